@@ -488,6 +488,12 @@ class _EventLogTile extends StatelessWidget {
       'EmbeddedSubtitleCue',
       cue?.text ?? 'Cue cleared',
     ),
+    AudioLevelsChangedEvent(:final peak) => (
+      Icons.graphic_eq,
+      Colors.lightGreen,
+      'AudioLevelsChanged',
+      'Peak: ${peak.map((level) => level.toStringAsFixed(2)).join(' / ')}',
+    ),
   };
 
   String _formatDuration(Duration duration) {
@@ -7,7 +7,7 @@
         test-android-instrumented-coverage test-android-full-coverage \
         test-ios-native test-ios-native-coverage \
         test-macos-native test-macos-native-coverage \
-        test-native test-e2e test-e2e-ios test-e2e-android test-e2e-macos test-e2e-web
+        test-native test-cpp-native benchmark-linux benchmark-time-stretch test-e2e test-e2e-ios test-e2e-android test-e2e-macos test-e2e-web
 
 # Shared parallel Dart analysis function
 # Note: Used by both 'analyze' and 'quick-check' targets to avoid duplication
@@ -545,10 +545,61 @@ test-macos-native-coverage:
 	echo ""; \
 	echo "$(CHECK) macOS native coverage complete!"
 
+# test-cpp-native: Build and run the shared C++ player core tests (no Flutter needed)
+# Use when: Changing shared_cpp_sources/ (player state machine, command queue, clock)
+# Note: Needs cmake and GoogleTest development files
+CPP_CORE_BUILD_DIR ?= shared_cpp_sources/build
+test-cpp-native:
+	@echo "$(TEST) Running shared C++ core tests..."
+	@cmake -S shared_cpp_sources -B $(CPP_CORE_BUILD_DIR) $(OUTPUT_REDIRECT) && \
+		cmake --build $(CPP_CORE_BUILD_DIR) -j $(OUTPUT_REDIRECT) || \
+		{ echo "$(CROSS) C++ core build failed (needs cmake and GoogleTest)"; exit 1; }
+	@ctest --test-dir $(CPP_CORE_BUILD_DIR) --output-on-failure && \
+		echo "$(CHECK) C++ core tests complete!" || \
+		{ echo "$(CROSS) C++ core tests failed!"; exit 1; }
+
 # test-native: Run all native tests
-test-native: test-android-native test-ios-native test-macos-native
+test-native: test-android-native test-ios-native test-macos-native test-cpp-native
 	@echo "$(CHECK) All native tests complete!"
 
+# === Benchmarks ===
+
+BENCH_BUILD_DIR ?= pro_video_player_linux/benchmark/build
+BENCH_PLAYERS ?= 4
+BENCH_DURATION ?= 20
+BENCH_MEDIA ?=
+BENCH_ARGS ?=
+
+# benchmark-linux: GStreamer BASELINE only - bare playbins with fake sinks; does not run the player core
+# Use when: Measuring what GStreamer decode costs (fps, CPU per stream, RSS, TTFF, seek latency, drops)
+#           as a baseline; these are not pro_video_player's own numbers
+# Note: BENCH_MEDIA is a file or directory (default: generated 1080p30 clip);
+#       add BENCH_ARGS="--http" to play through the local HTTP server, "--json" for CI
+benchmark-linux:
+	@echo "$(CHART) Building Linux playback benchmark..."
+	@cmake -S pro_video_player_linux/benchmark -B $(BENCH_BUILD_DIR) $(OUTPUT_REDIRECT) && \
+		cmake --build $(BENCH_BUILD_DIR) -j $(OUTPUT_REDIRECT) || \
+		{ echo "$(CROSS) Benchmark build failed (needs cmake and gstreamer-1.0 development files)"; exit 1; }
+	@echo "$(INFO) GStreamer baseline: bare playbins, not the player core"
+	@echo "$(TEST) Running $(BENCH_PLAYERS) players for $(BENCH_DURATION)s..."
+	@$(BENCH_BUILD_DIR)/playback_benchmark --players $(BENCH_PLAYERS) --duration $(BENCH_DURATION) \
+		$(if $(BENCH_MEDIA),--media "$(BENCH_MEDIA)") $(BENCH_ARGS)
+
+STRETCH_BUILD_DIR ?= shared_cpp_sources/build-bench
+STRETCH_ARGS ?= --budget 2
+
+# benchmark-time-stretch: CPU cost of the pitch-preserving speed stage (shared C++ core)
+# Use when: Changing shared_cpp_sources/time_stretch.* or the SIMD helpers
+# Note: Release build; fails when any speed from 0.25x to 4x needs more than
+#       STRETCH_ARGS' --budget percent of one core per stream
+benchmark-time-stretch:
+	@echo "$(CHART) Building time-stretch benchmark..."
+	@cmake -S shared_cpp_sources -B $(STRETCH_BUILD_DIR) -DCMAKE_BUILD_TYPE=Release \
+		-DPVP_CORE_BUILD_BENCHMARKS=ON -DPVP_CORE_BUILD_TESTS=OFF $(OUTPUT_REDIRECT) && \
+		cmake --build $(STRETCH_BUILD_DIR) -j --target time_stretch_benchmark $(OUTPUT_REDIRECT) || \
+		{ echo "$(CROSS) Benchmark build failed (needs cmake)"; exit 1; }
+	@$(STRETCH_BUILD_DIR)/benchmarks/time_stretch_benchmark $(STRETCH_ARGS)
+
 # === E2E Tests ===
 
 # test-e2e: Run E2E UI tests on ALL platforms in PARALLEL (default)
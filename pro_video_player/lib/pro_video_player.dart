@@ -42,6 +42,7 @@ export 'package:pro_video_player_platform_interface/pro_video_player_platform_in
     show
         AbrMode,
         AssetVideoSource,
+        AudioLevelsChangedEvent,
         AudioTrack,
         AudioTracksChangedEvent,
         BackgroundPlaybackChangedEvent,
@@ -51,6 +52,8 @@ export 'package:pro_video_player_platform_interface/pro_video_player_platform_in
         BufferingStartedEvent,
         BufferingTier,
         Caption,
+        CaptureFormat,
+        CapturedFrame,
         CastDevice,
         CastDevicesChangedEvent,
         CastState,
@@ -8,6 +8,8 @@ import 'manager_callbacks.dart';
 /// This manager handles:
 /// - Looping mode
 /// - Video scaling mode
+/// - Display size hints
+/// - Render frame rate cap and visibility hints
 /// - Background playback settings
 class ConfigurationManager with ManagerCallbacks {
   /// Creates a configuration manager with dependency injection via callbacks.
@@ -52,6 +54,48 @@ class ConfigurationManager with ManagerCallbacks {
     await platform.setScalingMode(getPlayerId()!, mode);
   }
 
+  /// Reports the on-screen size of the video view in physical pixels.
+  ///
+  /// The native player uses this as a decode hint so small views (e.g. grid
+  /// thumbnails) don't pay for full-resolution decoding. Platforms that don't
+  /// support the hint are ignored.
+  Future<void> setDisplaySize(int widthPx, int heightPx) async {
+    ensureInitialized();
+    try {
+      await platform.setDisplaySize(getPlayerId()!, widthPx, heightPx);
+    } on UnimplementedError {
+      // Third-party platform without decode hints - keep decoding at full size
+    }
+  }
+
+  /// Caps how many video frames per second are rendered.
+  ///
+  /// Pass `null` to render at the native frame rate, `0` to render no video
+  /// frames (audio only), or a positive value such as 1, 5 or 15 fps.
+  Future<void> setMaxRenderFrameRate(int? maxFps) async {
+    ensureInitialized();
+    if (maxFps != null && maxFps < 0) {
+      throw ArgumentError.value(maxFps, 'maxFps', 'Must be null or non-negative');
+    }
+    try {
+      await platform.setMaxRenderFrameRate(getPlayerId()!, maxFps);
+    } on UnimplementedError {
+      // Third-party platform without a render cap - keep rendering every frame
+    }
+  }
+
+  /// Tells the platform whether the video view is currently visible.
+  ///
+  /// Hidden players stop rendering video frames; audio is unaffected.
+  Future<void> setVisibilityHint({required bool isVisible}) async {
+    ensureInitialized();
+    try {
+      await platform.setVisibilityHint(getPlayerId()!, isVisible: isVisible);
+    } on UnimplementedError {
+      // Third-party platform without visibility hints - keep rendering
+    }
+  }
+
   /// Enables or disables background playback.
   ///
   /// When enabled, audio will continue playing when the app is in the background.
@@ -281,6 +281,11 @@ class EventCoordinator {
 
       case EmbeddedSubtitleCueEvent(:final cue):
         setValue(getValue().copyWith(currentEmbeddedCue: cue, clearCurrentEmbeddedCue: cue == null));
+
+      case AudioLevelsChangedEvent():
+        // Arrives every ~50ms; meters listen to the event stream directly
+        // rather than rebuilding every value listener
+        break;
     }
   }
 
@@ -1,3 +1,5 @@
+import 'dart:typed_data';
+
 import 'package:pro_video_player_platform_interface/pro_video_player_platform_interface.dart';
 
 /// Manages video metadata and chapter navigation for the video player.
@@ -57,6 +59,24 @@ class MetadataManager {
     await platform.setMediaMetadata(getPlayerId()!, metadata);
   }
 
+  /// Fetches a peak-amplitude summary of the whole file with at most
+  /// [bucketCount] entries (0-255 each).
+  ///
+  /// Returns `null` if the platform can't analyse the audio.
+  Future<Uint8List?> getWaveform(int bucketCount) async {
+    ensureInitialized();
+    return platform.getWaveform(getPlayerId()!, bucketCount);
+  }
+
+  /// Grabs the frame currently on screen, scaled down to at most [maxWidth]
+  /// pixels wide (0 keeps the video's size).
+  ///
+  /// Returns `null` if the platform can't read back decoded frames.
+  Future<CapturedFrame?> captureFrame(int maxWidth, CaptureFormat format) async {
+    ensureInitialized();
+    return platform.captureFrame(getPlayerId()!, maxWidth: maxWidth, format: format);
+  }
+
   /// Seeks to the start of the specified chapter.
   ///
   /// This is a convenience method equivalent to calling `seekTo(chapter.startTime)`.
@@ -21,6 +21,46 @@ mixin ConfigurationMixin on ProVideoPlayerControllerBase {
     return services.configurationManager.setScalingMode(mode);
   }
 
+  /// Reports the on-screen size of the video view in physical pixels.
+  ///
+  /// `ProVideoPlayer` calls this automatically whenever its layout size
+  /// changes, so you only need it when rendering the video view yourself.
+  /// Native players use the size to decode at a lower resolution when the
+  /// video is shown much smaller than its native size. The desktop libmpv
+  /// backend still decodes at full resolution and only renders smaller
+  /// frames, which saves colour conversion and copying but not decoding.
+  Future<void> setDisplaySize(int widthPx, int heightPx) async {
+    ensureInitializedInternal();
+    return services.configurationManager.setDisplaySize(widthPx, heightPx);
+  }
+
+  /// Caps how many video frames per second are rendered.
+  ///
+  /// Useful for players that don't need full motion, like dashboard tiles or
+  /// previews. Excess frames are dropped before conversion and upload, while
+  /// audio keeps playing normally.
+  ///
+  /// - `null`: native frame rate (default)
+  /// - `0`: no video frames, audio only
+  /// - positive values (e.g. 1, 5, 15): at most that many frames per second
+  ///
+  /// Throws [ArgumentError] if [maxFps] is negative.
+  Future<void> setMaxRenderFrameRate(int? maxFps) async {
+    ensureInitializedInternal();
+    return services.configurationManager.setMaxRenderFrameRate(maxFps);
+  }
+
+  /// Tells the platform whether the video view is currently visible.
+  ///
+  /// `ProVideoPlayer` reports this automatically when it is covered by another
+  /// route or placed under a disabled `TickerMode`. Call it yourself for
+  /// visibility the widget can't see, such as a scrolled-away list item.
+  /// Hidden players stop rendering video frames; audio is unaffected.
+  Future<void> setVisibilityHint({required bool isVisible}) async {
+    ensureInitializedInternal();
+    return services.configurationManager.setVisibilityHint(isVisible: isVisible);
+  }
+
   /// Sets whether background playback is enabled.
   ///
   /// Enables or disables background playback for the current player.
@@ -1,3 +1,5 @@
+import 'dart:typed_data';
+
 import 'package:pro_video_player_platform_interface/pro_video_player_platform_interface.dart';
 
 import '../controller_base.dart';
@@ -43,6 +45,43 @@ mixin MetadataMixin on ProVideoPlayerControllerBase {
     await services.metadataManager.setMediaMetadata(metadata);
   }
 
+  /// Gets a peak-amplitude summary of the whole file, for drawing a waveform
+  /// scrubber.
+  ///
+  /// Returns at most [bucketCount] values spread evenly over [duration], each
+  /// the loudest sample in its span scaled to 0-255. The audio is scanned
+  /// once in the background and cached on disk, so later calls for the same
+  /// file are fast.
+  ///
+  /// Desktop only: implemented by the native player core on Linux and
+  /// Windows. Android, iOS, macOS and web always return `null`.
+  ///
+  /// Returns `null` if the platform can't analyse the audio or the media has
+  /// no audio track.
+  Future<Uint8List?> getWaveform({int bucketCount = 500}) async {
+    ensureInitializedInternal();
+    if (bucketCount <= 0) {
+      throw ArgumentError.value(bucketCount, 'bucketCount', 'must be positive');
+    }
+    return services.metadataManager.getWaveform(bucketCount);
+  }
+
+  /// Grabs the video frame currently on screen, for thumbnails or snapshots,
+  /// without pausing playback.
+  ///
+  /// The frame is scaled down to at most [maxWidth] pixels wide with its
+  /// aspect ratio kept (0 keeps the video's size) and encoded as [format] in
+  /// the background.
+  ///
+  /// Returns `null` if the platform can't read back decoded frames.
+  Future<CapturedFrame?> captureFrame({int maxWidth = 0, CaptureFormat format = CaptureFormat.png}) async {
+    ensureInitializedInternal();
+    if (maxWidth < 0) {
+      throw ArgumentError.value(maxWidth, 'maxWidth', 'must not be negative');
+    }
+    return services.metadataManager.captureFrame(maxWidth, format);
+  }
+
   /// Available chapters in the video.
   ///
   /// Returns an empty list if no chapters are available.
@@ -145,6 +145,18 @@ class ProVideoPlayer extends StatefulWidget {
 }
 
 class _ProVideoPlayerState extends State<ProVideoPlayer> {
+  /// Last display size reported to the platform, in physical pixels.
+  (int, int)? _reportedDisplaySize;
+
+  /// Display size measured during layout, waiting for the end of the frame.
+  (int, int)? _pendingDisplaySize;
+
+  /// Whether the platform was told this view is hidden.
+  bool _reportedHidden = false;
+
+  /// Visibility seen during layout, waiting for the end of the frame.
+  bool? _pendingVisible;
+
   /// Computes the effective native controls mode for the platform view.
   ControlsMode get _effectiveNativeControlsMode {
     final useNativeControls = widget.controlsMode == ControlsMode.native && widget.controlsBuilder == null;
@@ -164,6 +176,71 @@ class _ProVideoPlayerState extends State<ProVideoPlayer> {
     if (oldNativeMode != newNativeMode && widget.controller.playerId != null) {
       unawaited(ProVideoPlayerPlatform.instance.setControlsMode(widget.controller.playerId!, newNativeMode));
     }
+
+    // A new controller needs its own display size report
+    if (oldWidget.controller != widget.controller) {
+      _reportedDisplaySize = null;
+      if (_reportedHidden) _restoreVisibility(oldWidget.controller);
+    }
+  }
+
+  @override
+  void dispose() {
+    if (_reportedHidden) _restoreVisibility(widget.controller);
+    super.dispose();
+  }
+
+  /// Tells the platform how large the video is actually shown, so small views
+  /// can be decoded at reduced resolution. Only reports changes.
+  ///
+  /// Called from layout, so the report itself waits for the end of the frame:
+  /// the controller may notify listeners, which must not happen mid-build.
+  void _reportDisplaySize(BoxConstraints constraints) {
+    if (widget.controller.playerId == null || !constraints.hasBoundedWidth || !constraints.hasBoundedHeight) return;
+
+    final pixelRatio = MediaQuery.devicePixelRatioOf(context);
+    final size = ((constraints.maxWidth * pixelRatio).round(), (constraints.maxHeight * pixelRatio).round());
+    if (size.$1 <= 0 || size.$2 <= 0) return;
+    if (_pendingDisplaySize == null && size == _reportedDisplaySize) return;
+
+    final scheduled = _pendingDisplaySize != null;
+    _pendingDisplaySize = size;
+    if (scheduled) return;
+    WidgetsBinding.instance.addPostFrameCallback((_) {
+      final pending = _pendingDisplaySize;
+      _pendingDisplaySize = null;
+      if (!mounted || pending == null || pending == _reportedDisplaySize || widget.controller.playerId == null) return;
+
+      _reportedDisplaySize = pending;
+      // A hint only: nothing to do if the player is gone or refuses it
+      unawaited(widget.controller.setDisplaySize(pending.$1, pending.$2).catchError((Object _) {}));
+    });
+  }
+
+  /// Tells the platform to stop rendering frames while this view is hidden
+  /// (covered by another route or under a disabled [TickerMode]). Deferred to
+  /// the end of the frame like [_reportDisplaySize].
+  void _reportVisibility({required bool isVisible}) {
+    if (widget.controller.playerId == null) return;
+    if (_pendingVisible == null && isVisible == !_reportedHidden) return;
+
+    final scheduled = _pendingVisible != null;
+    _pendingVisible = isVisible;
+    if (scheduled) return;
+    WidgetsBinding.instance.addPostFrameCallback((_) {
+      final pending = _pendingVisible;
+      _pendingVisible = null;
+      if (!mounted || pending == null || pending == !_reportedHidden || widget.controller.playerId == null) return;
+
+      _reportedHidden = !pending;
+      unawaited(widget.controller.setVisibilityHint(isVisible: pending).catchError((Object _) {}));
+    });
+  }
+
+  void _restoreVisibility(ProVideoPlayerController controller) {
+    _reportedHidden = false;
+    if (controller.isDisposed || !controller.isInitialized) return;
+    unawaited(controller.setVisibilityHint(isVisible: true).catchError((Object _) {}));
   }
 
   @override
@@ -186,7 +263,16 @@ class _ProVideoPlayerState extends State<ProVideoPlayer> {
       final calculatedAspectRatio = value.aspectRatio != 0.0 ? value.aspectRatio : 16 / 9;
       final videoAspectRatio = widget.aspectRatio ?? calculatedAspectRatio;
 
-      return AspectRatio(aspectRatio: videoAspectRatio, child: _buildVideoView(context));
+      return AspectRatio(
+        aspectRatio: videoAspectRatio,
+        child: LayoutBuilder(
+          builder: (context, constraints) {
+            _reportDisplaySize(constraints);
+            _reportVisibility(isVisible: TickerMode.of(context));
+            return _buildVideoView(context);
+          },
+        ),
+      );
     },
   );
 
@@ -61,6 +61,7 @@ void registerVideoPlayerFallbackValues() {
   registerFallbackValue(VideoMetadata.empty);
   registerFallbackValue(const <Chapter>[]);
   registerFallbackValue(const <SubtitleTrack>[]);
+  registerFallbackValue(CaptureFormat.png);
 }
 
 /// Test fixture for video player tests that use a mock platform.
@@ -325,6 +326,11 @@ class VideoPlayerTestFixture {
     when(() => mockPlatform.setVolume(any(), any())).thenAnswer((_) async {});
     when(() => mockPlatform.setLooping(any(), any())).thenAnswer((_) async {});
     when(() => mockPlatform.setScalingMode(any(), any())).thenAnswer((_) async {});
+    when(() => mockPlatform.setDisplaySize(any(), any(), any())).thenAnswer((_) async {});
+    when(() => mockPlatform.setMaxRenderFrameRate(any(), any())).thenAnswer((_) async {});
+    when(
+      () => mockPlatform.setVisibilityHint(any(), isVisible: any(named: 'isVisible')),
+    ).thenAnswer((_) async {});
 
     // Device controls (for gestures)
     when(() => mockPlatform.getDeviceVolume()).thenAnswer((_) async => 0.5);
@@ -351,6 +357,10 @@ class VideoPlayerTestFixture {
     // Background playback
     when(() => mockPlatform.setBackgroundPlayback(any(), enabled: any(named: 'enabled'))).thenAnswer((_) async => true);
     when(() => mockPlatform.setMediaMetadata(any(), any())).thenAnswer((_) async {});
+    when(() => mockPlatform.getWaveform(any(), any())).thenAnswer((_) async => null);
+    when(
+      () => mockPlatform.captureFrame(any(), maxWidth: any(named: 'maxWidth'), format: any(named: 'format')),
+    ).thenAnswer((_) async => null);
 
     // Casting
     when(() => mockPlatform.startCasting(any(), device: any(named: 'device'))).thenAnswer((_) async => true);
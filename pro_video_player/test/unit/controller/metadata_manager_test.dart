@@ -1,3 +1,5 @@
+import 'dart:typed_data';
+
 import 'package:flutter_test/flutter_test.dart';
 import 'package:mocktail/mocktail.dart';
 import 'package:pro_video_player/src/controller/metadata_manager.dart';
@@ -111,6 +113,49 @@ void main() {
       });
     });
 
+    group('getWaveform', () {
+      test('throws when not initialized', () async {
+        isInitialized = false;
+
+        expect(() => manager.getWaveform(100), throwsStateError);
+      });
+
+      test('returns the summary from platform', () async {
+        final peaks = Uint8List.fromList([0, 128, 255]);
+        when(() => mockPlatform.getWaveform(any(), any())).thenAnswer((_) async => peaks);
+
+        final waveform = await manager.getWaveform(100);
+
+        expect(waveform, equals(peaks));
+        verify(() => mockPlatform.getWaveform(1, 100)).called(1);
+      });
+    });
+
+    group('captureFrame', () {
+      test('throws when not initialized', () async {
+        isInitialized = false;
+
+        expect(() => manager.captureFrame(320, CaptureFormat.jpeg), throwsStateError);
+      });
+
+      test('returns the frame from platform', () async {
+        final frame = CapturedFrame(
+          bytes: Uint8List.fromList([1, 2, 3]),
+          width: 320,
+          height: 180,
+          position: const Duration(seconds: 2),
+        );
+        when(
+          () => mockPlatform.captureFrame(any(), maxWidth: any(named: 'maxWidth'), format: any(named: 'format')),
+        ).thenAnswer((_) async => frame);
+
+        final captured = await manager.captureFrame(320, CaptureFormat.jpeg);
+
+        expect(captured, same(frame));
+        verify(() => mockPlatform.captureFrame(1, maxWidth: 320, format: CaptureFormat.jpeg)).called(1);
+      });
+    });
+
     group('seekToChapter', () {
       test('calls ensureInitialized', () async {
         const chapter = Chapter(
@@ -137,6 +137,87 @@ void main() {
     });
   });
 
+  group('ProVideoPlayerController display size', () {
+    setUp(() async {
+      when(
+        () => fixture.mockPlatform.create(
+          source: any(named: 'source'),
+          options: any(named: 'options'),
+        ),
+      ).thenAnswer((_) async => 1);
+
+      await fixture.controller.initialize(source: const VideoSource.network(TestMedia.networkUrl));
+    });
+
+    test('setDisplaySize calls platform', () async {
+      await fixture.controller.setDisplaySize(480, 270);
+
+      verify(() => fixture.mockPlatform.setDisplaySize(1, 480, 270)).called(1);
+    });
+
+    test('setDisplaySize ignores platforms without support', () async {
+      when(() => fixture.mockPlatform.setDisplaySize(any(), any(), any())).thenThrow(UnimplementedError());
+
+      await expectLater(fixture.controller.setDisplaySize(480, 270), completes);
+    });
+
+    test('setDisplaySize throws when not initialized', () async {
+      final uninitializedController = ProVideoPlayerController();
+
+      expect(() => uninitializedController.setDisplaySize(480, 270), throwsA(isA<StateError>()));
+    });
+  });
+
+  group('ProVideoPlayerController render frame rate', () {
+    setUp(() async {
+      when(
+        () => fixture.mockPlatform.create(
+          source: any(named: 'source'),
+          options: any(named: 'options'),
+        ),
+      ).thenAnswer((_) async => 1);
+
+      await fixture.controller.initialize(source: const VideoSource.network(TestMedia.networkUrl));
+    });
+
+    test('setMaxRenderFrameRate calls platform', () async {
+      await fixture.controller.setMaxRenderFrameRate(5);
+
+      verify(() => fixture.mockPlatform.setMaxRenderFrameRate(1, 5)).called(1);
+    });
+
+    test('setMaxRenderFrameRate with null restores native rate', () async {
+      await fixture.controller.setMaxRenderFrameRate(null);
+
+      verify(() => fixture.mockPlatform.setMaxRenderFrameRate(1, null)).called(1);
+    });
+
+    test('setMaxRenderFrameRate rejects negative values', () async {
+      await expectLater(fixture.controller.setMaxRenderFrameRate(-1), throwsArgumentError);
+      verifyNever(() => fixture.mockPlatform.setMaxRenderFrameRate(any(), any()));
+    });
+
+    test('setMaxRenderFrameRate ignores platforms without support', () async {
+      when(() => fixture.mockPlatform.setMaxRenderFrameRate(any(), any())).thenThrow(UnimplementedError());
+
+      await expectLater(fixture.controller.setMaxRenderFrameRate(5), completes);
+    });
+
+    test('setVisibilityHint calls platform', () async {
+      await fixture.controller.setVisibilityHint(isVisible: false);
+
+      verify(() => fixture.mockPlatform.setVisibilityHint(1, isVisible: false)).called(1);
+    });
+
+    test('setVisibilityHint ignores platforms without support', () async {
+      when(
+        () => fixture.mockPlatform.setVisibilityHint(any(), isVisible: any(named: 'isVisible')),
+      ).thenThrow(UnimplementedError());
+
+      await expectLater(fixture.controller.setVisibilityHint(isVisible: false), completes);
+    });
+  });
+
   group('ProVideoPlayerController background playback', () {
     setUp(() async {
       when(
@@ -93,6 +93,71 @@ void main() {
       expect(aspectRatio.aspectRatio, closeTo(2.4, 0.01));
     });
 
+    group('display size', () {
+      testWidgets('reports physical view size to platform', (tester) async {
+        await fixture.initializeController();
+        tester.view.devicePixelRatio = 2;
+        addTearDown(tester.view.resetDevicePixelRatio);
+
+        await tester.pumpWidget(
+          buildTestWidget(
+            Center(
+              child: SizedBox(width: 160, height: 90, child: ProVideoPlayer(controller: fixture.controller)),
+            ),
+          ),
+        );
+
+        verify(() => fixture.mockPlatform.setDisplaySize(1, 320, 180)).called(1);
+      });
+
+      testWidgets('does not report again when size is unchanged', (tester) async {
+        await fixture.initializeController();
+        Widget build() => buildTestWidget(
+          Center(
+            child: SizedBox(width: 160, height: 90, child: ProVideoPlayer(controller: fixture.controller)),
+          ),
+        );
+
+        await tester.pumpWidget(build());
+        await tester.pumpWidget(build());
+
+        verify(() => fixture.mockPlatform.setDisplaySize(1, any(), any())).called(1);
+      });
+    });
+
+    group('visibility', () {
+      testWidgets('does not send a hint while visible', (tester) async {
+        await fixture.initializeController();
+
+        await tester.pumpWidget(buildTestWidget(ProVideoPlayer(controller: fixture.controller)));
+
+        verifyNever(() => fixture.mockPlatform.setVisibilityHint(any(), isVisible: any(named: 'isVisible')));
+      });
+
+      testWidgets('reports hidden and visible when TickerMode toggles', (tester) async {
+        await fixture.initializeController();
+        Widget build({required bool enabled}) =>
+            buildTestWidget(TickerMode(enabled: enabled, child: ProVideoPlayer(controller: fixture.controller)));
+
+        await tester.pumpWidget(build(enabled: false));
+        verify(() => fixture.mockPlatform.setVisibilityHint(1, isVisible: false)).called(1);
+
+        await tester.pumpWidget(build(enabled: true));
+        verify(() => fixture.mockPlatform.setVisibilityHint(1, isVisible: true)).called(1);
+      });
+
+      testWidgets('restores visibility when disposed while hidden', (tester) async {
+        await fixture.initializeController();
+
+        await tester.pumpWidget(
+          buildTestWidget(TickerMode(enabled: false, child: ProVideoPlayer(controller: fixture.controller))),
+        );
+        await tester.pumpWidget(buildTestWidget(const SizedBox()));
+
+        verify(() => fixture.mockPlatform.setVisibilityHint(1, isVisible: true)).called(1);
+      });
+    });
+
     group('controlsMode', () {
       testWidgets('defaults to ControlsMode.flutter (shows VideoPlayerControls)', (tester) async {
         await fixture.initializeController();
@@ -367,6 +367,12 @@ class ProVideoPlayerPlugin: FlutterPlugin, ActivityAware, Application.ActivityLi
         }
     }
 
+    override fun dumpNativeTrace(callback: (Result<String>) -> Unit) {
+        // ExoPlayer's pipeline is traced with system tracing (Perfetto/systrace);
+        // there is no plugin-side ring buffer on Android.
+        callback(Result.success("{\"traceEvents\":[]}"))
+    }
+
     // MARK: - Platform Capabilities
 
     override fun supportsPictureInPicture(callback: (Result<Boolean>) -> Unit) {
@@ -471,6 +477,18 @@ class ProVideoPlayerPlugin: FlutterPlugin, ActivityAware, Application.ActivityLi
         delegatePlayerMethod(playerId, { it.setControlsMode(useNativeControls) }, callback)
     }
 
+    override fun setDisplaySize(playerId: Long, widthPx: Long, heightPx: Long, callback: (Result<Unit>) -> Unit) {
+        delegatePlayerMethod(playerId, { it.setDisplaySize(widthPx.toInt(), heightPx.toInt()) }, callback)
+    }
+
+    override fun setMaxRenderFrameRate(playerId: Long, maxFps: Long, callback: (Result<Unit>) -> Unit) {
+        delegatePlayerMethod(playerId, { it.setMaxRenderFrameRate(maxFps.toInt()) }, callback)
+    }
+
+    override fun setVisibilityHint(playerId: Long, isVisible: Boolean, callback: (Result<Unit>) -> Unit) {
+        delegatePlayerMethod(playerId, { it.setVisibilityHint(isVisible) }, callback)
+    }
+
     // MARK: - Device Controls
 
     override fun getDeviceVolume(callback: (Result<Double>) -> Unit) {
@@ -837,6 +855,31 @@ class ProVideoPlayerPlugin: FlutterPlugin, ActivityAware, Application.ActivityLi
         delegatePlayerMethod(playerId, { it.setMediaMetadata(metadataMap) }, callback)
     }
 
+    override fun getWaveform(playerId: Long, bucketCount: Long, callback: (Result<ByteArray?>) -> Unit) {
+        try {
+            getPlayerOrFail(playerId)
+            // ExoPlayer has no cheap whole-file audio scan; waveforms come from the desktop core
+            callback(Result.success(null))
+        } catch (e: FlutterError) {
+            callback(Result.failure(e))
+        }
+    }
+
+    override fun captureFrame(
+        playerId: Long,
+        maxWidth: Long,
+        format: String,
+        callback: (Result<CapturedFrameMessage?>) -> Unit
+    ) {
+        try {
+            getPlayerOrFail(playerId)
+            // ExoPlayer renders straight into the Flutter surface; frame grabs come from the desktop core
+            callback(Result.success(null))
+        } catch (e: FlutterError) {
+            callback(Result.failure(e))
+        }
+    }
+
     // MARK: - Casting Methods
 
     override fun isCastingSupported(callback: (Result<Boolean>) -> Unit) {
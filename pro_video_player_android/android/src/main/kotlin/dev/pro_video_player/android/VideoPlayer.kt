@@ -99,6 +99,12 @@ class VideoPlayer(
     private var isPlaying: Boolean = false
     private var isInBackground: Boolean = false
 
+    // Render-rate state: -1 = native frame rate, 0 = no video frames (audio only)
+    private var maxRenderFrameRate: Int = -1
+    private var isViewVisible: Boolean = true
+    // Desired state, kept while there is no player to apply it to
+    private var isVideoRenderingDisabled: Boolean = false
+
     // Track selection state
     private var hasManuallySelectedSubtitle: Boolean = false
     private var isInitialSubtitleSelection: Boolean = true
@@ -601,6 +607,9 @@ class VideoPlayer(
                 // Position updates will start on first play() call
             }
 
+        // Render-policy hints may have arrived before the player existed
+        applyVideoRendering()
+
         // Set up MediaSession and register for background playback if enabled
         // MediaSession is only needed when background playback is enabled
         if (allowBackgroundPlayback) {
@@ -1269,6 +1278,7 @@ class VideoPlayer(
                 isPipModeActive = false
                 pipActivity = null
                 sendEvent(mapOf("type" to "pipStateChanged", "isActive" to false))
+                updateVideoRendering()
             }
         }
     }
@@ -1297,7 +1307,30 @@ class VideoPlayer(
             playerView?.useController = useNativeControls
         }
     }
-    
+
+    /**
+     * Constrains adaptive track selection to the on-screen size of the video view.
+     *
+     * By default ExoPlayer uses the physical display size as viewport, so a
+     * thumbnail-sized player still selects (and decodes) 1080p renditions.
+     * Passing the real view size lets the track selector pick the smallest
+     * rendition that still covers the view.
+     *
+     * @param widthPx view width in physical pixels
+     * @param heightPx view height in physical pixels
+     */
+    fun setDisplaySize(widthPx: Int, heightPx: Int) {
+        if (widthPx <= 0 || heightPx <= 0) return
+        mainHandler.post {
+            val player = exoPlayer ?: return@post
+            verboseLog("setDisplaySize: ${widthPx}x$heightPx", TAG)
+            player.trackSelectionParameters = player.trackSelectionParameters
+                .buildUpon()
+                .setViewportSize(widthPx, heightPx, /* viewportOrientationMayChange= */ false)
+                .build()
+        }
+    }
+
     private fun applyScalingMode(view: PlayerView) {
         val scalingMode = initialOptions["scalingMode"] as? String ?: "fit"
         view.resizeMode = when (scalingMode) {
@@ -1426,6 +1459,7 @@ class VideoPlayer(
     fun onAppBackground() {
         isInBackground = true
         updateScreenSleepPrevention()
+        updateVideoRendering()
     }
 
     /**
@@ -1435,6 +1469,60 @@ class VideoPlayer(
     fun onAppForeground() {
         isInBackground = false
         updateScreenSleepPrevention()
+        updateVideoRendering()
+    }
+
+    /**
+     * Caps the video render rate.
+     *
+     * ExoPlayer renders every decoded frame and has no hook to drop frames
+     * before they reach the surface, so only the 0 fps cap (audio only) is
+     * applied here; it disables the video renderer entirely, which also stops
+     * video decoding. Other caps render at the native frame rate.
+     *
+     * @param maxFps -1 for native frame rate, 0 for no video frames
+     */
+    fun setMaxRenderFrameRate(maxFps: Int) {
+        maxRenderFrameRate = maxFps
+        updateVideoRendering()
+    }
+
+    /**
+     * Updates whether the Flutter view showing this player is visible.
+     * Hidden players stop rendering (and decoding) video until shown again.
+     */
+    fun setVisibilityHint(isVisible: Boolean) {
+        isViewVisible = isVisible
+        updateVideoRendering()
+    }
+
+    /**
+     * Works out whether video should be off from the render-rate cap, view
+     * visibility and background audio-only playback, and applies it.
+     * Audio playback continues either way. PiP always shows video.
+     */
+    private fun updateVideoRendering() {
+        val backgroundAudioOnly = isInBackground && allowBackgroundPlayback && !isPipModeActive
+        isVideoRenderingDisabled =
+            !isPipModeActive && (maxRenderFrameRate == 0 || !isViewVisible || backgroundAudioOnly)
+        mainHandler.post { applyVideoRendering() }
+    }
+
+    /**
+     * Brings the player's video track in line with [isVideoRenderingDisabled].
+     * Also runs when the player is created, so hints that arrive before it
+     * are not lost. Track selection parameters outlive media item changes.
+     */
+    private fun applyVideoRendering() {
+        val player = exoPlayer ?: return
+        val disable = isVideoRenderingDisabled
+        val params = player.trackSelectionParameters
+        if (params.disabledTrackTypes.contains(C.TRACK_TYPE_VIDEO) == disable) return
+        verboseLog("updateVideoRendering: video ${if (disable) "disabled" else "enabled"}", TAG)
+        player.trackSelectionParameters = params
+            .buildUpon()
+            .setTrackTypeDisabled(C.TRACK_TYPE_VIDEO, disable)
+            .build()
     }
 
     override fun seekTo(position: Long) {
@@ -2085,6 +2173,7 @@ class VideoPlayer(
 
                 sendEvent(mapOf("type" to "pipStateChanged", "isActive" to true))
                 updateScreenSleepPrevention()
+                updateVideoRendering()
                 return true
             } catch (e: IllegalStateException) {
                 // Activity doesn't support PiP (missing android:supportsPictureInPicture="true" in manifest)
@@ -2101,6 +2190,7 @@ class VideoPlayer(
         unregisterPipActionReceiver()
         sendEvent(mapOf("type" to "pipStateChanged", "isActive" to false))
         updateScreenSleepPrevention()
+        updateVideoRendering()
     }
 
     /**
@@ -2478,6 +2568,7 @@ class VideoPlayer(
             MediaPlaybackService.unregisterPlayer(playerId)
         }
 
+        updateVideoRendering()
         sendEvent(mapOf("type" to "backgroundPlaybackChanged", "isEnabled" to enabled))
         return true
     }
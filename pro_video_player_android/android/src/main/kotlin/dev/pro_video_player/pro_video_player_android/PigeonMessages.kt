@@ -301,7 +301,14 @@ data class VideoPlayerOptionsMessage (
   /** Whether to allow Picture-in-Picture mode (deprecated, use enablePip). */
   val allowPip: Boolean,
   /** Whether to auto-enter PiP when app goes to background. */
-  val autoEnterPipOnBackground: Boolean
+  val autoEnterPipOnBackground: Boolean,
+  /**
+   * Native decode backend for platforms that offer more than one
+   * (e.g. "gstreamer" or "mpv" on Linux). Null uses the platform default.
+   */
+  val nativeBackend: String? = null,
+  /** Whether to emit per-channel audio level events (VU meters). */
+  val enableAudioLevels: Boolean? = null
 )
  {
   companion object {
@@ -322,7 +329,9 @@ data class VideoPlayerOptionsMessage (
       val mixWithOthers = pigeonVar_list[13] as Boolean
       val allowPip = pigeonVar_list[14] as Boolean
       val autoEnterPipOnBackground = pigeonVar_list[15] as Boolean
-      return VideoPlayerOptionsMessage(autoPlay, looping, volume, playbackSpeed, startPosition, enablePip, enableBackgroundPlayback, preferredAudioLanguage, preferredSubtitleLanguage, maxBitrate, minBitrate, preferredAudioRendition, allowBackgroundPlayback, mixWithOthers, allowPip, autoEnterPipOnBackground)
+      val nativeBackend = pigeonVar_list[16] as String?
+      val enableAudioLevels = pigeonVar_list[17] as Boolean?
+      return VideoPlayerOptionsMessage(autoPlay, looping, volume, playbackSpeed, startPosition, enablePip, enableBackgroundPlayback, preferredAudioLanguage, preferredSubtitleLanguage, maxBitrate, minBitrate, preferredAudioRendition, allowBackgroundPlayback, mixWithOthers, allowPip, autoEnterPipOnBackground, nativeBackend, enableAudioLevels)
     }
   }
   fun toList(): List<Any?> {
@@ -343,6 +352,8 @@ data class VideoPlayerOptionsMessage (
       mixWithOthers,
       allowPip,
       autoEnterPipOnBackground,
+      nativeBackend,
+      enableAudioLevels,
     )
   }
 }
@@ -870,6 +881,41 @@ data class VideoPlayerEventMessage (
     )
   }
 }
+
+/**
+ * A video frame grabbed by captureFrame.
+ *
+ * Generated class from Pigeon that represents data sent in messages.
+ */
+data class CapturedFrameMessage (
+  /** PNG or JPEG file, or tightly packed RGBA pixels for the 'raw' format. */
+  val bytes: ByteArray,
+  /** Width in pixels. */
+  val width: Long,
+  /** Height in pixels. */
+  val height: Long,
+  /** Position of the frame in the video, in milliseconds. */
+  val positionMs: Long
+)
+ {
+  companion object {
+    fun fromList(pigeonVar_list: List<Any?>): CapturedFrameMessage {
+      val bytes = pigeonVar_list[0] as ByteArray
+      val width = pigeonVar_list[1] as Long
+      val height = pigeonVar_list[2] as Long
+      val positionMs = pigeonVar_list[3] as Long
+      return CapturedFrameMessage(bytes, width, height, positionMs)
+    }
+  }
+  fun toList(): List<Any?> {
+    return listOf(
+      bytes,
+      width,
+      height,
+      positionMs,
+    )
+  }
+}
 private open class PigeonMessagesPigeonCodec : StandardMessageCodec() {
   override fun readValueOfType(type: Byte, buffer: ByteBuffer): Any? {
     return when (type) {
@@ -993,6 +1039,11 @@ private open class PigeonMessagesPigeonCodec : StandardMessageCodec() {
           VideoPlayerEventMessage.fromList(it)
         }
       }
+      153.toByte() -> {
+        return (readValue(buffer) as? List<Any?>)?.let {
+          CapturedFrameMessage.fromList(it)
+        }
+      }
       else -> super.readValueOfType(type, buffer)
     }
   }
@@ -1094,6 +1145,10 @@ private open class PigeonMessagesPigeonCodec : StandardMessageCodec() {
         stream.write(152)
         writeValue(stream, value.toList())
       }
+      is CapturedFrameMessage -> {
+        stream.write(153)
+        writeValue(stream, value.toList())
+      }
       else -> super.writeValue(stream, value)
     }
   }
@@ -1141,6 +1196,8 @@ interface ProVideoPlayerHostApi {
   fun getPlatformInfo(callback: (Result<PlatformInfoMessage>) -> Unit)
   /** Enables or disables verbose logging. */
   fun setVerboseLogging(enabled: Boolean, callback: (Result<Unit>) -> Unit)
+  /** Returns the native trace ring buffer as Chrome trace event JSON. */
+  fun dumpNativeTrace(callback: (Result<String>) -> Unit)
   /** Checks if Picture-in-Picture mode is supported. */
   fun supportsPictureInPicture(callback: (Result<Boolean>) -> Unit)
   /** Checks if fullscreen mode is supported. */
@@ -1199,6 +1256,26 @@ interface ProVideoPlayerHostApi {
   fun setScalingMode(playerId: Long, mode: VideoScalingModeEnum, callback: (Result<Unit>) -> Unit)
   /** Sets the controls mode. */
   fun setControlsMode(playerId: Long, mode: ControlsModeEnum, callback: (Result<Unit>) -> Unit)
+  /**
+   * Reports the on-screen size of the player's video surface in physical pixels.
+   *
+   * Native players use this to cap decode resolution when the video is shown
+   * much smaller than its native size (e.g. thumbnails in a grid).
+   */
+  fun setDisplaySize(playerId: Long, widthPx: Long, heightPx: Long, callback: (Result<Unit>) -> Unit)
+  /**
+   * Caps how many video frames per second the player renders.
+   *
+   * A negative [maxFps] renders at the video's native frame rate. Zero renders
+   * no video frames at all while audio keeps playing.
+   */
+  fun setMaxRenderFrameRate(playerId: Long, maxFps: Long, callback: (Result<Unit>) -> Unit)
+  /**
+   * Tells the player whether its view is currently visible on screen.
+   *
+   * Hidden players stop rendering video frames; audio is unaffected.
+   */
+  fun setVisibilityHint(playerId: Long, isVisible: Boolean, callback: (Result<Unit>) -> Unit)
   /** Sets the active subtitle track. */
   fun setSubtitleTrack(playerId: Long, track: SubtitleTrackMessage?, callback: (Result<Unit>) -> Unit)
   /** Sets the subtitle render mode. */
@@ -1241,6 +1318,17 @@ interface ProVideoPlayerHostApi {
   fun getVideoMetadata(playerId: Long, callback: (Result<VideoMetadataMessage?>) -> Unit)
   /** Sets media metadata for platform controls. */
   fun setMediaMetadata(playerId: Long, metadata: MediaMetadataMessage, callback: (Result<Unit>) -> Unit)
+  /**
+   * Gets a peak-amplitude summary of the whole file with at most
+   * [bucketCount] entries (0-255 each). Null when unsupported.
+   */
+  fun getWaveform(playerId: Long, bucketCount: Long, callback: (Result<ByteArray?>) -> Unit)
+  /**
+   * Grabs the current video frame, scaled down to at most [maxWidth] pixels
+   * wide (0 keeps the video's width) and encoded as [format] ('png', 'jpeg'
+   * or 'raw' RGBA). Null when unsupported.
+   */
+  fun captureFrame(playerId: Long, maxWidth: Long, format: String, callback: (Result<CapturedFrameMessage?>) -> Unit)
   /** Checks if casting is supported on this platform. */
   fun isCastingSupported(callback: (Result<Boolean>) -> Unit)
   /** Gets available cast devices. */
@@ -1497,6 +1585,24 @@ interface ProVideoPlayerHostApi {
           channel.setMessageHandler(null)
         }
       }
+      run {
+        val channel = BasicMessageChannel<Any?>(binaryMessenger, "dev.flutter.pigeon.pro_video_player_platform_interface.ProVideoPlayerHostApi.dumpNativeTrace$separatedMessageChannelSuffix", codec)
+        if (api != null) {
+          channel.setMessageHandler { _, reply ->
+            api.dumpNativeTrace{ result: Result<String> ->
+              val error = result.exceptionOrNull()
+              if (error != null) {
+                reply.reply(wrapError(error))
+              } else {
+                val data = result.getOrNull()
+                reply.reply(wrapResult(data))
+              }
+            }
+          }
+        } else {
+          channel.setMessageHandler(null)
+        }
+      }
       run {
         val channel = BasicMessageChannel<Any?>(binaryMessenger, "dev.flutter.pigeon.pro_video_player_platform_interface.ProVideoPlayerHostApi.supportsPictureInPicture$separatedMessageChannelSuffix", codec)
         if (api != null) {
@@ -2027,6 +2133,67 @@ interface ProVideoPlayerHostApi {
           channel.setMessageHandler(null)
         }
       }
+      run {
+        val channel = BasicMessageChannel<Any?>(binaryMessenger, "dev.flutter.pigeon.pro_video_player_platform_interface.ProVideoPlayerHostApi.setDisplaySize$separatedMessageChannelSuffix", codec)
+        if (api != null) {
+          channel.setMessageHandler { message, reply ->
+            val args = message as List<Any?>
+            val playerIdArg = args[0] as Long
+            val widthPxArg = args[1] as Long
+            val heightPxArg = args[2] as Long
+            api.setDisplaySize(playerIdArg, widthPxArg, heightPxArg) { result: Result<Unit> ->
+              val error = result.exceptionOrNull()
+              if (error != null) {
+                reply.reply(wrapError(error))
+              } else {
+                reply.reply(wrapResult(null))
+              }
+            }
+          }
+        } else {
+          channel.setMessageHandler(null)
+        }
+      }
+      run {
+        val channel = BasicMessageChannel<Any?>(binaryMessenger, "dev.flutter.pigeon.pro_video_player_platform_interface.ProVideoPlayerHostApi.setMaxRenderFrameRate$separatedMessageChannelSuffix", codec)
+        if (api != null) {
+          channel.setMessageHandler { message, reply ->
+            val args = message as List<Any?>
+            val playerIdArg = args[0] as Long
+            val maxFpsArg = args[1] as Long
+            api.setMaxRenderFrameRate(playerIdArg, maxFpsArg) { result: Result<Unit> ->
+              val error = result.exceptionOrNull()
+              if (error != null) {
+                reply.reply(wrapError(error))
+              } else {
+                reply.reply(wrapResult(null))
+              }
+            }
+          }
+        } else {
+          channel.setMessageHandler(null)
+        }
+      }
+      run {
+        val channel = BasicMessageChannel<Any?>(binaryMessenger, "dev.flutter.pigeon.pro_video_player_platform_interface.ProVideoPlayerHostApi.setVisibilityHint$separatedMessageChannelSuffix", codec)
+        if (api != null) {
+          channel.setMessageHandler { message, reply ->
+            val args = message as List<Any?>
+            val playerIdArg = args[0] as Long
+            val isVisibleArg = args[1] as Boolean
+            api.setVisibilityHint(playerIdArg, isVisibleArg) { result: Result<Unit> ->
+              val error = result.exceptionOrNull()
+              if (error != null) {
+                reply.reply(wrapError(error))
+              } else {
+                reply.reply(wrapResult(null))
+              }
+            }
+          }
+        } else {
+          channel.setMessageHandler(null)
+        }
+      }
       run {
         val channel = BasicMessageChannel<Any?>(binaryMessenger, "dev.flutter.pigeon.pro_video_player_platform_interface.ProVideoPlayerHostApi.setSubtitleTrack$separatedMessageChannelSuffix", codec)
         if (api != null) {
@@ -2445,6 +2612,49 @@ interface ProVideoPlayerHostApi {
           channel.setMessageHandler(null)
         }
       }
+      run {
+        val channel = BasicMessageChannel<Any?>(binaryMessenger, "dev.flutter.pigeon.pro_video_player_platform_interface.ProVideoPlayerHostApi.getWaveform$separatedMessageChannelSuffix", codec)
+        if (api != null) {
+          channel.setMessageHandler { message, reply ->
+            val args = message as List<Any?>
+            val playerIdArg = args[0] as Long
+            val bucketCountArg = args[1] as Long
+            api.getWaveform(playerIdArg, bucketCountArg) { result: Result<ByteArray?> ->
+              val error = result.exceptionOrNull()
+              if (error != null) {
+                reply.reply(wrapError(error))
+              } else {
+                val data = result.getOrNull()
+                reply.reply(wrapResult(data))
+              }
+            }
+          }
+        } else {
+          channel.setMessageHandler(null)
+        }
+      }
+      run {
+        val channel = BasicMessageChannel<Any?>(binaryMessenger, "dev.flutter.pigeon.pro_video_player_platform_interface.ProVideoPlayerHostApi.captureFrame$separatedMessageChannelSuffix", codec)
+        if (api != null) {
+          channel.setMessageHandler { message, reply ->
+            val args = message as List<Any?>
+            val playerIdArg = args[0] as Long
+            val maxWidthArg = args[1] as Long
+            val formatArg = args[2] as String
+            api.captureFrame(playerIdArg, maxWidthArg, formatArg) { result: Result<CapturedFrameMessage?> ->
+              val error = result.exceptionOrNull()
+              if (error != null) {
+                reply.reply(wrapError(error))
+              } else {
+                val data = result.getOrNull()
+                reply.reply(wrapResult(data))
+              }
+            }
+          }
+        } else {
+          channel.setMessageHandler(null)
+        }
+      }
       run {
         val channel = BasicMessageChannel<Any?>(binaryMessenger, "dev.flutter.pigeon.pro_video_player_platform_interface.ProVideoPlayerHostApi.isCastingSupported$separatedMessageChannelSuffix", codec)
         if (api != null) {
@@ -269,6 +269,11 @@ struct VideoPlayerOptionsMessage {
   var allowPip: Bool
   /// Whether to auto-enter PiP when app goes to background.
   var autoEnterPipOnBackground: Bool
+  /// Native decode backend for platforms that offer more than one
+  /// (e.g. "gstreamer" or "mpv" on Linux). Null uses the platform default.
+  var nativeBackend: String? = nil
+  /// Whether to emit per-channel audio level events (VU meters).
+  var enableAudioLevels: Bool? = nil
 
 
   // swift-format-ignore: AlwaysUseLowerCamelCase
@@ -289,6 +294,8 @@ struct VideoPlayerOptionsMessage {
     let mixWithOthers = pigeonVar_list[13] as! Bool
     let allowPip = pigeonVar_list[14] as! Bool
     let autoEnterPipOnBackground = pigeonVar_list[15] as! Bool
+    let nativeBackend: String? = nilOrValue(pigeonVar_list[16])
+    let enableAudioLevels: Bool? = nilOrValue(pigeonVar_list[17])
 
     return VideoPlayerOptionsMessage(
       autoPlay: autoPlay,
@@ -306,7 +313,9 @@ struct VideoPlayerOptionsMessage {
       allowBackgroundPlayback: allowBackgroundPlayback,
       mixWithOthers: mixWithOthers,
       allowPip: allowPip,
-      autoEnterPipOnBackground: autoEnterPipOnBackground
+      autoEnterPipOnBackground: autoEnterPipOnBackground,
+      nativeBackend: nativeBackend,
+      enableAudioLevels: enableAudioLevels
     )
   }
   func toList() -> [Any?] {
@@ -327,6 +336,8 @@ struct VideoPlayerOptionsMessage {
       mixWithOthers,
       allowPip,
       autoEnterPipOnBackground,
+      nativeBackend,
+      enableAudioLevels,
     ]
   }
 }
@@ -906,6 +917,44 @@ struct VideoPlayerEventMessage {
   }
 }
 
+/// A video frame grabbed by captureFrame.
+///
+/// Generated class from Pigeon that represents data sent in messages.
+struct CapturedFrameMessage {
+  /// PNG or JPEG file, or tightly packed RGBA pixels for the 'raw' format.
+  var bytes: FlutterStandardTypedData
+  /// Width in pixels.
+  var width: Int64
+  /// Height in pixels.
+  var height: Int64
+  /// Position of the frame in the video, in milliseconds.
+  var positionMs: Int64
+
+
+  // swift-format-ignore: AlwaysUseLowerCamelCase
+  static func fromList(_ pigeonVar_list: [Any?]) -> CapturedFrameMessage? {
+    let bytes = pigeonVar_list[0] as! FlutterStandardTypedData
+    let width = pigeonVar_list[1] as! Int64
+    let height = pigeonVar_list[2] as! Int64
+    let positionMs = pigeonVar_list[3] as! Int64
+
+    return CapturedFrameMessage(
+      bytes: bytes,
+      width: width,
+      height: height,
+      positionMs: positionMs
+    )
+  }
+  func toList() -> [Any?] {
+    return [
+      bytes,
+      width,
+      height,
+      positionMs,
+    ]
+  }
+}
+
 private class PigeonMessagesPigeonCodecReader: FlutterStandardReader {
   override func readValue(ofType type: UInt8) -> Any? {
     switch type {
@@ -993,6 +1042,8 @@ private class PigeonMessagesPigeonCodecReader: FlutterStandardReader {
       return ExternalSubtitleTrackMessage.fromList(self.readValue() as! [Any?])
     case 152:
       return VideoPlayerEventMessage.fromList(self.readValue() as! [Any?])
+    case 153:
+      return CapturedFrameMessage.fromList(self.readValue() as! [Any?])
     default:
       return super.readValue(ofType: type)
     }
@@ -1073,6 +1124,9 @@ private class PigeonMessagesPigeonCodecWriter: FlutterStandardWriter {
     } else if let value = value as? VideoPlayerEventMessage {
       super.writeByte(152)
       super.writeValue(value.toList())
+    } else if let value = value as? CapturedFrameMessage {
+      super.writeByte(153)
+      super.writeValue(value.toList())
     } else {
       super.writeValue(value)
     }
@@ -1129,6 +1183,8 @@ protocol ProVideoPlayerHostApi {
   func getPlatformInfo(completion: @escaping (Result<PlatformInfoMessage, Error>) -> Void)
   /// Enables or disables verbose logging.
   func setVerboseLogging(enabled: Bool, completion: @escaping (Result<Void, Error>) -> Void)
+  /// Returns the native trace ring buffer as Chrome trace event JSON.
+  func dumpNativeTrace(completion: @escaping (Result<String, Error>) -> Void)
   /// Checks if Picture-in-Picture mode is supported.
   func supportsPictureInPicture(completion: @escaping (Result<Bool, Error>) -> Void)
   /// Checks if fullscreen mode is supported.
@@ -1187,6 +1243,20 @@ protocol ProVideoPlayerHostApi {
   func setScalingMode(playerId: Int64, mode: VideoScalingModeEnum, completion: @escaping (Result<Void, Error>) -> Void)
   /// Sets the controls mode.
   func setControlsMode(playerId: Int64, mode: ControlsModeEnum, completion: @escaping (Result<Void, Error>) -> Void)
+  /// Reports the on-screen size of the player's video surface in physical pixels.
+  ///
+  /// Native players use this to cap decode resolution when the video is shown
+  /// much smaller than its native size (e.g. thumbnails in a grid).
+  func setDisplaySize(playerId: Int64, widthPx: Int64, heightPx: Int64, completion: @escaping (Result<Void, Error>) -> Void)
+  /// Caps how many video frames per second the player renders.
+  ///
+  /// A negative [maxFps] renders at the video's native frame rate. Zero renders
+  /// no video frames at all while audio keeps playing.
+  func setMaxRenderFrameRate(playerId: Int64, maxFps: Int64, completion: @escaping (Result<Void, Error>) -> Void)
+  /// Tells the player whether its view is currently visible on screen.
+  ///
+  /// Hidden players stop rendering video frames; audio is unaffected.
+  func setVisibilityHint(playerId: Int64, isVisible: Bool, completion: @escaping (Result<Void, Error>) -> Void)
   /// Sets the active subtitle track.
   func setSubtitleTrack(playerId: Int64, track: SubtitleTrackMessage?, completion: @escaping (Result<Void, Error>) -> Void)
   /// Sets the subtitle render mode.
@@ -1229,6 +1299,13 @@ protocol ProVideoPlayerHostApi {
   func getVideoMetadata(playerId: Int64, completion: @escaping (Result<VideoMetadataMessage?, Error>) -> Void)
   /// Sets media metadata for platform controls.
   func setMediaMetadata(playerId: Int64, metadata: MediaMetadataMessage, completion: @escaping (Result<Void, Error>) -> Void)
+  /// Gets a peak-amplitude summary of the whole file with at most
+  /// [bucketCount] entries (0-255 each). Null when unsupported.
+  func getWaveform(playerId: Int64, bucketCount: Int64, completion: @escaping (Result<FlutterStandardTypedData?, Error>) -> Void)
+  /// Grabs the current video frame, scaled down to at most [maxWidth] pixels
+  /// wide (0 keeps the video's width) and encoded as [format] ('png', 'jpeg'
+  /// or 'raw' RGBA). Null when unsupported.
+  func captureFrame(playerId: Int64, maxWidth: Int64, format: String, completion: @escaping (Result<CapturedFrameMessage?, Error>) -> Void)
   /// Checks if casting is supported on this platform.
   func isCastingSupported(completion: @escaping (Result<Bool, Error>) -> Void)
   /// Gets available cast devices.
@@ -1471,6 +1548,22 @@ class ProVideoPlayerHostApiSetup {
     } else {
       setVerboseLoggingChannel.setMessageHandler(nil)
     }
+    /// Returns the native trace ring buffer as Chrome trace event JSON.
+    let dumpNativeTraceChannel = FlutterBasicMessageChannel(name: "dev.flutter.pigeon.pro_video_player_platform_interface.ProVideoPlayerHostApi.dumpNativeTrace\(channelSuffix)", binaryMessenger: binaryMessenger, codec: codec)
+    if let api = api {
+      dumpNativeTraceChannel.setMessageHandler { _, reply in
+        api.dumpNativeTrace { result in
+          switch result {
+          case .success(let res):
+            reply(wrapResult(res))
+          case .failure(let error):
+            reply(wrapError(error))
+          }
+        }
+      }
+    } else {
+      dumpNativeTraceChannel.setMessageHandler(nil)
+    }
     /// Checks if Picture-in-Picture mode is supported.
     let supportsPictureInPictureChannel = FlutterBasicMessageChannel(name: "dev.flutter.pigeon.pro_video_player_platform_interface.ProVideoPlayerHostApi.supportsPictureInPicture\(channelSuffix)", binaryMessenger: binaryMessenger, codec: codec)
     if let api = api {
@@ -1948,6 +2041,72 @@ class ProVideoPlayerHostApiSetup {
     } else {
       setControlsModeChannel.setMessageHandler(nil)
     }
+    /// Reports the on-screen size of the player's video surface in physical pixels.
+    ///
+    /// Native players use this to cap decode resolution when the video is shown
+    /// much smaller than its native size (e.g. thumbnails in a grid).
+    let setDisplaySizeChannel = FlutterBasicMessageChannel(name: "dev.flutter.pigeon.pro_video_player_platform_interface.ProVideoPlayerHostApi.setDisplaySize\(channelSuffix)", binaryMessenger: binaryMessenger, codec: codec)
+    if let api = api {
+      setDisplaySizeChannel.setMessageHandler { message, reply in
+        let args = message as! [Any?]
+        let playerIdArg = args[0] as! Int64
+        let widthPxArg = args[1] as! Int64
+        let heightPxArg = args[2] as! Int64
+        api.setDisplaySize(playerId: playerIdArg, widthPx: widthPxArg, heightPx: heightPxArg) { result in
+          switch result {
+          case .success:
+            reply(wrapResult(nil))
+          case .failure(let error):
+            reply(wrapError(error))
+          }
+        }
+      }
+    } else {
+      setDisplaySizeChannel.setMessageHandler(nil)
+    }
+    /// Caps how many video frames per second the player renders.
+    ///
+    /// A negative [maxFps] renders at the video's native frame rate. Zero renders
+    /// no video frames at all while audio keeps playing.
+    let setMaxRenderFrameRateChannel = FlutterBasicMessageChannel(name: "dev.flutter.pigeon.pro_video_player_platform_interface.ProVideoPlayerHostApi.setMaxRenderFrameRate\(channelSuffix)", binaryMessenger: binaryMessenger, codec: codec)
+    if let api = api {
+      setMaxRenderFrameRateChannel.setMessageHandler { message, reply in
+        let args = message as! [Any?]
+        let playerIdArg = args[0] as! Int64
+        let maxFpsArg = args[1] as! Int64
+        api.setMaxRenderFrameRate(playerId: playerIdArg, maxFps: maxFpsArg) { result in
+          switch result {
+          case .success:
+            reply(wrapResult(nil))
+          case .failure(let error):
+            reply(wrapError(error))
+          }
+        }
+      }
+    } else {
+      setMaxRenderFrameRateChannel.setMessageHandler(nil)
+    }
+    /// Tells the player whether its view is currently visible on screen.
+    ///
+    /// Hidden players stop rendering video frames; audio is unaffected.
+    let setVisibilityHintChannel = FlutterBasicMessageChannel(name: "dev.flutter.pigeon.pro_video_player_platform_interface.ProVideoPlayerHostApi.setVisibilityHint\(channelSuffix)", binaryMessenger: binaryMessenger, codec: codec)
+    if let api = api {
+      setVisibilityHintChannel.setMessageHandler { message, reply in
+        let args = message as! [Any?]
+        let playerIdArg = args[0] as! Int64
+        let isVisibleArg = args[1] as! Bool
+        api.setVisibilityHint(playerId: playerIdArg, isVisible: isVisibleArg) { result in
+          switch result {
+          case .success:
+            reply(wrapResult(nil))
+          case .failure(let error):
+            reply(wrapError(error))
+          }
+        }
+      }
+    } else {
+      setVisibilityHintChannel.setMessageHandler(nil)
+    }
     /// Sets the active subtitle track.
     let setSubtitleTrackChannel = FlutterBasicMessageChannel(name: "dev.flutter.pigeon.pro_video_player_platform_interface.ProVideoPlayerHostApi.setSubtitleTrack\(channelSuffix)", binaryMessenger: binaryMessenger, codec: codec)
     if let api = api {
@@ -2332,6 +2491,48 @@ class ProVideoPlayerHostApiSetup {
     } else {
       setMediaMetadataChannel.setMessageHandler(nil)
     }
+    /// Gets a peak-amplitude summary of the whole file with at most
+    /// [bucketCount] entries (0-255 each). Null when unsupported.
+    let getWaveformChannel = FlutterBasicMessageChannel(name: "dev.flutter.pigeon.pro_video_player_platform_interface.ProVideoPlayerHostApi.getWaveform\(channelSuffix)", binaryMessenger: binaryMessenger, codec: codec)
+    if let api = api {
+      getWaveformChannel.setMessageHandler { message, reply in
+        let args = message as! [Any?]
+        let playerIdArg = args[0] as! Int64
+        let bucketCountArg = args[1] as! Int64
+        api.getWaveform(playerId: playerIdArg, bucketCount: bucketCountArg) { result in
+          switch result {
+          case .success(let res):
+            reply(wrapResult(res))
+          case .failure(let error):
+            reply(wrapError(error))
+          }
+        }
+      }
+    } else {
+      getWaveformChannel.setMessageHandler(nil)
+    }
+    /// Grabs the current video frame, scaled down to at most [maxWidth] pixels
+    /// wide (0 keeps the video's width) and encoded as [format] ('png', 'jpeg'
+    /// or 'raw' RGBA). Null when unsupported.
+    let captureFrameChannel = FlutterBasicMessageChannel(name: "dev.flutter.pigeon.pro_video_player_platform_interface.ProVideoPlayerHostApi.captureFrame\(channelSuffix)", binaryMessenger: binaryMessenger, codec: codec)
+    if let api = api {
+      captureFrameChannel.setMessageHandler { message, reply in
+        let args = message as! [Any?]
+        let playerIdArg = args[0] as! Int64
+        let maxWidthArg = args[1] as! Int64
+        let formatArg = args[2] as! String
+        api.captureFrame(playerId: playerIdArg, maxWidth: maxWidthArg, format: formatArg) { result in
+          switch result {
+          case .success(let res):
+            reply(wrapResult(res))
+          case .failure(let error):
+            reply(wrapError(error))
+          }
+        }
+      }
+    } else {
+      captureFrameChannel.setMessageHandler(nil)
+    }
     /// Checks if casting is supported on this platform.
     let isCastingSupportedChannel = FlutterBasicMessageChannel(name: "dev.flutter.pigeon.pro_video_player_platform_interface.ProVideoPlayerHostApi.isCastingSupported\(channelSuffix)", binaryMessenger: binaryMessenger, codec: codec)
     if let api = api {
@@ -0,0 +1,242 @@
+#include "local_http_server.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+
+namespace pro_video_player_benchmark {
+
+namespace {
+
+constexpr size_t kMaxRequestHeaderBytes = 16 * 1024;
+
+std::string ContentTypeFor(const std::string& path) {
+  auto ends_with = [&path](const char* suffix) {
+    const size_t len = std::strlen(suffix);
+    return path.size() >= len && path.compare(path.size() - len, len, suffix) == 0;
+  };
+  if (ends_with(".mp4") || ends_with(".m4v") || ends_with(".m4s")) return "video/mp4";
+  if (ends_with(".webm")) return "video/webm";
+  if (ends_with(".mkv")) return "video/x-matroska";
+  if (ends_with(".ts")) return "video/mp2t";
+  if (ends_with(".m3u8")) return "application/vnd.apple.mpegurl";
+  return "application/octet-stream";
+}
+
+bool SendAll(int fd, const std::string& data) {
+  size_t sent = 0;
+  while (sent < data.size()) {
+    const ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+    if (n <= 0) return false;
+    sent += static_cast<size_t>(n);
+  }
+  return true;
+}
+
+// Parses "bytes=start-end" / "bytes=start-" / "bytes=-suffix".
+// Returns false for anything else (multi-range is not supported).
+bool ParseRange(const std::string& value, uint64_t size, uint64_t* start, uint64_t* end) {
+  const std::string prefix = "bytes=";
+  if (value.compare(0, prefix.size(), prefix) != 0 || size == 0) return false;
+  const std::string spec = value.substr(prefix.size());
+  if (spec.find(',') != std::string::npos) return false;
+  const size_t dash = spec.find('-');
+  if (dash == std::string::npos) return false;
+
+  const std::string first = spec.substr(0, dash);
+  const std::string last = spec.substr(dash + 1);
+  try {
+    if (first.empty()) {
+      if (last.empty()) return false;
+      const uint64_t suffix = std::min<uint64_t>(std::stoull(last), size);
+      *start = size - suffix;
+      *end = size - 1;
+      return suffix > 0;
+    }
+    *start = std::stoull(first);
+    *end = last.empty() ? size - 1 : std::min<uint64_t>(std::stoull(last), size - 1);
+  } catch (const std::exception&) {
+    return false;
+  }
+  return *start <= *end;
+}
+
+}  // namespace
+
+LocalHttpServer::~LocalHttpServer() { Stop(); }
+
+void LocalHttpServer::AddFile(const std::string& url_path, const std::string& file_path) {
+  files_[url_path] = file_path;
+}
+
+bool LocalHttpServer::Start() {
+  listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+  if (listen_fd_ < 0) return false;
+
+  int reuse = 1;
+  setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = 0;
+  if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+      listen(listen_fd_, 64) != 0) {
+    close(listen_fd_);
+    listen_fd_ = -1;
+    return false;
+  }
+
+  socklen_t len = sizeof(addr);
+  getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+  port_ = ntohs(addr.sin_port);
+
+  running_ = true;
+  accept_thread_ = std::thread(&LocalHttpServer::AcceptLoop, this);
+  return true;
+}
+
+void LocalHttpServer::Stop() {
+  if (!running_.exchange(false)) return;
+  // Unblocks accept()
+  shutdown(listen_fd_, SHUT_RDWR);
+  close(listen_fd_);
+  listen_fd_ = -1;
+  if (accept_thread_.joinable()) accept_thread_.join();
+  for (auto& thread : connection_threads_) {
+    if (thread.joinable()) thread.join();
+  }
+  connection_threads_.clear();
+}
+
+std::string LocalHttpServer::BaseUrl() const {
+  return "http://127.0.0.1:" + std::to_string(port_) + "/";
+}
+
+void LocalHttpServer::AcceptLoop() {
+  while (running_) {
+    const int client_fd = accept(listen_fd_, nullptr, nullptr);
+    if (client_fd < 0) {
+      if (!running_) break;
+      continue;
+    }
+    // Short receive timeout so idle keep-alive connections notice Stop()
+    timeval timeout{1, 0};
+    setsockopt(client_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    connection_threads_.emplace_back(&LocalHttpServer::HandleConnection, this, client_fd);
+  }
+}
+
+void LocalHttpServer::HandleConnection(int client_fd) {
+  std::string buffer;
+  char chunk[4096];
+
+  while (running_) {
+    // Read one request header block
+    size_t header_end;
+    while ((header_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+      const ssize_t n = recv(client_fd, chunk, sizeof(chunk), 0);
+      if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) && running_) continue;
+      if (n <= 0 || buffer.size() > kMaxRequestHeaderBytes) {
+        close(client_fd);
+        return;
+      }
+      buffer.append(chunk, static_cast<size_t>(n));
+    }
+    const std::string header = buffer.substr(0, header_end);
+    buffer.erase(0, header_end + 4);
+
+    std::istringstream lines(header);
+    std::string method;
+    std::string target;
+    std::string version;
+    lines >> method >> target >> version;
+
+    std::string range;
+    bool keep_alive = version == "HTTP/1.1";
+    std::string line;
+    std::getline(lines, line);
+    while (std::getline(lines, line)) {
+      if (!line.empty() && line.back() == '\r') line.pop_back();
+      const size_t colon = line.find(':');
+      if (colon == std::string::npos) continue;
+      std::string name = line.substr(0, colon);
+      std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+      std::string value = line.substr(colon + 1);
+      value.erase(0, value.find_first_not_of(' '));
+      if (name == "range") range = value;
+      if (name == "connection") {
+        std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+        keep_alive = value != "close";
+      }
+    }
+
+    const size_t query = target.find('?');
+    if (query != std::string::npos) target.erase(query);
+    const bool head_only = method == "HEAD";
+    const auto file = files_.find(target);
+    const std::string path = file != files_.end() ? file->second : std::string();
+    struct stat st {};
+    const int file_fd =
+        (method == "GET" || head_only) && !path.empty() ? open(path.c_str(), O_RDONLY) : -1;
+    if (file_fd < 0 || fstat(file_fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+      if (file_fd >= 0) close(file_fd);
+      SendAll(client_fd, "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+      close(client_fd);
+      return;
+    }
+
+    const uint64_t size = static_cast<uint64_t>(st.st_size);
+    uint64_t start = 0;
+    uint64_t end = size == 0 ? 0 : size - 1;
+    const bool partial = !range.empty() && ParseRange(range, size, &start, &end);
+    if (!range.empty() && !partial) {
+      close(file_fd);
+      SendAll(client_fd, "HTTP/1.1 416 Range Not Satisfiable\r\nContent-Range: bytes */" +
+                             std::to_string(size) + "\r\nContent-Length: 0\r\n\r\n");
+      continue;
+    }
+    const uint64_t length = size == 0 ? 0 : end - start + 1;
+
+    std::string response = partial ? "HTTP/1.1 206 Partial Content\r\n" : "HTTP/1.1 200 OK\r\n";
+    response += "Content-Type: " + ContentTypeFor(path) + "\r\n";
+    response += "Accept-Ranges: bytes\r\n";
+    response += "Content-Length: " + std::to_string(length) + "\r\n";
+    if (partial) {
+      response += "Content-Range: bytes " + std::to_string(start) + "-" + std::to_string(end) +
+                  "/" + std::to_string(size) + "\r\n";
+    }
+    response += keep_alive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+
+    bool ok = SendAll(client_fd, response);
+    if (ok && !head_only) {
+      off_t offset = static_cast<off_t>(start);
+      uint64_t remaining = length;
+      while (ok && remaining > 0 && running_) {
+        const ssize_t n = sendfile(client_fd, file_fd, &offset, std::min<uint64_t>(remaining, 1 << 20));
+        if (n <= 0) {
+          // Player closed the connection mid-body (normal after a seek)
+          ok = false;
+          break;
+        }
+        remaining -= static_cast<uint64_t>(n);
+        bytes_served_ += static_cast<uint64_t>(n);
+      }
+    }
+    close(file_fd);
+    if (!ok || !keep_alive) break;
+  }
+  close(client_fd);
+}
+
+}  // namespace pro_video_player_benchmark
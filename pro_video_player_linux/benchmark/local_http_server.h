@@ -0,0 +1,58 @@
+#ifndef PRO_VIDEO_PLAYER_LINUX_BENCHMARK_LOCAL_HTTP_SERVER_H_
+#define PRO_VIDEO_PLAYER_LINUX_BENCHMARK_LOCAL_HTTP_SERVER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pro_video_player_benchmark {
+
+// Minimal HTTP/1.1 file server bound to 127.0.0.1.
+//
+// Stands in for a CDN so network playback can be benchmarked without
+// external traffic. Supports GET/HEAD, keep-alive and single byte ranges,
+// which is all souphttpsrc needs for progressive playback and seeking.
+class LocalHttpServer {
+ public:
+  LocalHttpServer() = default;
+  ~LocalHttpServer();
+
+  LocalHttpServer(const LocalHttpServer&) = delete;
+  LocalHttpServer& operator=(const LocalHttpServer&) = delete;
+
+  // Publishes |file_path| at |url_path| (e.g. "/0.mp4"). Call before Start().
+  void AddFile(const std::string& url_path, const std::string& file_path);
+
+  // Binds an ephemeral port and starts accepting connections.
+  // Returns false if the socket could not be set up.
+  bool Start();
+
+  // Stops accepting and joins all connection threads.
+  void Stop();
+
+  // Returns "http://127.0.0.1:<port>/" once started.
+  std::string BaseUrl() const;
+
+  // Total response body bytes written so far.
+  uint64_t BytesServed() const { return bytes_served_.load(); }
+
+ private:
+  void AcceptLoop();
+  void HandleConnection(int client_fd);
+
+  // URL path -> file path; read-only once started
+  std::map<std::string, std::string> files_;
+  int listen_fd_ = -1;
+  uint16_t port_ = 0;
+  std::atomic<bool> running_{false};
+  std::atomic<uint64_t> bytes_served_{0};
+  std::thread accept_thread_;
+  std::vector<std::thread> connection_threads_;
+};
+
+}  // namespace pro_video_player_benchmark
+
+#endif  // PRO_VIDEO_PLAYER_LINUX_BENCHMARK_LOCAL_HTTP_SERVER_H_
@@ -0,0 +1,717 @@
+// Headless GStreamer baseline benchmark. It does NOT measure the player.
+//
+// Runs N concurrent bare playbins with fake sinks and no Flutter embedder
+// and reports decode fps, CPU per stream, RSS, time to first frame, seek
+// latency and dropped frames. Driven by `make benchmark-linux`.
+//
+// Nothing here goes through the shared player core (PlayerManager, Player,
+// its render policy or the libmpv backend), and the Linux plugin does not
+// use the core yet either. The numbers are what GStreamer demux, decode and
+// convert cost on this machine: a baseline to compare engines against, not
+// the cost of playing through pro_video_player.
+
+#include <dirent.h>
+#include <gst/gst.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "local_http_server.h"
+#include "trace_recorder.h"
+
+namespace pro_video_player_benchmark {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double MsBetween(Clock::time_point from, Clock::time_point to) {
+  return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+struct Options {
+  int players = 4;
+  double duration_s = 20.0;
+  int seeks = 5;
+  bool http = false;
+  bool convert = true;
+  bool sync = true;
+  bool json = false;
+  std::string trace_path;
+  std::string generate_size = "1920x1080";
+  std::vector<std::string> media;
+};
+
+void PrintUsage(const char* argv0) {
+  std::fprintf(stderr,
+               "Usage: %s [options]\n"
+               "GStreamer baseline only: plays through bare playbins. The player core\n"
+               "(PlayerManager, Player, the libmpv backend) is not exercised, so the\n"
+               "numbers are not the cost of playing through pro_video_player.\n"
+               "  --players N        concurrent players (default 4)\n"
+               "  --duration SEC     measured playback time (default 20)\n"
+               "  --seeks N          seeks per player in the second half (default 5)\n"
+               "  --media PATH       media file or directory; repeatable. Without it a\n"
+               "                     10s test clip is generated with the first available encoder\n"
+               "  --generate WxH     size of the generated clip (default 1920x1080)\n"
+               "  --http             play through the local HTTP server instead of file://\n"
+               "  --no-convert       skip RGBA conversion (decode cost only)\n"
+               "  --max-speed        unsynchronised sinks: measures raw decode throughput\n"
+               "  --json             machine-readable output\n"
+               "  --trace FILE       write a Chrome trace of the run to FILE\n",
+               argv0);
+}
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    auto next = [&](const char* name) -> const char* {
+      if (i + 1 >= argc) {
+        std::fprintf(stderr, "%s requires a value\n", name);
+        return nullptr;
+      }
+      return argv[++i];
+    };
+    if (arg == "--players") {
+      const char* value = next("--players");
+      if (value == nullptr) return false;
+      options->players = std::max(1, std::atoi(value));
+    } else if (arg == "--duration") {
+      const char* value = next("--duration");
+      if (value == nullptr) return false;
+      options->duration_s = std::max(1.0, std::atof(value));
+    } else if (arg == "--seeks") {
+      const char* value = next("--seeks");
+      if (value == nullptr) return false;
+      options->seeks = std::max(0, std::atoi(value));
+    } else if (arg == "--media") {
+      const char* value = next("--media");
+      if (value == nullptr) return false;
+      options->media.emplace_back(value);
+    } else if (arg == "--generate") {
+      const char* value = next("--generate");
+      if (value == nullptr) return false;
+      options->generate_size = value;
+    } else if (arg == "--http") {
+      options->http = true;
+    } else if (arg == "--no-convert") {
+      options->convert = false;
+    } else if (arg == "--max-speed") {
+      options->sync = false;
+    } else if (arg == "--trace") {
+      const char* value = next("--trace");
+      if (value == nullptr) return false;
+      options->trace_path = value;
+    } else if (arg == "--json") {
+      options->json = true;
+    } else {
+      PrintUsage(argv[0]);
+      return false;
+    }
+  }
+  return true;
+}
+
+bool IsMediaFile(const std::string& name) {
+  static const char* kExtensions[] = {".mp4", ".m4v", ".mov", ".mkv", ".webm", ".ts", ".avi"};
+  for (const char* ext : kExtensions) {
+    const size_t len = std::strlen(ext);
+    if (name.size() > len && name.compare(name.size() - len, len, ext) == 0) return true;
+  }
+  return false;
+}
+
+// Expands directories into the media files they contain, sorted by name.
+std::vector<std::string> CollectMedia(const std::vector<std::string>& paths) {
+  std::vector<std::string> files;
+  for (const auto& path : paths) {
+    struct stat st {};
+    if (stat(path.c_str(), &st) != 0) {
+      std::fprintf(stderr, "warning: %s not found\n", path.c_str());
+      continue;
+    }
+    if (!S_ISDIR(st.st_mode)) {
+      files.push_back(path);
+      continue;
+    }
+    std::vector<std::string> entries;
+    if (DIR* dir = opendir(path.c_str())) {
+      while (dirent* entry = readdir(dir)) {
+        if (IsMediaFile(entry->d_name)) entries.push_back(path + "/" + entry->d_name);
+      }
+      closedir(dir);
+    }
+    std::sort(entries.begin(), entries.end());
+    files.insert(files.end(), entries.begin(), entries.end());
+  }
+  return files;
+}
+
+// Temporary directory for the generated clip; removed with its files when
+// the run ends, however it ends.
+class TempDir {
+ public:
+  TempDir() {
+    char dir_template[] = "/tmp/pvp-benchmark-XXXXXX";
+    if (mkdtemp(dir_template) != nullptr) path_ = dir_template;
+  }
+  ~TempDir() {
+    if (path_.empty()) return;
+    if (DIR* dir = opendir(path_.c_str())) {
+      while (dirent* entry = readdir(dir)) {
+        if (std::strcmp(entry->d_name, ".") != 0 && std::strcmp(entry->d_name, "..") != 0) {
+          unlink((path_ + "/" + entry->d_name).c_str());
+        }
+      }
+      closedir(dir);
+    }
+    rmdir(path_.c_str());
+  }
+
+  TempDir(const TempDir&) = delete;
+  TempDir& operator=(const TempDir&) = delete;
+
+  // Empty if the directory couldn't be created.
+  const std::string& path() const { return path_; }
+
+ private:
+  std::string path_;
+};
+
+// Encodes a 10 second moving test pattern into |dir| with whichever encoder
+// the installed plugin set provides. Returns the file path or "" on failure.
+std::string GenerateClip(const std::string& size, const std::string& dir) {
+  int width = 1920;
+  int height = 1080;
+  std::sscanf(size.c_str(), "%dx%d", &width, &height);
+
+  struct Encoder {
+    const char* element;
+    const char* chain;
+    const char* extension;
+  };
+  static const Encoder kEncoders[] = {
+      {"x264enc", "x264enc speed-preset=ultrafast key-int-max=60 ! h264parse ! mp4mux", ".mp4"},
+      {"openh264enc", "openh264enc ! h264parse ! mp4mux", ".mp4"},
+      {"vp8enc", "vp8enc deadline=1 keyframe-max-dist=60 ! webmmux", ".webm"},
+      {"avenc_mpeg4", "avenc_mpeg4 ! mpeg4videoparse ! mp4mux", ".mp4"},
+  };
+
+  for (const auto& encoder : kEncoders) {
+    GstElementFactory* factory = gst_element_factory_find(encoder.element);
+    if (factory == nullptr) continue;
+    gst_object_unref(factory);
+
+    const std::string path = dir + "/clip-" + size + encoder.extension;
+    gchar* description = g_strdup_printf(
+        "videotestsrc num-buffers=300 pattern=ball ! "
+        "video/x-raw,width=%d,height=%d,framerate=30/1 ! videoconvert ! %s ! "
+        "filesink location=\"%s\"",
+        width, height, encoder.chain, path.c_str());
+    GError* error = nullptr;
+    GstElement* pipeline = gst_parse_launch(description, &error);
+    g_free(description);
+    if (pipeline == nullptr) {
+      g_clear_error(&error);
+      continue;
+    }
+
+    gst_element_set_state(pipeline, GST_STATE_PLAYING);
+    GstBus* bus = gst_element_get_bus(pipeline);
+    GstMessage* message = gst_bus_timed_pop_filtered(
+        bus, GST_CLOCK_TIME_NONE, static_cast<GstMessageType>(GST_MESSAGE_EOS | GST_MESSAGE_ERROR));
+    const bool ok = message != nullptr && GST_MESSAGE_TYPE(message) == GST_MESSAGE_EOS;
+    if (message != nullptr) gst_message_unref(message);
+    gst_object_unref(bus);
+    gst_element_set_state(pipeline, GST_STATE_NULL);
+    gst_object_unref(pipeline);
+
+    if (ok) {
+      std::fprintf(stderr, "Generated %s with %s\n", path.c_str(), encoder.element);
+      return path;
+    }
+    unlink(path.c_str());
+  }
+  return "";
+}
+
+// Resident set size in KiB from /proc/self/status ("VmRSS" or "VmHWM").
+long ReadStatusKb(const char* key) {
+  FILE* file = std::fopen("/proc/self/status", "r");
+  if (file == nullptr) return 0;
+  char line[256];
+  long value = 0;
+  const size_t key_len = std::strlen(key);
+  while (std::fgets(line, sizeof(line), file) != nullptr) {
+    if (std::strncmp(line, key, key_len) == 0 && line[key_len] == ':') {
+      value = std::atol(line + key_len + 1);
+      break;
+    }
+  }
+  std::fclose(file);
+  return value;
+}
+
+double ProcessCpuSeconds() {
+  rusage usage {};
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 + usage.ru_stime.tv_sec +
+         usage.ru_stime.tv_usec / 1e6;
+}
+
+struct PlayerReport {
+  int index = 0;
+  std::string uri;
+  double ttff_ms = -1;
+  uint64_t frames = 0;
+  double fps = 0;
+  uint64_t dropped = 0;
+  std::vector<double> seek_ms;
+  int loops = 0;
+  std::string error;
+};
+
+// One playbin pipeline rendering into fake sinks.
+//
+// The video sink mirrors what the plugin does per frame (convert to RGBA,
+// hand the buffer to the renderer) minus the texture upload.
+class BenchmarkPlayer {
+ public:
+  BenchmarkPlayer(int index, std::string uri) : index_(index), uri_(std::move(uri)) {}
+
+  ~BenchmarkPlayer() {
+    if (pipeline_ != nullptr) {
+      gst_element_set_state(pipeline_, GST_STATE_NULL);
+      gst_object_unref(pipeline_);
+    }
+  }
+
+  bool Start(const Options& options) {
+    pipeline_ = gst_element_factory_make("playbin", nullptr);
+    if (pipeline_ == nullptr) {
+      error_ = "playbin not available";
+      return false;
+    }
+
+    const std::string sink_description =
+        std::string(options.convert ? "videoconvert ! video/x-raw,format=RGBA ! " : "") +
+        "fakesink name=vsink qos=true signal-handoffs=true sync=" + (options.sync ? "true" : "false");
+    GError* error = nullptr;
+    GstElement* video_sink = gst_parse_bin_from_description(sink_description.c_str(), TRUE, &error);
+    if (video_sink == nullptr) {
+      error_ = error != nullptr ? error->message : "could not build video sink";
+      g_clear_error(&error);
+      return false;
+    }
+    GstElement* fakesink = gst_bin_get_by_name(GST_BIN(video_sink), "vsink");
+    g_signal_connect(fakesink, "handoff", G_CALLBACK(&BenchmarkPlayer::OnHandoff), this);
+    gst_object_unref(fakesink);
+
+    GstElement* audio_sink = gst_element_factory_make("fakesink", nullptr);
+    g_object_set(audio_sink, "sync", options.sync ? TRUE : FALSE, nullptr);
+    g_object_set(pipeline_, "uri", uri_.c_str(), "video-sink", video_sink, "audio-sink", audio_sink,
+                 nullptr);
+
+    GstBus* bus = gst_element_get_bus(pipeline_);
+    bus_watch_ = gst_bus_add_watch(bus, &BenchmarkPlayer::OnBusMessage, this);
+    gst_object_unref(bus);
+
+    start_time_ = Clock::now();
+    return gst_element_set_state(pipeline_, GST_STATE_PLAYING) != GST_STATE_CHANGE_FAILURE;
+  }
+
+  // Flushing keyframe seek; latency is measured up to the next rendered frame.
+  void SeekToFraction(double fraction) {
+    gint64 duration = 0;
+    if (!error_.empty() || !gst_element_query_duration(pipeline_, GST_FORMAT_TIME, &duration) ||
+        duration <= 0) {
+      return;
+    }
+    const gint64 target = static_cast<gint64>(duration * fraction);
+    PVP_TRACE_SCOPE_PLAYER("pipeline", "seek", index_);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      seek_issued_ = Clock::now();
+    }
+    if (gst_element_seek_simple(pipeline_, GST_FORMAT_TIME,
+                                static_cast<GstSeekFlags>(GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_KEY_UNIT),
+                                target)) {
+      seek_pending_ = true;
+    }
+  }
+
+  void Stop() {
+    end_time_ = Clock::now();
+    if (bus_watch_ != 0) {
+      g_source_remove(bus_watch_);
+      bus_watch_ = 0;
+    }
+    gst_element_set_state(pipeline_, GST_STATE_NULL);
+  }
+
+  PlayerReport Report() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PlayerReport report;
+    report.index = index_;
+    report.uri = uri_;
+    report.frames = frames_.load();
+    if (first_frame_seen_) {
+      report.ttff_ms = MsBetween(start_time_, first_frame_time_);
+      const double seconds = MsBetween(first_frame_time_, end_time_) / 1000.0;
+      if (seconds > 0) report.fps = report.frames / seconds;
+    }
+    for (const auto& entry : dropped_by_element_) report.dropped += entry.second;
+    report.seek_ms = seek_ms_;
+    report.loops = loops_;
+    report.error = error_;
+    return report;
+  }
+
+ private:
+  // Streaming thread
+  static void OnHandoff(GstElement*, GstBuffer*, GstPad*, gpointer user_data) {
+    auto* self = static_cast<BenchmarkPlayer*>(user_data);
+    PVP_TRACE_INSTANT("render", "present", self->index_);
+    const auto now = Clock::now();
+    self->frames_++;
+    if (!self->first_frame_seen_ || self->seek_pending_) {
+      std::lock_guard<std::mutex> lock(self->mutex_);
+      if (!self->first_frame_seen_) {
+        self->first_frame_time_ = now;
+        self->first_frame_seen_ = true;
+      }
+      if (self->seek_pending_.exchange(false)) {
+        self->seek_ms_.push_back(MsBetween(self->seek_issued_, now));
+      }
+    }
+  }
+
+  // Main loop thread
+  static gboolean OnBusMessage(GstBus*, GstMessage* message, gpointer user_data) {
+    auto* self = static_cast<BenchmarkPlayer*>(user_data);
+    switch (GST_MESSAGE_TYPE(message)) {
+      case GST_MESSAGE_ERROR: {
+        GError* error = nullptr;
+        gst_message_parse_error(message, &error, nullptr);
+        std::lock_guard<std::mutex> lock(self->mutex_);
+        self->error_ = error != nullptr ? error->message : "unknown error";
+        g_clear_error(&error);
+        break;
+      }
+      case GST_MESSAGE_STATE_CHANGED: {
+        if (GST_MESSAGE_SRC(message) != GST_OBJECT(self->pipeline_)) break;
+        GstState old_state;
+        GstState new_state;
+        gst_message_parse_state_changed(message, &old_state, &new_state, nullptr);
+        // Names must be literals for the recorder
+        static const char* kStateNames[] = {"state VOID_PENDING", "state NULL", "state READY",
+                                            "state PAUSED", "state PLAYING"};
+        if (new_state >= GST_STATE_VOID_PENDING && new_state <= GST_STATE_PLAYING) {
+          PVP_TRACE_INSTANT("pipeline", kStateNames[new_state], self->index_);
+        }
+        break;
+      }
+      case GST_MESSAGE_EOS:
+        // Loop so short clips cover the whole measurement window
+        PVP_TRACE_INSTANT("pipeline", "eos", self->index_);
+        self->loops_++;
+        gst_element_seek_simple(self->pipeline_, GST_FORMAT_TIME, GST_SEEK_FLAG_FLUSH, 0);
+        break;
+      case GST_MESSAGE_QOS: {
+        PVP_TRACE_INSTANT("render", "qos", self->index_);
+        // Dropped counts are cumulative per element (sink and decoders)
+        GstFormat format;
+        guint64 processed = 0;
+        guint64 dropped = 0;
+        gst_message_parse_qos_stats(message, &format, &processed, &dropped);
+        if (format == GST_FORMAT_BUFFERS) {
+          std::lock_guard<std::mutex> lock(self->mutex_);
+          auto& count = self->dropped_by_element_[GST_OBJECT_NAME(GST_MESSAGE_SRC(message))];
+          count = std::max<uint64_t>(count, dropped);
+        }
+        break;
+      }
+      default:
+        break;
+    }
+    return G_SOURCE_CONTINUE;
+  }
+
+  const int index_;
+  const std::string uri_;
+  GstElement* pipeline_ = nullptr;
+  guint bus_watch_ = 0;
+
+  std::atomic<uint64_t> frames_{0};
+  std::atomic<bool> first_frame_seen_{false};
+  std::atomic<bool> seek_pending_{false};
+
+  mutable std::mutex mutex_;
+  Clock::time_point start_time_;
+  Clock::time_point first_frame_time_;
+  Clock::time_point end_time_;
+  Clock::time_point seek_issued_;
+  std::vector<double> seek_ms_;
+  std::map<std::string, uint64_t> dropped_by_element_;
+  int loops_ = 0;
+  std::string error_;
+};
+
+struct Summary {
+  double wall_s = 0;
+  double cpu_percent = 0;
+  long rss_kb = 0;
+  long peak_rss_kb = 0;
+  uint64_t http_bytes = 0;
+};
+
+// |value| as a quoted JSON string.
+std::string JsonString(const std::string& value) {
+  std::string out = "\"";
+  for (char c : value) {
+    switch (c) {
+      case '"':
+        out += "\\\"";
+        break;
+      case '\\':
+        out += "\\\\";
+        break;
+      case '\n':
+        out += "\\n";
+        break;
+      case '\r':
+        out += "\\r";
+        break;
+      case '\t':
+        out += "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char escaped[8];
+          std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+          out += escaped;
+        } else {
+          out += c;
+        }
+    }
+  }
+  return out + "\"";
+}
+
+double Average(const std::vector<double>& values) {
+  if (values.empty()) return -1;
+  double sum = 0;
+  for (double v : values) sum += v;
+  return sum / values.size();
+}
+
+double Max(const std::vector<double>& values) {
+  return values.empty() ? -1 : *std::max_element(values.begin(), values.end());
+}
+
+void PrintText(const Options& options, const std::vector<PlayerReport>& reports, const Summary& summary) {
+  std::printf("\n%-4s %10s %8s %8s %8s %10s %10s %6s  %s\n", "id", "ttff_ms", "frames", "fps",
+              "dropped", "seek_avg", "seek_max", "loops", "uri");
+  double total_fps = 0;
+  uint64_t total_dropped = 0;
+  std::vector<double> ttffs;
+  std::vector<double> seeks;
+  for (const auto& r : reports) {
+    std::printf("%-4d %10.1f %8llu %8.1f %8llu %10.1f %10.1f %6d  %s%s%s\n", r.index, r.ttff_ms,
+                static_cast<unsigned long long>(r.frames), r.fps,
+                static_cast<unsigned long long>(r.dropped), Average(r.seek_ms), Max(r.seek_ms), r.loops,
+                r.uri.c_str(), r.error.empty() ? "" : "  ERROR: ", r.error.c_str());
+    total_fps += r.fps;
+    total_dropped += r.dropped;
+    if (r.ttff_ms >= 0) ttffs.push_back(r.ttff_ms);
+    seeks.insert(seeks.end(), r.seek_ms.begin(), r.seek_ms.end());
+  }
+  std::printf("\nengine=gstreamer-playbin (baseline, not the player core)\n");
+  std::printf("players=%d duration=%.0fs convert=%s sync=%s source=%s\n", options.players,
+              summary.wall_s, options.convert ? "rgba" : "none", options.sync ? "yes" : "no",
+              options.http ? "http" : "file");
+  std::printf("fps total=%.1f per-stream=%.1f\n", total_fps, total_fps / reports.size());
+  std::printf("cpu total=%.1f%% per-stream=%.1f%%\n", summary.cpu_percent,
+              summary.cpu_percent / reports.size());
+  std::printf("rss=%.1fMiB peak=%.1fMiB\n", summary.rss_kb / 1024.0, summary.peak_rss_kb / 1024.0);
+  std::printf("ttff avg=%.1fms max=%.1fms\n", Average(ttffs), Max(ttffs));
+  std::printf("seek avg=%.1fms max=%.1fms (n=%zu)\n", Average(seeks), Max(seeks), seeks.size());
+  std::printf("dropped=%llu\n", static_cast<unsigned long long>(total_dropped));
+  if (options.http) {
+    std::printf("http bytes=%.1fMiB\n", summary.http_bytes / (1024.0 * 1024.0));
+  }
+}
+
+void PrintJson(const Options& options, const std::vector<PlayerReport>& reports, const Summary& summary) {
+  std::printf("{\n  \"engine\": \"gstreamer-playbin\",\n  \"players\": %d,\n  \"duration_s\": %.3f,\n"
+              "  \"convert\": %s,\n  \"sync\": %s,\n"
+              "  \"source\": \"%s\",\n  \"cpu_percent\": %.2f,\n  \"cpu_percent_per_stream\": %.2f,\n"
+              "  \"rss_kb\": %ld,\n  \"peak_rss_kb\": %ld,\n  \"http_bytes\": %llu,\n  \"streams\": [\n",
+              options.players, summary.wall_s, options.convert ? "true" : "false",
+              options.sync ? "true" : "false", options.http ? "http" : "file", summary.cpu_percent,
+              summary.cpu_percent / reports.size(), summary.rss_kb, summary.peak_rss_kb,
+              static_cast<unsigned long long>(summary.http_bytes));
+  for (size_t i = 0; i < reports.size(); ++i) {
+    const auto& r = reports[i];
+    std::printf("    {\"id\": %d, \"uri\": %s, \"ttff_ms\": %.2f, \"frames\": %llu, \"fps\": %.2f, "
+                "\"dropped\": %llu, \"loops\": %d, \"seek_ms\": [",
+                r.index, JsonString(r.uri).c_str(), r.ttff_ms, static_cast<unsigned long long>(r.frames), r.fps,
+                static_cast<unsigned long long>(r.dropped), r.loops);
+    for (size_t s = 0; s < r.seek_ms.size(); ++s) {
+      std::printf("%s%.2f", s == 0 ? "" : ", ", r.seek_ms[s]);
+    }
+    std::printf("], \"error\": %s}%s\n", r.error.empty() ? "null" : JsonString(r.error).c_str(),
+                i + 1 < reports.size() ? "," : "");
+  }
+  std::printf("  ]\n}\n");
+}
+
+struct RunState {
+  GMainLoop* loop = nullptr;
+  std::vector<std::unique_ptr<BenchmarkPlayer>>* players = nullptr;
+  int seeks_remaining = 0;
+  guint seek_interval_ms = 0;
+  std::mt19937 random{42};
+};
+
+}  // namespace
+
+int Run(int argc, char** argv) {
+  gst_init(&argc, &argv);
+  pro_video_player::TraceRecorder::Instance().SetCurrentThreadName("main");
+
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) return 2;
+
+  std::vector<std::string> media = CollectMedia(options.media);
+  std::unique_ptr<TempDir> clip_dir;
+  if (options.media.empty()) {
+    clip_dir = std::make_unique<TempDir>();
+    const std::string clip = clip_dir->path().empty() ? "" : GenerateClip(options.generate_size, clip_dir->path());
+    if (clip.empty()) {
+      std::fprintf(stderr, "No --media given and no encoder available to generate a clip\n");
+      return 2;
+    }
+    media.push_back(clip);
+  }
+  if (media.empty()) {
+    std::fprintf(stderr, "No media files found\n");
+    return 2;
+  }
+
+  LocalHttpServer server;
+  if (options.http) {
+    for (size_t i = 0; i < media.size(); ++i) {
+      const std::string& path = media[i];
+      server.AddFile("/" + std::to_string(i) + "-" + path.substr(path.find_last_of('/') + 1), path);
+    }
+    if (!server.Start()) {
+      std::fprintf(stderr, "Could not start local HTTP server\n");
+      return 2;
+    }
+  }
+
+  std::vector<std::unique_ptr<BenchmarkPlayer>> players;
+  for (int i = 0; i < options.players; ++i) {
+    const size_t file_index = i % media.size();
+    const std::string& path = media[file_index];
+    std::string uri;
+    if (options.http) {
+      uri = server.BaseUrl() + std::to_string(file_index) + "-" + path.substr(path.find_last_of('/') + 1);
+    } else {
+      gchar* file_uri = gst_filename_to_uri(path.c_str(), nullptr);
+      uri = file_uri != nullptr ? file_uri : path;
+      g_free(file_uri);
+    }
+    players.push_back(std::make_unique<BenchmarkPlayer>(i, uri));
+  }
+
+  const double cpu_start = ProcessCpuSeconds();
+  const auto wall_start = Clock::now();
+  for (auto& player : players) {
+    if (!player->Start(options)) std::fprintf(stderr, "player failed to start\n");
+  }
+
+  RunState state;
+  state.loop = g_main_loop_new(nullptr, FALSE);
+  state.players = &players;
+  state.seeks_remaining = options.seeks;
+
+  // Seeks are spread over the second half so TTFF and steady-state decode
+  // in the first half aren't disturbed.
+  const guint duration_ms = static_cast<guint>(options.duration_s * 1000);
+  if (options.seeks > 0) {
+    state.seek_interval_ms = std::max<guint>(duration_ms / 2 / (options.seeks + 1), 100);
+    g_timeout_add(duration_ms / 2, [](gpointer data) -> gboolean {
+      auto* state = static_cast<RunState*>(data);
+      g_timeout_add(state->seek_interval_ms, [](gpointer data) -> gboolean {
+        auto* state = static_cast<RunState*>(data);
+        std::uniform_real_distribution<double> position(0.0, 0.9);
+        for (auto& player : *state->players) player->SeekToFraction(position(state->random));
+        return --state->seeks_remaining > 0 ? G_SOURCE_CONTINUE : G_SOURCE_REMOVE;
+      }, state);
+      return G_SOURCE_REMOVE;
+    }, &state);
+  }
+  g_timeout_add(duration_ms, [](gpointer data) -> gboolean {
+    g_main_loop_quit(static_cast<RunState*>(data)->loop);
+    return G_SOURCE_REMOVE;
+  }, &state);
+
+  g_main_loop_run(state.loop);
+
+  Summary summary;
+  summary.wall_s = MsBetween(wall_start, Clock::now()) / 1000.0;
+  summary.cpu_percent = (ProcessCpuSeconds() - cpu_start) / summary.wall_s * 100.0;
+  summary.rss_kb = ReadStatusKb("VmRSS");
+  summary.peak_rss_kb = ReadStatusKb("VmHWM");
+
+  std::vector<PlayerReport> reports;
+  for (auto& player : players) {
+    player->Stop();
+    reports.push_back(player->Report());
+  }
+  summary.http_bytes = server.BytesServed();
+  server.Stop();
+  g_main_loop_unref(state.loop);
+
+  if (!options.trace_path.empty()) {
+    const std::string trace = pro_video_player::TraceRecorder::Instance().DumpJson();
+    if (FILE* file = std::fopen(options.trace_path.c_str(), "w")) {
+      std::fwrite(trace.data(), 1, trace.size(), file);
+      std::fclose(file);
+      std::fprintf(stderr, "Trace written to %s\n", options.trace_path.c_str());
+    } else {
+      std::fprintf(stderr, "warning: could not write trace to %s\n", options.trace_path.c_str());
+    }
+  }
+
+  if (options.json) {
+    PrintJson(options, reports, summary);
+  } else {
+    PrintText(options, reports, summary);
+  }
+
+  // Non-zero when any stream failed so scripts can gate on it
+  for (const auto& r : reports) {
+    if (!r.error.empty() || r.frames == 0) return 1;
+  }
+  return 0;
+}
+
+}  // namespace pro_video_player_benchmark
+
+int main(int argc, char** argv) { return pro_video_player_benchmark::Run(argc, argv); }
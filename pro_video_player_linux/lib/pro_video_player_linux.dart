@@ -24,6 +24,41 @@ class ProVideoPlayerLinux extends PigeonMethodChannelBase {
   @override
   Future<bool> isPipSupported() async => false; // PiP not typically supported on Linux
 
+  @override
+  Future<void> setDisplaySize(int playerId, int widthPx, int heightPx) async {
+    // Decode downscaling not yet available on Linux (placeholder - native implementation needed)
+  }
+
+  @override
+  Future<void> setMaxRenderFrameRate(int playerId, int? maxFps) async {
+    // Render-rate cap not yet available on Linux (placeholder - native implementation needed)
+  }
+
+  @override
+  Future<void> setVisibilityHint(int playerId, {required bool isVisible}) async {
+    // Visibility hint not yet available on Linux (placeholder - native implementation needed)
+  }
+
+  @override
+  Future<String> dumpNativeTrace() async =>
+      // Trace export not yet available on Linux (placeholder - native implementation needed)
+      '{"traceEvents":[]}';
+
+  @override
+  Future<Uint8List?> getWaveform(int playerId, int bucketCount) async =>
+      // Waveform summaries not yet available on Linux (placeholder - native implementation needed)
+      null;
+
+  @override
+  Future<CapturedFrame?> captureFrame(
+    int playerId, {
+    int maxWidth = 0,
+    CaptureFormat format = CaptureFormat.png,
+  }) async {
+    // Frame capture not yet available on Linux (placeholder - native implementation needed)
+    return null;
+  }
+
   @override
   Future<PlatformInfo> getPlatformInfo() async =>
       const PlatformInfo(platformName: 'Linux', nativePlayerType: 'GStreamer (placeholder)');
@@ -28,6 +28,10 @@ void pro_video_player_linux_plugin_register_with_registrar(FlPluginRegistrar* re
 
   // TODO: Register Pigeon API when Linux implementation is complete
   // For now, this is a placeholder plugin with no functionality
+  //
+  // Keep this cheap: app start-up runs it. Register backends and the API
+  // here, but no engine init, registry scans or threads; PlayerManager
+  // starts an engine on the first Create() or WarmUp().
 
   g_object_unref(plugin);
 }
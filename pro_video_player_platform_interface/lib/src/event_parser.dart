@@ -98,10 +98,17 @@ class EventParser {
         cue: _parseEmbeddedSubtitleCue(event),
         trackId: event['trackId'] as String?,
       ),
+      'audioLevelsChanged' => AudioLevelsChangedEvent(
+        peak: _parseLevels(event['peak'] as List<dynamic>? ?? []),
+        rms: _parseLevels(event['rms'] as List<dynamic>? ?? []),
+      ),
       _ => null,
     };
   }
 
+  static List<double> _parseLevels(List<dynamic> levels) =>
+      levels.map((level) => (level as num).toDouble()).toList();
+
   static PipActionType _parsePipActionType(String? action) => switch (action) {
     'playPause' => PipActionType.playPause,
     'skipPrevious' => PipActionType.skipPrevious,
@@ -232,6 +232,8 @@ class VideoPlayerOptionsMessage {
     required this.mixWithOthers,
     required this.allowPip,
     required this.autoEnterPipOnBackground,
+    this.nativeBackend,
+    this.enableAudioLevels,
   });
 
   /// Whether to start playing automatically after initialization.
@@ -282,6 +284,13 @@ class VideoPlayerOptionsMessage {
   /// Whether to auto-enter PiP when app goes to background.
   bool autoEnterPipOnBackground;
 
+  /// Native decode backend for platforms that offer more than one
+  /// (e.g. "gstreamer" or "mpv" on Linux). Null uses the platform default.
+  String? nativeBackend;
+
+  /// Whether to emit per-channel audio level events (VU meters).
+  bool? enableAudioLevels;
+
   Object encode() {
     return <Object?>[
       autoPlay,
@@ -300,6 +309,8 @@ class VideoPlayerOptionsMessage {
       mixWithOthers,
       allowPip,
       autoEnterPipOnBackground,
+      nativeBackend,
+      enableAudioLevels,
     ];
   }
 
@@ -322,6 +333,8 @@ class VideoPlayerOptionsMessage {
       mixWithOthers: result[13]! as bool,
       allowPip: result[14]! as bool,
       autoEnterPipOnBackground: result[15]! as bool,
+      nativeBackend: result[16] as String?,
+      enableAudioLevels: result[17] as bool?,
     );
   }
 }
@@ -832,6 +845,37 @@ class VideoPlayerEventMessage {
   }
 }
 
+/// A video frame grabbed by captureFrame.
+class CapturedFrameMessage {
+  CapturedFrameMessage({required this.bytes, required this.width, required this.height, required this.positionMs});
+
+  /// PNG or JPEG file, or tightly packed RGBA pixels for the 'raw' format.
+  Uint8List bytes;
+
+  /// Width in pixels.
+  int width;
+
+  /// Height in pixels.
+  int height;
+
+  /// Position of the frame in the video, in milliseconds.
+  int positionMs;
+
+  Object encode() {
+    return <Object?>[bytes, width, height, positionMs];
+  }
+
+  static CapturedFrameMessage decode(Object result) {
+    result as List<Object?>;
+    return CapturedFrameMessage(
+      bytes: result[0]! as Uint8List,
+      width: result[1]! as int,
+      height: result[2]! as int,
+      positionMs: result[3]! as int,
+    );
+  }
+}
+
 class _PigeonCodec extends StandardMessageCodec {
   const _PigeonCodec();
   @override
@@ -911,6 +955,9 @@ class _PigeonCodec extends StandardMessageCodec {
     } else if (value is VideoPlayerEventMessage) {
       buffer.putUint8(152);
       writeValue(buffer, value.encode());
+    } else if (value is CapturedFrameMessage) {
+      buffer.putUint8(153);
+      writeValue(buffer, value.encode());
     } else {
       super.writeValue(buffer, value);
     }
@@ -976,6 +1023,8 @@ class _PigeonCodec extends StandardMessageCodec {
         return ExternalSubtitleTrackMessage.decode(readValue(buffer)!);
       case 152:
         return VideoPlayerEventMessage.decode(readValue(buffer)!);
+      case 153:
+        return CapturedFrameMessage.decode(readValue(buffer)!);
       default:
         return super.readValueOfType(type, buffer);
     }
@@ -1303,6 +1352,34 @@ class ProVideoPlayerHostApi {
     }
   }
 
+  /// Returns the native trace ring buffer as Chrome trace event JSON.
+  Future<String> dumpNativeTrace() async {
+    final String pigeonVar_channelName =
+        'dev.flutter.pigeon.pro_video_player_platform_interface.ProVideoPlayerHostApi.dumpNativeTrace$pigeonVar_messageChannelSuffix';
+    final BasicMessageChannel<Object?> pigeonVar_channel = BasicMessageChannel<Object?>(
+      pigeonVar_channelName,
+      pigeonChannelCodec,
+      binaryMessenger: pigeonVar_binaryMessenger,
+    );
+    final List<Object?>? pigeonVar_replyList = await pigeonVar_channel.send(null) as List<Object?>?;
+    if (pigeonVar_replyList == null) {
+      throw _createConnectionError(pigeonVar_channelName);
+    } else if (pigeonVar_replyList.length > 1) {
+      throw PlatformException(
+        code: pigeonVar_replyList[0]! as String,
+        message: pigeonVar_replyList[1] as String?,
+        details: pigeonVar_replyList[2],
+      );
+    } else if (pigeonVar_replyList[0] == null) {
+      throw PlatformException(
+        code: 'null-error',
+        message: 'Host platform returned null value for non-null return value.',
+      );
+    } else {
+      return (pigeonVar_replyList[0] as String?)!;
+    }
+  }
+
   /// Checks if Picture-in-Picture mode is supported.
   Future<bool> supportsPictureInPicture() async {
     final String pigeonVar_channelName =
@@ -2088,6 +2165,86 @@ class ProVideoPlayerHostApi {
     }
   }
 
+  /// Reports the on-screen size of the player's video surface in physical pixels.
+  ///
+  /// Native players use this to cap decode resolution when the video is shown
+  /// much smaller than its native size (e.g. thumbnails in a grid).
+  Future<void> setDisplaySize(int playerId, int widthPx, int heightPx) async {
+    final String pigeonVar_channelName =
+        'dev.flutter.pigeon.pro_video_player_platform_interface.ProVideoPlayerHostApi.setDisplaySize$pigeonVar_messageChannelSuffix';
+    final BasicMessageChannel<Object?> pigeonVar_channel = BasicMessageChannel<Object?>(
+      pigeonVar_channelName,
+      pigeonChannelCodec,
+      binaryMessenger: pigeonVar_binaryMessenger,
+    );
+    final List<Object?>? pigeonVar_replyList =
+        await pigeonVar_channel.send(<Object?>[playerId, widthPx, heightPx]) as List<Object?>?;
+    if (pigeonVar_replyList == null) {
+      throw _createConnectionError(pigeonVar_channelName);
+    } else if (pigeonVar_replyList.length > 1) {
+      throw PlatformException(
+        code: pigeonVar_replyList[0]! as String,
+        message: pigeonVar_replyList[1] as String?,
+        details: pigeonVar_replyList[2],
+      );
+    } else {
+      return;
+    }
+  }
+
+  /// Caps how many video frames per second the player renders.
+  ///
+  /// A negative [maxFps] renders at the video's native frame rate. Zero renders
+  /// no video frames at all while audio keeps playing.
+  Future<void> setMaxRenderFrameRate(int playerId, int maxFps) async {
+    final String pigeonVar_channelName =
+        'dev.flutter.pigeon.pro_video_player_platform_interface.ProVideoPlayerHostApi.setMaxRenderFrameRate$pigeonVar_messageChannelSuffix';
+    final BasicMessageChannel<Object?> pigeonVar_channel = BasicMessageChannel<Object?>(
+      pigeonVar_channelName,
+      pigeonChannelCodec,
+      binaryMessenger: pigeonVar_binaryMessenger,
+    );
+    final List<Object?>? pigeonVar_replyList =
+        await pigeonVar_channel.send(<Object?>[playerId, maxFps]) as List<Object?>?;
+    if (pigeonVar_replyList == null) {
+      throw _createConnectionError(pigeonVar_channelName);
+    } else if (pigeonVar_replyList.length > 1) {
+      throw PlatformException(
+        code: pigeonVar_replyList[0]! as String,
+        message: pigeonVar_replyList[1] as String?,
+        details: pigeonVar_replyList[2],
+      );
+    } else {
+      return;
+    }
+  }
+
+  /// Tells the player whether its view is currently visible on screen.
+  ///
+  /// Hidden players stop rendering video frames; audio is unaffected.
+  Future<void> setVisibilityHint(int playerId, bool isVisible) async {
+    final String pigeonVar_channelName =
+        'dev.flutter.pigeon.pro_video_player_platform_interface.ProVideoPlayerHostApi.setVisibilityHint$pigeonVar_messageChannelSuffix';
+    final BasicMessageChannel<Object?> pigeonVar_channel = BasicMessageChannel<Object?>(
+      pigeonVar_channelName,
+      pigeonChannelCodec,
+      binaryMessenger: pigeonVar_binaryMessenger,
+    );
+    final List<Object?>? pigeonVar_replyList =
+        await pigeonVar_channel.send(<Object?>[playerId, isVisible]) as List<Object?>?;
+    if (pigeonVar_replyList == null) {
+      throw _createConnectionError(pigeonVar_channelName);
+    } else if (pigeonVar_replyList.length > 1) {
+      throw PlatformException(
+        code: pigeonVar_replyList[0]! as String,
+        message: pigeonVar_replyList[1] as String?,
+        details: pigeonVar_replyList[2],
+      );
+    } else {
+      return;
+    }
+  }
+
   /// Sets the active subtitle track.
   Future<void> setSubtitleTrack(int playerId, SubtitleTrackMessage? track) async {
     final String pigeonVar_channelName =
@@ -2636,6 +2793,57 @@ class ProVideoPlayerHostApi {
     }
   }
 
+  /// Gets a peak-amplitude summary of the whole file with at most
+  /// [bucketCount] entries (0-255 each). Null when unsupported.
+  Future<Uint8List?> getWaveform(int playerId, int bucketCount) async {
+    final String pigeonVar_channelName =
+        'dev.flutter.pigeon.pro_video_player_platform_interface.ProVideoPlayerHostApi.getWaveform$pigeonVar_messageChannelSuffix';
+    final BasicMessageChannel<Object?> pigeonVar_channel = BasicMessageChannel<Object?>(
+      pigeonVar_channelName,
+      pigeonChannelCodec,
+      binaryMessenger: pigeonVar_binaryMessenger,
+    );
+    final List<Object?>? pigeonVar_replyList =
+        await pigeonVar_channel.send(<Object?>[playerId, bucketCount]) as List<Object?>?;
+    if (pigeonVar_replyList == null) {
+      throw _createConnectionError(pigeonVar_channelName);
+    } else if (pigeonVar_replyList.length > 1) {
+      throw PlatformException(
+        code: pigeonVar_replyList[0]! as String,
+        message: pigeonVar_replyList[1] as String?,
+        details: pigeonVar_replyList[2],
+      );
+    } else {
+      return (pigeonVar_replyList[0] as Uint8List?);
+    }
+  }
+
+  /// Grabs the current video frame, scaled down to at most [maxWidth] pixels
+  /// wide (0 keeps the video's width) and encoded as [format] ('png', 'jpeg'
+  /// or 'raw' RGBA). Null when unsupported.
+  Future<CapturedFrameMessage?> captureFrame(int playerId, int maxWidth, String format) async {
+    final String pigeonVar_channelName =
+        'dev.flutter.pigeon.pro_video_player_platform_interface.ProVideoPlayerHostApi.captureFrame$pigeonVar_messageChannelSuffix';
+    final BasicMessageChannel<Object?> pigeonVar_channel = BasicMessageChannel<Object?>(
+      pigeonVar_channelName,
+      pigeonChannelCodec,
+      binaryMessenger: pigeonVar_binaryMessenger,
+    );
+    final List<Object?>? pigeonVar_replyList =
+        await pigeonVar_channel.send(<Object?>[playerId, maxWidth, format]) as List<Object?>?;
+    if (pigeonVar_replyList == null) {
+      throw _createConnectionError(pigeonVar_channelName);
+    } else if (pigeonVar_replyList.length > 1) {
+      throw PlatformException(
+        code: pigeonVar_replyList[0]! as String,
+        message: pigeonVar_replyList[1] as String?,
+        details: pigeonVar_replyList[2],
+      );
+    } else {
+      return (pigeonVar_replyList[0] as CapturedFrameMessage?);
+    }
+  }
+
   /// Checks if casting is supported on this platform.
   Future<bool> isCastingSupported() async {
     final String pigeonVar_channelName =
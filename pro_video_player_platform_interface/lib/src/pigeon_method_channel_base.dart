@@ -1,4 +1,5 @@
 import 'dart:async';
+import 'dart:typed_data';
 
 import 'pigeon_generated/messages.g.dart';
 import 'pro_video_player_logger.dart';
@@ -127,6 +128,9 @@ abstract class PigeonMethodChannelBase extends ProVideoPlayerPlatform implements
     await _hostApi.setVerboseLogging(enabled);
   }
 
+  @override
+  Future<String> dumpNativeTrace() => _hostApi.dumpNativeTrace();
+
   // ==================== Platform Capabilities ====================
 
   @override
@@ -241,6 +245,18 @@ abstract class PigeonMethodChannelBase extends ProVideoPlayerPlatform implements
     await _hostApi.setControlsMode(playerId, pigeonMode);
   }
 
+  @override
+  Future<void> setDisplaySize(int playerId, int widthPx, int heightPx) async =>
+      _hostApi.setDisplaySize(playerId, widthPx, heightPx);
+
+  @override
+  Future<void> setMaxRenderFrameRate(int playerId, int? maxFps) async =>
+      _hostApi.setMaxRenderFrameRate(playerId, maxFps ?? -1);
+
+  @override
+  Future<void> setVisibilityHint(int playerId, {required bool isVisible}) async =>
+      _hostApi.setVisibilityHint(playerId, isVisible);
+
   // ==================== Subtitle Management ====================
 
   @override
@@ -455,6 +471,33 @@ abstract class PigeonMethodChannelBase extends ProVideoPlayerPlatform implements
     await _hostApi.setMediaMetadata(playerId, message);
   }
 
+  // ==================== Audio Analysis ====================
+
+  @override
+  Future<Uint8List?> getWaveform(int playerId, int bucketCount) async {
+    final peaks = await _hostApi.getWaveform(playerId, bucketCount);
+    // Native cores reply with an empty summary when the audio can't be scanned
+    return peaks == null || peaks.isEmpty ? null : peaks;
+  }
+
+  // ==================== Frame Capture ====================
+
+  @override
+  Future<CapturedFrame?> captureFrame(
+    int playerId, {
+    int maxWidth = 0,
+    CaptureFormat format = CaptureFormat.png,
+  }) async {
+    final message = await _hostApi.captureFrame(playerId, maxWidth, format.name);
+    if (message == null) return null;
+    return CapturedFrame(
+      bytes: message.bytes,
+      width: message.width,
+      height: message.height,
+      position: Duration(milliseconds: message.positionMs),
+    );
+  }
+
   // ==================== Casting ====================
 
   @override
@@ -665,6 +708,8 @@ abstract class PigeonMethodChannelBase extends ProVideoPlayerPlatform implements
     mixWithOthers: options.mixWithOthers,
     allowPip: options.allowPip,
     autoEnterPipOnBackground: options.autoEnterPipOnBackground,
+    nativeBackend: options.nativeBackend,
+    enableAudioLevels: options.enableAudioLevels,
   );
 
   /// Converts a Pigeon [PlatformInfoMessage] to [PlatformInfo].
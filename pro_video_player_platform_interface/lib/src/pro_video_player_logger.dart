@@ -39,6 +39,24 @@ class ProVideoPlayerLogger {
     }
   }
 
+  /// Returns the native playback trace as Chrome trace event JSON.
+  ///
+  /// The native engine keeps a fixed-size ring buffer of scoped events (host
+  /// calls, pipeline state changes, decode, color conversion, texture present
+  /// and event emission). Save the result to a `.json` file and open it in
+  /// `chrome://tracing` or https://ui.perfetto.dev alongside a DevTools
+  /// timeline export to correlate jank with native stalls.
+  ///
+  /// Returns `null` if the platform does not support trace export.
+  static Future<String?> dumpNativeTrace() async {
+    try {
+      return await ProVideoPlayerPlatform.instance.dumpNativeTrace();
+    } catch (e) {
+      debugPrint('[ProVideoPlayer] Note: Platform does not support dumpNativeTrace: $e');
+      return null;
+    }
+  }
+
   /// Logs a verbose message if verbose logging is enabled.
   ///
   /// Messages are only printed when [isVerboseLoggingEnabled] is true.
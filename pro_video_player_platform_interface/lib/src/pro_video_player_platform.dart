@@ -329,6 +329,40 @@ abstract class ProVideoPlayerPlatform extends PlatformInterface {
     throw UnimplementedError('setControlsMode() has not been implemented.');
   }
 
+  /// Reports the on-screen size of the video view in physical pixels.
+  ///
+  /// This is a decode hint: when the view is much smaller than the video's
+  /// native resolution (e.g. thumbnails in a grid), the platform may request
+  /// lower-resolution output from the decoder or prefer a smaller rendition.
+  /// Desktop (libmpv) only scales its rendered output; decoding stays at
+  /// full resolution. It never changes how the video is scaled inside the
+  /// view.
+  Future<void> setDisplaySize(int playerId, int widthPx, int heightPx) {
+    throw UnimplementedError('setDisplaySize() has not been implemented.');
+  }
+
+  /// Caps how many video frames per second are rendered for the player.
+  ///
+  /// Use this for players that don't need full motion, such as dashboard
+  /// tiles or previews. Frames above the cap are dropped before they are
+  /// converted and uploaded, and audio keeps playing normally.
+  ///
+  /// - `null`: render at the video's native frame rate (default)
+  /// - `0`: render no video frames (audio only)
+  /// - any positive value: render at most that many frames per second
+  Future<void> setMaxRenderFrameRate(int playerId, int? maxFps) {
+    throw UnimplementedError('setMaxRenderFrameRate() has not been implemented.');
+  }
+
+  /// Tells the platform whether the player's view is currently visible.
+  ///
+  /// Hidden players (e.g. in a background tab or covered by another route)
+  /// stop rendering video frames until they become visible again. Audio is
+  /// unaffected.
+  Future<void> setVisibilityHint(int playerId, {required bool isVisible}) {
+    throw UnimplementedError('setVisibilityHint() has not been implemented.');
+  }
+
   /// Sets verbose logging mode for all platform implementations.
   ///
   /// When enabled, detailed debug logs will be printed to help troubleshoot issues.
@@ -337,6 +371,16 @@ abstract class ProVideoPlayerPlatform extends PlatformInterface {
     throw UnimplementedError('setVerboseLogging() has not been implemented.');
   }
 
+  /// Returns the native trace ring buffer as Chrome trace event JSON.
+  ///
+  /// The result can be loaded in `chrome://tracing` or https://ui.perfetto.dev
+  /// next to a Dart timeline export. Timestamps are microseconds on the same
+  /// monotonic clock the Dart timeline uses, so native stalls line up with
+  /// frame jank. Platforms without a native trace return an empty trace.
+  Future<String> dumpNativeTrace() {
+    throw UnimplementedError('dumpNativeTrace() has not been implemented.');
+  }
+
   /// Gets static platform information.
   ///
   /// Returns metadata about the platform (name, player type, additional info)
@@ -616,6 +660,41 @@ abstract class ProVideoPlayerPlatform extends PlatformInterface {
     throw UnimplementedError('getVideoMetadata() has not been implemented.');
   }
 
+  // ==================== Audio Analysis ====================
+
+  /// Gets a peak-amplitude summary of the whole media file, for drawing a
+  /// waveform scrubber.
+  ///
+  /// The result has at most [bucketCount] entries spread evenly over the
+  /// duration, each the loudest sample in its span scaled to 0-255. The file's
+  /// audio is scanned once in the background, independently of playback, and
+  /// cached on disk, so later calls for the same file return quickly.
+  ///
+  /// Desktop only: implemented by the native player core on Linux and
+  /// Windows. Android, iOS, macOS and web return `null`.
+  ///
+  /// Returns `null` if the platform can't analyse the audio or the media has
+  /// no audio track.
+  Future<Uint8List?> getWaveform(int playerId, int bucketCount) {
+    throw UnimplementedError('getWaveform() has not been implemented.');
+  }
+
+  // ==================== Frame Capture ====================
+
+  /// Grabs the video frame currently on screen, for thumbnails or moderation
+  /// snapshots, without pausing playback.
+  ///
+  /// The frame is scaled down to at most [maxWidth] pixels wide with its
+  /// aspect ratio kept (0 keeps the video's size; frames are never scaled up)
+  /// and encoded as [format] in the background.
+  ///
+  /// Returns `null` if the platform can't read back decoded frames. Fails with
+  /// a `PlatformException` if no frame has been decoded yet or too many
+  /// captures are already pending.
+  Future<CapturedFrame?> captureFrame(int playerId, {int maxWidth = 0, CaptureFormat format = CaptureFormat.png}) {
+    throw UnimplementedError('captureFrame() has not been implemented.');
+  }
+
   // ==================== Casting ====================
 
   /// Returns whether casting is supported on this platform.
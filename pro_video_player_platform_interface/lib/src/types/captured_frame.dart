@@ -0,0 +1,37 @@
+import 'dart:typed_data';
+
+/// Image format for frames grabbed with `captureFrame()`.
+enum CaptureFormat {
+  /// Lossless PNG file.
+  png,
+
+  /// Baseline JPEG file. Much smaller than PNG; drops transparency.
+  jpeg,
+
+  /// Tightly packed RGBA pixels, 4 bytes per pixel, rows top to bottom.
+  ///
+  /// Cheapest to produce; use [CapturedFrame.width] and
+  /// [CapturedFrame.height] to interpret the bytes.
+  raw,
+}
+
+/// A snapshot of the video frame that was on screen when it was captured.
+class CapturedFrame {
+  /// Creates a captured frame.
+  const CapturedFrame({required this.bytes, required this.width, required this.height, required this.position});
+
+  /// The image, encoded as requested (see [CaptureFormat]).
+  final Uint8List bytes;
+
+  /// Width of the image in pixels.
+  final int width;
+
+  /// Height of the image in pixels.
+  final int height;
+
+  /// Position of the frame in the video.
+  final Duration position;
+
+  @override
+  String toString() => 'CapturedFrame(${width}x$height, ${bytes.length} bytes, position: $position)';
+}
@@ -3,6 +3,7 @@ export 'audio_track.dart';
 export 'battery_info.dart';
 export 'buffering_tier.dart';
 export 'caption.dart';
+export 'captured_frame.dart';
 export 'cast_device.dart';
 export 'cast_state.dart';
 export 'chapter.dart';
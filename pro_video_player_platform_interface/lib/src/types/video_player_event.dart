@@ -644,3 +644,34 @@ final class EmbeddedSubtitleCueEvent extends VideoPlayerEvent {
   @override
   String toString() => 'EmbeddedSubtitleCueEvent(cue: $cue, trackId: $trackId)';
 }
+
+// ==================== Audio Analysis Events ====================
+
+/// Emitted with the audio levels of the last ~50ms of playback.
+///
+/// Only sent when `VideoPlayerOptions.enableAudioLevels` is set, and only by
+/// the libmpv backend of the desktop player core (Linux and Windows). Both
+/// lists have one entry per audio channel, in the track's channel order, as
+/// linear amplitudes from 0.0 (silence) to 1.0 (full scale).
+///
+/// Example:
+/// ```dart
+/// controller.events.listen((event) {
+///   if (event is AudioLevelsChangedEvent) {
+///     meter.update(left: event.peak.first, right: event.peak.last);
+///   }
+/// });
+/// ```
+final class AudioLevelsChangedEvent extends VideoPlayerEvent {
+  /// Creates an audio levels changed event.
+  const AudioLevelsChangedEvent({required this.peak, required this.rms});
+
+  /// Highest absolute sample value per channel.
+  final List<double> peak;
+
+  /// Root-mean-square level per channel.
+  final List<double> rms;
+
+  @override
+  String toString() => 'AudioLevelsChangedEvent(peak: $peak, rms: $rms)';
+}
@@ -111,6 +111,8 @@ class VideoPlayerOptions {
     this.abrMode = AbrMode.auto,
     this.minBitrate,
     this.maxBitrate,
+    this.nativeBackend,
+    this.enableAudioLevels = false,
   });
 
   // ============================================
@@ -530,6 +532,41 @@ class VideoPlayerOptions {
   /// Defaults to `null` (no maximum limit).
   final int? maxBitrate;
 
+  // ============================================
+  // Native Backend Options
+  // ============================================
+
+  /// The native decode backend to use for this player.
+  ///
+  /// Only meaningful on platforms that ship more than one playback engine;
+  /// everywhere else the value is ignored.
+  ///
+  /// - **Linux**: `'gstreamer'` or `'mpv'` (libmpv, when the plugin was built
+  ///   with it). libmpv handles MKV/WebM content that GStreamer setups often
+  ///   lack plugins for.
+  ///
+  /// The backend actually in use is reported by `getPlatformInfo()` as
+  /// `nativePlayerType`. Unknown names fail player creation.
+  ///
+  /// Defaults to `null` (platform default).
+  final String? nativeBackend;
+
+  // ============================================
+  // Audio Analysis Options
+  // ============================================
+
+  /// Whether to emit `AudioLevelsChangedEvent`s with per-channel peak and RMS
+  /// levels, for VU meters.
+  ///
+  /// Levels are measured natively on the decoded audio and emitted about every
+  /// 50ms while audio plays.
+  ///
+  /// Desktop only: supported by the libmpv backend of the native player core
+  /// on Linux and Windows. Other platforms and backends ignore this option.
+  ///
+  /// Defaults to `false`.
+  final bool enableAudioLevels;
+
   /// Creates a copy of this options with the given fields replaced.
   VideoPlayerOptions copyWith({
     bool? autoPlay,
@@ -556,6 +593,8 @@ class VideoPlayerOptions {
     AbrMode? abrMode,
     int? minBitrate,
     int? maxBitrate,
+    String? nativeBackend,
+    bool? enableAudioLevels,
   }) => VideoPlayerOptions(
     autoPlay: autoPlay ?? this.autoPlay,
     looping: looping ?? this.looping,
@@ -581,6 +620,8 @@ class VideoPlayerOptions {
     abrMode: abrMode ?? this.abrMode,
     minBitrate: minBitrate ?? this.minBitrate,
     maxBitrate: maxBitrate ?? this.maxBitrate,
+    nativeBackend: nativeBackend ?? this.nativeBackend,
+    enableAudioLevels: enableAudioLevels ?? this.enableAudioLevels,
   );
 
   @override
@@ -610,7 +651,9 @@ class VideoPlayerOptions {
         allowCasting == other.allowCasting &&
         abrMode == other.abrMode &&
         minBitrate == other.minBitrate &&
-        maxBitrate == other.maxBitrate;
+        maxBitrate == other.maxBitrate &&
+        nativeBackend == other.nativeBackend &&
+        enableAudioLevels == other.enableAudioLevels;
   }
 
   @override
@@ -639,6 +682,8 @@ class VideoPlayerOptions {
     abrMode,
     minBitrate,
     maxBitrate,
+    nativeBackend,
+    enableAudioLevels,
   ]);
 
   @override
@@ -667,6 +712,8 @@ class VideoPlayerOptions {
       'allowCasting: $allowCasting, '
       'abrMode: $abrMode, '
       'minBitrate: $minBitrate, '
-      'maxBitrate: $maxBitrate'
+      'maxBitrate: $maxBitrate, '
+      'nativeBackend: $nativeBackend, '
+      'enableAudioLevels: $enableAudioLevels'
       ')';
 }
@@ -214,6 +214,13 @@ class VideoPlayerOptionsMessage {
   /// Whether to auto-enter PiP when app goes to background.
   final bool autoEnterPipOnBackground;
 
+  /// Native decode backend for platforms that offer more than one
+  /// (e.g. "gstreamer" or "mpv" on Linux). Null uses the platform default.
+  final String? nativeBackend;
+
+  /// Whether to emit per-channel audio level events (VU meters).
+  final bool? enableAudioLevels;
+
   VideoPlayerOptionsMessage({
     required this.autoPlay,
     required this.looping,
@@ -231,6 +238,8 @@ class VideoPlayerOptionsMessage {
     this.maxBitrate,
     this.minBitrate,
     this.preferredAudioRendition,
+    this.nativeBackend,
+    this.enableAudioLevels,
   });
 }
 
@@ -563,6 +572,10 @@ abstract class ProVideoPlayerHostApi {
   @async
   void setVerboseLogging(bool enabled);
 
+  /// Returns the native trace ring buffer as Chrome trace event JSON.
+  @async
+  String dumpNativeTrace();
+
   // ==================== Platform Capabilities ====================
 
   /// Checks if Picture-in-Picture mode is supported.
@@ -685,6 +698,26 @@ abstract class ProVideoPlayerHostApi {
   @async
   void setControlsMode(int playerId, ControlsModeEnum mode);
 
+  /// Reports the on-screen size of the player's video surface in physical pixels.
+  ///
+  /// Native players use this to cap decode resolution when the video is shown
+  /// much smaller than its native size (e.g. thumbnails in a grid).
+  @async
+  void setDisplaySize(int playerId, int widthPx, int heightPx);
+
+  /// Caps how many video frames per second the player renders.
+  ///
+  /// A negative [maxFps] renders at the video's native frame rate. Zero renders
+  /// no video frames at all while audio keeps playing.
+  @async
+  void setMaxRenderFrameRate(int playerId, int maxFps);
+
+  /// Tells the player whether its view is currently visible on screen.
+  ///
+  /// Hidden players stop rendering video frames; audio is unaffected.
+  @async
+  void setVisibilityHint(int playerId, bool isVisible);
+
   // ==================== Subtitle Management ====================
 
   /// Sets the active subtitle track.
@@ -783,6 +816,21 @@ abstract class ProVideoPlayerHostApi {
   @async
   void setMediaMetadata(int playerId, MediaMetadataMessage metadata);
 
+  // ==================== Audio Analysis ====================
+
+  /// Gets a peak-amplitude summary of the whole file with at most
+  /// [bucketCount] entries (0-255 each). Null when unsupported.
+  @async
+  Uint8List? getWaveform(int playerId, int bucketCount);
+
+  // ==================== Frame Capture ====================
+
+  /// Grabs the current video frame, scaled down to at most [maxWidth] pixels
+  /// wide (0 keeps the video's width) and encoded as [format] ('png', 'jpeg'
+  /// or 'raw' RGBA). Null when unsupported.
+  @async
+  CapturedFrameMessage? captureFrame(int playerId, int maxWidth, String format);
+
   // ==================== Casting ====================
 
   /// Checks if casting is supported on this platform.
@@ -885,6 +933,23 @@ class VideoPlayerEventMessage {
   });
 }
 
+/// A video frame grabbed by captureFrame.
+class CapturedFrameMessage {
+  /// PNG or JPEG file, or tightly packed RGBA pixels for the 'raw' format.
+  final Uint8List bytes;
+
+  /// Width in pixels.
+  final int width;
+
+  /// Height in pixels.
+  final int height;
+
+  /// Position of the frame in the video, in milliseconds.
+  final int positionMs;
+
+  CapturedFrameMessage({required this.bytes, required this.width, required this.height, required this.positionMs});
+}
+
 /// Flutter API for callbacks from the platform to Dart.
 ///
 /// This API is implemented in Dart and called from the native platform
@@ -92,6 +92,9 @@ class _PigeonCodec extends StandardMessageCodec {
     } else if (value is VideoPlayerEventMessage) {
       buffer.putUint8(152);
       writeValue(buffer, value.encode());
+    } else if (value is CapturedFrameMessage) {
+      buffer.putUint8(153);
+      writeValue(buffer, value.encode());
     } else {
       super.writeValue(buffer, value);
     }
@@ -157,6 +160,8 @@ class _PigeonCodec extends StandardMessageCodec {
         return ExternalSubtitleTrackMessage.decode(readValue(buffer)!);
       case 152:
         return VideoPlayerEventMessage.decode(readValue(buffer)!);
+      case 153:
+        return CapturedFrameMessage.decode(readValue(buffer)!);
       default:
         return super.readValueOfType(type, buffer);
     }
@@ -77,6 +77,27 @@ void main() {
       expect(decoded.mixWithOthers, false);
       expect(decoded.allowPip, true);
       expect(decoded.autoEnterPipOnBackground, false);
+      expect(decoded.nativeBackend, isNull);
+      expect(decoded.enableAudioLevels, isNull);
+    });
+
+    test('round-trips nativeBackend and enableAudioLevels', () {
+      final options = VideoPlayerOptionsMessage(
+        autoPlay: false,
+        looping: false,
+        volume: 1,
+        playbackSpeed: 1,
+        allowBackgroundPlayback: false,
+        mixWithOthers: false,
+        allowPip: false,
+        autoEnterPipOnBackground: false,
+        nativeBackend: 'mpv',
+        enableAudioLevels: true,
+      );
+
+      final decoded = VideoPlayerOptionsMessage.decode(options.encode());
+      expect(decoded.nativeBackend, 'mpv');
+      expect(decoded.enableAudioLevels, true);
     });
   });
 
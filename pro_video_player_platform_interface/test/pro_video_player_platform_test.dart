@@ -106,6 +106,48 @@ void main() {
         );
       });
 
+      test('setDisplaySize throws UnimplementedError', () {
+        expect(
+          () => platform.setDisplaySize(1, 640, 360),
+          throwsA(isA<UnimplementedError>().having((e) => e.message, 'message', contains('setDisplaySize()'))),
+        );
+      });
+
+      test('setMaxRenderFrameRate throws UnimplementedError', () {
+        expect(
+          () => platform.setMaxRenderFrameRate(1, 5),
+          throwsA(isA<UnimplementedError>().having((e) => e.message, 'message', contains('setMaxRenderFrameRate()'))),
+        );
+      });
+
+      test('getWaveform throws UnimplementedError', () {
+        expect(
+          () => platform.getWaveform(1, 200),
+          throwsA(isA<UnimplementedError>().having((e) => e.message, 'message', contains('getWaveform()'))),
+        );
+      });
+
+      test('captureFrame throws UnimplementedError', () {
+        expect(
+          () => platform.captureFrame(1, maxWidth: 320),
+          throwsA(isA<UnimplementedError>().having((e) => e.message, 'message', contains('captureFrame()'))),
+        );
+      });
+
+      test('setVisibilityHint throws UnimplementedError', () {
+        expect(
+          () => platform.setVisibilityHint(1, isVisible: false),
+          throwsA(isA<UnimplementedError>().having((e) => e.message, 'message', contains('setVisibilityHint()'))),
+        );
+      });
+
+      test('dumpNativeTrace throws UnimplementedError', () {
+        expect(
+          () => platform.dumpNativeTrace(),
+          throwsA(isA<UnimplementedError>().having((e) => e.message, 'message', contains('dumpNativeTrace()'))),
+        );
+      });
+
       test('setSubtitleTrack throws UnimplementedError', () {
         expect(
           () => platform.setSubtitleTrack(1, const SubtitleTrack(id: 'en', label: 'English')),
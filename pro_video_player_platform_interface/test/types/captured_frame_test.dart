@@ -0,0 +1,28 @@
+import 'dart:typed_data';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:pro_video_player_platform_interface/pro_video_player_platform_interface.dart';
+
+void main() {
+  group('CaptureFormat', () {
+    test('names match the native format strings', () {
+      expect(CaptureFormat.values.map((format) => format.name), ['png', 'jpeg', 'raw']);
+    });
+  });
+
+  group('CapturedFrame', () {
+    test('holds the image and where it was taken', () {
+      final frame = CapturedFrame(
+        bytes: Uint8List.fromList([1, 2, 3, 4]),
+        width: 1,
+        height: 1,
+        position: const Duration(milliseconds: 40),
+      );
+      expect(frame.bytes, [1, 2, 3, 4]);
+      expect(frame.width, 1);
+      expect(frame.height, 1);
+      expect(frame.position, const Duration(milliseconds: 40));
+      expect(frame.toString(), 'CapturedFrame(1x1, 4 bytes, position: 0:00:00.040000)');
+    });
+  });
+}
@@ -668,6 +668,25 @@ void main() {
       });
     });
 
+    // Audio analysis events
+    group('AudioLevelsChangedEvent', () {
+      test('creates with per-channel levels', () {
+        const event = AudioLevelsChangedEvent(peak: [0.5, 1], rms: [0.25, 0.7]);
+
+        expect(event.peak, equals([0.5, 1.0]));
+        expect(event.rms, equals([0.25, 0.7]));
+      });
+
+      test('toString returns readable representation', () {
+        const event = AudioLevelsChangedEvent(peak: [0.5], rms: [0.25]);
+
+        final str = event.toString();
+        expect(str, contains('AudioLevelsChangedEvent'));
+        expect(str, contains('0.5'));
+        expect(str, contains('0.25'));
+      });
+    });
+
     test('all event types are sealed VideoPlayerEvent subclasses', () {
       final events = <VideoPlayerEvent>[
         const PlaybackStateChangedEvent(PlaybackState.playing),
@@ -708,6 +727,8 @@ void main() {
         const CurrentChapterChangedEvent(null),
         // Embedded subtitle events
         const EmbeddedSubtitleCueEvent(cue: null),
+        // Audio analysis events
+        const AudioLevelsChangedEvent(peak: [], rms: []),
       ];
 
       for (final event in events) {
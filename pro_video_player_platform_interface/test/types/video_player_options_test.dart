@@ -328,6 +328,48 @@ void main() {
         expect(options, equals(options));
       });
     });
+
+    group('nativeBackend', () {
+      test('defaults to null (platform default)', () {
+        const options = VideoPlayerOptions();
+        expect(options.nativeBackend, isNull);
+      });
+
+      test('copyWith preserves and replaces nativeBackend', () {
+        const original = VideoPlayerOptions(nativeBackend: 'mpv');
+        expect(original.copyWith(autoPlay: true).nativeBackend, equals('mpv'));
+        expect(original.copyWith(nativeBackend: 'gstreamer').nativeBackend, equals('gstreamer'));
+      });
+
+      test('is part of equality, hashCode and toString', () {
+        const mpv = VideoPlayerOptions(nativeBackend: 'mpv');
+        const gstreamer = VideoPlayerOptions(nativeBackend: 'gstreamer');
+
+        expect(mpv, isNot(equals(gstreamer)));
+        expect(mpv.hashCode, equals(const VideoPlayerOptions(nativeBackend: 'mpv').hashCode));
+        expect(mpv.toString(), contains('nativeBackend: mpv'));
+      });
+    });
+
+    group('enableAudioLevels', () {
+      test('defaults to false', () {
+        const options = VideoPlayerOptions();
+        expect(options.enableAudioLevels, isFalse);
+      });
+
+      test('copyWith preserves and replaces enableAudioLevels', () {
+        const original = VideoPlayerOptions(enableAudioLevels: true);
+        expect(original.copyWith(autoPlay: true).enableAudioLevels, isTrue);
+        expect(original.copyWith(enableAudioLevels: false).enableAudioLevels, isFalse);
+      });
+
+      test('is part of equality and toString', () {
+        const enabled = VideoPlayerOptions(enableAudioLevels: true);
+
+        expect(enabled, isNot(equals(const VideoPlayerOptions())));
+        expect(enabled.toString(), contains('enableAudioLevels: true'));
+      });
+    });
   });
 
   group('FullscreenOrientation', () {
@@ -96,6 +96,21 @@ class ProVideoPlayerWeb extends ProVideoPlayerPlatform {
   @override
   Future<void> setScalingMode(int playerId, VideoScalingMode mode) async => _getPlayer(playerId).setScalingMode(mode);
 
+  @override
+  Future<void> setDisplaySize(int playerId, int widthPx, int heightPx) async {
+    // hls.js caps renditions to the <video> element size (capLevelToPlayerSize)
+  }
+
+  @override
+  Future<void> setMaxRenderFrameRate(int playerId, int? maxFps) async {
+    // Browsers don't expose frame pacing for <video>; rendering is left to the browser
+  }
+
+  @override
+  Future<void> setVisibilityHint(int playerId, {required bool isVisible}) async {
+    // Browsers already skip painting hidden <video> elements
+  }
+
   @override
   Future<void> setSubtitleRenderMode(int playerId, SubtitleRenderMode mode) async =>
       _getPlayer(playerId).setSubtitleRenderMode(mode.name);
@@ -167,6 +182,10 @@ class ProVideoPlayerWeb extends ProVideoPlayerPlatform {
     verboseLog('Verbose logging ${enabled ? "enabled" : "disabled"}', tag: 'Plugin');
   }
 
+  // The browser's own performance profiler covers the media pipeline.
+  @override
+  Future<String> dumpNativeTrace() async => '{"traceEvents":[]}';
+
   @override
   Future<PlatformInfo> getPlatformInfo() async {
     verboseLog('Getting platform info', tag: 'Plugin');
@@ -330,6 +349,21 @@ class ProVideoPlayerWeb extends ProVideoPlayerPlatform {
   @override
   Future<VideoMetadata?> getVideoMetadata(int playerId) async => _getPlayer(playerId).getVideoMetadata();
 
+  @override
+  Future<Uint8List?> getWaveform(int playerId, int bucketCount) async =>
+      // <video> doesn't expose decoded audio without routing playback through Web Audio
+      null;
+
+  @override
+  Future<CapturedFrame?> captureFrame(
+    int playerId, {
+    int maxWidth = 0,
+    CaptureFormat format = CaptureFormat.png,
+  }) async {
+    // Not implemented on web yet; a canvas read-back only works for same-origin or CORS-enabled sources
+    return null;
+  }
+
   @override
   Future<ExternalSubtitleTrack?> addExternalSubtitle(int playerId, SubtitleSource source) async {
     verboseLog('addExternalSubtitle() called for playerId: $playerId, source: ${source.path}', tag: 'Plugin');
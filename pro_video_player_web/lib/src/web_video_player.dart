@@ -181,6 +181,8 @@ class WebVideoPlayer {
           'lowLatencyMode': false,
           'startPosition': -1,
           'abrMaxWithRealBitrate': true,
+          // Don't fetch renditions larger than the <video> element is displayed
+          'capLevelToPlayerSize': true,
         };
 
         if (options.abrMode == AbrMode.manual) {
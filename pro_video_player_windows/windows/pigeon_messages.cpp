@@ -178,7 +178,9 @@ VideoPlayerOptionsMessage::VideoPlayerOptionsMessage(
   bool allow_background_playback,
   bool mix_with_others,
   bool allow_pip,
-  bool auto_enter_pip_on_background)
+  bool auto_enter_pip_on_background,
+  const std::string* native_backend,
+  const bool* enable_audio_levels)
  : auto_play_(auto_play),
     looping_(looping),
     volume_(volume),
@@ -194,7 +196,9 @@ VideoPlayerOptionsMessage::VideoPlayerOptionsMessage(
     allow_background_playback_(allow_background_playback),
     mix_with_others_(mix_with_others),
     allow_pip_(allow_pip),
-    auto_enter_pip_on_background_(auto_enter_pip_on_background) {}
+    auto_enter_pip_on_background_(auto_enter_pip_on_background),
+    native_backend_(native_backend ? std::optional<std::string>(*native_backend) : std::nullopt),
+    enable_audio_levels_(enable_audio_levels ? std::optional<bool>(*enable_audio_levels) : std::nullopt) {}
 
 bool VideoPlayerOptionsMessage::auto_play() const {
   return auto_play_;
@@ -372,9 +376,35 @@ void VideoPlayerOptionsMessage::set_auto_enter_pip_on_background(bool value_arg)
 }
 
 
+const std::string* VideoPlayerOptionsMessage::native_backend() const {
+  return native_backend_ ? &(*native_backend_) : nullptr;
+}
+
+void VideoPlayerOptionsMessage::set_native_backend(const std::string_view* value_arg) {
+  native_backend_ = value_arg ? std::optional<std::string>(*value_arg) : std::nullopt;
+}
+
+void VideoPlayerOptionsMessage::set_native_backend(std::string_view value_arg) {
+  native_backend_ = value_arg;
+}
+
+
+const bool* VideoPlayerOptionsMessage::enable_audio_levels() const {
+  return enable_audio_levels_ ? &(*enable_audio_levels_) : nullptr;
+}
+
+void VideoPlayerOptionsMessage::set_enable_audio_levels(const bool* value_arg) {
+  enable_audio_levels_ = value_arg ? std::optional<bool>(*value_arg) : std::nullopt;
+}
+
+void VideoPlayerOptionsMessage::set_enable_audio_levels(bool value_arg) {
+  enable_audio_levels_ = value_arg;
+}
+
+
 EncodableList VideoPlayerOptionsMessage::ToEncodableList() const {
   EncodableList list;
-  list.reserve(16);
+  list.reserve(18);
   list.push_back(EncodableValue(auto_play_));
   list.push_back(EncodableValue(looping_));
   list.push_back(EncodableValue(volume_));
@@ -391,6 +421,8 @@ EncodableList VideoPlayerOptionsMessage::ToEncodableList() const {
   list.push_back(EncodableValue(mix_with_others_));
   list.push_back(EncodableValue(allow_pip_));
   list.push_back(EncodableValue(auto_enter_pip_on_background_));
+  list.push_back(native_backend_ ? EncodableValue(*native_backend_) : EncodableValue());
+  list.push_back(enable_audio_levels_ ? EncodableValue(*enable_audio_levels_) : EncodableValue());
   return list;
 }
 
@@ -436,6 +468,14 @@ VideoPlayerOptionsMessage VideoPlayerOptionsMessage::FromEncodableList(const Enc
   if (!encodable_preferred_audio_rendition.IsNull()) {
     decoded.set_preferred_audio_rendition(std::get<std::string>(encodable_preferred_audio_rendition));
   }
+  auto& encodable_native_backend = list[16];
+  if (!encodable_native_backend.IsNull()) {
+    decoded.set_native_backend(std::get<std::string>(encodable_native_backend));
+  }
+  auto& encodable_enable_audio_levels = list[17];
+  if (!encodable_enable_audio_levels.IsNull()) {
+    decoded.set_enable_audio_levels(std::get<bool>(encodable_enable_audio_levels));
+  }
   return decoded;
 }
 
@@ -1850,6 +1890,73 @@ VideoPlayerEventMessage VideoPlayerEventMessage::FromEncodableList(const Encodab
   return decoded;
 }
 
+// CapturedFrameMessage
+
+CapturedFrameMessage::CapturedFrameMessage(
+  const std::vector<uint8_t>& bytes,
+  int64_t width,
+  int64_t height,
+  int64_t position_ms)
+ : bytes_(bytes),
+    width_(width),
+    height_(height),
+    position_ms_(position_ms) {}
+
+const std::vector<uint8_t>& CapturedFrameMessage::bytes() const {
+  return bytes_;
+}
+
+void CapturedFrameMessage::set_bytes(const std::vector<uint8_t>& value_arg) {
+  bytes_ = value_arg;
+}
+
+
+int64_t CapturedFrameMessage::width() const {
+  return width_;
+}
+
+void CapturedFrameMessage::set_width(int64_t value_arg) {
+  width_ = value_arg;
+}
+
+
+int64_t CapturedFrameMessage::height() const {
+  return height_;
+}
+
+void CapturedFrameMessage::set_height(int64_t value_arg) {
+  height_ = value_arg;
+}
+
+
+int64_t CapturedFrameMessage::position_ms() const {
+  return position_ms_;
+}
+
+void CapturedFrameMessage::set_position_ms(int64_t value_arg) {
+  position_ms_ = value_arg;
+}
+
+
+EncodableList CapturedFrameMessage::ToEncodableList() const {
+  EncodableList list;
+  list.reserve(4);
+  list.push_back(EncodableValue(bytes_));
+  list.push_back(EncodableValue(width_));
+  list.push_back(EncodableValue(height_));
+  list.push_back(EncodableValue(position_ms_));
+  return list;
+}
+
+CapturedFrameMessage CapturedFrameMessage::FromEncodableList(const EncodableList& list) {
+  CapturedFrameMessage decoded(
+    std::get<std::vector<uint8_t>>(list[0]),
+    std::get<int64_t>(list[1]),
+    std::get<int64_t>(list[2]),
+    std::get<int64_t>(list[3]));
+  return decoded;
+}
+
 
 PigeonInternalCodecSerializer::PigeonInternalCodecSerializer() {}
 
@@ -1947,6 +2054,9 @@ EncodableValue PigeonInternalCodecSerializer::ReadValueOfType(
     case 152: {
         return CustomEncodableValue(VideoPlayerEventMessage::FromEncodableList(std::get<EncodableList>(ReadValue(stream))));
       }
+    case 153: {
+        return CustomEncodableValue(CapturedFrameMessage::FromEncodableList(std::get<EncodableList>(ReadValue(stream))));
+      }
     default:
       return flutter::StandardCodecSerializer::ReadValueOfType(type, stream);
     }
@@ -2076,6 +2186,11 @@ void PigeonInternalCodecSerializer::WriteValue(
       WriteValue(EncodableValue(std::any_cast<VideoPlayerEventMessage>(*custom_value).ToEncodableList()), stream);
       return;
     }
+    if (custom_value->type() == typeid(CapturedFrameMessage)) {
+      stream->WriteByte(153);
+      WriteValue(EncodableValue(std::any_cast<CapturedFrameMessage>(*custom_value).ToEncodableList()), stream);
+      return;
+    }
   }
   flutter::StandardCodecSerializer::WriteValue(value, stream);
 }
@@ -2462,6 +2577,28 @@ void ProVideoPlayerHostApi::SetUp(
       channel.SetMessageHandler(nullptr);
     }
   }
+  {
+    BasicMessageChannel<> channel(binary_messenger, "dev.flutter.pigeon.pro_video_player_platform_interface.ProVideoPlayerHostApi.dumpNativeTrace" + prepended_suffix, &GetCodec());
+    if (api != nullptr) {
+      channel.SetMessageHandler([api](const EncodableValue& message, const flutter::MessageReply<EncodableValue>& reply) {
+        try {
+          api->DumpNativeTrace([reply](ErrorOr<std::string>&& output) {
+            if (output.has_error()) {
+              reply(WrapError(output.error()));
+              return;
+            }
+            EncodableList wrapped;
+            wrapped.push_back(EncodableValue(std::move(output).TakeValue()));
+            reply(EncodableValue(std::move(wrapped)));
+          });
+        } catch (const std::exception& exception) {
+          reply(WrapError(exception.what()));
+        }
+      });
+    } else {
+      channel.SetMessageHandler(nullptr);
+    }
+  }
   {
     BasicMessageChannel<> channel(binary_messenger, "dev.flutter.pigeon.pro_video_player_platform_interface.ProVideoPlayerHostApi.supportsPictureInPicture" + prepended_suffix, &GetCodec());
     if (api != nullptr) {
@@ -3158,6 +3295,117 @@ void ProVideoPlayerHostApi::SetUp(
       channel.SetMessageHandler(nullptr);
     }
   }
+  {
+    BasicMessageChannel<> channel(binary_messenger, "dev.flutter.pigeon.pro_video_player_platform_interface.ProVideoPlayerHostApi.setDisplaySize" + prepended_suffix, &GetCodec());
+    if (api != nullptr) {
+      channel.SetMessageHandler([api](const EncodableValue& message, const flutter::MessageReply<EncodableValue>& reply) {
+        try {
+          const auto& args = std::get<EncodableList>(message);
+          const auto& encodable_player_id_arg = args.at(0);
+          if (encodable_player_id_arg.IsNull()) {
+            reply(WrapError("player_id_arg unexpectedly null."));
+            return;
+          }
+          const int64_t player_id_arg = encodable_player_id_arg.LongValue();
+          const auto& encodable_width_px_arg = args.at(1);
+          if (encodable_width_px_arg.IsNull()) {
+            reply(WrapError("width_px_arg unexpectedly null."));
+            return;
+          }
+          const int64_t width_px_arg = encodable_width_px_arg.LongValue();
+          const auto& encodable_height_px_arg = args.at(2);
+          if (encodable_height_px_arg.IsNull()) {
+            reply(WrapError("height_px_arg unexpectedly null."));
+            return;
+          }
+          const int64_t height_px_arg = encodable_height_px_arg.LongValue();
+          api->SetDisplaySize(player_id_arg, width_px_arg, height_px_arg, [reply](std::optional<FlutterError>&& output) {
+            if (output.has_value()) {
+              reply(WrapError(output.value()));
+              return;
+            }
+            EncodableList wrapped;
+            wrapped.push_back(EncodableValue());
+            reply(EncodableValue(std::move(wrapped)));
+          });
+        } catch (const std::exception& exception) {
+          reply(WrapError(exception.what()));
+        }
+      });
+    } else {
+      channel.SetMessageHandler(nullptr);
+    }
+  }
+  {
+    BasicMessageChannel<> channel(binary_messenger, "dev.flutter.pigeon.pro_video_player_platform_interface.ProVideoPlayerHostApi.setMaxRenderFrameRate" + prepended_suffix, &GetCodec());
+    if (api != nullptr) {
+      channel.SetMessageHandler([api](const EncodableValue& message, const flutter::MessageReply<EncodableValue>& reply) {
+        try {
+          const auto& args = std::get<EncodableList>(message);
+          const auto& encodable_player_id_arg = args.at(0);
+          if (encodable_player_id_arg.IsNull()) {
+            reply(WrapError("player_id_arg unexpectedly null."));
+            return;
+          }
+          const int64_t player_id_arg = encodable_player_id_arg.LongValue();
+          const auto& encodable_max_fps_arg = args.at(1);
+          if (encodable_max_fps_arg.IsNull()) {
+            reply(WrapError("max_fps_arg unexpectedly null."));
+            return;
+          }
+          const int64_t max_fps_arg = encodable_max_fps_arg.LongValue();
+          api->SetMaxRenderFrameRate(player_id_arg, max_fps_arg, [reply](std::optional<FlutterError>&& output) {
+            if (output.has_value()) {
+              reply(WrapError(output.value()));
+              return;
+            }
+            EncodableList wrapped;
+            wrapped.push_back(EncodableValue());
+            reply(EncodableValue(std::move(wrapped)));
+          });
+        } catch (const std::exception& exception) {
+          reply(WrapError(exception.what()));
+        }
+      });
+    } else {
+      channel.SetMessageHandler(nullptr);
+    }
+  }
+  {
+    BasicMessageChannel<> channel(binary_messenger, "dev.flutter.pigeon.pro_video_player_platform_interface.ProVideoPlayerHostApi.setVisibilityHint" + prepended_suffix, &GetCodec());
+    if (api != nullptr) {
+      channel.SetMessageHandler([api](const EncodableValue& message, const flutter::MessageReply<EncodableValue>& reply) {
+        try {
+          const auto& args = std::get<EncodableList>(message);
+          const auto& encodable_player_id_arg = args.at(0);
+          if (encodable_player_id_arg.IsNull()) {
+            reply(WrapError("player_id_arg unexpectedly null."));
+            return;
+          }
+          const int64_t player_id_arg = encodable_player_id_arg.LongValue();
+          const auto& encodable_is_visible_arg = args.at(1);
+          if (encodable_is_visible_arg.IsNull()) {
+            reply(WrapError("is_visible_arg unexpectedly null."));
+            return;
+          }
+          const auto& is_visible_arg = std::get<bool>(encodable_is_visible_arg);
+          api->SetVisibilityHint(player_id_arg, is_visible_arg, [reply](std::optional<FlutterError>&& output) {
+            if (output.has_value()) {
+              reply(WrapError(output.value()));
+              return;
+            }
+            EncodableList wrapped;
+            wrapped.push_back(EncodableValue());
+            reply(EncodableValue(std::move(wrapped)));
+          });
+        } catch (const std::exception& exception) {
+          reply(WrapError(exception.what()));
+        }
+      });
+    } else {
+      channel.SetMessageHandler(nullptr);
+    }
+  }
   {
     BasicMessageChannel<> channel(binary_messenger, "dev.flutter.pigeon.pro_video_player_platform_interface.ProVideoPlayerHostApi.setSubtitleTrack" + prepended_suffix, &GetCodec());
     if (api != nullptr) {
@@ -3815,6 +4063,92 @@ void ProVideoPlayerHostApi::SetUp(
       channel.SetMessageHandler(nullptr);
     }
   }
+  {
+    BasicMessageChannel<> channel(binary_messenger, "dev.flutter.pigeon.pro_video_player_platform_interface.ProVideoPlayerHostApi.getWaveform" + prepended_suffix, &GetCodec());
+    if (api != nullptr) {
+      channel.SetMessageHandler([api](const EncodableValue& message, const flutter::MessageReply<EncodableValue>& reply) {
+        try {
+          const auto& args = std::get<EncodableList>(message);
+          const auto& encodable_player_id_arg = args.at(0);
+          if (encodable_player_id_arg.IsNull()) {
+            reply(WrapError("player_id_arg unexpectedly null."));
+            return;
+          }
+          const int64_t player_id_arg = encodable_player_id_arg.LongValue();
+          const auto& encodable_bucket_count_arg = args.at(1);
+          if (encodable_bucket_count_arg.IsNull()) {
+            reply(WrapError("bucket_count_arg unexpectedly null."));
+            return;
+          }
+          const int64_t bucket_count_arg = encodable_bucket_count_arg.LongValue();
+          api->GetWaveform(player_id_arg, bucket_count_arg, [reply](ErrorOr<std::optional<std::vector<uint8_t>>>&& output) {
+            if (output.has_error()) {
+              reply(WrapError(output.error()));
+              return;
+            }
+            EncodableList wrapped;
+            auto output_optional = std::move(output).TakeValue();
+            if (output_optional) {
+              wrapped.push_back(EncodableValue(std::move(output_optional).value()));
+            } else {
+              wrapped.push_back(EncodableValue());
+            }
+            reply(EncodableValue(std::move(wrapped)));
+          });
+        } catch (const std::exception& exception) {
+          reply(WrapError(exception.what()));
+        }
+      });
+    } else {
+      channel.SetMessageHandler(nullptr);
+    }
+  }
+  {
+    BasicMessageChannel<> channel(binary_messenger, "dev.flutter.pigeon.pro_video_player_platform_interface.ProVideoPlayerHostApi.captureFrame" + prepended_suffix, &GetCodec());
+    if (api != nullptr) {
+      channel.SetMessageHandler([api](const EncodableValue& message, const flutter::MessageReply<EncodableValue>& reply) {
+        try {
+          const auto& args = std::get<EncodableList>(message);
+          const auto& encodable_player_id_arg = args.at(0);
+          if (encodable_player_id_arg.IsNull()) {
+            reply(WrapError("player_id_arg unexpectedly null."));
+            return;
+          }
+          const int64_t player_id_arg = encodable_player_id_arg.LongValue();
+          const auto& encodable_max_width_arg = args.at(1);
+          if (encodable_max_width_arg.IsNull()) {
+            reply(WrapError("max_width_arg unexpectedly null."));
+            return;
+          }
+          const int64_t max_width_arg = encodable_max_width_arg.LongValue();
+          const auto& encodable_format_arg = args.at(2);
+          if (encodable_format_arg.IsNull()) {
+            reply(WrapError("format_arg unexpectedly null."));
+            return;
+          }
+          const auto& format_arg = std::get<std::string>(encodable_format_arg);
+          api->CaptureFrame(player_id_arg, max_width_arg, format_arg, [reply](ErrorOr<std::optional<CapturedFrameMessage>>&& output) {
+            if (output.has_error()) {
+              reply(WrapError(output.error()));
+              return;
+            }
+            EncodableList wrapped;
+            auto output_optional = std::move(output).TakeValue();
+            if (output_optional) {
+              wrapped.push_back(CustomEncodableValue(std::move(output_optional).value()));
+            } else {
+              wrapped.push_back(EncodableValue());
+            }
+            reply(EncodableValue(std::move(wrapped)));
+          });
+        } catch (const std::exception& exception) {
+          reply(WrapError(exception.what()));
+        }
+      });
+    } else {
+      channel.SetMessageHandler(nullptr);
+    }
+  }
   {
     BasicMessageChannel<> channel(binary_messenger, "dev.flutter.pigeon.pro_video_player_platform_interface.ProVideoPlayerHostApi.isCastingSupported" + prepended_suffix, &GetCodec());
     if (api != nullptr) {
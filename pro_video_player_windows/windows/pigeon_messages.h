@@ -269,7 +269,9 @@ class VideoPlayerOptionsMessage {
     bool allow_background_playback,
     bool mix_with_others,
     bool allow_pip,
-    bool auto_enter_pip_on_background);
+    bool auto_enter_pip_on_background,
+    const std::string* native_backend,
+    const bool* enable_audio_levels);
 
   // Whether to start playing automatically after initialization.
   bool auto_play() const;
@@ -343,6 +345,17 @@ class VideoPlayerOptionsMessage {
   bool auto_enter_pip_on_background() const;
   void set_auto_enter_pip_on_background(bool value_arg);
 
+  // Native decode backend for platforms that offer more than one
+  // (e.g. "gstreamer" or "mpv" on Linux). Null uses the platform default.
+  const std::string* native_backend() const;
+  void set_native_backend(const std::string_view* value_arg);
+  void set_native_backend(std::string_view value_arg);
+
+  // Whether to emit per-channel audio level events (VU meters).
+  const bool* enable_audio_levels() const;
+  void set_enable_audio_levels(const bool* value_arg);
+  void set_enable_audio_levels(bool value_arg);
+
 
  private:
   static VideoPlayerOptionsMessage FromEncodableList(const flutter::EncodableList& list);
@@ -366,6 +379,8 @@ class VideoPlayerOptionsMessage {
   bool mix_with_others_;
   bool allow_pip_;
   bool auto_enter_pip_on_background_;
+  std::optional<std::string> native_backend_;
+  std::optional<bool> enable_audio_levels_;
 
 };
 
@@ -1112,6 +1127,49 @@ class VideoPlayerEventMessage {
 };
 
 
+// A video frame grabbed by captureFrame.
+//
+// Generated class from Pigeon that represents data sent in messages.
+class CapturedFrameMessage {
+ public:
+  // Constructs an object setting all fields.
+  explicit CapturedFrameMessage(
+    const std::vector<uint8_t>& bytes,
+    int64_t width,
+    int64_t height,
+    int64_t position_ms);
+
+  // PNG or JPEG file, or tightly packed RGBA pixels for the 'raw' format.
+  const std::vector<uint8_t>& bytes() const;
+  void set_bytes(const std::vector<uint8_t>& value_arg);
+
+  // Width in pixels.
+  int64_t width() const;
+  void set_width(int64_t value_arg);
+
+  // Height in pixels.
+  int64_t height() const;
+  void set_height(int64_t value_arg);
+
+  // Position of the frame in the video, in milliseconds.
+  int64_t position_ms() const;
+  void set_position_ms(int64_t value_arg);
+
+
+ private:
+  static CapturedFrameMessage FromEncodableList(const flutter::EncodableList& list);
+  flutter::EncodableList ToEncodableList() const;
+  friend class ProVideoPlayerHostApi;
+  friend class ProVideoPlayerFlutterApi;
+  friend class PigeonInternalCodecSerializer;
+  std::vector<uint8_t> bytes_;
+  int64_t width_;
+  int64_t height_;
+  int64_t position_ms_;
+
+};
+
+
 class PigeonInternalCodecSerializer : public flutter::StandardCodecSerializer {
  public:
   PigeonInternalCodecSerializer();
@@ -1196,6 +1254,8 @@ class ProVideoPlayerHostApi {
   virtual void SetVerboseLogging(
     bool enabled,
     std::function<void(std::optional<FlutterError> reply)> result) = 0;
+  // Returns the native trace ring buffer as Chrome trace event JSON.
+  virtual void DumpNativeTrace(std::function<void(ErrorOr<std::string> reply)> result) = 0;
   // Checks if Picture-in-Picture mode is supported.
   virtual void SupportsPictureInPicture(std::function<void(ErrorOr<bool> reply)> result) = 0;
   // Checks if fullscreen mode is supported.
@@ -1267,6 +1327,30 @@ class ProVideoPlayerHostApi {
     int64_t player_id,
     const ControlsModeEnum& mode,
     std::function<void(std::optional<FlutterError> reply)> result) = 0;
+  // Reports the on-screen size of the player's video surface in physical pixels.
+  //
+  // Native players use this to cap decode resolution when the video is shown
+  // much smaller than its native size (e.g. thumbnails in a grid).
+  virtual void SetDisplaySize(
+    int64_t player_id,
+    int64_t width_px,
+    int64_t height_px,
+    std::function<void(std::optional<FlutterError> reply)> result) = 0;
+  // Caps how many video frames per second the player renders.
+  //
+  // A negative [maxFps] renders at the video's native frame rate. Zero renders
+  // no video frames at all while audio keeps playing.
+  virtual void SetMaxRenderFrameRate(
+    int64_t player_id,
+    int64_t max_fps,
+    std::function<void(std::optional<FlutterError> reply)> result) = 0;
+  // Tells the player whether its view is currently visible on screen.
+  //
+  // Hidden players stop rendering video frames; audio is unaffected.
+  virtual void SetVisibilityHint(
+    int64_t player_id,
+    bool is_visible,
+    std::function<void(std::optional<FlutterError> reply)> result) = 0;
   // Sets the active subtitle track.
   virtual void SetSubtitleTrack(
     int64_t player_id,
@@ -1357,6 +1441,20 @@ class ProVideoPlayerHostApi {
     int64_t player_id,
     const MediaMetadataMessage& metadata,
     std::function<void(std::optional<FlutterError> reply)> result) = 0;
+  // Gets a peak-amplitude summary of the whole file with at most
+  // [bucketCount] entries (0-255 each). Null when unsupported.
+  virtual void GetWaveform(
+    int64_t player_id,
+    int64_t bucket_count,
+    std::function<void(ErrorOr<std::optional<std::vector<uint8_t>>> reply)> result) = 0;
+  // Grabs the current video frame, scaled down to at most [maxWidth] pixels
+  // wide (0 keeps the video's width) and encoded as [format] ('png', 'jpeg'
+  // or 'raw' RGBA). Null when unsupported.
+  virtual void CaptureFrame(
+    int64_t player_id,
+    int64_t max_width,
+    const std::string& format,
+    std::function<void(ErrorOr<std::optional<CapturedFrameMessage>> reply)> result) = 0;
   // Checks if casting is supported on this platform.
   virtual void IsCastingSupported(std::function<void(ErrorOr<bool> reply)> result) = 0;
   // Gets available cast devices.
@@ -401,6 +401,39 @@ open class SharedPluginBase: NSObject, ProVideoPlayerHostApi {
         completion(.success(()))
     }
 
+    func setDisplaySize(playerId: Int64, widthPx: Int64, heightPx: Int64, completion: @escaping (Result<Void, Error>) -> Void) {
+
+        guard let player = players[Int(playerId)] else {
+            completion(.failure(PigeonError(code: "INVALID_PLAYER", message: "Player \(playerId) not found", details: nil)))
+            return
+        }
+
+        player.setDisplaySize(width: Int(widthPx), height: Int(heightPx))
+        completion(.success(()))
+    }
+
+    func setMaxRenderFrameRate(playerId: Int64, maxFps: Int64, completion: @escaping (Result<Void, Error>) -> Void) {
+
+        guard let player = players[Int(playerId)] else {
+            completion(.failure(PigeonError(code: "INVALID_PLAYER", message: "Player \(playerId) not found", details: nil)))
+            return
+        }
+
+        player.setMaxRenderFrameRate(Int(maxFps))
+        completion(.success(()))
+    }
+
+    func setVisibilityHint(playerId: Int64, isVisible: Bool, completion: @escaping (Result<Void, Error>) -> Void) {
+
+        guard let player = players[Int(playerId)] else {
+            completion(.failure(PigeonError(code: "INVALID_PLAYER", message: "Player \(playerId) not found", details: nil)))
+            return
+        }
+
+        player.setVisibilityHint(isVisible)
+        completion(.success(()))
+    }
+
     func setSubtitleTrack(playerId: Int64, track: SubtitleTrackMessage?, completion: @escaping (Result<Void, Error>) -> Void) {
 
         guard let player = players[Int(playerId)] else {
@@ -711,6 +744,28 @@ open class SharedPluginBase: NSObject, ProVideoPlayerHostApi {
         completion(.success(metadata))
     }
 
+    func getWaveform(playerId: Int64, bucketCount: Int64, completion: @escaping (Result<FlutterStandardTypedData?, Error>) -> Void) {
+
+        guard players[Int(playerId)] != nil else {
+            completion(.failure(PigeonError(code: "INVALID_PLAYER", message: "Player \(playerId) not found", details: nil)))
+            return
+        }
+
+        // AVPlayer has no cheap whole-file audio scan; waveforms come from the desktop core
+        completion(.success(nil))
+    }
+
+    func captureFrame(playerId: Int64, maxWidth: Int64, format: String, completion: @escaping (Result<CapturedFrameMessage?, Error>) -> Void) {
+
+        guard players[Int(playerId)] != nil else {
+            completion(.failure(PigeonError(code: "INVALID_PLAYER", message: "Player \(playerId) not found", details: nil)))
+            return
+        }
+
+        // AVPlayerLayer frames aren't readable here; frame grabs come from the desktop core
+        completion(.success(nil))
+    }
+
     func getVideoQualities(playerId: Int64, completion: @escaping (Result<[VideoQualityTrackMessage?], Error>) -> Void) {
 
         guard let player = players[Int(playerId)] else {
@@ -927,6 +982,12 @@ open class SharedPluginBase: NSObject, ProVideoPlayerHostApi {
         completion(.success(()))
     }
 
+    func dumpNativeTrace(completion: @escaping (Result<String, Error>) -> Void) {
+        // AVFoundation's pipeline is traced with Instruments (os_signpost);
+        // there is no plugin-side ring buffer on Apple platforms.
+        completion(.success("{\"traceEvents\":[]}"))
+    }
+
     func supportsPictureInPicture(completion: @escaping (Result<Bool, Error>) -> Void) {
         completion(.success(platformBehavior.isPipSupported()))
     }
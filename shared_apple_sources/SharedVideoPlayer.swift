@@ -56,6 +56,12 @@ class SharedVideoPlayer: NSObject {
     private var isPipActive: Bool = false
     private var isInBackground: Bool = false
     private var userRequestedPip: Bool = false  // Tracks if PiP was explicitly requested by user
+
+    // Render-rate state: -1 = native frame rate, 0 = no video frames (audio only)
+    private var maxRenderFrameRate: Int = -1
+    private var isViewVisible: Bool = true
+    // Desired state, kept until there is a player and item to apply it to
+    private var isVideoRenderingDisabled: Bool = false
     #if os(macOS)
     private var wakeLockActivity: NSObjectProtocol?
     #endif
@@ -88,6 +94,9 @@ class SharedVideoPlayer: NSObject {
     private var currentQualityTrackId: String = "auto"
     private var availableQualityTracks: [[String: Any]] = []
 
+    // On-screen size of the video view in pixels; caps auto quality (.zero = no cap)
+    private var displaySize: CGSize = .zero
+
     // Bandwidth estimation
     private var lastSentBandwidth: Int = -1
     private var lastBandwidthUpdateTime: TimeInterval = 0
@@ -210,6 +219,7 @@ class SharedVideoPlayer: NSObject {
             }
 
             let playerItem = AVPlayerItem(asset: asset)
+            playerItem.preferredMaximumResolution = self.displaySize
 
             // Configure buffering based on tier
             if let bufferingTier = options["bufferingTier"] as? String {
@@ -229,6 +239,8 @@ class SharedVideoPlayer: NSObject {
                 self.player = player
                 self.playerItem = playerItem
                 self.playerLayer?.videoGravity = .resizeAspect
+                // Render-policy hints may have arrived before the player existed
+                self.applyVideoRendering()
             }
 
             // Phase 2: Configure remaining options (can be async)
@@ -521,6 +533,9 @@ class SharedVideoPlayer: NSObject {
 
         switch item.status {
         case .readyToPlay:
+            // The item's tracks exist from now on
+            applyVideoRendering()
+
             let duration = Int(CMTimeGetSeconds(item.duration) * 1000)
             sendEvent(["type": "durationChanged", "duration": duration])
 
@@ -850,6 +865,7 @@ class SharedVideoPlayer: NSObject {
     @objc func handleAppDidEnterBackground() {
         isInBackground = true
         updateScreenSleepPrevention()
+        updateVideoRendering()
 
         // Determine what should happen when app goes to background:
         // 1. If autoEnterPipOnBackground is enabled -> enter PiP (video continues in floating window)
@@ -860,13 +876,10 @@ class SharedVideoPlayer: NSObject {
             // User wants PiP when backgrounding
             _ = enterPip()
         } else if allowBackgroundPlayback {
-            // Background audio-only mode: disconnect video layer so AVPlayer only outputs audio.
-            // On iOS, if the video layer is still connected when backgrounding, iOS may pause
-            // the player because the video rendering surface is not visible.
-            // By disconnecting the layer, audio continues in background.
-            #if os(iOS)
-            playerLayer?.player = nil
-            #endif
+            // Background audio-only mode: updateVideoRendering() above disconnects the
+            // video layer so AVPlayer only outputs audio. On iOS, if the video layer is
+            // still connected when backgrounding, iOS may pause the player because the
+            // video rendering surface is not visible.
         } else {
             // Background playback is disabled - pause the video
             // This prevents iOS from trying to preserve playback via PiP
@@ -881,13 +894,8 @@ class SharedVideoPlayer: NSObject {
     @objc func handleAppWillEnterForeground() {
         isInBackground = false
         updateScreenSleepPrevention()
-
-        // Reconnect video layer if it was disconnected for background audio-only mode
-        #if os(iOS)
-        if allowBackgroundPlayback && playerLayer?.player == nil {
-            playerLayer?.player = player
-        }
-        #endif
+        // Reconnects the video layer if it was disconnected for background audio-only mode
+        updateVideoRendering()
 
         // If playback was paused due to backgrounding (not user-initiated pause),
         // and the video was playing before, resume playback.
@@ -1605,7 +1613,7 @@ class SharedVideoPlayer: NSObject {
             // Enable automatic quality selection by removing resolution limit
             isAutoQuality = true
             currentQualityTrackId = "auto"
-            item.preferredMaximumResolution = .zero
+            item.preferredMaximumResolution = displaySize
             item.preferredPeakBitRate = 0
 
             sendEvent(["type": "selectedQualityChanged",
@@ -1644,6 +1652,22 @@ class SharedVideoPlayer: NSObject {
         return true
     }
 
+    /// Sets the on-screen size of the video view in pixels.
+    /// While quality is automatic, AVPlayer won't pick variants larger than the view,
+    /// so small players (grid thumbnails) don't download and decode full resolution.
+    func setDisplaySize(width: Int, height: Int) {
+        guard width > 0, height > 0 else { return }
+        displaySize = CGSize(width: width, height: height)
+        verboseLog("setDisplaySize: \(width)x\(height)", tag: "Quality")
+
+        // A manual quality selection takes precedence
+        guard isAutoQuality else { return }
+        DispatchQueue.main.async { [weak self] in
+            guard let self = self else { return }
+            self.playerItem?.preferredMaximumResolution = self.displaySize
+        }
+    }
+
     /// Gets the currently selected video quality track.
     func getCurrentVideoQuality() -> [String: Any] {
         if isAutoQuality {
@@ -1698,12 +1722,70 @@ class SharedVideoPlayer: NSObject {
             // This allows Bluetooth controls to work during foreground playback.
             // Only the audio session category changes based on this setting.
             updateNowPlayingInfo()
+            updateVideoRendering()
 
             sendEvent(["type": "backgroundPlaybackChanged", "isEnabled": enabled])
         }
         return success
     }
 
+    /// Caps the video render rate (-1 = native frame rate, 0 = no video frames).
+    ///
+    /// AVPlayer has no hook to drop frames before they reach the layer, so only
+    /// the 0 fps cap is applied: it disables the item's video tracks, which stops
+    /// video decoding while audio continues. Other caps render at the native rate.
+    func setMaxRenderFrameRate(_ maxFps: Int) {
+        maxRenderFrameRate = maxFps
+        updateVideoRendering()
+    }
+
+    /// Updates whether the Flutter view showing this player is visible.
+    /// Hidden players stop rendering video until shown again.
+    func setVisibilityHint(_ isVisible: Bool) {
+        isViewVisible = isVisible
+        updateVideoRendering()
+    }
+
+    /// Works out whether video should be off from the render-rate cap, view
+    /// visibility and background audio-only playback, and applies it. Audio is
+    /// never affected, and PiP always shows video.
+    private func updateVideoRendering() {
+        #if os(iOS)
+        let backgroundAudioOnly = isInBackground && allowBackgroundPlayback && !(autoEnterPipOnBackground && allowPip)
+        #else
+        // On macOS "background" only means another app is active; the video is still on screen
+        let backgroundAudioOnly = false
+        #endif
+        let pipShowing = isPipActive || userRequestedPip
+        isVideoRenderingDisabled = !pipShowing && (maxRenderFrameRate == 0 || !isViewVisible || backgroundAudioOnly)
+
+        DispatchQueue.main.async { [weak self] in
+            self?.applyVideoRendering()
+        }
+    }
+
+    /// Brings the player in line with `isVideoRenderingDisabled`. Also runs when the
+    /// player is created and when its item becomes ready, so hints that arrive
+    /// before either are kept.
+    ///
+    /// Detaching the player from its layer is Apple's documented way to play only
+    /// the audio of a video item, and works for HLS, where toggling
+    /// `AVPlayerItemTrack.isEnabled` is unreliable (the item's tracks follow the
+    /// variant being played). Disabling the tracks as well stops video decoding of
+    /// file-based assets.
+    private func applyVideoRendering() {
+        guard let player = player else { return }
+        let disable = isVideoRenderingDisabled
+        let layerPlayer: AVPlayer? = disable ? nil : player
+        if playerLayer?.player !== layerPlayer {
+            verboseLog("updateVideoRendering: video \(disable ? "disabled" : "enabled")", tag: "Playback")
+            playerLayer?.player = layerPlayer
+        }
+        for track in playerItem?.tracks ?? [] where track.assetTrack?.mediaType == .video {
+            track.isEnabled = !disable
+        }
+    }
+
     /// Returns the current background playback enabled state.
     func isBackgroundPlaybackEnabled() -> Bool {
         return allowBackgroundPlayback
@@ -2340,6 +2422,7 @@ extension SharedVideoPlayer: AVPictureInPictureControllerDelegate {
         isPipActive = true
         sendEvent(["type": "pipStateChanged", "isActive": true])
         updateScreenSleepPrevention()
+        updateVideoRendering()
     }
 
     func pictureInPictureControllerDidStopPictureInPicture(
@@ -2349,6 +2432,7 @@ extension SharedVideoPlayer: AVPictureInPictureControllerDelegate {
         userRequestedPip = false  // Reset the flag when PiP stops
         sendEvent(["type": "pipStateChanged", "isActive": false])
         updateScreenSleepPrevention()
+        updateVideoRendering()
     }
 
     /// Called when the user taps the "expand" button in PiP to return to the app.
@@ -193,6 +193,18 @@ open class SharedVideoPlayerWrapper: NSObject {
     public func setVideoQuality(_ quality: [String: Any]?) -> Bool {
         return sharedPlayer.setVideoQuality(quality)
     }
+
+    public func setDisplaySize(width: Int, height: Int) {
+        sharedPlayer.setDisplaySize(width: width, height: height)
+    }
+
+    public func setMaxRenderFrameRate(_ maxFps: Int) {
+        sharedPlayer.setMaxRenderFrameRate(maxFps)
+    }
+
+    public func setVisibilityHint(_ isVisible: Bool) {
+        sharedPlayer.setVisibilityHint(isVisible)
+    }
     
     public func getCurrentVideoQuality() -> [String: Any]? {
         return sharedPlayer.getCurrentVideoQuality()
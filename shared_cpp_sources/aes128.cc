@@ -0,0 +1,278 @@
+#include "aes128.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#define PVP_AES_X86 1
+#include <emmintrin.h>
+#include <wmmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define PVP_AES_TARGET
+#else
+#define PVP_AES_TARGET __attribute__((target("aes,sse2")))
+#endif
+#elif defined(__aarch64__) && (defined(__linux__) || defined(__APPLE__))
+#define PVP_AES_ARM 1
+#include <arm_neon.h>
+#if defined(__linux__)
+#include <sys/auxv.h>
+#ifndef HWCAP_AES
+#define HWCAP_AES (1 << 3)
+#endif
+#endif
+#if defined(__clang__)
+#define PVP_AES_TARGET __attribute__((target("aes")))
+#else
+#define PVP_AES_TARGET __attribute__((target("+crypto")))
+#endif
+#endif
+
+namespace pro_video_player {
+
+namespace {
+
+// Blocks decrypted side by side: CBC decryption has no chain between
+// blocks, and the AES units are pipelined.
+constexpr size_t kLanes = 4;
+
+uint8_t Xtime(uint8_t x) { return static_cast<uint8_t>((x << 1) ^ ((x & 0x80) ? 0x1b : 0)); }
+
+uint8_t Multiply(uint8_t x, uint8_t y) {
+  uint8_t product = 0;
+  for (; y != 0; y >>= 1, x = Xtime(x)) {
+    if (y & 1) product ^= x;
+  }
+  return product;
+}
+
+struct Tables {
+  uint8_t sbox[256];
+  uint8_t inv_sbox[256];
+
+  Tables() {
+    // S-box: multiplicative inverse in GF(2^8), then the affine transform
+    for (int x = 0; x < 256; ++x) {
+      uint8_t inverse = 0;
+      for (int y = 1; y < 256 && x != 0; ++y) {
+        if (Multiply(static_cast<uint8_t>(x), static_cast<uint8_t>(y)) == 1) {
+          inverse = static_cast<uint8_t>(y);
+          break;
+        }
+      }
+      uint8_t s = inverse;
+      for (int shift = 1; shift <= 4; ++shift) {
+        s ^= static_cast<uint8_t>((inverse << shift) | (inverse >> (8 - shift)));
+      }
+      s ^= 0x63;
+      sbox[x] = s;
+      inv_sbox[s] = static_cast<uint8_t>(x);
+    }
+  }
+};
+
+const Tables& GetTables() {
+  static const Tables tables;
+  return tables;
+}
+
+void InvMixColumns(uint8_t block[16]) {
+  for (int c = 0; c < 4; ++c) {
+    uint8_t* column = block + 4 * c;
+    const uint8_t a0 = column[0], a1 = column[1], a2 = column[2], a3 = column[3];
+    column[0] = Multiply(a0, 14) ^ Multiply(a1, 11) ^ Multiply(a2, 13) ^ Multiply(a3, 9);
+    column[1] = Multiply(a0, 9) ^ Multiply(a1, 14) ^ Multiply(a2, 11) ^ Multiply(a3, 13);
+    column[2] = Multiply(a0, 13) ^ Multiply(a1, 9) ^ Multiply(a2, 14) ^ Multiply(a3, 11);
+    column[3] = Multiply(a0, 11) ^ Multiply(a1, 13) ^ Multiply(a2, 9) ^ Multiply(a3, 14);
+  }
+}
+
+// InvSubBytes and InvShiftRows (row r moves r columns right).
+void InvSubShift(uint8_t block[16], const uint8_t inv_sbox[256]) {
+  uint8_t out[16];
+  for (int c = 0; c < 4; ++c) {
+    for (int r = 0; r < 4; ++r) out[4 * ((c + r) % 4) + r] = inv_sbox[block[4 * c + r]];
+  }
+  std::memcpy(block, out, 16);
+}
+
+void XorBlock(uint8_t* block, const uint8_t* other) {
+  for (size_t i = 0; i < 16; ++i) block[i] ^= other[i];
+}
+
+void DecryptBlockPortable(const uint8_t keys[11][16], uint8_t block[16]) {
+  const Tables& tables = GetTables();
+  XorBlock(block, keys[0]);
+  for (int round = 1; round < 10; ++round) {
+    InvSubShift(block, tables.inv_sbox);
+    InvMixColumns(block);
+    XorBlock(block, keys[round]);
+  }
+  InvSubShift(block, tables.inv_sbox);
+  XorBlock(block, keys[10]);
+}
+
+void DecryptCbcPortable(const uint8_t keys[11][16], uint8_t* data, size_t size, uint8_t iv[16]) {
+  uint8_t ciphertext[16];
+  for (size_t offset = 0; offset < size; offset += 16) {
+    uint8_t* block = data + offset;
+    std::memcpy(ciphertext, block, 16);
+    DecryptBlockPortable(keys, block);
+    XorBlock(block, iv);
+    std::memcpy(iv, ciphertext, 16);
+  }
+}
+
+#if defined(PVP_AES_X86)
+
+bool HasAesInstructions() {
+#if defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 1);
+  return (info[2] & (1 << 25)) != 0;
+#else
+  return __builtin_cpu_supports("aes");
+#endif
+}
+
+PVP_AES_TARGET void DecryptCbcHardware(const uint8_t keys[11][16], uint8_t* data, size_t size, uint8_t iv[16]) {
+  __m128i k[11];
+  for (int i = 0; i < 11; ++i) k[i] = _mm_load_si128(reinterpret_cast<const __m128i*>(keys[i]));
+  __m128i previous = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iv));
+  size_t offset = 0;
+  for (; offset + kLanes * 16 <= size; offset += kLanes * 16) {
+    __m128i* blocks = reinterpret_cast<__m128i*>(data + offset);
+    __m128i in[kLanes];
+    __m128i state[kLanes];
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+      in[lane] = _mm_loadu_si128(blocks + lane);
+      state[lane] = _mm_xor_si128(in[lane], k[0]);
+    }
+    for (int round = 1; round < 10; ++round) {
+      for (size_t lane = 0; lane < kLanes; ++lane) state[lane] = _mm_aesdec_si128(state[lane], k[round]);
+    }
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+      state[lane] = _mm_aesdeclast_si128(state[lane], k[10]);
+      _mm_storeu_si128(blocks + lane, _mm_xor_si128(state[lane], previous));
+      previous = in[lane];
+    }
+  }
+  for (; offset < size; offset += 16) {
+    __m128i* block = reinterpret_cast<__m128i*>(data + offset);
+    const __m128i in = _mm_loadu_si128(block);
+    __m128i state = _mm_xor_si128(in, k[0]);
+    for (int round = 1; round < 10; ++round) state = _mm_aesdec_si128(state, k[round]);
+    state = _mm_aesdeclast_si128(state, k[10]);
+    _mm_storeu_si128(block, _mm_xor_si128(state, previous));
+    previous = in;
+  }
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(iv), previous);
+}
+
+#elif defined(PVP_AES_ARM)
+
+bool HasAesInstructions() {
+#if defined(__linux__)
+  return (getauxval(AT_HWCAP) & HWCAP_AES) != 0;
+#else
+  // Every arm64 Apple chip has the crypto extension
+  return true;
+#endif
+}
+
+// AESD is AddRoundKey + InvShiftRows + InvSubBytes, so the key of each
+// round goes in first and the last one is a plain XOR.
+PVP_AES_TARGET void DecryptCbcHardware(const uint8_t keys[11][16], uint8_t* data, size_t size, uint8_t iv[16]) {
+  uint8x16_t k[11];
+  for (int i = 0; i < 11; ++i) k[i] = vld1q_u8(keys[i]);
+  uint8x16_t previous = vld1q_u8(iv);
+  size_t offset = 0;
+  for (; offset + kLanes * 16 <= size; offset += kLanes * 16) {
+    uint8_t* blocks = data + offset;
+    uint8x16_t in[kLanes];
+    uint8x16_t state[kLanes];
+    for (size_t lane = 0; lane < kLanes; ++lane) state[lane] = in[lane] = vld1q_u8(blocks + 16 * lane);
+    for (int round = 0; round < 9; ++round) {
+      for (size_t lane = 0; lane < kLanes; ++lane) state[lane] = vaesimcq_u8(vaesdq_u8(state[lane], k[round]));
+    }
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+      state[lane] = veorq_u8(vaesdq_u8(state[lane], k[9]), k[10]);
+      vst1q_u8(blocks + 16 * lane, veorq_u8(state[lane], previous));
+      previous = in[lane];
+    }
+  }
+  for (; offset < size; offset += 16) {
+    uint8_t* block = data + offset;
+    const uint8x16_t in = vld1q_u8(block);
+    uint8x16_t state = in;
+    for (int round = 0; round < 9; ++round) state = vaesimcq_u8(vaesdq_u8(state, k[round]));
+    state = veorq_u8(vaesdq_u8(state, k[9]), k[10]);
+    vst1q_u8(block, veorq_u8(state, previous));
+    previous = in;
+  }
+  vst1q_u8(iv, previous);
+}
+
+#else
+
+bool HasAesInstructions() { return false; }
+
+void DecryptCbcHardware(const uint8_t keys[11][16], uint8_t* data, size_t size, uint8_t iv[16]) {
+  DecryptCbcPortable(keys, data, size, iv);
+}
+
+#endif
+
+bool UseHardware() {
+  static const bool hardware = HasAesInstructions();
+  return hardware;
+}
+
+}  // namespace
+
+Aes128::Aes128(const uint8_t key[16]) {
+  const Tables& tables = GetTables();
+  // FIPS-197 key expansion: 44 words, four per round
+  uint8_t words[44][4];
+  std::memcpy(words, key, 16);
+  uint8_t rcon = 1;
+  for (int i = 4; i < 44; ++i) {
+    uint8_t temp[4];
+    std::memcpy(temp, words[i - 1], 4);
+    if (i % 4 == 0) {
+      const uint8_t first = temp[0];
+      temp[0] = static_cast<uint8_t>(tables.sbox[temp[1]] ^ rcon);
+      temp[1] = tables.sbox[temp[2]];
+      temp[2] = tables.sbox[temp[3]];
+      temp[3] = tables.sbox[first];
+      rcon = Xtime(rcon);
+    }
+    for (int j = 0; j < 4; ++j) words[i][j] = words[i - 4][j] ^ temp[j];
+  }
+  // Equivalent inverse cipher: encryption keys in reverse, the inner ones
+  // through InvMixColumns
+  for (int round = 0; round <= 10; ++round) {
+    std::memcpy(round_keys_[round], words[4 * (10 - round)], 16);
+    if (round != 0 && round != 10) InvMixColumns(round_keys_[round]);
+  }
+}
+
+void Aes128::DecryptCbc(uint8_t* data, size_t size, uint8_t iv[16]) const {
+  size -= size % kBlockSize;
+  if (UseHardware()) {
+    DecryptCbcHardware(round_keys_, data, size, iv);
+  } else {
+    DecryptCbcPortable(round_keys_, data, size, iv);
+  }
+}
+
+const char* Aes128::Implementation() {
+  if (!UseHardware()) return "portable";
+#if defined(PVP_AES_X86)
+  return "aesni";
+#else
+  return "armv8";
+#endif
+}
+
+}  // namespace pro_video_player
@@ -0,0 +1,39 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_AES128_H_
+#define PRO_VIDEO_PLAYER_SHARED_AES128_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pro_video_player {
+
+// AES-128 decryption for HLS (EXT-X-KEY METHOD=AES-128 and SAMPLE-AES).
+//
+// Uses the CPU's AES instructions where present (AES-NI on x86, the ARMv8
+// crypto extension on arm64), chosen once at run time; elsewhere a
+// portable byte-wise implementation that is correct but several times
+// slower. No dependency on a crypto library, so it is always built.
+//
+// Immutable after construction; one instance may be shared across threads.
+class Aes128 {
+ public:
+  static constexpr size_t kBlockSize = 16;
+
+  explicit Aes128(const uint8_t key[16]);
+
+  // CBC-decrypts the whole blocks of |data| in place; a trailing partial
+  // block is left as it is. |iv| is advanced to the last ciphertext block,
+  // so a stream can be decrypted in pieces.
+  void DecryptCbc(uint8_t* data, size_t size, uint8_t iv[16]) const;
+
+  // "aesni", "armv8" or "portable".
+  static const char* Implementation();
+
+ private:
+  // Decryption round keys in the order they are applied, in the
+  // "equivalent inverse cipher" form the AES instructions expect.
+  alignas(16) uint8_t round_keys_[11][16];
+};
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_AES128_H_
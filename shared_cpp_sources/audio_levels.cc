@@ -0,0 +1,133 @@
+#include "audio_levels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "simd_float4.h"
+
+namespace pro_video_player {
+
+namespace {
+
+#if defined(PVP_SIMD_FLOAT4)
+
+// lcm(channels, 4) / 4 for up to 8 channels never exceeds 7.
+constexpr int kMaxBlockVectors = 8;
+// Float sums of squares are moved into the double totals this often to
+// keep rounding error negligible on long windows.
+constexpr size_t kFlushBlocks = 256;
+
+#endif  // PVP_SIMD_FLOAT4
+
+void AccumulateScalar(const float* interleaved, size_t frames, int channels, float* peak,
+                      double* sum_squares) {
+  for (size_t frame = 0; frame < frames; ++frame) {
+    const float* sample = interleaved + frame * channels;
+    for (int channel = 0; channel < channels; ++channel) {
+      const float value = sample[channel];
+      peak[channel] = std::max(peak[channel], std::fabs(value));
+      sum_squares[channel] += static_cast<double>(value) * value;
+    }
+  }
+}
+
+}  // namespace
+
+void AccumulateLevels(const float* interleaved, size_t frames, int channels, float* peak,
+                      double* sum_squares) {
+  if (interleaved == nullptr || frames == 0 || channels <= 0) return;
+  size_t done = 0;
+#if defined(PVP_SIMD_FLOAT4)
+  // A block of lcm(channels, 4) samples pins every lane of every vector to
+  // one channel, so interleaved data of any layout stays in registers.
+  const int block_samples = std::lcm(channels, simd::kLanes);
+  const int vectors = block_samples / simd::kLanes;
+  if (vectors <= kMaxBlockVectors) {
+    const size_t block_frames = static_cast<size_t>(block_samples / channels);
+    const size_t blocks = frames / block_frames;
+    simd::Vec peaks[kMaxBlockVectors];
+    simd::Vec squares[kMaxBlockVectors];
+    for (int v = 0; v < vectors; ++v) {
+      peaks[v] = simd::Zero();
+      squares[v] = simd::Zero();
+    }
+    alignas(16) float lanes[simd::kLanes];
+    auto flush_squares = [&]() {
+      for (int v = 0; v < vectors; ++v) {
+        simd::Store(lanes, squares[v]);
+        for (int lane = 0; lane < simd::kLanes; ++lane) {
+          sum_squares[(v * simd::kLanes + lane) % channels] += lanes[lane];
+        }
+        squares[v] = simd::Zero();
+      }
+    };
+
+    const float* block = interleaved;
+    for (size_t b = 0; b < blocks; ++b, block += block_samples) {
+      for (int v = 0; v < vectors; ++v) {
+        const simd::Vec x = simd::Load(block + v * simd::kLanes);
+        peaks[v] = simd::Max(peaks[v], simd::Abs(x));
+        squares[v] = simd::MulAdd(squares[v], x, x);
+      }
+      if ((b + 1) % kFlushBlocks == 0) flush_squares();
+    }
+    flush_squares();
+    for (int v = 0; v < vectors; ++v) {
+      simd::Store(lanes, peaks[v]);
+      for (int lane = 0; lane < simd::kLanes; ++lane) {
+        float& channel_peak = peak[(v * simd::kLanes + lane) % channels];
+        channel_peak = std::max(channel_peak, lanes[lane]);
+      }
+    }
+    done = blocks * block_frames;
+  }
+#endif
+  AccumulateScalar(interleaved + done * channels, frames - done, channels, peak, sum_squares);
+}
+
+float PeakAbs(const float* samples, size_t count) {
+  if (samples == nullptr) return 0.0f;
+  float peak = 0.0f;
+  size_t i = 0;
+#if defined(PVP_SIMD_FLOAT4)
+  simd::Vec a = simd::Zero();
+  simd::Vec b = simd::Zero();
+  for (; i + 2 * simd::kLanes <= count; i += 2 * simd::kLanes) {
+    a = simd::Max(a, simd::Abs(simd::Load(samples + i)));
+    b = simd::Max(b, simd::Abs(simd::Load(samples + i + simd::kLanes)));
+  }
+  alignas(16) float lanes[simd::kLanes];
+  simd::Store(lanes, simd::Max(a, b));
+  peak = *std::max_element(lanes, lanes + simd::kLanes);
+#endif
+  for (; i < count; ++i) peak = std::max(peak, std::fabs(samples[i]));
+  return peak;
+}
+
+void AudioLevelMeter::Add(const AudioSamples& samples) {
+  if (samples.channels <= 0 || samples.channels > kMaxMeteredChannels) return;
+  if (samples.channels != channels_) {
+    // Layout change (track switch): restart the window
+    TakeLevels();
+    channels_ = samples.channels;
+  }
+  AccumulateLevels(samples.data, samples.frames, channels_, peak_, sum_squares_);
+  frames_ += samples.frames;
+}
+
+AudioLevels AudioLevelMeter::TakeLevels() {
+  AudioLevels levels;
+  levels.peak.assign(peak_, peak_ + channels_);
+  levels.rms.resize(channels_);
+  for (int channel = 0; channel < channels_; ++channel) {
+    levels.rms[channel] =
+        frames_ > 0 ? static_cast<float>(std::sqrt(sum_squares_[channel] / frames_)) : 0.0f;
+  }
+  std::fill(std::begin(peak_), std::end(peak_), 0.0f);
+  std::fill(std::begin(sum_squares_), std::end(sum_squares_), 0.0);
+  frames_ = 0;
+  return levels;
+}
+
+}  // namespace pro_video_player
@@ -0,0 +1,50 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_AUDIO_LEVELS_H_
+#define PRO_VIDEO_PLAYER_SHARED_AUDIO_LEVELS_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "player_types.h"
+
+namespace pro_video_player {
+
+// Widest layout the meter handles (7.1); wider streams are not metered.
+inline constexpr int kMaxMeteredChannels = 8;
+
+// Adds the absolute peak and the sum of squares of each channel of
+// |frames| interleaved samples to |peak| and |sum_squares| (|channels|
+// entries each). Vectorised with SSE2 / NEON where available.
+void AccumulateLevels(const float* interleaved, size_t frames, int channels, float* peak,
+                      double* sum_squares);
+
+// Largest absolute value among |count| samples.
+float PeakAbs(const float* samples, size_t count);
+
+// Per-channel peak and RMS (linear, 1.0 = full scale) over one window.
+struct AudioLevels {
+  std::vector<float> peak;
+  std::vector<float> rms;
+};
+
+// Accumulates levels over a metering window. Not thread-safe; fed from the
+// backend's audio thread.
+class AudioLevelMeter {
+ public:
+  void Add(const AudioSamples& samples);
+
+  // Frames accumulated since the last TakeLevels().
+  size_t frames() const { return frames_; }
+
+  // Returns the window's levels and starts a new window.
+  AudioLevels TakeLevels();
+
+ private:
+  int channels_ = 0;
+  size_t frames_ = 0;
+  float peak_[kMaxMeteredChannels] = {};
+  double sum_squares_[kMaxMeteredChannels] = {};
+};
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_AUDIO_LEVELS_H_
@@ -0,0 +1,882 @@
+#include "backends/mpv_decode_backend.h"
+
+#include <mpv/client.h>
+#include <mpv/render.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <clocale>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <poll.h>
+#ifdef __linux__
+#include <link.h>
+#endif
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "trace_recorder.h"
+
+namespace pro_video_player {
+
+namespace {
+
+// reply_userdata of observed properties.
+enum ObservedProperty : uint64_t {
+  kTimePos = 1,
+  kPausedForCache,
+  kDemuxerCacheTime,
+  kEofReached,
+  kTrackList,
+  kVideoOutParams,
+  kSubText,
+};
+
+const mpv_node* MapGet(const mpv_node& node, const char* key) {
+  if (node.format != MPV_FORMAT_NODE_MAP) return nullptr;
+  for (int i = 0; i < node.u.list->num; ++i) {
+    if (std::strcmp(node.u.list->keys[i], key) == 0) return &node.u.list->values[i];
+  }
+  return nullptr;
+}
+
+std::string MapString(const mpv_node& node, const char* key) {
+  const mpv_node* value = MapGet(node, key);
+  return value != nullptr && value->format == MPV_FORMAT_STRING ? value->u.string : "";
+}
+
+int64_t MapInt(const mpv_node& node, const char* key) {
+  const mpv_node* value = MapGet(node, key);
+  return value != nullptr && value->format == MPV_FORMAT_INT64 ? value->u.int64 : 0;
+}
+
+bool MapFlag(const mpv_node& node, const char* key) {
+  const mpv_node* value = MapGet(node, key);
+  return value != nullptr && value->format == MPV_FORMAT_FLAG && value->u.flag != 0;
+}
+
+// Label of the metering filter, and how often its stats are read: the
+// player's audioLevelsChanged cadence.
+constexpr char kLevelsFilterLabel[] = "pvp-levels";
+constexpr std::chrono::milliseconds kLevelsPollInterval{50};
+
+// astats reports levels in dBFS ("-inf" for silence).
+float DbToLinear(const char* db) { return static_cast<float>(std::pow(10.0, std::strtod(db, nullptr) / 20.0)); }
+
+int64_t SecondsToMs(double seconds) { return static_cast<int64_t>(std::llround(seconds * 1000.0)); }
+
+bool EqualsIgnoreCase(const std::string& a, const char* b) {
+  if (a.size() != std::strlen(b)) return false;
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void SetHeaderOptions(mpv_handle* mpv, const MediaSource& source) {
+  if (source.headers.empty()) return;
+  std::vector<std::string> fields;
+  for (const auto& header : source.headers) {
+    if (EqualsIgnoreCase(header.first, "User-Agent")) {
+      mpv_set_option_string(mpv, "user-agent", header.second.c_str());
+    } else {
+      fields.push_back(header.first + ": " + header.second);
+    }
+  }
+  // A node list rather than the string form, which splits on commas
+  std::vector<mpv_node> values(fields.size());
+  for (size_t i = 0; i < fields.size(); ++i) {
+    values[i].format = MPV_FORMAT_STRING;
+    values[i].u.string = const_cast<char*>(fields[i].c_str());
+  }
+  mpv_node_list list{static_cast<int>(values.size()), values.data(), nullptr};
+  mpv_node node;
+  node.format = MPV_FORMAT_NODE_ARRAY;
+  node.u.list = &list;
+  mpv_set_option(mpv, "http-header-fields", MPV_FORMAT_NODE, &node);
+}
+
+// Format ScanAudio asks mpv for. A waveform doesn't need full bandwidth.
+constexpr int kScanSampleRate = 22050;
+constexpr int kScanChannels = 2;
+
+// Runs a video-less mpv instance that decodes |source| untimed through
+// ao=pcm into |fifo|, and hands what arrives there to |sink|.
+bool ScanThroughFifo(const MediaSource& source, const std::string& fifo, const AudioScanSink& sink,
+                     const std::atomic<bool>& cancel) {
+  // Opened before mpv so its blocking open for writing finds a reader
+  const int fd = open(fifo.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+  if (fd < 0) return false;
+  mpv_handle* mpv = mpv_create();
+  if (mpv == nullptr) {
+    close(fd);
+    return false;
+  }
+  mpv_set_option_string(mpv, "config", "no");
+  mpv_set_option_string(mpv, "terminal", "no");
+  mpv_set_option_string(mpv, "load-scripts", "no");
+  mpv_set_option_string(mpv, "ytdl", "no");
+  mpv_set_option_string(mpv, "vid", "no");
+  mpv_set_option_string(mpv, "sid", "no");
+  mpv_set_option_string(mpv, "untimed", "yes");
+  mpv_set_option_string(mpv, "ao", "pcm");
+  mpv_set_option_string(mpv, "ao-pcm-file", fifo.c_str());
+  mpv_set_option_string(mpv, "ao-pcm-waveheader", "no");
+  mpv_set_option_string(mpv, "audio-format", "float");
+  mpv_set_option_string(mpv, "audio-channels", "stereo");
+  mpv_set_option_string(mpv, "audio-samplerate", std::to_string(kScanSampleRate).c_str());
+  SetHeaderOptions(mpv, source);
+
+  bool failed = mpv_initialize(mpv) < 0;
+  if (!failed) {
+    const char* command[] = {"loadfile", source.uri.c_str(), nullptr};
+    failed = mpv_command(mpv, command) < 0;
+  }
+
+  std::vector<float> buffer(16384);
+  size_t buffered_bytes = 0;
+  int64_t frames_read = 0;
+  // Reads everything available; returns the last read() result.
+  auto drain = [&]() {
+    constexpr size_t kFrameBytes = sizeof(float) * kScanChannels;
+    char* bytes = reinterpret_cast<char*>(buffer.data());
+    while (true) {
+      const ssize_t n = read(fd, bytes + buffered_bytes, buffer.size() * sizeof(float) - buffered_bytes);
+      if (n <= 0) return n;
+      buffered_bytes += static_cast<size_t>(n);
+      const size_t frames = buffered_bytes / kFrameBytes;
+      if (frames > 0 && !cancel.load()) {
+        AudioSamples samples;
+        samples.data = buffer.data();
+        samples.frames = frames;
+        samples.channels = kScanChannels;
+        samples.sample_rate = kScanSampleRate;
+        samples.pts_ms = frames_read * 1000 / kScanSampleRate;
+        sink(samples);
+      }
+      frames_read += static_cast<int64_t>(frames);
+      buffered_bytes -= frames * kFrameBytes;
+      std::memmove(bytes, bytes + frames * kFrameBytes, buffered_bytes);
+    }
+  };
+
+  bool ended = failed;
+  while (!ended && !cancel.load()) {
+    pollfd descriptor{fd, POLLIN, 0};
+    poll(&descriptor, 1, 50);
+    drain();
+    for (mpv_event* event = mpv_wait_event(mpv, 0); event->event_id != MPV_EVENT_NONE;
+         event = mpv_wait_event(mpv, 0)) {
+      if (event->event_id == MPV_EVENT_END_FILE) {
+        const auto* end = static_cast<const mpv_event_end_file*>(event->data);
+        failed = end->reason == MPV_END_FILE_REASON_ERROR;
+        ended = true;
+      } else if (event->event_id == MPV_EVENT_SHUTDOWN) {
+        ended = true;
+      }
+    }
+  }
+
+  // The audio output may still be blocked writing into a full FIFO, so
+  // keep draining while mpv shuts down; EOF means every writer is gone.
+  std::atomic<bool> destroyed{false};
+  std::thread destroyer([&]() {
+    mpv_terminate_destroy(mpv);
+    destroyed = true;
+  });
+  while (true) {
+    const bool done = destroyed.load();
+    pollfd descriptor{fd, POLLIN, 0};
+    poll(&descriptor, 1, 20);
+    if (drain() <= 0 && done) break;
+  }
+  destroyer.join();
+  close(fd);
+  return !failed && !cancel.load();
+}
+
+bool HardwareDecodingEnabled() {
+  const char* hwdec = std::getenv("PVP_MPV_HWDEC");
+  return hwdec != nullptr && *hwdec != '\0' && std::strcmp(hwdec, "no") != 0;
+}
+
+#ifdef __linux__
+// Appends path, size and modification time of the loaded libmpv and
+// libavcodec, so an upgrade of either invalidates the cached decoders.
+int AppendLibraryIdentity(dl_phdr_info* info, size_t /*size*/, void* data) {
+  const char* path = info->dlpi_name;
+  if (path == nullptr || (std::strstr(path, "libmpv") == nullptr && std::strstr(path, "libavcodec") == nullptr)) {
+    return 0;
+  }
+  struct stat status;
+  if (stat(path, &status) != 0) return 0;
+  *static_cast<std::string*>(data) += std::string(" ") + path + ":" + std::to_string(status.st_size) + ":" +
+                                      std::to_string(static_cast<int64_t>(status.st_mtime));
+  return 0;
+}
+#endif
+
+// What an FFmpeg decoder name says about it: hardware wrappers carry the
+// API as a suffix, and the native "av1" decoder only works through a
+// hwaccel.
+bool IsHardwareDecoder(const std::string& name) {
+  static constexpr const char* kSuffixes[] = {"_v4l2m2m", "_cuvid",  "_qsv",        "_vaapi",
+                                              "_vdpau",   "_rkmpp",  "_mediacodec", "_nvdec"};
+  for (const char* suffix : kSuffixes) {
+    const size_t length = std::strlen(suffix);
+    if (name.size() > length && name.compare(name.size() - length, length, suffix) == 0) return true;
+  }
+  return name == "av1";
+}
+
+// libavcodec doesn't report profiles or levels per decoder; these are the
+// limits of FFmpeg's software decoders that have any.
+void ApplySoftwareLimits(DecoderInfo* decoder) {
+  if (decoder->name == "hevc") {
+    // Main, Main 10, Main Still Picture, range extensions; no SCC
+    decoder->profiles = {1, 2, 3, 4};
+    decoder->max_bit_depth = 12;
+  } else if (decoder->name == "vp9") {
+    decoder->profiles = {0, 1, 2, 3};
+  } else if (decoder->name == "h264") {
+    // Up to High 4:4:4 Predictive, 4:2:0 through 4:4:4
+    decoder->max_bit_depth = 14;
+  }
+}
+
+// Lists mpv's decoder-list on a bare instance. Hardware decoders only
+// count when PVP_MPV_HWDEC lets mpv use them.
+bool EnumerateMpvDecoders(std::vector<DecoderInfo>* decoders) {
+  PVP_TRACE_SCOPE("mpv", "EnumerateDecoders");
+  mpv_handle* mpv = mpv_create();
+  if (mpv == nullptr) return false;
+  mpv_set_option_string(mpv, "config", "no");
+  mpv_set_option_string(mpv, "terminal", "no");
+  mpv_set_option_string(mpv, "load-scripts", "no");
+  mpv_set_option_string(mpv, "vo", "null");
+  mpv_set_option_string(mpv, "ao", "null");
+  mpv_node list;
+  const bool listed = mpv_initialize(mpv) >= 0 && mpv_get_property(mpv, "decoder-list", MPV_FORMAT_NODE, &list) >= 0;
+  if (listed) {
+    const bool hardware_enabled = HardwareDecodingEnabled();
+    decoders->clear();
+    if (list.format == MPV_FORMAT_NODE_ARRAY) {
+      for (int i = 0; i < list.u.list->num; ++i) {
+        DecoderInfo decoder;
+        decoder.codec = MapString(list.u.list->values[i], "codec");
+        decoder.name = MapString(list.u.list->values[i], "driver");
+        if (decoder.codec.empty() || decoder.name.empty()) continue;
+        decoder.hardware = IsHardwareDecoder(decoder.name);
+        if (decoder.hardware && !hardware_enabled) continue;
+        if (!decoder.hardware) ApplySoftwareLimits(&decoder);
+        decoders->push_back(std::move(decoder));
+      }
+    }
+    mpv_free_node_contents(&list);
+  }
+  mpv_terminate_destroy(mpv);
+  return listed;
+}
+
+// The libmpv found at run time must speak the client API the backend was
+// built against; a different major version changed it incompatibly.
+bool InitializeMpv() {
+  PVP_TRACE_SCOPE("mpv", "Initialize");
+  // mpv refuses to create instances unless numbers are formatted the C
+  // way, and GTK has switched LC_NUMERIC to the user's locale by now. Set
+  // here, once and before any instance exists, not on every thread that
+  // creates one: setlocale races with anything reading the locale.
+  std::setlocale(LC_NUMERIC, "C");
+  return (mpv_client_api_version() >> 16) == (MPV_CLIENT_API_VERSION >> 16);
+}
+
+DecoderProbe MpvDecoderProbe() {
+  DecoderProbe probe;
+  probe.version = []() {
+    std::string version = "mpv-api " + std::to_string(mpv_client_api_version());
+#ifdef __linux__
+    dl_iterate_phdr(AppendLibraryIdentity, &version);
+#endif
+    const char* hwdec = std::getenv("PVP_MPV_HWDEC");
+    return version + " hwdec=" + (hwdec != nullptr ? hwdec : "");
+  };
+  probe.enumerate = EnumerateMpvDecoders;
+  return probe;
+}
+
+}  // namespace
+
+void RegisterMpvDecodeBackend(DecodeBackendRegistry* registry) {
+  registry->Register(
+      kMpvBackendName, []() { return std::make_unique<MpvDecodeBackend>(); },
+      kMpvBackendDisplayName, MpvDecoderProbe(), InitializeMpv);
+}
+
+MpvDecodeBackend::MpvDecodeBackend()
+    : pool_(FrameBufferPool::Create(FrameBufferPool::kDefaultMaxBuffers + kFramesHeldByPlayer)) {}
+
+MpvDecodeBackend::~MpvDecodeBackend() { Close(); }
+
+void MpvDecodeBackend::Open(const MediaSource& source, DecodeBackendListener* listener) {
+  PVP_TRACE_SCOPE("mpv", "Open");
+  listener_ = listener;
+
+  // LC_NUMERIC is "C" since InitializeMpv
+  mpv_ = mpv_create();
+  if (mpv_ == nullptr) {
+    Fail("mpv_create failed");
+    return;
+  }
+
+  const char* hwdec = std::getenv("PVP_MPV_HWDEC");
+  mpv_set_option_string(mpv_, "hwdec", hwdec != nullptr && *hwdec != '\0' ? hwdec : "no");
+  mpv_set_option_string(mpv_, "vo", "libmpv");
+  mpv_set_option_string(mpv_, "terminal", "no");
+  mpv_set_option_string(mpv_, "input-default-bindings", "no");
+  mpv_set_option_string(mpv_, "audio-client-name", "pro_video_player");
+  mpv_set_option_string(mpv_, "idle", "yes");
+  // Stay on the last frame at the end so the player can seek back
+  mpv_set_option_string(mpv_, "keep-open", "yes");
+  mpv_set_option_string(mpv_, "pause", "yes");
+  mpv_set_option_string(mpv_, "sub-auto", "no");
+  // Let the demuxer start on the preferred streams so the player doesn't
+  // have to switch (and refill the audio pipeline) right after prepare
+  if (!preferred_audio_language_.empty()) {
+    mpv_set_option_string(mpv_, "alang", preferred_audio_language_.c_str());
+  }
+  if (!preferred_subtitle_language_.empty()) {
+    mpv_set_option_string(mpv_, "slang", preferred_subtitle_language_.c_str());
+  }
+  // sub-text is still updated while hidden, which is how Flutter-rendered
+  // subtitles get their cues
+  mpv_set_option_string(mpv_, "sub-visibility", subtitle_cues_enabled_.load() ? "no" : "yes");
+  // mpv's own WSOLA stage (scaletempo2) keeps pitch on speed changes; pin
+  // it to the same range as TimeStretcher so every backend behaves alike
+  mpv_set_option_string(mpv_, "audio-pitch-correction", "yes");
+  std::string audio_filters = "scaletempo2=min-speed=0.25:max-speed=4";
+  if (audio_tap_enabled_) {
+    // Stats of each audio frame, exposed as af-metadata/<label>
+    audio_filters += std::string(",@") + kLevelsFilterLabel + ":lavfi=[astats=metadata=1:reset=1]";
+  }
+  mpv_set_option_string(mpv_, "af", audio_filters.c_str());
+  ApplyBufferLimits();
+
+  SetHeaderOptions(mpv_, source);
+
+  int result = mpv_initialize(mpv_);
+  if (result < 0) {
+    Fail(std::string("mpv_initialize failed: ") + mpv_error_string(result));
+    return;
+  }
+
+  mpv_render_param params[] = {
+      {MPV_RENDER_PARAM_API_TYPE, const_cast<char*>(MPV_RENDER_API_TYPE_SW)},
+      {MPV_RENDER_PARAM_INVALID, nullptr},
+  };
+  result = mpv_render_context_create(&render_, mpv_, params);
+  if (result < 0) {
+    render_ = nullptr;
+    Fail(std::string("mpv_render_context_create failed: ") + mpv_error_string(result));
+    return;
+  }
+  mpv_render_context_set_update_callback(render_, &MpvDecodeBackend::OnRenderUpdate, this);
+
+  mpv_observe_property(mpv_, kTimePos, "time-pos", MPV_FORMAT_NODE);
+  mpv_observe_property(mpv_, kPausedForCache, "paused-for-cache", MPV_FORMAT_NODE);
+  mpv_observe_property(mpv_, kDemuxerCacheTime, "demuxer-cache-time", MPV_FORMAT_NODE);
+  mpv_observe_property(mpv_, kEofReached, "eof-reached", MPV_FORMAT_NODE);
+  mpv_observe_property(mpv_, kTrackList, "track-list", MPV_FORMAT_NODE);
+  mpv_observe_property(mpv_, kVideoOutParams, "video-out-params", MPV_FORMAT_NODE);
+  mpv_observe_property(mpv_, kSubText, "sub-text", MPV_FORMAT_NODE);
+
+  event_thread_ = std::thread(&MpvDecodeBackend::RunEvents, this);
+  render_thread_ = std::thread(&MpvDecodeBackend::RunRender, this);
+
+  const char* command[] = {"loadfile", source.uri.c_str(), nullptr};
+  result = mpv_command(mpv_, command);
+  if (result < 0) Fail(std::string("loadfile failed: ") + mpv_error_string(result));
+}
+
+void MpvDecodeBackend::Fail(const std::string& message) {
+  if (listener_ != nullptr && !closing_.load()) listener_->OnError("PLAYBACK_ERROR", message);
+}
+
+void MpvDecodeBackend::Play() {
+  if (mpv_ == nullptr) return;
+  int pause = 0;
+  mpv_set_property(mpv_, "pause", MPV_FORMAT_FLAG, &pause);
+}
+
+void MpvDecodeBackend::Pause() {
+  if (mpv_ == nullptr) return;
+  int pause = 1;
+  mpv_set_property(mpv_, "pause", MPV_FORMAT_FLAG, &pause);
+}
+
+void MpvDecodeBackend::Seek(int64_t position_ms) {
+  if (mpv_ == nullptr) return;
+  char seconds[32];
+  std::snprintf(seconds, sizeof(seconds), "%.3f", static_cast<double>(position_ms) / 1000.0);
+  const char* command[] = {"seek", seconds, "absolute+exact", nullptr};
+  mpv_command_async(mpv_, 0, command);
+  position_ms_.store(position_ms, std::memory_order_relaxed);
+}
+
+void MpvDecodeBackend::SetRate(double rate) {
+  if (mpv_ == nullptr) return;
+  mpv_set_property(mpv_, "speed", MPV_FORMAT_DOUBLE, &rate);
+}
+
+void MpvDecodeBackend::SetVolume(double volume) {
+  if (mpv_ == nullptr) return;
+  double percent = volume * 100.0;
+  mpv_set_property(mpv_, "volume", MPV_FORMAT_DOUBLE, &percent);
+}
+
+void MpvDecodeBackend::SetPreferredLanguages(const std::string& audio, const std::string& subtitle) {
+  preferred_audio_language_ = audio;
+  preferred_subtitle_language_ = subtitle;
+}
+
+void MpvDecodeBackend::SetBufferLimits(const BufferLimits& limits) {
+  buffer_limits_ = limits;
+  has_buffer_limits_ = true;
+  ApplyBufferLimits();
+}
+
+// mpv has no low watermark or start threshold of its own: the demuxer
+// reads ahead continuously up to the caps, and after running dry
+// ("paused-for-cache") it waits for cache-pause-wait seconds. The caps
+// are runtime properties, so lowering the back buffer of an idle player
+// prunes it right away.
+void MpvDecodeBackend::ApplyBufferLimits() {
+  if (mpv_ == nullptr || !has_buffer_limits_) return;
+  double ahead = static_cast<double>(buffer_limits_.max_ms) / 1000.0;
+  double resume = static_cast<double>(buffer_limits_.resume_ms) / 1000.0;
+  mpv_set_option(mpv_, "cache-secs", MPV_FORMAT_DOUBLE, &ahead);
+  mpv_set_option(mpv_, "demuxer-readahead-secs", MPV_FORMAT_DOUBLE, &ahead);
+  mpv_set_option_string(mpv_, "demuxer-max-bytes", std::to_string(buffer_limits_.max_bytes).c_str());
+  mpv_set_option_string(mpv_, "demuxer-max-back-bytes", std::to_string(buffer_limits_.back_bytes).c_str());
+  mpv_set_option(mpv_, "cache-pause-wait", MPV_FORMAT_DOUBLE, &resume);
+}
+
+// "aid" picks another stream from the open demuxer; mpv reinitialises only
+// the audio decoder and keeps the playback position and demuxer cache
+void MpvDecodeBackend::SelectAudioTrack(const std::string& track_id) {
+  if (mpv_ == nullptr) return;
+  mpv_set_property_string(mpv_, "aid", track_id.empty() ? "no" : track_id.c_str());
+}
+
+void MpvDecodeBackend::SelectSubtitleTrack(const std::string& track_id) {
+  if (mpv_ == nullptr) return;
+  mpv_set_property_string(mpv_, "sid", track_id.empty() ? "no" : track_id.c_str());
+}
+
+void MpvDecodeBackend::SetSubtitleCuesEnabled(bool enabled) {
+  subtitle_cues_enabled_.store(enabled);
+  if (mpv_ == nullptr) return;
+  mpv_set_property_string(mpv_, "sub-visibility", enabled ? "no" : "yes");
+}
+
+void MpvDecodeBackend::SetVideoEnabled(bool enabled) {
+  if (mpv_ == nullptr) return;
+  // Deselecting the track stops video decoding altogether
+  mpv_set_property_string(mpv_, "vid", enabled ? "auto" : "no");
+}
+
+void MpvDecodeBackend::SetOutputSizeHint(int width, int height) {
+  hint_width_.store(width, std::memory_order_relaxed);
+  hint_height_.store(height, std::memory_order_relaxed);
+}
+
+bool MpvDecodeBackend::ScanAudio(const MediaSource& source, const AudioScanSink& sink,
+                                 const std::atomic<bool>& cancel) {
+  PVP_TRACE_SCOPE("mpv", "ScanAudio");
+  // libmpv has no PCM client API; a second instance writes raw samples
+  // into a private FIFO instead
+  char directory[] = "/tmp/pvp-mpv-scan-XXXXXX";
+  if (mkdtemp(directory) == nullptr) return false;
+  const std::string fifo = std::string(directory) + "/pcm";
+  bool scanned = false;
+  if (mkfifo(fifo.c_str(), 0600) == 0) {
+    scanned = ScanThroughFifo(source, fifo, sink, cancel);
+    unlink(fifo.c_str());
+  }
+  rmdir(directory);
+  return scanned;
+}
+
+bool MpvDecodeBackend::WarmUp() {
+  PVP_TRACE_SCOPE("mpv", "WarmUp");
+  // A second of lavfi test video and audio through a throwaway instance
+  // set up like a player's: loads libavformat, libavcodec, libavfilter
+  // and libswscale and runs the demuxer, decoder and filter chain once.
+  // mpv has no plugin registry to scan; the decoder list it does probe
+  // is kept on disk by CodecCapabilityCache.
+  mpv_handle* mpv = mpv_create();
+  if (mpv == nullptr) return false;
+  const char* hwdec = std::getenv("PVP_MPV_HWDEC");
+  mpv_set_option_string(mpv, "hwdec", hwdec != nullptr && *hwdec != '\0' ? hwdec : "no");
+  mpv_set_option_string(mpv, "config", "no");
+  mpv_set_option_string(mpv, "terminal", "no");
+  mpv_set_option_string(mpv, "load-scripts", "no");
+  mpv_set_option_string(mpv, "ytdl", "no");
+  mpv_set_option_string(mpv, "vo", "null");
+  mpv_set_option_string(mpv, "ao", "null");
+  mpv_set_option_string(mpv, "untimed", "yes");
+
+  bool warmed = mpv_initialize(mpv) >= 0;
+  if (warmed) {
+    const char* command[] = {"loadfile", "av://lavfi:testsrc2=size=320x180:duration=1[out0];sine=duration=1[out1]",
+                             nullptr};
+    warmed = mpv_command(mpv, command) >= 0;
+  }
+  // Bounded, in case the source never ends
+  constexpr double kTimeoutSeconds = 10.0;
+  const int64_t deadline_us = TraceRecorder::NowMicros() + static_cast<int64_t>(kTimeoutSeconds * 1e6);
+  bool ended = !warmed;
+  while (!ended) {
+    const int64_t remaining_us = deadline_us - TraceRecorder::NowMicros();
+    if (remaining_us <= 0) {
+      warmed = false;
+      break;
+    }
+    mpv_event* event = mpv_wait_event(mpv, static_cast<double>(remaining_us) / 1e6);
+    if (event->event_id == MPV_EVENT_END_FILE) {
+      const auto* end = static_cast<const mpv_event_end_file*>(event->data);
+      warmed = end->reason == MPV_END_FILE_REASON_EOF;
+      ended = true;
+    } else if (event->event_id == MPV_EVENT_SHUTDOWN) {
+      warmed = false;
+      ended = true;
+    }
+  }
+  mpv_terminate_destroy(mpv);
+  return warmed;
+}
+
+void MpvDecodeBackend::Close() {
+  {
+    std::lock_guard<std::mutex> lock(render_mutex_);
+    if (closing_.exchange(true)) return;
+  }
+  render_cv_.notify_all();
+  if (render_thread_.joinable()) render_thread_.join();
+  // The render context must go before the core
+  if (render_ != nullptr) {
+    mpv_render_context_free(render_);
+    render_ = nullptr;
+  }
+  if (mpv_ != nullptr) mpv_wakeup(mpv_);
+  if (event_thread_.joinable()) event_thread_.join();
+  if (mpv_ != nullptr) {
+    mpv_terminate_destroy(mpv_);
+    mpv_ = nullptr;
+  }
+  listener_ = nullptr;
+}
+
+void MpvDecodeBackend::RunEvents() {
+  TraceRecorder::Instance().SetCurrentThreadName("pvp-mpv-events");
+  auto next_levels = std::chrono::steady_clock::now();
+  while (!closing_.load()) {
+    double timeout = -1;
+    if (audio_tap_enabled_) {
+      // Polled on a deadline: time-pos alone changes every frame
+      const auto now = std::chrono::steady_clock::now();
+      if (now >= next_levels) {
+        ReportAudioLevels();
+        next_levels = now + kLevelsPollInterval;
+      }
+      timeout = std::chrono::duration<double>(next_levels - now).count();
+    }
+    mpv_event* event = mpv_wait_event(mpv_, timeout);
+    if (closing_.load() || event->event_id == MPV_EVENT_SHUTDOWN) break;
+
+    switch (event->event_id) {
+      case MPV_EVENT_FILE_LOADED:
+        HandleFileLoaded();
+        break;
+      case MPV_EVENT_END_FILE: {
+        const auto* end = static_cast<const mpv_event_end_file*>(event->data);
+        if (end->reason == MPV_END_FILE_REASON_ERROR) {
+          listener_->OnError("PLAYBACK_ERROR", mpv_error_string(end->error));
+        }
+        break;
+      }
+      case MPV_EVENT_PROPERTY_CHANGE: {
+        const auto* property = static_cast<const mpv_event_property*>(event->data);
+        mpv_node unavailable;
+        unavailable.format = MPV_FORMAT_NONE;
+        HandlePropertyChange(event->reply_userdata,
+                             property->format == MPV_FORMAT_NODE
+                                 ? *static_cast<const mpv_node*>(property->data)
+                                 : unavailable);
+        break;
+      }
+      default:
+        break;
+    }
+  }
+}
+
+void MpvDecodeBackend::HandleFileLoaded() {
+  if (prepared_) return;
+  PVP_TRACE_SCOPE("mpv", "FileLoaded");
+  MediaInfo info;
+
+  double duration = 0;
+  if (mpv_get_property(mpv_, "duration", MPV_FORMAT_DOUBLE, &duration) >= 0 && duration > 0) {
+    info.duration_ms = SecondsToMs(duration);
+  } else {
+    info.is_live = true;
+  }
+
+  mpv_node track_list;
+  if (mpv_get_property(mpv_, "track-list", MPV_FORMAT_NODE, &track_list) >= 0) {
+    ReadTracks(track_list);
+    mpv_free_node_contents(&track_list);
+  }
+  info.audio_tracks = audio_tracks_;
+  info.subtitle_tracks = subtitle_tracks_;
+  info.selected_audio_track_id = selected_audio_track_id_;
+  // The decoder isn't configured yet; the container knows the size
+  info.width = source_width_;
+  info.height = source_height_;
+
+  prepared_ = true;
+  listener_->OnPrepared(info);
+}
+
+bool MpvDecodeBackend::ReadTracks(const mpv_node& track_list) {
+  if (track_list.format != MPV_FORMAT_NODE_ARRAY) return false;
+  std::vector<AudioTrack> audio;
+  std::vector<SubtitleTrack> subtitles;
+  for (int i = 0; i < track_list.u.list->num; ++i) {
+    const mpv_node& track = track_list.u.list->values[i];
+    const std::string type = MapString(track, "type");
+    const std::string id = std::to_string(MapInt(track, "id"));
+    if (type == "audio") {
+      AudioTrack entry;
+      entry.id = id;
+      entry.label = MapString(track, "title");
+      entry.language = MapString(track, "lang");
+      entry.channel_count = static_cast<int>(MapInt(track, "demux-channel-count"));
+      entry.is_default = MapFlag(track, "default");
+      if (MapFlag(track, "selected")) selected_audio_track_id_ = id;
+      audio.push_back(std::move(entry));
+    } else if (type == "sub") {
+      SubtitleTrack entry;
+      entry.id = id;
+      entry.label = MapString(track, "title");
+      entry.language = MapString(track, "lang");
+      entry.is_default = MapFlag(track, "default");
+      subtitles.push_back(std::move(entry));
+    } else if (type == "video" && MapFlag(track, "selected")) {
+      source_width_ = static_cast<int>(MapInt(track, "demux-w"));
+      source_height_ = static_cast<int>(MapInt(track, "demux-h"));
+    }
+  }
+  if (audio == audio_tracks_ && subtitles == subtitle_tracks_) return false;
+  audio_tracks_ = std::move(audio);
+  subtitle_tracks_ = std::move(subtitles);
+  return true;
+}
+
+void MpvDecodeBackend::HandlePropertyChange(uint64_t property, const mpv_node& value) {
+  switch (property) {
+    case kTimePos:
+      if (value.format == MPV_FORMAT_DOUBLE) {
+        position_ms_.store(SecondsToMs(value.u.double_), std::memory_order_relaxed);
+      }
+      break;
+    case kPausedForCache: {
+      const bool buffering = value.format == MPV_FORMAT_FLAG && value.u.flag != 0;
+      if (prepared_ && buffering != buffering_) listener_->OnBufferingChanged(buffering);
+      buffering_ = buffering;
+      break;
+    }
+    case kDemuxerCacheTime:
+      if (prepared_ && value.format == MPV_FORMAT_DOUBLE) {
+        const int64_t buffered_ms = SecondsToMs(value.u.double_);
+        if (buffered_ms != buffered_ms_) listener_->OnBufferedPosition(buffered_ms);
+        buffered_ms_ = buffered_ms;
+      }
+      break;
+    case kEofReached: {
+      const bool eof = value.format == MPV_FORMAT_FLAG && value.u.flag != 0;
+      if (prepared_ && eof && !eof_) listener_->OnEndOfStream();
+      eof_ = eof;
+      break;
+    }
+    case kTrackList:
+      // Before FILE_LOADED the list is still being filled in
+      if (ReadTracks(value) && prepared_) listener_->OnTracksChanged(audio_tracks_, subtitle_tracks_);
+      break;
+    case kVideoOutParams: {
+      // Display size: aspect ratio and rotation applied
+      const int width = static_cast<int>(MapInt(value, "dw"));
+      const int height = static_cast<int>(MapInt(value, "dh"));
+      if (width <= 0 || height <= 0) break;
+      if (width == video_width_.load() && height == video_height_.load()) break;
+      video_width_.store(width);
+      video_height_.store(height);
+      if (prepared_) listener_->OnVideoSizeChanged(width, height);
+      break;
+    }
+    case kSubText:
+      if (prepared_ && subtitle_cues_enabled_.load()) ReportSubtitleCue(value);
+      break;
+    default:
+      break;
+  }
+}
+
+void MpvDecodeBackend::ReportSubtitleCue(const mpv_node& text) {
+  // mpv demuxes mov_text, SubRip/ASS in Matroska and WebVTT in HLS itself
+  // and publishes each event as it becomes current; the timing comes
+  // from sub-start/sub-end, which always describe the same event
+  if (text.format != MPV_FORMAT_STRING || text.u.string[0] == '\0') return;
+  double start = 0;
+  double end = 0;
+  int64_t sid = 0;
+  if (mpv_get_property(mpv_, "sub-start", MPV_FORMAT_DOUBLE, &start) < 0 ||
+      mpv_get_property(mpv_, "sub-end", MPV_FORMAT_DOUBLE, &end) < 0 ||
+      mpv_get_property(mpv_, "sid", MPV_FORMAT_INT64, &sid) < 0) {
+    return;
+  }
+  SubtitleCue cue;
+  cue.start_ms = SecondsToMs(start);
+  cue.end_ms = SecondsToMs(end);
+  cue.text = text.u.string;
+  listener_->OnSubtitleCue(std::to_string(sid), cue);
+}
+
+void MpvDecodeBackend::ReportAudioLevels() {
+  if (!prepared_) return;
+  const std::string property = std::string("af-metadata/") + kLevelsFilterLabel;
+  mpv_node metadata;
+  if (mpv_get_property(mpv_, property.c_str(), MPV_FORMAT_NODE, &metadata) < 0) return;
+  // Keys per channel, numbered from 1: lavfi.astats.1.Peak_level, ...
+  AudioLevels levels;
+  for (int channel = 1; channel <= kMaxMeteredChannels; ++channel) {
+    const std::string prefix = "lavfi.astats." + std::to_string(channel) + ".";
+    const std::string peak = MapString(metadata, (prefix + "Peak_level").c_str());
+    const std::string rms = MapString(metadata, (prefix + "RMS_level").c_str());
+    if (peak.empty() || rms.empty()) break;
+    levels.peak.push_back(DbToLinear(peak.c_str()));
+    levels.rms.push_back(DbToLinear(rms.c_str()));
+  }
+  mpv_free_node_contents(&metadata);
+  // Unchanged stats mean no audio went through (paused, seeking)
+  if (levels.peak.empty() || (levels.peak == last_levels_.peak && levels.rms == last_levels_.rms)) return;
+  last_levels_ = levels;
+  listener_->OnAudioLevels(levels);
+}
+
+void MpvDecodeBackend::OnRenderUpdate(void* context) {
+  // Called on an mpv thread; no mpv API calls allowed here
+  auto* self = static_cast<MpvDecodeBackend*>(context);
+  {
+    std::lock_guard<std::mutex> lock(self->render_mutex_);
+    self->render_pending_ = true;
+  }
+  self->render_cv_.notify_one();
+}
+
+void MpvDecodeBackend::RunRender() {
+  TraceRecorder::Instance().SetCurrentThreadName("pvp-mpv-render");
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(render_mutex_);
+      render_cv_.wait(lock, [this]() { return render_pending_ || closing_.load(); });
+      if (closing_.load()) return;
+      render_pending_ = false;
+    }
+    if ((mpv_render_context_update(render_) & MPV_RENDER_UPDATE_FRAME) != 0) RenderFrame();
+  }
+}
+
+void MpvDecodeBackend::RenderFrame() {
+  PVP_TRACE_SCOPE("mpv", "RenderFrame");
+  int width = video_width_.load();
+  int height = video_height_.load();
+  if (width <= 0 || height <= 0) {
+    SkipFrame();
+    return;
+  }
+
+  // Decide before anything is scaled or converted. The render API doesn't
+  // hand out the next frame's pts, only when it is due on screen: that is
+  // the frame's own timestamp, advancing with its pts at the playback
+  // rate. Redraws (paused, after a seek) have none.
+  mpv_render_frame_info info{};
+  const bool timed =
+      mpv_render_context_get_info(render_, {MPV_RENDER_PARAM_NEXT_FRAME_INFO, &info}) >= 0 &&
+      (info.flags & MPV_RENDER_FRAME_INFO_PRESENT) != 0 && (info.flags & MPV_RENDER_FRAME_INFO_REDRAW) == 0 &&
+      info.target_time > 0;
+  if (!render_gate_.ShouldRender(timed ? info.target_time : -1)) {
+    SkipFrame();
+    return;
+  }
+
+  // Render straight at the on-screen size; mpv's scaler is cheaper than
+  // uploading and sampling a full-size frame
+  const int hint_width = hint_width_.load(std::memory_order_relaxed);
+  const int hint_height = hint_height_.load(std::memory_order_relaxed);
+  if (hint_width > 0 && hint_height > 0 && (hint_width < width || hint_height < height)) {
+    const double scale = std::min(static_cast<double>(hint_width) / width,
+                                  static_cast<double>(hint_height) / height);
+    width = std::max(2, static_cast<int>(width * scale) & ~1);
+    height = std::max(2, static_cast<int>(height * scale) & ~1);
+  }
+
+  size_t stride = static_cast<size_t>(width) * 4;
+  stride = (stride + FrameBuffer::kAlignment - 1) / FrameBuffer::kAlignment * FrameBuffer::kAlignment;
+  std::shared_ptr<FrameBuffer> buffer = pool_->Acquire(stride * static_cast<size_t>(height));
+  if (buffer == nullptr) {
+    // Every buffer is still on its way to the screen
+    PVP_TRACE_INSTANT("mpv", "PoolExhausted", -1);
+    SkipFrame();
+    return;
+  }
+
+  int size[2] = {width, height};
+  mpv_render_param params[] = {
+      {MPV_RENDER_PARAM_SW_SIZE, size},
+      {MPV_RENDER_PARAM_SW_FORMAT, const_cast<char*>("rgb0")},
+      {MPV_RENDER_PARAM_SW_STRIDE, &stride},
+      {MPV_RENDER_PARAM_SW_POINTER, buffer->data()},
+      {MPV_RENDER_PARAM_INVALID, nullptr},
+  };
+  if (mpv_render_context_render(render_, params) < 0 || closing_.load()) return;
+
+  VideoFrame frame;
+  frame.width = width;
+  frame.height = height;
+  frame.stride = static_cast<int>(stride);
+  frame.format = PixelFormat::kRgbx;
+  frame.pts_ms = position_ms_.load(std::memory_order_relaxed);
+  frame.data = buffer->data();
+  frame.owner = std::move(buffer);
+  listener_->OnFrame(frame);
+}
+
+void MpvDecodeBackend::SkipFrame() {
+  // Lets mpv advance (and account the drop) without drawing
+  int skip = 1;
+  mpv_render_param params[] = {
+      {MPV_RENDER_PARAM_SKIP_RENDERING, &skip},
+      {MPV_RENDER_PARAM_INVALID, nullptr},
+  };
+  mpv_render_context_render(render_, params);
+}
+
+}  // namespace pro_video_player
@@ -0,0 +1,150 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_BACKENDS_MPV_DECODE_BACKEND_H_
+#define PRO_VIDEO_PLAYER_SHARED_BACKENDS_MPV_DECODE_BACKEND_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "decode_backend.h"
+#include "frame_buffer_pool.h"
+#include "frame_rate_gate.h"
+#include "player_types.h"
+
+struct mpv_handle;
+struct mpv_node;
+struct mpv_render_context;
+
+namespace pro_video_player {
+
+// Registry key ("nativeBackend: 'mpv'") and reported name.
+inline constexpr char kMpvBackendName[] = "mpv";
+inline constexpr char kMpvBackendDisplayName[] = "libmpv";
+
+// Adds the libmpv backend to |registry|. Only available when the core is
+// built with PVP_CORE_WITH_MPV.
+void RegisterMpvDecodeBackend(DecodeBackendRegistry* registry = &DecodeBackendRegistry::Instance());
+
+// DecodeBackend on libmpv's software render API.
+//
+// One mpv instance per player. Frames are rendered by mpv into pooled
+// CPU buffers (RGBx, 64-byte aligned stride) on a dedicated render thread
+// and handed to the player without copying, so it works on hosts without
+// a GPU. Hardware decoding is off unless PVP_MPV_HWDEC names an mpv
+// hwdec mode; only copy-back modes ("auto-copy") make sense here.
+//
+// Frames the render policy drops are skipped before mpv scales and
+// converts them. Subtitles selected through SelectSubtitleTrack are drawn
+// by mpv into the frame.
+//
+// ScanAudio (waveforms) runs a second, video-less mpv instance that
+// decodes untimed into a FIFO. libmpv offers no way to tap the playback
+// audio itself, so the audio tap meters inside mpv instead: an astats
+// filter in the af chain, polled every 50ms and reported through
+// OnAudioLevels.
+class MpvDecodeBackend : public DecodeBackend {
+ public:
+  MpvDecodeBackend();
+  ~MpvDecodeBackend() override;
+
+  MpvDecodeBackend(const MpvDecodeBackend&) = delete;
+  MpvDecodeBackend& operator=(const MpvDecodeBackend&) = delete;
+
+  std::string name() const override { return kMpvBackendDisplayName; }
+
+  void Open(const MediaSource& source, DecodeBackendListener* listener) override;
+  void Play() override;
+  void Pause() override;
+  void Seek(int64_t position_ms) override;
+  void SetRate(double rate) override;
+  void SetVolume(double volume) override;
+  void SetPreferredLanguages(const std::string& audio, const std::string& subtitle) override;
+  void SetAudioTapEnabled(bool enabled) override { audio_tap_enabled_ = enabled; }
+  void SetBufferLimits(const BufferLimits& limits) override;
+  size_t TrimMemory() override { return pool_->Trim(); }
+  void SelectAudioTrack(const std::string& track_id) override;
+  void SelectSubtitleTrack(const std::string& track_id) override;
+  void SetSubtitleCuesEnabled(bool enabled) override;
+  void SetVideoEnabled(bool enabled) override;
+  void SetOutputSizeHint(int width, int height) override;
+  void SetRenderPolicy(int64_t min_interval_us, bool visible) override {
+    render_gate_.SetPolicy(min_interval_us, visible);
+  }
+  int64_t QueryPositionMs() override { return position_ms_.load(std::memory_order_relaxed); }
+  bool ScanAudio(const MediaSource& source, const AudioScanSink& sink,
+                 const std::atomic<bool>& cancel) override;
+  bool WarmUp() override;
+  void Close() override;
+
+ private:
+  // Event thread.
+  void RunEvents();
+  void HandleFileLoaded();
+  void HandlePropertyChange(uint64_t property, const mpv_node& value);
+  bool ReadTracks(const mpv_node& track_list);
+  void ReportSubtitleCue(const mpv_node& text);
+  void ReportAudioLevels();
+
+  // Render thread.
+  static void OnRenderUpdate(void* context);
+  void RunRender();
+  void RenderFrame();
+  void SkipFrame();
+
+  void Fail(const std::string& message);
+  void ApplyBufferLimits();
+
+  mpv_handle* mpv_ = nullptr;
+  mpv_render_context* render_ = nullptr;
+  DecodeBackendListener* listener_ = nullptr;
+  std::shared_ptr<FrameBufferPool> pool_;
+
+  std::thread event_thread_;
+  std::thread render_thread_;
+  std::atomic<bool> closing_{false};
+
+  std::mutex render_mutex_;
+  std::condition_variable render_cv_;
+  bool render_pending_ = false;
+
+  // Written on the event thread, read by the render thread.
+  std::atomic<int64_t> position_ms_{0};
+  std::atomic<int> video_width_{0};
+  std::atomic<int> video_height_{0};
+  // Written on the player worker.
+  std::atomic<int> hint_width_{0};
+  std::atomic<int> hint_height_{0};
+  FrameRateGate render_gate_;
+
+  // Written on the player worker, read on the event thread.
+  std::atomic<bool> subtitle_cues_enabled_{false};
+
+  // Set on the player worker before Open().
+  std::string preferred_audio_language_;
+  std::string preferred_subtitle_language_;
+  bool audio_tap_enabled_ = false;
+
+  // Player worker only.
+  BufferLimits buffer_limits_;
+  bool has_buffer_limits_ = false;
+
+  // Event thread only.
+  bool prepared_ = false;
+  bool buffering_ = false;
+  bool eof_ = false;
+  int64_t buffered_ms_ = -1;
+  std::vector<AudioTrack> audio_tracks_;
+  std::vector<SubtitleTrack> subtitle_tracks_;
+  std::string selected_audio_track_id_;
+  int source_width_ = 0;
+  int source_height_ = 0;
+  AudioLevels last_levels_;
+};
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_BACKENDS_MPV_DECODE_BACKEND_H_
@@ -0,0 +1,183 @@
+// CPU cost of the pitch-preserving time-stretch stage.
+//
+// Stretches a synthetic speech-like signal (voiced harmonics with a
+// wandering pitch, plus noise) at a range of playback speeds, fed in 10 ms
+// chunks as an audio thread would, and reports the share of one core each
+// stream needs in real time. Driven by `make benchmark-time-stretch`.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "time_stretch.h"
+
+namespace pro_video_player_benchmark {
+
+namespace {
+
+using pro_video_player::TimeStretcher;
+
+constexpr double kPi = 3.14159265358979323846;
+
+struct Options {
+  int sample_rate = 48000;
+  int channels = 2;
+  double seconds = 30.0;
+  double budget_percent = 0.0;  // 0 = report only
+  bool json = false;
+};
+
+struct Result {
+  double rate = 1.0;
+  double output_seconds = 0.0;
+  double cpu_seconds = 0.0;
+  double core_percent() const { return output_seconds > 0 ? 100.0 * cpu_seconds / output_seconds : 0.0; }
+};
+
+void PrintUsage(const char* argv0) {
+  std::fprintf(stderr,
+               "Usage: %s [options]\n"
+               "  --seconds SEC      input length per rate (default 30)\n"
+               "  --sample-rate HZ   default 48000\n"
+               "  --channels N       default 2\n"
+               "  --budget PERCENT   exit 1 if any rate needs more of one core than this\n"
+               "  --json             machine-readable output\n",
+               argv0);
+}
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    auto next = [&](const char* name) -> const char* {
+      if (i + 1 >= argc) {
+        std::fprintf(stderr, "%s requires a value\n", name);
+        return nullptr;
+      }
+      return argv[++i];
+    };
+    const char* value = nullptr;
+    if (arg == "--seconds") {
+      if ((value = next("--seconds")) == nullptr) return false;
+      options->seconds = std::atof(value);
+    } else if (arg == "--sample-rate") {
+      if ((value = next("--sample-rate")) == nullptr) return false;
+      options->sample_rate = std::atoi(value);
+    } else if (arg == "--channels") {
+      if ((value = next("--channels")) == nullptr) return false;
+      options->channels = std::atoi(value);
+    } else if (arg == "--budget") {
+      if ((value = next("--budget")) == nullptr) return false;
+      options->budget_percent = std::atof(value);
+    } else if (arg == "--json") {
+      options->json = true;
+    } else {
+      PrintUsage(argv[0]);
+      return false;
+    }
+  }
+  if (options->seconds <= 0 || options->sample_rate <= 0 || options->channels <= 0) {
+    PrintUsage(argv[0]);
+    return false;
+  }
+  return true;
+}
+
+std::vector<float> SpeechLikeSignal(const Options& options) {
+  const size_t frames = static_cast<size_t>(options.seconds * options.sample_rate);
+  std::vector<float> samples(frames * options.channels);
+  std::mt19937 random(42);
+  std::normal_distribution<float> noise(0.0f, 0.02f);
+  double phase = 0.0;
+  for (size_t frame = 0; frame < frames; ++frame) {
+    const double t = static_cast<double>(frame) / options.sample_rate;
+    // 90-250 Hz pitch contour with 4 Hz syllable-rate envelope
+    const double pitch = 170.0 + 80.0 * std::sin(2 * kPi * 0.7 * t);
+    phase += 2 * kPi * pitch / options.sample_rate;
+    const double envelope = 0.5 + 0.5 * std::sin(2 * kPi * 4.0 * t);
+    double voiced = 0.0;
+    for (int harmonic = 1; harmonic <= 8; ++harmonic) voiced += std::sin(harmonic * phase) / harmonic;
+    const float value = static_cast<float>(0.3 * envelope * voiced);
+    for (int channel = 0; channel < options.channels; ++channel) {
+      samples[frame * options.channels + channel] = value + noise(random);
+    }
+  }
+  return samples;
+}
+
+Result Measure(const Options& options, const std::vector<float>& input, double rate) {
+  TimeStretcher stretcher(options.channels, options.sample_rate);
+  stretcher.SetRate(rate);
+  const size_t chunk = options.sample_rate / 100;
+  const size_t total = input.size() / options.channels;
+  std::vector<float> output(16 * chunk * options.channels);
+  size_t produced = 0;
+
+  const std::clock_t start = std::clock();
+  for (size_t frame = 0; frame < total; frame += chunk) {
+    const size_t frames = std::min(chunk, total - frame);
+    stretcher.Push(input.data() + frame * options.channels, frames);
+    while (size_t pulled = stretcher.Pull(output.data(), output.size() / options.channels)) {
+      produced += pulled;
+    }
+  }
+  const std::clock_t end = std::clock();
+
+  Result result;
+  result.rate = rate;
+  result.output_seconds = static_cast<double>(produced) / options.sample_rate;
+  result.cpu_seconds = static_cast<double>(end - start) / CLOCKS_PER_SEC;
+  return result;
+}
+
+int Run(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) return 2;
+#if !defined(__OPTIMIZE__) && !defined(_MSC_VER)
+  std::fprintf(stderr, "warning: built without optimisation; numbers are not representative\n");
+#endif
+
+  const auto input = SpeechLikeSignal(options);
+  std::vector<Result> results;
+  for (double rate : {0.25, 0.5, 0.75, 1.0, 1.25, 1.5, 1.75, 2.0, 2.5, 3.0, 4.0}) {
+    results.push_back(Measure(options, input, rate));
+  }
+
+  double worst = 0.0;
+  for (const auto& result : results) worst = std::max(worst, result.core_percent());
+
+  if (options.json) {
+    std::printf("{\n  \"sample_rate\": %d,\n  \"channels\": %d,\n  \"input_s\": %.1f,\n  \"rates\": [\n",
+                options.sample_rate, options.channels, options.seconds);
+    for (size_t i = 0; i < results.size(); ++i) {
+      const auto& r = results[i];
+      std::printf("    {\"rate\": %.2f, \"output_s\": %.2f, \"cpu_s\": %.4f, \"core_percent\": %.3f}%s\n",
+                  r.rate, r.output_seconds, r.cpu_seconds, r.core_percent(), i + 1 < results.size() ? "," : "");
+    }
+    std::printf("  ],\n  \"worst_core_percent\": %.3f\n}\n", worst);
+  } else {
+    std::printf("\n%6s %10s %10s %8s\n", "rate", "output_s", "cpu_ms", "core%");
+    for (const auto& r : results) {
+      std::printf("%6.2f %10.1f %10.1f %8.3f\n", r.rate, r.output_seconds, r.cpu_seconds * 1000.0,
+                  r.core_percent());
+    }
+    std::printf("\n%d Hz x %d ch, worst %.3f%% of one core per stream\n", options.sample_rate,
+                options.channels, worst);
+  }
+
+  if (options.budget_percent > 0 && worst > options.budget_percent) {
+    std::fprintf(stderr, "over budget: %.3f%% > %.3f%%\n", worst, options.budget_percent);
+    return 1;
+  }
+  return 0;
+}
+
+}  // namespace
+
+}  // namespace pro_video_player_benchmark
+
+int main(int argc, char** argv) { return pro_video_player_benchmark::Run(argc, argv); }
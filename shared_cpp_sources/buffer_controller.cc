@@ -0,0 +1,112 @@
+#include "buffer_controller.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace pro_video_player {
+
+namespace {
+
+constexpr int64_t kMiB = 1024 * 1024;
+constexpr double kGrowth = 1.5;
+constexpr double kShrink = 0.5;
+
+int64_t Scaled(int64_t value, double scale) {
+  return static_cast<int64_t>(std::llround(static_cast<double>(value) * scale));
+}
+
+}  // namespace
+
+BufferLimits BufferLimitsForTier(BufferingTier tier) {
+  BufferLimits limits;
+  switch (tier) {
+    case BufferingTier::kMin:
+      limits = {1000, 2000, 500, 1000, 8 * kMiB, 0};
+      break;
+    case BufferingTier::kLow:
+      limits = {2000, 5000, 1000, 2000, 16 * kMiB, 2 * kMiB};
+      break;
+    case BufferingTier::kMedium:
+      limits = {5000, 15000, 2500, 5000, 32 * kMiB, 8 * kMiB};
+      break;
+    case BufferingTier::kHigh:
+      limits = {5000, 30000, 2500, 5000, 64 * kMiB, 16 * kMiB};
+      break;
+    case BufferingTier::kMax:
+      limits = {10000, 60000, 5000, 10000, 150 * kMiB, 50 * kMiB};
+      break;
+  }
+  return limits;
+}
+
+BufferLimits LowLatencyBufferLimits(int64_t target_latency_ms) {
+  BufferLimits limits = BufferLimitsForTier(BufferingTier::kMin);
+  limits.max_ms = std::max(limits.max_ms, 2 * target_latency_ms);
+  return limits;
+}
+
+BufferController::BufferController(BufferingTier tier, bool dynamic)
+    : BufferController(BufferLimitsForTier(tier), dynamic) {}
+
+BufferController::BufferController(const BufferLimits& base, bool dynamic)
+    : base_(base),
+      dynamic_(dynamic),
+      min_scale_(static_cast<double>(BufferLimitsForTier(BufferingTier::kMin).max_ms) / base_.max_ms),
+      max_scale_(static_cast<double>(BufferLimitsForTier(BufferingTier::kMax).max_ms) / base_.max_ms) {
+  Update();
+}
+
+BufferController::Transition BufferController::OnStallChanged(bool stalled, int64_t buffered_ahead_ms,
+                                                              bool at_end, bool playing) {
+  if (stalled == buffering_) return Transition::kNone;
+  if (!stalled) {
+    buffering_ = false;
+    seeking_ = false;
+    return Transition::kEnded;
+  }
+  const bool underrun = !at_end && (buffered_ahead_ms < 0 || buffered_ahead_ms < limits_.resume_ms);
+  if (!underrun) return Transition::kNone;
+  buffering_ = true;
+  if (playing && !seeking_) {
+    ++rebuffer_count_;
+    if (dynamic_) {
+      scale_ = std::min(scale_ * kGrowth, max_scale_);
+      Update();
+    }
+  }
+  return Transition::kStarted;
+}
+
+void BufferController::OnSeek() { seeking_ = true; }
+
+void BufferController::SetIdle(bool idle) {
+  if (idle == idle_) return;
+  idle_ = idle;
+  Update();
+}
+
+void BufferController::OnMemoryPressure() {
+  scale_ = std::max(scale_ * kShrink, min_scale_);
+  Update();
+}
+
+void BufferController::OnMemoryRelief() {
+  if (dynamic_ || scale_ == 1.0) return;
+  scale_ = 1.0;
+  Update();
+}
+
+void BufferController::Update() {
+  limits_ = base_;
+  if (scale_ != 1.0) {
+    limits_.min_ms = Scaled(base_.min_ms, scale_);
+    limits_.max_ms = Scaled(base_.max_ms, scale_);
+    limits_.resume_ms = Scaled(base_.resume_ms, scale_);
+    limits_.max_bytes = Scaled(base_.max_bytes, scale_);
+    // Seeking back is the first thing to give up, never to grow
+    limits_.back_bytes = Scaled(base_.back_bytes, std::min(scale_, 1.0));
+  }
+  if (idle_) limits_.back_bytes = 0;
+}
+
+}  // namespace pro_video_player
@@ -0,0 +1,87 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_BUFFER_CONTROLLER_H_
+#define PRO_VIDEO_PLAYER_SHARED_BUFFER_CONTROLLER_H_
+
+#include <cstdint>
+
+#include "player_types.h"
+
+namespace pro_video_player {
+
+// Watermarks for |tier|. The times are the ones the Android plugin gives
+// ExoPlayer (BufferingConfig.kt), so a tier buffers alike everywhere; the
+// byte caps keep a high-bitrate stream from holding minutes of video.
+BufferLimits BufferLimitsForTier(BufferingTier tier);
+
+// Watermarks for live low-latency playback (PlayerOptions::
+// target_live_latency_ms): the kMin tier, except that read-ahead may go up
+// to twice the target. A live stream can't buffer further ahead than its
+// live edge anyway, and a backend that stopped reading short of the edge
+// would under-report the latency.
+BufferLimits LowLatencyBufferLimits(int64_t target_latency_ms);
+
+// Decides buffering for one player on top of its backend.
+//
+// Buffering starts only when the backend stalls with less than
+// |resume_ms| buffered ahead; stalls with a healthy buffer (decoder
+// restarts after a seek or track switch) are not underruns and produce no
+// events. Buffering ends when the backend resumes, which backends do once
+// |resume_ms| is buffered again.
+//
+// In dynamic mode each rebuffer during playback grows the time and byte
+// watermarks by half, up to the kMax tier. In any mode memory pressure
+// halves them, down to the kMin tier; once it is over a fixed tier
+// returns to its own watermarks, while dynamic mode grows back on the
+// next rebuffers. Idle players (not playing) keep no back buffer, since it
+// is most of what a paused stream holds on to.
+//
+// Not thread-safe; the player drives it from its worker.
+class BufferController {
+ public:
+  enum class Transition {
+    kNone,
+    kStarted,
+    kEnded,
+  };
+
+  BufferController() : BufferController(BufferingTier::kMedium, false) {}
+  BufferController(BufferingTier tier, bool dynamic);
+  BufferController(const BufferLimits& base, bool dynamic);
+
+  // What the backend should apply now.
+  const BufferLimits& limits() const { return limits_; }
+  bool buffering() const { return buffering_; }
+  int rebuffer_count() const { return rebuffer_count_; }
+
+  // The backend's stall flag changed. |buffered_ahead_ms| is buffered
+  // past the playhead, -1 if unknown; |at_end| if the buffer reaches the
+  // end of the stream. |playing| tells rebuffers from initial loading.
+  Transition OnStallChanged(bool stalled, int64_t buffered_ahead_ms, bool at_end, bool playing);
+
+  // The next stall refills after a jump; reported, but not counted as a
+  // rebuffer.
+  void OnSeek();
+
+  void SetIdle(bool idle);
+
+  void OnMemoryPressure();
+  void OnMemoryRelief();
+
+ private:
+  void Update();
+
+  BufferLimits base_;
+  bool dynamic_;
+  // Bounds of |scale_|: the kMin and kMax tiers.
+  double min_scale_;
+  double max_scale_;
+  double scale_ = 1.0;
+  bool idle_ = false;
+  bool buffering_ = false;
+  bool seeking_ = false;
+  int rebuffer_count_ = 0;
+  BufferLimits limits_;
+};
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_BUFFER_CONTROLLER_H_
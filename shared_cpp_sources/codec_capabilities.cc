@@ -0,0 +1,352 @@
+#include "codec_capabilities.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#ifndef PVP_CORE_VERSION
+#define PVP_CORE_VERSION "dev"
+#endif
+
+namespace pro_video_player {
+
+namespace {
+
+// First line of a cache file, before the core and library versions.
+constexpr char kCacheFormat[] = "pvp-codecs 1";
+
+struct PlainName {
+  const char* name;
+  const char* codec;
+};
+
+// Plain names and bare sample entry types, matched without case.
+constexpr PlainName kPlainNames[] = {
+    {"h264", "h264"},   {"h.264", "h264"},       {"avc", "h264"},      {"avc1", "h264"},  {"avc3", "h264"},
+    {"hevc", "hevc"},   {"h265", "hevc"},        {"h.265", "hevc"},    {"hvc1", "hevc"},  {"hev1", "hevc"},
+    {"av1", "av1"},     {"av01", "av1"},         {"vp9", "vp9"},       {"vp09", "vp9"},   {"vp8", "vp8"},
+    {"vp08", "vp8"},    {"mpeg2", "mpeg2video"}, {"aac", "aac"},       {"mp4a", "aac"},   {"opus", "opus"},
+    {"flac", "flac"},   {"mp3", "mp3"},          {"vorbis", "vorbis"}, {"ac-3", "ac3"},   {"ac3", "ac3"},
+    {"ec-3", "eac3"},   {"eac3", "eac3"},        {"alac", "alac"},
+};
+
+bool EqualsIgnoreCase(std::string_view a, std::string_view b) {
+  if (a.size() != b.size()) return false;
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ParseInt(std::string_view text, int base, int* value) {
+  if (text.empty() || text.size() > 6) return false;
+  int result = 0;
+  for (const char c : text) {
+    int digit;
+    if (c >= '0' && c <= '9') {
+      digit = c - '0';
+    } else if (base == 16 && c >= 'a' && c <= 'f') {
+      digit = c - 'a' + 10;
+    } else if (base == 16 && c >= 'A' && c <= 'F') {
+      digit = c - 'A' + 10;
+    } else {
+      return false;
+    }
+    result = result * base + digit;
+  }
+  *value = result;
+  return true;
+}
+
+// Splits |text| at dots into at most |max| fields; returns how many.
+size_t SplitFields(std::string_view text, std::string_view* fields, size_t max) {
+  size_t count = 0;
+  while (count < max) {
+    const size_t dot = text.find('.');
+    fields[count++] = text.substr(0, dot);
+    if (dot == std::string_view::npos) break;
+    text.remove_prefix(dot + 1);
+  }
+  return count;
+}
+
+// "avc1.PPCCLL": profile_idc, constraint flags, level_idc in hex.
+bool ParseAvc(const std::string_view* fields, size_t count, CodecString* out) {
+  if (count < 2 || fields[1].size() != 6) return false;
+  out->codec = "h264";
+  if (!ParseInt(fields[1].substr(0, 2), 16, &out->profile) || !ParseInt(fields[1].substr(4, 2), 16, &out->level)) {
+    return false;
+  }
+  // High 10 and High 4:2:2 take 10 bits, High 4:4:4 Predictive 14
+  if (out->profile == 110 || out->profile == 122) out->bit_depth = 10;
+  if (out->profile == 244) out->bit_depth = 14;
+  return true;
+}
+
+// "hvc1.[A-C]P.compat.(L|H)level[.constraints]".
+bool ParseHevc(const std::string_view* fields, size_t count, CodecString* out) {
+  if (count < 4) return false;
+  std::string_view profile = fields[1];
+  if (!profile.empty() && profile[0] >= 'A' && profile[0] <= 'C') profile.remove_prefix(1);
+  const std::string_view level = fields[3];
+  if (level.empty() || (level[0] != 'L' && level[0] != 'H')) return false;
+  out->codec = "hevc";
+  if (!ParseInt(profile, 10, &out->profile) || !ParseInt(level.substr(1), 10, &out->level)) return false;
+  if (out->profile == 2) out->bit_depth = 10;
+  return true;
+}
+
+// "av01.P.LLT.DD[...]": seq_profile, seq_level_idx and tier, bit depth.
+bool ParseAv1(const std::string_view* fields, size_t count, CodecString* out) {
+  if (count < 4 || fields[2].size() != 3) return false;
+  out->codec = "av1";
+  return ParseInt(fields[1], 10, &out->profile) && ParseInt(fields[2].substr(0, 2), 10, &out->level) &&
+         ParseInt(fields[3], 10, &out->bit_depth);
+}
+
+// "vp09.PP.LL.DD[...]".
+bool ParseVp9(const std::string_view* fields, size_t count, CodecString* out) {
+  if (count < 4) return false;
+  out->codec = "vp9";
+  return ParseInt(fields[1], 10, &out->profile) && ParseInt(fields[2], 10, &out->level) &&
+         ParseInt(fields[3], 10, &out->bit_depth);
+}
+
+// "mp4a.OT[.AOT]": MPEG-4 object type in hex, then the audio object type.
+bool ParseMp4a(const std::string_view* fields, size_t count, CodecString* out) {
+  int object_type = 0;
+  if (count < 2 || !ParseInt(fields[1], 16, &object_type)) return false;
+  int audio_object_type = 0;
+  if (count > 2 && !ParseInt(fields[2], 10, &audio_object_type)) return false;
+  switch (object_type) {
+    case 0x40:
+      // Audio object type 34 is layer 3
+      out->codec = audio_object_type == 34 ? "mp3" : "aac";
+      out->profile = count > 2 ? audio_object_type : -1;
+      return true;
+    case 0x66:
+    case 0x67:
+    case 0x68:
+      out->codec = "aac";
+      return true;
+    case 0x69:
+    case 0x6B:
+      out->codec = "mp3";
+      return true;
+    case 0xA5:
+      out->codec = "ac3";
+      return true;
+    case 0xA6:
+      out->codec = "eac3";
+      return true;
+    case 0xAD:
+      out->codec = "opus";
+      return true;
+    default:
+      return false;
+  }
+}
+
+std::string DefaultDirectory() {
+  const char* xdg = std::getenv("XDG_CACHE_HOME");
+  std::string base;
+  if (xdg != nullptr && *xdg != '\0') {
+    base = xdg;
+  } else if (const char* home = std::getenv("HOME"); home != nullptr && *home != '\0') {
+    base = std::string(home) + "/.cache";
+  } else {
+    return std::string();
+  }
+  return base + "/pro_video_player/codecs";
+}
+
+// What a cache file must start with to be used: the format, the core and
+// the backend's libraries.
+std::string CacheKey(const DecoderProbe& probe) {
+  std::string key = std::string(kCacheFormat) + " " + PVP_CORE_VERSION + " " + (probe.version ? probe.version() : "");
+  std::replace(key.begin(), key.end(), '\n', ' ');
+  return key;
+}
+
+}  // namespace
+
+bool ParseCodecString(std::string_view text, CodecString* out) {
+  while (!text.empty() && text.front() == ' ') text.remove_prefix(1);
+  while (!text.empty() && text.back() == ' ') text.remove_suffix(1);
+  *out = CodecString();
+  for (const auto& plain : kPlainNames) {
+    if (EqualsIgnoreCase(text, plain.name)) {
+      out->codec = plain.codec;
+      return true;
+    }
+  }
+  std::string_view fields[6];
+  const size_t count = SplitFields(text, fields, 6);
+  const std::string_view type = fields[0];
+  bool parsed = false;
+  if (type == "avc1" || type == "avc3") {
+    parsed = ParseAvc(fields, count, out);
+  } else if (type == "hvc1" || type == "hev1") {
+    parsed = ParseHevc(fields, count, out);
+  } else if (type == "av01") {
+    parsed = ParseAv1(fields, count, out);
+  } else if (type == "vp09") {
+    parsed = ParseVp9(fields, count, out);
+  } else if (type == "mp4a") {
+    parsed = ParseMp4a(fields, count, out);
+  }
+  if (!parsed) *out = CodecString();
+  return parsed;
+}
+
+// ==================== CodecCapabilities ====================
+
+CodecCapabilities::CodecCapabilities(std::vector<DecoderInfo> decoders) : decoders_(std::move(decoders)) {}
+
+CodecCheck CodecCapabilities::Check(std::string_view codec) const {
+  CodecString parsed;
+  if (!ParseCodecString(codec, &parsed)) return {CodecSupport::kUnknown, "Unknown codec " + std::string(codec)};
+  // The reason of the last decoder ruled out
+  std::string reason = "No decoder for " + parsed.codec;
+  for (const auto& decoder : decoders_) {
+    if (decoder.codec != parsed.codec) continue;
+    if (parsed.profile >= 0 && !decoder.profiles.empty() &&
+        std::find(decoder.profiles.begin(), decoder.profiles.end(), parsed.profile) == decoder.profiles.end()) {
+      reason = decoder.name + " can't decode " + parsed.codec + " profile " + std::to_string(parsed.profile);
+      continue;
+    }
+    if (parsed.level > 0 && decoder.max_level > 0 && parsed.level > decoder.max_level) {
+      reason = decoder.name + " can't decode " + parsed.codec + " level " + std::to_string(parsed.level);
+      continue;
+    }
+    if (parsed.bit_depth > 0 && decoder.max_bit_depth > 0 && parsed.bit_depth > decoder.max_bit_depth) {
+      reason = decoder.name + " can't decode " + std::to_string(parsed.bit_depth) + "-bit " + parsed.codec;
+      continue;
+    }
+    return {CodecSupport::kSupported, std::string()};
+  }
+  return {CodecSupport::kUnsupported, reason};
+}
+
+CodecCheck CodecCapabilities::CanPlay(const VideoMetadata& metadata) const {
+  CodecCheck result{CodecSupport::kSupported, std::string()};
+  for (const std::string* codec : {&metadata.video_codec, &metadata.audio_codec}) {
+    if (codec->empty()) continue;
+    CodecCheck check = Check(*codec);
+    if (check.support == CodecSupport::kUnsupported) return check;
+    if (check.support == CodecSupport::kUnknown && result.support == CodecSupport::kSupported) {
+      result = std::move(check);
+    }
+  }
+  return result;
+}
+
+std::string CodecCapabilities::Serialize() const {
+  std::ostringstream out;
+  for (const auto& decoder : decoders_) {
+    out << decoder.codec << '\t' << decoder.name << '\t' << (decoder.hardware ? 1 : 0) << '\t';
+    for (size_t i = 0; i < decoder.profiles.size(); ++i) out << (i > 0 ? "," : "") << decoder.profiles[i];
+    out << '\t' << decoder.max_level << '\t' << decoder.max_bit_depth << '\n';
+  }
+  return out.str();
+}
+
+bool CodecCapabilities::Parse(const std::string& text, std::vector<DecoderInfo>* decoders) {
+  std::istringstream in(text);
+  std::string line;
+  std::vector<DecoderInfo> result;
+  while (std::getline(in, line)) {
+    if (line.empty()) continue;
+    std::istringstream fields(line);
+    DecoderInfo decoder;
+    std::string hardware;
+    std::string profiles;
+    std::string max_level;
+    std::string max_bit_depth;
+    if (!std::getline(fields, decoder.codec, '\t') || !std::getline(fields, decoder.name, '\t') ||
+        !std::getline(fields, hardware, '\t') || !std::getline(fields, profiles, '\t') ||
+        !std::getline(fields, max_level, '\t') || !std::getline(fields, max_bit_depth, '\t') ||
+        (hardware != "0" && hardware != "1") || !ParseInt(max_level, 10, &decoder.max_level) ||
+        !ParseInt(max_bit_depth, 10, &decoder.max_bit_depth)) {
+      return false;
+    }
+    decoder.hardware = hardware == "1";
+    std::istringstream list(profiles);
+    std::string profile;
+    while (std::getline(list, profile, ',')) {
+      int value = 0;
+      if (!ParseInt(profile, 10, &value)) return false;
+      decoder.profiles.push_back(value);
+    }
+    result.push_back(std::move(decoder));
+  }
+  *decoders = std::move(result);
+  return true;
+}
+
+// ==================== CodecCapabilityCache ====================
+
+CodecCapabilityCache& CodecCapabilityCache::Instance() {
+  static CodecCapabilityCache* instance = new CodecCapabilityCache(DefaultDirectory());
+  return *instance;
+}
+
+std::shared_ptr<const CodecCapabilities> CodecCapabilityCache::Get(const std::string& backend,
+                                                                   const DecoderProbe& probe) {
+  // Held through a probe, so concurrent first calls probe once
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto loaded = loaded_.find(backend);
+  if (loaded != loaded_.end()) return loaded->second;
+  if (!probe.enumerate) return nullptr;
+
+  const std::string key = CacheKey(probe);
+  const std::string path = PathFor(backend);
+  std::vector<DecoderInfo> decoders;
+  bool cached = false;
+  if (!path.empty()) {
+    std::ifstream file(path, std::ios::binary);
+    std::string first_line;
+    if (file && std::getline(file, first_line) && first_line == key) {
+      std::ostringstream rest;
+      rest << file.rdbuf();
+      cached = CodecCapabilities::Parse(rest.str(), &decoders);
+    }
+  }
+  if (!cached && !probe.enumerate(&decoders)) return nullptr;
+  auto capabilities = std::make_shared<const CodecCapabilities>(std::move(decoders));
+
+  if (!cached && !path.empty()) {
+    // Best effort, atomically: a failed write just means probing again
+    std::error_code error;
+    std::filesystem::create_directories(directory_, error);
+    const std::string temp = path + ".tmp";
+    {
+      std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+      file << key << '\n' << capabilities->Serialize();
+    }
+    std::filesystem::rename(temp, path, error);
+    if (error) std::filesystem::remove(temp, error);
+  }
+  loaded_[backend] = capabilities;
+  return capabilities;
+}
+
+void CodecCapabilityCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  loaded_.clear();
+}
+
+std::string CodecCapabilityCache::PathFor(const std::string& backend) const {
+  if (directory_.empty() || backend.empty()) return std::string();
+  for (const char c : backend) {
+    if (!std::isalnum(static_cast<unsigned char>(c)) && c != '-' && c != '_') return std::string();
+  }
+  return directory_ + "/" + backend + ".tsv";
+}
+
+}  // namespace pro_video_player
@@ -0,0 +1,129 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_CODEC_CAPABILITIES_H_
+#define PRO_VIDEO_PLAYER_SHARED_CODEC_CAPABILITIES_H_
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "player_types.h"
+
+namespace pro_video_player {
+
+// A codec string taken apart: RFC 6381 ("avc1.640028", "hvc1.2.4.L120.B0",
+// "av01.0.08M.10", "vp09.02.10.10", "mp4a.40.2") or a plain name ("hevc",
+// "H.264", "opus"). -1 and 0 mean not stated.
+struct CodecString {
+  // FFmpeg codec name: "h264", "hevc", "av1", "vp9", "aac", ...
+  std::string codec;
+  // As the codec string numbers them: H.264 profile_idc, HEVC
+  // general_profile_idc, AV1 seq_profile, VP9 profile.
+  int profile = -1;
+  // H.264 level_idc, HEVC general_level_idc (30 x level), AV1
+  // seq_level_idx, VP9 level (10 x level).
+  int level = -1;
+  int bit_depth = 0;
+};
+
+// False for strings it doesn't know.
+bool ParseCodecString(std::string_view text, CodecString* out);
+
+// One decoder a backend can use. Empty and 0 mean no limit.
+struct DecoderInfo {
+  std::string codec;
+  // Decoder name ("libdav1d", "hevc", "h264_v4l2m2m").
+  std::string name;
+  bool hardware = false;
+  std::vector<int> profiles;
+  int max_level = 0;
+  int max_bit_depth = 0;
+
+  bool operator==(const DecoderInfo& other) const {
+    return codec == other.codec && name == other.name && hardware == other.hardware &&
+           profiles == other.profiles && max_level == other.max_level && max_bit_depth == other.max_bit_depth;
+  }
+};
+
+// How a backend lists its decoders.
+struct DecoderProbe {
+  // Cheap, no decoder loading: identifies the libraries (versions, file
+  // sizes and times). A different value invalidates the cached list.
+  std::function<std::string()> version;
+  // Expensive: the decoders the backend would actually use, in its
+  // current configuration. False if they can't be listed.
+  std::function<bool(std::vector<DecoderInfo>* decoders)> enumerate;
+};
+
+enum class CodecSupport {
+  kSupported,
+  kUnsupported,
+  // A codec string that isn't understood, or no decoder list.
+  kUnknown,
+};
+
+struct CodecCheck {
+  CodecSupport support = CodecSupport::kUnknown;
+  // Why not, for kUnsupported and kUnknown: "No decoder for av1".
+  std::string reason;
+};
+
+// Decoder matrix of one backend. Immutable, so CanPlay() needs no locking;
+// it parses the codec strings and walks a handful of decoders, without
+// touching the disk or the decoders.
+class CodecCapabilities {
+ public:
+  explicit CodecCapabilities(std::vector<DecoderInfo> decoders);
+
+  const std::vector<DecoderInfo>& decoders() const { return decoders_; }
+
+  // Whether |codec| has a decoder that takes its profile, level and bit
+  // depth. kUnknown for codec strings it can't parse.
+  CodecCheck Check(std::string_view codec) const;
+
+  // Both streams of |metadata| (absent ones pass): unsupported if either
+  // is, else unknown if either is.
+  CodecCheck CanPlay(const VideoMetadata& metadata) const;
+
+  // One decoder per line, for the disk cache.
+  std::string Serialize() const;
+  static bool Parse(const std::string& text, std::vector<DecoderInfo>* decoders);
+
+ private:
+  std::vector<DecoderInfo> decoders_;
+};
+
+// Decoder lists per backend, probed once per library version: in memory
+// for the process, on disk across runs, keyed by the core's version and
+// DecoderProbe::version(). Thread-safe.
+class CodecCapabilityCache {
+ public:
+  // Uses $XDG_CACHE_HOME/pro_video_player/codecs (or ~/.cache/...).
+  static CodecCapabilityCache& Instance();
+
+  // Empty |directory| keeps lists in memory only.
+  explicit CodecCapabilityCache(std::string directory) : directory_(std::move(directory)) {}
+
+  // The list of |backend|: from memory, else from disk if the versions
+  // match, else from |probe| (written back to disk). The first call per
+  // backend may take a while; later ones are a map lookup. Null if the
+  // probe fails or there is none.
+  std::shared_ptr<const CodecCapabilities> Get(const std::string& backend, const DecoderProbe& probe);
+
+  // Drops what is in memory, e.g. after a backend setting changed.
+  void Clear();
+
+ private:
+  std::string PathFor(const std::string& backend) const;
+
+  mutable std::mutex mutex_;
+  const std::string directory_;
+  std::map<std::string, std::shared_ptr<const CodecCapabilities>> loaded_;
+};
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_CODEC_CAPABILITIES_H_
@@ -0,0 +1,174 @@
+#include "command_queue.h"
+
+#include <array>
+#include <cstddef>
+
+#include "trace_recorder.h"
+
+namespace pro_video_player {
+
+CommandQueue::CommandQueue() : head_(&stub_), tail_(&stub_) {}
+
+CommandQueue::~CommandQueue() {
+  Stop();
+  // Only reachable if Start() never ran; Stop() drains otherwise.
+  while (Node* node = Pop()) delete node;
+}
+
+void CommandQueue::Start(std::string thread_name, Timer timer) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (worker_.joinable()) return;
+  timer_ = std::move(timer);
+  stopping_ = false;
+  accepting_ = true;
+  worker_ = std::thread(&CommandQueue::Run, this, std::move(thread_name));
+}
+
+bool CommandQueue::Post(Command command) {
+  Node* node = new Node;
+  node->command = std::move(command);
+  return Push(node);
+}
+
+bool CommandQueue::PostCoalesced(int key, Command command, Command superseded) {
+  Node* node = new Node;
+  node->command = std::move(command);
+  node->superseded = std::move(superseded);
+  node->key = key > 0 && key < kMaxCoalesceKeys ? key : 0;
+  return Push(node);
+}
+
+bool CommandQueue::Push(Node* node) {
+  // Stop() waits for |producers_| to drain after clearing |accepting_|, so
+  // a node is either rejected here or guaranteed to run.
+  producers_.fetch_add(1);
+  if (!accepting_.load()) {
+    producers_.fetch_sub(1);
+    delete node;
+    return false;
+  }
+  Link(node);
+  pending_.fetch_add(1);
+  Wake();
+  producers_.fetch_sub(1);
+  return true;
+}
+
+void CommandQueue::Link(Node* node) {
+  node->next.store(nullptr, std::memory_order_relaxed);
+  Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+  prev->next.store(node, std::memory_order_release);
+}
+
+CommandQueue::Node* CommandQueue::Pop() {
+  Node* tail = tail_;
+  Node* next = tail->next.load(std::memory_order_acquire);
+  if (tail == &stub_) {
+    if (next == nullptr) return nullptr;
+    tail_ = next;
+    tail = next;
+    next = next->next.load(std::memory_order_acquire);
+  }
+  if (next == nullptr) {
+    // |tail| is the last node; park the stub behind it so it can be taken.
+    if (tail != head_.load(std::memory_order_acquire)) return nullptr;
+    Link(&stub_);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next == nullptr) return nullptr;
+  }
+  tail_ = next;
+  pending_.fetch_sub(1);
+  return tail;
+}
+
+void CommandQueue::Wake() {
+  if (!sleeping_.load()) return;
+  std::lock_guard<std::mutex> lock(mutex_);
+  wake_.notify_one();
+}
+
+void CommandQueue::WakeTimer() {
+  timer_dirty_ = true;
+  Wake();
+}
+
+void CommandQueue::Stop() {
+  accepting_ = false;
+  while (producers_.load() != 0) std::this_thread::yield();
+  stopping_ = true;
+  Wake();
+  if (worker_.joinable()) worker_.join();
+}
+
+void CommandQueue::Run(std::string thread_name) {
+  worker_id_ = std::this_thread::get_id();
+  TraceRecorder::Instance().SetCurrentThreadName(thread_name);
+  using Clock = std::chrono::steady_clock;
+  auto next_tick = Clock::time_point::max();
+  auto schedule = [&]() {
+    if (!timer_) return;
+    const auto delay = timer_();
+    next_tick = delay.count() < 0 ? Clock::time_point::max() : Clock::now() + delay;
+  };
+  schedule();
+
+  while (true) {
+    if (Node* first = Pop()) {
+      RunBatch(first);
+      continue;
+    }
+    // Read |stopping_| first: every accepted push is counted before it is set.
+    const bool stopping = stopping_.load();
+    if (pending_.load() > 0) {
+      // A producer is between the exchange and the link
+      std::this_thread::yield();
+      continue;
+    }
+    if (stopping) break;
+
+    if (timer_dirty_.exchange(false) || Clock::now() >= next_tick) {
+      schedule();
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    sleeping_ = true;
+    const auto ready = [this]() {
+      return pending_.load() > 0 || stopping_.load() || timer_dirty_.load();
+    };
+    if (next_tick == Clock::time_point::max()) {
+      wake_.wait(lock, ready);
+    } else {
+      wake_.wait_until(lock, next_tick, ready);
+    }
+    sleeping_ = false;
+  }
+}
+
+void CommandQueue::RunBatch(Node* first) {
+  batch_.clear();
+  batch_.push_back(first);
+  while (Node* node = Pop()) batch_.push_back(node);
+
+  constexpr size_t kNone = static_cast<size_t>(-1);
+  std::array<size_t, kMaxCoalesceKeys> last;
+  last.fill(kNone);
+  for (size_t i = 0; i < batch_.size(); ++i) {
+    if (batch_[i]->key != 0) last[batch_[i]->key] = i;
+  }
+
+  PVP_TRACE_SCOPE("queue", "batch");
+  for (size_t i = 0; i < batch_.size(); ++i) {
+    Node* node = batch_[i];
+    if (node->key != 0 && last[node->key] != i) {
+      coalesced_.fetch_add(1, std::memory_order_relaxed);
+      if (node->superseded) node->superseded();
+    } else if (node->command) {
+      node->command();
+    }
+    delete node;
+  }
+  batch_.clear();
+}
+
+}  // namespace pro_video_player
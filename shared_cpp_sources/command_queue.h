@@ -0,0 +1,108 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_COMMAND_QUEUE_H_
+#define PRO_VIDEO_PLAYER_SHARED_COMMAND_QUEUE_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pro_video_player {
+
+// Serial executor backing one player.
+//
+// Commands run in FIFO order on a dedicated worker thread, which is the only
+// thread that touches the player's backend. An optional timer callback runs
+// on the same thread between batches (position ticks).
+//
+// Posting is lock-free (an intrusive multi-producer/single-consumer list),
+// so the platform thread never waits on a busy worker; the mutex is only
+// taken to wake a sleeping worker. The worker drains everything queued at
+// once and runs it as one batch, in which coalesced commands sharing a key
+// collapse to the last one posted.
+class CommandQueue {
+ public:
+  using Command = std::function<void()>;
+  // Runs on the worker; returns the delay until the next call, or a
+  // negative value to sleep until the next command.
+  using Timer = std::function<std::chrono::milliseconds()>;
+
+  // Keys for PostCoalesced() are small integers in [1, kMaxCoalesceKeys).
+  static constexpr int kMaxCoalesceKeys = 32;
+
+  CommandQueue();
+  ~CommandQueue();
+
+  CommandQueue(const CommandQueue&) = delete;
+  CommandQueue& operator=(const CommandQueue&) = delete;
+
+  // Spawns the worker. |timer| may be empty.
+  void Start(std::string thread_name, Timer timer = Timer());
+
+  // Returns false once Stop() has begun; the command is dropped.
+  bool Post(Command command);
+
+  // Like Post(), but if a later command with the same |key| lands in the
+  // same batch, only that one runs ("last volume wins") and |superseded|
+  // runs in place of this one, typically to complete its reply. Ordering
+  // against other commands is kept: the surviving command runs at its own
+  // position.
+  bool PostCoalesced(int key, Command command, Command superseded = Command());
+
+  // Re-evaluates the timer delay (e.g. after play/pause).
+  void WakeTimer();
+
+  // Runs already-queued commands, then joins the worker. Must not be called
+  // from the worker itself.
+  void Stop();
+
+  bool IsWorkerThread() const { return std::this_thread::get_id() == worker_id_.load(); }
+
+  // Commands dropped by coalescing so far.
+  uint64_t coalesced_count() const { return coalesced_.load(std::memory_order_relaxed); }
+
+ private:
+  struct Node {
+    std::atomic<Node*> next{nullptr};
+    Command command;
+    Command superseded;
+    int key = 0;
+  };
+
+  bool Push(Node* node);
+  void Link(Node* node);
+  // Worker only. Returns nullptr when empty or a producer is mid-push.
+  Node* Pop();
+  void Wake();
+  void Run(std::string thread_name);
+  void RunBatch(Node* first);
+
+  // Producers exchange |head_|; the worker owns |tail_|. |stub_| keeps the
+  // list non-empty so neither side ever needs a lock.
+  std::atomic<Node*> head_;
+  Node* tail_;
+  Node stub_;
+  std::atomic<int64_t> pending_{0};
+  std::atomic<int> producers_{0};
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::atomic<bool> sleeping_{false};
+  std::atomic<bool> accepting_{false};
+  std::atomic<bool> stopping_{false};
+  std::atomic<bool> timer_dirty_{false};
+  std::atomic<uint64_t> coalesced_{0};
+  Timer timer_;
+  // Worker only; reused across batches.
+  std::vector<Node*> batch_;
+  std::thread worker_;
+  std::atomic<std::thread::id> worker_id_{};
+};
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_COMMAND_QUEUE_H_
@@ -0,0 +1,115 @@
+#include "decode_backend.h"
+
+namespace pro_video_player {
+
+DecodeBackendRegistry& DecodeBackendRegistry::Instance() {
+  static DecodeBackendRegistry* instance = new DecodeBackendRegistry();
+  return *instance;
+}
+
+void DecodeBackendRegistry::Register(const std::string& name, DecodeBackendFactory factory,
+                                     const std::string& display_name, DecoderProbe probe,
+                                     DecodeBackendInitializer initializer) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Entry entry;
+  entry.factory = std::move(factory);
+  entry.display_name = display_name.empty() ? name : display_name;
+  entry.probe = std::move(probe);
+  entry.initializer = std::move(initializer);
+  factories_[name] = std::move(entry);
+  if (default_name_.empty()) default_name_ = name;
+}
+
+void DecodeBackendRegistry::Unregister(const std::string& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  factories_.erase(name);
+  if (default_name_ == name) {
+    default_name_ = factories_.empty() ? std::string() : factories_.begin()->first;
+  }
+}
+
+bool DecodeBackendRegistry::Initialize(const std::string& name) const {
+  DecodeBackendInitializer initializer;
+  std::shared_ptr<InitState> init;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = factories_.find(name.empty() ? default_name_ : name);
+    if (it == factories_.end()) return false;
+    initializer = it->second.initializer;
+    init = it->second.init;
+  }
+  // Held while the initializer runs, which may take seconds
+  std::lock_guard<std::mutex> lock(init->mutex);
+  if (!init->done) {
+    init->succeeded = initializer ? initializer() : true;
+    init->done = true;
+  }
+  return init->succeeded;
+}
+
+bool DecodeBackendRegistry::IsInitialized(const std::string& name) const {
+  std::shared_ptr<InitState> init;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = factories_.find(name.empty() ? default_name_ : name);
+    if (it == factories_.end()) return false;
+    init = it->second.init;
+  }
+  std::unique_lock<std::mutex> lock(init->mutex, std::try_to_lock);
+  return lock.owns_lock() && init->done;
+}
+
+std::unique_ptr<DecodeBackend> DecodeBackendRegistry::Create(const std::string& name) const {
+  if (!Initialize(name)) return nullptr;
+  DecodeBackendFactory factory;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = factories_.find(name.empty() ? default_name_ : name);
+    if (it == factories_.end()) return nullptr;
+    factory = it->second.factory;
+  }
+  // Constructed outside the lock; factories may be slow (library loading)
+  return factory();
+}
+
+void DecodeBackendRegistry::SetDefault(const std::string& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (factories_.count(name) != 0) default_name_ = name;
+}
+
+std::string DecodeBackendRegistry::default_name() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return default_name_;
+}
+
+std::vector<std::string> DecodeBackendRegistry::names() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<std::string> result;
+  result.reserve(factories_.size());
+  for (const auto& entry : factories_) result.push_back(entry.first);
+  return result;
+}
+
+std::string DecodeBackendRegistry::DisplayName(const std::string& name) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto it = factories_.find(name.empty() ? default_name_ : name);
+  return it == factories_.end() ? std::string() : it->second.display_name;
+}
+
+DecoderProbe DecodeBackendRegistry::Probe(const std::string& name) const {
+  DecoderProbe probe;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = factories_.find(name.empty() ? default_name_ : name);
+    if (it == factories_.end()) return DecoderProbe();
+    probe = it->second.probe;
+  }
+  if (probe.enumerate) {
+    probe.enumerate = [this, name, enumerate = probe.enumerate](std::vector<DecoderInfo>* decoders) {
+      return Initialize(name) && enumerate(decoders);
+    };
+  }
+  return probe;
+}
+
+}  // namespace pro_video_player
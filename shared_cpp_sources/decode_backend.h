@@ -0,0 +1,235 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_DECODE_BACKEND_H_
+#define PRO_VIDEO_PLAYER_SHARED_DECODE_BACKEND_H_
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "audio_levels.h"
+#include "codec_capabilities.h"
+#include "player_types.h"
+
+namespace pro_video_player {
+
+// Callbacks from a backend to its player. May be invoked on any thread;
+// the player marshals them onto its worker.
+class DecodeBackendListener {
+ public:
+  virtual ~DecodeBackendListener() = default;
+
+  // Source opened; duration, size and tracks are known.
+  virtual void OnPrepared(const MediaInfo& info) = 0;
+  virtual void OnBufferingChanged(bool buffering) = 0;
+  virtual void OnBufferedPosition(int64_t position_ms) = 0;
+  virtual void OnVideoSizeChanged(int width, int height) = 0;
+  virtual void OnTracksChanged(const std::vector<AudioTrack>& audio,
+                               const std::vector<SubtitleTrack>& subtitles) = 0;
+  virtual void OnEndOfStream() = 0;
+  virtual void OnError(const std::string& code, const std::string& message) = 0;
+
+  // Hot path: streaming thread, once per frame the render policy lets
+  // through.
+  virtual void OnFrame(const VideoFrame& frame) = 0;
+
+  // Decoded playback audio while the audio tap is enabled; always from the
+  // same backend thread.
+  virtual void OnAudioSamples(const AudioSamples& samples) = 0;
+
+  // Levels of the playback audio while the audio tap is enabled, from
+  // backends that meter inside their engine instead of handing out PCM.
+  // Roughly one call per metering window; always from the same thread.
+  virtual void OnAudioLevels(const AudioLevels& levels) = 0;
+
+  // A text cue the demuxer read for embedded subtitle |track_id|, while
+  // subtitle cues are enabled. Repeats (e.g. after a seek) are fine.
+  virtual void OnSubtitleCue(const std::string& track_id, const SubtitleCue& cue) = 0;
+
+  // Live HLS: the media playlist, each time the backend loads or refreshes
+  // it. The player keeps only a SegmentTimeline of it, for the seekable
+  // window. Backends that hide their playlists don't call this.
+  virtual void OnLivePlaylist(const std::string& playlist) = 0;
+};
+
+// Frames the player keeps referenced past presenting them: the newest one,
+// for CaptureFrame. Backends rendering into a FrameBufferPool size it this
+// much beyond what presenting needs, so the reference never costs a frame.
+inline constexpr size_t kFramesHeldByPlayer = 1;
+
+// Receives audio from DecodeBackend::ScanAudio.
+using AudioScanSink = std::function<void(const AudioSamples& samples)>;
+
+// A media engine (GStreamer, libmpv, ...) driven by Player.
+//
+// All methods except ScanAudio are called from the player's worker thread
+// only, so implementations need no locking of their own beyond what their
+// callbacks require. Control methods are fire-and-forget; outcomes arrive
+// through the listener.
+class DecodeBackend {
+ public:
+  virtual ~DecodeBackend() = default;
+
+  // Short identifier reported as the native player type ("GStreamer").
+  virtual std::string name() const = 0;
+
+  // Starts opening |source|; OnPrepared or OnError follows. |listener|
+  // outlives the backend.
+  virtual void Open(const MediaSource& source, DecodeBackendListener* listener) = 0;
+  virtual void Play() = 0;
+  virtual void Pause() = 0;
+  virtual void Seek(int64_t position_ms) = 0;
+  // Audio keeps its pitch between kMinTimeStretchRate and
+  // kMaxTimeStretchRate (backends rendering PCM themselves run it through a
+  // TimeStretcher) and is muted outside that range.
+  virtual void SetRate(double rate) = 0;
+  virtual void SetVolume(double volume) = 0;
+
+  // Called before Open() so backends that choose tracks while demuxing
+  // can start on the preferred ones instead of switching after prepare.
+  // Languages are BCP 47 tags; empty means no preference.
+  virtual void SetPreferredLanguages(const std::string& /*audio*/, const std::string& /*subtitle*/) {}
+
+  // Empty id disables the track type (subtitles off). Audio switches
+  // select among streams the demuxer already reads: no reopen, no
+  // rebuffer, position kept.
+  virtual void SelectAudioTrack(const std::string& track_id) = 0;
+  virtual void SelectSubtitleTrack(const std::string& track_id) = 0;
+
+  // Buffer watermarks from the player's BufferController; called before
+  // Open() and again whenever they change. Backends pause for a refill
+  // when they run dry and resume once |resume_ms| is buffered.
+  virtual void SetBufferLimits(const BufferLimits& /*limits*/) {}
+
+  // Memory pressure: frees what the backend can rebuild (idle frame
+  // buffers, decoder caches). Returns the bytes freed, as far as known.
+  virtual size_t TrimMemory() { return 0; }
+
+  // When false the backend may stop decoding video entirely (audio only).
+  virtual void SetVideoEnabled(bool enabled) = 0;
+
+  // On-screen size in physical pixels; backends may scale or pick a
+  // lower rendition. Zero means unknown.
+  virtual void SetOutputSizeHint(int width, int height) = 0;
+
+  // Render policy: at most one frame per |min_interval_us| of frame time
+  // (0 = uncapped, < 0 = none) and nothing while |visible| is false.
+  // Frames ruled out are dropped before they are scaled or converted (see
+  // FrameRateGate), so OnFrame only sees frames to present. May be called
+  // at any time.
+  virtual void SetRenderPolicy(int64_t min_interval_us, bool visible) = 0;
+
+  // Current media position; called to re-anchor the player clock.
+  virtual int64_t QueryPositionMs() = 0;
+
+  // Live streams: how far the playhead is behind the live edge, or -1 if
+  // the backend doesn't know. The player then takes the buffered position
+  // as the edge, which is where a live demuxer reads up to.
+  virtual int64_t QueryLiveLatencyMs() { return -1; }
+
+  // Audio analysis; optional. While the tap is enabled, decoded playback
+  // audio is reported through OnAudioSamples, or metered by the engine and
+  // reported through OnAudioLevels. Set before Open().
+  virtual void SetAudioTapEnabled(bool /*enabled*/) {}
+
+  // Subtitle rendering in Flutter; optional. While enabled the backend
+  // stops drawing the selected embedded subtitle track and reports its
+  // cues through OnSubtitleCue instead. May be called at any time.
+  virtual void SetSubtitleCuesEnabled(bool /*enabled*/) {}
+
+  // Decodes the audio of |source| as fast as possible, independent of
+  // playback, until the stream ends or |cancel| becomes true. Runs on a
+  // background thread while the backend may be playing, so implementations
+  // use a decoder of their own. Returns false if unsupported or failed.
+  virtual bool ScanAudio(const MediaSource& /*source*/, const AudioScanSink& /*sink*/,
+                         const std::atomic<bool>& /*cancel*/) {
+    return false;
+  }
+
+  // Engine warm-up; optional. Builds and tears down a representative
+  // pipeline (demuxer, decoder, output) on a throwaway source, so that the
+  // first Open() finds libraries loaded and caches filled. Called on a
+  // fresh instance, off the player's thread, instead of Open(); Close()
+  // follows. Returns false if unsupported or failed.
+  virtual bool WarmUp() { return false; }
+
+  // Releases all resources. No callbacks may be delivered afterwards.
+  virtual void Close() = 0;
+};
+
+using DecodeBackendFactory = std::function<std::unique_ptr<DecodeBackend>()>;
+
+// One-time, process-wide engine set-up (library init, plugin scans).
+// Returns false if the engine can't be used.
+using DecodeBackendInitializer = std::function<bool()>;
+
+// Name -> factory lookup used to pick a backend per player. Backends
+// register themselves at plugin start-up (or in tests); registering must
+// stay cheap, so engines do their set-up in an initializer that runs on
+// first use instead.
+class DecodeBackendRegistry {
+ public:
+  static DecodeBackendRegistry& Instance();
+
+  // Replaces any factory already registered under |name|. The first
+  // registered backend becomes the default. |display_name| is what
+  // PlatformInfo reports ("libmpv" for "mpv"); empty means |name|.
+  // |probe| lists the backend's decoders for CodecCapabilityCache.
+  // |initializer| runs once, on the first Initialize() or Create().
+  void Register(const std::string& name, DecodeBackendFactory factory,
+                const std::string& display_name = std::string(), DecoderProbe probe = DecoderProbe(),
+                DecodeBackendInitializer initializer = DecodeBackendInitializer());
+  void Unregister(const std::string& name);
+
+  // Runs the initializer of |name| unless it already ran; concurrent
+  // callers wait for the one running it. The outcome is kept, so a failed
+  // engine isn't retried. False if |name| is unknown or failed. Empty
+  // |name| means the default.
+  bool Initialize(const std::string& name = std::string()) const;
+  // Whether the initializer of |name| has run, without running it.
+  bool IsInitialized(const std::string& name = std::string()) const;
+
+  // Initializes the backend, then returns a new instance of it; nullptr
+  // if |name| is unknown or failed to initialize. Empty |name| means the
+  // default.
+  std::unique_ptr<DecodeBackend> Create(const std::string& name = std::string()) const;
+
+  void SetDefault(const std::string& name);
+  std::string default_name() const;
+  std::vector<std::string> names() const;
+
+  // Empty for unknown names. Empty |name| means the default.
+  std::string DisplayName(const std::string& name = std::string()) const;
+
+  // Empty (no enumerate) for unknown names and backends registered
+  // without one. Its enumerate initializes the backend first, since
+  // listing decoders needs the engine set up. Empty |name| means the
+  // default.
+  DecoderProbe Probe(const std::string& name = std::string()) const;
+
+ private:
+  struct InitState {
+    std::mutex mutex;
+    bool done = false;
+    bool succeeded = false;
+  };
+
+  struct Entry {
+    DecodeBackendFactory factory;
+    std::string display_name;
+    DecoderProbe probe;
+    DecodeBackendInitializer initializer;
+    // Shared so Initialize() can run it outside the registry lock
+    std::shared_ptr<InitState> init = std::make_shared<InitState>();
+  };
+
+  mutable std::mutex mutex_;
+  std::map<std::string, Entry> factories_;
+  std::string default_name_;
+};
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_DECODE_BACKEND_H_
@@ -0,0 +1,701 @@
+#include "download_manager.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <tuple>
+#include <utility>
+
+#include "hls_decrypt.h"
+#include "trace_recorder.h"
+
+namespace pro_video_player {
+
+namespace {
+
+constexpr char kEntryPlaylist[] = "index.m3u8";
+
+bool Retryable(const HttpResponse& response) { return response.status == 0 || response.status >= 500; }
+
+std::string HttpError(const HttpResponse& response) {
+  return response.error.empty() ? "HTTP " + std::to_string(response.status) : response.error;
+}
+
+bool StartsWith(std::string_view text, std::string_view prefix) { return text.substr(0, prefix.size()) == prefix; }
+
+// Splits |text| into lines without their line breaks, skipping blank ones.
+std::vector<std::string_view> Lines(std::string_view text) {
+  std::vector<std::string_view> lines;
+  size_t start = 0;
+  while (start < text.size()) {
+    size_t end = text.find('\n', start);
+    if (end == std::string_view::npos) end = text.size();
+    std::string_view line = text.substr(start, end - start);
+    while (!line.empty() && std::isspace(static_cast<unsigned char>(line.back()))) line.remove_suffix(1);
+    while (!line.empty() && std::isspace(static_cast<unsigned char>(line.front()))) line.remove_prefix(1);
+    if (!line.empty()) lines.push_back(line);
+    start = end + 1;
+  }
+  return lines;
+}
+
+// ".ts", ".m4s", ... of the URL's last path element; empty if none.
+std::string Extension(const std::string& url) {
+  const std::string path = url.substr(0, url.find_first_of("?#"));
+  const size_t slash = path.rfind('/');
+  const size_t dot = path.rfind('.');
+  if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return std::string();
+  const std::string extension = path.substr(dot);
+  if (extension.size() < 2 || extension.size() > 6) return std::string();
+  for (size_t i = 1; i < extension.size(); ++i) {
+    if (!std::isalnum(static_cast<unsigned char>(extension[i]))) return std::string();
+  }
+  return extension;
+}
+
+// EXT-X-BYTERANGE / BYTERANGE="<length>[@<offset>]"; offset -1 if absent.
+bool ParseByteRange(std::string_view text, int64_t* length, int64_t* offset) {
+  const std::string value(text);
+  char* end = nullptr;
+  *length = std::strtoll(value.c_str(), &end, 10);
+  if (end == value.c_str() || *length <= 0) return false;
+  *offset = -1;
+  if (*end != '@') return true;
+  *offset = std::strtoll(end + 1, nullptr, 10);
+  return *offset >= 0;
+}
+
+}  // namespace
+
+const char* DownloadStateName(DownloadState state) {
+  switch (state) {
+    case DownloadState::kQueued:
+      return "queued";
+    case DownloadState::kPreparing:
+      return "preparing";
+    case DownloadState::kDownloading:
+      return "downloading";
+    case DownloadState::kPaused:
+      return "paused";
+    case DownloadState::kCompleted:
+      return "completed";
+    case DownloadState::kFailed:
+      return "failed";
+  }
+  return "unknown";
+}
+
+// ==================== HLS planning ====================
+
+std::string ResolveUrl(const std::string& base, const std::string& reference) {
+  const size_t delimiter = reference.find_first_of(":/?#");
+  if (delimiter != std::string::npos && reference.compare(delimiter, 3, "://") == 0) return reference;
+  const size_t scheme_end = base.find("://");
+  if (scheme_end == std::string::npos) return reference;
+  if (StartsWith(reference, "//")) return base.substr(0, scheme_end + 1) + reference;
+  const size_t host_end = base.find_first_of("/?#", scheme_end + 3);
+  const std::string origin = base.substr(0, host_end);
+  if (StartsWith(reference, "/")) return origin + reference;
+  std::string path = host_end == std::string::npos ? std::string() : base.substr(host_end);
+  path = path.substr(0, path.find_first_of("?#"));
+  path = path.substr(0, path.rfind('/') + 1);
+  if (path.empty()) path = "/";
+  return origin + path + reference;
+}
+
+bool ParseHlsMasterPlaylist(std::string_view playlist, const std::string& url, std::vector<HlsVariant>* variants,
+                            std::vector<HlsAudioRendition>* audio) {
+  variants->clear();
+  audio->clear();
+  std::optional<HlsVariant> pending;
+  std::string_view name;
+  std::string_view value;
+  for (const std::string_view line : Lines(playlist)) {
+    if (StartsWith(line, "#EXT-X-STREAM-INF:")) {
+      HlsVariant variant;
+      std::string_view attributes = line.substr(18);
+      while (NextHlsAttribute(&attributes, &name, &value)) {
+        if (name == "BANDWIDTH") {
+          variant.bandwidth = std::strtoll(std::string(value).c_str(), nullptr, 10);
+        } else if (name == "RESOLUTION") {
+          const std::string resolution(value);
+          char* end = nullptr;
+          variant.width = static_cast<int>(std::strtol(resolution.c_str(), &end, 10));
+          if (*end == 'x') variant.height = static_cast<int>(std::strtol(end + 1, nullptr, 10));
+        } else if (name == "CODECS") {
+          variant.codecs = std::string(value);
+        } else if (name == "AUDIO") {
+          variant.audio_group = std::string(value);
+        }
+      }
+      pending = variant;
+    } else if (StartsWith(line, "#EXT-X-MEDIA:")) {
+      HlsAudioRendition rendition;
+      bool is_audio = false;
+      std::string_view attributes = line.substr(13);
+      while (NextHlsAttribute(&attributes, &name, &value)) {
+        if (name == "TYPE") {
+          is_audio = value == "AUDIO";
+        } else if (name == "GROUP-ID") {
+          rendition.group = std::string(value);
+        } else if (name == "URI") {
+          rendition.uri = ResolveUrl(url, std::string(value));
+        } else if (name == "DEFAULT") {
+          rendition.is_default = value == "YES";
+        }
+      }
+      // Without a URI the audio is muxed into the variants
+      if (is_audio && !rendition.uri.empty()) audio->push_back(std::move(rendition));
+    } else if (line.front() != '#' && pending) {
+      pending->uri = ResolveUrl(url, std::string(line));
+      variants->push_back(std::move(*pending));
+      pending.reset();
+    }
+  }
+  return !variants->empty();
+}
+
+size_t SelectHlsVariant(const std::vector<HlsVariant>& variants, const std::optional<VideoQualityTrack>& track) {
+  auto cost = [&track](const HlsVariant& variant) {
+    if (!track) return std::make_tuple(int64_t{0}, int64_t{0}, -variant.bandwidth);
+    const int64_t height = track->height > 0 ? std::abs(variant.height - track->height) : 0;
+    const int64_t width = track->width > 0 ? std::abs(variant.width - track->width) : 0;
+    const int64_t bitrate = track->bitrate > 0 ? std::abs(variant.bandwidth - track->bitrate) : -variant.bandwidth;
+    return std::make_tuple(height, width, bitrate);
+  };
+  size_t best = 0;
+  for (size_t i = 1; i < variants.size(); ++i) {
+    if (cost(variants[i]) < cost(variants[best])) best = i;
+  }
+  return best;
+}
+
+bool PlanHlsMediaPlaylist(std::string_view playlist, const std::string& url, const std::string& directory,
+                          std::vector<DownloadPart>* parts, std::string* local, std::string* error) {
+  std::string out;
+  bool header = false;
+  bool ended = false;
+  size_t segments = 0;
+  size_t maps = 0;
+  // Key URL -> local name; one file per key however many segments use it
+  std::map<std::string, std::string> keys;
+  // Where the next EXT-X-BYTERANGE without an offset starts, per URL
+  std::map<std::string, int64_t> range_ends;
+  int64_t range_length = -1;
+  int64_t range_offset = -1;
+  std::string_view name;
+  std::string_view value;
+
+  for (const std::string_view line : Lines(playlist)) {
+    if (line == "#EXTM3U") {
+      header = true;
+    } else if (StartsWith(line, "#EXT-X-STREAM-INF:")) {
+      *error = "Not a media playlist: " + url;
+      return false;
+    } else if (StartsWith(line, "#EXT-X-ENDLIST")) {
+      ended = true;
+    } else if (StartsWith(line, "#EXT-X-BYTERANGE:")) {
+      if (!ParseByteRange(line.substr(17), &range_length, &range_offset)) {
+        *error = "Bad " + std::string(line);
+        return false;
+      }
+      continue;
+    } else if (StartsWith(line, "#EXT-X-KEY:")) {
+      HlsKey key;
+      if (!ParseHlsKey(line.substr(11), 0, &key)) {
+        *error = "Unsupported key: " + std::string(line);
+        return false;
+      }
+      if (key.method != HlsKeyMethod::kNone) {
+        const std::string key_url = ResolveUrl(url, key.uri);
+        auto found = keys.find(key_url);
+        if (found == keys.end()) {
+          found = keys.emplace(key_url, "key" + std::to_string(keys.size()) + ".key").first;
+          parts->push_back({key_url, -1, -1, directory + found->second, 0});
+        }
+        std::string rewritten(line);
+        const std::string quoted = "URI=\"" + key.uri + "\"";
+        rewritten.replace(rewritten.find(quoted), quoted.size(), "URI=\"" + found->second + "\"");
+        out += rewritten + '\n';
+        continue;
+      }
+    } else if (StartsWith(line, "#EXT-X-MAP:")) {
+      std::string_view attributes = line.substr(11);
+      std::string map_url;
+      int64_t length = -1;
+      int64_t offset = -1;
+      while (NextHlsAttribute(&attributes, &name, &value)) {
+        if (name == "URI") {
+          map_url = ResolveUrl(url, std::string(value));
+        } else if (name == "BYTERANGE" && !ParseByteRange(value, &length, &offset)) {
+          length = -1;
+        }
+      }
+      if (map_url.empty()) {
+        *error = "Bad " + std::string(line);
+        return false;
+      }
+      const std::string extension = Extension(map_url);
+      const std::string file = "init" + std::to_string(maps++) + (extension.empty() ? ".mp4" : extension);
+      DownloadPart part{map_url, -1, -1, directory + file, 0};
+      if (length > 0) {
+        part.range_start = std::max<int64_t>(offset, 0);
+        part.range_end = part.range_start + length - 1;
+      }
+      parts->push_back(std::move(part));
+      out += "#EXT-X-MAP:URI=\"" + file + "\"\n";
+      continue;
+    } else if (line.front() != '#') {
+      const std::string segment_url = ResolveUrl(url, std::string(line));
+      const std::string extension = Extension(segment_url);
+      const std::string file = "seg" + std::to_string(segments++) + (extension.empty() ? ".ts" : extension);
+      DownloadPart part{segment_url, -1, -1, directory + file, 0};
+      if (range_length > 0) {
+        part.range_start = range_offset >= 0 ? range_offset : range_ends[segment_url];
+        part.range_end = part.range_start + range_length - 1;
+        range_ends[segment_url] = part.range_end + 1;
+        range_length = -1;
+      }
+      parts->push_back(std::move(part));
+      out += file + '\n';
+      continue;
+    }
+    out += std::string(line) + '\n';
+  }
+
+  if (!header) {
+    *error = "Not an HLS playlist: " + url;
+    return false;
+  }
+  if (!ended) {
+    *error = "Live playlists can't be downloaded: " + url;
+    return false;
+  }
+  if (segments == 0) {
+    *error = "No segments in " + url;
+    return false;
+  }
+  *local = std::move(out);
+  return true;
+}
+
+// ==================== DownloadManager ====================
+
+DownloadManager::DownloadManager(HttpFetcher* fetcher, DownloadStore* store, Options options, Listener listener)
+    : fetcher_(fetcher), store_(store), options_(options), listener_(std::move(listener)) {}
+
+DownloadManager::~DownloadManager() {
+  std::unique_lock<std::recursive_mutex> lock(mutex_);
+  stopped_ = true;
+  for (const auto& entry : fetches_) {
+    if (fetcher_->Cancel(entry.second.request)) --outstanding_;
+  }
+  fetches_.clear();
+  idle_cv_.wait(lock, [&]() { return outstanding_ == 0; });
+}
+
+bool DownloadManager::Start(const std::string& id, const MediaSource& source,
+                            const std::optional<VideoQualityTrack>& track) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  DownloadPlan existing;
+  if (stopped_ || source.type != SourceType::kNetwork || !DownloadStore::ValidId(id) || downloads_.count(id) != 0 ||
+      store_->ReadPlan(id, &existing)) {
+    return false;
+  }
+  auto download = std::make_unique<Download>();
+  download->status.id = id;
+  download->plan.source = source;
+  download->plan.track = track;
+  if (!store_->WritePlan(id, download->plan)) return false;
+  Notify(*download);
+  downloads_[id] = std::move(download);
+  order_.push_back(id);
+  Pump();
+  return true;
+}
+
+bool DownloadManager::Resume(const std::string& id) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  if (stopped_) return false;
+  Download* download;
+  const auto found = downloads_.find(id);
+  if (found != downloads_.end()) {
+    download = found->second.get();
+    const DownloadState state = download->status.state;
+    if (state != DownloadState::kPaused && state != DownloadState::kFailed) return true;
+  } else {
+    auto loaded = std::make_unique<Download>();
+    if (!store_->ReadPlan(id, &loaded->plan)) return false;
+    loaded->status.id = id;
+    download = loaded.get();
+    downloads_[id] = std::move(loaded);
+    order_.push_back(id);
+  }
+
+  // Trust only what is on disk and matches its journal line
+  PVP_TRACE_SCOPE("download", "DownloadManager::Resume");
+  bool complete = false;
+  const auto journal = store_->ReadJournal(id, &complete);
+  download->done.clear();
+  download->in_flight.clear();
+  download->next_part = 0;
+  download->status.bytes_done = 0;
+  for (const auto& entry : journal) {
+    if (entry.first < download->plan.parts.size() &&
+        store_->CheckPart(id, download->plan.parts[entry.first], entry.second)) {
+      download->done[entry.first] = entry.second;
+      download->status.bytes_done += entry.second.size;
+    }
+  }
+  download->status.state = DownloadState::kQueued;
+  download->status.error.clear();
+  download->status.parts_done = download->done.size();
+  download->status.parts_total = download->plan.parts.size();
+  Notify(*download);
+  Pump();
+  return true;
+}
+
+void DownloadManager::ResumeAll() {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  for (const std::string& id : store_->List()) {
+    bool complete = false;
+    store_->ReadJournal(id, &complete);
+    if (!complete || downloads_.count(id) != 0) Resume(id);
+  }
+}
+
+bool DownloadManager::Pause(const std::string& id) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  const auto found = downloads_.find(id);
+  if (found == downloads_.end()) return false;
+  Download* download = found->second.get();
+  const DownloadState state = download->status.state;
+  if (state == DownloadState::kCompleted || state == DownloadState::kFailed || state == DownloadState::kPaused) {
+    return state == DownloadState::kPaused;
+  }
+  CancelFetches(id);
+  download->playlists_pending = 0;
+  download->status.state = DownloadState::kPaused;
+  Notify(*download);
+  Pump();
+  return true;
+}
+
+bool DownloadManager::Remove(const std::string& id) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  const bool loaded = downloads_.count(id) != 0;
+  CancelFetches(id);
+  downloads_.erase(id);
+  order_.erase(std::remove(order_.begin(), order_.end(), id), order_.end());
+  const bool removed = store_->Remove(id);
+  Pump();
+  return loaded || removed;
+}
+
+std::optional<DownloadStatus> DownloadManager::Status(const std::string& id) const {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  const auto found = downloads_.find(id);
+  if (found == downloads_.end()) return std::nullopt;
+  return found->second->status;
+}
+
+std::vector<DownloadStatus> DownloadManager::List() const {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::vector<DownloadStatus> statuses;
+  for (const std::string& id : order_) statuses.push_back(downloads_.at(id)->status);
+  return statuses;
+}
+
+void DownloadManager::Pump() {
+  if (stopped_) return;
+  int active = 0;
+  for (const std::string& id : order_) {
+    const DownloadState state = downloads_.at(id)->status.state;
+    active += state == DownloadState::kPreparing || state == DownloadState::kDownloading;
+  }
+  for (const std::string& id : order_) {
+    if (active >= std::max(options_.max_active_downloads, 1)) break;
+    Download* download = downloads_.at(id).get();
+    if (download->status.state != DownloadState::kQueued) continue;
+    ++active;
+    if (download->plan.entry.empty()) {
+      download->status.state = DownloadState::kPreparing;
+      Notify(*download);
+      // Enough to tell a playlist from a media file, and the first chunk
+      // of the latter
+      StartFetch(id, FetchKind::kSource, 0, download->plan.source.uri, 0, options_.chunk_bytes - 1, 0);
+    } else {
+      BeginDownloading(download);
+    }
+  }
+
+  int running = static_cast<int>(fetches_.size());
+  for (const std::string& id : order_) {
+    Download* download = downloads_.at(id).get();
+    if (download->status.state != DownloadState::kDownloading) continue;
+    const auto& parts = download->plan.parts;
+    while (running < options_.max_parallel && download->next_part < parts.size()) {
+      const size_t index = download->next_part++;
+      if (download->done.count(index) != 0 || download->in_flight.count(index) != 0) continue;
+      StartFetch(id, FetchKind::kPart, index, parts[index].url, parts[index].range_start, parts[index].range_end, 0);
+      ++running;
+    }
+  }
+  ShareRate();
+}
+
+int64_t DownloadManager::RateShare(size_t transfers) const {
+  return std::max<int64_t>(options_.max_bytes_per_second / static_cast<int64_t>(std::max<size_t>(transfers, 1)), 1);
+}
+
+void DownloadManager::ShareRate() {
+  if (options_.max_bytes_per_second <= 0 || fetches_.size() == rate_shared_by_) return;
+  rate_shared_by_ = fetches_.size();
+  const int64_t share = RateShare(rate_shared_by_);
+  for (const auto& fetch : fetches_) fetcher_->SetMaxBytesPerSecond(fetch.second.request, share);
+}
+
+void DownloadManager::StartFetch(const std::string& id, FetchKind kind, size_t index, std::string url,
+                                 int64_t range_start, int64_t range_end, int attempts) {
+  Download* download = downloads_.at(id).get();
+  // Behind anything a player is waiting for
+  HttpRequest request = MakeHttpRequest(download->plan.source, std::move(url), FetchPriority::kPrefetch);
+  request.range_start = range_start;
+  request.range_end = range_end;
+  // Counting this one; ShareRate() evens out the others afterwards
+  if (options_.max_bytes_per_second > 0) request.max_bytes_per_second = RateShare(fetches_.size() + 1);
+  if (kind == FetchKind::kPart) download->in_flight.insert(index);
+
+  // The callback can't run before this returns: it needs mutex_
+  const uint64_t token = next_token_++;
+  Fetch& fetch = fetches_[token];
+  fetch.id = id;
+  fetch.kind = kind;
+  fetch.index = index;
+  fetch.url = request.url;
+  fetch.range_start = range_start;
+  fetch.range_end = range_end;
+  fetch.attempts = attempts + 1;
+  ++outstanding_;
+  fetch.request =
+      fetcher_->Fetch(std::move(request), [this, token](const HttpResponse& response) { OnResponse(token, response); });
+}
+
+void DownloadManager::OnResponse(uint64_t token, const HttpResponse& response) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  const auto found = fetches_.find(token);
+  if (!stopped_ && found != fetches_.end()) {
+    const Fetch fetch = std::move(found->second);
+    fetches_.erase(found);
+    Download* download = downloads_.at(fetch.id).get();
+    if (fetch.kind == FetchKind::kPart) download->in_flight.erase(fetch.index);
+
+    // A short body is as transient as a dropped connection
+    const bool short_read = response.ok() && fetch.range_end >= 0 && response.status == 206 &&
+                            static_cast<int64_t>(response.body.size()) != fetch.range_end - fetch.range_start + 1 &&
+                            fetch.kind == FetchKind::kPart;
+    if (((!response.ok() && Retryable(response)) || short_read) && fetch.attempts < options_.max_attempts) {
+      StartFetch(fetch.id, fetch.kind, fetch.index, fetch.url, fetch.range_start, fetch.range_end, fetch.attempts);
+    } else if (fetch.kind == FetchKind::kSource) {
+      OnSource(download, response);
+    } else if (fetch.kind == FetchKind::kPart) {
+      OnPart(download, fetch.index, response);
+    } else {
+      OnPlaylist(download, fetch.kind, response);
+    }
+    Pump();
+  }
+  if (--outstanding_ == 0) idle_cv_.notify_all();
+}
+
+void DownloadManager::OnSource(Download* download, const HttpResponse& response) {
+  if (!response.ok()) return Fail(download, HttpError(response));
+  const std::string& url = download->plan.source.uri;
+  std::string_view text(reinterpret_cast<const char*>(response.body.data()), response.body.size());
+  if (StartsWith(text, "\xef\xbb\xbf")) text.remove_prefix(3);
+
+  if (StartsWith(text, "#EXTM3U")) {
+    if (response.status == 206 && ContentRangeTotal(response) > static_cast<int64_t>(response.body.size())) {
+      return Fail(download, "Playlist is larger than a chunk: " + url);
+    }
+    std::vector<HlsVariant> variants;
+    std::vector<HlsAudioRendition> audio;
+    if (!ParseHlsMasterPlaylist(text, url, &variants, &audio)) {
+      download->variant = HlsVariant();
+      download->variant.uri = url;
+      download->variant_playlist = std::string(text);
+      return PlanHls(download);
+    }
+    download->variant = variants[SelectHlsVariant(variants, download->plan.track)];
+    download->audio_uri.clear();
+    bool audio_is_default = false;
+    for (const auto& rendition : audio) {
+      if (rendition.group != download->variant.audio_group || audio_is_default) continue;
+      download->audio_uri = rendition.uri;
+      audio_is_default = rendition.is_default;
+    }
+    download->playlists_pending = download->audio_uri.empty() ? 1 : 2;
+    StartFetch(download->status.id, FetchKind::kVariant, 0, download->variant.uri, -1, -1, 0);
+    if (!download->audio_uri.empty()) {
+      StartFetch(download->status.id, FetchKind::kAudio, 0, download->audio_uri, -1, -1, 0);
+    }
+    return;
+  }
+  if (text.find("<MPD") != std::string_view::npos) return Fail(download, "DASH downloads are not supported yet");
+
+  // Progressive: the response is the first chunk, or the whole file from a
+  // server that ignored the range
+  const std::string file = "media" + Extension(url);
+  download->plan.entry = file;
+  download->plan.parts.clear();
+  if (response.status == 206) {
+    const int64_t total = ContentRangeTotal(response);
+    if (total <= 0) return Fail(download, "No file size from " + url);
+    for (int64_t offset = 0; offset < total; offset += options_.chunk_bytes) {
+      download->plan.parts.push_back({url, offset, std::min(offset + options_.chunk_bytes, total) - 1, file, offset});
+    }
+  } else {
+    download->plan.parts.push_back({url, -1, -1, file, 0});
+  }
+  const DownloadPart& first = download->plan.parts[0];
+  if (first.range_end >= 0 && static_cast<int64_t>(response.body.size()) != first.range_end + 1) {
+    return Fail(download, "Short read from " + url);
+  }
+  if (!store_->WritePlan(download->status.id, download->plan)) {
+    return Fail(download, "Can't write to " + store_->PathFor(download->status.id));
+  }
+  BeginDownloading(download);
+  StorePart(download, 0, response);
+}
+
+void DownloadManager::OnPlaylist(Download* download, FetchKind kind, const HttpResponse& response) {
+  if (download->status.state != DownloadState::kPreparing) return;
+  if (!response.ok()) return Fail(download, HttpError(response));
+  std::string text(response.body.begin(), response.body.end());
+  if (kind == FetchKind::kVariant) {
+    download->variant_playlist = std::move(text);
+  } else {
+    download->audio_playlist = std::move(text);
+  }
+  if (--download->playlists_pending == 0) PlanHls(download);
+}
+
+void DownloadManager::PlanHls(Download* download) {
+  const std::string& id = download->status.id;
+  const bool separate_audio = !download->audio_uri.empty();
+  std::vector<DownloadPart> parts;
+  std::string video;
+  std::string audio;
+  std::string error;
+  if (!PlanHlsMediaPlaylist(download->variant_playlist, download->variant.uri, separate_audio ? "video/" : "",
+                            &parts, &video, &error) ||
+      (separate_audio &&
+       !PlanHlsMediaPlaylist(download->audio_playlist, download->audio_uri, "audio/", &parts, &audio, &error))) {
+    return Fail(download, error);
+  }
+  download->variant_playlist.clear();
+  download->audio_playlist.clear();
+
+  // Playlists before the plan: a planned download has everything but
+  // its parts on disk
+  bool written;
+  if (separate_audio) {
+    const HlsVariant& variant = download->variant;
+    std::string master = "#EXTM3U\n";
+    master += "#EXT-X-MEDIA:TYPE=AUDIO,GROUP-ID=\"audio\",NAME=\"audio\",DEFAULT=YES,AUTOSELECT=YES,";
+    master += "URI=\"audio/" + std::string(kEntryPlaylist) + "\"\n";
+    master += "#EXT-X-STREAM-INF:BANDWIDTH=" + std::to_string(variant.bandwidth);
+    if (variant.width > 0 && variant.height > 0) {
+      master += ",RESOLUTION=" + std::to_string(variant.width) + "x" + std::to_string(variant.height);
+    }
+    if (!variant.codecs.empty()) master += ",CODECS=\"" + variant.codecs + "\"";
+    master += ",AUDIO=\"audio\"\nvideo/" + std::string(kEntryPlaylist) + "\n";
+    written = store_->WriteFile(id, "video/" + std::string(kEntryPlaylist), video) &&
+              store_->WriteFile(id, "audio/" + std::string(kEntryPlaylist), audio) &&
+              store_->WriteFile(id, kEntryPlaylist, master);
+  } else {
+    written = store_->WriteFile(id, kEntryPlaylist, video);
+  }
+  download->plan.parts = std::move(parts);
+  download->plan.entry = kEntryPlaylist;
+  if (!written || !store_->WritePlan(id, download->plan)) {
+    download->plan.entry.clear();
+    return Fail(download, "Can't write to " + store_->PathFor(id));
+  }
+  BeginDownloading(download);
+}
+
+void DownloadManager::OnPart(Download* download, size_t index, const HttpResponse& response) {
+  if (download->status.state != DownloadState::kDownloading) return;
+  const DownloadPart& part = download->plan.parts[index];
+  if (!response.ok()) return Fail(download, part.url + ": " + HttpError(response));
+  if (part.range_start >= 0 && response.status != 206) return Fail(download, part.url + ": byte ranges not served");
+  if (part.range_end >= 0 && static_cast<int64_t>(response.body.size()) != part.range_end - part.range_start + 1) {
+    return Fail(download, part.url + ": short read");
+  }
+  StorePart(download, index, response);
+}
+
+void DownloadManager::StorePart(Download* download, size_t index, const HttpResponse& response) {
+  PVP_TRACE_SCOPE("download", "DownloadManager::StorePart");
+  const std::string& id = download->status.id;
+  DownloadedPart stored;
+  stored.size = static_cast<int64_t>(response.body.size());
+  stored.crc = Crc32(response.body.data(), response.body.size());
+  if (!store_->WritePart(id, download->plan.parts[index], response.body.data(), response.body.size()) ||
+      !store_->AppendJournal(id, index, stored)) {
+    return Fail(download, "Can't write to " + store_->PathFor(id));
+  }
+  download->done[index] = stored;
+  download->status.parts_done = download->done.size();
+  download->status.bytes_done += stored.size;
+  if (download->done.size() == download->plan.parts.size()) {
+    store_->MarkComplete(id);
+    download->status.state = DownloadState::kCompleted;
+  }
+  Notify(*download);
+}
+
+void DownloadManager::BeginDownloading(Download* download) {
+  download->status.state = DownloadState::kDownloading;
+  download->status.parts_total = download->plan.parts.size();
+  download->status.parts_done = download->done.size();
+  download->next_part = 0;
+  if (download->done.size() == download->plan.parts.size()) {
+    store_->MarkComplete(download->status.id);
+    download->status.state = DownloadState::kCompleted;
+  }
+  Notify(*download);
+}
+
+void DownloadManager::Fail(Download* download, std::string error) {
+  CancelFetches(download->status.id);
+  download->playlists_pending = 0;
+  download->status.state = DownloadState::kFailed;
+  download->status.error = std::move(error);
+  Notify(*download);
+}
+
+void DownloadManager::CancelFetches(const std::string& id) {
+  for (auto fetch = fetches_.begin(); fetch != fetches_.end();) {
+    if (fetch->second.id != id) {
+      ++fetch;
+      continue;
+    }
+    if (fetcher_->Cancel(fetch->second.request)) --outstanding_;
+    fetch = fetches_.erase(fetch);
+  }
+  const auto found = downloads_.find(id);
+  if (found != downloads_.end()) {
+    found->second->in_flight.clear();
+    found->second->next_part = 0;
+  }
+  if (outstanding_ == 0) idle_cv_.notify_all();
+}
+
+void DownloadManager::Notify(const Download& download) {
+  if (listener_) listener_(download.status);
+}
+
+}  // namespace pro_video_player
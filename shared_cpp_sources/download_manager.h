@@ -0,0 +1,224 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_DOWNLOAD_MANAGER_H_
+#define PRO_VIDEO_PLAYER_SHARED_DOWNLOAD_MANAGER_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "download_store.h"
+#include "http_fetcher.h"
+#include "player_types.h"
+
+namespace pro_video_player {
+
+enum class DownloadState {
+  kQueued,
+  // Reading the source to find out what to fetch.
+  kPreparing,
+  kDownloading,
+  kPaused,
+  kCompleted,
+  kFailed,
+};
+
+// "queued", "preparing", ...
+const char* DownloadStateName(DownloadState state);
+
+struct DownloadStatus {
+  std::string id;
+  DownloadState state = DownloadState::kQueued;
+  // 0 total while preparing.
+  size_t parts_done = 0;
+  size_t parts_total = 0;
+  int64_t bytes_done = 0;
+  // Why the download failed.
+  std::string error;
+};
+
+// ==================== HLS planning ====================
+
+// One EXT-X-STREAM-INF of a master playlist.
+struct HlsVariant {
+  std::string uri;
+  int64_t bandwidth = 0;
+  int width = 0;
+  int height = 0;
+  std::string codecs;
+  // GROUP-ID of its EXT-X-MEDIA audio renditions, if any.
+  std::string audio_group;
+};
+
+// An EXT-X-MEDIA TYPE=AUDIO with its own playlist.
+struct HlsAudioRendition {
+  std::string group;
+  std::string uri;
+  bool is_default = false;
+};
+
+// |reference| (absolute, host-relative or path-relative) against |base|.
+std::string ResolveUrl(const std::string& base, const std::string& reference);
+
+// Variants and audio renditions of a master playlist at |url|, URIs
+// resolved. False if |playlist| has no variants (a media playlist).
+bool ParseHlsMasterPlaylist(std::string_view playlist, const std::string& url, std::vector<HlsVariant>* variants,
+                            std::vector<HlsAudioRendition>* audio);
+
+// Index of the variant closest to |track|: nearest height, then width,
+// then bitrate. The highest bandwidth without a track.
+size_t SelectHlsVariant(const std::vector<HlsVariant>& variants, const std::optional<VideoQualityTrack>& track);
+
+// Plans the download of a VOD media playlist at |url| into |directory|
+// ("" or e.g. "video/"): a part per segment, key and init section, added
+// to |parts|, and |local|, the playlist rewritten to name those files
+// (relative to itself) without byte ranges. Fails on live playlists and
+// on keys other than clear AES-128/SAMPLE-AES.
+bool PlanHlsMediaPlaylist(std::string_view playlist, const std::string& url, const std::string& directory,
+                          std::vector<DownloadPart>* parts, std::string* local, std::string* error);
+
+// ==================== DownloadManager ====================
+
+// Downloads streams and files into a DownloadStore for offline playback.
+//
+// A download starts by fetching its source. HLS master playlists are
+// narrowed to one variant (SelectHlsVariant) plus its default audio
+// rendition; segments, keys and init sections become parts, and the
+// playlists are rewritten to point at them. Anything else is a progressive
+// file, fetched in |chunk_bytes| ranges (in one piece from servers that
+// ignore Range). DASH manifests are refused for now.
+//
+// Up to |max_active_downloads| run at once, in start order, sharing
+// |max_parallel| transfers. With |max_bytes_per_second| set, the running
+// transfers split it evenly, re-split whenever one starts or ends, so the
+// total stays under it without idling when few are running. Failed parts (no
+// response or 5xx) are retried up to |max_attempts| times before the
+// download fails; Resume() picks it up again.
+//
+// Every part is journaled with its size and CRC-32 once written. After a
+// crash, Resume()/ResumeAll() re-read the journaled parts, fetch again
+// any that don't match and continue with the rest.
+//
+// Thread-safe. The listener runs on the fetcher thread with the manager
+// locked: it may call back into the manager but must not block.
+class DownloadManager {
+ public:
+  using Listener = std::function<void(const DownloadStatus& status)>;
+
+  struct Options {
+    int max_parallel = 4;
+    int max_active_downloads = 1;
+    // 0 is unlimited.
+    int64_t max_bytes_per_second = 0;
+    int max_attempts = 3;
+    int64_t chunk_bytes = 4 * 1024 * 1024;
+  };
+
+  // |fetcher| and |store| must outlive the manager.
+  DownloadManager(HttpFetcher* fetcher, DownloadStore* store, Options options, Listener listener);
+  // Cancels all transfers (downloads stay resumable), then waits for a
+  // listener call in progress. Not from the listener.
+  ~DownloadManager();
+
+  DownloadManager(const DownloadManager&) = delete;
+  DownloadManager& operator=(const DownloadManager&) = delete;
+
+  // Queues a download of |source| (kNetwork) as |id|. False if the id is
+  // invalid or taken, or the store can't be written.
+  bool Start(const std::string& id, const MediaSource& source,
+             const std::optional<VideoQualityTrack>& track = std::nullopt);
+
+  // Queues a paused, failed or interrupted download again, checking the
+  // parts already on disk first. False for unknown ids.
+  bool Resume(const std::string& id);
+  // Resumes every unfinished download in the store.
+  void ResumeAll();
+
+  // Cancels a download's transfers; what is on disk is kept.
+  bool Pause(const std::string& id);
+  // Cancels a download and deletes it from the store.
+  bool Remove(const std::string& id);
+
+  std::optional<DownloadStatus> Status(const std::string& id) const;
+  std::vector<DownloadStatus> List() const;
+
+ private:
+  enum class FetchKind {
+    kSource,
+    kVariant,
+    kAudio,
+    kPart,
+  };
+
+  struct Fetch {
+    std::string id;
+    FetchKind kind = FetchKind::kPart;
+    size_t index = 0;
+    std::string url;
+    int64_t range_start = -1;
+    int64_t range_end = -1;
+    int attempts = 0;
+    HttpFetcher::RequestId request = 0;
+  };
+
+  struct Download {
+    DownloadStatus status;
+    DownloadPlan plan;
+    std::map<size_t, DownloadedPart> done;
+    std::set<size_t> in_flight;
+    // Parts before it are done or in flight.
+    size_t next_part = 0;
+    // Preparing: the variant, and the audio rendition ("" if none).
+    HlsVariant variant;
+    std::string audio_uri;
+    std::string variant_playlist;
+    std::string audio_playlist;
+    int playlists_pending = 0;
+  };
+
+  void Pump();
+  void StartFetch(const std::string& id, FetchKind kind, size_t index, std::string url, int64_t range_start,
+                  int64_t range_end, int attempts);
+  void OnResponse(uint64_t token, const HttpResponse& response);
+  void OnSource(Download* download, const HttpResponse& response);
+  void OnPlaylist(Download* download, FetchKind kind, const HttpResponse& response);
+  void PlanHls(Download* download);
+  void OnPart(Download* download, size_t index, const HttpResponse& response);
+  void StorePart(Download* download, size_t index, const HttpResponse& response);
+  void BeginDownloading(Download* download);
+  void Fail(Download* download, std::string error);
+  void CancelFetches(const std::string& id);
+  int64_t RateShare(size_t transfers) const;
+  void ShareRate();
+  void Notify(const Download& download);
+
+  HttpFetcher* const fetcher_;
+  DownloadStore* const store_;
+  const Options options_;
+  const Listener listener_;
+
+  // Held while the listener runs, hence recursive.
+  mutable std::recursive_mutex mutex_;
+  std::condition_variable_any idle_cv_;
+  bool stopped_ = false;
+  // Fetches whose callback may still run.
+  int outstanding_ = 0;
+  uint64_t next_token_ = 1;
+  std::map<uint64_t, Fetch> fetches_;
+  // Transfers the rate cap was last split over.
+  size_t rate_shared_by_ = 0;
+  std::map<std::string, std::unique_ptr<Download>> downloads_;
+  // Start order; scheduling goes by it.
+  std::vector<std::string> order_;
+};
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_DOWNLOAD_MANAGER_H_
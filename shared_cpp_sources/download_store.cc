@@ -0,0 +1,349 @@
+#include "download_store.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <system_error>
+#include <utility>
+
+namespace pro_video_player {
+
+namespace {
+
+constexpr char kPlanHeader[] = "pvp-download 1";
+constexpr char kComplete[] = "complete";
+constexpr size_t kMaxIdLength = 128;
+
+std::array<uint32_t, 256> MakeCrcTable() {
+  std::array<uint32_t, 256> table{};
+  for (uint32_t i = 0; i < 256; ++i) {
+    uint32_t crc = i;
+    for (int bit = 0; bit < 8; ++bit) crc = (crc & 1) ? 0xedb88320u ^ (crc >> 1) : crc >> 1;
+    table[i] = crc;
+  }
+  return table;
+}
+
+std::string DefaultDirectory() {
+  const char* xdg = std::getenv("XDG_DATA_HOME");
+  std::string base;
+  if (xdg != nullptr && *xdg != '\0') {
+    base = xdg;
+  } else if (const char* home = std::getenv("HOME"); home != nullptr && *home != '\0') {
+    base = std::string(home) + "/.local/share";
+  } else {
+    return std::string();
+  }
+  return base + "/pro_video_player/downloads";
+}
+
+// Fields are tab-separated, so values can't hold tabs or line breaks.
+bool Storable(const std::string& value) { return value.find_first_of("\t\r\n") == std::string::npos; }
+
+// Part paths stay inside the download's directory.
+bool SafeRelativePath(const std::string& path) {
+  if (path.empty() || path.front() == '/' || path.find('\\') != std::string::npos) return false;
+  for (const auto& element : std::filesystem::path(path)) {
+    if (element == "..") return false;
+  }
+  return true;
+}
+
+std::vector<std::string> SplitTabs(const std::string& line) {
+  std::vector<std::string> fields;
+  size_t start = 0;
+  while (true) {
+    const size_t tab = line.find('\t', start);
+    fields.push_back(line.substr(start, tab == std::string::npos ? std::string::npos : tab - start));
+    if (tab == std::string::npos) return fields;
+    start = tab + 1;
+  }
+}
+
+bool WriteAtomically(const std::filesystem::path& path, const std::string& contents) {
+  std::error_code error;
+  std::filesystem::create_directories(path.parent_path(), error);
+  if (error) return false;
+  const std::filesystem::path temp = path.string() + ".tmp";
+  {
+    std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+    file << contents;
+    file.flush();
+    if (!file) {
+      file.close();
+      std::filesystem::remove(temp, error);
+      return false;
+    }
+  }
+  std::filesystem::rename(temp, path, error);
+  return !error;
+}
+
+}  // namespace
+
+uint32_t Crc32(const uint8_t* data, size_t size, uint32_t crc) {
+  static const std::array<uint32_t, 256> table = MakeCrcTable();
+  crc = ~crc;
+  for (size_t i = 0; i < size; ++i) crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+  return ~crc;
+}
+
+DownloadStore& DownloadStore::Instance() {
+  static DownloadStore* instance = new DownloadStore(DefaultDirectory());
+  return *instance;
+}
+
+void DownloadStore::SetDirectory(std::string directory) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  directory_ = std::move(directory);
+}
+
+std::string DownloadStore::directory() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return directory_;
+}
+
+bool DownloadStore::ValidId(const std::string& id) {
+  if (id.empty() || id.size() > kMaxIdLength || id.front() == '.') return false;
+  for (const char c : id) {
+    const bool allowed = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' ||
+                         c == '_' || c == '.';
+    if (!allowed) return false;
+  }
+  return true;
+}
+
+std::string DownloadStore::PathFor(const std::string& id) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (directory_.empty() || !ValidId(id)) return std::string();
+  return directory_ + "/" + id;
+}
+
+std::vector<std::string> DownloadStore::List() const {
+  std::vector<std::string> ids;
+  const std::string root = directory();
+  std::error_code error;
+  if (root.empty() || !std::filesystem::is_directory(root, error)) return ids;
+  for (const auto& entry : std::filesystem::directory_iterator(root, error)) {
+    const std::string id = entry.path().filename().string();
+    if (ValidId(id) && std::filesystem::exists(entry.path() / "plan", error)) ids.push_back(id);
+  }
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+bool DownloadStore::WritePlan(const std::string& id, const DownloadPlan& plan) const {
+  const std::string directory = PathFor(id);
+  if (directory.empty()) return false;
+  std::ostringstream out;
+  out << kPlanHeader << '\n';
+  out << "source\t" << static_cast<int>(plan.source.type) << '\t' << plan.source.uri << '\n';
+  bool storable = Storable(plan.source.uri) && Storable(plan.entry);
+  for (const auto& header : plan.source.headers) {
+    out << "header\t" << header.first << '\t' << header.second << '\n';
+    storable = storable && Storable(header.first) && Storable(header.second);
+  }
+  if (plan.track) {
+    out << "track\t" << plan.track->bitrate << '\t' << plan.track->width << '\t' << plan.track->height << '\t'
+        << plan.track->id << '\n';
+    storable = storable && Storable(plan.track->id);
+  }
+  if (!plan.entry.empty()) out << "entry\t" << plan.entry << '\n';
+  for (const auto& part : plan.parts) {
+    out << "part\t" << part.path << '\t' << part.offset << '\t' << part.range_start << '\t' << part.range_end << '\t'
+        << part.url << '\n';
+    storable = storable && Storable(part.url) && SafeRelativePath(part.path);
+  }
+  if (!storable || (!plan.entry.empty() && !SafeRelativePath(plan.entry))) return false;
+  // Credentials in the headers stay readable to the user only
+  if (!WriteAtomically(std::filesystem::path(directory) / "plan", out.str())) return false;
+  std::error_code error;
+  std::filesystem::permissions(std::filesystem::path(directory) / "plan",
+                               std::filesystem::perms::owner_read | std::filesystem::perms::owner_write,
+                               std::filesystem::perm_options::replace, error);
+  return true;
+}
+
+bool DownloadStore::ReadPlan(const std::string& id, DownloadPlan* plan) const {
+  const std::string directory = PathFor(id);
+  if (directory.empty()) return false;
+  std::ifstream file(std::filesystem::path(directory) / "plan");
+  std::string line;
+  if (!std::getline(file, line) || line != kPlanHeader) return false;
+  DownloadPlan parsed;
+  bool has_source = false;
+  while (std::getline(file, line)) {
+    const std::vector<std::string> fields = SplitTabs(line);
+    const std::string& kind = fields[0];
+    if (kind == "source" && fields.size() == 3) {
+      const int type = std::atoi(fields[1].c_str());
+      if (type < 0 || type > static_cast<int>(SourceType::kOffline)) return false;
+      parsed.source.type = static_cast<SourceType>(type);
+      parsed.source.uri = fields[2];
+      has_source = true;
+    } else if (kind == "header" && fields.size() == 3) {
+      parsed.source.headers[fields[1]] = fields[2];
+    } else if (kind == "track" && fields.size() == 5) {
+      VideoQualityTrack track;
+      track.bitrate = std::strtoll(fields[1].c_str(), nullptr, 10);
+      track.width = std::atoi(fields[2].c_str());
+      track.height = std::atoi(fields[3].c_str());
+      track.id = fields[4];
+      parsed.track = track;
+    } else if (kind == "entry" && fields.size() == 2 && SafeRelativePath(fields[1])) {
+      parsed.entry = fields[1];
+    } else if (kind == "part" && fields.size() == 6 && SafeRelativePath(fields[1])) {
+      DownloadPart part;
+      part.path = fields[1];
+      part.offset = std::strtoll(fields[2].c_str(), nullptr, 10);
+      part.range_start = std::strtoll(fields[3].c_str(), nullptr, 10);
+      part.range_end = std::strtoll(fields[4].c_str(), nullptr, 10);
+      part.url = fields[5];
+      parsed.parts.push_back(std::move(part));
+    } else {
+      return false;
+    }
+  }
+  if (!has_source) return false;
+  *plan = std::move(parsed);
+  return true;
+}
+
+bool DownloadStore::WriteFile(const std::string& id, const std::string& path, const std::string& contents) const {
+  const std::string directory = PathFor(id);
+  if (directory.empty() || !SafeRelativePath(path)) return false;
+  return WriteAtomically(std::filesystem::path(directory) / path, contents);
+}
+
+bool DownloadStore::WritePart(const std::string& id, const DownloadPart& part, const uint8_t* data,
+                              size_t size) const {
+  const std::string directory = PathFor(id);
+  if (directory.empty() || !SafeRelativePath(part.path)) return false;
+  const std::filesystem::path path = std::filesystem::path(directory) / part.path;
+  std::error_code error;
+  std::filesystem::create_directories(path.parent_path(), error);
+  if (error) return false;
+  std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+  if (!file.is_open()) {
+    std::ofstream(path, std::ios::binary).close();
+    file.open(path, std::ios::in | std::ios::out | std::ios::binary);
+  }
+  file.seekp(part.offset);
+  file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+  file.flush();
+  return static_cast<bool>(file);
+}
+
+bool DownloadStore::AppendJournal(const std::string& id, size_t index, const DownloadedPart& part) const {
+  const std::string directory = PathFor(id);
+  if (directory.empty()) return false;
+  std::ofstream file(std::filesystem::path(directory) / "journal", std::ios::app);
+  char crc[9];
+  std::snprintf(crc, sizeof(crc), "%08x", static_cast<unsigned>(part.crc));
+  file << index << '\t' << part.size << '\t' << crc << '\n';
+  file.flush();
+  return static_cast<bool>(file);
+}
+
+bool DownloadStore::MarkComplete(const std::string& id) const {
+  const std::string directory = PathFor(id);
+  if (directory.empty()) return false;
+  std::ofstream file(std::filesystem::path(directory) / "journal", std::ios::app);
+  file << kComplete << '\n';
+  file.flush();
+  return static_cast<bool>(file);
+}
+
+std::map<size_t, DownloadedPart> DownloadStore::ReadJournal(const std::string& id, bool* complete) const {
+  std::map<size_t, DownloadedPart> parts;
+  *complete = false;
+  const std::string directory = PathFor(id);
+  if (directory.empty()) return parts;
+  std::ifstream file(std::filesystem::path(directory) / "journal");
+  std::string line;
+  // Only whole lines count: the last one may have been cut off
+  while (std::getline(file, line) && !file.eof()) {
+    if (line == kComplete) {
+      *complete = true;
+      continue;
+    }
+    const std::vector<std::string> fields = SplitTabs(line);
+    if (fields.size() != 3 || fields[2].size() != 8) continue;
+    DownloadedPart part;
+    part.size = std::strtoll(fields[1].c_str(), nullptr, 10);
+    part.crc = static_cast<uint32_t>(std::strtoul(fields[2].c_str(), nullptr, 16));
+    parts[std::strtoull(fields[0].c_str(), nullptr, 10)] = part;
+  }
+  return parts;
+}
+
+bool DownloadStore::CheckPart(const std::string& id, const DownloadPart& part,
+                              const DownloadedPart& journaled) const {
+  const std::string directory = PathFor(id);
+  if (directory.empty() || !SafeRelativePath(part.path) || journaled.size < 0) return false;
+  std::ifstream file(std::filesystem::path(directory) / part.path, std::ios::binary);
+  if (!file.seekg(part.offset)) return false;
+  std::vector<uint8_t> buffer(64 * 1024);
+  uint32_t crc = 0;
+  int64_t remaining = journaled.size;
+  while (remaining > 0) {
+    const size_t chunk = static_cast<size_t>(std::min<int64_t>(remaining, static_cast<int64_t>(buffer.size())));
+    if (!file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(chunk))) return false;
+    crc = Crc32(buffer.data(), chunk, crc);
+    remaining -= static_cast<int64_t>(chunk);
+  }
+  return crc == journaled.crc;
+}
+
+bool DownloadStore::Verify(const std::string& id, std::string* error) const {
+  DownloadPlan plan;
+  if (!ReadPlan(id, &plan)) {
+    *error = "No download " + id;
+    return false;
+  }
+  bool complete = false;
+  const auto journal = ReadJournal(id, &complete);
+  if (!complete || plan.entry.empty()) {
+    *error = "Download " + id + " is not finished";
+    return false;
+  }
+  for (size_t i = 0; i < plan.parts.size(); ++i) {
+    const auto journaled = journal.find(i);
+    if (journaled == journal.end() || !CheckPart(id, plan.parts[i], journaled->second)) {
+      *error = "Download " + id + ": " + plan.parts[i].path + " is damaged";
+      return false;
+    }
+  }
+  return true;
+}
+
+bool DownloadStore::Resolve(const std::string& id, MediaSource* source, std::string* error) const {
+  DownloadPlan plan;
+  if (!ReadPlan(id, &plan)) {
+    *error = "No download " + id;
+    return false;
+  }
+  bool complete = false;
+  ReadJournal(id, &complete);
+  if (!complete || plan.entry.empty()) {
+    *error = "Download " + id + " is not finished";
+    return false;
+  }
+  source->type = SourceType::kFile;
+  source->uri = PathFor(id) + "/" + plan.entry;
+  source->headers.clear();
+  return true;
+}
+
+bool DownloadStore::Remove(const std::string& id) const {
+  const std::string directory = PathFor(id);
+  if (directory.empty()) return false;
+  std::error_code error;
+  return std::filesystem::remove_all(directory, error) > 0 && !error;
+}
+
+}  // namespace pro_video_player
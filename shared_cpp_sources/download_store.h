@@ -0,0 +1,118 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_DOWNLOAD_STORE_H_
+#define PRO_VIDEO_PLAYER_SHARED_DOWNLOAD_STORE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "player_types.h"
+
+namespace pro_video_player {
+
+// CRC-32 (IEEE), continuing from |crc|.
+uint32_t Crc32(const uint8_t* data, size_t size, uint32_t crc = 0);
+
+// One file, or byte range of one, to fetch into a download.
+struct DownloadPart {
+  std::string url;
+  int64_t range_start = -1;
+  int64_t range_end = -1;
+  // File relative to the download's directory, and where in it the bytes
+  // go (progressive files arrive in ranges).
+  std::string path;
+  int64_t offset = 0;
+
+  bool operator==(const DownloadPart& other) const {
+    return url == other.url && range_start == other.range_start && range_end == other.range_end &&
+           path == other.path && offset == other.offset;
+  }
+};
+
+// What a download fetches. Written when it starts, with no parts until the
+// source has been looked at, and again once planned.
+struct DownloadPlan {
+  MediaSource source;
+  // HLS: the variant to keep, matched on bitrate and size. Highest
+  // bandwidth if unset.
+  std::optional<VideoQualityTrack> track;
+  // File a player opens, relative to the download's directory; empty
+  // until planned.
+  std::string entry;
+  std::vector<DownloadPart> parts;
+};
+
+// Journal entry of a part that is on disk.
+struct DownloadedPart {
+  int64_t size = 0;
+  uint32_t crc = 0;
+};
+
+// Offline downloads on disk, one directory per id:
+//
+//   plan      the DownloadPlan (text, replaced atomically)
+//   journal   append-only: a line per part once its bytes are written,
+//             then "complete"
+//   ...       the media: a progressive file, or HLS playlists rewritten to
+//             point at local segments and keys
+//
+// A crash loses at most the parts whose journal lines weren't written;
+// the journal's CRCs catch parts whose bytes didn't make it to disk.
+//
+// Thread-safe for distinct ids. DownloadManager fills it; players open
+// finished downloads through SourceType::kOffline.
+class DownloadStore {
+ public:
+  // Uses $XDG_DATA_HOME/pro_video_player/downloads (or
+  // ~/.local/share/...).
+  static DownloadStore& Instance();
+
+  explicit DownloadStore(std::string directory) : directory_(std::move(directory)) {}
+
+  void SetDirectory(std::string directory);
+  std::string directory() const;
+
+  // Ids name directories: up to 128 letters, digits, '-', '_' and '.',
+  // not starting with '.'.
+  static bool ValidId(const std::string& id);
+
+  // Ids that have a plan, sorted.
+  std::vector<std::string> List() const;
+
+  bool WritePlan(const std::string& id, const DownloadPlan& plan) const;
+  bool ReadPlan(const std::string& id, DownloadPlan* plan) const;
+
+  // Replaces the file |path| of a download (playlists) atomically.
+  bool WriteFile(const std::string& id, const std::string& path, const std::string& contents) const;
+  // Writes a part's bytes at its offset, creating the file as needed.
+  bool WritePart(const std::string& id, const DownloadPart& part, const uint8_t* data, size_t size) const;
+
+  bool AppendJournal(const std::string& id, size_t index, const DownloadedPart& part) const;
+  bool MarkComplete(const std::string& id) const;
+  // Parts journaled so far by index; |complete| tells whether all were.
+  // A torn last line is ignored.
+  std::map<size_t, DownloadedPart> ReadJournal(const std::string& id, bool* complete) const;
+
+  // Re-reads a part from disk and checks it against its journal entry.
+  bool CheckPart(const std::string& id, const DownloadPart& part, const DownloadedPart& journaled) const;
+  // Checks every part of a finished download.
+  bool Verify(const std::string& id, std::string* error) const;
+
+  // The local file a player opens for a finished download.
+  bool Resolve(const std::string& id, MediaSource* source, std::string* error) const;
+
+  bool Remove(const std::string& id) const;
+
+  std::string PathFor(const std::string& id) const;
+
+ private:
+  mutable std::mutex mutex_;
+  std::string directory_;
+};
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_DOWNLOAD_STORE_H_
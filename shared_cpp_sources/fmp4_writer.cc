@@ -0,0 +1,339 @@
+#include "fmp4_writer.h"
+
+#include <cstring>
+
+namespace pro_video_player {
+
+namespace {
+
+// tkhd/mvhd identity matrix.
+constexpr uint32_t kMatrix[9] = {0x00010000, 0, 0, 0, 0x00010000, 0, 0, 0, 0x40000000};
+
+// trun sample_flags: sample_depends_on 2 (an I-frame), or 1 plus
+// sample_is_non_sync_sample.
+constexpr uint32_t kSyncSampleFlags = 0x02000000;
+constexpr uint32_t kNonSyncSampleFlags = 0x01010000;
+
+void Put(std::string* out, uint64_t value, int bytes) {
+  for (int i = bytes - 1; i >= 0; --i) out->push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+}
+
+void PutZeros(std::string* out, size_t count) { out->append(count, '\0'); }
+
+// Starts a box whose size End() fills in.
+size_t Begin(std::string* out, const char* type) {
+  const size_t start = out->size();
+  Put(out, 0, 4);
+  out->append(type, 4);
+  return start;
+}
+
+size_t BeginFull(std::string* out, const char* type, uint8_t version, uint32_t flags) {
+  const size_t start = Begin(out, type);
+  Put(out, (static_cast<uint32_t>(version) << 24) | flags, 4);
+  return start;
+}
+
+void Patch(std::string* out, size_t at, uint64_t value, int bytes) {
+  for (int i = 0; i < bytes; ++i) (*out)[at + i] = static_cast<char>((value >> (8 * (bytes - 1 - i))) & 0xff);
+}
+
+void End(std::string* out, size_t start) { Patch(out, start, out->size() - start, 4); }
+
+void PutMatrix(std::string* out) {
+  for (const uint32_t value : kMatrix) Put(out, value, 4);
+}
+
+std::vector<uint8_t> ToBytes(const std::string& box) { return std::vector<uint8_t>(box.begin(), box.end()); }
+
+// MPEG-4 descriptor header; lengths always take four bytes.
+void PutDescriptor(std::string* out, uint8_t tag, size_t length) {
+  out->push_back(static_cast<char>(tag));
+  for (int shift = 21; shift > 0; shift -= 7) out->push_back(static_cast<char>(0x80 | ((length >> shift) & 0x7f)));
+  out->push_back(static_cast<char>(length & 0x7f));
+}
+
+void WriteTrack(std::string* out, uint32_t id, const DemuxedTrack& track) {
+  const bool video = track.kind == DemuxedTrackKind::kVideo;
+  const size_t trak = Begin(out, "trak");
+
+  // Enabled, in movie; durations stay 0: the fragments have them
+  const size_t tkhd = BeginFull(out, "tkhd", 0, 3);
+  PutZeros(out, 8);
+  Put(out, id, 4);
+  PutZeros(out, 4 + 4 + 8);
+  Put(out, 0, 2);  // layer
+  Put(out, 0, 2);  // alternate group
+  Put(out, video ? 0 : 0x0100, 2);
+  PutZeros(out, 2);
+  PutMatrix(out);
+  Put(out, static_cast<uint32_t>(track.width) << 16, 4);
+  Put(out, static_cast<uint32_t>(track.height) << 16, 4);
+  End(out, tkhd);
+
+  const size_t mdia = Begin(out, "mdia");
+  const size_t mdhd = BeginFull(out, "mdhd", 0, 0);
+  PutZeros(out, 8);
+  Put(out, track.timescale, 4);
+  Put(out, 0, 4);
+  uint16_t language = 0;
+  for (size_t i = 0; i < 3; ++i) {
+    const char c = i < track.language.size() ? track.language[i] : 'u';
+    language = static_cast<uint16_t>((language << 5) | ((c - 0x60) & 0x1f));
+  }
+  Put(out, language, 2);
+  Put(out, 0, 2);
+  End(out, mdhd);
+
+  const size_t hdlr = BeginFull(out, "hdlr", 0, 0);
+  Put(out, 0, 4);
+  out->append(video ? "vide" : "soun", 4);
+  PutZeros(out, 12);
+  const char* name = video ? "VideoHandler" : "SoundHandler";
+  out->append(name, std::strlen(name) + 1);
+  End(out, hdlr);
+
+  const size_t minf = Begin(out, "minf");
+  if (video) {
+    const size_t vmhd = BeginFull(out, "vmhd", 0, 1);
+    PutZeros(out, 8);
+    End(out, vmhd);
+  } else {
+    const size_t smhd = BeginFull(out, "smhd", 0, 0);
+    PutZeros(out, 4);
+    End(out, smhd);
+  }
+  const size_t dinf = Begin(out, "dinf");
+  const size_t dref = BeginFull(out, "dref", 0, 0);
+  Put(out, 1, 4);
+  // Self-contained
+  const size_t url = BeginFull(out, "url ", 0, 1);
+  End(out, url);
+  End(out, dref);
+  End(out, dinf);
+
+  const size_t stbl = Begin(out, "stbl");
+  const size_t stsd = BeginFull(out, "stsd", 0, 0);
+  Put(out, 1, 4);
+  out->append(reinterpret_cast<const char*>(track.sample_entry.data()), track.sample_entry.size());
+  End(out, stsd);
+  // Empty tables: every sample is in a fragment
+  for (const char* type : {"stts", "stsc", "stco"}) {
+    const size_t table = BeginFull(out, type, 0, 0);
+    Put(out, 0, 4);
+    End(out, table);
+  }
+  const size_t stsz = BeginFull(out, "stsz", 0, 0);
+  Put(out, 0, 4);
+  Put(out, 0, 4);
+  End(out, stsz);
+  End(out, stbl);
+  End(out, minf);
+  End(out, mdia);
+  End(out, trak);
+}
+
+}  // namespace
+
+int64_t Fmp4Fragment::size() const {
+  int64_t total = static_cast<int64_t>(header.size());
+  for (const auto& range : payload) total += range.size;
+  return total;
+}
+
+std::string BuildFmp4Init(const std::vector<DemuxedTrack>& tracks) {
+  std::string out;
+  const size_t ftyp = Begin(&out, "ftyp");
+  out.append("iso6", 4);
+  Put(&out, 0, 4);
+  out.append("iso6mp41", 8);
+  End(&out, ftyp);
+
+  const size_t moov = Begin(&out, "moov");
+  const size_t mvhd = BeginFull(&out, "mvhd", 0, 0);
+  PutZeros(&out, 8);
+  Put(&out, 1000, 4);
+  Put(&out, 0, 4);
+  Put(&out, 0x00010000, 4);  // rate 1.0
+  Put(&out, 0x0100, 2);      // volume 1.0
+  PutZeros(&out, 10);
+  PutMatrix(&out);
+  PutZeros(&out, 24);
+  Put(&out, tracks.size() + 1, 4);
+  End(&out, mvhd);
+
+  for (size_t i = 0; i < tracks.size(); ++i) WriteTrack(&out, static_cast<uint32_t>(i + 1), tracks[i]);
+
+  const size_t mvex = Begin(&out, "mvex");
+  for (size_t i = 0; i < tracks.size(); ++i) {
+    const size_t trex = BeginFull(&out, "trex", 0, 0);
+    Put(&out, i + 1, 4);
+    Put(&out, 1, 4);  // sample description
+    PutZeros(&out, 12);
+    End(&out, trex);
+  }
+  End(&out, mvex);
+  End(&out, moov);
+  return out;
+}
+
+Fmp4Fragment BuildFmp4Fragment(uint32_t sequence, const std::vector<DemuxedTrack>& tracks,
+                               const std::vector<std::vector<DemuxedSample>>& samples) {
+  Fmp4Fragment fragment;
+  std::string& out = fragment.header;
+  const size_t moof = Begin(&out, "moof");
+  const size_t mfhd = BeginFull(&out, "mfhd", 0, 0);
+  Put(&out, sequence, 4);
+  End(&out, mfhd);
+
+  // trun data offsets are relative to moof: patched once its size is known
+  std::vector<size_t> data_offset_at;
+  std::vector<int64_t> data_offset;
+  int64_t payload = 0;
+  for (size_t t = 0; t < tracks.size() && t < samples.size(); ++t) {
+    const auto& track_samples = samples[t];
+    if (track_samples.empty()) continue;
+    const bool video = tracks[t].kind == DemuxedTrackKind::kVideo;
+    const size_t traf = Begin(&out, "traf");
+    // default-base-is-moof
+    const size_t tfhd = BeginFull(&out, "tfhd", 0, 0x020000);
+    Put(&out, t + 1, 4);
+    End(&out, tfhd);
+    const size_t tfdt = BeginFull(&out, "tfdt", 1, 0);
+    Put(&out, static_cast<uint64_t>(track_samples.front().dts), 8);
+    End(&out, tfdt);
+
+    // Version 1 for signed composition offsets; data offset, then per
+    // sample duration, size, flags and composition offset
+    const size_t trun = BeginFull(&out, "trun", 1, 0x000f01);
+    Put(&out, track_samples.size(), 4);
+    data_offset_at.push_back(out.size());
+    data_offset.push_back(payload);
+    Put(&out, 0, 4);
+    for (const auto& sample : track_samples) {
+      Put(&out, sample.duration, 4);
+      Put(&out, sample.size, 4);
+      Put(&out, !video || sample.keyframe ? kSyncSampleFlags : kNonSyncSampleFlags, 4);
+      Put(&out, static_cast<uint32_t>(sample.composition_offset), 4);
+
+      if (!fragment.payload.empty() &&
+          fragment.payload.back().offset + fragment.payload.back().size == sample.offset) {
+        fragment.payload.back().size += sample.size;
+      } else {
+        fragment.payload.push_back({sample.offset, sample.size});
+      }
+      payload += sample.size;
+    }
+    End(&out, trun);
+    End(&out, traf);
+  }
+  End(&out, moof);
+
+  const bool large = payload + 8 > 0xffffffffLL;
+  const int64_t mdat_header = large ? 16 : 8;
+  const int64_t moof_size = static_cast<int64_t>(out.size());
+  for (size_t i = 0; i < data_offset_at.size(); ++i) {
+    Patch(&out, data_offset_at[i], static_cast<uint64_t>(moof_size + mdat_header + data_offset[i]), 4);
+  }
+  if (large) {
+    Put(&out, 1, 4);
+    out.append("mdat", 4);
+    Put(&out, static_cast<uint64_t>(payload + 16), 8);
+  } else {
+    Put(&out, static_cast<uint64_t>(payload + 8), 4);
+    out.append("mdat", 4);
+  }
+  return fragment;
+}
+
+// ==================== Sample entries ====================
+
+std::vector<uint8_t> Mp4VisualSampleEntry(const char* fourcc, int width, int height, const char* config_type,
+                                          const std::vector<uint8_t>& config) {
+  std::string out;
+  const size_t entry = Begin(&out, fourcc);
+  PutZeros(&out, 6);
+  Put(&out, 1, 2);  // data reference index
+  PutZeros(&out, 16);
+  Put(&out, static_cast<uint32_t>(width), 2);
+  Put(&out, static_cast<uint32_t>(height), 2);
+  Put(&out, 0x00480000, 4);  // 72 dpi
+  Put(&out, 0x00480000, 4);
+  PutZeros(&out, 4);
+  Put(&out, 1, 2);  // frame count
+  PutZeros(&out, 32);
+  Put(&out, 0x0018, 2);  // depth
+  Put(&out, 0xffff, 2);
+  const size_t box = Begin(&out, config_type);
+  out.append(reinterpret_cast<const char*>(config.data()), config.size());
+  End(&out, box);
+  End(&out, entry);
+  return ToBytes(out);
+}
+
+std::vector<uint8_t> Mp4AudioSampleEntry(const char* fourcc, int channels, int sample_rate,
+                                         const std::vector<uint8_t>& config_box) {
+  std::string out;
+  const size_t entry = Begin(&out, fourcc);
+  PutZeros(&out, 6);
+  Put(&out, 1, 2);  // data reference index
+  PutZeros(&out, 8);
+  Put(&out, static_cast<uint32_t>(channels), 2);
+  Put(&out, 16, 2);  // sample size
+  PutZeros(&out, 4);
+  // 16.16; rates past 65535 Hz don't fit and are left to the config
+  Put(&out, sample_rate <= 0xffff ? static_cast<uint32_t>(sample_rate) << 16 : 0, 4);
+  out.append(reinterpret_cast<const char*>(config_box.data()), config_box.size());
+  End(&out, entry);
+  return ToBytes(out);
+}
+
+std::vector<uint8_t> Mp4EsdsBox(const std::vector<uint8_t>& audio_specific_config) {
+  // ES_Descriptor > DecoderConfigDescriptor > DecoderSpecificInfo, then
+  // SLConfigDescriptor; each header is 5 bytes
+  const size_t specific = audio_specific_config.size();
+  const size_t decoder_config = 13 + 5 + specific;
+  const size_t es = 3 + 5 + decoder_config + 5 + 1;
+  std::string out;
+  const size_t esds = BeginFull(&out, "esds", 0, 0);
+  PutDescriptor(&out, 0x03, es);
+  Put(&out, 0, 2);  // ES_ID
+  Put(&out, 0, 1);
+  PutDescriptor(&out, 0x04, decoder_config);
+  Put(&out, 0x40, 1);  // MPEG-4 audio
+  Put(&out, 0x15, 1);  // audio stream
+  PutZeros(&out, 3 + 4 + 4);
+  PutDescriptor(&out, 0x05, specific);
+  out.append(reinterpret_cast<const char*>(audio_specific_config.data()), specific);
+  PutDescriptor(&out, 0x06, 1);
+  Put(&out, 0x02, 1);
+  End(&out, esds);
+  return ToBytes(out);
+}
+
+bool Mp4OpusBox(const std::vector<uint8_t>& opus_head, std::vector<uint8_t>* box) {
+  // "OpusHead", version, channels, pre-skip (LE), rate (LE), gain (LE),
+  // mapping family, [mapping table]
+  if (opus_head.size() < 19 || std::memcmp(opus_head.data(), "OpusHead", 8) != 0) return false;
+  auto little = [&opus_head](size_t at, int bytes) {
+    uint32_t value = 0;
+    for (int i = bytes - 1; i >= 0; --i) value = (value << 8) | opus_head[at + i];
+    return value;
+  };
+  std::string out;
+  const size_t dops = Begin(&out, "dOps");
+  Put(&out, 0, 1);
+  Put(&out, opus_head[9], 1);
+  Put(&out, little(10, 2), 2);
+  Put(&out, little(12, 4), 4);
+  Put(&out, little(16, 2), 2);
+  Put(&out, opus_head[18], 1);
+  if (opus_head[18] != 0) {
+    out.append(reinterpret_cast<const char*>(opus_head.data()) + 19, opus_head.size() - 19);
+  }
+  End(&out, dops);
+  *box = ToBytes(out);
+  return true;
+}
+
+}  // namespace pro_video_player
@@ -0,0 +1,61 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_FMP4_WRITER_H_
+#define PRO_VIDEO_PLAYER_SHARED_FMP4_WRITER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "media_demuxer.h"
+
+namespace pro_video_player {
+
+// Bytes of the source file that go into a fragment's mdat as they are.
+struct FileRange {
+  int64_t offset = 0;
+  int64_t size = 0;
+};
+
+// A media fragment that references its payload instead of holding it:
+// |header| (moof, then the mdat header) followed by |payload|, read from the
+// source file in order.
+struct Fmp4Fragment {
+  std::string header;
+  // Adjacent samples are merged into one range.
+  std::vector<FileRange> payload;
+
+  int64_t size() const;
+};
+
+// Initialization segment (ftyp, moov with mvex) for |tracks|, numbered from
+// 1 in order.
+std::string BuildFmp4Init(const std::vector<DemuxedTrack>& tracks);
+
+// Media fragment |sequence| (from 1) with |samples| per track, in the order
+// of BuildFmp4Init()'s tracks; tracks without samples are left out. Decode
+// times carry over into tfdt, so fragments needn't start at 0.
+Fmp4Fragment BuildFmp4Fragment(uint32_t sequence, const std::vector<DemuxedTrack>& tracks,
+                               const std::vector<std::vector<DemuxedSample>>& samples);
+
+// ==================== Sample entries ====================
+// For demuxers of containers without ISO BMFF sample descriptions.
+
+// VisualSampleEntry |fourcc| ("avc1", ...) with one decoder configuration
+// box, e.g. "avcC" holding an AVCDecoderConfigurationRecord.
+std::vector<uint8_t> Mp4VisualSampleEntry(const char* fourcc, int width, int height, const char* config_type,
+                                          const std::vector<uint8_t>& config);
+
+// AudioSampleEntry |fourcc| ("mp4a", "Opus") around a complete box
+// (Mp4EsdsBox(), Mp4OpusBox()).
+std::vector<uint8_t> Mp4AudioSampleEntry(const char* fourcc, int channels, int sample_rate,
+                                         const std::vector<uint8_t>& config_box);
+
+// esds of an MPEG-4 audio track from its AudioSpecificConfig.
+std::vector<uint8_t> Mp4EsdsBox(const std::vector<uint8_t>& audio_specific_config);
+
+// dOps from an Ogg "OpusHead" header. False if it isn't one.
+bool Mp4OpusBox(const std::vector<uint8_t>& opus_head, std::vector<uint8_t>* box);
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_FMP4_WRITER_H_
@@ -0,0 +1,82 @@
+#include "frame_buffer_pool.h"
+
+namespace pro_video_player {
+
+FrameBuffer::FrameBuffer(size_t size)
+    : storage_(new uint8_t[size + kAlignment - 1]), size_(size) {
+  const uintptr_t address = reinterpret_cast<uintptr_t>(storage_.get());
+  data_ = storage_.get() + ((kAlignment - address % kAlignment) % kAlignment);
+}
+
+std::shared_ptr<FrameBufferPool> FrameBufferPool::Create(size_t max_buffers) {
+  return std::shared_ptr<FrameBufferPool>(new FrameBufferPool(max_buffers == 0 ? 1 : max_buffers));
+}
+
+FrameBufferPool::FrameBufferPool(size_t max_buffers) : max_buffers_(max_buffers) {}
+
+std::shared_ptr<FrameBuffer> FrameBufferPool::Acquire(size_t size) {
+  std::unique_ptr<FrameBuffer> buffer;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (size != buffer_size_) {
+      // Resolution change: idle buffers are useless, in-flight ones are
+      // freed on release
+      allocated_ -= idle_.size();
+      idle_.clear();
+      buffer_size_ = size;
+    }
+    if (!idle_.empty()) {
+      buffer = std::move(idle_.back());
+      idle_.pop_back();
+    } else if (allocated_ < max_buffers_) {
+      ++allocated_;
+    } else {
+      return nullptr;
+    }
+  }
+  // Allocated outside the lock; a 4K RGBA frame is 33 MB
+  if (buffer == nullptr) buffer = std::make_unique<FrameBuffer>(size);
+
+  std::weak_ptr<FrameBufferPool> weak_pool = weak_from_this();
+  return std::shared_ptr<FrameBuffer>(buffer.release(), [weak_pool](FrameBuffer* released) {
+    if (auto pool = weak_pool.lock()) {
+      pool->Release(released);
+    } else {
+      delete released;
+    }
+  });
+}
+
+void FrameBufferPool::Release(FrameBuffer* buffer) {
+  std::unique_ptr<FrameBuffer> owned(buffer);
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (owned->size() == buffer_size_) {
+    idle_.push_back(std::move(owned));
+  } else {
+    --allocated_;
+  }
+}
+
+size_t FrameBufferPool::allocated() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return allocated_;
+}
+
+size_t FrameBufferPool::available() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return idle_.size();
+}
+
+size_t FrameBufferPool::Trim() {
+  std::vector<std::unique_ptr<FrameBuffer>> idle;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle.swap(idle_);
+    allocated_ -= idle.size();
+  }
+  size_t freed = 0;
+  for (const auto& buffer : idle) freed += buffer->size();
+  return freed;
+}
+
+}  // namespace pro_video_player
@@ -0,0 +1,77 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_FRAME_BUFFER_POOL_H_
+#define PRO_VIDEO_PLAYER_SHARED_FRAME_BUFFER_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace pro_video_player {
+
+// A 64-byte aligned pixel buffer, as software renderers want for SIMD.
+class FrameBuffer {
+ public:
+  static constexpr size_t kAlignment = 64;
+
+  explicit FrameBuffer(size_t size);
+
+  FrameBuffer(const FrameBuffer&) = delete;
+  FrameBuffer& operator=(const FrameBuffer&) = delete;
+
+  uint8_t* data() { return data_; }
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  std::unique_ptr<uint8_t[]> storage_;
+  uint8_t* data_;
+  size_t size_;
+};
+
+// Fixed-size set of frame buffers recycled between a renderer and the
+// texture that displays them.
+//
+// Acquire() hands out a buffer whose shared_ptr returns it to the pool when
+// the last reference (usually the texture's) goes away, so steady-state
+// playback allocates nothing. Buffers of a previous size are freed instead
+// of recycled, which makes resolution changes self-cleaning.
+class FrameBufferPool : public std::enable_shared_from_this<FrameBufferPool> {
+ public:
+  // Triple buffering: one being rendered, one queued, one displayed.
+  static constexpr size_t kDefaultMaxBuffers = 3;
+
+  static std::shared_ptr<FrameBufferPool> Create(size_t max_buffers = kDefaultMaxBuffers);
+
+  FrameBufferPool(const FrameBufferPool&) = delete;
+  FrameBufferPool& operator=(const FrameBufferPool&) = delete;
+
+  // Returns a buffer of exactly |size| bytes, or nullptr if |max_buffers|
+  // are already in flight; the consumer is behind and the frame should be
+  // skipped. Thread-safe.
+  std::shared_ptr<FrameBuffer> Acquire(size_t size);
+
+  // Buffers currently allocated (in flight + idle).
+  size_t allocated() const;
+  // Idle buffers ready for reuse.
+  size_t available() const;
+
+  // Frees the idle buffers (memory pressure); the next frames allocate
+  // again. Returns the bytes freed.
+  size_t Trim();
+
+ private:
+  explicit FrameBufferPool(size_t max_buffers);
+
+  void Release(FrameBuffer* buffer);
+
+  const size_t max_buffers_;
+  mutable std::mutex mutex_;
+  size_t buffer_size_ = 0;
+  size_t allocated_ = 0;
+  std::vector<std::unique_ptr<FrameBuffer>> idle_;
+};
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_FRAME_BUFFER_POOL_H_
@@ -0,0 +1,606 @@
+#include "frame_capture.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+
+#include "download_store.h"
+
+namespace pro_video_player {
+
+namespace {
+
+// ==================== Deflate (for PNG) ====================
+
+// Deflate writes bits starting at the least significant end of a byte.
+class LsbBitWriter {
+ public:
+  explicit LsbBitWriter(std::vector<uint8_t>* out) : out_(out) {}
+
+  void Put(uint32_t bits, int count) {
+    buffer_ |= static_cast<uint64_t>(bits) << filled_;
+    filled_ += count;
+    while (filled_ >= 8) {
+      out_->push_back(static_cast<uint8_t>(buffer_));
+      buffer_ >>= 8;
+      filled_ -= 8;
+    }
+  }
+
+  // Huffman codes go most significant bit first.
+  void PutCode(uint32_t code, int length) {
+    uint32_t reversed = 0;
+    for (int i = 0; i < length; ++i) reversed |= ((code >> i) & 1) << (length - 1 - i);
+    Put(reversed, length);
+  }
+
+  void Flush() {
+    if (filled_ > 0) out_->push_back(static_cast<uint8_t>(buffer_));
+    buffer_ = 0;
+    filled_ = 0;
+  }
+
+ private:
+  std::vector<uint8_t>* out_;
+  uint64_t buffer_ = 0;
+  int filled_ = 0;
+};
+
+constexpr int kLengthBase[] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                               31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+constexpr int kLengthExtra[] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+constexpr int kDistanceBase[] = {1,    2,    3,    4,    5,    7,     9,     13,    17,    25,
+                                 33,   49,   65,   97,   129,  193,   257,   385,   513,   769,
+                                 1025, 1537, 2049, 3073, 4097, 6145,  8193,  12289, 16385, 24577};
+constexpr int kDistanceExtra[] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6,
+                                  6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+// Literal/length symbol in the fixed Huffman code (RFC 1951 3.2.6).
+void PutFixedSymbol(LsbBitWriter* writer, int symbol) {
+  if (symbol < 144) {
+    writer->PutCode(0x30 + symbol, 8);
+  } else if (symbol < 256) {
+    writer->PutCode(0x190 + symbol - 144, 9);
+  } else if (symbol < 280) {
+    writer->PutCode(symbol - 256, 7);
+  } else {
+    writer->PutCode(0xc0 + symbol - 280, 8);
+  }
+}
+
+void PutMatch(LsbBitWriter* writer, int length, int distance) {
+  int code = 28;
+  while (kLengthBase[code] > length) --code;
+  PutFixedSymbol(writer, 257 + code);
+  writer->Put(length - kLengthBase[code], kLengthExtra[code]);
+  code = 29;
+  while (kDistanceBase[code] > distance) --code;
+  writer->PutCode(code, 5);
+  writer->Put(distance - kDistanceBase[code], kDistanceExtra[code]);
+}
+
+// zlib stream of |data| in one fixed-Huffman block, with hash-chained
+// LZ77 matching. Filtered image rows compress close to what dynamic codes
+// would give, and the encoder stays small.
+std::vector<uint8_t> Zlib(const std::vector<uint8_t>& data) {
+  constexpr int kWindow = 32768;
+  constexpr int kHashBits = 15;
+  constexpr int kMaxChain = 32;
+  constexpr int kMinMatch = 3;
+  constexpr int kMaxMatch = 258;
+
+  std::vector<uint8_t> out = {0x78, 0x01};
+  LsbBitWriter writer(&out);
+  // BFINAL, fixed codes
+  writer.Put(1, 1);
+  writer.Put(1, 2);
+
+  const int64_t size = static_cast<int64_t>(data.size());
+  std::vector<int64_t> head(size_t{1} << kHashBits, -1);
+  std::vector<int64_t> previous(kWindow, -1);
+  const auto hash = [&data](int64_t at) {
+    return ((data[at] << 10) ^ (data[at + 1] << 5) ^ data[at + 2]) & ((1 << kHashBits) - 1);
+  };
+  const auto insert = [&](int64_t at) {
+    if (at + kMinMatch > size) return;
+    const int h = hash(at);
+    previous[at & (kWindow - 1)] = head[h];
+    head[h] = at;
+  };
+
+  int64_t at = 0;
+  while (at < size) {
+    int best_length = 0;
+    int64_t best_distance = 0;
+    if (at + kMinMatch <= size) {
+      const int64_t limit = std::min<int64_t>(kMaxMatch, size - at);
+      int64_t candidate = head[hash(at)];
+      for (int chain = 0; candidate >= 0 && at - candidate <= kWindow && chain < kMaxChain; ++chain) {
+        int length = 0;
+        while (length < limit && data[candidate + length] == data[at + length]) ++length;
+        if (length > best_length) {
+          best_length = length;
+          best_distance = at - candidate;
+          if (length == limit) break;
+        }
+        candidate = previous[candidate & (kWindow - 1)];
+      }
+    }
+    if (best_length >= kMinMatch) {
+      PutMatch(&writer, best_length, static_cast<int>(best_distance));
+      for (int i = 0; i < best_length; ++i) insert(at + i);
+      at += best_length;
+    } else {
+      PutFixedSymbol(&writer, data[at]);
+      insert(at);
+      ++at;
+    }
+  }
+  PutFixedSymbol(&writer, 256);
+  writer.Flush();
+
+  uint32_t a = 1;
+  uint32_t b = 0;
+  for (const uint8_t byte : data) {
+    a = (a + byte) % 65521;
+    b = (b + a) % 65521;
+  }
+  const uint32_t adler = (b << 16) | a;
+  for (int shift = 24; shift >= 0; shift -= 8) out.push_back(static_cast<uint8_t>(adler >> shift));
+  return out;
+}
+
+// ==================== PNG ====================
+
+void PutBe32(std::vector<uint8_t>* out, uint32_t value) {
+  for (int shift = 24; shift >= 0; shift -= 8) out->push_back(static_cast<uint8_t>(value >> shift));
+}
+
+void PutPngChunk(std::vector<uint8_t>* out, const char* type, const std::vector<uint8_t>& data) {
+  PutBe32(out, static_cast<uint32_t>(data.size()));
+  const size_t start = out->size();
+  out->insert(out->end(), type, type + 4);
+  out->insert(out->end(), data.begin(), data.end());
+  PutBe32(out, Crc32(out->data() + start, out->size() - start));
+}
+
+uint8_t Paeth(int left, int up, int up_left) {
+  const int estimate = left + up - up_left;
+  const int to_left = std::abs(estimate - left);
+  const int to_up = std::abs(estimate - up);
+  const int to_up_left = std::abs(estimate - up_left);
+  if (to_left <= to_up && to_left <= to_up_left) return static_cast<uint8_t>(left);
+  return static_cast<uint8_t>(to_up <= to_up_left ? up : up_left);
+}
+
+// Rows with a filter byte each: whichever of the five filters gives the
+// smallest sum of absolute differences, the usual heuristic.
+std::vector<uint8_t> FilterRows(const std::vector<uint8_t>& pixels, int width, int height, int channels) {
+  const size_t row_bytes = static_cast<size_t>(width) * channels;
+  const std::vector<uint8_t> zero_row(row_bytes, 0);
+  std::vector<uint8_t> filtered;
+  filtered.reserve((row_bytes + 1) * height);
+  std::array<std::vector<uint8_t>, 5> candidates;
+  for (auto& candidate : candidates) candidate.resize(row_bytes);
+  for (int y = 0; y < height; ++y) {
+    const uint8_t* row = pixels.data() + y * row_bytes;
+    const uint8_t* up = y > 0 ? row - row_bytes : zero_row.data();
+    for (size_t i = 0; i < row_bytes; ++i) {
+      const int left = i >= static_cast<size_t>(channels) ? row[i - channels] : 0;
+      const int up_left = i >= static_cast<size_t>(channels) ? up[i - channels] : 0;
+      candidates[0][i] = row[i];
+      candidates[1][i] = static_cast<uint8_t>(row[i] - left);
+      candidates[2][i] = static_cast<uint8_t>(row[i] - up[i]);
+      candidates[3][i] = static_cast<uint8_t>(row[i] - ((left + up[i]) >> 1));
+      candidates[4][i] = static_cast<uint8_t>(row[i] - Paeth(left, up[i], up_left));
+    }
+    size_t best = 0;
+    uint64_t best_cost = UINT64_MAX;
+    for (size_t filter = 0; filter < candidates.size(); ++filter) {
+      uint64_t cost = 0;
+      for (const uint8_t byte : candidates[filter]) cost += static_cast<uint64_t>(std::abs(static_cast<int8_t>(byte)));
+      if (cost < best_cost) {
+        best_cost = cost;
+        best = filter;
+      }
+    }
+    filtered.push_back(static_cast<uint8_t>(best));
+    filtered.insert(filtered.end(), candidates[best].begin(), candidates[best].end());
+  }
+  return filtered;
+}
+
+// ==================== JPEG ====================
+
+constexpr uint8_t kZigzag[64] = {0,  1,  8,  16, 9,  2,  3,  10, 17, 24, 32, 25, 18, 11, 4,  5,
+                                 12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6,  7,  14, 21, 28,
+                                 35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+                                 58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63};
+
+// ITU T.81 Annex K quantization tables, in natural order.
+constexpr uint8_t kLumaQuant[64] = {16, 11, 10, 16, 24,  40,  51,  61,  12, 12, 14, 19, 26,  58,  60,  55,
+                                    14, 13, 16, 24, 40,  57,  69,  56,  14, 17, 22, 29, 51,  87,  80,  62,
+                                    18, 22, 37, 56, 68,  109, 103, 77,  24, 35, 55, 64, 81,  104, 113, 92,
+                                    49, 64, 78, 87, 103, 121, 120, 101, 72, 92, 95, 98, 112, 100, 103, 99};
+constexpr uint8_t kChromaQuant[64] = {17, 18, 24, 47, 99, 99, 99, 99, 18, 21, 26, 66, 99, 99, 99, 99,
+                                      24, 26, 56, 99, 99, 99, 99, 99, 47, 66, 99, 99, 99, 99, 99, 99,
+                                      99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+                                      99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99};
+
+// Annex K Huffman tables: code counts per length 1..16, then the symbols.
+struct HuffmanSpec {
+  uint8_t counts[16];
+  std::vector<uint8_t> symbols;
+};
+
+const HuffmanSpec& LumaDcSpec() {
+  static const HuffmanSpec spec{{0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0},
+                                {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}};
+  return spec;
+}
+
+const HuffmanSpec& ChromaDcSpec() {
+  static const HuffmanSpec spec{{0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0},
+                                {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}};
+  return spec;
+}
+
+const HuffmanSpec& LumaAcSpec() {
+  static const HuffmanSpec spec{
+      {0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7d},
+      {0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07, 0x22, 0x71,
+       0x14, 0x32, 0x81, 0x91, 0xa1, 0x08, 0x23, 0x42, 0xb1, 0xc1, 0x15, 0x52, 0xd1, 0xf0, 0x24, 0x33, 0x62, 0x72,
+       0x82, 0x09, 0x0a, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x34, 0x35, 0x36, 0x37,
+       0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59,
+       0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x83,
+       0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3,
+       0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3,
+       0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe1, 0xe2,
+       0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa}};
+  return spec;
+}
+
+const HuffmanSpec& ChromaAcSpec() {
+  static const HuffmanSpec spec{
+      {0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 0x77},
+      {0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71, 0x13, 0x22,
+       0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xa1, 0xb1, 0xc1, 0x09, 0x23, 0x33, 0x52, 0xf0, 0x15, 0x62, 0x72, 0xd1,
+       0x0a, 0x16, 0x24, 0x34, 0xe1, 0x25, 0xf1, 0x17, 0x18, 0x19, 0x1a, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x35, 0x36,
+       0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58,
+       0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a,
+       0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a,
+       0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba,
+       0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda,
+       0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa}};
+  return spec;
+}
+
+// Code and length per symbol.
+struct HuffmanTable {
+  std::array<uint16_t, 256> code{};
+  std::array<uint8_t, 256> length{};
+};
+
+HuffmanTable BuildHuffmanTable(const HuffmanSpec& spec) {
+  HuffmanTable table;
+  uint16_t code = 0;
+  size_t next = 0;
+  for (int length = 1; length <= 16; ++length) {
+    for (int i = 0; i < spec.counts[length - 1]; ++i) {
+      table.code[spec.symbols[next]] = code++;
+      table.length[spec.symbols[next]] = static_cast<uint8_t>(length);
+      ++next;
+    }
+    code = static_cast<uint16_t>(code << 1);
+  }
+  return table;
+}
+
+// Entropy-coded data: most significant bit first, 0xff stuffed.
+class MsbBitWriter {
+ public:
+  explicit MsbBitWriter(std::vector<uint8_t>* out) : out_(out) {}
+
+  void Put(uint32_t bits, int count) {
+    buffer_ = (buffer_ << count) | (bits & ((1u << count) - 1));
+    filled_ += count;
+    while (filled_ >= 8) {
+      const uint8_t byte = static_cast<uint8_t>(buffer_ >> (filled_ - 8));
+      out_->push_back(byte);
+      if (byte == 0xff) out_->push_back(0);
+      filled_ -= 8;
+    }
+    buffer_ &= (1u << filled_) - 1;
+  }
+
+  void Put(const HuffmanTable& table, int symbol) { Put(table.code[symbol], table.length[symbol]); }
+
+  // Pads the last byte with ones.
+  void Flush() {
+    if (filled_ > 0) Put((1u << (8 - filled_)) - 1, 8 - filled_);
+  }
+
+ private:
+  std::vector<uint8_t>* out_;
+  uint32_t buffer_ = 0;
+  int filled_ = 0;
+};
+
+// Bits needed for |value|'s magnitude (the JPEG size category).
+int Category(int value) {
+  int magnitude = std::abs(value);
+  int bits = 0;
+  while (magnitude > 0) {
+    ++bits;
+    magnitude >>= 1;
+  }
+  return bits;
+}
+
+// Negative values are sent as value - 1 in |category| bits.
+void PutAmplitude(MsbBitWriter* writer, int value, int category) {
+  if (category > 0) writer->Put(static_cast<uint32_t>(value < 0 ? value + (1 << category) - 1 : value), category);
+}
+
+struct JpegTables {
+  // Cosine basis with the DCT's C(u) / 2 folded in: [frequency][sample]
+  float basis[8][8];
+  HuffmanTable dc[2];
+  HuffmanTable ac[2];
+};
+
+const JpegTables& Tables() {
+  static const JpegTables tables = []() {
+    JpegTables result;
+    const double pi = std::acos(-1.0);
+    for (int u = 0; u < 8; ++u) {
+      const double scale = (u == 0 ? std::sqrt(0.5) : 1.0) / 2;
+      for (int x = 0; x < 8; ++x) result.basis[u][x] = static_cast<float>(scale * std::cos((2 * x + 1) * u * pi / 16));
+    }
+    result.dc[0] = BuildHuffmanTable(LumaDcSpec());
+    result.dc[1] = BuildHuffmanTable(ChromaDcSpec());
+    result.ac[0] = BuildHuffmanTable(LumaAcSpec());
+    result.ac[1] = BuildHuffmanTable(ChromaAcSpec());
+    return result;
+  }();
+  return tables;
+}
+
+// Forward DCT, quantization and entropy coding of one 8x8 block of
+// level-shifted samples. |table| is 0 for luma, 1 for chroma.
+void EncodeBlock(const float (&samples)[64], const uint8_t (&quant)[64], int table, int* previous_dc,
+                 MsbBitWriter* writer) {
+  const JpegTables& tables = Tables();
+  float rows[64];
+  for (int y = 0; y < 8; ++y) {
+    for (int u = 0; u < 8; ++u) {
+      float sum = 0;
+      for (int x = 0; x < 8; ++x) sum += samples[y * 8 + x] * tables.basis[u][x];
+      rows[y * 8 + u] = sum;
+    }
+  }
+  int coefficients[64];
+  for (int v = 0; v < 8; ++v) {
+    for (int u = 0; u < 8; ++u) {
+      float sum = 0;
+      for (int y = 0; y < 8; ++y) sum += rows[y * 8 + u] * tables.basis[v][y];
+      coefficients[v * 8 + u] = static_cast<int>(std::lround(sum / quant[v * 8 + u]));
+    }
+  }
+
+  const int difference = coefficients[0] - *previous_dc;
+  *previous_dc = coefficients[0];
+  int category = Category(difference);
+  writer->Put(tables.dc[table], category);
+  PutAmplitude(writer, difference, category);
+
+  int run = 0;
+  for (int k = 1; k < 64; ++k) {
+    const int value = coefficients[kZigzag[k]];
+    if (value == 0) {
+      ++run;
+      continue;
+    }
+    for (; run > 15; run -= 16) writer->Put(tables.ac[table], 0xf0);
+    category = Category(value);
+    writer->Put(tables.ac[table], (run << 4) | category);
+    PutAmplitude(writer, value, category);
+    run = 0;
+  }
+  if (run > 0) writer->Put(tables.ac[table], 0x00);
+}
+
+void PutMarker(std::vector<uint8_t>* out, uint8_t marker, const std::vector<uint8_t>& payload) {
+  out->push_back(0xff);
+  out->push_back(marker);
+  const size_t length = payload.size() + 2;
+  out->push_back(static_cast<uint8_t>(length >> 8));
+  out->push_back(static_cast<uint8_t>(length));
+  out->insert(out->end(), payload.begin(), payload.end());
+}
+
+void AppendHuffmanSpec(std::vector<uint8_t>* payload, uint8_t table_class_and_id, const HuffmanSpec& spec) {
+  payload->push_back(table_class_and_id);
+  payload->insert(payload->end(), spec.counts, spec.counts + 16);
+  payload->insert(payload->end(), spec.symbols.begin(), spec.symbols.end());
+}
+
+}  // namespace
+
+std::vector<uint8_t> ScaleFrameToRgba(const VideoFrame& frame, int max_width, int* width, int* height) {
+  *width = 0;
+  *height = 0;
+  const int source_width = frame.width;
+  const int source_height = frame.height;
+  if (frame.data == nullptr || source_width <= 0 || source_height <= 0 || frame.stride < source_width * 4) {
+    return std::vector<uint8_t>();
+  }
+  const int target_width = max_width > 0 && max_width < source_width ? max_width : source_width;
+  const int target_height = std::max<int>(
+      1, static_cast<int>((static_cast<int64_t>(source_height) * target_width + source_width / 2) / source_width));
+  const bool bgra = frame.format == PixelFormat::kBgra;
+  const bool opaque = frame.format == PixelFormat::kRgbx;
+
+  std::vector<uint8_t> rgba(static_cast<size_t>(target_width) * target_height * 4);
+  uint8_t* out = rgba.data();
+  for (int y = 0; y < target_height; ++y) {
+    const int y0 = static_cast<int>(static_cast<int64_t>(y) * source_height / target_height);
+    const int y1 = std::max(y0 + 1, static_cast<int>(static_cast<int64_t>(y + 1) * source_height / target_height));
+    for (int x = 0; x < target_width; ++x) {
+      const int x0 = static_cast<int>(static_cast<int64_t>(x) * source_width / target_width);
+      const int x1 = std::max(x0 + 1, static_cast<int>(static_cast<int64_t>(x + 1) * source_width / target_width));
+      // Box filter: the mean of the source pixels this one covers
+      uint32_t sums[4] = {0, 0, 0, 0};
+      for (int sy = y0; sy < y1; ++sy) {
+        const uint8_t* pixel = frame.data + static_cast<size_t>(sy) * frame.stride + static_cast<size_t>(x0) * 4;
+        for (int sx = x0; sx < x1; ++sx, pixel += 4) {
+          for (int c = 0; c < 4; ++c) sums[c] += pixel[c];
+        }
+      }
+      const uint32_t count = static_cast<uint32_t>((y1 - y0) * (x1 - x0));
+      out[0] = static_cast<uint8_t>((sums[bgra ? 2 : 0] + count / 2) / count);
+      out[1] = static_cast<uint8_t>((sums[1] + count / 2) / count);
+      out[2] = static_cast<uint8_t>((sums[bgra ? 0 : 2] + count / 2) / count);
+      out[3] = opaque ? 255 : static_cast<uint8_t>((sums[3] + count / 2) / count);
+      out += 4;
+    }
+  }
+  *width = target_width;
+  *height = target_height;
+  return rgba;
+}
+
+std::vector<uint8_t> EncodePng(const uint8_t* rgba, int width, int height) {
+  const size_t pixel_count = static_cast<size_t>(width) * height;
+  bool has_alpha = false;
+  for (size_t i = 0; i < pixel_count && !has_alpha; ++i) has_alpha = rgba[i * 4 + 3] != 255;
+  const int channels = has_alpha ? 4 : 3;
+  std::vector<uint8_t> pixels;
+  if (has_alpha) {
+    pixels.assign(rgba, rgba + pixel_count * 4);
+  } else {
+    pixels.resize(pixel_count * 3);
+    for (size_t i = 0; i < pixel_count; ++i) std::copy(rgba + i * 4, rgba + i * 4 + 3, pixels.begin() + i * 3);
+  }
+
+  std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+  std::vector<uint8_t> header;
+  PutBe32(&header, static_cast<uint32_t>(width));
+  PutBe32(&header, static_cast<uint32_t>(height));
+  // 8 bits, RGB or RGBA, deflate, adaptive filtering, no interlacing
+  header.insert(header.end(), {8, static_cast<uint8_t>(has_alpha ? 6 : 2), 0, 0, 0});
+  PutPngChunk(&png, "IHDR", header);
+  PutPngChunk(&png, "IDAT", Zlib(FilterRows(pixels, width, height, channels)));
+  PutPngChunk(&png, "IEND", std::vector<uint8_t>());
+  return png;
+}
+
+std::vector<uint8_t> EncodeJpeg(const uint8_t* rgba, int width, int height, int quality) {
+  quality = std::clamp(quality, 1, 100);
+  // IJG scaling of the Annex K tables
+  const int scale = quality < 50 ? 5000 / quality : 200 - quality * 2;
+  uint8_t quant[2][64];
+  for (int i = 0; i < 64; ++i) {
+    quant[0][i] = static_cast<uint8_t>(std::clamp((kLumaQuant[i] * scale + 50) / 100, 1, 255));
+    quant[1][i] = static_cast<uint8_t>(std::clamp((kChromaQuant[i] * scale + 50) / 100, 1, 255));
+  }
+
+  std::vector<uint8_t> jpeg = {0xff, 0xd8};
+  PutMarker(&jpeg, 0xe0, {'J', 'F', 'I', 'F', 0, 1, 1, 0, 0, 1, 0, 1, 0, 0});
+  std::vector<uint8_t> payload;
+  for (uint8_t id = 0; id < 2; ++id) {
+    payload.push_back(id);
+    for (int i = 0; i < 64; ++i) payload.push_back(quant[id][kZigzag[i]]);
+  }
+  PutMarker(&jpeg, 0xdb, payload);
+  // 8 bits; Y sampled 2x2 against Cb and Cr
+  PutMarker(&jpeg, 0xc0,
+            {8, static_cast<uint8_t>(height >> 8), static_cast<uint8_t>(height), static_cast<uint8_t>(width >> 8),
+             static_cast<uint8_t>(width), 3, 1, 0x22, 0, 2, 0x11, 1, 3, 0x11, 1});
+  payload.clear();
+  AppendHuffmanSpec(&payload, 0x00, LumaDcSpec());
+  AppendHuffmanSpec(&payload, 0x10, LumaAcSpec());
+  AppendHuffmanSpec(&payload, 0x01, ChromaDcSpec());
+  AppendHuffmanSpec(&payload, 0x11, ChromaAcSpec());
+  PutMarker(&jpeg, 0xc4, payload);
+  PutMarker(&jpeg, 0xda, {3, 1, 0x00, 2, 0x11, 3, 0x11, 0, 63, 0});
+
+  MsbBitWriter writer(&jpeg);
+  int previous_dc[3] = {0, 0, 0};
+  float y_plane[16 * 16];
+  float cb_plane[16 * 16];
+  float cr_plane[16 * 16];
+  for (int mcu_y = 0; mcu_y < height; mcu_y += 16) {
+    for (int mcu_x = 0; mcu_x < width; mcu_x += 16) {
+      // Edge pixels are repeated into partial MCUs
+      for (int y = 0; y < 16; ++y) {
+        const int sy = std::min(mcu_y + y, height - 1);
+        for (int x = 0; x < 16; ++x) {
+          const int sx = std::min(mcu_x + x, width - 1);
+          const uint8_t* pixel = rgba + (static_cast<size_t>(sy) * width + sx) * 4;
+          const float r = pixel[0];
+          const float g = pixel[1];
+          const float b = pixel[2];
+          y_plane[y * 16 + x] = 0.299f * r + 0.587f * g + 0.114f * b - 128;
+          cb_plane[y * 16 + x] = -0.168736f * r - 0.331264f * g + 0.5f * b;
+          cr_plane[y * 16 + x] = 0.5f * r - 0.418688f * g - 0.081312f * b;
+        }
+      }
+      float block[64];
+      for (int by = 0; by < 16; by += 8) {
+        for (int bx = 0; bx < 16; bx += 8) {
+          for (int y = 0; y < 8; ++y) {
+            for (int x = 0; x < 8; ++x) block[y * 8 + x] = y_plane[(by + y) * 16 + bx + x];
+          }
+          EncodeBlock(block, quant[0], 0, &previous_dc[0], &writer);
+        }
+      }
+      const float* chroma_planes[2] = {cb_plane, cr_plane};
+      for (int plane = 0; plane < 2; ++plane) {
+        const float* samples = chroma_planes[plane];
+        for (int y = 0; y < 8; ++y) {
+          for (int x = 0; x < 8; ++x) {
+            const int at = y * 2 * 16 + x * 2;
+            block[y * 8 + x] = (samples[at] + samples[at + 1] + samples[at + 16] + samples[at + 17]) / 4;
+          }
+        }
+        EncodeBlock(block, quant[1], 1, &previous_dc[plane + 1], &writer);
+      }
+    }
+  }
+  writer.Flush();
+  jpeg.push_back(0xff);
+  jpeg.push_back(0xd9);
+  return jpeg;
+}
+
+void EncodeRgba(std::vector<uint8_t> rgba, int width, int height, CaptureFormat format, CapturedFrame* captured) {
+  captured->width = width;
+  captured->height = height;
+  captured->format = format;
+  switch (format) {
+    case CaptureFormat::kPng:
+      captured->bytes = EncodePng(rgba.data(), width, height);
+      break;
+    case CaptureFormat::kJpeg:
+      captured->bytes = EncodeJpeg(rgba.data(), width, height);
+      break;
+    case CaptureFormat::kRaw:
+      captured->bytes = std::move(rgba);
+      break;
+  }
+}
+
+bool EncodeFrame(const VideoFrame& frame, int max_width, CaptureFormat format, CapturedFrame* captured) {
+  int width = 0;
+  int height = 0;
+  std::vector<uint8_t> rgba = ScaleFrameToRgba(frame, max_width, &width, &height);
+  if (rgba.empty()) return false;
+  EncodeRgba(std::move(rgba), width, height, format, captured);
+  captured->pts_ms = frame.pts_ms;
+  return true;
+}
+
+}  // namespace pro_video_player
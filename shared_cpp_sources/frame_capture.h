@@ -0,0 +1,48 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_FRAME_CAPTURE_H_
+#define PRO_VIDEO_PLAYER_SHARED_FRAME_CAPTURE_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "player_types.h"
+
+namespace pro_video_player {
+
+enum class CaptureFormat {
+  kPng,
+  kJpeg,
+  // Tightly packed RGBA, 4 bytes per pixel, rows top to bottom.
+  kRaw,
+};
+
+// Quality CaptureFrame encodes JPEG snapshots at (1..100).
+inline constexpr int kCaptureJpegQuality = 85;
+
+// An encoded snapshot of one video frame.
+struct CapturedFrame {
+  int width = 0;
+  int height = 0;
+  int64_t pts_ms = 0;
+  CaptureFormat format = CaptureFormat::kPng;
+  std::vector<uint8_t> bytes;
+};
+
+// Converts |frame| to tightly packed RGBA, box-filtered down to at most
+// |max_width| pixels wide with the aspect ratio kept (<= 0 keeps the
+// size; frames are never scaled up). kRgbx frames come out opaque.
+std::vector<uint8_t> ScaleFrameToRgba(const VideoFrame& frame, int max_width, int* width, int* height);
+
+// Image files from tightly packed RGBA. PNG is lossless, and RGB unless
+// some pixel isn't opaque; JPEG is baseline 4:2:0 and drops alpha.
+std::vector<uint8_t> EncodePng(const uint8_t* rgba, int width, int height);
+std::vector<uint8_t> EncodeJpeg(const uint8_t* rgba, int width, int height, int quality = kCaptureJpegQuality);
+
+// Fills |captured| (but not its pts) with |rgba| encoded as |format|.
+void EncodeRgba(std::vector<uint8_t> rgba, int width, int height, CaptureFormat format, CapturedFrame* captured);
+
+// ScaleFrameToRgba, then EncodeRgba. False for frames without pixels.
+bool EncodeFrame(const VideoFrame& frame, int max_width, CaptureFormat format, CapturedFrame* captured);
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_FRAME_CAPTURE_H_
@@ -0,0 +1,22 @@
+#include "frame_rate_gate.h"
+
+namespace pro_video_player {
+
+void FrameRateGate::SetPolicy(int64_t min_interval_us, bool visible) {
+  min_interval_us_.store(min_interval_us, std::memory_order_relaxed);
+  visible_.store(visible, std::memory_order_relaxed);
+}
+
+bool FrameRateGate::ShouldRender(int64_t timestamp_us) {
+  const int64_t interval_us = min_interval_us_.load(std::memory_order_relaxed);
+  bool render = visible_.load(std::memory_order_relaxed) && interval_us >= 0;
+  if (render && interval_us > 0 && timestamp_us >= 0) {
+    const int64_t last_us = last_timestamp_us_.load(std::memory_order_relaxed);
+    render = last_us < 0 || timestamp_us < last_us || timestamp_us - last_us >= interval_us - kToleranceUs;
+    if (render) last_timestamp_us_.store(timestamp_us, std::memory_order_relaxed);
+  }
+  (render ? rendered_ : skipped_).fetch_add(1, std::memory_order_relaxed);
+  return render;
+}
+
+}  // namespace pro_video_player
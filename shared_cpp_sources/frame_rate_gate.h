@@ -0,0 +1,46 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_FRAME_RATE_GATE_H_
+#define PRO_VIDEO_PLAYER_SHARED_FRAME_RATE_GATE_H_
+
+#include <atomic>
+#include <cstdint>
+
+namespace pro_video_player {
+
+// A player's render policy (frame rate cap, visibility) as a per-frame
+// decision. Backends that convert frames themselves ask before converting,
+// so a dropped frame costs no scaling or colour conversion.
+//
+// SetPolicy is called from the player's worker, ShouldRender from the
+// backend's render thread.
+class FrameRateGate {
+ public:
+  // Slack for timestamps rounded to whole milliseconds, so a 30 fps source
+  // capped at 10 fps still renders every third frame.
+  static constexpr int64_t kToleranceUs = 2000;
+
+  // |min_interval_us|: 0 renders every frame, < 0 none (no video).
+  void SetPolicy(int64_t min_interval_us, bool visible);
+
+  // Whether to render the frame with timestamp |timestamp_us| (its pts, or
+  // any per-frame clock that advances with it). Timestamps going backwards
+  // (seek, loop) always render; a negative one means the frame has none and
+  // is only subject to visibility. Counts the decision.
+  bool ShouldRender(int64_t timestamp_us);
+
+  // Forgets the last rendered timestamp, e.g. after a seek.
+  void Reset() { last_timestamp_us_.store(-1, std::memory_order_relaxed); }
+
+  uint64_t rendered() const { return rendered_.load(std::memory_order_relaxed); }
+  uint64_t skipped() const { return skipped_.load(std::memory_order_relaxed); }
+
+ private:
+  std::atomic<int64_t> min_interval_us_{0};
+  std::atomic<bool> visible_{true};
+  std::atomic<int64_t> last_timestamp_us_{-1};
+  std::atomic<uint64_t> rendered_{0};
+  std::atomic<uint64_t> skipped_{0};
+};
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_FRAME_RATE_GATE_H_
@@ -0,0 +1,213 @@
+#include "hls_decrypt.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace pro_video_player {
+
+namespace {
+
+constexpr size_t kBlock = Aes128::kBlockSize;
+// SAMPLE-AES H.264: bytes left clear at the start of a NAL unit, and
+// clear bytes after each encrypted block.
+constexpr size_t kNalClearLeader = 32;
+constexpr size_t kNalClearStride = 144;
+// SAMPLE-AES AAC: clear bytes after the ADTS header.
+constexpr size_t kAudioClearLeader = 16;
+
+int HexDigit(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+bool ParseIv(std::string_view text, std::array<uint8_t, 16>* iv) {
+  if (text.size() < 2 || text[0] != '0' || (text[1] != 'x' && text[1] != 'X')) return false;
+  text.remove_prefix(2);
+  if (text.size() > 32) return false;
+  // Right-aligned like any 128-bit hex number
+  iv->fill(0);
+  const size_t skip = 32 - text.size();
+  for (size_t i = 0; i < text.size(); ++i) {
+    const int digit = HexDigit(text[i]);
+    if (digit < 0) return false;
+    const size_t nibble = skip + i;
+    (*iv)[nibble / 2] |= static_cast<uint8_t>(nibble % 2 == 0 ? digit << 4 : digit);
+  }
+  return true;
+}
+
+// Removes the 0x03 of every 00 00 03 in place; returns the new size.
+size_t RemoveEmulationPrevention(uint8_t* data, size_t size) {
+  size_t out = 0;
+  int zeros = 0;
+  for (size_t in = 0; in < size; ++in) {
+    const uint8_t byte = data[in];
+    if (zeros >= 2 && byte == 0x03) {
+      zeros = 0;
+      continue;
+    }
+    zeros = byte == 0 ? zeros + 1 : 0;
+    data[out++] = byte;
+  }
+  return out;
+}
+
+void DecryptNalUnit(const Aes128& aes, const std::array<uint8_t, 16>& iv, uint8_t* nal, size_t size) {
+  uint8_t chain[16];
+  std::memcpy(chain, iv.data(), 16);
+  size_t offset = kNalClearLeader;
+  while (offset < size) {
+    if (size - offset > kBlock) {
+      aes.DecryptCbc(nal + offset, kBlock, chain);
+      offset += kBlock;
+    }
+    offset += std::min(kNalClearStride, size - offset);
+  }
+}
+
+// Offset of the next 00 00 01 at or after |from|, or |size|.
+size_t FindStartCode(const uint8_t* data, size_t size, size_t from) {
+  for (size_t i = from; i + 3 <= size; ++i) {
+    if (data[i] == 0 && data[i + 1] == 0 && data[i + 2] == 1) return i;
+  }
+  return size;
+}
+
+}  // namespace
+
+bool NextHlsAttribute(std::string_view* list, std::string_view* name, std::string_view* value) {
+  while (!list->empty() && (list->front() == ',' || std::isspace(static_cast<unsigned char>(list->front())))) {
+    list->remove_prefix(1);
+  }
+  if (list->empty()) return false;
+  const size_t equals = list->find('=');
+  if (equals == std::string_view::npos) return false;
+  *name = list->substr(0, equals);
+  list->remove_prefix(equals + 1);
+  size_t end;
+  if (!list->empty() && list->front() == '"') {
+    end = list->find('"', 1);
+    if (end == std::string_view::npos) return false;
+    *value = list->substr(1, end - 1);
+    ++end;
+  } else {
+    end = std::min(list->find(','), list->size());
+    *value = list->substr(0, end);
+  }
+  list->remove_prefix(end);
+  return true;
+}
+
+std::array<uint8_t, 16> HlsSequenceIv(uint64_t sequence) {
+  std::array<uint8_t, 16> iv{};
+  for (int i = 0; i < 8; ++i) iv[15 - i] = static_cast<uint8_t>(sequence >> (8 * i));
+  return iv;
+}
+
+bool ParseHlsKey(std::string_view attributes, uint64_t sequence, HlsKey* key) {
+  HlsKey parsed;
+  parsed.iv = HlsSequenceIv(sequence);
+  bool has_method = false;
+  std::string_view name;
+  std::string_view value;
+  while (NextHlsAttribute(&attributes, &name, &value)) {
+    if (name == "METHOD") {
+      has_method = true;
+      if (value == "NONE") {
+        parsed.method = HlsKeyMethod::kNone;
+      } else if (value == "AES-128") {
+        parsed.method = HlsKeyMethod::kAes128;
+      } else if (value == "SAMPLE-AES") {
+        parsed.method = HlsKeyMethod::kSampleAes;
+      } else {
+        return false;
+      }
+    } else if (name == "URI") {
+      parsed.uri = std::string(value);
+    } else if (name == "IV") {
+      if (!ParseIv(value, &parsed.iv)) return false;
+    } else if (name == "KEYFORMAT") {
+      // Anything but a plain key is DRM
+      if (value != "identity") return false;
+    }
+  }
+  if (!has_method || (parsed.method != HlsKeyMethod::kNone && parsed.uri.empty())) return false;
+  *key = std::move(parsed);
+  return true;
+}
+
+int64_t DecryptAes128Segment(const Aes128& aes, const std::array<uint8_t, 16>& iv, uint8_t* data,
+                             size_t size) {
+  if (size == 0 || size % kBlock != 0) return -1;
+  uint8_t chain[16];
+  std::memcpy(chain, iv.data(), 16);
+  aes.DecryptCbc(data, size, chain);
+  const uint8_t padding = data[size - 1];
+  if (padding == 0 || padding > kBlock) return -1;
+  for (size_t i = size - padding; i < size; ++i) {
+    if (data[i] != padding) return -1;
+  }
+  return static_cast<int64_t>(size - padding);
+}
+
+void DecryptSampleAesAdts(const Aes128& aes, const std::array<uint8_t, 16>& iv, uint8_t* data, size_t size) {
+  size_t offset = 0;
+  while (offset + 7 <= size) {
+    const uint8_t* header = data + offset;
+    if (header[0] != 0xff || (header[1] & 0xf0) != 0xf0) return;
+    const size_t header_size = (header[1] & 0x01) ? 7 : 9;
+    const size_t frame_size = (static_cast<size_t>(header[3] & 0x03) << 11) |
+                              (static_cast<size_t>(header[4]) << 3) | (header[5] >> 5);
+    if (frame_size < header_size || offset + frame_size > size) return;
+    const size_t payload = frame_size - header_size;
+    if (payload > kAudioClearLeader) {
+      const size_t encrypted = (payload - kAudioClearLeader) / kBlock * kBlock;
+      uint8_t chain[16];
+      std::memcpy(chain, iv.data(), 16);
+      aes.DecryptCbc(data + offset + header_size + kAudioClearLeader, encrypted, chain);
+    }
+    offset += frame_size;
+  }
+}
+
+size_t DecryptSampleAesH264(const Aes128& aes, const std::array<uint8_t, 16>& iv, uint8_t* data, size_t size) {
+  size_t in = FindStartCode(data, size, 0);
+  // Whatever precedes the first start code stays as it is
+  size_t out = in;
+  while (in < size) {
+    const size_t nal_start = in + 3;
+    size_t next = FindStartCode(data, size, nal_start);
+    size_t nal_end = next;
+    // A zero before the next start code makes it a 4-byte one
+    if (next < size && nal_end > nal_start && data[nal_end - 1] == 0) --nal_end;
+
+    // Start code, then the unit, moved down over what earlier units shed
+    std::memmove(data + out, data + in, nal_start - in);
+    out += nal_start - in;
+    size_t nal_size = nal_end - nal_start;
+    std::memmove(data + out, data + nal_start, nal_size);
+    const int type = nal_size > 0 ? data[out] & 0x1f : 0;
+    if ((type == 1 || type == 5) && nal_size > 48) {
+      nal_size = RemoveEmulationPrevention(data + out, nal_size);
+      DecryptNalUnit(aes, iv, data + out, nal_size);
+    }
+    out += nal_size;
+    // The zero of a 4-byte start code goes with the next one
+    in = nal_end;
+    if (next == size) {
+      std::memmove(data + out, data + nal_end, size - nal_end);
+      out += size - nal_end;
+      break;
+    }
+    if (nal_end < next) {
+      data[out++] = 0;
+      in = next;
+    }
+  }
+  return out;
+}
+
+}  // namespace pro_video_player
@@ -0,0 +1,71 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_HLS_DECRYPT_H_
+#define PRO_VIDEO_PLAYER_SHARED_HLS_DECRYPT_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "aes128.h"
+
+namespace pro_video_player {
+
+enum class HlsKeyMethod {
+  kNone,
+  // Whole segments, AES-128-CBC with PKCS#7 padding.
+  kAes128,
+  // Parts of each audio frame and video NAL unit (MPEG-2 TS elementary
+  // streams), AES-128-CBC.
+  kSampleAes,
+};
+
+// One EXT-X-KEY as it applies to a segment.
+struct HlsKey {
+  HlsKeyMethod method = HlsKeyMethod::kNone;
+  // Absolute URL of the 16-byte key.
+  std::string uri;
+  std::array<uint8_t, 16> iv{};
+
+  bool operator==(const HlsKey& other) const {
+    return method == other.method && uri == other.uri && iv == other.iv;
+  }
+};
+
+// The IV of a segment whose key has no IV attribute: its media sequence
+// number, big-endian, zero-padded to 16 bytes.
+std::array<uint8_t, 16> HlsSequenceIv(uint64_t sequence);
+
+// Takes the next NAME=VALUE off an HLS attribute list, unquoting quoted
+// values (which may hold commas). False at the end or on malformed input.
+bool NextHlsAttribute(std::string_view* list, std::string_view* name, std::string_view* value);
+
+// Parses the attributes of an EXT-X-KEY tag (the text after the colon)
+// for the segment with media sequence |sequence|. |uri| comes back as
+// written, to be resolved against the playlist URL. False for methods
+// this decrypter doesn't handle (SAMPLE-AES-CTR, DRM key formats) and for
+// malformed tags.
+bool ParseHlsKey(std::string_view attributes, uint64_t sequence, HlsKey* key);
+
+// AES-128: decrypts a whole segment in place and strips the padding.
+// Returns the plaintext size, or -1 if |size| isn't whole blocks or the
+// padding is invalid (wrong key or IV).
+int64_t DecryptAes128Segment(const Aes128& aes, const std::array<uint8_t, 16>& iv, uint8_t* data,
+                             size_t size);
+
+// SAMPLE-AES works on what a TS demuxer hands out per access unit; the CBC
+// chain restarts from |iv| for every audio frame and NAL unit.
+//
+// ADTS AAC: after each frame header, a 16-byte clear leader, then every
+// whole 16-byte block encrypted. Decrypts all frames in |data| in place.
+void DecryptSampleAesAdts(const Aes128& aes, const std::array<uint8_t, 16>& iv, uint8_t* data, size_t size);
+
+// H.264 Annex B: slice NAL units (types 1 and 5) longer than 48 bytes keep
+// 32 bytes in the clear, then one 16-byte block in ten is encrypted. The
+// encrypted units carry an extra layer of emulation prevention, removed
+// here, so |data| shrinks; returns its new size.
+size_t DecryptSampleAesH264(const Aes128& aes, const std::array<uint8_t, 16>& iv, uint8_t* data, size_t size);
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_HLS_DECRYPT_H_
@@ -0,0 +1,115 @@
+#include "hls_remuxer.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace pro_video_player {
+
+std::unique_ptr<HlsRemuxer> HlsRemuxer::Open(const std::string& path, Options options, std::string* error) {
+  std::unique_ptr<HlsRemuxer> remuxer(new HlsRemuxer());
+  remuxer->fd_ = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  struct stat info;
+  if (remuxer->fd_ < 0 || fstat(remuxer->fd_, &info) != 0) {
+    *error = "Can't open " + path + ": " + std::strerror(errno);
+    return nullptr;
+  }
+  if (info.st_size <= 0) {
+    *error = path + " is empty";
+    return nullptr;
+  }
+  void* mapped = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, remuxer->fd_, 0);
+  if (mapped == MAP_FAILED) {
+    *error = "Can't map " + path + ": " + std::strerror(errno);
+    return nullptr;
+  }
+  remuxer->data_ = static_cast<const uint8_t*>(mapped);
+  remuxer->size_ = static_cast<size_t>(info.st_size);
+  remuxer->demuxer_ = OpenMediaDemuxer(remuxer->data_, remuxer->size_, error);
+  if (!remuxer->demuxer_) return nullptr;
+
+  // Greedy: each cut is the first sync point a target duration past the
+  // previous one
+  const auto& points = remuxer->demuxer_->sync_points();
+  const int64_t target_us = std::max<int64_t>(options.target_duration_ms, 1) * 1000;
+  auto& cuts = remuxer->cuts_;
+  cuts.push_back(0);
+  for (size_t i = 1; i < points.size(); ++i) {
+    if (points[i].time_us - points[cuts.back()].time_us >= target_us) cuts.push_back(i);
+  }
+
+  // The last segment ends with the file; without a usable duration in the
+  // header, with its last sample
+  remuxer->end_us_ = remuxer->demuxer_->duration_us();
+  const SyncPoint& last = points[cuts.back()];
+  if (remuxer->end_us_ <= last.time_us) {
+    std::vector<std::vector<DemuxedSample>> samples;
+    if (!remuxer->demuxer_->ReadSamples(last, nullptr, &samples, error)) return nullptr;
+    const auto& tracks = remuxer->demuxer_->tracks();
+    for (size_t t = 0; t < samples.size(); ++t) {
+      for (const auto& sample : samples[t]) {
+        const int64_t end = sample.dts + sample.composition_offset + sample.duration;
+        // A sample whose end doesn't convert doesn't extend the file
+        int64_t end_us = 0;
+        if (RescaleTime(end, tracks[t].timescale, 1000000, &end_us)) {
+          remuxer->end_us_ = std::max(remuxer->end_us_, end_us);
+        }
+      }
+    }
+  }
+
+  remuxer->init_segment_ = BuildFmp4Init(remuxer->demuxer_->tracks());
+
+  std::string segments;
+  double longest = 0;
+  char extinf[32];
+  for (size_t i = 0; i < cuts.size(); ++i) {
+    const double seconds = static_cast<double>(remuxer->segment_duration_us(i)) / 1e6;
+    longest = std::max(longest, seconds);
+    std::snprintf(extinf, sizeof(extinf), "%.3f", seconds);
+    segments += "#EXTINF:" + std::string(extinf) + ",\nseg" + std::to_string(i) + ".m4s\n";
+  }
+  auto& playlist = remuxer->playlist_;
+  playlist = "#EXTM3U\n#EXT-X-VERSION:7\n";
+  playlist += "#EXT-X-TARGETDURATION:" + std::to_string(std::max(1, static_cast<int>(std::ceil(longest)))) + "\n";
+  playlist += "#EXT-X-MEDIA-SEQUENCE:0\n#EXT-X-PLAYLIST-TYPE:VOD\n#EXT-X-INDEPENDENT-SEGMENTS\n";
+  playlist += "#EXT-X-MAP:URI=\"init.mp4\"\n" + segments + "#EXT-X-ENDLIST\n";
+  return remuxer;
+}
+
+HlsRemuxer::~HlsRemuxer() {
+  demuxer_.reset();
+  if (data_ != nullptr) munmap(const_cast<uint8_t*>(data_), size_);
+  if (fd_ >= 0) close(fd_);
+}
+
+int64_t HlsRemuxer::segment_start_us(size_t index) const {
+  return demuxer_->sync_points()[cuts_[index]].time_us;
+}
+
+int64_t HlsRemuxer::segment_duration_us(size_t index) const {
+  const int64_t end = index + 1 < cuts_.size() ? segment_start_us(index + 1) : end_us_;
+  return std::max<int64_t>(end - segment_start_us(index), 0);
+}
+
+bool HlsRemuxer::Segment(size_t index, Fmp4Fragment* fragment, std::string* error) const {
+  if (index >= cuts_.size()) {
+    *error = "No segment " + std::to_string(index);
+    return false;
+  }
+  const auto& points = demuxer_->sync_points();
+  const SyncPoint* to = index + 1 < cuts_.size() ? &points[cuts_[index + 1]] : nullptr;
+  std::vector<std::vector<DemuxedSample>> samples;
+  if (!demuxer_->ReadSamples(points[cuts_[index]], to, &samples, error)) return false;
+  *fragment = BuildFmp4Fragment(static_cast<uint32_t>(index + 1), demuxer_->tracks(), samples);
+  return true;
+}
+
+}  // namespace pro_video_player
@@ -0,0 +1,76 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_HLS_REMUXER_H_
+#define PRO_VIDEO_PLAYER_SHARED_HLS_REMUXER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "fmp4_writer.h"
+#include "media_demuxer.h"
+
+namespace pro_video_player {
+
+// A local MP4 or Matroska file as a fMP4 HLS presentation, for decoders
+// that play HLS well but not the file's container (or not seeking in it).
+//
+// Opening maps the file and reads only its index: segments are cut at the
+// sync points at least |target_duration_ms| apart, and the media playlist
+// is written from their times. Segment() builds a fragment on demand from
+// the samples of one range, as a moof header plus ranges of the mapped
+// file; no media data is copied, and a server can send the ranges
+// straight from fd() (sendfile).
+//
+// The first video and the first audio track are muxed together; other
+// tracks are dropped. Immutable once opened, so Segment() may run on
+// several threads at once.
+class HlsRemuxer {
+ public:
+  struct Options {
+    // Segments are at least this long, except the last, and as long as
+    // the GOPs make them beyond it.
+    int64_t target_duration_ms = 6000;
+  };
+
+  static std::unique_ptr<HlsRemuxer> Open(const std::string& path, Options options, std::string* error);
+  ~HlsRemuxer();
+
+  HlsRemuxer(const HlsRemuxer&) = delete;
+  HlsRemuxer& operator=(const HlsRemuxer&) = delete;
+
+  // VOD media playlist; the init segment is "init.mp4", segment |i| is
+  // "seg<i>.m4s", relative to the playlist.
+  const std::string& playlist() const { return playlist_; }
+  const std::string& init_segment() const { return init_segment_; }
+  size_t segment_count() const { return cuts_.size(); }
+  // In microseconds, from the first sample's presentation.
+  int64_t segment_start_us(size_t index) const;
+  int64_t segment_duration_us(size_t index) const;
+
+  // Fragment |index|, numbered |index| + 1. False with |error| for a bad
+  // index or samples the demuxer can't read.
+  bool Segment(size_t index, Fmp4Fragment* fragment, std::string* error) const;
+
+  // The source, for sending a fragment's payload ranges.
+  int fd() const { return fd_; }
+  const uint8_t* data() const { return data_; }
+  int64_t file_size() const { return static_cast<int64_t>(size_); }
+
+ private:
+  HlsRemuxer() = default;
+
+  int fd_ = -1;
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+  std::unique_ptr<MediaDemuxer> demuxer_;
+  // Indexes into the demuxer's sync points, one per segment.
+  std::vector<size_t> cuts_;
+  int64_t end_us_ = 0;
+  std::string init_segment_;
+  std::string playlist_;
+};
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_HLS_REMUXER_H_
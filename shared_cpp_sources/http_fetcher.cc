@@ -0,0 +1,374 @@
+#include "http_fetcher.h"
+
+#include <curl/curl.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+#include "trace_recorder.h"
+
+namespace pro_video_player {
+
+namespace {
+
+std::string Lower(std::string text) {
+  std::transform(text.begin(), text.end(), text.begin(),
+                 [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+  return text;
+}
+
+// scheme://host:port, the unit connections are pooled by; empty if |url|
+// doesn't parse.
+std::string OriginOf(const std::string& url) {
+  CURLU* handle = curl_url();
+  std::string origin;
+  char* scheme = nullptr;
+  char* host = nullptr;
+  char* port = nullptr;
+  if (curl_url_set(handle, CURLUPART_URL, url.c_str(), 0) == CURLUE_OK &&
+      curl_url_get(handle, CURLUPART_SCHEME, &scheme, 0) == CURLUE_OK &&
+      curl_url_get(handle, CURLUPART_HOST, &host, 0) == CURLUE_OK &&
+      curl_url_get(handle, CURLUPART_PORT, &port, CURLU_DEFAULT_PORT) == CURLUE_OK) {
+    origin = Lower(scheme) + "://" + Lower(host) + ":" + port;
+  }
+  curl_free(scheme);
+  curl_free(host);
+  curl_free(port);
+  curl_url_cleanup(handle);
+  return origin;
+}
+
+long StreamWeight(FetchPriority priority) {
+  switch (priority) {
+    case FetchPriority::kCurrentSegment:
+      return 256;
+    case FetchPriority::kNextSegment:
+      return 64;
+    case FetchPriority::kPrefetch:
+      return 16;
+  }
+  return 16;
+}
+
+void InitCurlOnce() {
+  static std::once_flag once;
+  std::call_once(once, []() { curl_global_init(CURL_GLOBAL_DEFAULT); });
+}
+
+}  // namespace
+
+struct HttpFetcher::Pending {
+  RequestId id = 0;
+  HttpRequest request;
+  Callback done;
+  std::string origin;
+};
+
+struct HttpFetcher::Transfer {
+  RequestId id = 0;
+  Callback done;
+  std::string origin;
+  curl_slist* headers = nullptr;
+  HttpResponse response;
+  std::chrono::steady_clock::time_point start;
+};
+
+HttpRequest MakeHttpRequest(const MediaSource& source, std::string url, FetchPriority priority) {
+  HttpRequest request;
+  request.url = std::move(url);
+  request.headers = source.headers;
+  request.priority = priority;
+  return request;
+}
+
+int64_t ContentRangeTotal(const HttpResponse& response) {
+  const auto header = response.headers.find("content-range");
+  if (header == response.headers.end()) return -1;
+  const size_t slash = header->second.find('/');
+  if (slash == std::string::npos || header->second.compare(slash + 1, 1, "*") == 0) return -1;
+  return std::strtoll(header->second.c_str() + slash + 1, nullptr, 10);
+}
+
+HttpFetcher::HttpFetcher() : HttpFetcher(Options()) {}
+
+HttpFetcher::HttpFetcher(Options options) : options_(std::move(options)) {
+  InitCurlOnce();
+  CURLM* multi = curl_multi_init();
+  curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+  curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS,
+                    static_cast<long>(std::max(options_.max_requests_per_origin, 1)));
+  curl_multi_setopt(multi, CURLMOPT_MAXCONNECTS, static_cast<long>(std::max(options_.max_idle_connections, 1)));
+  multi_ = multi;
+  // Resumed TLS sessions make the handshake on a fresh connection one
+  // round trip. Only the fetcher thread touches handles, so no locking.
+  CURLSH* share = curl_share_init();
+  curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+  curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+  share_ = share;
+  thread_ = std::thread(&HttpFetcher::Run, this);
+}
+
+HttpFetcher::~HttpFetcher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  curl_multi_wakeup(static_cast<CURLM*>(multi_));
+  thread_.join();
+  curl_multi_cleanup(static_cast<CURLM*>(multi_));
+  curl_share_cleanup(static_cast<CURLSH*>(share_));
+}
+
+HttpFetcher::RequestId HttpFetcher::Fetch(HttpRequest request, Callback done) {
+  auto pending = std::make_unique<Pending>();
+  pending->origin = OriginOf(request.url);
+  pending->request = std::move(request);
+  pending->done = std::move(done);
+  RequestId id;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    id = next_id_++;
+    pending->id = id;
+    queue_.push_back(std::move(pending));
+  }
+  curl_multi_wakeup(static_cast<CURLM*>(multi_));
+  return id;
+}
+
+bool HttpFetcher::Cancel(RequestId id) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto queued = std::find_if(queue_.begin(), queue_.end(),
+                                     [id](const std::unique_ptr<Pending>& pending) { return pending->id == id; });
+    if (queued != queue_.end()) {
+      queue_.erase(queued);
+      return true;
+    }
+    // Running transfers belong to the fetcher thread
+    if (running_.erase(id) == 0) return false;
+    cancelled_.push_back(id);
+  }
+  curl_multi_wakeup(static_cast<CURLM*>(multi_));
+  return true;
+}
+
+bool HttpFetcher::SetMaxBytesPerSecond(RequestId id, int64_t max_bytes_per_second) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto queued = std::find_if(queue_.begin(), queue_.end(),
+                                     [id](const std::unique_ptr<Pending>& pending) { return pending->id == id; });
+    if (queued != queue_.end()) {
+      (*queued)->request.max_bytes_per_second = max_bytes_per_second;
+      return true;
+    }
+    if (running_.count(id) == 0) return false;
+    rate_changes_.emplace_back(id, max_bytes_per_second);
+  }
+  curl_multi_wakeup(static_cast<CURLM*>(multi_));
+  return true;
+}
+
+HttpFetcher::Stats HttpFetcher::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void HttpFetcher::Run() {
+  TraceRecorder::Instance().SetCurrentThreadName("pvp-http");
+  CURLM* multi = static_cast<CURLM*>(multi_);
+  for (;;) {
+    std::vector<RequestId> cancelled;
+    std::vector<std::pair<RequestId, int64_t>> rate_changes;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (stopping_) break;
+      cancelled.swap(cancelled_);
+      rate_changes.swap(rate_changes_);
+    }
+    for (RequestId id : cancelled) Abort(id);
+    for (const auto& change : rate_changes) ApplyRate(change.first, change.second);
+    StartQueued();
+
+    int running = 0;
+    curl_multi_perform(multi, &running);
+    int left = 0;
+    bool finished = false;
+    while (CURLMsg* message = curl_multi_info_read(multi, &left)) {
+      if (message->msg != CURLMSG_DONE) continue;
+      Finish(message->easy_handle, message->data.result);
+      finished = true;
+    }
+    // A freed slot may let a queued request start right away
+    if (!finished) curl_multi_poll(multi, nullptr, 0, 1000, nullptr);
+  }
+
+  for (auto& entry : transfers_) {
+    curl_multi_remove_handle(multi, entry.first);
+    curl_easy_cleanup(entry.first);
+    curl_slist_free_all(entry.second->headers);
+  }
+  transfers_.clear();
+}
+
+void HttpFetcher::StartQueued() {
+  const int limit = std::max(options_.max_requests_per_origin, 1);
+  for (;;) {
+    std::unique_ptr<Pending> next;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      // Highest priority first, oldest first within a priority, skipping
+      // origins that are at their limit
+      auto best = queue_.end();
+      for (auto it = queue_.begin(); it != queue_.end(); ++it) {
+        if (active_per_origin_[(*it)->origin] >= limit) continue;
+        if (best == queue_.end() || (*it)->request.priority > (*best)->request.priority) best = it;
+      }
+      if (best == queue_.end()) return;
+      next = std::move(*best);
+      queue_.erase(best);
+      running_.insert(next->id);
+      ++stats_.requests;
+    }
+    Start(std::move(next));
+  }
+}
+
+void HttpFetcher::Start(std::unique_ptr<Pending> pending) {
+  PVP_TRACE_SCOPE("http", "Start");
+  auto transfer = std::make_unique<Transfer>();
+  transfer->id = pending->id;
+  transfer->done = std::move(pending->done);
+  transfer->origin = pending->origin;
+  transfer->start = std::chrono::steady_clock::now();
+  const HttpRequest& request = pending->request;
+
+  // Request headers override defaults of the same name, ignoring case
+  std::map<std::string, std::pair<std::string, std::string>> headers;
+  for (const auto& header : options_.default_headers) headers[Lower(header.first)] = header;
+  for (const auto& header : request.headers) headers[Lower(header.first)] = header;
+  for (const auto& header : headers) {
+    const std::string line = header.second.first + ": " + header.second.second;
+    transfer->headers = curl_slist_append(transfer->headers, line.c_str());
+  }
+
+  CURL* easy = curl_easy_init();
+  curl_easy_setopt(easy, CURLOPT_URL, request.url.c_str());
+  curl_easy_setopt(easy, CURLOPT_SHARE, static_cast<CURLSH*>(share_));
+  curl_easy_setopt(easy, CURLOPT_PRIVATE, transfer.get());
+  curl_easy_setopt(easy, CURLOPT_HTTPHEADER, transfer->headers);
+  curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+  curl_easy_setopt(easy, CURLOPT_FOLLOWLOCATION, 1L);
+  curl_easy_setopt(easy, CURLOPT_MAXREDIRS, 5L);
+  curl_easy_setopt(easy, CURLOPT_TCP_KEEPALIVE, 1L);
+  curl_easy_setopt(easy, CURLOPT_HTTP_VERSION, static_cast<long>(CURL_HTTP_VERSION_2TLS));
+  // Queue behind an HTTP/2 connection that is still being set up instead
+  // of racing a second handshake to the same origin
+  curl_easy_setopt(easy, CURLOPT_PIPEWAIT, 1L);
+  curl_easy_setopt(easy, CURLOPT_STREAM_WEIGHT, StreamWeight(request.priority));
+  curl_easy_setopt(easy, CURLOPT_CONNECTTIMEOUT_MS, static_cast<long>(options_.connect_timeout.count()));
+  if (options_.stall_timeout.count() > 0) {
+    curl_easy_setopt(easy, CURLOPT_LOW_SPEED_LIMIT, 1L);
+    curl_easy_setopt(easy, CURLOPT_LOW_SPEED_TIME,
+                     std::max(1L, static_cast<long>(options_.stall_timeout.count() / 1000)));
+  }
+  if (request.range_start >= 0) {
+    std::string range = std::to_string(request.range_start) + "-";
+    if (request.range_end >= 0) range += std::to_string(request.range_end);
+    curl_easy_setopt(easy, CURLOPT_RANGE, range.c_str());
+  }
+  if (request.max_bytes_per_second > 0) {
+    curl_easy_setopt(easy, CURLOPT_MAX_RECV_SPEED_LARGE, static_cast<curl_off_t>(request.max_bytes_per_second));
+  }
+  curl_easy_setopt(easy, CURLOPT_WRITEDATA, transfer.get());
+  curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, +[](char* data, size_t size, size_t count, void* context) {
+    auto* self = static_cast<Transfer*>(context);
+    self->response.body.insert(self->response.body.end(), data, data + size * count);
+    return size * count;
+  });
+  curl_easy_setopt(easy, CURLOPT_HEADERDATA, transfer.get());
+  curl_easy_setopt(easy, CURLOPT_HEADERFUNCTION, +[](char* data, size_t size, size_t count, void* context) {
+    auto* self = static_cast<Transfer*>(context);
+    std::string line(data, size * count);
+    // A new status line starts over (redirects, 100 Continue)
+    if (line.compare(0, 5, "HTTP/") == 0) {
+      self->response.headers.clear();
+      return size * count;
+    }
+    const size_t colon = line.find(':');
+    if (colon != std::string::npos) {
+      size_t begin = colon + 1;
+      size_t end = line.size();
+      while (begin < end && std::isspace(static_cast<unsigned char>(line[begin]))) ++begin;
+      while (end > begin && std::isspace(static_cast<unsigned char>(line[end - 1]))) --end;
+      self->response.headers[Lower(line.substr(0, colon))] = line.substr(begin, end - begin);
+    }
+    return size * count;
+  });
+
+  ++active_per_origin_[transfer->origin];
+  transfers_[easy] = std::move(transfer);
+  curl_multi_add_handle(static_cast<CURLM*>(multi_), easy);
+}
+
+void HttpFetcher::Finish(void* handle, int result) {
+  CURL* easy = static_cast<CURL*>(handle);
+  const auto found = transfers_.find(easy);
+  if (found == transfers_.end()) return;
+  std::unique_ptr<Transfer> transfer = std::move(found->second);
+  transfers_.erase(found);
+
+  HttpResponse& response = transfer->response;
+  long status = 0;
+  long connects = 0;
+  curl_off_t first_byte_us = 0;
+  curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &status);
+  curl_easy_getinfo(easy, CURLINFO_NUM_CONNECTS, &connects);
+  curl_easy_getinfo(easy, CURLINFO_STARTTRANSFER_TIME_T, &first_byte_us);
+  response.time_to_first_byte = std::chrono::microseconds(first_byte_us);
+  response.status = static_cast<int>(status);
+  response.new_connection = connects > 0;
+  response.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - transfer->start);
+  if (result != CURLE_OK) response.error = curl_easy_strerror(static_cast<CURLcode>(result));
+
+  curl_multi_remove_handle(static_cast<CURLM*>(multi_), easy);
+  curl_easy_cleanup(easy);
+  curl_slist_free_all(transfer->headers);
+  --active_per_origin_[transfer->origin];
+
+  bool cancelled;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cancelled = running_.erase(transfer->id) == 0;
+    stats_.connections_opened += static_cast<uint64_t>(connects);
+    stats_.bytes_received += response.body.size();
+  }
+  if (!cancelled && transfer->done) transfer->done(response);
+}
+
+void HttpFetcher::ApplyRate(RequestId id, int64_t max_bytes_per_second) {
+  for (const auto& entry : transfers_) {
+    if (entry.second->id != id) continue;
+    // libcurl reads the cap as it paces the transfer, so it takes effect
+    // mid-body
+    curl_easy_setopt(static_cast<CURL*>(entry.first), CURLOPT_MAX_RECV_SPEED_LARGE,
+                     static_cast<curl_off_t>(std::max<int64_t>(max_bytes_per_second, 0)));
+    return;
+  }
+}
+
+void HttpFetcher::Abort(RequestId id) {
+  for (auto it = transfers_.begin(); it != transfers_.end(); ++it) {
+    if (it->second->id != id) continue;
+    CURL* easy = static_cast<CURL*>(it->first);
+    curl_multi_remove_handle(static_cast<CURLM*>(multi_), easy);
+    curl_easy_cleanup(easy);
+    curl_slist_free_all(it->second->headers);
+    --active_per_origin_[it->second->origin];
+    transfers_.erase(it);
+    return;
+  }
+}
+
+}  // namespace pro_video_player
@@ -0,0 +1,160 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_HTTP_FETCHER_H_
+#define PRO_VIDEO_PLAYER_SHARED_HTTP_FETCHER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "player_types.h"
+
+namespace pro_video_player {
+
+// Order in which queued requests get a connection. Within a priority,
+// requests start in submission order.
+enum class FetchPriority {
+  kPrefetch = 0,
+  kNextSegment = 1,
+  kCurrentSegment = 2,
+};
+
+struct HttpRequest {
+  std::string url;
+  // Sent as-is, after the fetcher's default headers (same name wins).
+  std::map<std::string, std::string> headers;
+  FetchPriority priority = FetchPriority::kCurrentSegment;
+  // Byte range [range_start, range_end]; range_end < 0 means to the end.
+  // No Range header while range_start < 0.
+  int64_t range_start = -1;
+  int64_t range_end = -1;
+  // Receive rate cap for this transfer; 0 is unlimited.
+  int64_t max_bytes_per_second = 0;
+};
+
+// |source|'s headers (VideoSourceMessage.headers) on a request for |url|,
+// e.g. a segment of the playlist |source| points at.
+HttpRequest MakeHttpRequest(const MediaSource& source, std::string url,
+                            FetchPriority priority = FetchPriority::kCurrentSegment);
+
+struct HttpResponse {
+  // 0 if no response arrived; |error| says why.
+  int status = 0;
+  std::string error;
+  // Header names lower-cased; the last of repeated headers wins.
+  std::map<std::string, std::string> headers;
+  std::vector<uint8_t> body;
+  // False if the request went over a pooled connection (no TCP or TLS
+  // handshake).
+  bool new_connection = false;
+  std::chrono::microseconds elapsed{0};
+  // Until the first response byte: roughly one round trip on a pooled
+  // connection, plus handshakes on a new one.
+  std::chrono::microseconds time_to_first_byte{0};
+
+  bool ok() const { return error.empty() && status >= 200 && status < 300; }
+};
+
+// Total size from a 206's Content-Range ("bytes 0-65535/1234567" ->
+// 1234567); -1 for "*" or no header.
+int64_t ContentRangeTotal(const HttpResponse& response);
+
+// Native HTTP client for segment fetching (libcurl multi).
+//
+// Connections are pooled per origin and kept alive between requests, so a
+// stream pays for one TCP + TLS handshake instead of one per segment; new
+// connections resume cached TLS sessions. HTTPS origins negotiate HTTP/2
+// and multiplex concurrent requests over one connection. libcurl no longer
+// does HTTP/1.1 pipelining, so plain HTTP/1.1 origins get up to
+// |max_requests_per_origin| parallel keep-alive connections instead.
+//
+// Requests beyond the per-origin limit wait in a priority queue (current
+// segment > next segment > prefetch); on HTTP/2 the priority is also sent
+// as the stream weight.
+//
+// Thread-safe. Callbacks run on the fetcher's own thread and must not
+// block; they may call Fetch() and Cancel().
+class HttpFetcher {
+ public:
+  using RequestId = uint64_t;
+  using Callback = std::function<void(const HttpResponse& response)>;
+
+  struct Options {
+    // Concurrent requests (HTTP/2 streams or HTTP/1.1 connections) per
+    // scheme://host:port.
+    int max_requests_per_origin = 6;
+    // Idle pooled connections kept across all origins.
+    int max_idle_connections = 16;
+    std::chrono::milliseconds connect_timeout{10000};
+    // Abort if fewer than 1 byte/s arrives for this long; 0 disables.
+    std::chrono::milliseconds stall_timeout{20000};
+    std::map<std::string, std::string> default_headers;
+  };
+
+  struct Stats {
+    uint64_t requests = 0;
+    uint64_t connections_opened = 0;
+    uint64_t bytes_received = 0;
+  };
+
+  HttpFetcher();
+  explicit HttpFetcher(Options options);
+  // Cancels outstanding requests without calling their callbacks.
+  ~HttpFetcher();
+
+  HttpFetcher(const HttpFetcher&) = delete;
+  HttpFetcher& operator=(const HttpFetcher&) = delete;
+
+  // Queues |request|; |done| is called exactly once unless the request is
+  // cancelled or the fetcher destroyed first.
+  RequestId Fetch(HttpRequest request, Callback done);
+
+  // Drops a queued or running request; its callback is not called.
+  // Returns false if it already completed.
+  bool Cancel(RequestId id);
+
+  // Changes the receive rate cap of a queued or running request (0 is
+  // unlimited). Returns false if it already completed.
+  bool SetMaxBytesPerSecond(RequestId id, int64_t max_bytes_per_second);
+
+  Stats stats() const;
+
+ private:
+  struct Pending;
+  struct Transfer;
+
+  void Run();
+  void StartQueued();
+  void Start(std::unique_ptr<Pending> pending);
+  void Finish(void* easy, int result);
+  void Abort(RequestId id);
+  void ApplyRate(RequestId id, int64_t max_bytes_per_second);
+
+  const Options options_;
+
+  mutable std::mutex mutex_;
+  bool stopping_ = false;
+  RequestId next_id_ = 1;
+  std::vector<std::unique_ptr<Pending>> queue_;  // submission order
+  std::set<RequestId> running_;
+  std::vector<RequestId> cancelled_;
+  std::vector<std::pair<RequestId, int64_t>> rate_changes_;
+  Stats stats_;
+
+  // Fetcher thread only.
+  void* multi_ = nullptr;
+  void* share_ = nullptr;
+  std::map<void*, std::unique_ptr<Transfer>> transfers_;
+  std::map<std::string, int> active_per_origin_;
+  std::thread thread_;
+};
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_HTTP_FETCHER_H_
@@ -0,0 +1,71 @@
+#include "live_latency.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace pro_video_player {
+
+namespace {
+
+// Weight of a new measurement; latency readings jump by a segment or a
+// part whenever the playlist refreshes.
+constexpr double kSmoothing = 0.3;
+// Rates are rounded to this step so that a slowly moving error doesn't
+// reconfigure the audio filters on every tick.
+constexpr double kRateStep = 0.005;
+
+}  // namespace
+
+LiveLatencyController::Decision LiveLatencyController::Update(int64_t latency_ms,
+                                                              int64_t buffered_ahead_ms) {
+  Decision decision;
+  if (latency_ms < 0) {
+    decision.rate = rate_;
+    return decision;
+  }
+  if (retarget_) {
+    retarget_ = false;
+    target_ms_ = std::max(options_.target_ms, latency_ms);
+  }
+  latency_ms_ = latency_ms_ < 0 ? static_cast<double>(latency_ms)
+                                : latency_ms_ + kSmoothing * (static_cast<double>(latency_ms) - latency_ms_);
+  const double error = latency_ms_ - static_cast<double>(target_ms_);
+
+  if (error > static_cast<double>(options_.max_drift_ms)) {
+    decision.seek_by_ms = static_cast<int64_t>(error);
+    Reset();
+    return decision;
+  }
+
+  const bool correcting = rate_ != 1.0;
+  const double dead_band = static_cast<double>(correcting ? options_.tolerance_ms / 2 : options_.tolerance_ms);
+  double rate = 1.0;
+  if (std::abs(error) > dead_band) {
+    const double full = static_cast<double>(std::max<int64_t>(options_.full_correction_ms, 1));
+    const double nudge = (kMaxRate - 1.0) * std::clamp(error / full, -1.0, 1.0);
+    rate = std::clamp(1.0 + std::round(nudge / kRateStep) * kRateStep, kMinRate, kMaxRate);
+  }
+  if (rate > 1.0 && buffered_ahead_ms >= 0 && buffered_ahead_ms < options_.min_ahead_ms) rate = 1.0;
+  rate_ = rate;
+  decision.rate = rate;
+  return decision;
+}
+
+void LiveLatencyController::Reset() {
+  latency_ms_ = -1;
+  rate_ = 1.0;
+}
+
+void LiveLatencyController::Retarget() {
+  Reset();
+  retarget_ = true;
+}
+
+void LiveLatencyController::RestoreTarget() {
+  Reset();
+  retarget_ = false;
+  target_ms_ = options_.target_ms;
+}
+
+}  // namespace pro_video_player
@@ -0,0 +1,73 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_LIVE_LATENCY_H_
+#define PRO_VIDEO_PLAYER_SHARED_LIVE_LATENCY_H_
+
+#include <cstdint>
+
+namespace pro_video_player {
+
+// Keeps a live stream at a target distance from its live edge by nudging
+// the playback rate, the way the ExoPlayer and hls.js catch-up controllers
+// do: slightly faster when behind, slightly slower when ahead, never
+// outside [kMinRate, kMaxRate] so the change stays inaudible with pitch
+// correction. Far too much latency (after a long stall, or a pause) is
+// removed with a jump instead, which a few percent of rate would take
+// minutes to catch up.
+//
+// Not thread-safe; the player drives it from its worker.
+class LiveLatencyController {
+ public:
+  static constexpr double kMinRate = 0.95;
+  static constexpr double kMaxRate = 1.05;
+
+  struct Options {
+    int64_t target_ms = 3000;
+    // No correction within this distance of the target; once correcting,
+    // the rate returns to 1.0 within half of it.
+    int64_t tolerance_ms = 250;
+    // Latency error at which the rate reaches its bound.
+    int64_t full_correction_ms = 2000;
+    // Latency beyond target + this is cut by seeking.
+    int64_t max_drift_ms = 10000;
+    // Don't speed up with less than this buffered ahead: it would drain
+    // the buffer into a stall and lose more than it gains.
+    int64_t min_ahead_ms = 1000;
+  };
+
+  struct Decision {
+    double rate = 1.0;
+    // > 0: jump forward by this much.
+    int64_t seek_by_ms = 0;
+  };
+
+  explicit LiveLatencyController(Options options) : options_(options), target_ms_(options.target_ms) {}
+
+  // |latency_ms| was measured now; |buffered_ahead_ms| is -1 if unknown.
+  Decision Update(int64_t latency_ms, int64_t buffered_ahead_ms);
+
+  // Forgets the smoothed latency, e.g. after a pause, where the next
+  // measurement has nothing to do with the previous ones.
+  void Reset();
+  // Like Reset, for a seek chosen by the user: the latency measured next
+  // becomes the target, so playback stays where the user put it instead
+  // of drifting back to the edge. Never below the configured target.
+  void Retarget();
+  // Like Reset, for a seek to the live edge: back to the configured target.
+  void RestoreTarget();
+
+  const Options& options() const { return options_; }
+  int64_t target_ms() const { return target_ms_; }
+  // -1 before the first Update.
+  int64_t latency_ms() const { return latency_ms_ < 0 ? -1 : static_cast<int64_t>(latency_ms_); }
+  double rate() const { return rate_; }
+
+ private:
+  Options options_;
+  int64_t target_ms_;
+  bool retarget_ = false;
+  double latency_ms_ = -1;
+  double rate_ = 1.0;
+};
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_LIVE_LATENCY_H_
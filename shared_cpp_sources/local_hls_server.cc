@@ -0,0 +1,338 @@
+#include "local_hls_server.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+namespace pro_video_player {
+
+namespace {
+
+constexpr size_t kMaxRequestHead = 16 * 1024;
+// Idle keep-alive connections give their thread back after this.
+constexpr int kIdleTimeoutSeconds = 60;
+
+const char* StatusText(int status) {
+  switch (status) {
+    case 200:
+      return "OK";
+    case 206:
+      return "Partial Content";
+    case 400:
+      return "Bad Request";
+    case 404:
+      return "Not Found";
+    case 405:
+      return "Method Not Allowed";
+    case 416:
+      return "Range Not Satisfiable";
+    default:
+      return "Internal Server Error";
+  }
+}
+
+std::string Lower(std::string value) {
+  std::transform(value.begin(), value.end(), value.begin(),
+                 [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+  return value;
+}
+
+// Value of header |name| (lower case) in a request head, or empty.
+std::string HeaderValue(const std::string& head, const std::string& name) {
+  size_t line = head.find("\r\n");
+  while (line != std::string::npos) {
+    const size_t start = line + 2;
+    line = head.find("\r\n", start);
+    const std::string text = head.substr(start, line == std::string::npos ? std::string::npos : line - start);
+    const size_t colon = text.find(':');
+    if (colon == std::string::npos || Lower(text.substr(0, colon)) != name) continue;
+    const size_t value = text.find_first_not_of(' ', colon + 1);
+    return value == std::string::npos ? std::string() : text.substr(value);
+  }
+  return std::string();
+}
+
+bool ParseNumber(const std::string& text, int64_t* value) {
+  if (text.empty() || text.size() > 18) return false;
+  *value = 0;
+  for (const char c : text) {
+    if (c < '0' || c > '9') return false;
+    *value = *value * 10 + (c - '0');
+  }
+  return true;
+}
+
+// A single "bytes=" range of a body of |size| bytes as [first, last].
+// 0 when there is none or several (answered in full), 1 when it is valid,
+// -1 when it can't be satisfied.
+int ParseRange(const std::string& header, int64_t size, int64_t* first, int64_t* last) {
+  if (header.compare(0, 6, "bytes=") != 0 || header.find(',') != std::string::npos) return 0;
+  const std::string spec = header.substr(6);
+  const size_t dash = spec.find('-');
+  if (dash == std::string::npos) return -1;
+  int64_t start = 0;
+  int64_t end = 0;
+  if (dash == 0) {
+    if (!ParseNumber(spec.substr(1), &end) || end == 0 || size == 0) return -1;
+    *first = std::max<int64_t>(size - end, 0);
+    *last = size - 1;
+    return 1;
+  }
+  if (!ParseNumber(spec.substr(0, dash), &start) || start >= size) return -1;
+  *first = start;
+  *last = size - 1;
+  if (dash + 1 < spec.size()) {
+    if (!ParseNumber(spec.substr(dash + 1), &end) || end < start) return -1;
+    *last = std::min(end, size - 1);
+  }
+  return 1;
+}
+
+bool SendAll(int fd, const char* data, size_t size) {
+  while (size > 0) {
+    const ssize_t sent = send(fd, data, size, MSG_NOSIGNAL);
+    if (sent <= 0) return false;
+    data += sent;
+    size -= static_cast<size_t>(sent);
+  }
+  return true;
+}
+
+// Bytes [offset, offset + size) of the source file.
+bool SendFileRange(int fd, const HlsRemuxer& remuxer, int64_t offset, int64_t size) {
+#ifdef __linux__
+  off_t position = static_cast<off_t>(offset);
+  while (size > 0) {
+    const ssize_t sent = sendfile(fd, remuxer.fd(), &position, static_cast<size_t>(size));
+    if (sent <= 0) return false;
+    size -= sent;
+  }
+  return true;
+#else
+  return SendAll(fd, reinterpret_cast<const char*>(remuxer.data() + offset), static_cast<size_t>(size));
+#endif
+}
+
+// Bytes [first, last] of |fragment|: its header, then its file ranges.
+bool SendFragment(int fd, const HlsRemuxer& remuxer, const Fmp4Fragment& fragment, int64_t first, int64_t last) {
+  int64_t position = 0;
+  const auto header_size = static_cast<int64_t>(fragment.header.size());
+  if (first < header_size) {
+    const int64_t end = std::min(last + 1, header_size);
+    if (!SendAll(fd, fragment.header.data() + first, static_cast<size_t>(end - first))) return false;
+  }
+  position = header_size;
+  for (const auto& range : fragment.payload) {
+    const int64_t start = std::max(first, position);
+    const int64_t end = std::min(last + 1, position + range.size);
+    if (start < end && !SendFileRange(fd, remuxer, range.offset + start - position, end - start)) return false;
+    position += range.size;
+    if (position > last) break;
+  }
+  return true;
+}
+
+}  // namespace
+
+LocalHlsServer& LocalHlsServer::Instance() {
+  static LocalHlsServer server;
+  return server;
+}
+
+LocalHlsServer::~LocalHlsServer() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  stopping_ = true;
+  if (listen_fd_ >= 0) shutdown(listen_fd_, SHUT_RDWR);
+  lock.unlock();
+  if (accept_thread_.joinable()) accept_thread_.join();
+  lock.lock();
+  if (listen_fd_ >= 0) close(listen_fd_);
+  for (const int fd : client_fds_) shutdown(fd, SHUT_RDWR);
+  idle_cv_.wait(lock, [this]() { return client_fds_.empty(); });
+}
+
+std::string LocalHlsServer::Publish(const std::string& path, HlsRemuxer::Options options, std::string* error) {
+  std::shared_ptr<const HlsRemuxer> remuxer = HlsRemuxer::Open(path, options, error);
+  if (!remuxer) return std::string();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (listen_fd_ < 0 && !Start(error)) return std::string();
+  static std::mt19937_64 random{std::random_device{}()};
+  std::string token;
+  do {
+    char text[33];
+    std::snprintf(text, sizeof(text), "%016llx%016llx", static_cast<unsigned long long>(random()),
+                  static_cast<unsigned long long>(random()));
+    token = text;
+  } while (published_.count(token) != 0);
+  published_[token] = std::move(remuxer);
+  return "http://127.0.0.1:" + std::to_string(port_) + "/" + token + "/index.m3u8";
+}
+
+void LocalHlsServer::Unpublish(const std::string& url) {
+  const size_t host = url.find("://");
+  const size_t start = url.find('/', host == std::string::npos ? 0 : host + 3);
+  if (start == std::string::npos) return;
+  const size_t end = url.find('/', start + 1);
+  std::lock_guard<std::mutex> lock(mutex_);
+  published_.erase(url.substr(start + 1, end == std::string::npos ? std::string::npos : end - start - 1));
+}
+
+int LocalHlsServer::port() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return port_;
+}
+
+bool LocalHlsServer::Start(std::string* error) {
+  if (stopping_) {
+    *error = "Local HLS server is stopping";
+    return false;
+  }
+  const int fd = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t length = sizeof(address);
+  if (fd < 0 || bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+      getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length) != 0 || listen(fd, 64) != 0) {
+    if (fd >= 0) close(fd);
+    *error = "Can't listen on 127.0.0.1";
+    return false;
+  }
+  fcntl(fd, F_SETFD, FD_CLOEXEC);
+  listen_fd_ = fd;
+  port_ = ntohs(address.sin_port);
+  accept_thread_ = std::thread([this]() { AcceptLoop(); });
+  return true;
+}
+
+void LocalHlsServer::AcceptLoop() {
+  for (;;) {
+    const int fd = accept(listen_fd_, nullptr, nullptr);
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (fd < 0) {
+      if (stopping_) return;
+      // Out of descriptors, most likely; let connections finish
+      lock.unlock();
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      continue;
+    }
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+    if (stopping_ || client_fds_.size() >= static_cast<size_t>(kMaxConnections)) {
+      close(fd);
+      continue;
+    }
+    timeval timeout{kIdleTimeoutSeconds, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    client_fds_.push_back(fd);
+    std::thread([this, fd]() { Serve(fd); }).detach();
+  }
+}
+
+void LocalHlsServer::Serve(int fd) {
+  std::string buffer;
+  char chunk[4096];
+  for (;;) {
+    size_t end;
+    bool open = true;
+    while (open && (end = buffer.find("\r\n\r\n")) == std::string::npos) {
+      const ssize_t received = buffer.size() < kMaxRequestHead ? recv(fd, chunk, sizeof(chunk), 0) : 0;
+      if (received <= 0) open = false;
+      if (received > 0) buffer.append(chunk, static_cast<size_t>(received));
+    }
+    if (!open) break;
+    const std::string head = buffer.substr(0, end);
+    buffer.erase(0, end + 4);
+    if (!Respond(fd, head)) break;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  close(fd);
+  client_fds_.erase(std::remove(client_fds_.begin(), client_fds_.end(), fd), client_fds_.end());
+  idle_cv_.notify_all();
+}
+
+bool LocalHlsServer::Respond(int fd, const std::string& head) {
+  // "GET /<token>/<name> HTTP/1.1"
+  const size_t method_end = head.find(' ');
+  const size_t target_end = method_end == std::string::npos ? method_end : head.find(' ', method_end + 1);
+  const std::string method = head.substr(0, method_end);
+  std::string target;
+  if (target_end != std::string::npos) target = head.substr(method_end + 1, target_end - method_end - 1);
+  target = target.substr(0, target.find('?'));
+  const bool http10 = head.compare(target_end + 1, 8, "HTTP/1.0") == 0;
+  const std::string connection = Lower(HeaderValue(head, "connection"));
+  const bool keep_alive = http10 ? connection == "keep-alive" : connection != "close";
+
+  int status = 200;
+  const char* content_type = "video/mp4";
+  std::shared_ptr<const HlsRemuxer> remuxer;
+  Fmp4Fragment body;
+  if (target.size() < 2 || target[0] != '/') {
+    status = 400;
+  } else if (method != "GET" && method != "HEAD") {
+    status = 405;
+  } else {
+    const size_t slash = target.find('/', 1);
+    const std::string name = slash == std::string::npos ? std::string() : target.substr(slash + 1);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      const auto found = published_.find(target.substr(1, slash == std::string::npos ? slash : slash - 1));
+      if (found != published_.end()) remuxer = found->second;
+    }
+    int64_t index = -1;
+    const bool segment = name.size() > 7 && name.compare(0, 3, "seg") == 0 &&
+                         name.compare(name.size() - 4, 4, ".m4s") == 0 &&
+                         ParseNumber(name.substr(3, name.size() - 7), &index);
+    std::string error;
+    if (!remuxer) {
+      status = 404;
+    } else if (name == "index.m3u8") {
+      content_type = "application/vnd.apple.mpegurl";
+      body.header = remuxer->playlist();
+    } else if (name == "init.mp4") {
+      body.header = remuxer->init_segment();
+    } else if (!segment || index >= static_cast<int64_t>(remuxer->segment_count())) {
+      status = 404;
+    } else if (!remuxer->Segment(static_cast<size_t>(index), &body, &error)) {
+      status = 500;
+    }
+  }
+
+  const int64_t size = body.size();
+  int64_t first = 0;
+  int64_t last = size - 1;
+  std::string headers;
+  if (status == 200) {
+    const int range = ParseRange(HeaderValue(head, "range"), size, &first, &last);
+    if (range > 0) {
+      status = 206;
+      headers += "Content-Range: bytes " + std::to_string(first) + "-" + std::to_string(last) + "/" +
+                 std::to_string(size) + "\r\n";
+    } else if (range < 0) {
+      status = 416;
+      headers += "Content-Range: bytes */" + std::to_string(size) + "\r\n";
+    }
+  }
+  const bool has_body = status == 200 || status == 206;
+  const int64_t length = has_body ? last - first + 1 : 0;
+  std::string response = "HTTP/1.1 " + std::to_string(status) + " " + StatusText(status) + "\r\n" + headers;
+  if (has_body) response += std::string("Content-Type: ") + content_type + "\r\nAccept-Ranges: bytes\r\n";
+  response += "Content-Length: " + std::to_string(length) + "\r\n";
+  response += keep_alive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+  if (!SendAll(fd, response.data(), response.size())) return false;
+  if (has_body && method == "GET" && length > 0 && !SendFragment(fd, *remuxer, body, first, last)) return false;
+  return keep_alive;
+}
+
+}  // namespace pro_video_player
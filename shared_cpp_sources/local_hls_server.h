@@ -0,0 +1,67 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_LOCAL_HLS_SERVER_H_
+#define PRO_VIDEO_PLAYER_SHARED_LOCAL_HLS_SERVER_H_
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "hls_remuxer.h"
+
+namespace pro_video_player {
+
+// Serves local files remuxed to HLS (HlsRemuxer) over HTTP on 127.0.0.1,
+// for decoders that only take URLs: publish a file, then open the returned
+// playlist URL as a network source.
+//
+// HTTP/1.1 with keep-alive, GET and HEAD, and single byte ranges. Segment
+// payloads go from the mapped file to the socket with sendfile() where
+// there is one. A thread per connection, up to kMaxConnections; the socket
+// is opened with the first Publish().
+//
+// Thread-safe. Unpublishing doesn't cut off responses in flight.
+class LocalHlsServer {
+ public:
+  static constexpr int kMaxConnections = 32;
+
+  static LocalHlsServer& Instance();
+
+  LocalHlsServer() = default;
+  // Closes the socket and every connection, then waits for their threads.
+  ~LocalHlsServer();
+
+  LocalHlsServer(const LocalHlsServer&) = delete;
+  LocalHlsServer& operator=(const LocalHlsServer&) = delete;
+
+  // Remuxes |path| and returns its playlist URL, under a random path that
+  // other local processes can't guess. Empty with |error| on failure.
+  std::string Publish(const std::string& path, HlsRemuxer::Options options, std::string* error);
+  void Unpublish(const std::string& url);
+
+  // 0 until the first Publish().
+  int port() const;
+
+ private:
+  bool Start(std::string* error);
+  void AcceptLoop();
+  void Serve(int fd);
+  // Answers one request; false once the connection should close.
+  bool Respond(int fd, const std::string& head);
+
+  mutable std::mutex mutex_;
+  std::condition_variable idle_cv_;
+  int listen_fd_ = -1;
+  int port_ = 0;
+  bool stopping_ = false;
+  std::thread accept_thread_;
+  // Open connections, each served by a detached thread.
+  std::vector<int> client_fds_;
+  std::map<std::string, std::shared_ptr<const HlsRemuxer>> published_;  // by path token
+};
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_LOCAL_HLS_SERVER_H_
@@ -0,0 +1,79 @@
+#include "media_clock.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace pro_video_player {
+
+namespace {
+
+int64_t SteadyNowMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+MediaClock::MediaClock() : MediaClock(&SteadyNowMicros) {}
+
+MediaClock::MediaClock(TimeSource now) : now_(std::move(now)) { anchor_time_us_ = now_(); }
+
+void MediaClock::Anchor(int64_t position_ms) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  anchor_position_ms_ = std::max<int64_t>(0, position_ms);
+  anchor_time_us_ = now_();
+}
+
+void MediaClock::Start() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (running_) return;
+  anchor_time_us_ = now_();
+  running_ = true;
+}
+
+void MediaClock::Stop() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!running_) return;
+  anchor_position_ms_ = PositionLocked();
+  anchor_time_us_ = now_();
+  running_ = false;
+}
+
+bool MediaClock::running() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return running_;
+}
+
+void MediaClock::SetRate(double rate) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  anchor_position_ms_ = PositionLocked();
+  anchor_time_us_ = now_();
+  rate_ = rate;
+}
+
+double MediaClock::rate() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return rate_;
+}
+
+void MediaClock::SetDuration(int64_t duration_ms) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  duration_ms_ = std::max<int64_t>(0, duration_ms);
+}
+
+int64_t MediaClock::PositionMs() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return PositionLocked();
+}
+
+int64_t MediaClock::PositionLocked() const {
+  int64_t position = anchor_position_ms_;
+  if (running_) {
+    position += static_cast<int64_t>((now_() - anchor_time_us_) * rate_ / 1000.0);
+  }
+  if (duration_ms_ > 0) position = std::min(position, duration_ms_);
+  return std::max<int64_t>(0, position);
+}
+
+}  // namespace pro_video_player
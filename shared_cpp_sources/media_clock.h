@@ -0,0 +1,53 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_MEDIA_CLOCK_H_
+#define PRO_VIDEO_PLAYER_SHARED_MEDIA_CLOCK_H_
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+namespace pro_video_player {
+
+// Interpolated playback position.
+//
+// The backend is queried for the real position only on ticks; in between,
+// position is extrapolated from the last anchor at the current rate. This
+// keeps getPosition() cheap and callable from any thread.
+class MediaClock {
+ public:
+  // Monotonic time in microseconds; injectable for tests.
+  using TimeSource = std::function<int64_t()>;
+
+  MediaClock();
+  explicit MediaClock(TimeSource now);
+
+  // Sets the position at the current time without changing running/rate.
+  void Anchor(int64_t position_ms);
+
+  void Start();
+  void Stop();
+  bool running() const;
+
+  // Re-anchors at the current position so the rate change applies from now.
+  void SetRate(double rate);
+  double rate() const;
+
+  // Upper bound for extrapolation; 0 means unknown (live or not prepared).
+  void SetDuration(int64_t duration_ms);
+
+  int64_t PositionMs() const;
+
+ private:
+  int64_t PositionLocked() const;
+
+  TimeSource now_;
+  mutable std::mutex mutex_;
+  int64_t anchor_position_ms_ = 0;
+  int64_t anchor_time_us_ = 0;
+  int64_t duration_ms_ = 0;
+  double rate_ = 1.0;
+  bool running_ = false;
+};
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_MEDIA_CLOCK_H_
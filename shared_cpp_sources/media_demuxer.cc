@@ -0,0 +1,46 @@
+#include "media_demuxer.h"
+
+#include <cstring>
+#include <limits>
+
+#include "mkv_demuxer.h"
+#include "mp4_demuxer.h"
+
+namespace pro_video_player {
+
+bool RescaleTime(int64_t ticks, uint32_t from, uint32_t to, int64_t* out) {
+  if (from == 0) return false;
+  // Whole seconds and the rest apart, so only a result that really doesn't
+  // fit can overflow; the rest (< |from|) times |to| fits in 64 bits
+  const int64_t whole = ticks / from;
+  const int64_t rest = ticks % from;
+  const auto rest_scaled = static_cast<int64_t>(static_cast<uint64_t>(rest < 0 ? -rest : rest) * to / from);
+  int64_t scaled = 0;
+#if defined(_MSC_VER)
+  constexpr int64_t kMax = std::numeric_limits<int64_t>::max();
+  if (to != 0 && (whole > kMax / to || whole < -(kMax / to))) return false;
+  scaled = whole * static_cast<int64_t>(to);
+  if (scaled > kMax - rest_scaled || scaled < -kMax + rest_scaled) return false;
+  *out = rest < 0 ? scaled - rest_scaled : scaled + rest_scaled;
+  return true;
+#else
+  if (__builtin_mul_overflow(whole, static_cast<int64_t>(to), &scaled)) return false;
+  return !(rest < 0 ? __builtin_sub_overflow(scaled, rest_scaled, out)
+                    : __builtin_add_overflow(scaled, rest_scaled, out));
+#endif
+}
+
+std::unique_ptr<MediaDemuxer> OpenMediaDemuxer(const uint8_t* data, size_t size, std::string* error) {
+  static const uint8_t kEbmlMagic[] = {0x1A, 0x45, 0xDF, 0xA3};
+  if (size >= 4 && std::memcmp(data, kEbmlMagic, 4) == 0) return MkvDemuxer::Open(data, size, error);
+  if (size >= 8) {
+    static const char* const kFirstBoxes[] = {"ftyp", "moov", "mdat", "free", "wide", "skip"};
+    for (const char* type : kFirstBoxes) {
+      if (std::memcmp(data + 4, type, 4) == 0) return Mp4Demuxer::Open(data, size, error);
+    }
+  }
+  *error = "Not an MP4 or Matroska file";
+  return nullptr;
+}
+
+}  // namespace pro_video_player
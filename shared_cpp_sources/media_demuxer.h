@@ -0,0 +1,94 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_MEDIA_DEMUXER_H_
+#define PRO_VIDEO_PLAYER_SHARED_MEDIA_DEMUXER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace pro_video_player {
+
+enum class DemuxedTrackKind {
+  kVideo,
+  kAudio,
+};
+
+// One access unit, left where it is in the file.
+struct DemuxedSample {
+  int64_t offset = 0;
+  uint32_t size = 0;
+  // Decode time and duration in the track's timescale.
+  int64_t dts = 0;
+  uint32_t duration = 0;
+  // Presentation minus decode time; negative after B-frame reordering or
+  // an edit list.
+  int32_t composition_offset = 0;
+  bool keyframe = false;
+};
+
+struct DemuxedTrack {
+  DemuxedTrackKind kind = DemuxedTrackKind::kVideo;
+  uint32_t timescale = 0;
+  // Sample entry type: "avc1", "hvc1", "av01", "mp4a", "Opus", ...
+  std::string fourcc;
+  // The whole ISO BMFF sample entry box (with its avcC, esds, ...), as an
+  // fMP4 stsd needs it.
+  std::vector<uint8_t> sample_entry;
+  int width = 0;
+  int height = 0;
+  // ISO 639-2/T; "und" if unknown.
+  std::string language = "und";
+  // In the timescale; 0 if unknown.
+  int64_t duration = 0;
+};
+
+// Where a segment may start: a keyframe of the video track (any sample in
+// audio-only files).
+struct SyncPoint {
+  // Presentation time.
+  int64_t time_us = 0;
+  // Demuxer-specific: a sample number, a cluster offset.
+  int64_t position = 0;
+};
+
+// Reads the index of a media file that is in memory (mapped) and hands
+// out samples as file ranges, for remuxing without copying media data.
+// At most one video and one audio track are picked, the first of each.
+//
+// Implementations are immutable once created, so ReadSamples() may run
+// on several threads at once.
+class MediaDemuxer {
+ public:
+  virtual ~MediaDemuxer() = default;
+
+  // Video first, if any.
+  const std::vector<DemuxedTrack>& tracks() const { return tracks_; }
+  int64_t duration_us() const { return duration_us_; }
+
+  // Ascending by time; the first is the start of the file.
+  virtual const std::vector<SyncPoint>& sync_points() const = 0;
+
+  // The samples of each track (in tracks() order, decode order) from
+  // |from| up to |to|, or the end of the file if |to| is null. Video is cut
+  // at the sync samples themselves, other tracks by presentation time.
+  virtual bool ReadSamples(const SyncPoint& from, const SyncPoint* to,
+                           std::vector<std::vector<DemuxedSample>>* samples, std::string* error) const = 0;
+
+ protected:
+  std::vector<DemuxedTrack> tracks_;
+  int64_t duration_us_ = 0;
+};
+
+// |ticks| of a |from| Hz clock in a |to| Hz clock, truncated towards zero.
+// False if |from| is 0 or the result doesn't fit: times come from
+// untrusted files.
+bool RescaleTime(int64_t ticks, uint32_t from, uint32_t to, int64_t* out);
+
+// Picks the demuxer from the first bytes: ISO BMFF (MP4, MOV, M4V) or
+// Matroska (MKV, WebM). |data| must outlive the demuxer.
+std::unique_ptr<MediaDemuxer> OpenMediaDemuxer(const uint8_t* data, size_t size, std::string* error);
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_MEDIA_DEMUXER_H_
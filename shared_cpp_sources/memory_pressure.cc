@@ -0,0 +1,140 @@
+#include "memory_pressure.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#include "trace_recorder.h"
+
+namespace pro_video_player {
+
+namespace {
+
+bool ReadFile(const std::string& path, std::string* content) {
+  std::ifstream file(path);
+  if (!file) return false;
+  std::ostringstream buffer;
+  buffer << file.rdbuf();
+  *content = buffer.str();
+  return true;
+}
+
+// "some avg10=1.50 avg60=0.20 avg300=0.00 total=1234" -> 1.50 for the
+// line starting with |kind|.
+double PressureAvg10(const std::string& pressure, const std::string& kind) {
+  std::istringstream lines(pressure);
+  std::string line;
+  while (std::getline(lines, line)) {
+    if (line.compare(0, kind.size() + 1, kind + " ") != 0) continue;
+    const size_t field = line.find("avg10=");
+    if (field == std::string::npos) return 0;
+    return std::strtod(line.c_str() + field + 6, nullptr);
+  }
+  return 0;
+}
+
+}  // namespace
+
+const char* MemoryPressureLevelName(MemoryPressureLevel level) {
+  switch (level) {
+    case MemoryPressureLevel::kNone:
+      return "none";
+    case MemoryPressureLevel::kModerate:
+      return "moderate";
+    case MemoryPressureLevel::kCritical:
+      return "critical";
+  }
+  return "none";
+}
+
+std::string MemoryPressureMonitor::DetectCgroupDir() {
+  std::string content;
+  if (!ReadFile("/proc/self/cgroup", &content)) return std::string();
+  // cgroup v2 has a single "0::/path" entry
+  std::istringstream lines(content);
+  std::string line;
+  while (std::getline(lines, line)) {
+    if (line.compare(0, 3, "0::") != 0) continue;
+    std::string dir = "/sys/fs/cgroup" + line.substr(3);
+    if (!dir.empty() && dir.back() == '/') dir.pop_back();
+    std::ifstream current(dir + "/memory.current");
+    return current ? dir : std::string();
+  }
+  return std::string();
+}
+
+bool MemoryPressureMonitor::ReadStats(const std::string& cgroup_dir, MemoryStats* stats) {
+  std::string content;
+  if (!ReadFile(cgroup_dir + "/memory.current", &content)) return false;
+  *stats = MemoryStats();
+  stats->current_bytes = std::strtoll(content.c_str(), nullptr, 10);
+  if (ReadFile(cgroup_dir + "/memory.max", &content) && content.compare(0, 3, "max") != 0) {
+    stats->max_bytes = std::strtoll(content.c_str(), nullptr, 10);
+  }
+  if (ReadFile(cgroup_dir + "/memory.pressure", &content)) {
+    stats->some_avg10 = PressureAvg10(content, "some");
+    stats->full_avg10 = PressureAvg10(content, "full");
+  }
+  return true;
+}
+
+MemoryPressureLevel MemoryPressureMonitor::Classify(const MemoryStats& stats, const Options& options) {
+  const double usage = stats.max_bytes > 0
+                           ? static_cast<double>(stats.current_bytes) / static_cast<double>(stats.max_bytes)
+                           : 0;
+  if (usage >= options.critical_usage || stats.some_avg10 >= options.critical_some_avg10 ||
+      stats.full_avg10 >= options.critical_full_avg10) {
+    return MemoryPressureLevel::kCritical;
+  }
+  if (usage >= options.moderate_usage || stats.some_avg10 >= options.moderate_some_avg10) {
+    return MemoryPressureLevel::kModerate;
+  }
+  return MemoryPressureLevel::kNone;
+}
+
+MemoryPressureMonitor::MemoryPressureMonitor(Options options, Callback callback)
+    : options_(std::move(options)), callback_(std::move(callback)) {
+  if (options_.cgroup_dir.empty()) options_.cgroup_dir = DetectCgroupDir();
+  MemoryStats stats;
+  if (options_.cgroup_dir.empty() || !ReadStats(options_.cgroup_dir, &stats)) return;
+  thread_ = std::thread(&MemoryPressureMonitor::Run, this);
+}
+
+MemoryPressureMonitor::~MemoryPressureMonitor() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  stop_cv_.notify_all();
+  if (thread_.joinable()) thread_.join();
+}
+
+void MemoryPressureMonitor::Run() {
+  TraceRecorder::Instance().SetCurrentThreadName("pvp-memory");
+  MemoryPressureLevel level = MemoryPressureLevel::kNone;
+  MemoryShedStep step = MemoryShedStep::kCaches;
+  for (;;) {
+    MemoryStats stats;
+    if (ReadStats(options_.cgroup_dir, &stats)) {
+      const MemoryPressureLevel now = Classify(stats, options_);
+      if (now == MemoryPressureLevel::kCritical) {
+        step = MemoryShedStep::kForwardBuffers;
+      } else if (now == MemoryPressureLevel::kModerate && level != MemoryPressureLevel::kNone) {
+        step = static_cast<MemoryShedStep>(
+            std::min(static_cast<int>(step) + 1, static_cast<int>(MemoryShedStep::kForwardBuffers)));
+      } else {
+        step = MemoryShedStep::kCaches;
+      }
+      if (now != MemoryPressureLevel::kNone || level != MemoryPressureLevel::kNone) {
+        PVP_TRACE_INSTANT("memory", MemoryPressureLevelName(now), -1);
+        callback_(now, step, stats);
+      }
+      level = now;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (stop_cv_.wait_for(lock, options_.interval, [&]() { return stopping_; })) return;
+  }
+}
+
+}  // namespace pro_video_player
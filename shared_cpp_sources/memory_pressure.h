@@ -0,0 +1,109 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_MEMORY_PRESSURE_H_
+#define PRO_VIDEO_PLAYER_SHARED_MEMORY_PRESSURE_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace pro_video_player {
+
+enum class MemoryPressureLevel {
+  kNone,
+  kModerate,
+  kCritical,
+};
+
+// Name used in "memoryPressure" events ("none", "moderate", "critical").
+const char* MemoryPressureLevelName(MemoryPressureLevel level);
+
+// What players give up under pressure, in order: each step includes the
+// ones before it. Cheapest to rebuild first, playback quality last.
+enum class MemoryShedStep {
+  // Idle frame buffers, in-memory waveform peaks.
+  kCaches,
+  // Embedded subtitle cues away from the playhead (the demuxer re-reads
+  // them on a seek).
+  kSubtitleWindows,
+  // Forward and back buffers, halved on every step down to the kMin tier.
+  kForwardBuffers,
+};
+
+// One reading of a cgroup v2 memory controller.
+struct MemoryStats {
+  int64_t current_bytes = 0;
+  // -1 if the cgroup has no limit ("max").
+  int64_t max_bytes = -1;
+  // PSI averages over 10 s, in percent of wall time: some task stalled on
+  // memory, or all of them.
+  double some_avg10 = 0;
+  double full_avg10 = 0;
+};
+
+// Watches the memory controller of the process's cgroup (v2) and reports
+// pressure levels, so a player in a memory-limited container sheds its
+// buffers before the OOM killer picks it.
+//
+// Level comes from PSI (memory.pressure) and from memory.current against
+// memory.max. The usage thresholds are high because memory.current counts
+// page cache the kernel can reclaim on its own. Files are polled; PSI
+// triggers would wake up sooner but need write access to memory.pressure,
+// which unprivileged containers usually don't get.
+//
+// While pressure lasts the callback runs on every poll, with the shed step
+// advancing one per poll from kCaches (kCritical goes straight to
+// kForwardBuffers). It runs once more with kNone when pressure ends.
+// Callbacks run on the monitor's own thread.
+class MemoryPressureMonitor {
+ public:
+  struct Options {
+    // cgroup directory; empty means the process's own (see
+    // DetectCgroupDir).
+    std::string cgroup_dir;
+    std::chrono::milliseconds interval{1000};
+    double moderate_usage = 0.90;
+    double critical_usage = 0.97;
+    double moderate_some_avg10 = 10;
+    double critical_some_avg10 = 40;
+    double critical_full_avg10 = 10;
+  };
+
+  using Callback =
+      std::function<void(MemoryPressureLevel level, MemoryShedStep step, const MemoryStats& stats)>;
+
+  // /sys/fs/cgroup/<path from /proc/self/cgroup>, or empty without a
+  // cgroup v2 memory controller.
+  static std::string DetectCgroupDir();
+  // False if memory.current can't be read; missing memory.max or
+  // memory.pressure (no PSI in the kernel) leave their fields at defaults.
+  static bool ReadStats(const std::string& cgroup_dir, MemoryStats* stats);
+  static MemoryPressureLevel Classify(const MemoryStats& stats, const Options& options);
+
+  MemoryPressureMonitor(Options options, Callback callback);
+  ~MemoryPressureMonitor();
+
+  MemoryPressureMonitor(const MemoryPressureMonitor&) = delete;
+  MemoryPressureMonitor& operator=(const MemoryPressureMonitor&) = delete;
+
+  // False if there is no cgroup to watch; the monitor then does nothing.
+  bool running() const { return thread_.joinable(); }
+  const std::string& cgroup_dir() const { return options_.cgroup_dir; }
+
+ private:
+  void Run();
+
+  Options options_;
+  const Callback callback_;
+
+  std::mutex mutex_;
+  std::condition_variable stop_cv_;
+  bool stopping_ = false;
+  std::thread thread_;
+};
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_MEMORY_PRESSURE_H_
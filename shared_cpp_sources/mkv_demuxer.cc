@@ -0,0 +1,607 @@
+#include "mkv_demuxer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#include "fmp4_writer.h"
+
+namespace pro_video_player {
+
+namespace {
+
+constexpr uint32_t kEbmlId = 0x1A45DFA3;
+constexpr uint32_t kSegmentId = 0x18538067;
+constexpr uint32_t kSeekHeadId = 0x114D9B74;
+constexpr uint32_t kSeekId = 0x4DBB;
+constexpr uint32_t kSeekIdId = 0x53AB;
+constexpr uint32_t kSeekPositionId = 0x53AC;
+constexpr uint32_t kInfoId = 0x1549A966;
+constexpr uint32_t kTimestampScaleId = 0x2AD7B1;
+constexpr uint32_t kDurationId = 0x4489;
+constexpr uint32_t kTracksId = 0x1654AE6B;
+constexpr uint32_t kTrackEntryId = 0xAE;
+constexpr uint32_t kTrackNumberId = 0xD7;
+constexpr uint32_t kTrackTypeId = 0x83;
+constexpr uint32_t kCodecIdId = 0x86;
+constexpr uint32_t kCodecPrivateId = 0x63A2;
+constexpr uint32_t kDefaultDurationId = 0x23E383;
+constexpr uint32_t kLanguageId = 0x22B59C;
+constexpr uint32_t kContentEncodingsId = 0x6D80;
+constexpr uint32_t kVideoId = 0xE0;
+constexpr uint32_t kPixelWidthId = 0xB0;
+constexpr uint32_t kPixelHeightId = 0xBA;
+constexpr uint32_t kAudioId = 0xE1;
+constexpr uint32_t kSamplingFrequencyId = 0xB5;
+constexpr uint32_t kChannelsId = 0x9F;
+constexpr uint32_t kCuesId = 0x1C53BB6B;
+constexpr uint32_t kCuePointId = 0xBB;
+constexpr uint32_t kCueTimeId = 0xB3;
+constexpr uint32_t kCueTrackPositionsId = 0xB7;
+constexpr uint32_t kCueTrackId = 0xF7;
+constexpr uint32_t kCueClusterPositionId = 0xF1;
+constexpr uint32_t kClusterId = 0x1F43B675;
+constexpr uint32_t kTimestampId = 0xE7;
+constexpr uint32_t kSimpleBlockId = 0xA3;
+constexpr uint32_t kBlockGroupId = 0xA0;
+constexpr uint32_t kBlockId = 0xA1;
+constexpr uint32_t kReferenceBlockId = 0xFB;
+
+// Largest TimestampScale taken as real: one tick per second. Real files
+// use 1ms (the default) or finer.
+constexpr uint64_t kMaxTimestampScale = 1000000000;
+
+constexpr uint64_t kTrackTypeVideo = 1;
+constexpr uint64_t kTrackTypeAudio = 2;
+
+// Segment children: where an unknown-size cluster ends.
+bool IsTopLevel(uint32_t id) {
+  switch (id) {
+    case kClusterId:
+    case kCuesId:
+    case kSeekHeadId:
+    case kInfoId:
+    case kTracksId:
+    case 0x1254C367:  // Tags
+    case 0x1043A770:  // Chapters
+    case 0x1941A469:  // Attachments
+    case kSegmentId:
+    case kEbmlId:
+      return true;
+    default:
+      return false;
+  }
+}
+
+struct Element {
+  uint32_t id = 0;
+  size_t start = 0;
+  size_t data = 0;
+  // -1: unknown, up to the end of the parent.
+  int64_t size = -1;
+
+  size_t end() const { return data + static_cast<size_t>(size); }
+};
+
+// EBML variable-length integer at |*pos|: IDs keep their length marker,
+// sizes don't.
+bool ReadVint(const uint8_t* data, size_t end, size_t* pos, bool keep_marker, int max_length, uint64_t* value,
+              int* length) {
+  if (*pos >= end) return false;
+  const uint8_t first = data[*pos];
+  int bytes = 1;
+  while (bytes <= max_length && (first & (0x80 >> (bytes - 1))) == 0) ++bytes;
+  if (bytes > max_length || end - *pos < static_cast<size_t>(bytes)) return false;
+  uint64_t result = keep_marker ? first : first & (0xff >> bytes);
+  for (int i = 1; i < bytes; ++i) result = (result << 8) | data[*pos + i];
+  *pos += bytes;
+  *value = result;
+  *length = bytes;
+  return true;
+}
+
+// Element header at |pos|; sizes past |end| are cut to it (truncated
+// files).
+bool ReadElement(const uint8_t* data, size_t end, size_t pos, Element* element) {
+  element->start = pos;
+  uint64_t id = 0;
+  uint64_t size = 0;
+  int length = 0;
+  if (!ReadVint(data, end, &pos, true, 4, &id, &length)) return false;
+  element->id = static_cast<uint32_t>(id);
+  if (!ReadVint(data, end, &pos, false, 8, &size, &length)) return false;
+  element->data = pos;
+  if (size == (uint64_t{1} << (7 * length)) - 1) {
+    element->size = -1;
+  } else {
+    element->size = static_cast<int64_t>(std::min<uint64_t>(size, end - pos));
+  }
+  return true;
+}
+
+// |ticks| of |scale| ns each, in ns; false if that overflows. |scale| is
+// at most kMaxTimestampScale.
+bool TicksToNs(int64_t ticks, uint64_t scale, int64_t* ns) {
+#if defined(_MSC_VER)
+  const auto factor = static_cast<int64_t>(scale);
+  if (ticks > std::numeric_limits<int64_t>::max() / factor || ticks < std::numeric_limits<int64_t>::min() / factor) {
+    return false;
+  }
+  *ns = ticks * factor;
+  return true;
+#else
+  return !__builtin_mul_overflow(ticks, static_cast<int64_t>(scale), ns);
+#endif
+}
+
+uint64_t ReadUint(const uint8_t* data, const Element& element) {
+  uint64_t value = 0;
+  for (int64_t i = 0; i < element.size && i < 8; ++i) value = (value << 8) | data[element.data + i];
+  return value;
+}
+
+double ReadFloat(const uint8_t* data, const Element& element) {
+  const uint64_t bits = ReadUint(data, element);
+  if (element.size == 4) {
+    float value;
+    const auto narrow = static_cast<uint32_t>(bits);
+    std::memcpy(&value, &narrow, 4);
+    return value;
+  }
+  if (element.size != 8) return 0;
+  double value;
+  std::memcpy(&value, &bits, 8);
+  return value;
+}
+
+std::string ReadString(const uint8_t* data, const Element& element) {
+  std::string value(reinterpret_cast<const char*>(data + element.data), static_cast<size_t>(element.size));
+  return value.substr(0, value.find('\0'));
+}
+
+// Calls |visit| for the children in [start, end), up to one of unknown
+// size.
+template <typename Visit>
+void ForEachChild(const uint8_t* data, size_t start, size_t end, Visit visit) {
+  Element element;
+  size_t pos = start;
+  while (pos < end && ReadElement(data, end, pos, &element) && element.size >= 0) {
+    visit(element);
+    pos = element.end();
+  }
+}
+
+struct TrackEntry {
+  uint64_t number = 0;
+  uint64_t type = 0;
+  std::string codec;
+  std::vector<uint8_t> codec_private;
+  int64_t default_duration_ns = 0;
+  std::string language = "eng";
+  int width = 0;
+  int height = 0;
+  double sample_rate = 8000;
+  int channels = 1;
+  bool encoded = false;
+};
+
+TrackEntry ParseTrackEntry(const uint8_t* data, const Element& entry) {
+  TrackEntry track;
+  ForEachChild(data, entry.data, entry.end(), [&](const Element& e) {
+    switch (e.id) {
+      case kTrackNumberId:
+        track.number = ReadUint(data, e);
+        break;
+      case kTrackTypeId:
+        track.type = ReadUint(data, e);
+        break;
+      case kCodecIdId:
+        track.codec = ReadString(data, e);
+        break;
+      case kCodecPrivateId:
+        track.codec_private.assign(data + e.data, data + e.end());
+        break;
+      case kDefaultDurationId:
+        track.default_duration_ns = static_cast<int64_t>(ReadUint(data, e));
+        break;
+      case kLanguageId:
+        track.language = ReadString(data, e);
+        break;
+      case kContentEncodingsId:
+        track.encoded = true;
+        break;
+      case kVideoId:
+        ForEachChild(data, e.data, e.end(), [&](const Element& v) {
+          if (v.id == kPixelWidthId) track.width = static_cast<int>(ReadUint(data, v));
+          if (v.id == kPixelHeightId) track.height = static_cast<int>(ReadUint(data, v));
+        });
+        break;
+      case kAudioId:
+        ForEachChild(data, e.data, e.end(), [&](const Element& a) {
+          if (a.id == kSamplingFrequencyId) track.sample_rate = ReadFloat(data, a);
+          if (a.id == kChannelsId) track.channels = static_cast<int>(ReadUint(data, a));
+        });
+        break;
+      default:
+        break;
+    }
+  });
+  return track;
+}
+
+// The fMP4 sample entry of a Matroska codec.
+bool MakeTrack(const TrackEntry& entry, DemuxedTrack* track, std::string* error) {
+  if (entry.encoded) {
+    *error = "Can't remux " + entry.codec + " with content encodings";
+    return false;
+  }
+  const auto& config = entry.codec_private;
+  struct VideoCodec {
+    const char* codec;
+    const char* fourcc;
+    const char* config_type;
+  };
+  static constexpr VideoCodec kVideoCodecs[] = {
+      {"V_MPEG4/ISO/AVC", "avc1", "avcC"},
+      {"V_MPEGH/ISO/HEVC", "hvc1", "hvcC"},
+      {"V_AV1", "av01", "av1C"},
+  };
+  for (const auto& codec : kVideoCodecs) {
+    if (entry.codec != codec.codec || config.empty()) continue;
+    track->fourcc = codec.fourcc;
+    track->sample_entry = Mp4VisualSampleEntry(codec.fourcc, entry.width, entry.height, codec.config_type, config);
+    return true;
+  }
+  const int rate = static_cast<int>(entry.sample_rate);
+  if (entry.codec.compare(0, 5, "A_AAC") == 0 && !config.empty()) {
+    track->fourcc = "mp4a";
+    track->sample_entry = Mp4AudioSampleEntry("mp4a", entry.channels, rate, Mp4EsdsBox(config));
+    return true;
+  }
+  std::vector<uint8_t> dops;
+  if (entry.codec == "A_OPUS" && Mp4OpusBox(config, &dops)) {
+    track->fourcc = "Opus";
+    track->sample_entry = Mp4AudioSampleEntry("Opus", entry.channels, 48000, dops);
+    return true;
+  }
+  *error = "Can't remux codec " + entry.codec;
+  return false;
+}
+
+}  // namespace
+
+std::unique_ptr<MkvDemuxer> MkvDemuxer::Open(const uint8_t* data, size_t size, std::string* error) {
+  Element header;
+  Element segment;
+  if (!ReadElement(data, size, 0, &header) || header.id != kEbmlId || header.size < 0) {
+    *error = "Not a Matroska file";
+    return nullptr;
+  }
+  if (!ReadElement(data, size, header.end(), &segment) || segment.id != kSegmentId) {
+    *error = "No Matroska segment";
+    return nullptr;
+  }
+  std::unique_ptr<MkvDemuxer> demuxer(new MkvDemuxer(data, size));
+  demuxer->segment_start_ = segment.data;
+  demuxer->segment_end_ = segment.size < 0 ? size : segment.end();
+
+  // Top-level elements; clusters are skipped by size, which touches only
+  // their headers
+  double duration = 0;
+  Element tracks;
+  Element cues;
+  int64_t cues_position = -1;
+  Element element;
+  size_t pos = demuxer->segment_start_;
+  while (pos < demuxer->segment_end_ && ReadElement(data, demuxer->segment_end_, pos, &element)) {
+    if (element.id == kClusterId && demuxer->first_cluster_ == 0) demuxer->first_cluster_ = element.start;
+    if (element.size < 0) break;
+    if (element.id == kInfoId) {
+      ForEachChild(data, element.data, element.end(), [&](const Element& e) {
+        if (e.id == kTimestampScaleId) demuxer->timestamp_scale_ = ReadUint(data, e);
+        if (e.id == kDurationId) duration = ReadFloat(data, e);
+      });
+    } else if (element.id == kTracksId) {
+      tracks = element;
+    } else if (element.id == kCuesId) {
+      cues = element;
+    } else if (element.id == kSeekHeadId) {
+      ForEachChild(data, element.data, element.end(), [&](const Element& seek) {
+        if (seek.id != kSeekId) return;
+        uint64_t id = 0;
+        int64_t position = -1;
+        ForEachChild(data, seek.data, seek.end(), [&](const Element& e) {
+          if (e.id == kSeekIdId) id = ReadUint(data, e);
+          if (e.id == kSeekPositionId) position = static_cast<int64_t>(ReadUint(data, e));
+        });
+        if (id == kCuesId) cues_position = position;
+      });
+    }
+    pos = element.end();
+  }
+  // Cues past a cluster of unknown size are only found through the SeekHead
+  if (cues.id != kCuesId && cues_position >= 0) {
+    if (!ReadElement(data, demuxer->segment_end_, demuxer->segment_start_ + static_cast<size_t>(cues_position),
+                     &cues) ||
+        cues.id != kCuesId || cues.size < 0) {
+      cues = Element();
+    }
+  }
+
+  if (demuxer->timestamp_scale_ == 0) demuxer->timestamp_scale_ = 1000000;
+  if (demuxer->timestamp_scale_ > kMaxTimestampScale) {
+    *error = "Invalid TimestampScale";
+    return nullptr;
+  }
+  if (tracks.id != kTracksId || !demuxer->ParseTracks(tracks.data, tracks.end(), error)) {
+    if (error->empty()) *error = "No audio or video track";
+    return nullptr;
+  }
+  if (demuxer->first_cluster_ == 0) {
+    *error = "No clusters";
+    return nullptr;
+  }
+  demuxer->duration_us_ = static_cast<int64_t>(duration * static_cast<double>(demuxer->timestamp_scale_) / 1000);
+  for (auto& track : demuxer->tracks_) track.duration = demuxer->duration_us_;
+
+  if (cues.id == kCuesId) demuxer->ParseCues(cues.data, cues.end(), demuxer->track_numbers_[0]);
+  if (demuxer->sync_points_.empty()) {
+    // No index: one pass over the blocks
+    auto& points = demuxer->sync_points_;
+    size_t cluster = demuxer->first_cluster_;
+    while (cluster != 0 && cluster < demuxer->segment_end_) {
+      const size_t end = demuxer->ParseCluster(cluster, [&](const Frame& frame) {
+        if (frame.track == 0 && frame.keyframe) points.push_back({frame.time_us, static_cast<int64_t>(cluster)});
+      });
+      if (end == 0) {
+        // Something else between clusters
+        if (!ReadElement(data, demuxer->segment_end_, cluster, &element) || element.size < 0) break;
+        cluster = element.end();
+      } else {
+        cluster = end;
+      }
+    }
+  }
+  auto& points = demuxer->sync_points_;
+  std::stable_sort(points.begin(), points.end(),
+                   [](const SyncPoint& a, const SyncPoint& b) { return a.time_us < b.time_us; });
+  points.erase(std::unique(points.begin(), points.end(),
+                           [](const SyncPoint& a, const SyncPoint& b) { return a.time_us == b.time_us; }),
+               points.end());
+  if (points.empty()) {
+    *error = "No keyframes";
+    return nullptr;
+  }
+  // The first range starts with the file, whatever comes before the first
+  // keyframe
+  points.front().time_us = std::min<int64_t>(points.front().time_us, 0);
+  points.front().position = static_cast<int64_t>(demuxer->first_cluster_);
+  return demuxer;
+}
+
+bool MkvDemuxer::ParseTracks(size_t start, size_t end, std::string* error) {
+  std::vector<TrackEntry> entries;
+  ForEachChild(data_, start, end, [&](const Element& e) {
+    if (e.id == kTrackEntryId) entries.push_back(ParseTrackEntry(data_, e));
+  });
+  for (const uint64_t type : {kTrackTypeVideo, kTrackTypeAudio}) {
+    const auto entry = std::find_if(entries.begin(), entries.end(),
+                                    [type](const TrackEntry& candidate) { return candidate.type == type; });
+    if (entry == entries.end()) continue;
+    DemuxedTrack track;
+    track.kind = type == kTrackTypeVideo ? DemuxedTrackKind::kVideo : DemuxedTrackKind::kAudio;
+    track.timescale = 1000000;
+    track.width = entry->width;
+    track.height = entry->height;
+    track.language = entry->language;
+    if (!MakeTrack(*entry, &track, error)) return false;
+    tracks_.push_back(std::move(track));
+    track_numbers_.push_back(entry->number);
+    default_duration_ns_.push_back(entry->default_duration_ns);
+  }
+  return !tracks_.empty();
+}
+
+void MkvDemuxer::ParseCues(size_t start, size_t end, uint64_t track_number) {
+  ForEachChild(data_, start, end, [&](const Element& point) {
+    if (point.id != kCuePointId) return;
+    uint64_t time = 0;
+    int64_t position = -1;
+    ForEachChild(data_, point.data, point.end(), [&](const Element& e) {
+      if (e.id == kCueTimeId) time = ReadUint(data_, e);
+      if (e.id != kCueTrackPositionsId) return;
+      uint64_t track = 0;
+      int64_t cluster = -1;
+      ForEachChild(data_, e.data, e.end(), [&](const Element& p) {
+        if (p.id == kCueTrackId) track = ReadUint(data_, p);
+        if (p.id == kCueClusterPositionId) cluster = static_cast<int64_t>(ReadUint(data_, p));
+      });
+      if (track == track_number && cluster >= 0) position = cluster;
+    });
+    if (position < 0 || segment_start_ + static_cast<uint64_t>(position) >= segment_end_) return;
+    // A time that doesn't fit is corrupt; the point is dropped
+    int64_t time_ns = 0;
+    if (time > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) ||
+        !TicksToNs(static_cast<int64_t>(time), timestamp_scale_, &time_ns)) {
+      return;
+    }
+    sync_points_.push_back({time_ns / 1000, static_cast<int64_t>(segment_start_) + position});
+  });
+}
+
+size_t MkvDemuxer::ParseCluster(size_t offset, const FrameVisitor& visit) const {
+  Element cluster;
+  if (!ReadElement(data_, segment_end_, offset, &cluster) || cluster.id != kClusterId) return 0;
+  const size_t end = cluster.size >= 0 ? cluster.end() : segment_end_;
+  int64_t cluster_time = 0;
+  Element child;
+  size_t pos = cluster.data;
+  while (pos < end && ReadElement(data_, end, pos, &child)) {
+    // A cluster of unknown size ends where the next top-level element starts
+    if (cluster.size < 0 && IsTopLevel(child.id)) return pos;
+    if (child.size < 0) break;
+    if (child.id == kTimestampId) {
+      // Capped so adding a block's offset can't overflow; scaling still can
+      cluster_time = static_cast<int64_t>(
+          std::min<uint64_t>(ReadUint(data_, child), std::numeric_limits<int64_t>::max() / 2));
+    } else if (child.id == kSimpleBlockId) {
+      ParseBlock(child.data, child.end(), cluster_time, -1, visit);
+    } else if (child.id == kBlockGroupId) {
+      Element block;
+      bool referenced = false;
+      ForEachChild(data_, child.data, child.end(), [&](const Element& e) {
+        if (e.id == kBlockId) block = e;
+        if (e.id == kReferenceBlockId) referenced = true;
+      });
+      if (block.id == kBlockId) ParseBlock(block.data, block.end(), cluster_time, referenced ? 0 : 1, visit);
+    }
+    pos = child.end();
+  }
+  return end;
+}
+
+bool MkvDemuxer::ParseBlock(size_t start, size_t end, int64_t cluster_time, int keyframe,
+                            const FrameVisitor& visit) const {
+  size_t pos = start;
+  uint64_t number = 0;
+  int length = 0;
+  if (!ReadVint(data_, end, &pos, false, 8, &number, &length) || end - pos < 3) return false;
+  const auto found = std::find(track_numbers_.begin(), track_numbers_.end(), number);
+  if (found == track_numbers_.end()) return true;
+  const auto track = static_cast<size_t>(found - track_numbers_.begin());
+  const auto relative = static_cast<int16_t>((data_[pos] << 8) | data_[pos + 1]);
+  const uint8_t flags = data_[pos + 2];
+  pos += 3;
+
+  // Lacing: none, Xiph, fixed-size or EBML
+  const int lacing = (flags >> 1) & 3;
+  std::vector<uint64_t> sizes;
+  if (lacing == 0) {
+    sizes.push_back(end - pos);
+  } else {
+    if (pos >= end) return false;
+    const size_t count = data_[pos++] + size_t{1};
+    if (lacing == 2) {
+      if ((end - pos) % count != 0) return false;
+      sizes.assign(count, (end - pos) / count);
+    } else {
+      uint64_t used = 0;
+      for (size_t i = 0; i + 1 < count; ++i) {
+        uint64_t size = 0;
+        if (lacing == 1) {
+          uint8_t byte = 255;
+          while (byte == 255) {
+            if (pos >= end) return false;
+            byte = data_[pos++];
+            size += byte;
+          }
+        } else {
+          uint64_t raw = 0;
+          if (!ReadVint(data_, end, &pos, false, 8, &raw, &length)) return false;
+          // Sizes after the first are signed differences from the previous
+          size = i == 0 ? raw : sizes.back() + raw - ((uint64_t{1} << (7 * length - 1)) - 1);
+        }
+        sizes.push_back(size);
+        used += size;
+      }
+      if (used > end - pos) return false;
+      sizes.push_back(end - pos - used);
+    }
+  }
+
+  // A time that doesn't fit is corrupt; the block is dropped
+  int64_t time_ns = 0;
+  if (!TicksToNs(cluster_time + relative, timestamp_scale_, &time_ns)) return false;
+  Frame frame;
+  frame.track = track;
+  frame.keyframe = keyframe < 0 ? (flags & 0x80) != 0 : keyframe != 0;
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    if (sizes[i] > end - pos) return false;
+    frame.time_us = (time_ns + static_cast<int64_t>(i) * default_duration_ns_[track]) / 1000;
+    frame.offset = static_cast<int64_t>(pos);
+    frame.size = static_cast<uint32_t>(sizes[i]);
+    visit(frame);
+    pos += sizes[i];
+  }
+  return true;
+}
+
+bool MkvDemuxer::ReadSamples(const SyncPoint& from, const SyncPoint* to,
+                             std::vector<std::vector<DemuxedSample>>* samples, std::string* error) const {
+  samples->assign(tracks_.size(), {});
+  const SyncPoint& first = sync_points_.front();
+  const bool at_start = from.position == first.position && from.time_us == first.time_us;
+  const int64_t lower = at_start ? std::numeric_limits<int64_t>::min() : from.time_us;
+  const int64_t upper = to != nullptr ? to->time_us : std::numeric_limits<int64_t>::max();
+
+  // Presentation times go into dts until decode times are worked out
+  bool started = false;
+  bool finished = false;
+  const FrameVisitor visit = [&](const Frame& frame) {
+    DemuxedSample sample;
+    sample.offset = frame.offset;
+    sample.size = frame.size;
+    sample.dts = frame.time_us;
+    sample.keyframe = frame.keyframe;
+    if (frame.track != 0) {
+      if (frame.time_us >= lower && frame.time_us < upper) (*samples)[frame.track].push_back(sample);
+      return;
+    }
+    if (finished) return;
+    if (!started) {
+      if (!frame.keyframe || frame.time_us < from.time_us) return;
+      started = true;
+    }
+    if (to != nullptr && frame.keyframe && frame.time_us >= to->time_us) {
+      finished = true;
+      return;
+    }
+    (*samples)[0].push_back(sample);
+  };
+
+  // Whole clusters: other tracks' frames up to |to| may follow its keyframe
+  size_t pos = static_cast<size_t>(from.position);
+  Element element;
+  while (!finished && pos < segment_end_) {
+    const size_t end = ParseCluster(pos, visit);
+    if (end == 0) {
+      if (!ReadElement(data_, segment_end_, pos, &element) || element.size < 0) break;
+      pos = element.end();
+    } else {
+      pos = end;
+    }
+  }
+  if (!started) {
+    *error = "No keyframe at the sync point";
+    return false;
+  }
+
+  for (size_t t = 0; t < samples->size(); ++t) {
+    auto& list = (*samples)[t];
+    if (tracks_[t].kind == DemuxedTrackKind::kVideo) {
+      // Decode order with presentation times: the sorted times serve as
+      // decode times, so reordered frames get their offsets back
+      std::vector<int64_t> sorted;
+      sorted.reserve(list.size());
+      for (const auto& sample : list) sorted.push_back(sample.dts);
+      std::sort(sorted.begin(), sorted.end());
+      for (size_t i = 0; i < list.size(); ++i) {
+        list[i].composition_offset = static_cast<int32_t>(list[i].dts - sorted[i]);
+        list[i].dts = sorted[i];
+      }
+    }
+    for (size_t i = 0; i + 1 < list.size(); ++i) {
+      list[i].duration = static_cast<uint32_t>(std::max<int64_t>(list[i + 1].dts - list[i].dts, 0));
+    }
+    if (list.empty()) continue;
+    int64_t last = 0;
+    if (t == 0 && to != nullptr) last = to->time_us - list.back().dts;
+    if (last <= 0) last = default_duration_ns_[t] / 1000;
+    if (last <= 0 && list.size() > 1) last = list[list.size() - 2].duration;
+    list.back().duration = static_cast<uint32_t>(std::max<int64_t>(last, 0));
+  }
+  return true;
+}
+
+}  // namespace pro_video_player
@@ -0,0 +1,69 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_MKV_DEMUXER_H_
+#define PRO_VIDEO_PLAYER_SHARED_MKV_DEMUXER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "media_demuxer.h"
+
+namespace pro_video_player {
+
+// Matroska and WebM. Sync points come from Cues (the first track's entries),
+// so opening reads the headers and the index but no media; only files
+// without Cues are scanned once for keyframes. ReadSamples() then parses
+// just the clusters of the range asked for.
+//
+// Timescales are microseconds. Blocks carry presentation times, so video
+// decode times are rebuilt per range as the sorted presentation times,
+// with negative composition offsets where frames were reordered.
+//
+// Codecs: H.264, HEVC and AV1 video; AAC and Opus audio. Tracks using
+// content encodings (header stripping, encryption) are refused.
+class MkvDemuxer : public MediaDemuxer {
+ public:
+  static std::unique_ptr<MkvDemuxer> Open(const uint8_t* data, size_t size, std::string* error);
+
+  const std::vector<SyncPoint>& sync_points() const override { return sync_points_; }
+  bool ReadSamples(const SyncPoint& from, const SyncPoint* to, std::vector<std::vector<DemuxedSample>>* samples,
+                   std::string* error) const override;
+
+ private:
+  // One frame of a (possibly laced) block of a picked track.
+  struct Frame {
+    size_t track = 0;
+    int64_t time_us = 0;
+    bool keyframe = false;
+    int64_t offset = 0;
+    uint32_t size = 0;
+  };
+  using FrameVisitor = std::function<void(const Frame& frame)>;
+
+  MkvDemuxer(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+  bool ParseTracks(size_t start, size_t end, std::string* error);
+  void ParseCues(size_t start, size_t end, uint64_t track_number);
+  // Visits the frames of the cluster at |offset|; returns where it ends, or
+  // 0 if there is no cluster there.
+  size_t ParseCluster(size_t offset, const FrameVisitor& visit) const;
+  bool ParseBlock(size_t start, size_t end, int64_t cluster_time, int keyframe, const FrameVisitor& visit) const;
+
+  const uint8_t* const data_;
+  const size_t size_;
+  size_t segment_start_ = 0;
+  size_t segment_end_ = 0;
+  size_t first_cluster_ = 0;
+  // Nanoseconds per block timestamp tick.
+  uint64_t timestamp_scale_ = 1000000;
+  // Per picked track.
+  std::vector<uint64_t> track_numbers_;
+  std::vector<int64_t> default_duration_ns_;
+  std::vector<SyncPoint> sync_points_;
+};
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_MKV_DEMUXER_H_
@@ -0,0 +1,432 @@
+#include "mp4_demuxer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+namespace pro_video_player {
+
+namespace {
+
+// Largest decode time or edit offset taken as real, in track ticks; far
+// beyond any real file, and what is left can't overflow when offsets and
+// durations are added.
+constexpr int64_t kMaxTicks = std::numeric_limits<int64_t>::max() / 4;
+
+uint64_t ReadBigEndian(const uint8_t* data, size_t bytes) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < bytes; ++i) value = (value << 8) | data[i];
+  return value;
+}
+
+bool IsType(const uint8_t* type, const char* name) { return std::memcmp(type, name, 4) == 0; }
+
+struct Box {
+  const uint8_t* start = nullptr;
+  const uint8_t* type = nullptr;
+  const uint8_t* payload = nullptr;
+  size_t payload_size = 0;
+  size_t size() const { return static_cast<size_t>(payload - start) + payload_size; }
+};
+
+// Walks the boxes in [data, data + size).
+class BoxReader {
+ public:
+  BoxReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+  bool Next(Box* box) {
+    if (offset_ + 8 > size_) return false;
+    const uint8_t* start = data_ + offset_;
+    uint64_t box_size = ReadBigEndian(start, 4);
+    size_t header = 8;
+    if (box_size == 1) {
+      if (offset_ + 16 > size_) return false;
+      box_size = ReadBigEndian(start + 8, 8);
+      header = 16;
+    } else if (box_size == 0) {
+      box_size = size_ - offset_;
+    }
+    if (box_size < header || box_size > size_ - offset_) return false;
+    box->start = start;
+    box->type = start + 4;
+    box->payload = start + header;
+    box->payload_size = static_cast<size_t>(box_size) - header;
+    offset_ += static_cast<size_t>(box_size);
+    return true;
+  }
+
+ private:
+  const uint8_t* const data_;
+  const size_t size_;
+  size_t offset_ = 0;
+};
+
+bool FindBox(const uint8_t* data, size_t size, const char* type, Box* box) {
+  BoxReader reader(data, size);
+  while (reader.Next(box)) {
+    if (IsType(box->type, type)) return true;
+  }
+  return false;
+}
+
+bool FindBox(const Box& parent, const char* type, Box* box) {
+  return FindBox(parent.payload, parent.payload_size, type, box);
+}
+
+// Full-box payload with room for |count| entries of |entry_size| after
+// |header| bytes.
+bool HasEntries(const Box& box, size_t header, uint64_t count, size_t entry_size) {
+  return box.payload_size >= header && (box.payload_size - header) / entry_size >= count;
+}
+
+struct Track {
+  DemuxedTrack track;
+  std::vector<DemuxedSample> samples;
+};
+
+// Sample tables of one trak. False with |error| set for tracks that can't
+// be remuxed; true with no samples for tracks to skip (subtitles, ...).
+bool ParseTrack(const Box& trak, uint32_t movie_timescale, size_t file_size, Track* out, std::string* error) {
+  Box mdia, mdhd, hdlr, minf, stbl;
+  if (!FindBox(trak, "mdia", &mdia) || !FindBox(mdia, "mdhd", &mdhd) || !FindBox(mdia, "hdlr", &hdlr) ||
+      !FindBox(mdia, "minf", &minf) || !FindBox(minf, "stbl", &stbl) || hdlr.payload_size < 12) {
+    return true;
+  }
+  DemuxedTrack& track = out->track;
+  if (IsType(hdlr.payload + 8, "vide")) {
+    track.kind = DemuxedTrackKind::kVideo;
+  } else if (IsType(hdlr.payload + 8, "soun")) {
+    track.kind = DemuxedTrackKind::kAudio;
+  } else {
+    return true;
+  }
+
+  // mdhd: timescale, duration, packed language
+  const uint8_t* m = mdhd.payload;
+  const bool long_times = mdhd.payload_size > 0 && m[0] == 1;
+  if (mdhd.payload_size < (long_times ? 34u : 22u)) {
+    *error = "Bad mdhd";
+    return false;
+  }
+  const uint8_t* times = m + (long_times ? 20 : 12);
+  track.timescale = static_cast<uint32_t>(ReadBigEndian(times, 4));
+  track.duration = static_cast<int64_t>(ReadBigEndian(times + 4, long_times ? 8 : 4));
+  const uint16_t language = static_cast<uint16_t>(ReadBigEndian(times + (long_times ? 12 : 8), 2));
+  if (language != 0 && language != 0x7fff) {
+    track.language.clear();
+    for (int shift = 10; shift >= 0; shift -= 5) {
+      track.language.push_back(static_cast<char>(0x60 + ((language >> shift) & 0x1f)));
+    }
+  }
+  if (track.timescale == 0) {
+    *error = "Bad mdhd";
+    return false;
+  }
+
+  // stsd: the first sample entry, copied whole
+  Box stsd;
+  Box entry;
+  if (!FindBox(stbl, "stsd", &stsd) || stsd.payload_size < 8 ||
+      !BoxReader(stsd.payload + 8, stsd.payload_size - 8).Next(&entry)) {
+    *error = "No sample description";
+    return false;
+  }
+  track.fourcc.assign(reinterpret_cast<const char*>(entry.type), 4);
+  if (track.fourcc == "encv" || track.fourcc == "enca") {
+    *error = "Encrypted tracks can't be remuxed";
+    return false;
+  }
+  track.sample_entry.assign(entry.start, entry.start + entry.size());
+  if (track.kind == DemuxedTrackKind::kVideo && entry.size() >= 36) {
+    track.width = static_cast<int>(ReadBigEndian(entry.start + 32, 2));
+    track.height = static_cast<int>(ReadBigEndian(entry.start + 34, 2));
+  }
+
+  Box stts, stsz, stsc, stco;
+  const bool long_offsets = !FindBox(stbl, "stco", &stco);
+  if (!FindBox(stbl, "stts", &stts) || !FindBox(stbl, "stsz", &stsz) || !FindBox(stbl, "stsc", &stsc) ||
+      (long_offsets && !FindBox(stbl, "co64", &stco))) {
+    *error = "Incomplete sample table";
+    return false;
+  }
+  if (stsz.payload_size < 12) {
+    *error = "Bad stsz";
+    return false;
+  }
+  const uint32_t fixed_size = static_cast<uint32_t>(ReadBigEndian(stsz.payload + 4, 4));
+  const uint64_t count = ReadBigEndian(stsz.payload + 8, 4);
+  // Every sample takes at least its size in the file; checked before the
+  // table is allocated
+  if ((fixed_size == 0 && !HasEntries(stsz, 12, count, 4)) || count > file_size / std::max<uint32_t>(fixed_size, 1)) {
+    *error = "Bad stsz";
+    return false;
+  }
+  auto& samples = out->samples;
+  samples.resize(static_cast<size_t>(count));
+  for (size_t i = 0; i < samples.size(); ++i) {
+    samples[i].size =
+        fixed_size != 0 ? fixed_size : static_cast<uint32_t>(ReadBigEndian(stsz.payload + 12 + 4 * i, 4));
+  }
+
+  // stts: decode times
+  const uint64_t stts_count = stts.payload_size >= 8 ? ReadBigEndian(stts.payload + 4, 4) : 0;
+  if (!HasEntries(stts, 8, stts_count, 8)) {
+    *error = "Bad stts";
+    return false;
+  }
+  size_t index = 0;
+  int64_t dts = 0;
+  for (uint64_t e = 0; e < stts_count && index < samples.size(); ++e) {
+    const uint64_t run = ReadBigEndian(stts.payload + 8 + 8 * e, 4);
+    const uint32_t delta = static_cast<uint32_t>(ReadBigEndian(stts.payload + 12 + 8 * e, 4));
+    for (uint64_t i = 0; i < run && index < samples.size(); ++i, ++index) {
+      // Leaves room for composition offsets and durations on top
+      if (dts > kMaxTicks) {
+        *error = "Bad stts";
+        return false;
+      }
+      samples[index].dts = dts;
+      samples[index].duration = delta;
+      dts += delta;
+    }
+  }
+  if (index != samples.size()) {
+    *error = "stts is shorter than stsz";
+    return false;
+  }
+
+  // ctts: composition offsets, signed in practice whatever the version
+  Box ctts;
+  if (FindBox(stbl, "ctts", &ctts) && ctts.payload_size >= 8) {
+    const uint64_t entries = ReadBigEndian(ctts.payload + 4, 4);
+    if (!HasEntries(ctts, 8, entries, 8)) {
+      *error = "Bad ctts";
+      return false;
+    }
+    index = 0;
+    for (uint64_t e = 0; e < entries && index < samples.size(); ++e) {
+      const uint64_t run = ReadBigEndian(ctts.payload + 8 + 8 * e, 4);
+      const auto offset = static_cast<int32_t>(static_cast<uint32_t>(ReadBigEndian(ctts.payload + 12 + 8 * e, 4)));
+      for (uint64_t i = 0; i < run && index < samples.size(); ++i) samples[index++].composition_offset = offset;
+    }
+  }
+
+  // stss: sync samples; every sample is one without it
+  Box stss;
+  if (FindBox(stbl, "stss", &stss) && stss.payload_size >= 8) {
+    const uint64_t entries = ReadBigEndian(stss.payload + 4, 4);
+    if (!HasEntries(stss, 8, entries, 4)) {
+      *error = "Bad stss";
+      return false;
+    }
+    for (uint64_t e = 0; e < entries; ++e) {
+      const uint64_t number = ReadBigEndian(stss.payload + 8 + 4 * e, 4);
+      if (number >= 1 && number <= samples.size()) samples[number - 1].keyframe = true;
+    }
+  } else {
+    for (auto& sample : samples) sample.keyframe = true;
+  }
+
+  // stsc + stco/co64: file offsets, chunk by chunk
+  const uint64_t chunks = stco.payload_size >= 8 ? ReadBigEndian(stco.payload + 4, 4) : 0;
+  const size_t offset_size = long_offsets ? 8 : 4;
+  const uint64_t stsc_count = stsc.payload_size >= 8 ? ReadBigEndian(stsc.payload + 4, 4) : 0;
+  if (!HasEntries(stco, 8, chunks, offset_size) || !HasEntries(stsc, 8, stsc_count, 12)) {
+    *error = "Bad chunk table";
+    return false;
+  }
+  index = 0;
+  for (uint64_t e = 0; e < stsc_count && index < samples.size(); ++e) {
+    const uint64_t first_chunk = ReadBigEndian(stsc.payload + 8 + 12 * e, 4);
+    const uint64_t per_chunk = ReadBigEndian(stsc.payload + 12 + 12 * e, 4);
+    const uint64_t next_chunk = e + 1 < stsc_count ? ReadBigEndian(stsc.payload + 20 + 12 * e, 4) : chunks + 1;
+    if (first_chunk == 0) break;
+    for (uint64_t chunk = first_chunk; chunk < next_chunk && chunk <= chunks && index < samples.size(); ++chunk) {
+      uint64_t offset = ReadBigEndian(stco.payload + 8 + offset_size * (chunk - 1), offset_size);
+      for (uint64_t i = 0; i < per_chunk && index < samples.size(); ++i, ++index) {
+        samples[index].offset = static_cast<int64_t>(offset);
+        offset += samples[index].size;
+      }
+    }
+  }
+  if (index != samples.size()) {
+    *error = "Chunk table is shorter than stsz";
+    return false;
+  }
+  for (const auto& sample : samples) {
+    if (static_cast<uint64_t>(sample.offset) + sample.size > file_size) {
+      *error = "Truncated file: samples past the end";
+      return false;
+    }
+  }
+
+  // elst: empty edits delay the track, a media time skips into it
+  Box edts, elst;
+  if (FindBox(trak, "edts", &edts) && FindBox(edts, "elst", &elst) && elst.payload_size >= 8) {
+    const bool long_edits = elst.payload[0] == 1;
+    const size_t entry_size = long_edits ? 20 : 12;
+    const uint64_t entries = ReadBigEndian(elst.payload + 4, 4);
+    int64_t empty = 0;
+    int64_t media_time = 0;
+    for (uint64_t e = 0; HasEntries(elst, 8, e + 1, entry_size); ++e) {
+      if (e >= entries) break;
+      const uint8_t* edit = elst.payload + 8 + entry_size * e;
+      const auto segment = static_cast<int64_t>(ReadBigEndian(edit, long_edits ? 8 : 4));
+      const int64_t time = long_edits ? static_cast<int64_t>(ReadBigEndian(edit + 8, 8))
+                                      : static_cast<int32_t>(static_cast<uint32_t>(ReadBigEndian(edit + 4, 4)));
+      if (time >= 0) {
+        media_time = time;
+        break;
+      }
+      int64_t ticks = 0;
+      if (movie_timescale != 0) {
+        if (segment < 0 || !RescaleTime(segment, movie_timescale, track.timescale, &ticks) ||
+            ticks > kMaxTicks - empty) {
+          *error = "Bad elst";
+          return false;
+        }
+        empty += ticks;
+      }
+    }
+    const int64_t shift = empty - media_time;
+    if (shift != 0) {
+      for (auto& sample : samples) {
+        sample.composition_offset = static_cast<int32_t>(std::clamp<int64_t>(
+            sample.composition_offset + shift, std::numeric_limits<int32_t>::min(),
+            std::numeric_limits<int32_t>::max()));
+      }
+    }
+  }
+
+  // Presentation start and end must have a time in microseconds
+  for (const auto& sample : samples) {
+    const int64_t start = sample.dts + sample.composition_offset;
+    int64_t us = 0;
+    if (!RescaleTime(start, track.timescale, 1000000, &us) ||
+        !RescaleTime(start + sample.duration, track.timescale, 1000000, &us)) {
+      *error = "Sample times out of range";
+      return false;
+    }
+  }
+  return true;
+}
+
+// ParseTrack made sure this converts.
+int64_t PresentationUs(const DemuxedSample& sample, uint32_t timescale) {
+  int64_t us = 0;
+  RescaleTime(sample.dts + sample.composition_offset, timescale, 1000000, &us);
+  return us;
+}
+
+}  // namespace
+
+std::unique_ptr<Mp4Demuxer> Mp4Demuxer::Open(const uint8_t* data, size_t size, std::string* error) {
+  Box moov;
+  if (!FindBox(data, size, "moov", &moov)) {
+    *error = "No moov box: not an MP4 file, or truncated";
+    return nullptr;
+  }
+  Box box;
+  if (FindBox(moov, "mvex", &box)) {
+    *error = "Fragmented MP4 is already segmentable";
+    return nullptr;
+  }
+  uint32_t movie_timescale = 0;
+  int64_t movie_duration = 0;
+  if (FindBox(moov, "mvhd", &box) && box.payload_size >= 20) {
+    const bool long_times = box.payload[0] == 1;
+    if (box.payload_size >= (long_times ? 32u : 20u)) {
+      const uint8_t* times = box.payload + (long_times ? 20 : 12);
+      movie_timescale = static_cast<uint32_t>(ReadBigEndian(times, 4));
+      movie_duration = static_cast<int64_t>(ReadBigEndian(times + 4, long_times ? 8 : 4));
+    }
+  }
+
+  std::unique_ptr<Mp4Demuxer> demuxer(new Mp4Demuxer());
+  Track video;
+  Track audio;
+  bool have_video = false;
+  bool have_audio = false;
+  BoxReader reader(moov.payload, moov.payload_size);
+  while (reader.Next(&box)) {
+    if (!IsType(box.type, "trak")) continue;
+    Track track;
+    if (!ParseTrack(box, movie_timescale, size, &track, error)) return nullptr;
+    if (track.samples.empty()) continue;
+    if (track.track.kind == DemuxedTrackKind::kVideo && !have_video) {
+      video = std::move(track);
+      have_video = true;
+    } else if (track.track.kind == DemuxedTrackKind::kAudio && !have_audio) {
+      audio = std::move(track);
+      have_audio = true;
+    }
+  }
+  if (!have_video && !have_audio) {
+    *error = "No audio or video track";
+    return nullptr;
+  }
+  for (Track* track : {&video, &audio}) {
+    if (track->samples.empty()) continue;
+    demuxer->tracks_.push_back(std::move(track->track));
+    demuxer->samples_.push_back(std::move(track->samples));
+  }
+
+  // Segments start at the first track's sync samples
+  const auto& first = demuxer->samples_[0];
+  const uint32_t timescale = demuxer->tracks_[0].timescale;
+  for (size_t i = 0; i < first.size(); ++i) {
+    if (!first[i].keyframe) continue;
+    const int64_t time = demuxer->sync_points_.empty() ? 0 : PresentationUs(first[i], timescale);
+    if (!demuxer->sync_points_.empty() && time <= demuxer->sync_points_.back().time_us) continue;
+    demuxer->sync_points_.push_back({time, static_cast<int64_t>(i)});
+  }
+  if (demuxer->sync_points_.empty()) {
+    *error = "No sync samples";
+    return nullptr;
+  }
+
+  // Header durations that don't convert count as unknown
+  int64_t duration_us = 0;
+  if (RescaleTime(movie_duration, movie_timescale, 1000000, &duration_us)) {
+    demuxer->duration_us_ = std::max<int64_t>(duration_us, 0);
+  }
+  for (const auto& track : demuxer->tracks_) {
+    if (RescaleTime(track.duration, track.timescale, 1000000, &duration_us)) {
+      demuxer->duration_us_ = std::max(demuxer->duration_us_, duration_us);
+    }
+  }
+  return demuxer;
+}
+
+bool Mp4Demuxer::ReadSamples(const SyncPoint& from, const SyncPoint* to,
+                             std::vector<std::vector<DemuxedSample>>* samples, std::string* error) const {
+  const auto& first = samples_[0];
+  const auto begin = static_cast<size_t>(from.position);
+  const size_t end = to != nullptr ? static_cast<size_t>(to->position) : first.size();
+  if (begin > end || end > first.size()) {
+    *error = "Bad sync point";
+    return false;
+  }
+  samples->assign(samples_.size(), {});
+  (*samples)[0].assign(first.begin() + begin, first.begin() + end);
+
+  // The rest by presentation time, from the start of the file in the first
+  // segment
+  const bool at_start = from.position == sync_points_.front().position;
+  const int64_t lower = at_start ? std::numeric_limits<int64_t>::min() : from.time_us;
+  const int64_t upper = to != nullptr ? to->time_us : std::numeric_limits<int64_t>::max();
+  for (size_t t = 1; t < samples_.size(); ++t) {
+    const auto& track = samples_[t];
+    const uint32_t timescale = tracks_[t].timescale;
+    auto before = [timescale](const DemuxedSample& sample, int64_t time) {
+      return PresentationUs(sample, timescale) < time;
+    };
+    const auto start = std::lower_bound(track.begin(), track.end(), lower, before);
+    const auto stop = std::lower_bound(start, track.end(), upper, before);
+    (*samples)[t].assign(start, stop);
+  }
+  return true;
+}
+
+}  // namespace pro_video_player
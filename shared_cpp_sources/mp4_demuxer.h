@@ -0,0 +1,36 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_MP4_DEMUXER_H_
+#define PRO_VIDEO_PLAYER_SHARED_MP4_DEMUXER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "media_demuxer.h"
+
+namespace pro_video_player {
+
+// Progressive ISO BMFF (MP4, MOV): the sample tables in moov are the
+// index. Sync points are the video track's sync samples (stss). Edit
+// lists shift presentation times through the composition offsets, so the
+// first frame shows at 0. Fragmented and encrypted files are refused.
+class Mp4Demuxer : public MediaDemuxer {
+ public:
+  static std::unique_ptr<Mp4Demuxer> Open(const uint8_t* data, size_t size, std::string* error);
+
+  const std::vector<SyncPoint>& sync_points() const override { return sync_points_; }
+  bool ReadSamples(const SyncPoint& from, const SyncPoint* to, std::vector<std::vector<DemuxedSample>>* samples,
+                   std::string* error) const override;
+
+ private:
+  Mp4Demuxer() = default;
+
+  // Per track, all of them.
+  std::vector<std::vector<DemuxedSample>> samples_;
+  std::vector<SyncPoint> sync_points_;
+};
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_MP4_DEMUXER_H_
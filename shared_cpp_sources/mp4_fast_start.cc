@@ -0,0 +1,97 @@
+#include "mp4_fast_start.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "trace_recorder.h"
+
+namespace pro_video_player {
+
+Mp4FastStart::Mp4FastStart(HttpFetcher* fetcher, MediaSource source, Options options, Callback done)
+    : fetcher_(fetcher), source_(std::move(source)), options_(options), done_(std::move(done)) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Request(Part::kHead, 0, options_.head_bytes - 1, FetchPriority::kCurrentSegment);
+}
+
+Mp4FastStart::~Mp4FastStart() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  stopped_ = true;
+  for (const auto& entry : in_flight_) {
+    if (fetcher_->Cancel(entry.second)) --outstanding_;
+  }
+  in_flight_.clear();
+  idle_cv_.wait(lock, [&]() { return outstanding_ == 0; });
+}
+
+void Mp4FastStart::Request(Part part, int64_t first, int64_t last, FetchPriority priority) {
+  HttpRequest request = MakeHttpRequest(source_, source_.uri, priority);
+  request.range_start = first;
+  request.range_end = last;
+  // The callback can't run before this returns: it needs mutex_
+  ++outstanding_;
+  in_flight_[part] = fetcher_->Fetch(std::move(request),
+                                     [this, part](const HttpResponse& response) { OnResponse(part, response); });
+}
+
+void Mp4FastStart::OnResponse(Part part, const HttpResponse& response) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  in_flight_.erase(part);
+  if (!stopped_) {
+    switch (part) {
+      case Part::kHead:
+        OnHead(response);
+        break;
+      case Part::kTail:
+        if (response.ok()) {
+          result_.tail = response.body;
+        } else {
+          result_.error = response.error.empty() ? "HTTP " + std::to_string(response.status) : response.error;
+        }
+        break;
+      case Part::kMedia:
+        // Optional: the player reads media data itself if this failed
+        if (response.ok()) result_.media = response.body;
+        break;
+    }
+  }
+  const bool finish = !stopped_ && !finished_ && in_flight_.empty();
+  Mp4Prefetch result;
+  if (finish) {
+    finished_ = true;
+    result = std::move(result_);
+  }
+  lock.unlock();
+  if (finish) done_(result);
+  lock.lock();
+  --outstanding_;
+  idle_cv_.notify_all();
+}
+
+void Mp4FastStart::OnHead(const HttpResponse& response) {
+  PVP_TRACE_SCOPE("http", "Mp4FastStart::OnHead");
+  if (!response.ok()) {
+    result_.error = response.error.empty() ? "HTTP " + std::to_string(response.status) : response.error;
+    return;
+  }
+  result_.head = response.body;
+  // 200: the server sent the whole file
+  result_.file_size = response.status == 206 ? ContentRangeTotal(response)
+                                             : static_cast<int64_t>(response.body.size());
+  const auto& head = result_.head;
+  result_.layout = ParseMp4Layout(head.data(), head.size(), result_.file_size);
+  const Mp4Layout& layout = result_.layout;
+  if (layout.moov != Mp4MoovLocation::kEnd) return;
+
+  const int64_t head_end = static_cast<int64_t>(head.size());
+  if (layout.tail_offset < head_end) {
+    // Small file: moov came with the head
+    result_.tail.assign(head.begin() + layout.tail_offset, head.end());
+    return;
+  }
+  if (result_.file_size < 0 || result_.file_size - layout.tail_offset > options_.max_tail_bytes) return;
+  Request(Part::kTail, layout.tail_offset, result_.file_size - 1, FetchPriority::kCurrentSegment);
+  const int64_t media_end = std::min(head_end + options_.media_bytes, layout.tail_offset);
+  if (media_end > head_end) Request(Part::kMedia, head_end, media_end - 1, FetchPriority::kNextSegment);
+}
+
+}  // namespace pro_video_player
@@ -0,0 +1,96 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_MP4_FAST_START_H_
+#define PRO_VIDEO_PLAYER_SHARED_MP4_FAST_START_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "http_fetcher.h"
+#include "mp4_layout.h"
+#include "player_types.h"
+
+namespace pro_video_player {
+
+// What Mp4FastStart read of a progressive MP4.
+struct Mp4Prefetch {
+  // Empty on success; otherwise the fields below hold what did arrive.
+  std::string error;
+  Mp4Layout layout;
+  // From Content-Range; -1 if the server didn't say.
+  int64_t file_size = -1;
+  // Bytes [0, head.size()). The whole file if the server ignored Range.
+  std::vector<uint8_t> head;
+  // kEnd: bytes [layout.tail_offset, file_size), moov included.
+  std::vector<uint8_t> tail;
+  // kEnd: bytes [head.size(), head.size() + media.size()), the first media
+  // data, fetched alongside |tail|.
+  std::vector<uint8_t> media;
+};
+
+// Opens a progressive MP4 over HTTP without waiting on a sequential
+// download when its moov box sits at the end.
+//
+// A player reading such a file front to back reaches the index last, so
+// nothing decodes until the whole file is in; one that seeks for it still
+// pays a round trip for the head, one for the tail and one back to the
+// media data. Here the head is a small range request; if its box layout
+// (see ParseMp4Layout) puts moov after mdat, the tail and the first media
+// data are requested at once, on parallel connections. Faststart files
+// finish after the head.
+//
+// Thread-safe. |done| runs once on the fetcher thread, unless the
+// prefetcher is destroyed first; it must not destroy the prefetcher.
+class Mp4FastStart {
+ public:
+  struct Options {
+    int64_t head_bytes = 64 * 1024;
+    int64_t media_bytes = 1024 * 1024;
+    // Tails larger than this (more media after the first mdat) aren't
+    // fetched up front.
+    int64_t max_tail_bytes = 32 * 1024 * 1024;
+  };
+
+  using Callback = std::function<void(const Mp4Prefetch& prefetch)>;
+
+  // Starts with the head request. |fetcher| must outlive the prefetcher;
+  // |source| supplies the URL and request headers.
+  Mp4FastStart(HttpFetcher* fetcher, MediaSource source, Options options, Callback done);
+  // Cancels what is in flight, then waits for a callback in progress.
+  ~Mp4FastStart();
+
+  Mp4FastStart(const Mp4FastStart&) = delete;
+  Mp4FastStart& operator=(const Mp4FastStart&) = delete;
+
+ private:
+  enum class Part {
+    kHead,
+    kTail,
+    kMedia,
+  };
+
+  void Request(Part part, int64_t first, int64_t last, FetchPriority priority);
+  void OnResponse(Part part, const HttpResponse& response);
+  void OnHead(const HttpResponse& response);
+
+  HttpFetcher* const fetcher_;
+  const MediaSource source_;
+  const Options options_;
+  const Callback done_;
+
+  std::mutex mutex_;
+  std::condition_variable idle_cv_;
+  bool stopped_ = false;
+  bool finished_ = false;
+  // Fetches whose callback may still run.
+  int outstanding_ = 0;
+  std::map<Part, HttpFetcher::RequestId> in_flight_;
+  Mp4Prefetch result_;
+};
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_MP4_FAST_START_H_
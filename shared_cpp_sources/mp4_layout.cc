@@ -0,0 +1,74 @@
+#include "mp4_layout.h"
+
+#include <cstring>
+
+namespace pro_video_player {
+
+namespace {
+
+uint64_t ReadBigEndian(const uint8_t* data, size_t bytes) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < bytes; ++i) value = (value << 8) | data[i];
+  return value;
+}
+
+bool IsType(const uint8_t* type, const char* name) { return std::memcmp(type, name, 4) == 0; }
+
+}  // namespace
+
+Mp4Layout ParseMp4Layout(const uint8_t* head, size_t size, int64_t file_size) {
+  Mp4Layout layout;
+  uint64_t offset = 0;
+  while (offset + 8 <= size) {
+    const uint8_t* box = head + offset;
+    uint64_t box_size = ReadBigEndian(box, 4);
+    const uint8_t* type = box + 4;
+    uint64_t header_size = 8;
+    if (box_size == 1) {
+      // 64-bit largesize follows the type
+      if (offset + 16 > size) break;
+      box_size = ReadBigEndian(box + 8, 8);
+      header_size = 16;
+    }
+    if (offset == 0 && !IsType(type, "ftyp")) {
+      layout.moov = Mp4MoovLocation::kNotMp4;
+      return layout;
+    }
+    // 0: the box runs to the end of the file
+    const bool to_end = box_size == 0;
+    if (to_end && file_size >= 0) box_size = static_cast<uint64_t>(file_size) - offset;
+    if (!to_end && box_size < header_size) {
+      // Corrupt; nothing further can be trusted
+      layout.moov = Mp4MoovLocation::kUnknown;
+      return layout;
+    }
+
+    if (IsType(type, "moov")) {
+      // A small file may have both boxes in |head|
+      const bool after_mdat = layout.mdat_offset >= 0;
+      layout.moov = after_mdat ? Mp4MoovLocation::kEnd : Mp4MoovLocation::kFront;
+      layout.moov_offset = static_cast<int64_t>(offset);
+      layout.moov_size = box_size == 0 ? -1 : static_cast<int64_t>(box_size);
+      if (after_mdat) layout.tail_offset = static_cast<int64_t>(offset);
+      return layout;
+    }
+    if (IsType(type, "mdat")) {
+      layout.mdat_offset = static_cast<int64_t>(offset);
+      layout.mdat_size = box_size == 0 ? -1 : static_cast<int64_t>(box_size);
+      // Media data up to the end of the file leaves no room for moov
+      if (to_end) return layout;
+      const uint64_t tail = offset + box_size;
+      if (tail >= size) {
+        if (file_size >= 0 && tail >= static_cast<uint64_t>(file_size)) return layout;
+        layout.moov = Mp4MoovLocation::kEnd;
+        layout.tail_offset = static_cast<int64_t>(tail);
+        return layout;
+      }
+    }
+    if (box_size == 0) break;
+    offset += box_size;
+  }
+  return layout;
+}
+
+}  // namespace pro_video_player
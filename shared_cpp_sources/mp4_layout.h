@@ -0,0 +1,40 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_MP4_LAYOUT_H_
+#define PRO_VIDEO_PLAYER_SHARED_MP4_LAYOUT_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pro_video_player {
+
+// Where a progressive MP4 keeps its index (the moov box).
+enum class Mp4MoovLocation {
+  // Doesn't start with an ftyp box.
+  kNotMp4,
+  // Before the media data ("faststart"): playable while downloading.
+  kFront,
+  // After the media data: nothing plays until the tail has been read.
+  kEnd,
+  // The bytes end before either box was reached.
+  kUnknown,
+};
+
+// Top-level box layout read from the first bytes of an MP4. Offsets and
+// sizes are -1 when not located.
+struct Mp4Layout {
+  Mp4MoovLocation moov = Mp4MoovLocation::kUnknown;
+  int64_t moov_offset = -1;
+  int64_t moov_size = -1;
+  int64_t mdat_offset = -1;
+  int64_t mdat_size = -1;
+  // kEnd: where the boxes after mdat start, moov among them.
+  int64_t tail_offset = -1;
+};
+
+// Walks the top-level boxes in |head|, the first |size| bytes of a file of
+// |file_size| bytes (-1 if unknown). Box payloads need not be in |head|:
+// the mdat header alone tells where moov has to be.
+Mp4Layout ParseMp4Layout(const uint8_t* head, size_t size, int64_t file_size);
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_MP4_LAYOUT_H_
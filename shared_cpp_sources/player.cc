@@ -0,0 +1,1030 @@
+#include "player.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+
+#include "download_store.h"
+#include "time_stretch.h"
+#include "trace_recorder.h"
+
+namespace pro_video_player {
+
+namespace {
+
+// Primary language subtag, lower-cased ("en-US" -> "en").
+std::string PrimaryLanguage(const std::string& language) {
+  std::string primary;
+  for (char c : language) {
+    if (c == '-' || c == '_') break;
+    primary.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+  }
+  return primary;
+}
+
+bool LanguageMatches(const std::string& track_language, const std::string& preferred) {
+  return !preferred.empty() && !track_language.empty() &&
+         PrimaryLanguage(track_language) == PrimaryLanguage(preferred);
+}
+
+bool EqualsIgnoreCase(const std::string& a, const std::string& b) {
+  return a.size() == b.size() &&
+         std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+           return std::tolower(static_cast<unsigned char>(x)) ==
+                  std::tolower(static_cast<unsigned char>(y));
+         });
+}
+
+// Ranks audio tracks for the initial selection: language and rendition
+// both matching, then language, then rendition, then the stream's default.
+// Ties keep the earlier track.
+int AudioTrackScore(const AudioTrack& track, const std::string& language,
+                    const std::string& rendition) {
+  int score = 0;
+  if (LanguageMatches(track.language, language)) score += 4;
+  if (!rendition.empty() && EqualsIgnoreCase(track.label, rendition)) score += 2;
+  if (track.is_default) score += 1;
+  return score;
+}
+
+}  // namespace
+
+Player::Player(int64_t id, std::unique_ptr<DecodeBackend> backend, PlayerEventSink* events,
+               FrameSink* frames)
+    : id_(id),
+      backend_name_(backend ? backend->name() : std::string()),
+      backend_(std::move(backend)),
+      events_(events),
+      frames_(frames) {
+  queue_.Start("pvp-player-" + std::to_string(id_), [this]() { return Tick(); });
+}
+
+Player::~Player() { Dispose(); }
+
+bool Player::Post(CommandQueue::Command command) {
+  if (disposed_.load()) return false;
+  return queue_.Post(std::move(command));
+}
+
+bool Player::Submit(CommandKey key, Action action, CommandCallback done) {
+  if (disposed_.load()) return Reject(done, "INVALID_PLAYER", "Player has been disposed");
+  auto run = [action = std::move(action), done]() {
+    const CommandResult result = action();
+    if (done) done(result);
+  };
+  bool queued;
+  if (key == kNoKey) {
+    queued = queue_.Post(std::move(run));
+  } else {
+    queued = queue_.PostCoalesced(key, std::move(run), [done]() {
+      if (done) done(CommandResult());
+    });
+  }
+  if (!queued) return Reject(done, "INVALID_PLAYER", "Player has been disposed");
+  return true;
+}
+
+bool Player::Reject(const CommandCallback& done, std::string code, std::string message) {
+  if (done) done(CommandResult{std::move(code), std::move(message)});
+  return false;
+}
+
+// ==================== Control ====================
+
+bool Player::Initialize(const MediaSource& source, const PlayerOptions& options) {
+  if (backend_ == nullptr || initialize_requested_.exchange(true)) return false;
+  return Post([this, source, options]() {
+    PVP_TRACE_SCOPE_PLAYER("player", "Initialize", id_);
+    source_ = source;
+    options_ = options;
+    std::string offline_error;
+    if (source.type == SourceType::kOffline &&
+        !DownloadStore::Instance().Resolve(source.uri, &source_, &offline_error)) {
+      HandleError("OFFLINE_ERROR", offline_error);
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(state_mutex_);
+      volume_ = options.volume;
+      speed_ = options.playback_speed > 0 ? options.playback_speed : 1.0;
+      looping_ = options.looping;
+    }
+    user_rate_ = speed_ != 1.0;
+    clock_.SetRate(speed_);
+    play_when_ready_ = options.auto_play;
+    SetState(PlaybackState::kInitializing);
+    if (options.enable_audio_levels) {
+      audio_levels_enabled_.store(true);
+      backend_->SetAudioTapEnabled(true);
+    }
+    backend_->SetPreferredLanguages(options.preferred_audio_language,
+                                    options.preferred_subtitle_language);
+    buffer_ = BufferController(options.buffering_tier, options.dynamic_buffering);
+    ApplyBufferLimits();
+    backend_->Open(source_, this);
+  });
+}
+
+bool Player::Play(CommandCallback done) {
+  return Submit(kNoKey, [this]() {
+    PVP_TRACE_SCOPE_PLAYER("player", "Play", id_);
+    DoPlay();
+    return CommandResult();
+  }, std::move(done));
+}
+
+bool Player::Pause(CommandCallback done) {
+  return Submit(kNoKey, [this]() {
+    PVP_TRACE_SCOPE_PLAYER("player", "Pause", id_);
+    play_when_ready_ = false;
+    if (!prepared_) return CommandResult();
+    const PlaybackState current = state();
+    if (current != PlaybackState::kPlaying && current != PlaybackState::kBuffering) {
+      return CommandResult();
+    }
+    backend_->Pause();
+    clock_.Stop();
+    SetState(PlaybackState::kPaused);
+    EmitPosition(true);
+    return CommandResult();
+  }, std::move(done));
+}
+
+bool Player::SeekTo(int64_t position_ms, CommandCallback done) {
+  if (position_ms < 0) return Reject(done, "INVALID_ARGS", "Position must not be negative");
+  return Submit(kSeekKey, [this, position_ms]() {
+    PVP_TRACE_SCOPE_PLAYER("player", "SeekTo", id_);
+    if (!prepared_) {
+      options_.start_position_ms = position_ms;
+    } else {
+      // The end of a live stream's range is its edge; going back there
+      // hands the rate back to catching up
+      const int64_t duration = DurationMs();
+      const bool to_live_edge = live_sync_.has_value() && duration > 0 && position_ms >= duration;
+      DoSeek(position_ms);
+      if (to_live_edge && user_rate_) {
+        user_rate_ = false;
+        {
+          std::lock_guard<std::mutex> lock(state_mutex_);
+          speed_ = 1.0;
+        }
+        ApplyRate();
+        Emit(PlayerEvent("playbackSpeedChanged").With("speed", 1.0));
+      }
+      if (to_live_edge) {
+        live_sync_->RestoreTarget();
+      } else if (live_sync_.has_value()) {
+        live_sync_->Retarget();
+      }
+    }
+    return CommandResult();
+  }, std::move(done));
+}
+
+bool Player::SetPlaybackSpeed(double speed, CommandCallback done) {
+  // The range backends keep pitch over (DecodeBackend::SetRate)
+  if (!std::isfinite(speed) || speed < kMinTimeStretchRate || speed > kMaxTimeStretchRate) {
+    return Reject(done, "INVALID_ARGS", "Playback speed must be between 0.25 and 4.0");
+  }
+  return Submit(kSpeedKey, [this, speed]() {
+    {
+      std::lock_guard<std::mutex> lock(state_mutex_);
+      speed_ = speed;
+    }
+    // An explicit speed overrides catching up until a seek to the live
+    // edge; it restarts from 1.0x
+    user_rate_ = true;
+    live_rate_ = 1.0;
+    if (live_sync_.has_value()) live_sync_->Reset();
+    clock_.SetRate(speed);
+    if (prepared_) backend_->SetRate(speed);
+    Emit(PlayerEvent("playbackSpeedChanged").With("speed", speed));
+    return CommandResult();
+  }, std::move(done));
+}
+
+bool Player::SetVolume(double volume, CommandCallback done) {
+  if (!std::isfinite(volume) || volume < 0 || volume > 1) {
+    return Reject(done, "VOLUME_ERROR", "Volume must be between 0.0 and 1.0");
+  }
+  return Submit(kVolumeKey, [this, volume]() {
+    {
+      std::lock_guard<std::mutex> lock(state_mutex_);
+      volume_ = volume;
+    }
+    if (prepared_) backend_->SetVolume(volume);
+    Emit(PlayerEvent("volumeChanged").With("volume", volume));
+    return CommandResult();
+  }, std::move(done));
+}
+
+bool Player::SetLooping(bool looping, CommandCallback done) {
+  return Submit(kLoopingKey, [this, looping]() {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    looping_ = looping;
+    return CommandResult();
+  }, std::move(done));
+}
+
+bool Player::SetAudioTrack(const std::string& track_id, CommandCallback done) {
+  return Submit(kNoKey, [this, track_id]() {
+    // Re-selecting the current track must not restart the audio decoder
+    if (!track_id.empty() && track_id == selected_audio_track_id()) return CommandResult();
+    const auto tracks = audio_tracks();
+    const auto it = std::find_if(tracks.begin(), tracks.end(),
+                                 [&](const AudioTrack& track) { return track.id == track_id; });
+    if (it == tracks.end()) {
+      const std::string message = "Unknown audio track: " + track_id;
+      if (!disposed_.load()) events_->OnError(id_, "AUDIO_ERROR", message);
+      return CommandResult{"AUDIO_ERROR", message};
+    }
+    backend_->SelectAudioTrack(track_id);
+    {
+      std::lock_guard<std::mutex> lock(state_mutex_);
+      selected_audio_track_id_ = track_id;
+    }
+    Emit(PlayerEvent("selectedAudioChanged").With("track", ToEventValue(*it)));
+    return CommandResult();
+  }, std::move(done));
+}
+
+bool Player::SetSubtitleTrack(const std::string& track_id, CommandCallback done) {
+  return Submit(kNoKey, [this, track_id]() {
+    EventValue selected;
+    if (!track_id.empty()) {
+      const auto tracks = subtitle_tracks();
+      const auto it = std::find_if(tracks.begin(), tracks.end(),
+                                   [&](const SubtitleTrack& track) { return track.id == track_id; });
+      if (it == tracks.end()) {
+        const std::string message = "Unknown subtitle track: " + track_id;
+        if (!disposed_.load()) events_->OnError(id_, "SUBTITLE_ERROR", message);
+        return CommandResult{"SUBTITLE_ERROR", message};
+      }
+      selected = ToEventValue(*it);
+    }
+    subtitle_chosen_ = true;
+    ActivateSubtitleTrack(track_id, false);
+    Emit(PlayerEvent("selectedSubtitleChanged").With("track", std::move(selected)));
+    return CommandResult();
+  }, std::move(done));
+}
+
+bool Player::SetSubtitleRenderMode(SubtitleRenderMode mode, CommandCallback done) {
+  return Submit(kNoKey, [this, mode]() {
+    if (mode == subtitle_render_mode_) return CommandResult();
+    subtitle_render_mode_ = mode;
+    backend_->SetSubtitleCuesEnabled(mode == SubtitleRenderMode::kFlutter);
+    if (mode != SubtitleRenderMode::kFlutter && sent_cue_.has_value()) {
+      // Clear the Flutter overlay; the backend draws from now on
+      sent_cue_.reset();
+      Emit(PlayerEvent("embeddedSubtitleCue").With("text", EventValue()).With(
+          "trackId", selected_subtitle_track_id()));
+    }
+    UpdateSubtitleCue();
+    queue_.WakeTimer();
+    return CommandResult();
+  }, std::move(done));
+}
+
+bool Player::AddExternalSubtitle(ExternalSubtitle subtitle, ExternalSubtitleCallback done) {
+  const bool queued = Post([this, subtitle = std::move(subtitle), done]() {
+    PVP_TRACE_SCOPE_PLAYER("player", "AddExternalSubtitle", id_);
+    std::vector<SubtitleCue> cues;
+    if (!ParseSubtitles(subtitle.format, subtitle.content, &cues)) {
+      done(CommandResult{"SUBTITLE_ERROR", "Could not parse subtitle file"}, SubtitleTrack());
+      return;
+    }
+    SubtitleTrack track;
+    track.id = "external-" + std::to_string(++external_subtitle_count_);
+    track.label = subtitle.label;
+    track.language = subtitle.language;
+    track.is_default = subtitle.is_default;
+    cues_.Add(track.id, cues);
+    external_subtitle_tracks_.push_back(track);
+    PublishSubtitleTracks();
+    if (prepared_) SelectPreferredSubtitle();
+    done(CommandResult(), track);
+  });
+  if (!queued) done(CommandResult{"INVALID_PLAYER", "Player has been disposed"}, SubtitleTrack());
+  return queued;
+}
+
+bool Player::RemoveExternalSubtitle(const std::string& track_id, CommandCallback done) {
+  return Submit(kNoKey, [this, track_id]() {
+    const auto it = std::find_if(external_subtitle_tracks_.begin(), external_subtitle_tracks_.end(),
+                                 [&](const SubtitleTrack& track) { return track.id == track_id; });
+    if (it == external_subtitle_tracks_.end()) {
+      return CommandResult{"SUBTITLE_ERROR", "Unknown external subtitle: " + track_id};
+    }
+    if (selected_subtitle_track_id() == track_id) {
+      ActivateSubtitleTrack("", false);
+      Emit(PlayerEvent("selectedSubtitleChanged").With("track", EventValue()));
+    }
+    external_subtitle_tracks_.erase(it);
+    cues_.RemoveTrack(track_id);
+    PublishSubtitleTracks();
+    return CommandResult();
+  }, std::move(done));
+}
+
+bool Player::SetDisplaySize(int width, int height, CommandCallback done) {
+  if (width < 0 || height < 0) {
+    return Reject(done, "INVALID_ARGS", "Display size must not be negative");
+  }
+  return Submit(kDisplaySizeKey, [this, width, height]() {
+    backend_->SetOutputSizeHint(width, height);
+    return CommandResult();
+  }, std::move(done));
+}
+
+bool Player::SetMaxRenderFrameRate(std::optional<double> max_fps, CommandCallback done) {
+  int64_t interval_us = 0;
+  if (max_fps.has_value()) {
+    if (!std::isfinite(*max_fps) || *max_fps < 0) {
+      return Reject(done, "INVALID_ARGS", "Frame rate cap must not be negative");
+    }
+    interval_us = *max_fps == 0 ? -1 : static_cast<int64_t>(1000000.0 / *max_fps);
+  }
+  min_frame_interval_us_.store(interval_us);
+  return Submit(kRenderPolicyKey, [this]() {
+    UpdateRenderPolicy();
+    return CommandResult();
+  }, std::move(done));
+}
+
+bool Player::SetVisibilityHint(bool visible, CommandCallback done) {
+  visible_.store(visible);
+  // Shares the key with the frame cap: both only re-evaluate the atomics
+  return Submit(kRenderPolicyKey, [this]() {
+    UpdateRenderPolicy();
+    return CommandResult();
+  }, std::move(done));
+}
+
+bool Player::GetWaveform(int bucket_count, WaveformCallback done) {
+  const auto reject = [&done](const char* code, const char* message) {
+    done(CommandResult{code, message}, std::vector<uint8_t>());
+    return false;
+  };
+  if (bucket_count <= 0) return reject("INVALID_ARGS", "Bucket count must be positive");
+  const bool queued = Post([this, bucket_count, done]() {
+    if (waveform_.has_value()) {
+      done(CommandResult(), DownsampleWaveform(waveform_->peaks, bucket_count));
+      return;
+    }
+    if (!initialize_requested_.load()) {
+      done(CommandResult{"WAVEFORM_ERROR", "Player has no source"}, std::vector<uint8_t>());
+      return;
+    }
+    waveform_requests_.push_back({bucket_count, done});
+    // One scan serves every request made while it runs
+    if (!waveform_thread_.joinable()) {
+      waveform_thread_ = std::thread(&Player::ScanWaveform, this, source_);
+    }
+  });
+  if (!queued) return reject("INVALID_PLAYER", "Player has been disposed");
+  return true;
+}
+
+bool Player::CaptureFrame(int max_width, CaptureFormat format, CaptureCallback done) {
+  CommandResult error;
+  {
+    std::lock_guard<std::mutex> lock(capture_mutex_);
+    bool has_frame;
+    {
+      std::lock_guard<std::mutex> frame_lock(latest_frame_mutex_);
+      has_frame = latest_frame_.data != nullptr;
+    }
+    if (disposed_.load()) {
+      error = CommandResult{"INVALID_PLAYER", "Player has been disposed"};
+    } else if (!has_frame) {
+      error = CommandResult{"CAPTURE_ERROR", "No frame has been decoded yet"};
+    } else if (pending_captures_ >= kMaxPendingCaptures) {
+      error = CommandResult{"CAPTURE_ERROR", "Too many captures pending"};
+    } else {
+      if (!capture_started_) {
+        capture_queue_.Start("pvp-capture-" + std::to_string(id_));
+        capture_started_ = true;
+      }
+      // Counted only once queued; RunCapture's release waits for the lock
+      const bool queued = capture_queue_.Post([this, max_width, format, done]() {
+        RunCapture(max_width, format, done);
+      });
+      if (queued) {
+        ++pending_captures_;
+      } else {
+        error = CommandResult{"INVALID_PLAYER", "Player has been disposed"};
+      }
+    }
+  }
+  // Replied outside the lock, so |done| may capture again
+  if (error.ok()) return true;
+  done(error, CapturedFrame());
+  return false;
+}
+
+void Player::RunCapture(int max_width, CaptureFormat format, const CaptureCallback& done) {
+  PVP_TRACE_SCOPE_PLAYER("player", "CaptureFrame", id_);
+  CapturedFrame captured;
+  int width = 0;
+  int height = 0;
+  std::vector<uint8_t> rgba;
+  {
+    // Referenced only while it is scaled into a buffer of the capture's
+    // own; the pooled buffer goes back before the slow encode
+    VideoFrame frame;
+    {
+      std::lock_guard<std::mutex> lock(latest_frame_mutex_);
+      frame = latest_frame_;
+    }
+    rgba = ScaleFrameToRgba(frame, max_width, &width, &height);
+    captured.pts_ms = frame.pts_ms;
+  }
+  if (!rgba.empty()) EncodeRgba(std::move(rgba), width, height, format, &captured);
+  {
+    std::lock_guard<std::mutex> lock(capture_mutex_);
+    --pending_captures_;
+  }
+  if (captured.bytes.empty()) {
+    done(CommandResult{"CAPTURE_ERROR", "Frame has no pixels"}, CapturedFrame());
+    return;
+  }
+  done(CommandResult(), captured);
+}
+
+bool Player::ShedMemory(MemoryPressureLevel level, MemoryShedStep step) {
+  return Post([this, level, step]() {
+    PVP_TRACE_SCOPE_PLAYER("player", "ShedMemory", id_);
+    EventList shed;
+    if (level == MemoryPressureLevel::kNone) {
+      buffer_.OnMemoryRelief();
+      ApplyBufferLimits();
+      Emit(PlayerEvent("memoryPressure").With("level", MemoryPressureLevelName(level)).With("shed", shed));
+      return;
+    }
+    // Cheapest to rebuild first
+    if (backend_->TrimMemory() > 0) shed.emplace_back("frameBuffers");
+    // Reloaded from the disk cache on the next request
+    if (waveform_.has_value()) {
+      waveform_.reset();
+      shed.emplace_back("waveform");
+    }
+    if (step >= MemoryShedStep::kSubtitleWindows) {
+      const int64_t position = clock_.PositionMs();
+      size_t dropped = 0;
+      for (const auto& track : embedded_subtitle_tracks_) {
+        dropped += cues_.TrimOutside(track.id, position - kSubtitleWindowMs, position + kSubtitleWindowMs);
+      }
+      if (dropped > 0) shed.emplace_back("subtitleCues");
+    }
+    if (step >= MemoryShedStep::kForwardBuffers) {
+      buffer_.OnMemoryPressure();
+      if (applied_buffer_limits_ != buffer_.limits()) shed.emplace_back("buffers");
+      ApplyBufferLimits();
+    }
+    if (shed.empty()) return;
+    Emit(PlayerEvent("memoryPressure").With("level", MemoryPressureLevelName(level)).With("shed", std::move(shed)));
+  });
+}
+
+void Player::Dispose() {
+  if (disposed_.exchange(true)) return;
+  PVP_TRACE_SCOPE_PLAYER("player", "Dispose", id_);
+  // Commands already queued still run (with events suppressed) so the
+  // backend sees a consistent call sequence before Close().
+  queue_.Stop();
+  waveform_cancel_.store(true);
+  if (waveform_thread_.joinable()) waveform_thread_.join();
+  for (const auto& request : waveform_requests_) {
+    request.done(CommandResult{"INVALID_PLAYER", "Player has been disposed"}, std::vector<uint8_t>());
+  }
+  waveform_requests_.clear();
+  {
+    // CaptureFrame checks |disposed_| under this lock, so none starts or
+    // posts to the queue past here
+    std::lock_guard<std::mutex> lock(capture_mutex_);
+  }
+  // Captures already queued still finish; joined without the lock, which
+  // RunCapture takes
+  capture_queue_.Stop();
+  {
+    std::lock_guard<std::mutex> lock(latest_frame_mutex_);
+    latest_frame_ = VideoFrame();
+  }
+  if (backend_ != nullptr) {
+    backend_->Close();
+    backend_.reset();
+  }
+  clock_.Stop();
+  std::lock_guard<std::mutex> lock(state_mutex_);
+  state_ = PlaybackState::kDisposed;
+}
+
+// ==================== Queries ====================
+
+PlaybackState Player::state() const {
+  std::lock_guard<std::mutex> lock(state_mutex_);
+  return state_;
+}
+
+int64_t Player::DurationMs() const {
+  std::lock_guard<std::mutex> lock(state_mutex_);
+  return duration_ms_;
+}
+
+double Player::volume() const {
+  std::lock_guard<std::mutex> lock(state_mutex_);
+  return volume_;
+}
+
+double Player::playback_speed() const {
+  std::lock_guard<std::mutex> lock(state_mutex_);
+  return speed_;
+}
+
+bool Player::looping() const {
+  std::lock_guard<std::mutex> lock(state_mutex_);
+  return looping_;
+}
+
+std::vector<AudioTrack> Player::audio_tracks() const {
+  std::lock_guard<std::mutex> lock(state_mutex_);
+  return audio_tracks_;
+}
+
+std::vector<SubtitleTrack> Player::subtitle_tracks() const {
+  std::lock_guard<std::mutex> lock(state_mutex_);
+  return subtitle_tracks_;
+}
+
+std::string Player::selected_audio_track_id() const {
+  std::lock_guard<std::mutex> lock(state_mutex_);
+  return selected_audio_track_id_;
+}
+
+std::string Player::selected_subtitle_track_id() const {
+  std::lock_guard<std::mutex> lock(state_mutex_);
+  return selected_subtitle_track_id_;
+}
+
+// ==================== Backend callbacks ====================
+
+void Player::OnPrepared(const MediaInfo& info) {
+  Post([this, info]() { HandlePrepared(info); });
+}
+
+void Player::OnBufferingChanged(bool buffering) {
+  Post([this, buffering]() {
+    const PlaybackState current = state();
+    const int64_t duration = DurationMs();
+    const int64_t ahead =
+        buffered_position_ms_ < 0 ? -1 : std::max<int64_t>(buffered_position_ms_ - clock_.PositionMs(), 0);
+    // A live window's end moves on; only a finished stream has an end
+    const bool at_end = duration > 0 && buffered_position_ms_ >= duration &&
+                        (timeline_.empty() || timeline_.ended());
+    switch (buffer_.OnStallChanged(buffering, ahead, at_end, current == PlaybackState::kPlaying)) {
+      case BufferController::Transition::kNone:
+        return;
+      case BufferController::Transition::kStarted:
+        Emit(PlayerEvent("bufferingStarted").With("reason", "unknown"));
+        if (current == PlaybackState::kPlaying) {
+          clock_.Stop();
+          SetState(PlaybackState::kBuffering);
+        }
+        break;
+      case BufferController::Transition::kEnded:
+        Emit(PlayerEvent("bufferingEnded"));
+        if (current == PlaybackState::kBuffering) {
+          clock_.Anchor(backend_->QueryPositionMs());
+          clock_.Start();
+          SetState(PlaybackState::kPlaying);
+        }
+        break;
+    }
+    // Dynamic mode grows the buffer on rebuffers
+    ApplyBufferLimits();
+  });
+}
+
+void Player::OnBufferedPosition(int64_t position_ms) {
+  Post([this, position_ms]() {
+    buffered_position_ms_ = position_ms;
+    if (position_ms <= last_sent_buffered_ms_) return;
+    last_sent_buffered_ms_ = position_ms;
+    Emit(PlayerEvent("bufferedPositionChanged").With("bufferedPosition", position_ms));
+  });
+}
+
+void Player::OnVideoSizeChanged(int width, int height) {
+  Post([this, width, height]() {
+    Emit(PlayerEvent("videoSizeChanged").With("width", width).With("height", height));
+  });
+}
+
+void Player::OnTracksChanged(const std::vector<AudioTrack>& audio,
+                             const std::vector<SubtitleTrack>& subtitles) {
+  Post([this, audio, subtitles]() {
+    bool audio_changed;
+    {
+      std::lock_guard<std::mutex> lock(state_mutex_);
+      audio_changed = audio != audio_tracks_;
+      audio_tracks_ = audio;
+    }
+    if (audio_changed && !disposed_.load()) events_->OnAudioTracksChanged(id_, audio);
+    embedded_subtitle_tracks_ = subtitles;
+    PublishSubtitleTracks();
+    if (prepared_) SelectPreferredSubtitle();
+  });
+}
+
+void Player::OnEndOfStream() {
+  Post([this]() { HandleEndOfStream(); });
+}
+
+void Player::OnError(const std::string& code, const std::string& message) {
+  Post([this, code, message]() { HandleError(code, message); });
+}
+
+void Player::OnFrame(const VideoFrame& frame) {
+  if (disposed_.load(std::memory_order_relaxed)) return;
+  {
+    VideoFrame previous;
+    std::lock_guard<std::mutex> lock(latest_frame_mutex_);
+    previous = std::move(latest_frame_);
+    latest_frame_ = frame;
+    // |previous| lets go of its buffer after the lock
+  }
+  // The backend already dropped what the render policy rules out
+  PVP_TRACE_SCOPE_PLAYER("render", "present", id_);
+  if (frames_ != nullptr) frames_->OnFrame(id_, frame);
+  frames_rendered_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Player::OnAudioSamples(const AudioSamples& samples) {
+  if (!audio_levels_enabled_.load(std::memory_order_relaxed) ||
+      disposed_.load(std::memory_order_relaxed) || samples.sample_rate <= 0) {
+    return;
+  }
+  meter_.Add(samples);
+  const size_t window_frames =
+      static_cast<size_t>(samples.sample_rate) * kAudioLevelsInterval.count() / 1000;
+  if (meter_.frames() < window_frames) return;
+  OnAudioLevels(meter_.TakeLevels());
+}
+
+void Player::OnAudioLevels(const AudioLevels& levels) {
+  if (!audio_levels_enabled_.load(std::memory_order_relaxed) || disposed_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  Post([this, levels]() {
+    EventList peak;
+    EventList rms;
+    for (float value : levels.peak) peak.emplace_back(static_cast<double>(value));
+    for (float value : levels.rms) rms.emplace_back(static_cast<double>(value));
+    Emit(PlayerEvent("audioLevelsChanged").With("peak", std::move(peak)).With("rms", std::move(rms)));
+  });
+}
+
+void Player::OnLivePlaylist(const std::string& playlist) {
+  Post([this, playlist]() { HandleLivePlaylist(playlist); });
+}
+
+void Player::OnSubtitleCue(const std::string& track_id, const SubtitleCue& cue) {
+  // Stored on the calling thread; only the worker decides what is showing
+  if (cues_.Add(track_id, cue)) Post([this]() { UpdateSubtitleCue(); });
+}
+
+// ==================== Worker ====================
+
+void Player::HandlePrepared(const MediaInfo& info) {
+  PVP_TRACE_SCOPE_PLAYER("player", "Prepared", id_);
+  prepared_ = true;
+  bool audio_changed;
+  const int64_t duration = timeline_.empty() ? info.duration_ms : timeline_.end_ms();
+  {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    duration_ms_ = duration;
+    // A backend may already have reported the same lists through
+    // OnTracksChanged; Dart hears about each list once
+    audio_changed = info.audio_tracks != audio_tracks_;
+    audio_tracks_ = info.audio_tracks;
+  }
+  clock_.SetDuration(info.duration_ms);
+  if (info.is_live && options_.target_live_latency_ms > 0) {
+    LiveLatencyController::Options live;
+    live.target_ms = options_.target_live_latency_ms;
+    live_sync_.emplace(live);
+    buffer_ = BufferController(LowLatencyBufferLimits(live.target_ms), false);
+    ApplyBufferLimits();
+  }
+  SetState(PlaybackState::kReady);
+  Emit(PlayerEvent("durationChanged").With("duration", duration));
+  if (info.width > 0 && info.height > 0) {
+    Emit(PlayerEvent("videoSizeChanged").With("width", info.width).With("height", info.height));
+  }
+  if (audio_changed && !disposed_.load()) events_->OnAudioTracksChanged(id_, info.audio_tracks);
+  embedded_subtitle_tracks_ = info.subtitle_tracks;
+  PublishSubtitleTracks();
+  ApplyTrackPreferences(info.selected_audio_track_id);
+
+  if (volume() != 1.0) backend_->SetVolume(volume());
+  if (playback_speed() != 1.0) backend_->SetRate(playback_speed());
+  if (!video_enabled_) backend_->SetVideoEnabled(false);
+  if (options_.start_position_ms.has_value()) {
+    DoSeek(*options_.start_position_ms);
+    options_.start_position_ms.reset();
+  }
+  if (play_when_ready_) DoPlay();
+}
+
+void Player::HandleEndOfStream() {
+  if (looping()) {
+    DoSeek(0);
+    backend_->Play();
+    return;
+  }
+  clock_.Stop();
+  clock_.Anchor(DurationMs());
+  SetState(PlaybackState::kCompleted);
+  EmitPosition(true);
+  if (!disposed_.load()) events_->OnPlaybackCompleted(id_);
+}
+
+void Player::HandleError(const std::string& code, const std::string& message) {
+  clock_.Stop();
+  SetState(PlaybackState::kError);
+  if (!disposed_.load()) events_->OnError(id_, code, message);
+}
+
+void Player::HandleLivePlaylist(const std::string& playlist) {
+  PVP_TRACE_SCOPE_PLAYER("player", "LivePlaylist", id_);
+  const int64_t start = timeline_.start_ms();
+  const int64_t end = timeline_.end_ms();
+  timeline_.MergeMediaPlaylist(playlist);
+  if (timeline_.start_ms() == start && timeline_.end_ms() == end) return;
+  {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    duration_ms_ = timeline_.end_ms();
+  }
+  if (!prepared_) return;
+  Emit(PlayerEvent("durationChanged").With("duration", timeline_.end_ms()));
+  Emit(PlayerEvent("seekableRangeChanged")
+           .With("start", timeline_.start_ms())
+           .With("end", timeline_.end_ms()));
+}
+
+void Player::DoPlay() {
+  if (!prepared_) {
+    play_when_ready_ = true;
+    return;
+  }
+  const PlaybackState current = state();
+  if (current == PlaybackState::kPlaying || current == PlaybackState::kError) return;
+  if (current == PlaybackState::kCompleted) DoSeek(0);
+  backend_->Play();
+  clock_.Start();
+  // Latency grew while paused; measure it afresh
+  if (live_sync_.has_value()) live_sync_->Reset();
+  SetState(buffer_.buffering() ? PlaybackState::kBuffering : PlaybackState::kPlaying);
+  if (buffer_.buffering()) clock_.Stop();
+  // Restart position ticks
+  queue_.WakeTimer();
+}
+
+void Player::DoSeek(int64_t position_ms) {
+  const int64_t duration = DurationMs();
+  if (duration > 0) position_ms = std::min(position_ms, duration);
+  // Segments before the window are gone from the server
+  if (!timeline_.empty()) position_ms = std::clamp(position_ms, timeline_.start_ms(), timeline_.end_ms());
+  // Only a jump forward within what is buffered keeps the buffer
+  if (position_ms < clock_.PositionMs() || position_ms > buffered_position_ms_) buffered_position_ms_ = -1;
+  buffer_.OnSeek();
+  backend_->Seek(position_ms);
+  clock_.Anchor(position_ms);
+  if (state() == PlaybackState::kCompleted) SetState(PlaybackState::kPaused);
+  EmitPosition(true);
+  UpdateSubtitleCue();
+}
+
+void Player::SetState(PlaybackState new_state) {
+  {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    if (state_ == new_state || state_ == PlaybackState::kDisposed) return;
+    state_ = new_state;
+  }
+  PVP_TRACE_INSTANT("player", PlaybackStateName(new_state), id_);
+  Emit(PlayerEvent("playbackStateChanged").With("state", PlaybackStateName(new_state)));
+  if (prepared_) {
+    buffer_.SetIdle(new_state != PlaybackState::kPlaying && new_state != PlaybackState::kBuffering);
+    ApplyBufferLimits();
+  }
+}
+
+void Player::Emit(const PlayerEvent& event) {
+  if (disposed_.load()) return;
+  PVP_TRACE_SCOPE_PLAYER("event", "emit", id_);
+  events_->OnEvent(id_, event);
+}
+
+void Player::EmitPosition(bool force) {
+  const int64_t position = clock_.PositionMs();
+  if (!force && last_sent_position_ms_ >= 0 &&
+      std::abs(position - last_sent_position_ms_) < kPositionEpsilonMs) {
+    return;
+  }
+  last_sent_position_ms_ = position;
+  Emit(PlayerEvent("positionChanged").With("position", position));
+}
+
+void Player::ApplyTrackPreferences(const std::string& backend_audio_id) {
+  const auto audio = audio_tracks();
+  std::string audio_id;
+  int best_score = -1;
+  for (const auto& track : audio) {
+    const int score = AudioTrackScore(track, options_.preferred_audio_language,
+                                      options_.preferred_audio_rendition);
+    if (score > best_score) {
+      best_score = score;
+      audio_id = track.id;
+    }
+  }
+
+  // Backends honouring SetPreferredLanguages usually opened on the right
+  // track already; switching anyway would restart the audio decoder
+  if (!audio_id.empty() && audio_id != backend_audio_id) backend_->SelectAudioTrack(audio_id);
+  {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    selected_audio_track_id_ = audio_id;
+  }
+  SelectPreferredSubtitle();
+}
+
+void Player::PublishSubtitleTracks() {
+  std::vector<SubtitleTrack> tracks = embedded_subtitle_tracks_;
+  tracks.insert(tracks.end(), external_subtitle_tracks_.begin(), external_subtitle_tracks_.end());
+  {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    if (tracks == subtitle_tracks_) return;
+    subtitle_tracks_ = tracks;
+  }
+  if (!disposed_.load()) events_->OnSubtitleTracksChanged(id_, tracks);
+}
+
+void Player::SelectPreferredSubtitle() {
+  if (subtitle_chosen_ || options_.preferred_subtitle_language.empty() ||
+      !selected_subtitle_track_id().empty()) {
+    return;
+  }
+  for (const auto& track : subtitle_tracks()) {
+    if (LanguageMatches(track.language, options_.preferred_subtitle_language)) {
+      ActivateSubtitleTrack(track.id, true);
+      return;
+    }
+  }
+}
+
+void Player::ActivateSubtitleTrack(const std::string& track_id, bool notify) {
+  // External cues come from the store alone; the backend keeps its own
+  // subtitle stream off so it neither draws nor demuxes it
+  backend_->SelectSubtitleTrack(IsExternalSubtitle(track_id) ? std::string() : track_id);
+  {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    selected_subtitle_track_id_ = track_id;
+  }
+  if (notify && prepared_) {
+    EventValue selected;
+    for (const auto& track : subtitle_tracks()) {
+      if (track.id == track_id) selected = ToEventValue(track);
+    }
+    Emit(PlayerEvent("selectedSubtitleChanged").With("track", std::move(selected)));
+  }
+  UpdateSubtitleCue();
+  queue_.WakeTimer();
+}
+
+bool Player::IsExternalSubtitle(const std::string& track_id) const {
+  return std::any_of(external_subtitle_tracks_.begin(), external_subtitle_tracks_.end(),
+                     [&](const SubtitleTrack& track) { return track.id == track_id; });
+}
+
+void Player::UpdateSubtitleCue() {
+  if (subtitle_render_mode_ != SubtitleRenderMode::kFlutter) return;
+  const std::string track_id = selected_subtitle_track_id();
+  std::optional<SubtitleCue> cue;
+  if (!track_id.empty()) cue = cues_.ActiveAt(track_id, clock_.PositionMs());
+  if (cue == sent_cue_) return;
+  sent_cue_ = cue;
+  PlayerEvent event("embeddedSubtitleCue");
+  if (cue.has_value()) {
+    event.With("text", cue->text).With("startMs", cue->start_ms).With("endMs", cue->end_ms);
+  } else {
+    event.With("text", EventValue());
+  }
+  Emit(event.With("trackId", track_id));
+}
+
+void Player::UpdateRenderPolicy() {
+  const int64_t interval_us = min_frame_interval_us_.load();
+  const bool visible = visible_.load();
+  backend_->SetRenderPolicy(interval_us, visible);
+  const bool enabled = visible && interval_us >= 0;
+  if (enabled == video_enabled_) return;
+  video_enabled_ = enabled;
+  // Applied on prepare if the source is still opening
+  if (prepared_) backend_->SetVideoEnabled(enabled);
+}
+
+void Player::UpdateLiveLatency() {
+  const int64_t position = clock_.PositionMs();
+  const int64_t ahead =
+      buffered_position_ms_ < 0 ? -1 : std::max<int64_t>(buffered_position_ms_ - position, 0);
+  int64_t latency = backend_->QueryLiveLatencyMs();
+  if (latency < 0) latency = ahead;
+  if (latency < 0) return;
+  bool rate_changed = false;
+  if (!user_rate_) {
+    const LiveLatencyController::Decision decision = live_sync_->Update(latency, ahead);
+    if (decision.seek_by_ms > 0) {
+      PVP_TRACE_INSTANT("player", "LiveCatchUpSeek", id_);
+      DoSeek(position + decision.seek_by_ms);
+    }
+    rate_changed = decision.rate != live_rate_;
+    if (rate_changed) {
+      live_rate_ = decision.rate;
+      ApplyRate();
+    }
+  }
+  if (!rate_changed && last_sent_latency_ms_ >= 0 &&
+      std::abs(latency - last_sent_latency_ms_) < kPositionEpsilonMs) {
+    return;
+  }
+  last_sent_latency_ms_ = latency;
+  Emit(PlayerEvent("liveLatency")
+           .With("latency", latency)
+           .With("targetLatency", live_sync_->target_ms())
+           .With("playbackRate", effective_rate()));
+}
+
+double Player::effective_rate() const {
+  return playback_speed() * live_rate_;
+}
+
+void Player::ApplyRate() {
+  const double rate = effective_rate();
+  clock_.SetRate(rate);
+  backend_->SetRate(rate);
+}
+
+void Player::ApplyBufferLimits() {
+  if (applied_buffer_limits_ == buffer_.limits()) return;
+  applied_buffer_limits_ = buffer_.limits();
+  backend_->SetBufferLimits(buffer_.limits());
+}
+
+void Player::ScanWaveform(MediaSource source) {
+  TraceRecorder::Instance().SetCurrentThreadName("pvp-waveform-" + std::to_string(id_));
+  PVP_TRACE_SCOPE_PLAYER("player", "ScanWaveform", id_);
+  WaveformCache& cache = WaveformCache::Instance();
+  const std::string key = WaveformCache::KeyFor(source);
+  Waveform waveform;
+  if (!cache.Load(key, &waveform)) {
+    WaveformBuilder builder;
+    const bool scanned = backend_->ScanAudio(
+        source, [&builder](const AudioSamples& samples) { builder.Add(samples); }, waveform_cancel_);
+    if (scanned && !waveform_cancel_.load()) {
+      waveform = builder.Finish();
+      if (!waveform.peaks.empty()) cache.Store(key, waveform);
+    }
+  }
+  Post([this, waveform = std::move(waveform)]() {
+    // The thread is on its way out; reap it so a failed scan can be retried
+    if (waveform_thread_.joinable()) waveform_thread_.join();
+    if (!waveform.peaks.empty()) waveform_ = waveform;
+    for (const auto& request : waveform_requests_) {
+      request.done(CommandResult(), DownsampleWaveform(waveform.peaks, request.bucket_count));
+    }
+    waveform_requests_.clear();
+  });
+}
+
+std::chrono::milliseconds Player::Tick() {
+  if (!prepared_ || disposed_.load() || state() != PlaybackState::kPlaying) {
+    return std::chrono::milliseconds(-1);
+  }
+  PVP_TRACE_SCOPE_PLAYER("player", "Tick", id_);
+  const int64_t backend_position = backend_->QueryPositionMs();
+  if (backend_position >= 0) clock_.Anchor(backend_position);
+  EmitPosition(false);
+  if (live_sync_.has_value()) UpdateLiveLatency();
+  UpdateSubtitleCue();
+  if (subtitle_render_mode_ != SubtitleRenderMode::kFlutter) return kPositionInterval;
+  // Wake up for the next cue edge rather than up to 500 ms late
+  const int64_t position = clock_.PositionMs();
+  const int64_t next = cues_.NextChangeAfter(selected_subtitle_track_id(), position);
+  if (next < 0) return kPositionInterval;
+  const auto until_next = std::chrono::milliseconds(
+      static_cast<int64_t>(std::ceil((next - position) / effective_rate())));
+  return std::clamp(until_next, std::chrono::milliseconds(1), kPositionInterval);
+}
+
+}  // namespace pro_video_player
@@ -0,0 +1,305 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_PLAYER_H_
+#define PRO_VIDEO_PLAYER_SHARED_PLAYER_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "audio_levels.h"
+#include "buffer_controller.h"
+#include "command_queue.h"
+#include "decode_backend.h"
+#include "frame_capture.h"
+#include "live_latency.h"
+#include "media_clock.h"
+#include "memory_pressure.h"
+#include "player_event_sink.h"
+#include "player_types.h"
+#include "segment_timeline.h"
+#include "subtitle_cues.h"
+#include "waveform.h"
+
+namespace pro_video_player {
+
+// One video player: lifecycle, state machine, clock, tracks and render
+// policy on top of a DecodeBackend.
+//
+// Control methods are thread-safe and asynchronous: they validate their
+// arguments, queue a command for the player's worker thread and return.
+// The optional |done| callback receives the outcome once the command has
+// been applied (see CommandCallback). Repeated seeks and setter calls that
+// pile up while the worker is busy are coalesced, so only the last value
+// reaches the backend; the earlier calls still complete successfully.
+// Getters return snapshots and may be called from any thread.
+class Player : private DecodeBackendListener {
+ public:
+  // Position event cadence while playing, matching the mobile
+  // implementations. Nothing is polled while paused.
+  static constexpr std::chrono::milliseconds kPositionInterval{500};
+  // Position changes smaller than this are not re-sent.
+  static constexpr int64_t kPositionEpsilonMs = 100;
+  // Embedded subtitle cues kept around the playhead under memory pressure.
+  static constexpr int64_t kSubtitleWindowMs = 60000;
+  // "audioLevelsChanged" cadence when enabled (VU meters want ~20 Hz).
+  static constexpr std::chrono::milliseconds kAudioLevelsInterval{50};
+  // Captures queued or encoding at a time; more are refused.
+  static constexpr int kMaxPendingCaptures = 4;
+
+  // Outcome and peaks for GetWaveform.
+  using WaveformCallback =
+      std::function<void(const CommandResult& result, const std::vector<uint8_t>& peaks)>;
+  // Outcome and the encoded frame for CaptureFrame.
+  using CaptureCallback = std::function<void(const CommandResult& result, const CapturedFrame& frame)>;
+  // Outcome and the new track for AddExternalSubtitle.
+  using ExternalSubtitleCallback =
+      std::function<void(const CommandResult& result, const SubtitleTrack& track)>;
+
+  Player(int64_t id, std::unique_ptr<DecodeBackend> backend, PlayerEventSink* events,
+         FrameSink* frames);
+  ~Player() override;
+
+  Player(const Player&) = delete;
+  Player& operator=(const Player&) = delete;
+
+  // Opens |source|. Returns false if already initialized or disposed.
+  bool Initialize(const MediaSource& source, const PlayerOptions& options);
+
+  bool Play(CommandCallback done = CommandCallback());
+  bool Pause(CommandCallback done = CommandCallback());
+  bool SeekTo(int64_t position_ms, CommandCallback done = CommandCallback());
+  // |speed| must be within [kMinTimeStretchRate, kMaxTimeStretchRate].
+  bool SetPlaybackSpeed(double speed, CommandCallback done = CommandCallback());
+  // |volume| must be within [0, 1].
+  bool SetVolume(double volume, CommandCallback done = CommandCallback());
+  bool SetLooping(bool looping, CommandCallback done = CommandCallback());
+  bool SetAudioTrack(const std::string& track_id, CommandCallback done = CommandCallback());
+  // Empty |track_id| turns subtitles off. Embedded and external tracks
+  // share one list and one selection.
+  bool SetSubtitleTrack(const std::string& track_id, CommandCallback done = CommandCallback());
+  // kFlutter hides backend-drawn subtitles and emits "embeddedSubtitleCue"
+  // whenever the cue showing on the selected track changes.
+  bool SetSubtitleRenderMode(SubtitleRenderMode mode, CommandCallback done = CommandCallback());
+  // Parses |subtitle| (SubRip or WebVTT) into the same cue store the
+  // backend fills from embedded tracks and appends it to the subtitle
+  // tracks. Fails with SUBTITLE_ERROR if nothing could be parsed.
+  bool AddExternalSubtitle(ExternalSubtitle subtitle, ExternalSubtitleCallback done);
+  bool RemoveExternalSubtitle(const std::string& track_id, CommandCallback done = CommandCallback());
+
+  // Render policy (see setDisplaySize / setMaxRenderFrameRate /
+  // setVisibilityHint). A 0 fps cap or a hidden view disables video
+  // decoding in the backend; intermediate caps have the backend drop
+  // frames before it converts them.
+  bool SetDisplaySize(int width, int height, CommandCallback done = CommandCallback());
+  bool SetMaxRenderFrameRate(std::optional<double> max_fps,
+                             CommandCallback done = CommandCallback());
+  bool SetVisibilityHint(bool visible, CommandCallback done = CommandCallback());
+
+  // Replies with the file's waveform max-pooled to at most |bucket_count|
+  // peaks (see Waveform). The first call scans the audio on a background
+  // thread unless the waveform is cached on disk; the reply is empty if the
+  // backend can't analyse audio.
+  bool GetWaveform(int bucket_count, WaveformCallback done);
+
+  // Replies with the most recently decoded frame, scaled down to at most
+  // |max_width| pixels wide (<= 0 keeps its size) and encoded as
+  // |format|, on a capture thread of the player's own; |done| runs on that
+  // thread. The pooled frame is only referenced while it is scaled into a
+  // buffer of the capture's own, so captures don't hold up playback. Fails
+  // with CAPTURE_ERROR before the first frame and while
+  // kMaxPendingCaptures are already waiting.
+  bool CaptureFrame(int max_width, CaptureFormat format, CaptureCallback done);
+
+  // Gives up memory under pressure, every MemoryShedStep up to |step|,
+  // and emits "memoryPressure" with the level and what was shed. kNone
+  // ends the episode: fixed buffering tiers get their watermarks back.
+  bool ShedMemory(MemoryPressureLevel level, MemoryShedStep step);
+
+  // Drains queued commands, closes the backend and joins the worker.
+  // Idempotent; no events are emitted afterwards.
+  void Dispose();
+
+  int64_t id() const { return id_; }
+  std::string backend_name() const { return backend_name_; }
+  PlaybackState state() const;
+  int64_t PositionMs() const { return clock_.PositionMs(); }
+  int64_t DurationMs() const;
+  double volume() const;
+  double playback_speed() const;
+  bool looping() const;
+  std::vector<AudioTrack> audio_tracks() const;
+  std::vector<SubtitleTrack> subtitle_tracks() const;
+  std::string selected_audio_track_id() const;
+  std::string selected_subtitle_track_id() const;
+
+  // Frames forwarded to the FrameSink.
+  uint64_t frames_rendered() const { return frames_rendered_.load(std::memory_order_relaxed); }
+
+ private:
+  // DecodeBackendListener; marshalled onto the worker except OnFrame.
+  void OnPrepared(const MediaInfo& info) override;
+  void OnBufferingChanged(bool buffering) override;
+  void OnBufferedPosition(int64_t position_ms) override;
+  void OnVideoSizeChanged(int width, int height) override;
+  void OnTracksChanged(const std::vector<AudioTrack>& audio,
+                       const std::vector<SubtitleTrack>& subtitles) override;
+  void OnEndOfStream() override;
+  void OnError(const std::string& code, const std::string& message) override;
+  void OnFrame(const VideoFrame& frame) override;
+  void OnAudioSamples(const AudioSamples& samples) override;
+  void OnAudioLevels(const AudioLevels& levels) override;
+  void OnSubtitleCue(const std::string& track_id, const SubtitleCue& cue) override;
+  void OnLivePlaylist(const std::string& playlist) override;
+
+  // CommandQueue coalescing keys, one per idempotent control command.
+  enum CommandKey : int {
+    kNoKey = 0,
+    kSeekKey,
+    kSpeedKey,
+    kVolumeKey,
+    kLoopingKey,
+    kDisplaySizeKey,
+    kRenderPolicyKey,
+  };
+  using Action = std::function<CommandResult()>;
+
+  // Worker-thread helpers.
+  bool Post(CommandQueue::Command command);
+  // Queues a control command and reports its result to |done|.
+  bool Submit(CommandKey key, Action action, CommandCallback done);
+  static bool Reject(const CommandCallback& done, std::string code, std::string message);
+  void HandlePrepared(const MediaInfo& info);
+  void HandleEndOfStream();
+  void HandleError(const std::string& code, const std::string& message);
+  void HandleLivePlaylist(const std::string& playlist);
+  void DoPlay();
+  void DoSeek(int64_t position_ms);
+  void SetState(PlaybackState state);
+  void Emit(const PlayerEvent& event);
+  void EmitPosition(bool force);
+  // |backend_audio_id| is the track the backend opened with, if known.
+  void ApplyTrackPreferences(const std::string& backend_audio_id);
+  // Embedded + external tracks; emits the list only if it changed.
+  void PublishSubtitleTracks();
+  // Selects the first track matching preferred_subtitle_language if
+  // nothing is selected yet and the user hasn't chosen, so tracks that
+  // appear after prepare (HLS, external files) are honoured too.
+  void SelectPreferredSubtitle();
+  void ActivateSubtitleTrack(const std::string& track_id, bool notify);
+  bool IsExternalSubtitle(const std::string& track_id) const;
+  // Emits "embeddedSubtitleCue" if the cue showing now differs from the
+  // last one sent (Flutter render mode only).
+  void UpdateSubtitleCue();
+  // Hands the frame cap and visibility to the backend, and turns video
+  // decoding off for a 0 fps cap or a hidden view.
+  void UpdateRenderPolicy();
+  // Live low-latency mode: measures the latency, applies the catch-up
+  // rate and emits "liveLatency".
+  void UpdateLiveLatency();
+  // The user's speed times the catch-up rate.
+  double effective_rate() const;
+  // Sets the backend and clock to effective_rate().
+  void ApplyRate();
+  // Hands buffer_.limits() to the backend if they changed.
+  void ApplyBufferLimits();
+  void ScanWaveform(MediaSource source);
+  // Capture thread.
+  void RunCapture(int max_width, CaptureFormat format, const CaptureCallback& done);
+  std::chrono::milliseconds Tick();
+
+  const int64_t id_;
+  const std::string backend_name_;
+  std::unique_ptr<DecodeBackend> backend_;
+  PlayerEventSink* const events_;
+  FrameSink* const frames_;
+  CommandQueue queue_;
+  MediaClock clock_;
+
+  // Written on the worker, read anywhere.
+  mutable std::mutex state_mutex_;
+  PlaybackState state_ = PlaybackState::kUninitialized;
+  int64_t duration_ms_ = 0;
+  double volume_ = 1.0;
+  double speed_ = 1.0;
+  bool looping_ = false;
+  std::vector<AudioTrack> audio_tracks_;
+  std::vector<SubtitleTrack> subtitle_tracks_;
+  std::string selected_audio_track_id_;
+  std::string selected_subtitle_track_id_;
+
+  // Worker only.
+  MediaSource source_;
+  PlayerOptions options_;
+  bool prepared_ = false;
+  bool play_when_ready_ = false;
+  BufferController buffer_;
+  std::optional<BufferLimits> applied_buffer_limits_;
+  // Latest from the backend; -1 when unknown (e.g. after a seek out of
+  // the buffered range).
+  int64_t buffered_position_ms_ = -1;
+  int64_t last_sent_position_ms_ = -1;
+  int64_t last_sent_buffered_ms_ = -1;
+  // Set on prepare for live streams with a target latency.
+  std::optional<LiveLatencyController> live_sync_;
+  double live_rate_ = 1.0;
+  // Set while a speed the user picked is in force: catching up leaves the
+  // rate alone until a seek to the live edge.
+  bool user_rate_ = false;
+  int64_t last_sent_latency_ms_ = -1;
+  // DVR window of a live stream whose backend passes on its playlists;
+  // DurationMs() is its end and seeks are kept inside it.
+  SegmentTimeline timeline_;
+  bool video_enabled_ = true;
+  struct WaveformRequest {
+    int bucket_count;
+    WaveformCallback done;
+  };
+  std::vector<WaveformRequest> waveform_requests_;
+  std::optional<Waveform> waveform_;
+  std::thread waveform_thread_;
+  std::atomic<bool> waveform_cancel_{false};
+  std::vector<SubtitleTrack> embedded_subtitle_tracks_;
+  std::vector<SubtitleTrack> external_subtitle_tracks_;
+  int external_subtitle_count_ = 0;
+  bool subtitle_chosen_ = false;
+  SubtitleRenderMode subtitle_render_mode_ = SubtitleRenderMode::kAuto;
+  std::optional<SubtitleCue> sent_cue_;
+
+  // Filled from the worker and from backend threads.
+  SubtitleCueStore cues_;
+
+  std::atomic<bool> initialize_requested_{false};
+  std::atomic<bool> disposed_{false};
+
+  // Render policy; set by the control methods, applied on the worker.
+  std::atomic<bool> visible_{true};
+  // 0 = uncapped, < 0 = no video.
+  std::atomic<int64_t> min_frame_interval_us_{0};
+
+  // Frame path (streaming thread).
+  std::atomic<uint64_t> frames_rendered_{0};
+  // Newest frame from the backend, for CaptureFrame; holds a reference to
+  // its buffer (see kFramesHeldByPlayer).
+  std::mutex latest_frame_mutex_;
+  VideoFrame latest_frame_;
+
+  // Encodes captures; started on the first one.
+  std::mutex capture_mutex_;
+  CommandQueue capture_queue_;
+  bool capture_started_ = false;
+  int pending_captures_ = 0;
+
+  // Audio tap (backend audio thread).
+  std::atomic<bool> audio_levels_enabled_{false};
+  AudioLevelMeter meter_;
+};
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_PLAYER_H_
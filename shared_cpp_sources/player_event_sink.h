@@ -0,0 +1,41 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_PLAYER_EVENT_SINK_H_
+#define PRO_VIDEO_PLAYER_SHARED_PLAYER_EVENT_SINK_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "player_types.h"
+
+namespace pro_video_player {
+
+// Receives everything a player reports to Dart.
+//
+// Follows the hybrid event system: high-frequency events go through
+// OnEvent (EventChannel), the rest map onto ProVideoPlayerFlutterApi.
+// Methods are called on the player's worker thread; embedders must hop to
+// the platform thread before touching Flutter APIs.
+class PlayerEventSink {
+ public:
+  virtual ~PlayerEventSink() = default;
+
+  virtual void OnEvent(int64_t player_id, const PlayerEvent& event) = 0;
+  virtual void OnError(int64_t player_id, const std::string& code, const std::string& message) = 0;
+  virtual void OnPlaybackCompleted(int64_t player_id) = 0;
+  virtual void OnAudioTracksChanged(int64_t player_id, const std::vector<AudioTrack>& tracks) = 0;
+  virtual void OnSubtitleTracksChanged(int64_t player_id,
+                                       const std::vector<SubtitleTrack>& tracks) = 0;
+};
+
+// Receives frames that passed the render rate cap and visibility checks.
+// Called on the backend's streaming thread; must not block.
+class FrameSink {
+ public:
+  virtual ~FrameSink() = default;
+
+  virtual void OnFrame(int64_t player_id, const VideoFrame& frame) = 0;
+};
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_PLAYER_EVENT_SINK_H_
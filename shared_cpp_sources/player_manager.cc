@@ -0,0 +1,170 @@
+#include "player_manager.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "trace_recorder.h"
+
+namespace pro_video_player {
+
+PlayerManager::PlayerManager(PlayerEventSink* events, FrameSink* frames,
+                             DecodeBackendRegistry* registry, CodecCapabilityCache* codecs)
+    : events_(events), frames_(frames), registry_(registry), codecs_(codecs) {}
+
+PlayerManager::~PlayerManager() {
+  memory_monitor_.reset();
+  for (auto& warm_up : warm_ups_) warm_up.second.thread.join();
+  DisposeAll();
+}
+
+int64_t PlayerManager::Create(const MediaSource& source, const PlayerOptions& options,
+                              const std::string& backend_name) {
+  PVP_TRACE_SCOPE("manager", "Create");
+  std::unique_ptr<DecodeBackend> backend = registry_->Create(backend_name);
+  if (backend == nullptr) return -1;
+
+  int64_t player_id;
+  std::shared_ptr<Player> player;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    player_id = next_player_id_++;
+    player = std::make_shared<Player>(player_id, std::move(backend), events_, frames_);
+    players_[player_id] = player;
+  }
+  player->Initialize(source, options);
+  return player_id;
+}
+
+std::shared_ptr<Player> PlayerManager::Get(int64_t player_id) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto it = players_.find(player_id);
+  return it == players_.end() ? nullptr : it->second;
+}
+
+bool PlayerManager::Dispose(int64_t player_id) {
+  std::shared_ptr<Player> player;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = players_.find(player_id);
+    if (it == players_.end()) return false;
+    player = std::move(it->second);
+    players_.erase(it);
+  }
+  // Outside the lock: joins the player's worker
+  player->Dispose();
+  return true;
+}
+
+void PlayerManager::DisposeAll() {
+  std::map<int64_t, std::shared_ptr<Player>> players;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    players.swap(players_);
+  }
+  for (auto& entry : players) entry.second->Dispose();
+}
+
+bool PlayerManager::WatchMemoryPressure(MemoryPressureMonitor::Options options) {
+  memory_monitor_.reset();
+  auto monitor = std::make_unique<MemoryPressureMonitor>(
+      std::move(options), [this](MemoryPressureLevel level, MemoryShedStep step, const MemoryStats&) {
+        OnMemoryPressure(level, step);
+      });
+  if (!monitor->running()) return false;
+  memory_monitor_ = std::move(monitor);
+  return true;
+}
+
+void PlayerManager::OnMemoryPressure(MemoryPressureLevel level, MemoryShedStep step) {
+  std::vector<std::shared_ptr<Player>> players;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : players_) players.push_back(entry.second);
+  }
+  for (const auto& player : players) player->ShedMemory(level, step);
+}
+
+size_t PlayerManager::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return players_.size();
+}
+
+std::string PlayerManager::NativePlayerType() const {
+  std::vector<std::string> active;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : players_) {
+      const std::string name = entry.second->backend_name();
+      if (std::find(active.begin(), active.end(), name) == active.end()) active.push_back(name);
+    }
+  }
+  if (active.empty()) return registry_->DisplayName();
+
+  std::sort(active.begin(), active.end());
+  std::string result;
+  for (const auto& name : active) {
+    if (!result.empty()) result += ", ";
+    result += name;
+  }
+  return result;
+}
+
+void PlayerManager::WarmUp(const std::string& backend_name, std::function<void(const WarmUpReport&)> done) {
+  const std::string name = backend_name.empty() ? registry_->default_name() : backend_name;
+  std::unique_lock<std::mutex> lock(mutex_);
+  WarmUpState& state = warm_ups_[name];
+  if (state.finished) {
+    const WarmUpReport report = state.report;
+    lock.unlock();
+    if (done) done(report);
+    return;
+  }
+  if (done) state.waiting.push_back(std::move(done));
+  if (state.thread.joinable()) return;
+  state.thread = std::thread([this, name]() {
+    TraceRecorder::Instance().SetCurrentThreadName("pvp-warm-up");
+    PVP_TRACE_SCOPE("manager", "WarmUp");
+    WarmUpReport report;
+    report.backend = name;
+    const int64_t start_us = TraceRecorder::NowMicros();
+    int64_t step_us = start_us;
+    // Milliseconds since the previous step
+    auto lap = [&step_us]() {
+      const int64_t now_us = TraceRecorder::NowMicros();
+      const int64_t ms = (now_us - step_us) / 1000;
+      step_us = now_us;
+      return ms;
+    };
+    report.initialized = registry_->Initialize(name);
+    report.initialize_ms = lap();
+    if (report.initialized) {
+      codecs_->Get(name, registry_->Probe(name));
+      report.probe_ms = lap();
+      if (std::unique_ptr<DecodeBackend> backend = registry_->Create(name)) {
+        report.pipeline = backend->WarmUp();
+        backend->Close();
+      }
+      report.pipeline_ms = lap();
+    }
+    report.total_ms = (TraceRecorder::NowMicros() - start_us) / 1000;
+    TraceRecorder::Instance().AddCounter("warm_up_ms", report.total_ms);
+    std::vector<std::function<void(const WarmUpReport&)>> waiting;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      WarmUpState& state = warm_ups_[name];
+      state.finished = true;
+      state.report = report;
+      waiting.swap(state.waiting);
+    }
+    for (const auto& done : waiting) done(report);
+  });
+}
+
+CodecCheck PlayerManager::CanPlay(const VideoMetadata& metadata, const std::string& backend_name) const {
+  const std::string name = backend_name.empty() ? registry_->default_name() : backend_name;
+  const auto capabilities = codecs_->Get(name, registry_->Probe(name));
+  if (capabilities == nullptr) return {CodecSupport::kUnknown, "Can't list the decoders of " + name};
+  return capabilities->CanPlay(metadata);
+}
+
+}  // namespace pro_video_player
@@ -0,0 +1,125 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_PLAYER_MANAGER_H_
+#define PRO_VIDEO_PLAYER_SHARED_PLAYER_MANAGER_H_
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "codec_capabilities.h"
+#include "decode_backend.h"
+#include "memory_pressure.h"
+#include "player.h"
+#include "player_event_sink.h"
+#include "player_types.h"
+
+namespace pro_video_player {
+
+// Owns all players of one plugin instance and hands out their ids.
+//
+// This is what the Windows and Linux host API implementations delegate to;
+// everything platform specific (textures, event channels, threads) stays in
+// the plugin behind PlayerEventSink and FrameSink.
+class PlayerManager {
+ public:
+  PlayerManager(PlayerEventSink* events, FrameSink* frames,
+                DecodeBackendRegistry* registry = &DecodeBackendRegistry::Instance(),
+                CodecCapabilityCache* codecs = &CodecCapabilityCache::Instance());
+  ~PlayerManager();
+
+  PlayerManager(const PlayerManager&) = delete;
+  PlayerManager& operator=(const PlayerManager&) = delete;
+
+  // Nothing is initialized up front: a backend's engine starts on the
+  // first Create() or WarmUp() that needs it, so host start-up (plugin
+  // registration) doesn't pay for video.
+
+  // Creates and initializes a player on |backend_name| (empty = default).
+  // Returns the player id, or -1 if the backend is unknown or its engine
+  // failed to initialize.
+  int64_t Create(const MediaSource& source, const PlayerOptions& options,
+                 const std::string& backend_name = std::string());
+
+  // Returns nullptr for unknown or disposed ids.
+  std::shared_ptr<Player> Get(int64_t player_id) const;
+
+  // Returns false for unknown ids.
+  bool Dispose(int64_t player_id);
+  void DisposeAll();
+
+  size_t size() const;
+
+  // PlatformInfo nativePlayerType: the backends live players run on
+  // ("libmpv", or "GStreamer, libmpv" when mixed), else the default one.
+  std::string NativePlayerType() const;
+
+  // Pre-flight check of a catalog item against the decoders of
+  // |backend_name| (empty = default), before a player is created for it.
+  // The first call per backend probes them (or reads the disk cache);
+  // later calls take microseconds. kUnknown if the backend can't list its
+  // decoders.
+  CodecCheck CanPlay(const VideoMetadata& metadata, const std::string& backend_name = std::string()) const;
+
+  // What a WarmUp() did and how long it took, for boot-time metrics.
+  struct WarmUpReport {
+    std::string backend;
+    bool initialized = false;
+    // Whether the backend ran a pipeline (DecodeBackend::WarmUp)
+    bool pipeline = false;
+    int64_t initialize_ms = 0;
+    // Listing the decoders; near 0 when the disk cache was current
+    int64_t probe_ms = 0;
+    int64_t pipeline_ms = 0;
+    int64_t total_ms = 0;
+  };
+
+  // Initializes |backend_name| (empty = default), lists its decoders and
+  // has it build and tear down a representative pipeline, on a background
+  // thread, so that neither the first Create() nor CanPlay() waits for
+  // the engine. Returns at once; |done| (may be null) gets the report on
+  // that thread, and total_ms is also traced as the "warm_up_ms" counter.
+  // Hosts call this at boot or when a video screen is about to open.
+  // Each backend is warmed up once: later calls get the first run's report
+  // when it is ready (at once, on the calling thread, if it already is).
+  void WarmUp(const std::string& backend_name = std::string(),
+              std::function<void(const WarmUpReport&)> done = nullptr);
+
+  // Starts watching the cgroup's memory pressure and sheds from every
+  // player while it lasts. Returns false if there is no cgroup v2 memory
+  // controller to watch. Replaces a previous monitor.
+  bool WatchMemoryPressure(MemoryPressureMonitor::Options options = MemoryPressureMonitor::Options());
+
+  // Passes a pressure report on to every player (see Player::ShedMemory).
+  void OnMemoryPressure(MemoryPressureLevel level, MemoryShedStep step);
+
+ private:
+  PlayerEventSink* const events_;
+  FrameSink* const frames_;
+  DecodeBackendRegistry* const registry_;
+  CodecCapabilityCache* const codecs_;
+
+  mutable std::mutex mutex_;
+  std::map<int64_t, std::shared_ptr<Player>> players_;
+  int64_t next_player_id_ = 0;
+
+  std::unique_ptr<MemoryPressureMonitor> memory_monitor_;
+
+  // One per backend name, under |mutex_|.
+  struct WarmUpState {
+    // Joined on destruction
+    std::thread thread;
+    bool finished = false;
+    WarmUpReport report;
+    // Callers waiting for |report|
+    std::vector<std::function<void(const WarmUpReport&)>> waiting;
+  };
+  std::map<std::string, WarmUpState> warm_ups_;
+};
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_PLAYER_MANAGER_H_
@@ -0,0 +1,52 @@
+#include "player_types.h"
+
+namespace pro_video_player {
+
+const char* PlaybackStateName(PlaybackState state) {
+  switch (state) {
+    case PlaybackState::kUninitialized:
+      return "uninitialized";
+    case PlaybackState::kInitializing:
+      return "initializing";
+    case PlaybackState::kReady:
+      return "ready";
+    case PlaybackState::kPlaying:
+      return "playing";
+    case PlaybackState::kPaused:
+      return "paused";
+    case PlaybackState::kCompleted:
+      return "completed";
+    case PlaybackState::kBuffering:
+      return "buffering";
+    case PlaybackState::kError:
+      return "error";
+    case PlaybackState::kDisposed:
+      return "disposed";
+  }
+  return "uninitialized";
+}
+
+const EventValue& PlayerEvent::Get(const std::string& key) const {
+  static const EventValue kEmpty;
+  for (const auto& field : fields) {
+    if (field.first == key) return field.second;
+  }
+  return kEmpty;
+}
+
+EventValue ToEventValue(const AudioTrack& track) {
+  EventMap map{{"id", track.id}, {"isDefault", track.is_default}};
+  if (!track.label.empty()) map.emplace_back("label", track.label);
+  if (!track.language.empty()) map.emplace_back("language", track.language);
+  if (track.channel_count > 0) map.emplace_back("channelCount", track.channel_count);
+  return map;
+}
+
+EventValue ToEventValue(const SubtitleTrack& track) {
+  EventMap map{{"id", track.id}, {"isDefault", track.is_default}};
+  if (!track.label.empty()) map.emplace_back("label", track.label);
+  if (!track.language.empty()) map.emplace_back("language", track.language);
+  return map;
+}
+
+}  // namespace pro_video_player
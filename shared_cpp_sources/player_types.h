@@ -0,0 +1,296 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_PLAYER_TYPES_H_
+#define PRO_VIDEO_PLAYER_SHARED_PLAYER_TYPES_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// Embedder-neutral mirrors of the Pigeon messages. The Windows and Linux
+// plugins convert between these and their generated/FlValue types so the
+// core never depends on a Flutter embedder.
+
+namespace pro_video_player {
+
+// Mirrors PlaybackStateEnum.
+enum class PlaybackState {
+  kUninitialized,
+  kInitializing,
+  kReady,
+  kPlaying,
+  kPaused,
+  kCompleted,
+  kBuffering,
+  kError,
+  kDisposed,
+};
+
+// Name used in "playbackStateChanged" events ("playing", "paused", ...).
+const char* PlaybackStateName(PlaybackState state);
+
+// Mirrors VideoSourceType, plus kOffline.
+enum class SourceType {
+  kNetwork,
+  kFile,
+  kAsset,
+  // A finished DownloadStore entry; |uri| is its id. Core only until the
+  // Linux host API is wired and VideoSourceType gains a counterpart.
+  kOffline,
+};
+
+// Mirrors VideoSourceMessage. |uri| is the URL, file path, resolved asset
+// path or download id depending on |type|.
+struct MediaSource {
+  SourceType type = SourceType::kNetwork;
+  std::string uri;
+  std::map<std::string, std::string> headers;
+};
+
+// Mirrors BufferingTier: how far ahead to buffer, trading memory for
+// resilience to network stalls.
+enum class BufferingTier {
+  kMin,
+  kLow,
+  kMedium,
+  kHigh,
+  kMax,
+};
+
+// Watermarks a backend buffers by. Filling stops at whichever of |max_ms|
+// and |max_bytes| is reached first.
+struct BufferLimits {
+  // Buffered ahead of the playhead below which loading resumes, and the
+  // most it is filled to.
+  int64_t min_ms = 0;
+  int64_t max_ms = 0;
+  // Buffered ahead needed to start playing, and to resume after a
+  // rebuffer.
+  int64_t start_ms = 0;
+  int64_t resume_ms = 0;
+  int64_t max_bytes = 0;
+  // Already-played data kept for seeking back.
+  int64_t back_bytes = 0;
+
+  bool operator==(const BufferLimits& other) const {
+    return min_ms == other.min_ms && max_ms == other.max_ms && start_ms == other.start_ms &&
+           resume_ms == other.resume_ms && max_bytes == other.max_bytes && back_bytes == other.back_bytes;
+  }
+  bool operator!=(const BufferLimits& other) const { return !(*this == other); }
+};
+
+// Subset of VideoPlayerOptionsMessage the engine acts on.
+struct PlayerOptions {
+  bool auto_play = false;
+  bool looping = false;
+  double volume = 1.0;
+  double playback_speed = 1.0;
+  std::optional<int64_t> start_position_ms;
+  std::string preferred_audio_language;
+  // Audio track label (HLS rendition NAME) to prefer, case-insensitive.
+  std::string preferred_audio_rendition;
+  std::string preferred_subtitle_language;
+  // Emit "audioLevelsChanged" events (VideoPlayerOptions.enableAudioLevels).
+  bool enable_audio_levels = false;
+  BufferingTier buffering_tier = BufferingTier::kMedium;
+  // Grow the buffer after rebuffers and shrink it under memory pressure
+  // (see BufferController).
+  bool dynamic_buffering = false;
+  // Live streams only: keep this far behind the live edge by nudging the
+  // playback rate (see LiveLatencyController), with a minimal buffer in
+  // place of |buffering_tier|. 0 turns the mode off.
+  int64_t target_live_latency_ms = 0;
+};
+
+// Mirrors AudioTrackMessage.
+struct AudioTrack {
+  std::string id;
+  std::string label;
+  std::string language;
+  int channel_count = 0;
+  bool is_default = false;
+
+  bool operator==(const AudioTrack& other) const {
+    return id == other.id && label == other.label && language == other.language &&
+           channel_count == other.channel_count && is_default == other.is_default;
+  }
+};
+
+// Mirrors SubtitleTrackMessage.
+struct SubtitleTrack {
+  std::string id;
+  std::string label;
+  std::string language;
+  bool is_default = false;
+
+  bool operator==(const SubtitleTrack& other) const {
+    return id == other.id && label == other.label && language == other.language &&
+           is_default == other.is_default;
+  }
+};
+
+// Mirrors VideoQualityTrackMessage. 0 and empty mean unknown.
+struct VideoQualityTrack {
+  std::string id;
+  std::string label;
+  int64_t bitrate = 0;
+  int width = 0;
+  int height = 0;
+  std::string codec;
+  bool is_default = false;
+};
+
+// Mirrors VideoMetadataMessage. 0 and empty mean unknown; codecs are
+// codec strings as in the catalog ("hvc1.2.4.L120.B0", "av01.0.08M.10",
+// "mp4a.40.2") or plain names ("hevc").
+struct VideoMetadata {
+  int64_t duration_ms = 0;
+  int width = 0;
+  int height = 0;
+  std::string video_codec;
+  std::string audio_codec;
+  int64_t bitrate = 0;
+  double frame_rate = 0;
+};
+
+// Mirrors SubtitleFormatEnum.
+enum class SubtitleFormat {
+  kSrt,
+  kVtt,
+  kSsa,
+  kAss,
+  kTtml,
+};
+
+// Mirrors SubtitleRenderModeEnum. In kFlutter mode the backend stops
+// drawing subtitles and the player emits "embeddedSubtitleCue" events.
+enum class SubtitleRenderMode {
+  kAuto,
+  kNative,
+  kFlutter,
+};
+
+// One timed subtitle, already stripped to plain text (lines joined by
+// '\n').
+struct SubtitleCue {
+  int64_t start_ms = 0;
+  int64_t end_ms = 0;
+  std::string text;
+
+  bool operator==(const SubtitleCue& other) const {
+    return start_ms == other.start_ms && end_ms == other.end_ms && text == other.text;
+  }
+};
+
+// Mirrors SubtitleSourceMessage once the plugin has loaded the file.
+struct ExternalSubtitle {
+  SubtitleFormat format = SubtitleFormat::kSrt;
+  std::string content;
+  std::string label;
+  std::string language;
+  bool is_default = false;
+};
+
+// What a backend learned while opening a source.
+struct MediaInfo {
+  int64_t duration_ms = 0;
+  int width = 0;
+  int height = 0;
+  bool is_live = false;
+  std::vector<AudioTrack> audio_tracks;
+  std::vector<SubtitleTrack> subtitle_tracks;
+  // Audio track the backend started on; empty if it can't tell.
+  std::string selected_audio_track_id;
+};
+
+enum class PixelFormat {
+  kRgba,
+  kBgra,
+  // RGBA layout with an undefined fourth byte; display as opaque.
+  kRgbx,
+};
+
+// A decoded frame ready for the texture. |data| stays valid for as long as
+// |owner| is alive, so sinks may hold on to the frame without copying.
+struct VideoFrame {
+  int width = 0;
+  int height = 0;
+  int stride = 0;
+  PixelFormat format = PixelFormat::kRgba;
+  int64_t pts_ms = 0;
+  const uint8_t* data = nullptr;
+  std::shared_ptr<const void> owner;
+};
+
+// Decoded audio handed to the analysis stage: |frames| interleaved float
+// frames of |channels| samples each, nominally in [-1, 1]. Only valid for
+// the duration of the callback.
+struct AudioSamples {
+  const float* data = nullptr;
+  size_t frames = 0;
+  int channels = 0;
+  int sample_rate = 0;
+  // Media time of the first frame.
+  int64_t pts_ms = 0;
+};
+
+// Value carried by EventChannel-style events; the plugins map it onto
+// EncodableValue / FlValue. Lists and string-keyed maps nest.
+struct EventValue;
+using EventList = std::vector<EventValue>;
+using EventMap = std::vector<std::pair<std::string, EventValue>>;
+
+struct EventValue
+    : std::variant<std::monostate, bool, int64_t, double, std::string, EventList, EventMap> {
+  using variant::variant;
+  EventValue(int value) : variant(static_cast<int64_t>(value)) {}
+  EventValue(const char* value) : variant(std::string(value)) {}
+
+  bool is_null() const { return index() == 0; }
+};
+
+// An EventChannel event: "type" plus the fields the Dart side reads
+// (e.g. {"type": "positionChanged", "position": 1200}).
+struct PlayerEvent {
+  std::string type;
+  EventMap fields;
+
+  PlayerEvent() = default;
+  explicit PlayerEvent(std::string event_type) : type(std::move(event_type)) {}
+
+  PlayerEvent& With(std::string key, EventValue value) {
+    fields.emplace_back(std::move(key), std::move(value));
+    return *this;
+  }
+
+  // Returns the field or a null value if absent.
+  const EventValue& Get(const std::string& key) const;
+};
+
+// Outcome of a control command once the player's worker has applied it.
+// The plugins turn it into the Pigeon reply (ErrorOr / FlutterError) with
+// the same codes as the mobile implementations.
+struct CommandResult {
+  // Empty on success.
+  std::string code;
+  std::string message;
+
+  bool ok() const { return code.empty(); }
+};
+
+// Called exactly once per command, on the player's worker thread (or on the
+// caller's thread if the command is rejected up front).
+using CommandCallback = std::function<void(const CommandResult&)>;
+
+// Track encodings matching what EventParser reads on the Dart side.
+EventValue ToEventValue(const AudioTrack& track);
+EventValue ToEventValue(const SubtitleTrack& track);
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_PLAYER_TYPES_H_
@@ -0,0 +1,253 @@
+#include "segment_loader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "trace_recorder.h"
+
+namespace pro_video_player {
+
+namespace {
+
+// Weight of the newest sample in the smoothed estimates.
+constexpr double kSmoothing = 0.25;
+
+// Floor on the transfer time a throughput sample is computed over, so a
+// small segment that arrives with its first byte doesn't read as infinite.
+constexpr double kMinTransferUs = 1000;
+
+double Smooth(double current, double sample) { return current + kSmoothing * (sample - current); }
+
+bool Retryable(const HttpResponse& response) { return response.status == 0 || response.status >= 500; }
+
+}  // namespace
+
+int SegmentParallelism(std::chrono::microseconds rtt, double bytes_per_second, double segment_bytes,
+                       int min_parallel, int max_parallel) {
+  const int low = std::max(min_parallel, 1);
+  const int high = std::max(max_parallel, low);
+  if (segment_bytes <= 0 || bytes_per_second <= 0) return low;
+  const double in_round_trip = static_cast<double>(rtt.count()) / 1e6 * bytes_per_second / segment_bytes;
+  const double wanted = 1 + std::ceil(std::min(in_round_trip, static_cast<double>(high)));
+  return std::clamp(static_cast<int>(wanted), low, high);
+}
+
+SegmentLoader::SegmentLoader(HttpFetcher* fetcher, MediaSource source, Options options, Sink sink)
+    : fetcher_(fetcher),
+      source_(std::move(source)),
+      options_(options),
+      sink_(std::move(sink)),
+      parallelism_(std::clamp(options.initial_parallel, std::max(options.min_parallel, 1),
+                              std::max(options.max_parallel, std::max(options.min_parallel, 1)))) {}
+
+SegmentLoader::~SegmentLoader() {
+  std::unique_lock<std::recursive_mutex> lock(mutex_);
+  stopped_ = true;
+  CancelInFlight();
+  CancelKeys();
+  idle_cv_.wait(lock, [&]() { return outstanding_ == 0; });
+}
+
+void SegmentLoader::Append(std::vector<SegmentRequest> segments) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  if (stopped_) return;
+  for (auto& segment : segments) segments_.push_back(std::move(segment));
+  FillWindow();
+}
+
+void SegmentLoader::Seek(size_t index) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  if (stopped_) return;
+  CancelInFlight();
+  completed_.clear();
+  next_ = index;
+  FillWindow();
+}
+
+void SegmentLoader::Stop() {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  stopped_ = true;
+  CancelInFlight();
+  CancelKeys();
+  completed_.clear();
+}
+
+std::shared_ptr<const Aes128> SegmentLoader::CachedKey(const std::string& uri) const {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  const auto found = keys_.find(uri);
+  return found != keys_.end() ? found->second.aes : nullptr;
+}
+
+size_t SegmentLoader::next_index() const {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  return next_;
+}
+
+SegmentLoader::Estimate SegmentLoader::estimate() const {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  Estimate estimate;
+  estimate.rtt = std::chrono::microseconds(static_cast<int64_t>(rtt_us_));
+  estimate.bytes_per_second = bytes_per_second_;
+  estimate.segment_bytes = segment_bytes_;
+  estimate.parallelism = parallelism_;
+  return estimate;
+}
+
+void SegmentLoader::FillWindow() {
+  const size_t end = std::min(segments_.size(), next_ + static_cast<size_t>(parallelism_));
+  for (size_t index = next_; index < end; ++index) {
+    if (in_flight_.count(index) == 0 && completed_.count(index) == 0) Request(index, 0);
+  }
+}
+
+void SegmentLoader::Request(size_t index, int attempts) {
+  const SegmentRequest& segment = segments_[index];
+  FetchPriority priority = FetchPriority::kPrefetch;
+  if (index == next_) {
+    priority = FetchPriority::kCurrentSegment;
+  } else if (index == next_ + 1) {
+    priority = FetchPriority::kNextSegment;
+  }
+  if (segment.key.method != HlsKeyMethod::kNone && keys_.count(segment.key.uri) == 0) RequestKey(segment.key.uri);
+  HttpRequest request = MakeHttpRequest(source_, segment.url, priority);
+  request.range_start = segment.range_start;
+  request.range_end = segment.range_end;
+
+  // The callback can't run before this returns: it needs mutex_
+  const uint64_t generation = generation_;
+  ++outstanding_;
+  InFlight& in_flight = in_flight_[index];
+  in_flight.attempts = attempts + 1;
+  in_flight.id = fetcher_->Fetch(std::move(request), [this, generation, index](const HttpResponse& response) {
+    OnResponse(generation, index, response);
+  });
+}
+
+void SegmentLoader::OnResponse(uint64_t generation, size_t index, const HttpResponse& response) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  if (!stopped_ && generation == generation_) {
+    PVP_TRACE_SCOPE("http", "SegmentLoader::OnResponse");
+    const auto found = in_flight_.find(index);
+    const int attempts = found != in_flight_.end() ? found->second.attempts : options_.max_attempts;
+    if (found != in_flight_.end()) in_flight_.erase(found);
+
+    if (response.ok()) Measure(response);
+    if (!response.ok() && Retryable(response) && attempts < options_.max_attempts) {
+      Request(index, attempts);
+    } else {
+      completed_[index] = response;
+      Deliver();
+      if (!stopped_) FillWindow();
+    }
+  }
+  if (--outstanding_ == 0) idle_cv_.notify_all();
+}
+
+void SegmentLoader::RequestKey(const std::string& uri) {
+  Key& key = keys_[uri];
+  ++key.attempts;
+  ++outstanding_;
+  // Nothing using it can be delivered before it
+  key.id = fetcher_->Fetch(MakeHttpRequest(source_, uri, FetchPriority::kCurrentSegment),
+                           [this, uri](const HttpResponse& response) { OnKey(uri, response); });
+}
+
+void SegmentLoader::OnKey(const std::string& uri, const HttpResponse& response) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  if (!stopped_) {
+    Key& key = keys_[uri];
+    key.id = 0;
+    if (response.ok() && response.body.size() == Aes128::kBlockSize) {
+      key.aes = std::make_shared<const Aes128>(response.body.data());
+      key.done = true;
+    } else if (!response.ok() && Retryable(response) && key.attempts < options_.max_attempts) {
+      RequestKey(uri);
+    } else {
+      key.error = response.ok() ? "key is " + std::to_string(response.body.size()) + " bytes"
+                                : (response.error.empty() ? "HTTP " + std::to_string(response.status) : response.error);
+      key.done = true;
+    }
+    if (key.done) {
+      Deliver();
+      if (!stopped_) FillWindow();
+    }
+  }
+  if (--outstanding_ == 0) idle_cv_.notify_all();
+}
+
+void SegmentLoader::Deliver() {
+  // The sink may Seek() or Stop(), which bumps the generation or clears
+  // completed_
+  const uint64_t delivering = generation_;
+  for (auto next = completed_.find(next_); next != completed_.end() && !stopped_ && delivering == generation_;
+       next = completed_.find(next_)) {
+    const SegmentRequest& segment = segments_[next_];
+    if (segment.key.method != HlsKeyMethod::kNone) {
+      const auto key = keys_.find(segment.key.uri);
+      if (key == keys_.end() || !key->second.done) return;
+    }
+    HttpResponse ready = std::move(next->second);
+    completed_.erase(next);
+    Decrypt(segment, &ready);
+    ++next_;
+    sink_(next_ - 1, ready);
+  }
+}
+
+void SegmentLoader::Decrypt(const SegmentRequest& segment, HttpResponse* response) const {
+  if (segment.key.method == HlsKeyMethod::kNone || !response->ok()) return;
+  const Key& key = keys_.at(segment.key.uri);
+  if (!key.aes) {
+    response->error = "key " + segment.key.uri + ": " + key.error;
+    return;
+  }
+  if (segment.key.method != HlsKeyMethod::kAes128) return;
+  PVP_TRACE_SCOPE("http", "SegmentLoader::Decrypt");
+  const int64_t size = DecryptAes128Segment(*key.aes, segment.key.iv, response->body.data(), response->body.size());
+  if (size < 0) {
+    response->error = "segment doesn't decrypt with " + segment.key.uri;
+    return;
+  }
+  response->body.resize(static_cast<size_t>(size));
+}
+
+void SegmentLoader::Measure(const HttpResponse& response) {
+  const double first_byte_us = static_cast<double>(response.time_to_first_byte.count());
+  const double transfer_us =
+      std::max(static_cast<double>(response.elapsed.count()) - first_byte_us, kMinTransferUs);
+  const double bytes = static_cast<double>(response.body.size());
+  const double throughput = bytes / (transfer_us / 1e6);
+  if (!measured_) {
+    rtt_us_ = first_byte_us;
+    bytes_per_second_ = throughput;
+    segment_bytes_ = bytes;
+    measured_ = true;
+  } else {
+    // A new connection's first byte also waited out the handshakes
+    if (!response.new_connection) rtt_us_ = Smooth(rtt_us_, first_byte_us);
+    bytes_per_second_ = Smooth(bytes_per_second_, throughput);
+    segment_bytes_ = Smooth(segment_bytes_, bytes);
+  }
+  parallelism_ = SegmentParallelism(std::chrono::microseconds(static_cast<int64_t>(rtt_us_)), bytes_per_second_,
+                                    segment_bytes_, options_.min_parallel, options_.max_parallel);
+}
+
+void SegmentLoader::CancelInFlight() {
+  ++generation_;
+  for (const auto& entry : in_flight_) {
+    if (fetcher_->Cancel(entry.second.id)) --outstanding_;
+  }
+  in_flight_.clear();
+  if (outstanding_ == 0) idle_cv_.notify_all();
+}
+
+void SegmentLoader::CancelKeys() {
+  for (auto& entry : keys_) {
+    if (entry.second.id != 0 && fetcher_->Cancel(entry.second.id)) --outstanding_;
+    entry.second.id = 0;
+  }
+  if (outstanding_ == 0) idle_cv_.notify_all();
+}
+
+}  // namespace pro_video_player
@@ -0,0 +1,164 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_SEGMENT_LOADER_H_
+#define PRO_VIDEO_PLAYER_SHARED_SEGMENT_LOADER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "aes128.h"
+#include "hls_decrypt.h"
+#include "http_fetcher.h"
+#include "player_types.h"
+
+namespace pro_video_player {
+
+// One HLS media segment or DASH segment URL, optionally a byte range of it
+// (EXT-X-BYTERANGE, SegmentBase index ranges).
+struct SegmentRequest {
+  std::string url;
+  int64_t range_start = -1;
+  int64_t range_end = -1;
+  // EXT-X-KEY in effect for the segment; |key.uri| must be absolute.
+  HlsKey key;
+};
+
+// Requests to keep in flight so the link never idles waiting for a first
+// byte: one transfer takes |rtt| + |segment_bytes| / |bytes_per_second|,
+// and the round trip is covered by rtt * bandwidth / segment_bytes more.
+// Clamped to [min_parallel, max_parallel].
+int SegmentParallelism(std::chrono::microseconds rtt, double bytes_per_second, double segment_bytes,
+                       int min_parallel, int max_parallel);
+
+// Fetches a playlist's segments ahead of playback through an HttpFetcher,
+// up to parallelism() at a time, and hands them to the sink strictly in
+// playlist order. Segments that finish early wait until everything before
+// them has been delivered, so at most parallelism() are ever held.
+//
+// The window adapts after every response: round trip from the time to
+// first byte on pooled connections, per-transfer throughput from the rest,
+// both smoothed. Parallel transfers split the link, which lowers the
+// per-transfer throughput and so stops the window from overshooting.
+//
+// Failed segments (no response or 5xx) are retried up to |max_attempts|;
+// the last failure is delivered in order like a segment, and loading moves
+// on.
+//
+// Encrypted segments: each key URI is fetched once, alongside the first
+// segment that needs it, and kept for the loader's lifetime. A segment is
+// delivered once its key is in. AES-128 segments are decrypted in place in
+// the response body, so the sink sees plaintext; a missing key or bad
+// padding turns the segment into a failure. SAMPLE-AES segments are
+// delivered as fetched, for the demuxer to decrypt per sample with
+// CachedKey().
+//
+// Thread-safe. The sink runs on the fetcher thread with the loader locked:
+// it may call back into the loader but must not block.
+class SegmentLoader {
+ public:
+  using Sink = std::function<void(size_t index, const HttpResponse& response)>;
+
+  struct Options {
+    int min_parallel = 1;
+    // More than the fetcher's per-origin limit only queues.
+    int max_parallel = 6;
+    // Used until the first response has been measured.
+    int initial_parallel = 2;
+    int max_attempts = 3;
+  };
+
+  struct Estimate {
+    std::chrono::microseconds rtt{0};
+    double bytes_per_second = 0;
+    double segment_bytes = 0;
+    int parallelism = 0;
+  };
+
+  // |fetcher| must outlive the loader. |source| supplies request headers.
+  SegmentLoader(HttpFetcher* fetcher, MediaSource source, Options options, Sink sink);
+  // Stops, then waits for a sink call in progress. Not from the sink.
+  ~SegmentLoader();
+
+  SegmentLoader(const SegmentLoader&) = delete;
+  SegmentLoader& operator=(const SegmentLoader&) = delete;
+
+  // Adds segments to the end of the playlist (live refreshes) and starts
+  // fetching if the window has room.
+  void Append(std::vector<SegmentRequest> segments);
+
+  // Drops everything in flight or waiting and continues from |index|.
+  // Nothing before it is delivered once this returns.
+  void Seek(size_t index);
+
+  // Cancels all requests; nothing is delivered afterwards.
+  void Stop();
+
+  // The key fetched from |uri|, or null if it isn't in (yet).
+  std::shared_ptr<const Aes128> CachedKey(const std::string& uri) const;
+
+  // Next index the sink will receive.
+  size_t next_index() const;
+  Estimate estimate() const;
+
+ private:
+  struct InFlight {
+    HttpFetcher::RequestId id = 0;
+    int attempts = 0;
+  };
+
+  struct Key {
+    HttpFetcher::RequestId id = 0;
+    int attempts = 0;
+    bool done = false;
+    // Null with |error| set if the key couldn't be fetched.
+    std::shared_ptr<const Aes128> aes;
+    std::string error;
+  };
+
+  void FillWindow();
+  void Request(size_t index, int attempts);
+  void RequestKey(const std::string& uri);
+  void OnResponse(uint64_t generation, size_t index, const HttpResponse& response);
+  void OnKey(const std::string& uri, const HttpResponse& response);
+  // Hands the sink the contiguous run of completed segments whose keys
+  // are in.
+  void Deliver();
+  void Decrypt(const SegmentRequest& segment, HttpResponse* response) const;
+  void Measure(const HttpResponse& response);
+  void CancelInFlight();
+  void CancelKeys();
+
+  HttpFetcher* const fetcher_;
+  const MediaSource source_;
+  const Options options_;
+  const Sink sink_;
+
+  // Held while the sink runs, hence recursive.
+  mutable std::recursive_mutex mutex_;
+  std::condition_variable_any idle_cv_;
+  bool stopped_ = false;
+  uint64_t generation_ = 0;
+  // Fetches whose callback may still run.
+  int outstanding_ = 0;
+  std::vector<SegmentRequest> segments_;
+  size_t next_ = 0;
+  std::map<size_t, InFlight> in_flight_;
+  std::map<size_t, HttpResponse> completed_;  // out of order, waiting for next_
+  std::map<std::string, Key> keys_;            // by URI
+
+  bool measured_ = false;
+  double rtt_us_ = 0;
+  double bytes_per_second_ = 0;
+  double segment_bytes_ = 0;
+  int parallelism_;
+};
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_SEGMENT_LOADER_H_
@@ -0,0 +1,162 @@
+#include "segment_timeline.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+
+namespace pro_video_player {
+
+namespace {
+
+// Arena bytes of evicted URIs tolerated before compacting.
+constexpr size_t kMinCompactBytes = 4096;
+
+std::string_view Trim(std::string_view text) {
+  while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front()))) text.remove_prefix(1);
+  while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) text.remove_suffix(1);
+  return text;
+}
+
+bool ConsumePrefix(std::string_view* line, std::string_view prefix) {
+  if (line->compare(0, prefix.size(), prefix) != 0) return false;
+  line->remove_prefix(prefix.size());
+  return true;
+}
+
+// Leading decimal number of |text| ("6.006,title" -> 6.006).
+double ParseNumber(std::string_view text) {
+  return std::strtod(std::string(text.substr(0, text.find(','))).c_str(), nullptr);
+}
+
+}  // namespace
+
+SegmentTimeline::SegmentTimeline(size_t capacity) : capacity_(std::max<size_t>(capacity, 1)) {}
+
+size_t SegmentTimeline::MergeMediaPlaylist(std::string_view playlist) {
+  uint64_t sequence = 0;
+  int64_t duration_ms = -1;
+  size_t added = 0;
+  bool first_uri = true;
+  while (!playlist.empty()) {
+    const size_t eol = playlist.find('\n');
+    std::string_view line = Trim(playlist.substr(0, eol));
+    playlist.remove_prefix(eol == std::string_view::npos ? playlist.size() : eol + 1);
+    if (line.empty()) continue;
+    if (line.front() != '#') {
+      if (first_uri) {
+        // Everything older has left the server's window
+        TrimBefore(sequence);
+        first_uri = false;
+      }
+      if (duration_ms >= 0 && Append(sequence, duration_ms, line)) ++added;
+      ++sequence;
+      duration_ms = -1;
+    } else if (ConsumePrefix(&line, "#EXTINF:")) {
+      duration_ms = std::llround(ParseNumber(line) * 1000);
+    } else if (ConsumePrefix(&line, "#EXT-X-MEDIA-SEQUENCE:")) {
+      sequence = std::strtoull(std::string(line).c_str(), nullptr, 10);
+    } else if (ConsumePrefix(&line, "#EXT-X-TARGETDURATION:")) {
+      target_duration_ms_ = std::llround(ParseNumber(line) * 1000);
+    } else if (line == "#EXT-X-ENDLIST") {
+      ended_ = true;
+    }
+  }
+  return added;
+}
+
+bool SegmentTimeline::Append(uint64_t sequence, int64_t duration_ms, std::string_view uri) {
+  if (size_ > 0 || first_sequence_ > 0) {
+    const uint64_t next = first_sequence_ + size_;
+    if (sequence < next) return false;
+    // Missed part of the window: keep the clock running, restart the
+    // sequence numbering
+    if (sequence > next) {
+      while (size_ > 0) PopFront();
+    }
+  }
+  if (size_ == 0) first_sequence_ = sequence;
+  if (size_ == capacity_) PopFront();
+
+  const Entry entry{next_start_ms_, arena_base_ + arena_.size(), static_cast<int32_t>(duration_ms),
+                    static_cast<uint32_t>(uri.size())};
+  if (size_ < ring_.size()) {
+    ring_[(head_ + size_) % ring_.size()] = entry;
+  } else {
+    // Growing: unwrap so that the new slot is at the end
+    std::rotate(ring_.begin(), ring_.begin() + static_cast<std::ptrdiff_t>(head_), ring_.end());
+    head_ = 0;
+    ring_.push_back(entry);
+  }
+  ++size_;
+  arena_.append(uri.data(), uri.size());
+  next_start_ms_ += duration_ms;
+  return true;
+}
+
+void SegmentTimeline::TrimBefore(uint64_t sequence) {
+  while (size_ > 0 && first_sequence_ < sequence) PopFront();
+}
+
+void SegmentTimeline::Clear() {
+  ring_.clear();
+  head_ = 0;
+  size_ = 0;
+  first_sequence_ = 0;
+  next_start_ms_ = 0;
+  arena_.clear();
+  arena_base_ = 0;
+  ended_ = false;
+  target_duration_ms_ = 0;
+}
+
+std::optional<TimelineSegment> SegmentTimeline::Find(int64_t position_ms) const {
+  if (size_ == 0 || position_ms < start_ms() || position_ms > end_ms()) return std::nullopt;
+  size_t low = 0;
+  size_t high = size_;
+  // First entry starting after |position_ms|; the one before contains it
+  while (low < high) {
+    const size_t mid = low + (high - low) / 2;
+    if (EntryAt(mid).start_ms <= position_ms) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return At(low - 1);
+}
+
+TimelineSegment SegmentTimeline::At(size_t index) const {
+  const Entry& entry = EntryAt(index);
+  TimelineSegment segment;
+  segment.sequence = first_sequence_ + index;
+  segment.start_ms = entry.start_ms;
+  segment.duration_ms = entry.duration_ms;
+  segment.uri = arena_.substr(static_cast<size_t>(entry.uri_offset - arena_base_), entry.uri_length);
+  return segment;
+}
+
+int64_t SegmentTimeline::start_ms() const { return size_ == 0 ? 0 : EntryAt(0).start_ms; }
+
+int64_t SegmentTimeline::end_ms() const { return size_ == 0 ? 0 : next_start_ms_; }
+
+size_t SegmentTimeline::memory_bytes() const {
+  return ring_.capacity() * sizeof(Entry) + arena_.capacity();
+}
+
+void SegmentTimeline::PopFront() {
+  head_ = (head_ + 1) % ring_.size();
+  --size_;
+  ++first_sequence_;
+  CompactArena();
+}
+
+void SegmentTimeline::CompactArena() {
+  const uint64_t live_from = size_ == 0 ? arena_base_ + arena_.size() : EntryAt(0).uri_offset;
+  const size_t dead = static_cast<size_t>(live_from - arena_base_);
+  if (dead < kMinCompactBytes || dead < arena_.size() / 2) return;
+  arena_.erase(0, dead);
+  arena_base_ += dead;
+}
+
+}  // namespace pro_video_player
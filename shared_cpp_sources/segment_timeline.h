@@ -0,0 +1,108 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_SEGMENT_TIMELINE_H_
+#define PRO_VIDEO_PLAYER_SHARED_SEGMENT_TIMELINE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pro_video_player {
+
+// One media segment of a live timeline.
+struct TimelineSegment {
+  // HLS media sequence number.
+  uint64_t sequence = 0;
+  // Start on the stream's timeline: 0 is the first segment the timeline
+  // ever saw, which stays put while the window slides.
+  int64_t start_ms = 0;
+  int64_t duration_ms = 0;
+  // As written in the playlist, usually relative to it.
+  std::string uri;
+
+  int64_t end_ms() const { return start_ms + duration_ms; }
+};
+
+// The segments of a live stream's DVR window, built up from playlist
+// refreshes, for seeking without downloading the playlist again.
+//
+// Segments live in a ring of 24-byte entries; URIs share one string
+// arena that is compacted as the window slides. A six-hour window of 2 s
+// segments (10800 entries) with relative URIs stays under a megabyte,
+// where the playlist text alone is about as big and a parsed copy of it
+// several times that. Only contiguous sequence
+// numbers are kept: a refresh that skips ahead (the player was away
+// longer than the window) starts a new timeline at the old end time.
+//
+// Not thread-safe.
+class SegmentTimeline {
+ public:
+  // About nine hours of 2 s segments.
+  static constexpr size_t kDefaultCapacity = 16384;
+
+  explicit SegmentTimeline(size_t capacity = kDefaultCapacity);
+
+  // Merges one HLS media playlist (a live refresh or the first load):
+  // appends segments past the newest one known and drops those that fell
+  // out of the playlist window. The text isn't kept. Returns the number of
+  // segments added.
+  size_t MergeMediaPlaylist(std::string_view playlist);
+
+  // Appends segment |sequence|; anything not newer than the last one is
+  // ignored. Evicts the oldest segment when full.
+  bool Append(uint64_t sequence, int64_t duration_ms, std::string_view uri);
+
+  // Drops segments before |sequence|.
+  void TrimBefore(uint64_t sequence);
+  void Clear();
+
+  // Segment containing |position_ms|, by binary search; nullopt outside
+  // [start_ms(), end_ms()). The live edge itself maps to the last segment.
+  std::optional<TimelineSegment> Find(int64_t position_ms) const;
+  // |index| counts from the oldest segment.
+  TimelineSegment At(size_t index) const;
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+  // The seekable window; both 0 when empty.
+  int64_t start_ms() const;
+  int64_t end_ms() const;
+  // Set by EXT-X-ENDLIST: the stream is over and the window stops moving.
+  bool ended() const { return ended_; }
+  // EXT-X-TARGETDURATION, 0 until seen; the playlist refresh interval.
+  int64_t target_duration_ms() const { return target_duration_ms_; }
+  // Heap held by entries and URIs.
+  size_t memory_bytes() const;
+
+ private:
+  struct Entry {
+    int64_t start_ms;
+    // Absolute offset into the arena; see |arena_base_|.
+    uint64_t uri_offset;
+    int32_t duration_ms;
+    uint32_t uri_length;
+  };
+
+  const Entry& EntryAt(size_t index) const { return ring_[(head_ + index) % ring_.size()]; }
+  void PopFront();
+  void CompactArena();
+
+  const size_t capacity_;
+  // Grows up to |capacity_|, then wraps.
+  std::vector<Entry> ring_;
+  size_t head_ = 0;
+  size_t size_ = 0;
+  uint64_t first_sequence_ = 0;
+  // Where the next segment starts.
+  int64_t next_start_ms_ = 0;
+  // URIs back to back; |arena_base_| is the absolute offset of arena_[0].
+  std::string arena_;
+  uint64_t arena_base_ = 0;
+  bool ended_ = false;
+  int64_t target_duration_ms_ = 0;
+};
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_SEGMENT_TIMELINE_H_
@@ -0,0 +1,58 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_SIMD_FLOAT4_H_
+#define PRO_VIDEO_PLAYER_SHARED_SIMD_FLOAT4_H_
+
+// Four-lane float helpers for the audio DSP loops, over the baseline
+// instruction set of each architecture (SSE2 on x86-64, NEON on ARM64) so
+// no runtime dispatch is needed. PVP_SIMD_FLOAT4 is left undefined on
+// other targets; callers keep a scalar path for that case.
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PVP_SIMD_FLOAT4 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define PVP_SIMD_FLOAT4 1
+#endif
+
+#if defined(PVP_SIMD_FLOAT4)
+
+namespace pro_video_player {
+namespace simd {
+
+inline constexpr int kLanes = 4;
+
+#if defined(__ARM_NEON) && !defined(__SSE2__)
+using Vec = float32x4_t;
+inline Vec Zero() { return vdupq_n_f32(0.0f); }
+inline Vec Load(const float* p) { return vld1q_f32(p); }
+inline void Store(float* p, Vec v) { vst1q_f32(p, v); }
+inline Vec Abs(Vec v) { return vabsq_f32(v); }
+inline Vec Max(Vec a, Vec b) { return vmaxq_f32(a, b); }
+inline Vec Add(Vec a, Vec b) { return vaddq_f32(a, b); }
+inline Vec MulAdd(Vec acc, Vec a, Vec b) { return vmlaq_f32(acc, a, b); }
+inline float Sum(Vec v) {
+  const float32x2_t pair = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+  return vget_lane_f32(vpadd_f32(pair, pair), 0);
+}
+#else
+using Vec = __m128;
+inline Vec Zero() { return _mm_setzero_ps(); }
+inline Vec Load(const float* p) { return _mm_loadu_ps(p); }
+inline void Store(float* p, Vec v) { _mm_storeu_ps(p, v); }
+inline Vec Abs(Vec v) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), v); }
+inline Vec Max(Vec a, Vec b) { return _mm_max_ps(a, b); }
+inline Vec Add(Vec a, Vec b) { return _mm_add_ps(a, b); }
+inline Vec MulAdd(Vec acc, Vec a, Vec b) { return _mm_add_ps(acc, _mm_mul_ps(a, b)); }
+inline float Sum(Vec v) {
+  const __m128 high = _mm_movehl_ps(v, v);
+  const __m128 pair = _mm_add_ps(v, high);
+  return _mm_cvtss_f32(_mm_add_ss(pair, _mm_shuffle_ps(pair, pair, 1)));
+}
+#endif
+
+}  // namespace simd
+}  // namespace pro_video_player
+
+#endif  // PVP_SIMD_FLOAT4
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_SIMD_FLOAT4_H_
@@ -0,0 +1,251 @@
+#include "subtitle_cues.h"
+
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+namespace pro_video_player {
+
+namespace {
+
+bool CueLess(const SubtitleCue& a, const SubtitleCue& b) {
+  if (a.start_ms != b.start_ms) return a.start_ms < b.start_ms;
+  if (a.end_ms != b.end_ms) return a.end_ms < b.end_ms;
+  return a.text < b.text;
+}
+
+std::string Trim(const std::string& text) {
+  size_t begin = 0;
+  size_t end = text.size();
+  while (begin < end && std::isspace(static_cast<unsigned char>(text[begin]))) ++begin;
+  while (end > begin && std::isspace(static_cast<unsigned char>(text[end - 1]))) --end;
+  return text.substr(begin, end - begin);
+}
+
+// "01:02:03,456", "01:02:03.456" or (WebVTT) "02:03.456"; -1 if malformed.
+int64_t ParseTimestamp(const std::string& text) {
+  int64_t fields[3] = {0, 0, 0};
+  int count = 0;
+  size_t i = 0;
+  while (true) {
+    if (count == 3 || i >= text.size() || !std::isdigit(static_cast<unsigned char>(text[i]))) return -1;
+    int64_t value = 0;
+    while (i < text.size() && std::isdigit(static_cast<unsigned char>(text[i]))) {
+      value = value * 10 + (text[i++] - '0');
+    }
+    fields[count++] = value;
+    if (i < text.size() && text[i] == ':') {
+      ++i;
+      continue;
+    }
+    break;
+  }
+  if (count < 2) return -1;
+  int64_t millis = 0;
+  if (i < text.size() && (text[i] == ',' || text[i] == '.')) {
+    ++i;
+    int digits = 0;
+    while (i < text.size() && std::isdigit(static_cast<unsigned char>(text[i]))) {
+      if (digits < 3) millis = millis * 10 + (text[i] - '0');
+      ++digits;
+      ++i;
+    }
+    if (digits == 0) return -1;
+    for (; digits < 3; ++digits) millis *= 10;
+  }
+  if (i != text.size()) return -1;
+  const int64_t hours = count == 3 ? fields[0] : 0;
+  const int64_t minutes = fields[count - 2];
+  const int64_t seconds = fields[count - 1];
+  if (minutes >= 60 || seconds >= 60) return -1;
+  return ((hours * 60 + minutes) * 60 + seconds) * 1000 + millis;
+}
+
+// "start --> end[ settings]" into |cue|'s times.
+bool ParseTiming(const std::string& line, SubtitleCue* cue) {
+  const size_t arrow = line.find("-->");
+  if (arrow == std::string::npos) return false;
+  const std::string start = Trim(line.substr(0, arrow));
+  std::string end = Trim(line.substr(arrow + 3));
+  // WebVTT cue settings ("align:start line:0") follow the end time
+  const size_t space = end.find_first_of(" \t");
+  if (space != std::string::npos) end.resize(space);
+  cue->start_ms = ParseTimestamp(start);
+  cue->end_ms = ParseTimestamp(end);
+  return cue->start_ms >= 0 && cue->end_ms > cue->start_ms;
+}
+
+// Drops <i>/<b>/<c.cls>/<v Speaker> tags and {\an8}-style overrides, and
+// decodes the entities WebVTT requires.
+std::string StripMarkup(const std::string& line) {
+  std::string out;
+  out.reserve(line.size());
+  for (size_t i = 0; i < line.size(); ++i) {
+    const char c = line[i];
+    if (c == '<' || (c == '{' && i + 1 < line.size() && line[i + 1] == '\\')) {
+      const size_t close = line.find(c == '<' ? '>' : '}', i);
+      if (close != std::string::npos) {
+        i = close;
+        continue;
+      }
+    }
+    if (c == '&') {
+      static const std::pair<const char*, char> kEntities[] = {
+          {"&amp;", '&'}, {"&lt;", '<'}, {"&gt;", '>'}, {"&nbsp;", ' '}, {"&lrm;", '\0'}, {"&rlm;", '\0'}};
+      bool decoded = false;
+      for (const auto& entity : kEntities) {
+        const std::string name = entity.first;
+        if (line.compare(i, name.size(), name) == 0) {
+          if (entity.second != '\0') out.push_back(entity.second);
+          i += name.size() - 1;
+          decoded = true;
+          break;
+        }
+      }
+      if (decoded) continue;
+    }
+    out.push_back(c);
+  }
+  return out;
+}
+
+}  // namespace
+
+// ==================== SubtitleCueStore ====================
+
+bool SubtitleCueStore::Add(const std::string& track_id, const SubtitleCue& cue) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return AddLocked(tracks_[track_id], cue);
+}
+
+bool SubtitleCueStore::Add(const std::string& track_id, const std::vector<SubtitleCue>& cues) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Track& track = tracks_[track_id];
+  bool added = false;
+  for (const auto& cue : cues) added = AddLocked(track, cue) || added;
+  return added;
+}
+
+bool SubtitleCueStore::AddLocked(Track& track, const SubtitleCue& cue) {
+  if (cue.end_ms <= cue.start_ms || cue.text.empty()) return false;
+  // Demuxers mostly deliver in order, so this is usually an append
+  const auto it = std::lower_bound(track.cues.begin(), track.cues.end(), cue, CueLess);
+  if (it != track.cues.end() && *it == cue) return false;
+  track.cues.insert(it, cue);
+  track.longest_ms = std::max(track.longest_ms, cue.end_ms - cue.start_ms);
+  return true;
+}
+
+std::optional<SubtitleCue> SubtitleCueStore::ActiveAt(const std::string& track_id,
+                                                      int64_t position_ms) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto found = tracks_.find(track_id);
+  if (found == tracks_.end()) return std::nullopt;
+  const Track& track = found->second;
+  auto it = std::upper_bound(track.cues.begin(), track.cues.end(), position_ms,
+                             [](int64_t position, const SubtitleCue& cue) { return position < cue.start_ms; });
+  // Nothing starting before |position_ms - longest_ms| can still be showing
+  std::vector<const SubtitleCue*> active;
+  while (it != track.cues.begin()) {
+    --it;
+    if (it->start_ms < position_ms - track.longest_ms) break;
+    if (it->end_ms > position_ms) active.push_back(&*it);
+  }
+  if (active.empty()) return std::nullopt;
+  SubtitleCue merged;
+  merged.start_ms = active.front()->start_ms;
+  merged.end_ms = active.front()->end_ms;
+  for (auto cue = active.rbegin(); cue != active.rend(); ++cue) {
+    if (!merged.text.empty()) merged.text += '\n';
+    merged.text += (*cue)->text;
+    merged.start_ms = std::max(merged.start_ms, (*cue)->start_ms);
+    merged.end_ms = std::min(merged.end_ms, (*cue)->end_ms);
+  }
+  return merged;
+}
+
+int64_t SubtitleCueStore::NextChangeAfter(const std::string& track_id, int64_t position_ms) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto found = tracks_.find(track_id);
+  if (found == tracks_.end()) return -1;
+  const Track& track = found->second;
+  auto it = std::upper_bound(track.cues.begin(), track.cues.end(), position_ms,
+                             [](int64_t position, const SubtitleCue& cue) { return position < cue.start_ms; });
+  int64_t next = it != track.cues.end() ? it->start_ms : -1;
+  while (it != track.cues.begin()) {
+    --it;
+    if (it->start_ms < position_ms - track.longest_ms) break;
+    if (it->end_ms > position_ms && (next < 0 || it->end_ms < next)) next = it->end_ms;
+  }
+  return next;
+}
+
+size_t SubtitleCueStore::CueCount(const std::string& track_id) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto found = tracks_.find(track_id);
+  return found == tracks_.end() ? 0 : found->second.cues.size();
+}
+
+size_t SubtitleCueStore::TrimOutside(const std::string& track_id, int64_t from_ms, int64_t to_ms) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto found = tracks_.find(track_id);
+  if (found == tracks_.end()) return 0;
+  std::vector<SubtitleCue>& cues = found->second.cues;
+  const size_t before = cues.size();
+  cues.erase(std::remove_if(cues.begin(), cues.end(),
+                            [&](const SubtitleCue& cue) { return cue.end_ms < from_ms || cue.start_ms > to_ms; }),
+             cues.end());
+  // longest_ms may now overstate, which only lengthens the ActiveAt scan
+  return before - cues.size();
+}
+
+void SubtitleCueStore::RemoveTrack(const std::string& track_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  tracks_.erase(track_id);
+}
+
+void SubtitleCueStore::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  tracks_.clear();
+}
+
+// ==================== Parsing ====================
+
+bool ParseSubtitles(SubtitleFormat format, const std::string& content, std::vector<SubtitleCue>* cues) {
+  if (format != SubtitleFormat::kSrt && format != SubtitleFormat::kVtt) return false;
+  std::string text = content;
+  if (text.compare(0, 3, "\xEF\xBB\xBF") == 0) text.erase(0, 3);
+  text.erase(std::remove(text.begin(), text.end(), '\r'), text.end());
+
+  // Both formats are blank-line separated blocks: an optional identifier
+  // (SRT counter, VTT cue id), the timing line, then the text. VTT header,
+  // NOTE, STYLE and REGION blocks have no timing line and fall through.
+  const size_t before = cues->size();
+  std::istringstream stream(text);
+  std::string line;
+  SubtitleCue cue;
+  bool in_cue = false;
+  auto finish = [&]() {
+    if (in_cue && !cue.text.empty()) cues->push_back(cue);
+    in_cue = false;
+    cue = SubtitleCue();
+  };
+  while (std::getline(stream, line)) {
+    if (Trim(line).empty()) {
+      finish();
+      continue;
+    }
+    if (!in_cue) {
+      in_cue = ParseTiming(line, &cue);
+      continue;
+    }
+    const std::string stripped = Trim(StripMarkup(line));
+    if (stripped.empty()) continue;
+    if (!cue.text.empty()) cue.text += '\n';
+    cue.text += stripped;
+  }
+  finish();
+  return cues->size() > before;
+}
+
+}  // namespace pro_video_player
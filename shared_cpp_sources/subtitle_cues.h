@@ -0,0 +1,61 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_SUBTITLE_CUES_H_
+#define PRO_VIDEO_PLAYER_SHARED_SUBTITLE_CUES_H_
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "player_types.h"
+
+namespace pro_video_player {
+
+// Timed cues per subtitle track, whichever way they arrived: pushed by the
+// backend as its demuxer reaches them (mov_text, SubRip in MKV, WebVTT in
+// HLS) or parsed in one go from an external file. Thread-safe.
+class SubtitleCueStore {
+ public:
+  // Cues may arrive in any order and more than once (the demuxer re-reads
+  // after a seek); exact duplicates are dropped. Returns true if anything
+  // was new.
+  bool Add(const std::string& track_id, const SubtitleCue& cue);
+  bool Add(const std::string& track_id, const std::vector<SubtitleCue>& cues);
+
+  // Everything showing at |position_ms| on |track_id|, merged into one cue:
+  // overlapping texts are joined in start order and the span is where all
+  // of them are visible. O(log n) plus the number of overlapping cues.
+  std::optional<SubtitleCue> ActiveAt(const std::string& track_id, int64_t position_ms) const;
+
+  // First cue start or end after |position_ms|, i.e. when ActiveAt() can
+  // next change; -1 if the track has nothing further.
+  int64_t NextChangeAfter(const std::string& track_id, int64_t position_ms) const;
+
+  size_t CueCount(const std::string& track_id) const;
+  // Drops cues of |track_id| that end before |from_ms| or start after
+  // |to_ms|. Returns how many were dropped.
+  size_t TrimOutside(const std::string& track_id, int64_t from_ms, int64_t to_ms);
+  void RemoveTrack(const std::string& track_id);
+  void Clear();
+
+ private:
+  struct Track {
+    std::vector<SubtitleCue> cues;  // sorted by (start, end, text)
+    int64_t longest_ms = 0;         // bounds the backward scan in ActiveAt
+  };
+
+  bool AddLocked(Track& track, const SubtitleCue& cue);
+
+  mutable std::mutex mutex_;
+  std::map<std::string, Track> tracks_;
+};
+
+// Parses an external SubRip or WebVTT file. Cue markup (<i>, {\an8}, VTT
+// voice spans) is stripped. False for other formats or if no cue could be
+// read.
+bool ParseSubtitles(SubtitleFormat format, const std::string& content, std::vector<SubtitleCue>* cues);
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_SUBTITLE_CUES_H_
@@ -0,0 +1,64 @@
+#include "aes128.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace pro_video_player {
+namespace {
+
+std::vector<uint8_t> FromHex(const std::string& hex) {
+  std::vector<uint8_t> bytes;
+  for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+    bytes.push_back(static_cast<uint8_t>(std::stoi(hex.substr(i, 2), nullptr, 16)));
+  }
+  return bytes;
+}
+
+TEST(Aes128Test, DecryptsTheFips197Example) {
+  const auto key = FromHex("000102030405060708090a0b0c0d0e0f");
+  auto block = FromHex("69c4e0d86a7b0430d8cdb78070b4c55a");
+  // A zero IV makes one CBC block a plain block decryption
+  uint8_t iv[16] = {};
+  Aes128(key.data()).DecryptCbc(block.data(), block.size(), iv);
+  EXPECT_EQ(block, FromHex("00112233445566778899aabbccddeeff"));
+}
+
+// NIST SP 800-38A, F.2.2 CBC-AES128.Decrypt
+TEST(Aes128Test, DecryptsCbcChains) {
+  const Aes128 aes(FromHex("2b7e151628aed2a6abf7158809cf4f3c").data());
+  const auto ciphertext = FromHex(
+      "7649abac8119b246cee98e9b12e9197d5086cb9b507219ee95db113a917678b2"
+      "73bed6b8e3c1743b7116e69e222295163ff1caa1681fac09120eca307586e1a7");
+  const auto plaintext = FromHex(
+      "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+      "30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710");
+  const auto iv = FromHex("000102030405060708090a0b0c0d0e0f");
+
+  auto whole = ciphertext;
+  uint8_t chain[16];
+  std::memcpy(chain, iv.data(), 16);
+  aes.DecryptCbc(whole.data(), whole.size(), chain);
+  EXPECT_EQ(whole, plaintext) << Aes128::Implementation();
+  // The IV ends on the last ciphertext block
+  EXPECT_EQ(std::vector<uint8_t>(chain, chain + 16), std::vector<uint8_t>(ciphertext.end() - 16, ciphertext.end()));
+
+  // Block by block through the carried IV
+  auto pieces = ciphertext;
+  std::memcpy(chain, iv.data(), 16);
+  for (size_t offset = 0; offset < pieces.size(); offset += 16) aes.DecryptCbc(pieces.data() + offset, 16, chain);
+  EXPECT_EQ(pieces, plaintext);
+}
+
+TEST(Aes128Test, LeavesATrailingPartialBlockAlone) {
+  const auto key = FromHex("000102030405060708090a0b0c0d0e0f");
+  auto data = FromHex("69c4e0d86a7b0430d8cdb78070b4c55a0102030405");
+  uint8_t iv[16] = {};
+  Aes128(key.data()).DecryptCbc(data.data(), data.size(), iv);
+  EXPECT_EQ(data, FromHex("00112233445566778899aabbccddeeff0102030405"));
+}
+
+}  // namespace
+}  // namespace pro_video_player
@@ -0,0 +1,94 @@
+#include "audio_levels.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+namespace pro_video_player {
+namespace {
+
+std::vector<float> Noise(size_t count, unsigned seed) {
+  std::vector<float> samples(count);
+  unsigned state = seed;
+  for (auto& sample : samples) {
+    state = state * 1664525u + 1013904223u;
+    sample = static_cast<float>(state >> 8) / static_cast<float>(1u << 24) * 2.0f - 1.0f;
+  }
+  return samples;
+}
+
+TEST(AudioLevelsTest, MatchesScalarReferenceForEveryLayout) {
+  for (int channels = 1; channels <= kMaxMeteredChannels; ++channels) {
+    // Odd frame count exercises the scalar tail after the vector blocks
+    const size_t frames = 1237;
+    const auto samples = Noise(frames * channels, 17u + channels);
+    std::vector<float> peak(channels, 0.0f);
+    std::vector<double> sum_squares(channels, 0.0);
+    AccumulateLevels(samples.data(), frames, channels, peak.data(), sum_squares.data());
+
+    for (int channel = 0; channel < channels; ++channel) {
+      float expected_peak = 0.0f;
+      double expected_sum = 0.0;
+      for (size_t frame = 0; frame < frames; ++frame) {
+        const float value = samples[frame * channels + channel];
+        expected_peak = std::max(expected_peak, std::fabs(value));
+        expected_sum += static_cast<double>(value) * value;
+      }
+      EXPECT_FLOAT_EQ(peak[channel], expected_peak) << channels << " channels, #" << channel;
+      EXPECT_NEAR(sum_squares[channel], expected_sum, expected_sum * 1e-5)
+          << channels << " channels, #" << channel;
+    }
+  }
+}
+
+TEST(AudioLevelsTest, PeakAbsFindsNegativePeaks) {
+  std::vector<float> samples(101, 0.25f);
+  samples[77] = -0.9f;
+  EXPECT_FLOAT_EQ(PeakAbs(samples.data(), samples.size()), 0.9f);
+  EXPECT_FLOAT_EQ(PeakAbs(samples.data(), 3), 0.25f);
+  EXPECT_FLOAT_EQ(PeakAbs(nullptr, 10), 0.0f);
+}
+
+TEST(AudioLevelsTest, MeterReportsPeakAndRmsPerChannel) {
+  // Left: full-scale square wave, right: silence
+  std::vector<float> samples;
+  for (int i = 0; i < 480; ++i) {
+    samples.push_back(i % 2 == 0 ? 1.0f : -1.0f);
+    samples.push_back(0.0f);
+  }
+  AudioSamples input;
+  input.data = samples.data();
+  input.frames = 480;
+  input.channels = 2;
+  input.sample_rate = 48000;
+
+  AudioLevelMeter meter;
+  meter.Add(input);
+  EXPECT_EQ(meter.frames(), 480u);
+  const AudioLevels levels = meter.TakeLevels();
+  ASSERT_EQ(levels.peak.size(), 2u);
+  EXPECT_FLOAT_EQ(levels.peak[0], 1.0f);
+  EXPECT_FLOAT_EQ(levels.rms[0], 1.0f);
+  EXPECT_FLOAT_EQ(levels.peak[1], 0.0f);
+  EXPECT_FLOAT_EQ(levels.rms[1], 0.0f);
+
+  // Window restarts after TakeLevels
+  EXPECT_EQ(meter.frames(), 0u);
+  EXPECT_FLOAT_EQ(meter.TakeLevels().peak[0], 0.0f);
+}
+
+TEST(AudioLevelsTest, MeterIgnoresUnsupportedLayouts) {
+  std::vector<float> samples(12 * 10, 1.0f);
+  AudioSamples input;
+  input.data = samples.data();
+  input.frames = 10;
+  input.channels = 12;
+  input.sample_rate = 48000;
+  AudioLevelMeter meter;
+  meter.Add(input);
+  EXPECT_EQ(meter.frames(), 0u);
+}
+
+}  // namespace
+}  // namespace pro_video_player
@@ -0,0 +1,95 @@
+#include "buffer_controller.h"
+
+#include <gtest/gtest.h>
+
+namespace pro_video_player {
+namespace {
+
+using Transition = BufferController::Transition;
+
+TEST(BufferControllerTest, TiersGrowMonotonically) {
+  const BufferingTier tiers[] = {BufferingTier::kMin, BufferingTier::kLow, BufferingTier::kMedium,
+                                 BufferingTier::kHigh, BufferingTier::kMax};
+  for (size_t i = 0; i < 5; ++i) {
+    const BufferLimits limits = BufferLimitsForTier(tiers[i]);
+    EXPECT_LE(limits.start_ms, limits.resume_ms);
+    EXPECT_LE(limits.resume_ms, limits.min_ms);
+    EXPECT_LT(limits.min_ms, limits.max_ms);
+    if (i == 0) continue;
+    const BufferLimits lower = BufferLimitsForTier(tiers[i - 1]);
+    EXPECT_GE(limits.max_ms, lower.max_ms);
+    EXPECT_GT(limits.max_bytes, lower.max_bytes);
+    EXPECT_GT(limits.back_bytes, lower.back_bytes);
+  }
+  EXPECT_EQ(BufferLimitsForTier(BufferingTier::kMedium).max_ms, 15000);
+  EXPECT_EQ(BufferController().limits(), BufferLimitsForTier(BufferingTier::kMedium));
+}
+
+TEST(BufferControllerTest, OnlyUnderrunsStartBuffering) {
+  BufferController controller(BufferingTier::kMedium, false);
+  // A stall with 8 s buffered is a decoder restart, not an underrun
+  EXPECT_EQ(controller.OnStallChanged(true, 8000, false, true), Transition::kNone);
+  EXPECT_EQ(controller.OnStallChanged(false, 8000, false, true), Transition::kNone);
+  EXPECT_EQ(controller.OnStallChanged(true, 40000, true, true), Transition::kNone);
+
+  EXPECT_EQ(controller.OnStallChanged(true, 300, false, true), Transition::kStarted);
+  EXPECT_TRUE(controller.buffering());
+  EXPECT_EQ(controller.OnStallChanged(true, 0, false, true), Transition::kNone);
+  EXPECT_EQ(controller.OnStallChanged(false, 5000, false, true), Transition::kEnded);
+  // Unknown buffer level counts as empty
+  EXPECT_EQ(controller.OnStallChanged(true, -1, false, false), Transition::kStarted);
+  EXPECT_EQ(controller.rebuffer_count(), 1);
+}
+
+TEST(BufferControllerTest, DynamicModeGrowsOnRebuffersAndShrinksUnderPressure) {
+  BufferController controller(BufferingTier::kMedium, true);
+  const BufferLimits medium = BufferLimitsForTier(BufferingTier::kMedium);
+
+  // Refilling after a seek is expected
+  controller.OnSeek();
+  controller.OnStallChanged(true, -1, false, true);
+  controller.OnStallChanged(false, 5000, false, true);
+  EXPECT_EQ(controller.limits(), medium);
+
+  controller.OnStallChanged(true, 0, false, true);
+  controller.OnStallChanged(false, 7500, false, true);
+  EXPECT_EQ(controller.limits().max_ms, 22500);
+  EXPECT_EQ(controller.limits().resume_ms, 7500);
+  EXPECT_EQ(controller.limits().back_bytes, medium.back_bytes);
+  for (int i = 0; i < 10; ++i) {
+    controller.OnStallChanged(true, 0, false, true);
+    controller.OnStallChanged(false, 0, false, true);
+  }
+  EXPECT_EQ(controller.limits().max_ms, BufferLimitsForTier(BufferingTier::kMax).max_ms);
+
+  for (int i = 0; i < 10; ++i) controller.OnMemoryPressure();
+  EXPECT_EQ(controller.limits().max_ms, BufferLimitsForTier(BufferingTier::kMin).max_ms);
+  EXPECT_LT(controller.limits().back_bytes, medium.back_bytes);
+
+  // Dynamic mode earns its buffer back through rebuffers
+  controller.OnMemoryRelief();
+  EXPECT_EQ(controller.limits().max_ms, BufferLimitsForTier(BufferingTier::kMin).max_ms);
+}
+
+TEST(BufferControllerTest, FixedTierShrinksOnlyWhilePressureLasts) {
+  BufferController controller(BufferingTier::kMedium, false);
+  controller.OnStallChanged(true, 0, false, true);
+  controller.OnStallChanged(false, 0, false, true);
+  EXPECT_EQ(controller.limits().max_ms, 15000);
+  controller.OnMemoryPressure();
+  EXPECT_EQ(controller.limits().max_ms, 7500);
+  controller.OnMemoryRelief();
+  EXPECT_EQ(controller.limits(), BufferLimitsForTier(BufferingTier::kMedium));
+}
+
+TEST(BufferControllerTest, IdlePlayersKeepNoBackBuffer) {
+  BufferController controller(BufferingTier::kHigh, false);
+  controller.SetIdle(true);
+  EXPECT_EQ(controller.limits().back_bytes, 0);
+  EXPECT_EQ(controller.limits().max_ms, 30000);
+  controller.SetIdle(false);
+  EXPECT_EQ(controller.limits(), BufferLimitsForTier(BufferingTier::kHigh));
+}
+
+}  // namespace
+}  // namespace pro_video_player
@@ -0,0 +1,220 @@
+#include "codec_capabilities.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace pro_video_player {
+namespace {
+
+DecoderInfo Decoder(const std::string& codec, const std::string& name, std::vector<int> profiles = {},
+                    int max_level = 0, int max_bit_depth = 0) {
+  DecoderInfo decoder;
+  decoder.codec = codec;
+  decoder.name = name;
+  decoder.profiles = std::move(profiles);
+  decoder.max_level = max_level;
+  decoder.max_bit_depth = max_bit_depth;
+  return decoder;
+}
+
+// Software FFmpeg without dav1d: no AV1, HEVC without range extensions.
+CodecCapabilities Matrix() {
+  return CodecCapabilities({Decoder("h264", "h264", {}, 0, 14), Decoder("hevc", "hevc", {1, 2, 3}, 0, 10),
+                            Decoder("vp9", "vp9", {0, 2}, 41, 10), Decoder("aac", "aac"), Decoder("opus", "opus")});
+}
+
+TEST(CodecCapabilitiesTest, ParsesCodecStrings) {
+  CodecString parsed;
+  ASSERT_TRUE(ParseCodecString("avc1.640028", &parsed));
+  EXPECT_EQ(parsed.codec, "h264");
+  EXPECT_EQ(parsed.profile, 100);
+  EXPECT_EQ(parsed.level, 40);
+
+  ASSERT_TRUE(ParseCodecString("hvc1.2.4.L120.B0", &parsed));
+  EXPECT_EQ(parsed.codec, "hevc");
+  EXPECT_EQ(parsed.profile, 2);
+  EXPECT_EQ(parsed.level, 120);
+  EXPECT_EQ(parsed.bit_depth, 10);
+  ASSERT_TRUE(ParseCodecString("hev1.A4.10.H153.90", &parsed));
+  EXPECT_EQ(parsed.profile, 4);
+  EXPECT_EQ(parsed.level, 153);
+
+  ASSERT_TRUE(ParseCodecString("av01.0.08M.10", &parsed));
+  EXPECT_EQ(parsed.codec, "av1");
+  EXPECT_EQ(parsed.profile, 0);
+  EXPECT_EQ(parsed.level, 8);
+  EXPECT_EQ(parsed.bit_depth, 10);
+
+  ASSERT_TRUE(ParseCodecString("vp09.02.10.10.01.09.16.09.01", &parsed));
+  EXPECT_EQ(parsed.codec, "vp9");
+  EXPECT_EQ(parsed.profile, 2);
+  EXPECT_EQ(parsed.level, 10);
+
+  ASSERT_TRUE(ParseCodecString("mp4a.40.2", &parsed));
+  EXPECT_EQ(parsed.codec, "aac");
+  ASSERT_TRUE(ParseCodecString("mp4a.40.34", &parsed));
+  EXPECT_EQ(parsed.codec, "mp3");
+  ASSERT_TRUE(ParseCodecString("mp4a.a6", &parsed));
+  EXPECT_EQ(parsed.codec, "eac3");
+
+  ASSERT_TRUE(ParseCodecString(" H.265 ", &parsed));
+  EXPECT_EQ(parsed.codec, "hevc");
+  EXPECT_EQ(parsed.profile, -1);
+  ASSERT_TRUE(ParseCodecString("Opus", &parsed));
+  EXPECT_EQ(parsed.codec, "opus");
+
+  EXPECT_FALSE(ParseCodecString("avc1.64", &parsed));
+  EXPECT_FALSE(ParseCodecString("hvc1.2.4.X120", &parsed));
+  EXPECT_FALSE(ParseCodecString("dvh1.05.06", &parsed));
+  EXPECT_FALSE(ParseCodecString("", &parsed));
+}
+
+TEST(CodecCapabilitiesTest, ChecksProfilesLevelsAndBitDepths) {
+  const CodecCapabilities matrix = Matrix();
+  EXPECT_EQ(matrix.Check("avc1.640028").support, CodecSupport::kSupported);
+  EXPECT_EQ(matrix.Check("hvc1.2.4.L153.B0").support, CodecSupport::kSupported);
+  EXPECT_EQ(matrix.Check("hevc").support, CodecSupport::kSupported);
+
+  CodecCheck check = matrix.Check("av01.0.08M.10");
+  EXPECT_EQ(check.support, CodecSupport::kUnsupported);
+  EXPECT_EQ(check.reason, "No decoder for av1");
+  check = matrix.Check("hvc1.4.10.L120.90");
+  EXPECT_EQ(check.support, CodecSupport::kUnsupported);
+  EXPECT_EQ(check.reason, "hevc can't decode hevc profile 4");
+  check = matrix.Check("vp09.02.51.10");
+  EXPECT_EQ(check.support, CodecSupport::kUnsupported);
+  EXPECT_EQ(check.reason, "vp9 can't decode vp9 level 51");
+  check = matrix.Check("vp09.02.10.12");
+  EXPECT_EQ(check.support, CodecSupport::kUnsupported);
+  EXPECT_EQ(check.reason, "vp9 can't decode 12-bit vp9");
+  EXPECT_EQ(matrix.Check("vp09.01.10.08").support, CodecSupport::kUnsupported);
+
+  check = matrix.Check("dvh1.05.06");
+  EXPECT_EQ(check.support, CodecSupport::kUnknown);
+  EXPECT_EQ(check.reason, "Unknown codec dvh1.05.06");
+}
+
+TEST(CodecCapabilitiesTest, LaterDecodersAreTried) {
+  DecoderInfo hardware = Decoder("hevc", "hevc_v4l2m2m", {1});
+  hardware.hardware = true;
+  const CodecCapabilities matrix({hardware, Decoder("hevc", "hevc", {1, 2})});
+  EXPECT_EQ(matrix.Check("hvc1.2.4.L120.B0").support, CodecSupport::kSupported);
+}
+
+TEST(CodecCapabilitiesTest, CanPlayChecksBothStreams) {
+  const CodecCapabilities matrix = Matrix();
+  VideoMetadata metadata;
+  EXPECT_EQ(matrix.CanPlay(metadata).support, CodecSupport::kSupported);
+  metadata.video_codec = "hvc1.2.4.L120.B0";
+  metadata.audio_codec = "mp4a.40.2";
+  EXPECT_EQ(matrix.CanPlay(metadata).support, CodecSupport::kSupported);
+  metadata.audio_codec = "ac-3";
+  EXPECT_EQ(matrix.CanPlay(metadata).reason, "No decoder for ac3");
+  metadata.audio_codec = "mystery";
+  EXPECT_EQ(matrix.CanPlay(metadata).support, CodecSupport::kUnknown);
+  // Unsupported wins over unknown
+  metadata.video_codec = "av01.0.08M.10";
+  EXPECT_EQ(matrix.CanPlay(metadata).support, CodecSupport::kUnsupported);
+}
+
+TEST(CodecCapabilitiesTest, SerializeRoundTrips) {
+  DecoderInfo hardware = Decoder("h264", "h264_v4l2m2m");
+  hardware.hardware = true;
+  const CodecCapabilities matrix({hardware, Decoder("vp9", "vp9", {0, 2}, 41, 10)});
+  std::vector<DecoderInfo> decoders;
+  ASSERT_TRUE(CodecCapabilities::Parse(matrix.Serialize(), &decoders));
+  EXPECT_EQ(decoders, matrix.decoders());
+  EXPECT_FALSE(CodecCapabilities::Parse("h264\th264\t1\n", &decoders));
+  EXPECT_FALSE(CodecCapabilities::Parse("h264\th264\t2\t\t0\t0\n", &decoders));
+}
+
+class CodecCapabilityCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char path[] = "/tmp/pvp-codecs-XXXXXX";
+    ASSERT_NE(mkdtemp(path), nullptr);
+    directory_ = path;
+  }
+
+  void TearDown() override { std::filesystem::remove_all(directory_); }
+
+  DecoderProbe Probe() {
+    DecoderProbe probe;
+    probe.version = [this]() { return version_; };
+    probe.enumerate = [this](std::vector<DecoderInfo>* decoders) {
+      ++probes_;
+      *decoders = Matrix().decoders();
+      return true;
+    };
+    return probe;
+  }
+
+  std::string directory_;
+  std::string version_ = "libavcodec 61.3.100";
+  int probes_ = 0;
+};
+
+TEST_F(CodecCapabilityCacheTest, ProbesOncePerVersion) {
+  {
+    CodecCapabilityCache cache(directory_);
+    const auto first = cache.Get("mpv", Probe());
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(first->decoders(), Matrix().decoders());
+    EXPECT_EQ(cache.Get("mpv", Probe()), first);
+  }
+  // Another run reads the file
+  CodecCapabilityCache cache(directory_);
+  const auto loaded = cache.Get("mpv", Probe());
+  ASSERT_NE(loaded, nullptr);
+  EXPECT_EQ(loaded->decoders(), Matrix().decoders());
+  EXPECT_EQ(probes_, 1);
+
+  // A library upgrade doesn't
+  version_ = "libavcodec 62.0.100";
+  cache.Clear();
+  ASSERT_NE(cache.Get("mpv", Probe()), nullptr);
+  EXPECT_EQ(probes_, 2);
+  CodecCapabilityCache other(directory_);
+  ASSERT_NE(other.Get("mpv", Probe()), nullptr);
+  EXPECT_EQ(probes_, 2);
+}
+
+TEST_F(CodecCapabilityCacheTest, CorruptFileIsReprobed) {
+  {
+    CodecCapabilityCache cache(directory_);
+    ASSERT_NE(cache.Get("mpv", Probe()), nullptr);
+  }
+  const std::string path = directory_ + "/mpv.tsv";
+  std::string contents;
+  {
+    std::ifstream file(path);
+    std::getline(file, contents);
+  }
+  std::ofstream(path) << contents << "\nh264\th264\tyes\n";
+  CodecCapabilityCache cache(directory_);
+  const auto reprobed = cache.Get("mpv", Probe());
+  ASSERT_NE(reprobed, nullptr);
+  EXPECT_EQ(reprobed->decoders(), Matrix().decoders());
+  EXPECT_EQ(probes_, 2);
+}
+
+TEST_F(CodecCapabilityCacheTest, MemoryOnlyAndFailures) {
+  CodecCapabilityCache cache("");
+  ASSERT_NE(cache.Get("mpv", Probe()), nullptr);
+  EXPECT_TRUE(std::filesystem::is_empty(directory_));
+
+  EXPECT_EQ(cache.Get("gstreamer", DecoderProbe()), nullptr);
+  DecoderProbe failing;
+  failing.enumerate = [](std::vector<DecoderInfo>*) { return false; };
+  EXPECT_EQ(cache.Get("gstreamer", failing), nullptr);
+  // Not remembered; a later probe may work
+  EXPECT_NE(cache.Get("gstreamer", Probe()), nullptr);
+}
+
+}  // namespace
+}  // namespace pro_video_player
@@ -0,0 +1,135 @@
+#include "command_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "recording_event_sink.h"
+
+namespace pro_video_player {
+namespace {
+
+using ::pro_video_player::testing::WaitUntil;
+
+TEST(CommandQueueTest, RunsCommandsInOrderOnWorker) {
+  CommandQueue queue;
+  queue.Start("test");
+  std::vector<int> order;
+  std::atomic<bool> on_worker{true};
+  for (int i = 0; i < 100; ++i) {
+    queue.Post([&, i]() {
+      order.push_back(i);
+      if (!queue.IsWorkerThread()) on_worker = false;
+    });
+  }
+  queue.Stop();
+  ASSERT_EQ(order.size(), 100u);
+  for (int i = 0; i < 100; ++i) EXPECT_EQ(order[i], i);
+  EXPECT_TRUE(on_worker);
+  EXPECT_FALSE(queue.IsWorkerThread());
+}
+
+TEST(CommandQueueTest, StopDrainsPendingCommandsAndRejectsNewOnes) {
+  CommandQueue queue;
+  queue.Start("test");
+  std::atomic<int> ran{0};
+  for (int i = 0; i < 10; ++i) queue.Post([&]() { ++ran; });
+  queue.Stop();
+  EXPECT_EQ(ran.load(), 10);
+  EXPECT_FALSE(queue.Post([&]() { ++ran; }));
+  EXPECT_EQ(ran.load(), 10);
+}
+
+TEST(CommandQueueTest, AcceptsCommandsFromManyThreads) {
+  CommandQueue queue;
+  queue.Start("test");
+  std::atomic<int> ran{0};
+  std::vector<std::thread> producers;
+  for (int t = 0; t < 4; ++t) {
+    producers.emplace_back([&]() {
+      for (int i = 0; i < 250; ++i) queue.Post([&]() { ++ran; });
+    });
+  }
+  for (auto& producer : producers) producer.join();
+  queue.Stop();
+  EXPECT_EQ(ran.load(), 1000);
+}
+
+TEST(CommandQueueTest, CoalescesSameKeyWithinBatchAndKeepsOrder) {
+  CommandQueue queue;
+  queue.Start("test");
+  std::mutex gate;
+  std::vector<std::string> order;
+  {
+    // Everything below lands in one batch behind the blocked command
+    std::unique_lock<std::mutex> hold(gate);
+    queue.Post([&]() { std::lock_guard<std::mutex> wait(gate); });
+    queue.PostCoalesced(1, [&]() { order.push_back("volume 1"); },
+                        [&]() { order.push_back("superseded 1"); });
+    queue.Post([&]() { order.push_back("play"); });
+    queue.PostCoalesced(2, [&]() { order.push_back("speed"); });
+    queue.PostCoalesced(1, [&]() { order.push_back("volume 2"); },
+                        [&]() { order.push_back("superseded 2"); });
+    queue.PostCoalesced(1, [&]() { order.push_back("volume 3"); });
+  }
+  queue.Stop();
+  EXPECT_EQ(order, (std::vector<std::string>{"superseded 1", "play", "speed", "superseded 2",
+                                             "volume 3"}));
+  EXPECT_EQ(queue.coalesced_count(), 2u);
+}
+
+TEST(CommandQueueTest, CoalescingDoesNotReachAcrossBatches) {
+  CommandQueue queue;
+  queue.Start("test");
+  std::atomic<int> ran{0};
+  queue.PostCoalesced(1, [&]() { ++ran; });
+  ASSERT_TRUE(WaitUntil([&]() { return ran.load() == 1; }));
+  queue.PostCoalesced(1, [&]() { ++ran; });
+  queue.Stop();
+  EXPECT_EQ(ran.load(), 2);
+  EXPECT_EQ(queue.coalesced_count(), 0u);
+}
+
+TEST(CommandQueueTest, ConcurrentProducersRacingStopNeverLoseAcceptedCommands) {
+  for (int round = 0; round < 20; ++round) {
+    CommandQueue queue;
+    queue.Start("test");
+    std::atomic<int> accepted{0};
+    std::atomic<int> ran{0};
+    std::vector<std::thread> producers;
+    for (int t = 0; t < 4; ++t) {
+      producers.emplace_back([&]() {
+        for (int i = 0; i < 200; ++i) {
+          if (queue.Post([&]() { ++ran; })) ++accepted;
+        }
+      });
+    }
+    queue.Stop();
+    for (auto& producer : producers) producer.join();
+    EXPECT_EQ(ran.load(), accepted.load());
+  }
+}
+
+TEST(CommandQueueTest, TimerRepeatsUntilItAsksToSleep) {
+  CommandQueue queue;
+  std::atomic<int> ticks{0};
+  queue.Start("test", [&]() {
+    const int tick = ++ticks;
+    return tick < 3 ? std::chrono::milliseconds(1) : std::chrono::milliseconds(-1);
+  });
+  ASSERT_TRUE(WaitUntil([&]() { return ticks.load() >= 3; }));
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(ticks.load(), 3);
+
+  // WakeTimer re-evaluates a sleeping timer
+  queue.WakeTimer();
+  ASSERT_TRUE(WaitUntil([&]() { return ticks.load() >= 4; }));
+  queue.Stop();
+}
+
+}  // namespace
+}  // namespace pro_video_player
@@ -0,0 +1,403 @@
+#include "download_manager.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "local_http_server.h"
+#include "recording_event_sink.h"
+
+namespace pro_video_player {
+namespace {
+
+using ::pro_video_player::testing::LocalHttpServer;
+using ::pro_video_player::testing::WaitUntil;
+
+std::string Pattern(size_t size) {
+  std::string bytes(size, '\0');
+  for (size_t i = 0; i < size; ++i) bytes[i] = static_cast<char>((i * 31 + i / 7) & 0xff);
+  return bytes;
+}
+
+std::string ReadFile(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file), {});
+}
+
+// Serves |files| by path, with byte ranges, failing the first |failures|
+// requests for a path with 503.
+class MediaServer {
+ public:
+  explicit MediaServer(std::map<std::string, std::string> files, std::map<std::string, int> failures = {})
+      : files_(std::move(files)),
+        failures_(std::move(failures)),
+        server_([this](const LocalHttpServer::Request& request) {
+          LocalHttpServer::Response response;
+          {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (failures_[request.path] > 0) {
+              --failures_[request.path];
+              response.status = 503;
+              return response;
+            }
+          }
+          const auto file = files_.find(request.path);
+          if (file == files_.end()) {
+            response.status = 404;
+            return response;
+          }
+          const std::string& body = file->second;
+          const auto range = request.headers.find("range");
+          if (range == request.headers.end()) {
+            response.body = body;
+            return response;
+          }
+          // "bytes=first-last"
+          const size_t first = std::strtoull(range->second.c_str() + 6, nullptr, 10);
+          const size_t dash = range->second.find('-');
+          const size_t last = std::min<size_t>(std::strtoull(range->second.c_str() + dash + 1, nullptr, 10),
+                                               body.size() - 1);
+          response.status = 206;
+          response.body = body.substr(first, last - first + 1);
+          response.headers["Content-Range"] =
+              "bytes " + std::to_string(first) + "-" + std::to_string(last) + "/" + std::to_string(body.size());
+          return response;
+        }) {}
+
+  std::string url(const std::string& path) const { return server_.url(path); }
+
+  // Requests for |path| so far.
+  int Count(const std::string& path) const {
+    const auto requests = server_.requests();
+    return static_cast<int>(std::count_if(requests.begin(), requests.end(),
+                                          [&](const LocalHttpServer::Request& r) { return r.path == path; }));
+  }
+
+ private:
+  const std::map<std::string, std::string> files_;
+  std::mutex mutex_;
+  std::map<std::string, int> failures_;
+  LocalHttpServer server_;
+};
+
+class DownloadManagerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char path[] = "/tmp/pvp-downloads-XXXXXX";
+    ASSERT_NE(mkdtemp(path), nullptr);
+    directory_ = path;
+    store_ = std::make_unique<DownloadStore>(directory_);
+  }
+
+  void TearDown() override { std::filesystem::remove_all(directory_); }
+
+  std::unique_ptr<DownloadManager> MakeManager(DownloadManager::Options options) {
+    return std::make_unique<DownloadManager>(&fetcher_, store_.get(), options, [this](const DownloadStatus& status) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      statuses_.push_back(status);
+    });
+  }
+
+  MediaSource Network(const std::string& url) {
+    MediaSource source;
+    source.type = SourceType::kNetwork;
+    source.uri = url;
+    return source;
+  }
+
+  // Waits for |id| to complete or fail; its last status.
+  DownloadStatus WaitForEnd(const std::string& id) {
+    DownloadStatus last;
+    WaitUntil([&]() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (const auto& status : statuses_) {
+        if (status.id != id) continue;
+        last = status;
+      }
+      return last.state == DownloadState::kCompleted || last.state == DownloadState::kFailed;
+    });
+    return last;
+  }
+
+  std::string directory_;
+  std::unique_ptr<DownloadStore> store_;
+  HttpFetcher fetcher_;
+  std::mutex mutex_;
+  std::vector<DownloadStatus> statuses_;
+};
+
+TEST(HlsPlanningTest, ResolvesUrls) {
+  const std::string base = "https://cdn.example/show/hls/master.m3u8?token=1";
+  EXPECT_EQ(ResolveUrl(base, "720p/index.m3u8"), "https://cdn.example/show/hls/720p/index.m3u8");
+  EXPECT_EQ(ResolveUrl(base, "/keys/k1"), "https://cdn.example/keys/k1");
+  EXPECT_EQ(ResolveUrl(base, "//other.example/a.ts"), "https://other.example/a.ts");
+  EXPECT_EQ(ResolveUrl(base, "http://other.example/a.ts"), "http://other.example/a.ts");
+  EXPECT_EQ(ResolveUrl("https://cdn.example", "a.ts"), "https://cdn.example/a.ts");
+}
+
+TEST(HlsPlanningTest, SelectsTheVariantClosestToTheTrack) {
+  const std::string master =
+      "#EXTM3U\n"
+      "#EXT-X-MEDIA:TYPE=AUDIO,GROUP-ID=\"aac\",NAME=\"en\",DEFAULT=YES,URI=\"audio/en.m3u8\"\n"
+      "#EXT-X-MEDIA:TYPE=SUBTITLES,GROUP-ID=\"subs\",NAME=\"en\",URI=\"subs/en.m3u8\"\n"
+      "#EXT-X-STREAM-INF:BANDWIDTH=800000,RESOLUTION=640x360,CODECS=\"avc1.4d401e,mp4a.40.2\",AUDIO=\"aac\"\n"
+      "360p.m3u8\n"
+      "#EXT-X-STREAM-INF:BANDWIDTH=2500000,RESOLUTION=1280x720,AUDIO=\"aac\"\n"
+      "720p.m3u8\n"
+      "#EXT-X-STREAM-INF:BANDWIDTH=5000000,RESOLUTION=1920x1080,AUDIO=\"aac\"\n"
+      "1080p.m3u8\n";
+  std::vector<HlsVariant> variants;
+  std::vector<HlsAudioRendition> audio;
+  ASSERT_TRUE(ParseHlsMasterPlaylist(master, "https://cdn.example/hls/master.m3u8", &variants, &audio));
+  ASSERT_EQ(variants.size(), 3u);
+  EXPECT_EQ(variants[0].uri, "https://cdn.example/hls/360p.m3u8");
+  EXPECT_EQ(variants[0].width, 640);
+  EXPECT_EQ(variants[0].height, 360);
+  EXPECT_EQ(variants[0].codecs, "avc1.4d401e,mp4a.40.2");
+  EXPECT_EQ(variants[0].audio_group, "aac");
+  ASSERT_EQ(audio.size(), 1u);
+  EXPECT_EQ(audio[0].uri, "https://cdn.example/hls/audio/en.m3u8");
+  EXPECT_TRUE(audio[0].is_default);
+
+  EXPECT_EQ(SelectHlsVariant(variants, std::nullopt), 2u);
+  VideoQualityTrack track;
+  track.height = 720;
+  EXPECT_EQ(SelectHlsVariant(variants, track), 1u);
+  track = VideoQualityTrack();
+  track.bitrate = 900000;
+  EXPECT_EQ(SelectHlsVariant(variants, track), 0u);
+
+  EXPECT_FALSE(ParseHlsMasterPlaylist("#EXTM3U\n#EXTINF:4,\na.ts\n", "https://cdn.example/a.m3u8", &variants, &audio));
+}
+
+TEST(HlsPlanningTest, PlansSegmentsKeysAndByteRanges) {
+  const std::string playlist =
+      "#EXTM3U\n"
+      "#EXT-X-TARGETDURATION:4\n"
+      "#EXT-X-MAP:URI=\"init.mp4\",BYTERANGE=\"700@0\"\n"
+      "#EXT-X-KEY:METHOD=AES-128,URI=\"https://keys.example/k1\"\n"
+      "#EXTINF:4,\n"
+      "#EXT-X-BYTERANGE:1000@700\n"
+      "main.mp4\n"
+      "#EXTINF:4,\n"
+      "#EXT-X-BYTERANGE:1200\n"
+      "main.mp4\n"
+      "#EXT-X-KEY:METHOD=AES-128,URI=\"https://keys.example/k1\",IV=0x000102030405060708090a0b0c0d0e0f\n"
+      "#EXTINF:4,\n"
+      "tail.m4s?v=2\n"
+      "#EXT-X-ENDLIST\n";
+  std::vector<DownloadPart> parts;
+  std::string local;
+  std::string error;
+  ASSERT_TRUE(PlanHlsMediaPlaylist(playlist, "https://cdn.example/v/index.m3u8", "video/", &parts, &local, &error))
+      << error;
+  const std::vector<DownloadPart> expected = {
+      {"https://cdn.example/v/init.mp4", 0, 699, "video/init0.mp4", 0},
+      {"https://keys.example/k1", -1, -1, "video/key0.key", 0},
+      {"https://cdn.example/v/main.mp4", 700, 1699, "video/seg0.mp4", 0},
+      {"https://cdn.example/v/main.mp4", 1700, 2899, "video/seg1.mp4", 0},
+      {"https://cdn.example/v/tail.m4s?v=2", -1, -1, "video/seg2.m4s", 0},
+  };
+  EXPECT_EQ(parts, expected);
+  EXPECT_EQ(local,
+            "#EXTM3U\n"
+            "#EXT-X-TARGETDURATION:4\n"
+            "#EXT-X-MAP:URI=\"init0.mp4\"\n"
+            "#EXT-X-KEY:METHOD=AES-128,URI=\"key0.key\"\n"
+            "#EXTINF:4,\n"
+            "seg0.mp4\n"
+            "#EXTINF:4,\n"
+            "seg1.mp4\n"
+            "#EXT-X-KEY:METHOD=AES-128,URI=\"key0.key\",IV=0x000102030405060708090a0b0c0d0e0f\n"
+            "#EXTINF:4,\n"
+            "seg2.m4s\n"
+            "#EXT-X-ENDLIST\n");
+
+  // Live and DRM playlists can't be kept
+  parts.clear();
+  EXPECT_FALSE(PlanHlsMediaPlaylist("#EXTM3U\n#EXTINF:4,\na.ts\n", "https://cdn.example/live.m3u8", "", &parts,
+                                    &local, &error));
+  EXPECT_NE(error.find("Live"), std::string::npos);
+  EXPECT_FALSE(PlanHlsMediaPlaylist(
+      "#EXTM3U\n#EXT-X-KEY:METHOD=SAMPLE-AES,URI=\"skd://k\",KEYFORMAT=\"com.apple.streamingkeydelivery\"\n"
+      "#EXTINF:4,\na.ts\n#EXT-X-ENDLIST\n",
+      "https://cdn.example/drm.m3u8", "", &parts, &local, &error));
+}
+
+TEST_F(DownloadManagerTest, DownloadsProgressiveFilesInRanges) {
+  const std::string file = Pattern(10000);
+  MediaServer server({{"/clip.mp4", file}});
+  DownloadManager::Options options;
+  options.chunk_bytes = 4096;
+  options.max_parallel = 2;
+  auto manager = MakeManager(options);
+
+  ASSERT_TRUE(manager->Start("clip", Network(server.url("/clip.mp4"))));
+  EXPECT_FALSE(manager->Start("clip", Network(server.url("/clip.mp4"))));
+  EXPECT_FALSE(manager->Start("../clip", Network(server.url("/clip.mp4"))));
+  const DownloadStatus status = WaitForEnd("clip");
+  ASSERT_EQ(status.state, DownloadState::kCompleted) << status.error;
+  EXPECT_EQ(status.parts_total, 3u);
+  EXPECT_EQ(status.parts_done, 3u);
+  EXPECT_EQ(status.bytes_done, 10000);
+  // The first chunk came with the source probe
+  EXPECT_EQ(server.Count("/clip.mp4"), 3);
+
+  MediaSource local;
+  std::string error;
+  ASSERT_TRUE(store_->Resolve("clip", &local, &error)) << error;
+  EXPECT_EQ(local.uri, directory_ + "/clip/media.mp4");
+  EXPECT_EQ(ReadFile(local.uri), file);
+  EXPECT_TRUE(store_->Verify("clip", &error)) << error;
+
+  EXPECT_TRUE(manager->Remove("clip"));
+  EXPECT_FALSE(std::filesystem::exists(directory_ + "/clip"));
+  EXPECT_FALSE(manager->Status("clip").has_value());
+}
+
+TEST_F(DownloadManagerTest, DownloadsOneHlsVariantWithItsAudioAndKeys) {
+  const std::string key = "0123456789abcdef";
+  const std::string video0 = Pattern(3000);
+  const std::string video1 = Pattern(2000);
+  const std::string audio0 = Pattern(500);
+  MediaServer server(
+      {
+          {"/hls/master.m3u8",
+           "#EXTM3U\n"
+           "#EXT-X-MEDIA:TYPE=AUDIO,GROUP-ID=\"aac\",NAME=\"en\",DEFAULT=YES,URI=\"audio.m3u8\"\n"
+           "#EXT-X-STREAM-INF:BANDWIDTH=800000,RESOLUTION=640x360,AUDIO=\"aac\"\n"
+           "360p.m3u8\n"
+           "#EXT-X-STREAM-INF:BANDWIDTH=2500000,RESOLUTION=1280x720,CODECS=\"avc1.64001f\",AUDIO=\"aac\"\n"
+           "720p.m3u8\n"},
+          {"/hls/720p.m3u8",
+           "#EXTM3U\n"
+           "#EXT-X-KEY:METHOD=AES-128,URI=\"/keys/k1\"\n"
+           "#EXTINF:4,\nv0.ts\n#EXTINF:4,\nv1.ts\n#EXT-X-ENDLIST\n"},
+          {"/hls/audio.m3u8", "#EXTM3U\n#EXTINF:8,\na0.aac\n#EXT-X-ENDLIST\n"},
+          {"/keys/k1", key},
+          {"/hls/v0.ts", video0},
+          {"/hls/v1.ts", video1},
+          {"/hls/a0.aac", audio0},
+      },
+      // Server errors are retried
+      {{"/hls/v1.ts", 1}});
+  auto manager = MakeManager(DownloadManager::Options());
+  VideoQualityTrack track;
+  track.height = 720;
+
+  ASSERT_TRUE(manager->Start("show", Network(server.url("/hls/master.m3u8")), track));
+  const DownloadStatus status = WaitForEnd("show");
+  ASSERT_EQ(status.state, DownloadState::kCompleted) << status.error;
+  EXPECT_EQ(status.parts_total, 4u);
+  EXPECT_EQ(server.Count("/hls/360p.m3u8"), 0);
+  EXPECT_EQ(server.Count("/hls/v1.ts"), 2);
+
+  const std::string root = directory_ + "/show/";
+  EXPECT_EQ(ReadFile(root + "video/key0.key"), key);
+  EXPECT_EQ(ReadFile(root + "video/seg0.ts"), video0);
+  EXPECT_EQ(ReadFile(root + "video/seg1.ts"), video1);
+  EXPECT_EQ(ReadFile(root + "audio/seg0.aac"), audio0);
+  EXPECT_EQ(ReadFile(root + "video/index.m3u8"),
+            "#EXTM3U\n#EXT-X-KEY:METHOD=AES-128,URI=\"key0.key\"\n"
+            "#EXTINF:4,\nseg0.ts\n#EXTINF:4,\nseg1.ts\n#EXT-X-ENDLIST\n");
+  const std::string master = ReadFile(root + "index.m3u8");
+  EXPECT_NE(master.find("URI=\"audio/index.m3u8\""), std::string::npos);
+  EXPECT_NE(master.find("RESOLUTION=1280x720,CODECS=\"avc1.64001f\""), std::string::npos);
+  EXPECT_NE(master.find("\nvideo/index.m3u8\n"), std::string::npos);
+
+  MediaSource local;
+  std::string error;
+  ASSERT_TRUE(store_->Resolve("show", &local, &error)) << error;
+  EXPECT_EQ(local.uri, root + "index.m3u8");
+}
+
+TEST_F(DownloadManagerTest, RefusesLiveStreams) {
+  const std::string playlist = "#EXTM3U\n#EXT-X-TARGETDURATION:4\n#EXTINF:4,\na.ts\n";
+  MediaServer server({{"/live.m3u8", playlist}});
+  auto manager = MakeManager(DownloadManager::Options());
+  ASSERT_TRUE(manager->Start("live", Network(server.url("/live.m3u8"))));
+  const DownloadStatus status = WaitForEnd("live");
+  EXPECT_EQ(status.state, DownloadState::kFailed);
+  EXPECT_NE(status.error.find("Live"), std::string::npos);
+  MediaSource local;
+  std::string error;
+  EXPECT_FALSE(store_->Resolve("live", &local, &error));
+}
+
+TEST_F(DownloadManagerTest, ResumesAfterACrashRefetchingDamagedParts) {
+  const std::string file = Pattern(10000);
+  MediaServer server({{"/clip.mp4", file}});
+  DownloadManager::Options options;
+  options.chunk_bytes = 2500;
+  {
+    auto manager = MakeManager(options);
+    ASSERT_TRUE(manager->Start("clip", Network(server.url("/clip.mp4"))));
+    ASSERT_EQ(WaitForEnd("clip").state, DownloadState::kCompleted);
+  }
+  EXPECT_EQ(server.Count("/clip.mp4"), 4);
+
+  // As if the process died after journaling parts 0 to 2, with part 1's
+  // bytes never reaching the disk
+  const std::string root = directory_ + "/clip/";
+  std::string journal;
+  {
+    std::ifstream original(root + "journal");
+    std::string line;
+    while (std::getline(original, line)) {
+      if (line[0] >= '0' && line[0] <= '2') journal += line + '\n';
+    }
+  }
+  std::ofstream(root + "journal", std::ios::trunc) << journal;
+  {
+    std::fstream media(root + "media.mp4", std::ios::in | std::ios::out | std::ios::binary);
+    media.seekp(3000);
+    media.write("\0\0\0\0", 4);
+  }
+  MediaSource local;
+  std::string error;
+  EXPECT_FALSE(store_->Resolve("clip", &local, &error));
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    statuses_.clear();
+  }
+  auto manager = MakeManager(options);
+  manager->ResumeAll();
+  const DownloadStatus status = WaitForEnd("clip");
+  ASSERT_EQ(status.state, DownloadState::kCompleted) << status.error;
+  // Parts 1 and 3 only
+  EXPECT_EQ(server.Count("/clip.mp4"), 6);
+  ASSERT_TRUE(store_->Resolve("clip", &local, &error)) << error;
+  EXPECT_EQ(ReadFile(local.uri), file);
+  EXPECT_TRUE(store_->Verify("clip", &error)) << error;
+}
+
+TEST_F(DownloadManagerTest, RunsDownloadsOneAtATimeAndPauses) {
+  MediaServer server({{"/a.mp4", Pattern(3000)}, {"/b.mp4", Pattern(4000)}});
+  auto manager = MakeManager(DownloadManager::Options());
+  ASSERT_TRUE(manager->Start("a", Network(server.url("/a.mp4"))));
+  ASSERT_TRUE(manager->Start("b", Network(server.url("/b.mp4"))));
+  // b waits for a
+  EXPECT_EQ(manager->Status("b")->state, DownloadState::kQueued);
+  EXPECT_TRUE(manager->Pause("b"));
+  EXPECT_EQ(WaitForEnd("a").state, DownloadState::kCompleted);
+  EXPECT_EQ(manager->Status("b")->state, DownloadState::kPaused);
+  EXPECT_EQ(server.Count("/b.mp4"), 0);
+
+  ASSERT_TRUE(manager->Resume("b"));
+  EXPECT_EQ(WaitForEnd("b").state, DownloadState::kCompleted);
+  const auto list = manager->List();
+  ASSERT_EQ(list.size(), 2u);
+  EXPECT_EQ(list[0].id, "a");
+  EXPECT_EQ(list[1].id, "b");
+}
+
+}  // namespace
+}  // namespace pro_video_player
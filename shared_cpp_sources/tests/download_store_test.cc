@@ -0,0 +1,159 @@
+#include "download_store.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace pro_video_player {
+namespace {
+
+class DownloadStoreTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char path[] = "/tmp/pvp-download-store-XXXXXX";
+    ASSERT_NE(mkdtemp(path), nullptr);
+    directory_ = path;
+  }
+
+  void TearDown() override { std::filesystem::remove_all(directory_); }
+
+  bool Write(DownloadStore* store, const std::string& id, size_t index, const DownloadPart& part,
+             const std::string& bytes) {
+    const auto* data = reinterpret_cast<const uint8_t*>(bytes.data());
+    return store->WritePart(id, part, data, bytes.size()) &&
+           store->AppendJournal(id, index, {static_cast<int64_t>(bytes.size()), Crc32(data, bytes.size())});
+  }
+
+  std::string directory_;
+};
+
+TEST(Crc32Test, MatchesTheCheckValue) {
+  const std::string check = "123456789";
+  const auto* data = reinterpret_cast<const uint8_t*>(check.data());
+  EXPECT_EQ(Crc32(data, check.size()), 0xcbf43926u);
+  // Continues across calls
+  EXPECT_EQ(Crc32(data + 4, 5, Crc32(data, 4)), 0xcbf43926u);
+  EXPECT_EQ(Crc32(data, 0), 0u);
+}
+
+TEST(DownloadStoreIdTest, KeepsIdsInsideTheStore) {
+  EXPECT_TRUE(DownloadStore::ValidId("movie-1080p_v2.final"));
+  EXPECT_FALSE(DownloadStore::ValidId(""));
+  EXPECT_FALSE(DownloadStore::ValidId("."));
+  EXPECT_FALSE(DownloadStore::ValidId(".."));
+  EXPECT_FALSE(DownloadStore::ValidId(".hidden"));
+  EXPECT_FALSE(DownloadStore::ValidId("a/b"));
+  EXPECT_FALSE(DownloadStore::ValidId("a b"));
+  EXPECT_FALSE(DownloadStore::ValidId(std::string(129, 'a')));
+}
+
+TEST_F(DownloadStoreTest, PlansRoundTrip) {
+  DownloadStore store(directory_);
+  DownloadPlan plan;
+  plan.source.type = SourceType::kNetwork;
+  plan.source.uri = "https://cdn.example/master.m3u8?token=a%20b";
+  plan.source.headers["Authorization"] = "Bearer x";
+  VideoQualityTrack track;
+  track.id = "0:2";
+  track.bitrate = 2500000;
+  track.width = 1280;
+  track.height = 720;
+  plan.track = track;
+  plan.entry = "index.m3u8";
+  plan.parts.push_back({"https://cdn.example/seg0.ts", -1, -1, "seg0.ts", 0});
+  plan.parts.push_back({"https://cdn.example/all.mp4", 100, 199, "video/seg1.m4s", 0});
+  ASSERT_TRUE(store.WritePlan("movie", plan));
+
+  DownloadPlan read;
+  ASSERT_TRUE(store.ReadPlan("movie", &read));
+  EXPECT_EQ(read.source.type, SourceType::kNetwork);
+  EXPECT_EQ(read.source.uri, plan.source.uri);
+  EXPECT_EQ(read.source.headers, plan.source.headers);
+  ASSERT_TRUE(read.track.has_value());
+  EXPECT_EQ(read.track->id, "0:2");
+  EXPECT_EQ(read.track->bitrate, 2500000);
+  EXPECT_EQ(read.track->width, 1280);
+  EXPECT_EQ(read.track->height, 720);
+  EXPECT_EQ(read.entry, "index.m3u8");
+  EXPECT_EQ(read.parts, plan.parts);
+  EXPECT_EQ(store.List(), (std::vector<std::string>{"movie"}));
+
+  // Paths may not leave the download's directory
+  plan.parts[0].path = "../other/seg0.ts";
+  EXPECT_FALSE(store.WritePlan("escape", plan));
+  {
+    std::ofstream edited(directory_ + "/movie/plan", std::ios::app);
+    edited << "part\t../../etc/passwd\t0\t-1\t-1\thttps://cdn.example/x\n";
+  }
+  EXPECT_FALSE(store.ReadPlan("movie", &read));
+  EXPECT_FALSE(store.ReadPlan("missing", &read));
+}
+
+TEST_F(DownloadStoreTest, JournalIgnoresATornLastLine) {
+  DownloadStore store(directory_);
+  ASSERT_TRUE(store.WritePlan("clip", DownloadPlan()));
+  ASSERT_TRUE(store.AppendJournal("clip", 0, {10, 0x1234abcd}));
+  ASSERT_TRUE(store.AppendJournal("clip", 2, {20, 0xdeadbeef}));
+  {
+    // A crash mid-write
+    std::ofstream journal(directory_ + "/clip/journal", std::ios::app);
+    journal << "1\t3";
+  }
+
+  bool complete = true;
+  const auto parts = store.ReadJournal("clip", &complete);
+  EXPECT_FALSE(complete);
+  ASSERT_EQ(parts.size(), 2u);
+  EXPECT_EQ(parts.at(0).size, 10);
+  EXPECT_EQ(parts.at(0).crc, 0x1234abcdu);
+  EXPECT_EQ(parts.at(2).crc, 0xdeadbeefu);
+}
+
+TEST_F(DownloadStoreTest, ResolvesOnlyCompleteVerifiedDownloads) {
+  DownloadStore store(directory_);
+  DownloadPlan plan;
+  plan.source.type = SourceType::kNetwork;
+  plan.source.uri = "https://cdn.example/clip.mp4";
+  plan.entry = "media.mp4";
+  plan.parts.push_back({plan.source.uri, 0, 3, "media.mp4", 0});
+  plan.parts.push_back({plan.source.uri, 4, 7, "media.mp4", 4});
+  ASSERT_TRUE(store.WritePlan("clip", plan));
+
+  // Ranges land at their offsets, in any order
+  ASSERT_TRUE(Write(&store, "clip", 1, plan.parts[1], "efgh"));
+  MediaSource source;
+  std::string error;
+  EXPECT_FALSE(store.Resolve("clip", &source, &error));
+  EXPECT_FALSE(error.empty());
+  ASSERT_TRUE(Write(&store, "clip", 0, plan.parts[0], "abcd"));
+  ASSERT_TRUE(store.MarkComplete("clip"));
+
+  ASSERT_TRUE(store.Resolve("clip", &source, &error)) << error;
+  EXPECT_EQ(source.type, SourceType::kFile);
+  EXPECT_EQ(source.uri, directory_ + "/clip/media.mp4");
+  EXPECT_TRUE(store.Verify("clip", &error)) << error;
+  std::ifstream file(source.uri);
+  EXPECT_EQ(std::string(std::istreambuf_iterator<char>(file), {}), "abcdefgh");
+
+  // A flipped byte is caught by the part's CRC
+  {
+    std::fstream corrupt(source.uri, std::ios::in | std::ios::out | std::ios::binary);
+    corrupt.seekp(5);
+    corrupt.put('X');
+  }
+  EXPECT_FALSE(store.Verify("clip", &error));
+  bool complete = false;
+  const auto journal = store.ReadJournal("clip", &complete);
+  EXPECT_TRUE(store.CheckPart("clip", plan.parts[0], journal.at(0)));
+  EXPECT_FALSE(store.CheckPart("clip", plan.parts[1], journal.at(1)));
+
+  ASSERT_TRUE(store.Remove("clip"));
+  EXPECT_FALSE(std::filesystem::exists(directory_ + "/clip"));
+  EXPECT_FALSE(store.Resolve("clip", &source, &error));
+}
+
+}  // namespace
+}  // namespace pro_video_player
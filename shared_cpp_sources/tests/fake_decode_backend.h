@@ -0,0 +1,149 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_TESTS_FAKE_DECODE_BACKEND_H_
+#define PRO_VIDEO_PLAYER_SHARED_TESTS_FAKE_DECODE_BACKEND_H_
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "decode_backend.h"
+
+namespace pro_video_player {
+namespace testing {
+
+// Shared between a FakeDecodeBackend and the test, which keeps it after the
+// player has destroyed the backend.
+struct FakeBackendState {
+  std::mutex mutex;
+  std::vector<std::string> calls;
+  DecodeBackendListener* listener = nullptr;
+  MediaSource source;
+  std::atomic<int64_t> position_ms{0};
+  std::atomic<int64_t> live_latency_ms{-1};
+  bool closed = false;
+  // Held by a test to stall the player's worker inside its next backend
+  // call, so that further commands pile up behind it.
+  std::mutex hold;
+  // Interleaved audio returned by ScanAudio; empty means unsupported.
+  std::vector<float> scan_audio;
+  int scan_channels = 1;
+  int scan_sample_rate = 1000;
+  std::atomic<int> scans{0};
+
+  void Record(const std::string& call) {
+    { std::lock_guard<std::mutex> held(hold); }
+    std::lock_guard<std::mutex> lock(mutex);
+    calls.push_back(call);
+  }
+
+  std::vector<std::string> Calls() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return calls;
+  }
+
+  bool HasCall(const std::string& call) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& c : calls) {
+      if (c == call) return true;
+    }
+    return false;
+  }
+
+  DecodeBackendListener* Listener() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return listener;
+  }
+};
+
+// Records every call; tests drive the listener directly.
+class FakeDecodeBackend : public DecodeBackend {
+ public:
+  explicit FakeDecodeBackend(std::shared_ptr<FakeBackendState> state) : state_(std::move(state)) {}
+
+  std::string name() const override { return "Fake"; }
+
+  void Open(const MediaSource& source, DecodeBackendListener* listener) override {
+    {
+      std::lock_guard<std::mutex> lock(state_->mutex);
+      state_->source = source;
+      state_->listener = listener;
+    }
+    state_->Record("Open " + source.uri);
+  }
+  void Play() override { state_->Record("Play"); }
+  void Pause() override { state_->Record("Pause"); }
+  void Seek(int64_t position_ms) override {
+    state_->position_ms = position_ms;
+    state_->Record("Seek " + std::to_string(position_ms));
+  }
+  void SetRate(double rate) override { state_->Record("SetRate " + std::to_string(rate)); }
+  void SetVolume(double volume) override { state_->Record("SetVolume " + std::to_string(volume)); }
+  void SetPreferredLanguages(const std::string& audio, const std::string& subtitle) override {
+    state_->Record("SetPreferredLanguages " + audio + "," + subtitle);
+  }
+  void SelectAudioTrack(const std::string& id) override { state_->Record("SelectAudioTrack " + id); }
+  void SelectSubtitleTrack(const std::string& id) override {
+    state_->Record("SelectSubtitleTrack " + id);
+  }
+  void SetBufferLimits(const BufferLimits& limits) override {
+    state_->Record("SetBufferLimits " + std::to_string(limits.max_ms) + "ms " +
+                   std::to_string(limits.max_bytes) + "/" + std::to_string(limits.back_bytes));
+  }
+  void SetVideoEnabled(bool enabled) override {
+    state_->Record(std::string("SetVideoEnabled ") + (enabled ? "true" : "false"));
+  }
+  void SetOutputSizeHint(int width, int height) override {
+    state_->Record("SetOutputSizeHint " + std::to_string(width) + "x" + std::to_string(height));
+  }
+  void SetRenderPolicy(int64_t min_interval_us, bool visible) override {
+    state_->Record("SetRenderPolicy " + std::to_string(min_interval_us) + (visible ? " visible" : " hidden"));
+  }
+  int64_t QueryPositionMs() override { return state_->position_ms.load(); }
+  int64_t QueryLiveLatencyMs() override { return state_->live_latency_ms.load(); }
+  void SetAudioTapEnabled(bool enabled) override {
+    state_->Record(std::string("SetAudioTapEnabled ") + (enabled ? "true" : "false"));
+  }
+  void SetSubtitleCuesEnabled(bool enabled) override {
+    state_->Record(std::string("SetSubtitleCuesEnabled ") + (enabled ? "true" : "false"));
+  }
+  bool ScanAudio(const MediaSource& /*source*/, const AudioScanSink& sink,
+                 const std::atomic<bool>& cancel) override {
+    ++state_->scans;
+    if (state_->scan_audio.empty()) return false;
+    // Delivered in 10-frame chunks like a decoder would
+    const size_t channels = static_cast<size_t>(state_->scan_channels);
+    const size_t frames = state_->scan_audio.size() / channels;
+    for (size_t offset = 0; offset < frames && !cancel.load(); offset += 10) {
+      AudioSamples samples;
+      samples.data = state_->scan_audio.data() + offset * channels;
+      samples.frames = std::min<size_t>(10, frames - offset);
+      samples.channels = state_->scan_channels;
+      samples.sample_rate = state_->scan_sample_rate;
+      samples.pts_ms = static_cast<int64_t>(offset) * 1000 / state_->scan_sample_rate;
+      sink(samples);
+    }
+    return true;
+  }
+  bool WarmUp() override {
+    state_->Record("WarmUp");
+    return true;
+  }
+  void Close() override {
+    {
+      std::lock_guard<std::mutex> lock(state_->mutex);
+      state_->closed = true;
+      state_->listener = nullptr;
+    }
+    state_->Record("Close");
+  }
+
+ private:
+  std::shared_ptr<FakeBackendState> state_;
+};
+
+}  // namespace testing
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_TESTS_FAKE_DECODE_BACKEND_H_
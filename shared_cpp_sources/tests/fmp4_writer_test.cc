@@ -0,0 +1,155 @@
+#include "fmp4_writer.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace pro_video_player {
+namespace {
+
+uint64_t ReadBe(const std::string& bytes, size_t at, int count) {
+  uint64_t value = 0;
+  for (int i = 0; i < count; ++i) value = (value << 8) | static_cast<uint8_t>(bytes[at + i]);
+  return value;
+}
+
+// Offset of the first |type| box at or after |from| (box payloads are
+// searched too).
+size_t FindBox(const std::string& bytes, const std::string& type, size_t from = 0) {
+  const size_t at = bytes.find(type, from);
+  return at == std::string::npos ? at : at - 4;
+}
+
+std::vector<DemuxedTrack> Tracks() {
+  DemuxedTrack video;
+  video.kind = DemuxedTrackKind::kVideo;
+  video.timescale = 90000;
+  video.fourcc = "avc1";
+  video.sample_entry = Mp4VisualSampleEntry("avc1", 1280, 720, "avcC", {1, 2, 3});
+  video.width = 1280;
+  video.height = 720;
+  DemuxedTrack audio;
+  audio.kind = DemuxedTrackKind::kAudio;
+  audio.timescale = 48000;
+  audio.fourcc = "mp4a";
+  audio.sample_entry = Mp4AudioSampleEntry("mp4a", 2, 48000, Mp4EsdsBox({0x11, 0x90}));
+  audio.language = "eng";
+  return {video, audio};
+}
+
+DemuxedSample Sample(int64_t offset, uint32_t size, int64_t dts, uint32_t duration, int32_t composition_offset,
+                     bool keyframe) {
+  DemuxedSample sample;
+  sample.offset = offset;
+  sample.size = size;
+  sample.dts = dts;
+  sample.duration = duration;
+  sample.composition_offset = composition_offset;
+  sample.keyframe = keyframe;
+  return sample;
+}
+
+TEST(Fmp4WriterTest, InitSegmentCarriesTheSampleEntries) {
+  const auto tracks = Tracks();
+  const std::string init = BuildFmp4Init(tracks);
+  EXPECT_EQ(init.substr(4, 8), "ftypiso6");
+  const size_t moov = FindBox(init, "moov");
+  ASSERT_NE(moov, std::string::npos);
+  EXPECT_EQ(moov + ReadBe(init, moov, 4), init.size());
+  for (const auto& track : tracks) {
+    EXPECT_NE(init.find(std::string(track.sample_entry.begin(), track.sample_entry.end())), std::string::npos);
+  }
+  // Track ids 1 and 2 in tkhd and trex
+  const size_t tkhd = FindBox(init, "tkhd");
+  EXPECT_EQ(ReadBe(init, tkhd + 20, 4), 1u);
+  EXPECT_EQ(ReadBe(init, tkhd + 84, 4), 1280u << 16);
+  EXPECT_EQ(ReadBe(init, FindBox(init, "tkhd", tkhd + 8) + 20, 4), 2u);
+  const size_t trex = FindBox(init, "trex");
+  ASSERT_NE(trex, std::string::npos);
+  EXPECT_EQ(ReadBe(init, trex + 12, 4), 1u);
+  EXPECT_EQ(ReadBe(init, FindBox(init, "trex", trex + 8) + 12, 4), 2u);
+  // Packed "eng" in the audio mdhd
+  const size_t mdhd = FindBox(init, "mdhd", FindBox(init, "mdhd") + 8);
+  EXPECT_EQ(ReadBe(init, mdhd + 12 + 8, 4), 48000u);
+  EXPECT_EQ(ReadBe(init, mdhd + 12 + 16, 2), 0x15c7u);
+}
+
+TEST(Fmp4WriterTest, FragmentReferencesTheSourceBytes) {
+  const auto tracks = Tracks();
+  // Two adjacent video samples, then audio somewhere else in the file
+  std::vector<std::vector<DemuxedSample>> samples(2);
+  samples[0].push_back(Sample(1000, 500, 180000, 3000, 3000, true));
+  samples[0].push_back(Sample(1500, 100, 183000, 3000, -3000, false));
+  samples[1].push_back(Sample(5000, 40, 96000, 1024, 0, true));
+  const Fmp4Fragment fragment = BuildFmp4Fragment(7, tracks, samples);
+  const std::string& header = fragment.header;
+
+  ASSERT_EQ(fragment.payload.size(), 2u);
+  EXPECT_EQ(fragment.payload[0].offset, 1000);
+  EXPECT_EQ(fragment.payload[0].size, 600);
+  EXPECT_EQ(fragment.payload[1].offset, 5000);
+  EXPECT_EQ(fragment.payload[1].size, 40);
+  EXPECT_EQ(fragment.size(), static_cast<int64_t>(header.size()) + 640);
+
+  const size_t moof_size = ReadBe(header, 0, 4);
+  EXPECT_EQ(header.substr(4, 4), "moof");
+  EXPECT_EQ(header.size(), moof_size + 8);
+  EXPECT_EQ(header.substr(moof_size + 4, 4), "mdat");
+  EXPECT_EQ(ReadBe(header, moof_size, 4), 648u);
+  EXPECT_EQ(ReadBe(header, FindBox(header, "mfhd") + 12, 4), 7u);
+
+  const size_t tfdt = FindBox(header, "tfdt");
+  EXPECT_EQ(ReadBe(header, tfdt + 12, 8), 180000u);
+  const size_t trun = FindBox(header, "trun");
+  EXPECT_EQ(ReadBe(header, trun + 8, 4), 0x01000f01u);
+  EXPECT_EQ(ReadBe(header, trun + 12, 4), 2u);
+  EXPECT_EQ(ReadBe(header, trun + 16, 4), moof_size + 8);
+  // duration, size, flags, composition offset
+  EXPECT_EQ(ReadBe(header, trun + 20, 4), 3000u);
+  EXPECT_EQ(ReadBe(header, trun + 24, 4), 500u);
+  EXPECT_EQ(ReadBe(header, trun + 28, 4), 0x02000000u);
+  EXPECT_EQ(ReadBe(header, trun + 32, 4), 3000u);
+  EXPECT_EQ(ReadBe(header, trun + 44, 4), 0x01010000u);
+  EXPECT_EQ(static_cast<int32_t>(ReadBe(header, trun + 48, 4)), -3000);
+
+  // Audio after the video bytes
+  const size_t audio_tfhd = FindBox(header, "tfhd", trun);
+  EXPECT_EQ(ReadBe(header, audio_tfhd + 12, 4), 2u);
+  EXPECT_EQ(ReadBe(header, FindBox(header, "tfdt", trun) + 12, 8), 96000u);
+  EXPECT_EQ(ReadBe(header, FindBox(header, "trun", trun + 8) + 16, 4), moof_size + 8 + 600);
+}
+
+TEST(Fmp4WriterTest, EmptyTracksAreLeftOut) {
+  std::vector<std::vector<DemuxedSample>> samples(2);
+  samples[1].push_back(Sample(0, 10, 0, 1024, 0, true));
+  const Fmp4Fragment fragment = BuildFmp4Fragment(1, Tracks(), samples);
+  const size_t tfhd = FindBox(fragment.header, "tfhd");
+  EXPECT_EQ(ReadBe(fragment.header, tfhd + 12, 4), 2u);
+  EXPECT_EQ(FindBox(fragment.header, "traf", tfhd), std::string::npos);
+}
+
+TEST(Fmp4WriterTest, AudioConfigBoxes) {
+  const std::vector<uint8_t> esds = Mp4EsdsBox({0x12, 0x10});
+  const std::string expected_esds("\x00\x00\x00\x33"
+                                  "esds\x00\x00\x00\x00"
+                                  "\x03\x80\x80\x80\x22\x00\x00\x00"
+                                  "\x04\x80\x80\x80\x14\x40\x15\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+                                  "\x05\x80\x80\x80\x02\x12\x10"
+                                  "\x06\x80\x80\x80\x01\x02",
+                                  51);
+  EXPECT_EQ(std::string(esds.begin(), esds.end()), expected_esds);
+
+  // OpusHead: 2 channels, pre-skip 312, 48 kHz, no gain, family 0
+  const std::string head("OpusHead\x01\x02\x38\x01\x80\xbb\x00\x00\x00\x00\x00", 19);
+  std::vector<uint8_t> dops;
+  ASSERT_TRUE(Mp4OpusBox(std::vector<uint8_t>(head.begin(), head.end()), &dops));
+  const std::string expected_dops("\x00\x00\x00\x13"
+                                  "dOps\x00\x02\x01\x38\x00\x00\xbb\x80\x00\x00\x00",
+                                  19);
+  EXPECT_EQ(std::string(dops.begin(), dops.end()), expected_dops);
+  EXPECT_FALSE(Mp4OpusBox({1, 2, 3}, &dops));
+}
+
+}  // namespace
+}  // namespace pro_video_player
@@ -0,0 +1,111 @@
+#include "frame_buffer_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace pro_video_player {
+namespace {
+
+TEST(FrameBufferPoolTest, BuffersAreAligned) {
+  auto pool = FrameBufferPool::Create();
+  for (size_t size : {1u, 100u, 1920u * 1080u * 4u}) {
+    auto buffer = pool->Acquire(size);
+    ASSERT_NE(buffer, nullptr);
+    EXPECT_EQ(buffer->size(), size);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(buffer->data()) % FrameBuffer::kAlignment, 0u);
+  }
+}
+
+TEST(FrameBufferPoolTest, ReleasedBuffersAreReused) {
+  auto pool = FrameBufferPool::Create();
+  uint8_t* first;
+  {
+    auto buffer = pool->Acquire(4096);
+    first = buffer->data();
+  }
+  EXPECT_EQ(pool->available(), 1u);
+  auto again = pool->Acquire(4096);
+  EXPECT_EQ(again->data(), first);
+  EXPECT_EQ(pool->allocated(), 1u);
+}
+
+TEST(FrameBufferPoolTest, ReturnsNullWhenAllBuffersInFlight) {
+  auto pool = FrameBufferPool::Create(2);
+  auto a = pool->Acquire(64);
+  auto b = pool->Acquire(64);
+  EXPECT_EQ(pool->Acquire(64), nullptr);
+
+  b.reset();
+  EXPECT_NE(pool->Acquire(64), nullptr);
+}
+
+TEST(FrameBufferPoolTest, SizeChangeFreesOldBuffers) {
+  auto pool = FrameBufferPool::Create(3);
+  auto in_flight = pool->Acquire(64);
+  pool->Acquire(64).reset();
+  EXPECT_EQ(pool->allocated(), 2u);
+
+  auto resized = pool->Acquire(128);
+  ASSERT_NE(resized, nullptr);
+  // The idle 64-byte buffer is dropped right away, the in-flight one on release
+  EXPECT_EQ(pool->allocated(), 2u);
+  in_flight.reset();
+  EXPECT_EQ(pool->allocated(), 1u);
+  EXPECT_EQ(pool->available(), 0u);
+}
+
+TEST(FrameBufferPoolTest, TrimFreesOnlyIdleBuffers) {
+  auto pool = FrameBufferPool::Create();
+  auto shown = pool->Acquire(1024);
+  pool->Acquire(1024).reset();
+  pool->Acquire(1024);  // the idle one again
+  pool->Acquire(1024).reset();
+  ASSERT_EQ(pool->allocated(), 2u);
+  EXPECT_EQ(pool->Trim(), 1024u);
+  EXPECT_EQ(pool->allocated(), 1u);
+  EXPECT_EQ(pool->available(), 0u);
+  shown.reset();
+  EXPECT_EQ(pool->available(), 1u);
+}
+
+TEST(FrameBufferPoolTest, BuffersOutliveThePool) {
+  auto pool = FrameBufferPool::Create();
+  auto buffer = pool->Acquire(256);
+  pool.reset();
+  buffer->data()[255] = 1;
+  buffer.reset();
+}
+
+TEST(FrameBufferPoolTest, ConcurrentProducerAndConsumer) {
+  auto pool = FrameBufferPool::Create(3);
+  std::vector<std::shared_ptr<FrameBuffer>> queue;
+  std::mutex mutex;
+  int produced = 0;
+  std::thread producer([&]() {
+    while (produced < 1000) {
+      auto buffer = pool->Acquire(1024);
+      if (buffer == nullptr) {
+        std::this_thread::yield();
+        continue;
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      queue.push_back(std::move(buffer));
+      ++produced;
+    }
+  });
+  int consumed = 0;
+  while (consumed < 1000) {
+    std::lock_guard<std::mutex> lock(mutex);
+    consumed += static_cast<int>(queue.size());
+    queue.clear();
+  }
+  producer.join();
+  EXPECT_LE(pool->allocated(), 3u);
+}
+
+}  // namespace
+}  // namespace pro_video_player
@@ -0,0 +1,297 @@
+#include "frame_capture.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "download_store.h"
+
+namespace pro_video_player {
+namespace {
+
+uint32_t ReadBe32(const std::vector<uint8_t>& bytes, size_t at) {
+  return (static_cast<uint32_t>(bytes[at]) << 24) | (bytes[at + 1] << 16) | (bytes[at + 2] << 8) | bytes[at + 3];
+}
+
+// Inflates what EncodePng writes: a zlib stream of stored or
+// fixed-Huffman blocks. Empty on anything else.
+std::vector<uint8_t> Inflate(const std::vector<uint8_t>& zlib) {
+  static constexpr int kLengthBase[] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                        31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+  static constexpr int kLengthExtra[] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                         2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+  static constexpr int kDistanceBase[] = {1,    2,    3,    4,    5,    7,     9,     13,    17,    25,
+                                          33,   49,   65,   97,   129,  193,   257,   385,   513,   769,
+                                          1025, 1537, 2049, 3073, 4097, 6145,  8193,  12289, 16385, 24577};
+  static constexpr int kDistanceExtra[] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6,
+                                           6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+  size_t at = 2;
+  int bit = 0;
+  bool overrun = false;
+  auto bits = [&](int count) {
+    uint32_t value = 0;
+    for (int i = 0; i < count; ++i) {
+      if (at >= zlib.size()) {
+        overrun = true;
+        return value;
+      }
+      value |= ((zlib[at] >> bit) & 1u) << i;
+      if (++bit == 8) {
+        bit = 0;
+        ++at;
+      }
+    }
+    return value;
+  };
+  // Huffman codes are packed most significant bit first
+  auto code = [&](int count) {
+    uint32_t value = 0;
+    for (int i = 0; i < count; ++i) value = (value << 1) | bits(1);
+    return value;
+  };
+
+  std::vector<uint8_t> out;
+  bool last = false;
+  while (!last && !overrun) {
+    last = bits(1) == 1;
+    const uint32_t type = bits(2);
+    if (type == 0) {
+      if (bit != 0) {
+        bit = 0;
+        ++at;
+      }
+      const size_t length = zlib[at] | (zlib[at + 1] << 8);
+      at += 4;
+      out.insert(out.end(), zlib.begin() + at, zlib.begin() + at + length);
+      at += length;
+      continue;
+    }
+    if (type != 1) return {};
+    while (!overrun) {
+      uint32_t symbol = code(7);
+      if (symbol <= 0x17) {
+        symbol += 256;
+      } else {
+        symbol = (symbol << 1) | bits(1);
+        if (symbol >= 0x30 && symbol <= 0xbf) {
+          symbol -= 0x30;
+        } else if (symbol >= 0xc0 && symbol <= 0xc7) {
+          symbol = symbol - 0xc0 + 280;
+        } else {
+          symbol = ((symbol << 1) | bits(1)) - 0x190 + 144;
+        }
+      }
+      if (symbol < 256) {
+        out.push_back(static_cast<uint8_t>(symbol));
+        continue;
+      }
+      if (symbol == 256) break;
+      const int length = kLengthBase[symbol - 257] + bits(kLengthExtra[symbol - 257]);
+      const uint32_t distance_code = code(5);
+      const size_t distance = kDistanceBase[distance_code] + bits(kDistanceExtra[distance_code]);
+      if (distance > out.size()) return {};
+      for (int i = 0; i < length; ++i) out.push_back(out[out.size() - distance]);
+    }
+  }
+  if (overrun) return {};
+  // Adler-32 of the output follows
+  if (bit != 0) ++at;
+  uint32_t a = 1;
+  uint32_t b = 0;
+  for (const uint8_t byte : out) {
+    a = (a + byte) % 65521;
+    b = (b + a) % 65521;
+  }
+  if (at + 4 != zlib.size() || ReadBe32(zlib, at) != ((b << 16) | a)) return {};
+  return out;
+}
+
+// Undoes the PNG row filters.
+std::vector<uint8_t> Unfilter(const std::vector<uint8_t>& filtered, int width, int height, int channels) {
+  const size_t row_bytes = static_cast<size_t>(width) * channels;
+  std::vector<uint8_t> pixels(row_bytes * height);
+  for (int y = 0; y < height; ++y) {
+    const uint8_t* in = filtered.data() + y * (row_bytes + 1);
+    uint8_t* row = pixels.data() + y * row_bytes;
+    for (size_t i = 0; i < row_bytes; ++i) {
+      const int left = i >= static_cast<size_t>(channels) ? row[i - channels] : 0;
+      const int up = y > 0 ? row[i - row_bytes] : 0;
+      const int up_left = y > 0 && i >= static_cast<size_t>(channels) ? row[i - row_bytes - channels] : 0;
+      int predicted = 0;
+      switch (in[0]) {
+        case 1:
+          predicted = left;
+          break;
+        case 2:
+          predicted = up;
+          break;
+        case 3:
+          predicted = (left + up) >> 1;
+          break;
+        case 4: {
+          const int estimate = left + up - up_left;
+          const int to_left = std::abs(estimate - left);
+          const int to_up = std::abs(estimate - up);
+          const int to_up_left = std::abs(estimate - up_left);
+          predicted = to_left <= to_up && to_left <= to_up_left ? left : to_up <= to_up_left ? up : up_left;
+          break;
+        }
+      }
+      row[i] = static_cast<uint8_t>(in[1 + i] + predicted);
+    }
+  }
+  return pixels;
+}
+
+// Gradients, a hard edge and noise, so every filter and long matches
+// get used.
+std::vector<uint8_t> TestImage(int width, int height, uint8_t alpha = 255) {
+  std::vector<uint8_t> rgba(static_cast<size_t>(width) * height * 4);
+  uint32_t noise = 1;
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      uint8_t* pixel = &rgba[(static_cast<size_t>(y) * width + x) * 4];
+      noise = noise * 1103515245 + 12345;
+      pixel[0] = static_cast<uint8_t>(x * 255 / width);
+      pixel[1] = static_cast<uint8_t>(y < height / 2 ? 40 : 200);
+      pixel[2] = static_cast<uint8_t>(x < width / 3 ? noise >> 24 : 128);
+      pixel[3] = alpha;
+    }
+  }
+  return rgba;
+}
+
+VideoFrame Frame(const std::vector<uint8_t>& pixels, int width, int height, PixelFormat format) {
+  VideoFrame frame;
+  frame.width = width;
+  frame.height = height;
+  frame.stride = width * 4;
+  frame.format = format;
+  frame.data = pixels.data();
+  return frame;
+}
+
+TEST(FrameCaptureTest, ScalesWithABoxFilter) {
+  // Two 2x2 blocks: black and white, then mid grey
+  const std::vector<uint8_t> pixels = {0,   0,   0,   9,   255, 255, 255, 9,   100, 100, 100, 9,   100, 100, 100, 9,
+                                       255, 255, 255, 9,   0,   0,   0,   9,   100, 100, 100, 9,   100, 100, 100, 9};
+  int width = 0;
+  int height = 0;
+  std::vector<uint8_t> rgba = ScaleFrameToRgba(Frame(pixels, 4, 2, PixelFormat::kRgbx), 2, &width, &height);
+  EXPECT_EQ(width, 2);
+  EXPECT_EQ(height, 1);
+  EXPECT_EQ(rgba, (std::vector<uint8_t>{128, 128, 128, 255, 100, 100, 100, 255}));
+
+  // Never scaled up; BGRA swapped, alpha kept
+  const std::vector<uint8_t> bgra = {1, 2, 3, 4};
+  rgba = ScaleFrameToRgba(Frame(bgra, 1, 1, PixelFormat::kBgra), 640, &width, &height);
+  EXPECT_EQ(width, 1);
+  EXPECT_EQ(rgba, (std::vector<uint8_t>{3, 2, 1, 4}));
+
+  // Aspect ratio rounds; rows are read through the stride
+  std::vector<uint8_t> padded(1920 * 4 * 1081);
+  VideoFrame frame = Frame(padded, 1918, 1080, PixelFormat::kRgba);
+  frame.stride = 1920 * 4;
+  rgba = ScaleFrameToRgba(frame, 640, &width, &height);
+  EXPECT_EQ(width, 640);
+  EXPECT_EQ(height, 360);
+  EXPECT_EQ(rgba.size(), 640u * 360 * 4);
+
+  frame.data = nullptr;
+  EXPECT_TRUE(ScaleFrameToRgba(frame, 640, &width, &height).empty());
+  EXPECT_EQ(width, 0);
+}
+
+TEST(FrameCaptureTest, PngRoundTrips) {
+  for (const uint8_t alpha : {uint8_t{255}, uint8_t{77}}) {
+    const int width = 123;
+    const int height = 45;
+    const std::vector<uint8_t> rgba = TestImage(width, height, alpha);
+    const std::vector<uint8_t> png = EncodePng(rgba.data(), width, height);
+    ASSERT_GT(png.size(), 33u);
+    EXPECT_EQ(std::string(png.begin(), png.begin() + 8), "\x89PNG\r\n\x1a\n");
+
+    // Chunks with valid CRCs: IHDR, IDAT, IEND
+    std::vector<std::string> types;
+    std::vector<uint8_t> idat;
+    for (size_t at = 8; at + 12 <= png.size();) {
+      const uint32_t length = ReadBe32(png, at);
+      types.emplace_back(png.begin() + at + 4, png.begin() + at + 8);
+      EXPECT_EQ(ReadBe32(png, at + 8 + length), Crc32(png.data() + at + 4, length + 4)) << types.back();
+      if (types.back() == "IDAT") idat.assign(png.begin() + at + 8, png.begin() + at + 8 + length);
+      at += 12 + length;
+    }
+    EXPECT_EQ(types, (std::vector<std::string>{"IHDR", "IDAT", "IEND"}));
+    EXPECT_EQ(ReadBe32(png, 16), static_cast<uint32_t>(width));
+    EXPECT_EQ(ReadBe32(png, 20), static_cast<uint32_t>(height));
+    // RGB when opaque
+    const int channels = alpha == 255 ? 3 : 4;
+    EXPECT_EQ(png[25], alpha == 255 ? 2 : 6);
+
+    const std::vector<uint8_t> filtered = Inflate(idat);
+    ASSERT_EQ(filtered.size(), static_cast<size_t>(width * channels + 1) * height);
+    const std::vector<uint8_t> pixels = Unfilter(filtered, width, height, channels);
+    for (size_t i = 0; i < static_cast<size_t>(width) * height; ++i) {
+      for (int c = 0; c < channels; ++c) ASSERT_EQ(pixels[i * channels + c], rgba[i * 4 + c]) << i;
+    }
+    // Compressed, not stored
+    EXPECT_LT(idat.size(), filtered.size() / 2);
+  }
+}
+
+TEST(FrameCaptureTest, JpegIsBaseline) {
+  const int width = 37;
+  const int height = 21;
+  const std::vector<uint8_t> rgba = TestImage(width, height);
+  const std::vector<uint8_t> jpeg = EncodeJpeg(rgba.data(), width, height);
+  ASSERT_GT(jpeg.size(), 4u);
+  EXPECT_EQ(jpeg[0], 0xff);
+  EXPECT_EQ(jpeg[1], 0xd8);
+  EXPECT_EQ(jpeg[jpeg.size() - 2], 0xff);
+  EXPECT_EQ(jpeg[jpeg.size() - 1], 0xd9);
+
+  // Marker segments up to the scan
+  std::vector<int> markers;
+  size_t at = 2;
+  while (at + 4 <= jpeg.size() && jpeg[at] == 0xff) {
+    markers.push_back(jpeg[at + 1]);
+    const size_t length = (jpeg[at + 2] << 8) | jpeg[at + 3];
+    if (jpeg[at + 1] == 0xc0) {
+      EXPECT_EQ((jpeg[at + 5] << 8) | jpeg[at + 6], height);
+      EXPECT_EQ((jpeg[at + 7] << 8) | jpeg[at + 8], width);
+      EXPECT_EQ(jpeg[at + 9], 3);
+    }
+    at += 2 + length;
+    if (markers.back() == 0xda) break;
+  }
+  EXPECT_EQ(markers, (std::vector<int>{0xe0, 0xdb, 0xc0, 0xc4, 0xda}));
+  // Entropy-coded data: every 0xff is stuffed
+  for (; at + 2 < jpeg.size(); ++at) {
+    if (jpeg[at] == 0xff) EXPECT_EQ(jpeg[++at], 0x00) << at;
+  }
+
+  // Quality trades size
+  EXPECT_LT(EncodeJpeg(rgba.data(), width, height, 30).size(), EncodeJpeg(rgba.data(), width, height, 95).size());
+}
+
+TEST(FrameCaptureTest, EncodesFramesInEachFormat) {
+  const std::vector<uint8_t> pixels = TestImage(64, 32);
+  const VideoFrame frame = Frame(pixels, 64, 32, PixelFormat::kRgbx);
+  CapturedFrame captured;
+  ASSERT_TRUE(EncodeFrame(frame, 32, CaptureFormat::kRaw, &captured));
+  EXPECT_EQ(captured.width, 32);
+  EXPECT_EQ(captured.height, 16);
+  EXPECT_EQ(captured.bytes.size(), 32u * 16 * 4);
+  ASSERT_TRUE(EncodeFrame(frame, 0, CaptureFormat::kPng, &captured));
+  EXPECT_EQ(captured.width, 64);
+  EXPECT_EQ(captured.bytes[1], 'P');
+  ASSERT_TRUE(EncodeFrame(frame, 0, CaptureFormat::kJpeg, &captured));
+  EXPECT_EQ(captured.bytes[1], 0xd8);
+  EXPECT_FALSE(EncodeFrame(VideoFrame(), 0, CaptureFormat::kPng, &captured));
+}
+
+}  // namespace
+}  // namespace pro_video_player
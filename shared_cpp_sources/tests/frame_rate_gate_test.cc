@@ -0,0 +1,59 @@
+#include "frame_rate_gate.h"
+
+#include <gtest/gtest.h>
+
+namespace pro_video_player {
+namespace {
+
+TEST(FrameRateGateTest, RendersEveryFrameByDefault) {
+  FrameRateGate gate;
+  for (int i = 0; i < 5; ++i) EXPECT_TRUE(gate.ShouldRender(i * 1000));
+  EXPECT_EQ(gate.rendered(), 5u);
+  EXPECT_EQ(gate.skipped(), 0u);
+}
+
+TEST(FrameRateGateTest, CapKeepsEveryNthFrameOfMillisecondTimestamps) {
+  FrameRateGate gate;
+  gate.SetPolicy(100000, true);
+  // 30 fps source, timestamps rounded to milliseconds
+  int rendered = 0;
+  for (int i = 0; i < 30; ++i) {
+    if (gate.ShouldRender(static_cast<int64_t>(i * 1000 / 30) * 1000)) ++rendered;
+  }
+  EXPECT_EQ(rendered, 10);
+  EXPECT_EQ(gate.skipped(), 20u);
+}
+
+TEST(FrameRateGateTest, BackwardsTimestampRendersAtOnce) {
+  FrameRateGate gate;
+  gate.SetPolicy(100000, true);
+  EXPECT_TRUE(gate.ShouldRender(5000000));
+  EXPECT_FALSE(gate.ShouldRender(5010000));
+  EXPECT_TRUE(gate.ShouldRender(0));
+  EXPECT_FALSE(gate.ShouldRender(20000));
+  gate.Reset();
+  EXPECT_TRUE(gate.ShouldRender(30000));
+}
+
+TEST(FrameRateGateTest, UntimedFramesOnlyFollowVisibility) {
+  FrameRateGate gate;
+  gate.SetPolicy(100000, true);
+  EXPECT_TRUE(gate.ShouldRender(0));
+  EXPECT_TRUE(gate.ShouldRender(-1));
+  EXPECT_FALSE(gate.ShouldRender(1000));
+}
+
+TEST(FrameRateGateTest, HiddenOrNoVideoRendersNothing) {
+  FrameRateGate gate;
+  gate.SetPolicy(0, false);
+  EXPECT_FALSE(gate.ShouldRender(0));
+  EXPECT_FALSE(gate.ShouldRender(-1));
+  gate.SetPolicy(-1, true);
+  EXPECT_FALSE(gate.ShouldRender(1000000));
+  gate.SetPolicy(0, true);
+  EXPECT_TRUE(gate.ShouldRender(1000001));
+  EXPECT_EQ(gate.skipped(), 3u);
+}
+
+}  // namespace
+}  // namespace pro_video_player
@@ -0,0 +1,148 @@
+#include "hls_decrypt.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace pro_video_player {
+namespace {
+
+const uint8_t kKey[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+
+std::vector<uint8_t> FromHex(const std::string& hex) {
+  std::vector<uint8_t> bytes;
+  for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+    bytes.push_back(static_cast<uint8_t>(std::stoi(hex.substr(i, 2), nullptr, 16)));
+  }
+  return bytes;
+}
+
+// Bytes that aren't start codes or emulation prevention.
+std::vector<uint8_t> Pattern(size_t size, uint8_t seed) {
+  std::vector<uint8_t> bytes(size);
+  for (size_t i = 0; i < size; ++i) bytes[i] = static_cast<uint8_t>(0x10 + (seed + i * 7) % 0xe0);
+  return bytes;
+}
+
+// CBC-decrypts |size| bytes at |offset| starting from |iv|, to build the
+// expected output region by region.
+void DecryptRange(const Aes128& aes, const std::array<uint8_t, 16>& iv, std::vector<uint8_t>* data, size_t offset,
+                  size_t size, uint8_t chain[16] = nullptr) {
+  uint8_t fresh[16];
+  if (chain == nullptr) {
+    std::memcpy(fresh, iv.data(), 16);
+    chain = fresh;
+  }
+  aes.DecryptCbc(data->data() + offset, size, chain);
+}
+
+TEST(HlsDecryptTest, ParsesKeyTags) {
+  HlsKey key;
+  ASSERT_TRUE(ParseHlsKey("METHOD=AES-128,URI=\"https://keys.example/k?a=1,b=2\",IV=0x000102030405060708090A0B0C0D0E0F",
+                          5, &key));
+  EXPECT_EQ(key.method, HlsKeyMethod::kAes128);
+  EXPECT_EQ(key.uri, "https://keys.example/k?a=1,b=2");
+  EXPECT_EQ(std::vector<uint8_t>(key.iv.begin(), key.iv.end()), FromHex("000102030405060708090a0b0c0d0e0f"));
+
+  // Without an IV, the media sequence number
+  ASSERT_TRUE(ParseHlsKey("METHOD=SAMPLE-AES,URI=\"key.bin\",KEYFORMAT=\"identity\"", 0x0102, &key));
+  EXPECT_EQ(key.method, HlsKeyMethod::kSampleAes);
+  EXPECT_EQ(std::vector<uint8_t>(key.iv.begin(), key.iv.end()), FromHex("00000000000000000000000000000102"));
+
+  ASSERT_TRUE(ParseHlsKey("METHOD=NONE", 0, &key));
+  EXPECT_EQ(key.method, HlsKeyMethod::kNone);
+
+  EXPECT_FALSE(ParseHlsKey("METHOD=SAMPLE-AES-CTR,URI=\"k\"", 0, &key));
+  EXPECT_FALSE(ParseHlsKey("METHOD=SAMPLE-AES,URI=\"skd://k\",KEYFORMAT=\"com.apple.streamingkeydelivery\"", 0, &key));
+  EXPECT_FALSE(ParseHlsKey("METHOD=AES-128", 0, &key));
+  EXPECT_FALSE(ParseHlsKey("METHOD=AES-128,URI=\"k\",IV=0xZZ", 0, &key));
+}
+
+TEST(HlsDecryptTest, DecryptsAes128SegmentsAndStripsPadding) {
+  const Aes128 aes(kKey);
+  const auto iv = HlsSequenceIv(7);
+  // openssl enc -aes-128-cbc -K 000102..0f -iv 00..07
+  const auto ciphertext = FromHex(
+      "a8d2f3b8e2211143d890da56867e358a0cbf9a47ef3a6fd1f78fc9f159ff10cc"
+      "bf0362acaaf7d629ae3c38db7dc6f56b");
+  auto data = ciphertext;
+  const int64_t size = DecryptAes128Segment(aes, iv, data.data(), data.size());
+  ASSERT_EQ(size, 36);
+  EXPECT_EQ(std::string(data.begin(), data.begin() + size), "hls segment payload, 36 bytes long!!");
+
+  // A wrong key fails the padding check, and so does a torn segment
+  uint8_t other_key[16] = {};
+  data = ciphertext;
+  EXPECT_EQ(DecryptAes128Segment(Aes128(other_key), iv, data.data(), data.size()), -1);
+  data = ciphertext;
+  EXPECT_EQ(DecryptAes128Segment(aes, iv, data.data(), data.size() - 1), -1);
+}
+
+TEST(HlsDecryptTest, SampleAesAudioKeepsHeadersAndLeadersClear) {
+  const Aes128 aes(kKey);
+  const auto iv = HlsSequenceIv(3);
+  // Two ADTS frames without CRC: 7-byte header, then 16 clear bytes and
+  // the whole blocks after them
+  std::vector<uint8_t> stream;
+  const size_t payloads[] = {16 + 48 + 5, 10};
+  for (const size_t payload : payloads) {
+    const size_t frame = 7 + payload;
+    const uint8_t header[7] = {0xff, 0xf1, 0x50, static_cast<uint8_t>(0x80 | (frame >> 11)),
+                               static_cast<uint8_t>(frame >> 3), static_cast<uint8_t>((frame & 7) << 5 | 0x1f), 0xfc};
+    stream.insert(stream.end(), header, header + 7);
+    const auto body = Pattern(payload, static_cast<uint8_t>(payload));
+    stream.insert(stream.end(), body.begin(), body.end());
+  }
+  auto expected = stream;
+  DecryptRange(aes, iv, &expected, 7 + 16, 48);
+
+  DecryptSampleAesAdts(aes, iv, stream.data(), stream.size());
+  EXPECT_EQ(stream, expected);
+}
+
+TEST(HlsDecryptTest, SampleAesVideoDecryptsOneBlockInTenOfSlices) {
+  const Aes128 aes(kKey);
+  const auto iv = HlsSequenceIv(9);
+  const uint8_t start_code[4] = {0, 0, 0, 1};
+
+  // SPS (left alone), an IDR slice with an emulation prevention byte in
+  // its encrypted part, and a short non-IDR slice (too short to encrypt)
+  std::vector<uint8_t> sps = {0x67, 0x42, 0x00, 0x1e, 0x00, 0x00, 0x03, 0x01};
+  std::vector<uint8_t> idr = Pattern(400, 1);
+  idr[0] = 0x65;
+  const size_t prevention = 32 + 5;
+  idr[prevention - 2] = 0;
+  idr[prevention - 1] = 0;
+  idr[prevention] = 0x03;
+  std::vector<uint8_t> small = Pattern(40, 2);
+  small[0] = 0x41;
+
+  std::vector<uint8_t> stream;
+  for (const auto* nal : {&sps, &idr, &small}) {
+    stream.insert(stream.end(), start_code, start_code + 4);
+    stream.insert(stream.end(), nal->begin(), nal->end());
+  }
+
+  // Expected: the IDR slice without its 0x03, then blocks at 32, 192 and
+  // 352 (400 - 1 bytes: one more block only if more than 16 follow it)
+  std::vector<uint8_t> slice = idr;
+  slice.erase(slice.begin() + prevention);
+  uint8_t chain[16];
+  std::memcpy(chain, iv.data(), 16);
+  for (size_t offset = 32; offset + 16 < slice.size(); offset += 160) DecryptRange(aes, iv, &slice, offset, 16, chain);
+  std::vector<uint8_t> expected;
+  for (const auto* nal : {&sps, &slice, &small}) {
+    expected.insert(expected.end(), start_code, start_code + 4);
+    expected.insert(expected.end(), nal->begin(), nal->end());
+  }
+
+  const size_t size = DecryptSampleAesH264(aes, iv, stream.data(), stream.size());
+  ASSERT_EQ(size, expected.size());
+  stream.resize(size);
+  EXPECT_EQ(stream, expected);
+}
+
+}  // namespace
+}  // namespace pro_video_player
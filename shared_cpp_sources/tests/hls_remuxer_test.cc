@@ -0,0 +1,116 @@
+#include "hls_remuxer.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "synthetic_media.h"
+
+namespace pro_video_player {
+namespace {
+
+using testing::SyntheticMedia;
+
+class HlsRemuxerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char path[] = "/tmp/pvp-hls-remuxer-XXXXXX";
+    ASSERT_NE(mkdtemp(path), nullptr);
+    directory_ = path;
+  }
+
+  void TearDown() override { std::filesystem::remove_all(directory_); }
+
+  std::string WriteFile(const std::string& name, const std::string& bytes) {
+    const std::string path = directory_ + "/" + name;
+    std::ofstream(path, std::ios::binary) << bytes;
+    return path;
+  }
+
+  std::unique_ptr<HlsRemuxer> Open(const std::string& path, int64_t target_duration_ms) {
+    HlsRemuxer::Options options;
+    options.target_duration_ms = target_duration_ms;
+    std::string error;
+    auto remuxer = HlsRemuxer::Open(path, options, &error);
+    EXPECT_TRUE(remuxer) << error;
+    return remuxer;
+  }
+
+  // The mdat payload of segment |index|, read from the mapped source.
+  static std::string Payload(const HlsRemuxer& remuxer, size_t index) {
+    Fmp4Fragment fragment;
+    std::string error;
+    EXPECT_TRUE(remuxer.Segment(index, &fragment, &error)) << error;
+    std::string payload;
+    for (const auto& range : fragment.payload) {
+      payload.append(reinterpret_cast<const char*>(remuxer.data() + range.offset), static_cast<size_t>(range.size));
+    }
+    return payload;
+  }
+
+  // Video frames of GOPs [first, last), then the audio alongside them.
+  static std::string Expected(const SyntheticMedia& media, int first, int last) {
+    std::string bytes;
+    for (int i = first * testing::kSyntheticFramesPerGop; i < last * testing::kSyntheticFramesPerGop; ++i) {
+      bytes += media.video[i].data;
+    }
+    for (int i = first * testing::kSyntheticAudioPerGop; i < last * testing::kSyntheticAudioPerGop; ++i) {
+      bytes += media.audio[i].data;
+    }
+    return bytes;
+  }
+
+  std::string directory_;
+};
+
+TEST_F(HlsRemuxerTest, CutsAtKeyframesPastTheTargetDuration) {
+  const SyntheticMedia media = testing::BuildSyntheticMp4();
+  const auto remuxer = Open(WriteFile("movie.mp4", media.bytes), 2000);
+  ASSERT_TRUE(remuxer);
+  ASSERT_EQ(remuxer->segment_count(), 2u);
+  EXPECT_EQ(remuxer->segment_start_us(1), 2000000);
+  EXPECT_EQ(remuxer->segment_duration_us(1), 1000000);
+  EXPECT_EQ(remuxer->playlist(),
+            "#EXTM3U\n#EXT-X-VERSION:7\n#EXT-X-TARGETDURATION:2\n#EXT-X-MEDIA-SEQUENCE:0\n"
+            "#EXT-X-PLAYLIST-TYPE:VOD\n#EXT-X-INDEPENDENT-SEGMENTS\n#EXT-X-MAP:URI=\"init.mp4\"\n"
+            "#EXTINF:2.000,\nseg0.m4s\n#EXTINF:1.000,\nseg1.m4s\n#EXT-X-ENDLIST\n");
+  EXPECT_EQ(remuxer->init_segment().substr(4, 4), "ftyp");
+}
+
+TEST_F(HlsRemuxerTest, SegmentsSliceTheSourceFile) {
+  const SyntheticMedia media = testing::BuildSyntheticMp4();
+  const auto remuxer = Open(WriteFile("movie.mp4", media.bytes), 1000);
+  ASSERT_TRUE(remuxer);
+  ASSERT_EQ(remuxer->segment_count(), 3u);
+  for (int i = 0; i < 3; ++i) EXPECT_EQ(Payload(*remuxer, i), Expected(media, i, i + 1)) << i;
+
+  Fmp4Fragment fragment;
+  std::string error;
+  EXPECT_FALSE(remuxer->Segment(3, &fragment, &error));
+  EXPECT_EQ(error, "No segment 3");
+}
+
+TEST_F(HlsRemuxerTest, RemuxesMatroska) {
+  const SyntheticMedia media = testing::BuildSyntheticMkv();
+  const auto remuxer = Open(WriteFile("movie.mkv", media.bytes), 1500);
+  ASSERT_TRUE(remuxer);
+  ASSERT_EQ(remuxer->segment_count(), 2u);
+  EXPECT_EQ(Payload(*remuxer, 0), Expected(media, 0, 2));
+  EXPECT_EQ(Payload(*remuxer, 1), Expected(media, 2, 3));
+  EXPECT_NE(remuxer->playlist().find("#EXTINF:2.000,\nseg0.m4s\n#EXTINF:1.000,\nseg1.m4s\n"), std::string::npos);
+}
+
+TEST_F(HlsRemuxerTest, ReportsFilesItCantOpen) {
+  std::string error;
+  EXPECT_FALSE(HlsRemuxer::Open(directory_ + "/missing.mp4", {}, &error));
+  EXPECT_NE(error.find("missing.mp4"), std::string::npos);
+  EXPECT_FALSE(HlsRemuxer::Open(WriteFile("empty.mp4", ""), {}, &error));
+  EXPECT_FALSE(HlsRemuxer::Open(WriteFile("notes.txt", "plain text, not media"), {}, &error));
+  EXPECT_EQ(error, "Not an MP4 or Matroska file");
+}
+
+}  // namespace
+}  // namespace pro_video_player
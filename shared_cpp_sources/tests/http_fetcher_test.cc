@@ -0,0 +1,221 @@
+#include "http_fetcher.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "local_http_server.h"
+#include "recording_event_sink.h"
+
+namespace pro_video_player {
+namespace {
+
+using ::pro_video_player::testing::LocalHttpServer;
+using ::pro_video_player::testing::WaitUntil;
+
+// Collects responses from the fetcher thread.
+class Responses {
+ public:
+  HttpFetcher::Callback Add() {
+    return [this](const HttpResponse& response) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      responses_.push_back(response);
+    };
+  }
+
+  bool WaitFor(size_t count) {
+    return WaitUntil([&]() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return responses_.size() >= count;
+    });
+  }
+
+  std::vector<HttpResponse> Get() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return responses_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<HttpResponse> responses_;
+};
+
+// Holds requests for /block until released.
+class Gate {
+ public:
+  void Wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    open_cv_.wait(lock, [&]() { return open_; });
+  }
+  void Open() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      open_ = true;
+    }
+    open_cv_.notify_all();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable open_cv_;
+  bool open_ = false;
+};
+
+LocalHttpServer::Response Echo(const LocalHttpServer::Request& request) {
+  LocalHttpServer::Response response;
+  response.body = "body of " + request.path;
+  response.headers["X-Path"] = request.path;
+  return response;
+}
+
+TEST(HttpFetcherTest, SequentialSegmentsReuseOneConnection) {
+  LocalHttpServer server(Echo);
+  HttpFetcher fetcher;
+  Responses responses;
+  for (int i = 0; i < 5; ++i) {
+    fetcher.Fetch(MakeHttpRequest(MediaSource(), server.url("/seg" + std::to_string(i) + ".ts")),
+                  responses.Add());
+    ASSERT_TRUE(responses.WaitFor(i + 1));
+  }
+
+  const auto results = responses.Get();
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_TRUE(results[i].ok()) << results[i].error;
+    const std::string body(results[i].body.begin(), results[i].body.end());
+    EXPECT_EQ(body, "body of /seg" + std::to_string(i) + ".ts");
+    EXPECT_EQ(results[i].headers.at("x-path"), "/seg" + std::to_string(i) + ".ts");
+    EXPECT_EQ(results[i].new_connection, i == 0);
+  }
+  EXPECT_EQ(server.connections(), 1);
+  EXPECT_EQ(fetcher.stats().connections_opened, 1u);
+  EXPECT_EQ(fetcher.stats().requests, 5u);
+}
+
+TEST(HttpFetcherTest, AppliesSourceHeadersAndRange) {
+  LocalHttpServer server(Echo);
+  HttpFetcher::Options options;
+  options.default_headers = {{"User-Agent", "pro_video_player"}, {"X-Default", "kept"}};
+  HttpFetcher fetcher(options);
+  MediaSource source;
+  source.headers = {{"Authorization", "Bearer token"}, {"user-agent", "custom-agent"}};
+  HttpRequest request = MakeHttpRequest(source, server.url("/init.mp4"));
+  request.range_start = 100;
+  request.range_end = 199;
+  Responses responses;
+  fetcher.Fetch(request, responses.Add());
+  ASSERT_TRUE(responses.WaitFor(1));
+
+  const auto seen = server.requests();
+  ASSERT_EQ(seen.size(), 1u);
+  EXPECT_EQ(seen[0].headers.at("authorization"), "Bearer token");
+  EXPECT_EQ(seen[0].headers.at("user-agent"), "custom-agent");
+  EXPECT_EQ(seen[0].headers.at("x-default"), "kept");
+  EXPECT_EQ(seen[0].headers.at("range"), "bytes=100-199");
+}
+
+TEST(HttpFetcherTest, QueuedRequestsStartByPriority) {
+  Gate gate;
+  LocalHttpServer server([&](const LocalHttpServer::Request& request) {
+    if (request.path == "/block") gate.Wait();
+    return Echo(request);
+  });
+  HttpFetcher::Options options;
+  options.max_requests_per_origin = 1;
+  HttpFetcher fetcher(options);
+  Responses responses;
+  fetcher.Fetch(MakeHttpRequest(MediaSource(), server.url("/block")), responses.Add());
+  ASSERT_TRUE(WaitUntil([&]() { return server.requests().size() == 1; }));
+
+  fetcher.Fetch(MakeHttpRequest(MediaSource(), server.url("/prefetch"), FetchPriority::kPrefetch),
+                responses.Add());
+  fetcher.Fetch(MakeHttpRequest(MediaSource(), server.url("/next"), FetchPriority::kNextSegment),
+                responses.Add());
+  fetcher.Fetch(MakeHttpRequest(MediaSource(), server.url("/current-1"), FetchPriority::kCurrentSegment),
+                responses.Add());
+  fetcher.Fetch(MakeHttpRequest(MediaSource(), server.url("/current-2"), FetchPriority::kCurrentSegment),
+                responses.Add());
+  gate.Open();
+  ASSERT_TRUE(responses.WaitFor(5));
+
+  std::vector<std::string> order;
+  for (const auto& request : server.requests()) order.push_back(request.path);
+  EXPECT_EQ(order, (std::vector<std::string>{"/block", "/current-1", "/current-2", "/next", "/prefetch"}));
+  EXPECT_EQ(server.connections(), 1);
+}
+
+TEST(HttpFetcherTest, CancelledRequestsNeverComplete) {
+  Gate gate;
+  LocalHttpServer server([&](const LocalHttpServer::Request& request) {
+    if (request.path == "/block") gate.Wait();
+    return Echo(request);
+  });
+  HttpFetcher::Options options;
+  options.max_requests_per_origin = 1;
+  HttpFetcher fetcher(options);
+  Responses responses;
+  const auto running = fetcher.Fetch(MakeHttpRequest(MediaSource(), server.url("/block")), responses.Add());
+  ASSERT_TRUE(WaitUntil([&]() { return server.requests().size() == 1; }));
+  const auto queued = fetcher.Fetch(MakeHttpRequest(MediaSource(), server.url("/queued")), responses.Add());
+  EXPECT_TRUE(fetcher.Cancel(queued));
+  EXPECT_TRUE(fetcher.Cancel(running));
+  EXPECT_FALSE(fetcher.Cancel(running));
+  gate.Open();
+
+  fetcher.Fetch(MakeHttpRequest(MediaSource(), server.url("/after")), responses.Add());
+  ASSERT_TRUE(responses.WaitFor(1));
+  const auto results = responses.Get();
+  ASSERT_EQ(results.size(), 1u);
+  EXPECT_EQ(results[0].headers.at("x-path"), "/after");
+  for (const auto& request : server.requests()) EXPECT_NE(request.path, "/queued");
+}
+
+TEST(HttpFetcherTest, RateCapChangesUntilCompletion) {
+  Gate gate;
+  LocalHttpServer server([&](const LocalHttpServer::Request& request) {
+    if (request.path == "/block") gate.Wait();
+    return Echo(request);
+  });
+  HttpFetcher::Options options;
+  options.max_requests_per_origin = 1;
+  HttpFetcher fetcher(options);
+  Responses responses;
+  HttpRequest request = MakeHttpRequest(MediaSource(), server.url("/block"));
+  request.max_bytes_per_second = 1;
+  const auto running = fetcher.Fetch(std::move(request), responses.Add());
+  ASSERT_TRUE(WaitUntil([&]() { return server.requests().size() == 1; }));
+  request = MakeHttpRequest(MediaSource(), server.url("/queued"));
+  request.max_bytes_per_second = 1;
+  const auto queued = fetcher.Fetch(std::move(request), responses.Add());
+  // Lifted before either body arrives, so both finish promptly
+  EXPECT_TRUE(fetcher.SetMaxBytesPerSecond(running, 0));
+  EXPECT_TRUE(fetcher.SetMaxBytesPerSecond(queued, 0));
+  gate.Open();
+
+  ASSERT_TRUE(responses.WaitFor(2));
+  for (const auto& response : responses.Get()) EXPECT_TRUE(response.ok()) << response.error;
+  EXPECT_FALSE(fetcher.SetMaxBytesPerSecond(running, 1));
+  EXPECT_FALSE(fetcher.SetMaxBytesPerSecond(queued, 1));
+}
+
+TEST(HttpFetcherTest, ReportsConnectionFailures) {
+  std::string url;
+  {
+    LocalHttpServer server(Echo);
+    url = server.url("/gone");
+  }
+  HttpFetcher fetcher;
+  Responses responses;
+  fetcher.Fetch(MakeHttpRequest(MediaSource(), url), responses.Add());
+  ASSERT_TRUE(responses.WaitFor(1));
+  const auto result = responses.Get()[0];
+  EXPECT_FALSE(result.ok());
+  EXPECT_EQ(result.status, 0);
+  EXPECT_FALSE(result.error.empty());
+}
+
+}  // namespace
+}  // namespace pro_video_player
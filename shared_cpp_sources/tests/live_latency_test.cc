@@ -0,0 +1,83 @@
+#include "live_latency.h"
+
+#include <gtest/gtest.h>
+
+namespace pro_video_player {
+namespace {
+
+LiveLatencyController MakeController() {
+  LiveLatencyController::Options options;
+  options.target_ms = 3000;
+  return LiveLatencyController(options);
+}
+
+TEST(LiveLatencyControllerTest, RateStaysWithinBounds) {
+  LiveLatencyController controller = MakeController();
+  EXPECT_DOUBLE_EQ(controller.Update(9000, 8000).rate, LiveLatencyController::kMaxRate);
+  controller.Reset();
+  EXPECT_DOUBLE_EQ(controller.Update(0, 0).rate, LiveLatencyController::kMinRate);
+  controller.Reset();
+  // Half the full-correction error: half the nudge
+  EXPECT_DOUBLE_EQ(controller.Update(4000, 4000).rate, 1.025);
+  controller.Reset();
+  EXPECT_DOUBLE_EQ(controller.Update(2000, 2000).rate, 0.975);
+}
+
+TEST(LiveLatencyControllerTest, DeadBandWithHysteresis) {
+  LiveLatencyController controller = MakeController();
+  EXPECT_DOUBLE_EQ(controller.Update(3200, 3000).rate, 1.0);
+  controller.Reset();
+  EXPECT_GT(controller.Update(3600, 3000).rate, 1.0);
+  // Back within the band, but not within half of it: keeps correcting
+  for (int i = 0; i < 20; ++i) controller.Update(3200, 3000);
+  EXPECT_NEAR(controller.latency_ms(), 3200, 10);
+  EXPECT_DOUBLE_EQ(controller.rate(), 1.005);
+  for (int i = 0; i < 20; ++i) controller.Update(3000, 3000);
+  EXPECT_DOUBLE_EQ(controller.rate(), 1.0);
+}
+
+TEST(LiveLatencyControllerTest, NoSpeedUpOnAThinBuffer) {
+  LiveLatencyController controller = MakeController();
+  EXPECT_DOUBLE_EQ(controller.Update(6000, 500).rate, 1.0);
+  EXPECT_GT(controller.Update(6000, 1500).rate, 1.0);
+  // Unknown buffer doesn't hold catching up back
+  controller.Reset();
+  EXPECT_GT(controller.Update(6000, -1).rate, 1.0);
+}
+
+TEST(LiveLatencyControllerTest, JumpsWhenFarBehind) {
+  LiveLatencyController controller = MakeController();
+  const LiveLatencyController::Decision decision = controller.Update(20000, 15000);
+  EXPECT_EQ(decision.seek_by_ms, 17000);
+  EXPECT_DOUBLE_EQ(decision.rate, 1.0);
+  EXPECT_EQ(controller.latency_ms(), -1);
+  // Unknown latency changes nothing
+  EXPECT_EQ(controller.Update(-1, 3000).seek_by_ms, 0);
+}
+
+TEST(LiveLatencyControllerTest, RetargetKeepsUserSeekPosition) {
+  LiveLatencyController controller = MakeController();
+  controller.Retarget();
+  // The user went 30 s back: stay there rather than seek or speed up
+  const LiveLatencyController::Decision decision = controller.Update(33000, 20000);
+  EXPECT_EQ(decision.seek_by_ms, 0);
+  EXPECT_DOUBLE_EQ(decision.rate, 1.0);
+  EXPECT_EQ(controller.target_ms(), 33000);
+  // Back at the edge: never closer than the configured target
+  controller.Retarget();
+  controller.Update(1000, 1000);
+  EXPECT_EQ(controller.target_ms(), 3000);
+}
+
+TEST(LiveLatencyControllerTest, RestoreTargetCatchesUpAgain) {
+  LiveLatencyController controller = MakeController();
+  controller.Retarget();
+  controller.Update(6000, 5000);
+  EXPECT_EQ(controller.target_ms(), 6000);
+  controller.RestoreTarget();
+  EXPECT_EQ(controller.target_ms(), 3000);
+  EXPECT_GT(controller.Update(6000, 5000).rate, 1.0);
+}
+
+}  // namespace
+}  // namespace pro_video_player
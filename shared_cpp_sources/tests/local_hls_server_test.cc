@@ -0,0 +1,187 @@
+#include "local_hls_server.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "synthetic_media.h"
+
+namespace pro_video_player {
+namespace {
+
+struct Reply {
+  int status = 0;
+  std::string head;
+  std::string body;
+};
+
+// One request on a fresh connection; reads until the server closes it.
+Reply Request(int port, const std::string& method, const std::string& path, const std::string& headers = "") {
+  Reply reply;
+  const int fd = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons(static_cast<uint16_t>(port));
+  if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+    close(fd);
+    return reply;
+  }
+  const std::string request = method + " " + path + " HTTP/1.1\r\nHost: 127.0.0.1\r\nConnection: close\r\n" +
+                              headers + "\r\n";
+  send(fd, request.data(), request.size(), MSG_NOSIGNAL);
+  std::string response;
+  char chunk[4096];
+  ssize_t received;
+  while ((received = recv(fd, chunk, sizeof(chunk), 0)) > 0) response.append(chunk, static_cast<size_t>(received));
+  close(fd);
+  const size_t end = response.find("\r\n\r\n");
+  if (response.size() < 12 || end == std::string::npos) return reply;
+  reply.status = std::atoi(response.substr(9, 3).c_str());
+  reply.head = response.substr(0, end);
+  reply.body = response.substr(end + 4);
+  return reply;
+}
+
+// "/<token>/index.m3u8" of a published URL.
+std::string PathOf(const std::string& url) { return url.substr(url.find('/', 7)); }
+
+std::string Sibling(const std::string& playlist_path, const std::string& name) {
+  return playlist_path.substr(0, playlist_path.rfind('/') + 1) + name;
+}
+
+class LocalHlsServerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char path[] = "/tmp/pvp-hls-server-XXXXXX";
+    ASSERT_NE(mkdtemp(path), nullptr);
+    directory_ = path;
+    media_ = testing::BuildSyntheticMp4();
+    file_ = directory_ + "/movie.mp4";
+    std::ofstream(file_, std::ios::binary) << media_.bytes;
+  }
+
+  void TearDown() override { std::filesystem::remove_all(directory_); }
+
+  std::string directory_;
+  std::string file_;
+  testing::SyntheticMedia media_;
+};
+
+TEST_F(LocalHlsServerTest, ServesThePresentation) {
+  LocalHlsServer server;
+  EXPECT_EQ(server.port(), 0);
+  std::string error;
+  HlsRemuxer::Options options;
+  options.target_duration_ms = 1000;
+  const std::string url = server.Publish(file_, options, &error);
+  ASSERT_FALSE(url.empty()) << error;
+  EXPECT_EQ(url.compare(0, 17, "http://127.0.0.1:"), 0);
+  const std::string path = PathOf(url);
+  const auto remuxer = HlsRemuxer::Open(file_, options, &error);
+  ASSERT_TRUE(remuxer);
+
+  Reply reply = Request(server.port(), "GET", path);
+  EXPECT_EQ(reply.status, 200);
+  EXPECT_NE(reply.head.find("Content-Type: application/vnd.apple.mpegurl"), std::string::npos);
+  EXPECT_EQ(reply.body, remuxer->playlist());
+
+  reply = Request(server.port(), "GET", Sibling(path, "init.mp4"));
+  EXPECT_EQ(reply.status, 200);
+  EXPECT_EQ(reply.body, remuxer->init_segment());
+
+  Fmp4Fragment fragment;
+  ASSERT_TRUE(remuxer->Segment(1, &fragment, &error));
+  std::string segment = fragment.header;
+  for (const auto& range : fragment.payload) {
+    segment += media_.bytes.substr(static_cast<size_t>(range.offset), static_cast<size_t>(range.size));
+  }
+  reply = Request(server.port(), "GET", Sibling(path, "seg1.m4s"));
+  EXPECT_EQ(reply.status, 200);
+  EXPECT_NE(reply.head.find("Content-Type: video/mp4"), std::string::npos);
+  EXPECT_EQ(reply.body, segment);
+
+  reply = Request(server.port(), "HEAD", Sibling(path, "seg1.m4s"));
+  EXPECT_EQ(reply.status, 200);
+  EXPECT_NE(reply.head.find("Content-Length: " + std::to_string(segment.size())), std::string::npos);
+  EXPECT_TRUE(reply.body.empty());
+
+  EXPECT_EQ(Request(server.port(), "GET", Sibling(path, "seg3.m4s")).status, 404);
+  EXPECT_EQ(Request(server.port(), "GET", "/0123456789abcdef/index.m3u8").status, 404);
+  EXPECT_EQ(Request(server.port(), "POST", path).status, 405);
+
+  server.Unpublish(url);
+  EXPECT_EQ(Request(server.port(), "GET", path).status, 404);
+}
+
+TEST_F(LocalHlsServerTest, ServesByteRanges) {
+  LocalHlsServer server;
+  std::string error;
+  const std::string url = server.Publish(file_, {}, &error);
+  ASSERT_FALSE(url.empty()) << error;
+  const std::string segment_path = Sibling(PathOf(url), "seg0.m4s");
+  const Reply whole = Request(server.port(), "GET", segment_path);
+  ASSERT_EQ(whole.status, 200);
+  const std::string& body = whole.body;
+  const std::string size = std::to_string(body.size());
+
+  // Across the moof header and into the sample bytes
+  Reply reply = Request(server.port(), "GET", segment_path, "Range: bytes=100-4099\r\n");
+  EXPECT_EQ(reply.status, 206);
+  EXPECT_NE(reply.head.find("Content-Range: bytes 100-4099/" + size), std::string::npos);
+  EXPECT_EQ(reply.body, body.substr(100, 4000));
+
+  reply = Request(server.port(), "GET", segment_path, "Range: bytes=5000-\r\n");
+  EXPECT_EQ(reply.status, 206);
+  EXPECT_EQ(reply.body, body.substr(5000));
+
+  reply = Request(server.port(), "GET", segment_path, "Range: bytes=-10\r\n");
+  EXPECT_EQ(reply.status, 206);
+  EXPECT_EQ(reply.body, body.substr(body.size() - 10));
+
+  reply = Request(server.port(), "GET", segment_path, "Range: bytes=" + size + "-\r\n");
+  EXPECT_EQ(reply.status, 416);
+  EXPECT_NE(reply.head.find("Content-Range: bytes */" + size), std::string::npos);
+
+  // Several ranges: the whole body
+  reply = Request(server.port(), "GET", segment_path, "Range: bytes=0-1,5-6\r\n");
+  EXPECT_EQ(reply.status, 200);
+  EXPECT_EQ(reply.body, body);
+}
+
+TEST_F(LocalHlsServerTest, KeepsConnectionsAlive) {
+  LocalHlsServer server;
+  std::string error;
+  const std::string path = PathOf(server.Publish(file_, {}, &error));
+  const int fd = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons(static_cast<uint16_t>(server.port()));
+  ASSERT_EQ(connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+  // Two pipelined requests on one connection
+  const std::string request = "GET " + path + " HTTP/1.1\r\nHost: x\r\n\r\n";
+  const std::string both = request + request;
+  send(fd, both.data(), both.size(), MSG_NOSIGNAL);
+  std::string response;
+  char chunk[4096];
+  while (response.find("#EXT-X-ENDLIST\n", response.find("#EXT-X-ENDLIST\n") + 1) == std::string::npos) {
+    const ssize_t received = recv(fd, chunk, sizeof(chunk), 0);
+    ASSERT_GT(received, 0);
+    response.append(chunk, static_cast<size_t>(received));
+  }
+  EXPECT_NE(response.find("Connection: keep-alive"), std::string::npos);
+  // The destructor closes the idle connection
+  close(fd);
+}
+
+}  // namespace
+}  // namespace pro_video_player
@@ -0,0 +1,168 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_TESTS_LOCAL_HTTP_SERVER_H_
+#define PRO_VIDEO_PLAYER_SHARED_TESTS_LOCAL_HTTP_SERVER_H_
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pro_video_player {
+namespace testing {
+
+// Minimal HTTP/1.1 server on 127.0.0.1 standing in for a CDN: keep-alive,
+// GET only, one thread per connection. Records every request with the
+// connection it arrived on, so tests can check pooling and ordering.
+class LocalHttpServer {
+ public:
+  struct Request {
+    int connection = 0;  // 1-based, in accept order
+    std::string method;
+    std::string path;
+    std::map<std::string, std::string> headers;  // names lower-cased
+  };
+  struct Response {
+    int status = 200;
+    std::string body;
+    std::map<std::string, std::string> headers;
+  };
+  // Runs on the connection's thread; may block.
+  using Handler = std::function<Response(const Request& request)>;
+
+  explicit LocalHttpServer(Handler handler) : handler_(std::move(handler)) {
+    listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    const int yes = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+    socklen_t length = sizeof(address);
+    getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&address), &length);
+    port_ = ntohs(address.sin_port);
+    listen(listen_fd_, 16);
+    accept_thread_ = std::thread([this]() { AcceptLoop(); });
+  }
+
+  ~LocalHttpServer() {
+    stopping_ = true;
+    shutdown(listen_fd_, SHUT_RDWR);
+    accept_thread_.join();
+    close(listen_fd_);
+    std::vector<std::thread> threads;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (int fd : client_fds_) shutdown(fd, SHUT_RDWR);
+      threads.swap(threads_);
+    }
+    for (auto& thread : threads) thread.join();
+  }
+
+  std::string url(const std::string& path) const {
+    return "http://127.0.0.1:" + std::to_string(port_) + path;
+  }
+
+  int connections() const { return connections_.load(); }
+
+  std::vector<Request> requests() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return requests_;
+  }
+
+ private:
+  void AcceptLoop() {
+    while (!stopping_) {
+      const int fd = accept(listen_fd_, nullptr, nullptr);
+      if (fd < 0) return;
+      const int connection = ++connections_;
+      std::lock_guard<std::mutex> lock(mutex_);
+      client_fds_.push_back(fd);
+      threads_.emplace_back([this, fd, connection]() { Serve(fd, connection); });
+    }
+  }
+
+  void Serve(int fd, int connection) {
+    std::string buffer;
+    char chunk[4096];
+    for (;;) {
+      size_t end;
+      while ((end = buffer.find("\r\n\r\n")) == std::string::npos) {
+        const ssize_t received = recv(fd, chunk, sizeof(chunk), 0);
+        if (received <= 0) return Close(fd);
+        buffer.append(chunk, static_cast<size_t>(received));
+      }
+      Request request = Parse(buffer.substr(0, end), connection);
+      buffer.erase(0, end + 4);
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        requests_.push_back(request);
+      }
+      const Response response = handler_(request);
+      std::string out = "HTTP/1.1 " + std::to_string(response.status) + " X\r\n";
+      for (const auto& header : response.headers) out += header.first + ": " + header.second + "\r\n";
+      out += "Content-Length: " + std::to_string(response.body.size()) + "\r\n\r\n" + response.body;
+      if (send(fd, out.data(), out.size(), MSG_NOSIGNAL) < 0) return Close(fd);
+      const auto connection_header = request.headers.find("connection");
+      if (connection_header != request.headers.end() && connection_header->second == "close") {
+        return Close(fd);
+      }
+    }
+  }
+
+  void Close(int fd) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    client_fds_.erase(std::remove(client_fds_.begin(), client_fds_.end(), fd), client_fds_.end());
+    close(fd);
+  }
+
+  static Request Parse(const std::string& head, int connection) {
+    Request request;
+    request.connection = connection;
+    size_t line_end = head.find("\r\n");
+    const std::string request_line = head.substr(0, line_end);
+    const size_t first_space = request_line.find(' ');
+    const size_t second_space = request_line.find(' ', first_space + 1);
+    request.method = request_line.substr(0, first_space);
+    request.path = request_line.substr(first_space + 1, second_space - first_space - 1);
+    while (line_end != std::string::npos) {
+      const size_t start = line_end + 2;
+      line_end = head.find("\r\n", start);
+      const std::string line = head.substr(start, line_end == std::string::npos ? std::string::npos : line_end - start);
+      const size_t colon = line.find(':');
+      if (colon == std::string::npos) continue;
+      std::string name = line.substr(0, colon);
+      std::transform(name.begin(), name.end(), name.begin(),
+                     [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+      size_t value = colon + 1;
+      while (value < line.size() && line[value] == ' ') ++value;
+      request.headers[name] = line.substr(value);
+    }
+    return request;
+  }
+
+  Handler handler_;
+  int listen_fd_ = -1;
+  int port_ = 0;
+  std::atomic<bool> stopping_{false};
+  std::atomic<int> connections_{0};
+  std::thread accept_thread_;
+  mutable std::mutex mutex_;
+  std::vector<int> client_fds_;
+  std::vector<std::thread> threads_;
+  std::vector<Request> requests_;
+};
+
+}  // namespace testing
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_TESTS_LOCAL_HTTP_SERVER_H_
@@ -0,0 +1,61 @@
+#include "media_clock.h"
+
+#include <gtest/gtest.h>
+
+namespace pro_video_player {
+namespace {
+
+class MediaClockTest : public ::testing::Test {
+ protected:
+  int64_t now_us_ = 1000000;
+  MediaClock clock_{[this]() { return now_us_; }};
+
+  void Advance(int64_t ms) { now_us_ += ms * 1000; }
+};
+
+TEST_F(MediaClockTest, StaysAtAnchorWhileStopped) {
+  clock_.Anchor(5000);
+  Advance(1000);
+  EXPECT_EQ(clock_.PositionMs(), 5000);
+}
+
+TEST_F(MediaClockTest, AdvancesWhileRunning) {
+  clock_.Anchor(1000);
+  clock_.Start();
+  Advance(250);
+  EXPECT_EQ(clock_.PositionMs(), 1250);
+}
+
+TEST_F(MediaClockTest, StopFreezesPosition) {
+  clock_.Start();
+  Advance(400);
+  clock_.Stop();
+  Advance(400);
+  EXPECT_EQ(clock_.PositionMs(), 400);
+  EXPECT_FALSE(clock_.running());
+}
+
+TEST_F(MediaClockTest, RateChangeAppliesFromNow) {
+  clock_.Start();
+  Advance(1000);
+  clock_.SetRate(2.0);
+  Advance(1000);
+  EXPECT_EQ(clock_.PositionMs(), 3000);
+  EXPECT_DOUBLE_EQ(clock_.rate(), 2.0);
+}
+
+TEST_F(MediaClockTest, ClampsToDuration) {
+  clock_.SetDuration(1500);
+  clock_.Anchor(1000);
+  clock_.Start();
+  Advance(5000);
+  EXPECT_EQ(clock_.PositionMs(), 1500);
+}
+
+TEST_F(MediaClockTest, NegativeAnchorClampsToZero) {
+  clock_.Anchor(-20);
+  EXPECT_EQ(clock_.PositionMs(), 0);
+}
+
+}  // namespace
+}  // namespace pro_video_player
@@ -0,0 +1,224 @@
+#include "media_demuxer.h"
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "synthetic_media.h"
+
+namespace pro_video_player {
+namespace {
+
+using testing::SyntheticFrame;
+using testing::SyntheticMedia;
+
+std::unique_ptr<MediaDemuxer> Open(const SyntheticMedia& media) {
+  std::string error;
+  auto demuxer = OpenMediaDemuxer(reinterpret_cast<const uint8_t*>(media.bytes.data()), media.bytes.size(), &error);
+  EXPECT_TRUE(demuxer) << error;
+  return demuxer;
+}
+
+std::vector<std::vector<DemuxedSample>> Read(const MediaDemuxer& demuxer, size_t from, size_t to) {
+  const auto& points = demuxer.sync_points();
+  std::vector<std::vector<DemuxedSample>> samples;
+  std::string error;
+  EXPECT_TRUE(demuxer.ReadSamples(points[from], to < points.size() ? &points[to] : nullptr, &samples, &error))
+      << error;
+  return samples;
+}
+
+// The samples are |frames| [first, first + count), bytes and times.
+void ExpectFrames(const SyntheticMedia& media, const std::vector<DemuxedSample>& samples, uint32_t timescale,
+                  const std::vector<SyntheticFrame>& frames, size_t first, size_t count) {
+  ASSERT_EQ(samples.size(), count);
+  for (size_t i = 0; i < count; ++i) {
+    const auto& frame = frames[first + i];
+    const auto& sample = samples[i];
+    EXPECT_EQ(media.bytes.substr(static_cast<size_t>(sample.offset), sample.size), frame.data) << i;
+    EXPECT_EQ((sample.dts + sample.composition_offset) * 1000 / timescale, frame.pts_ms) << i;
+    EXPECT_EQ(sample.keyframe, frame.keyframe) << i;
+  }
+}
+
+void ExpectSyncPoints(const MediaDemuxer& demuxer) {
+  const auto& points = demuxer.sync_points();
+  ASSERT_EQ(points.size(), 3u);
+  EXPECT_EQ(points[0].time_us, 0);
+  EXPECT_EQ(points[1].time_us, 1000000);
+  EXPECT_EQ(points[2].time_us, 2000000);
+}
+
+TEST(MediaDemuxerTest, Mp4TracksAndSyncPoints) {
+  const SyntheticMedia media = testing::BuildSyntheticMp4();
+  const auto demuxer = Open(media);
+  ASSERT_TRUE(demuxer);
+  ASSERT_EQ(demuxer->tracks().size(), 2u);
+  const auto& video = demuxer->tracks()[0];
+  EXPECT_EQ(video.kind, DemuxedTrackKind::kVideo);
+  EXPECT_EQ(video.fourcc, "avc1");
+  EXPECT_EQ(video.timescale, 1000u);
+  EXPECT_EQ(video.width, 640);
+  EXPECT_EQ(video.height, 360);
+  EXPECT_EQ(video.sample_entry, Mp4VisualSampleEntry("avc1", 640, 360, "avcC", testing::SyntheticAvcConfig()));
+  const auto& audio = demuxer->tracks()[1];
+  EXPECT_EQ(audio.kind, DemuxedTrackKind::kAudio);
+  EXPECT_EQ(audio.fourcc, "mp4a");
+  EXPECT_EQ(audio.language, "fre");
+  EXPECT_EQ(demuxer->duration_us(), 3000000);
+  ExpectSyncPoints(*demuxer);
+}
+
+TEST(MediaDemuxerTest, Mp4SamplesOfARange) {
+  const SyntheticMedia media = testing::BuildSyntheticMp4();
+  const auto demuxer = Open(media);
+  ASSERT_TRUE(demuxer);
+  auto samples = Read(*demuxer, 1, 2);
+  ASSERT_EQ(samples.size(), 2u);
+  // The edit list makes the first frame show at 0
+  ExpectFrames(media, samples[0], 1000, media.video, 10, 10);
+  EXPECT_EQ(samples[0][0].dts, 1000);
+  EXPECT_EQ(samples[0][0].duration, 100u);
+  ExpectFrames(media, samples[1], 1000, media.audio, 20, 20);
+
+  samples = Read(*demuxer, 2, 3);
+  ExpectFrames(media, samples[0], 1000, media.video, 20, 10);
+  ExpectFrames(media, samples[1], 1000, media.audio, 40, 20);
+}
+
+TEST(MediaDemuxerTest, Mp4RejectsSampleTablesBiggerThanTheFile) {
+  SyntheticMedia media = testing::BuildSyntheticMp4();
+  // 1000-byte samples, half as many as there are bytes
+  const size_t stsz = media.bytes.find("stsz");
+  ASSERT_NE(stsz, std::string::npos);
+  media.bytes.replace(stsz + 8, 8, testing::Be(1000, 4) + testing::Be(media.bytes.size() / 2, 4));
+  std::string error;
+  EXPECT_FALSE(
+      OpenMediaDemuxer(reinterpret_cast<const uint8_t*>(media.bytes.data()), media.bytes.size(), &error));
+  EXPECT_EQ(error, "Bad stsz");
+}
+
+TEST(MediaDemuxerTest, RescaleTime) {
+  int64_t out = 0;
+  EXPECT_TRUE(RescaleTime(1500, 1000, 1000000, &out));
+  EXPECT_EQ(out, 1500000);
+  EXPECT_TRUE(RescaleTime(-1, 3, 1000000, &out));
+  EXPECT_EQ(out, -333333);
+  EXPECT_TRUE(RescaleTime(std::numeric_limits<int64_t>::max(), 90000, 1000, &out));
+  EXPECT_EQ(out, std::numeric_limits<int64_t>::max() / 90);
+  EXPECT_FALSE(RescaleTime(std::numeric_limits<int64_t>::max() / 1000, 1, 1000000, &out));
+  EXPECT_FALSE(RescaleTime(std::numeric_limits<int64_t>::min(), 1, 2, &out));
+  EXPECT_FALSE(RescaleTime(1, 0, 1000000, &out));
+}
+
+TEST(MediaDemuxerTest, MkvTracksAndSyncPointsFromCues) {
+  const SyntheticMedia media = testing::BuildSyntheticMkv();
+  const auto demuxer = Open(media);
+  ASSERT_TRUE(demuxer);
+  // The subtitle track is dropped
+  ASSERT_EQ(demuxer->tracks().size(), 2u);
+  const auto& video = demuxer->tracks()[0];
+  EXPECT_EQ(video.fourcc, "avc1");
+  EXPECT_EQ(video.timescale, 1000000u);
+  EXPECT_EQ(video.sample_entry, Mp4VisualSampleEntry("avc1", 640, 360, "avcC", testing::SyntheticAvcConfig()));
+  const auto& audio = demuxer->tracks()[1];
+  EXPECT_EQ(audio.fourcc, "mp4a");
+  EXPECT_EQ(audio.language, "fre");
+  EXPECT_EQ(audio.sample_entry, Mp4AudioSampleEntry("mp4a", 2, 44100, Mp4EsdsBox(testing::SyntheticAacConfig())));
+  EXPECT_EQ(demuxer->duration_us(), 3000000);
+  ExpectSyncPoints(*demuxer);
+}
+
+TEST(MediaDemuxerTest, MkvRebuildsDecodeTimes) {
+  const SyntheticMedia media = testing::BuildSyntheticMkv();
+  const auto demuxer = Open(media);
+  ASSERT_TRUE(demuxer);
+  const auto samples = Read(*demuxer, 1, 2);
+  ASSERT_EQ(samples.size(), 2u);
+  ExpectFrames(media, samples[0], 1000000, media.video, 10, 10);
+  ExpectFrames(media, samples[1], 1000000, media.audio, 20, 20);
+  // I0 P2 B1 ...: decode times are the presentation times in order
+  const std::vector<int32_t> offsets = {0, 100000, -100000, 100000, -100000, 100000, -100000, 100000, -100000, 0};
+  for (size_t i = 0; i < offsets.size(); ++i) {
+    EXPECT_EQ(samples[0][i].dts, 1000000 + static_cast<int64_t>(i) * 100000) << i;
+    EXPECT_EQ(samples[0][i].composition_offset, offsets[i]) << i;
+    EXPECT_EQ(samples[0][i].duration, 100000u) << i;
+  }
+}
+
+TEST(MediaDemuxerTest, MkvWithoutCuesScansForKeyframes) {
+  testing::SyntheticMkvOptions options;
+  options.cues = false;
+  const SyntheticMedia media = testing::BuildSyntheticMkv(options);
+  const auto demuxer = Open(media);
+  ASSERT_TRUE(demuxer);
+  ExpectSyncPoints(*demuxer);
+  const auto samples = Read(*demuxer, 2, 3);
+  ExpectFrames(media, samples[0], 1000000, media.video, 20, 10);
+  ExpectFrames(media, samples[1], 1000000, media.audio, 40, 20);
+  EXPECT_EQ(samples[0].back().duration, 100000u);
+}
+
+TEST(MediaDemuxerTest, MkvLacedFrames) {
+  testing::SyntheticMkvOptions options;
+  options.laced_audio = true;
+  const SyntheticMedia media = testing::BuildSyntheticMkv(options);
+  const auto demuxer = Open(media);
+  ASSERT_TRUE(demuxer);
+  for (size_t range = 0; range < 3; ++range) {
+    const auto samples = Read(*demuxer, range, range + 1);
+    ExpectFrames(media, samples[1], 1000000, media.audio, range * 20, 20);
+    EXPECT_EQ(samples[1][0].duration, 50000u);
+  }
+}
+
+TEST(MediaDemuxerTest, MkvDropsTimesThatOverflow) {
+  for (bool cues : {true, false}) {
+    testing::SyntheticMkvOptions options;
+    options.cues = cues;
+    options.last_cluster_time = uint64_t{1} << 62;
+    const SyntheticMedia media = testing::BuildSyntheticMkv(options);
+    const auto demuxer = Open(media);
+    ASSERT_TRUE(demuxer);
+    ASSERT_EQ(demuxer->sync_points().size(), 2u) << cues;
+    EXPECT_EQ(demuxer->sync_points()[1].time_us, 1000000) << cues;
+    // The last cluster's blocks are dropped too
+    const auto samples = Read(*demuxer, 1, 2);
+    ExpectFrames(media, samples[0], 1000000, media.video, 10, 10);
+  }
+}
+
+TEST(MediaDemuxerTest, RefusesWhatItCantRemux) {
+  std::string error;
+  const std::string text = "certainly not a media file";
+  EXPECT_FALSE(OpenMediaDemuxer(reinterpret_cast<const uint8_t*>(text.data()), text.size(), &error));
+  EXPECT_EQ(error, "Not an MP4 or Matroska file");
+
+  // Fragmented MP4
+  const std::string fragmented =
+      testing::Mp4Box("ftyp", "iso6" + testing::Be(0, 4)) + testing::Mp4Box("moov", testing::Mp4Box("mvex", ""));
+  EXPECT_FALSE(OpenMediaDemuxer(reinterpret_cast<const uint8_t*>(fragmented.data()), fragmented.size(), &error));
+
+  // Matroska audio in a codec fMP4 can't carry here
+  SyntheticMedia media = testing::BuildSyntheticMkv();
+  const size_t codec = media.bytes.find("A_AAC");
+  ASSERT_NE(codec, std::string::npos);
+  media.bytes.replace(codec, 5, "A_XYZ");
+  error.clear();
+  EXPECT_FALSE(
+      OpenMediaDemuxer(reinterpret_cast<const uint8_t*>(media.bytes.data()), media.bytes.size(), &error));
+  EXPECT_EQ(error, "Can't remux codec A_XYZ");
+
+  testing::SyntheticMkvOptions options;
+  options.timestamp_scale = uint64_t{1} << 40;
+  media = testing::BuildSyntheticMkv(options);
+  error.clear();
+  EXPECT_FALSE(
+      OpenMediaDemuxer(reinterpret_cast<const uint8_t*>(media.bytes.data()), media.bytes.size(), &error));
+  EXPECT_EQ(error, "Invalid TimestampScale");
+}
+
+}  // namespace
+}  // namespace pro_video_player
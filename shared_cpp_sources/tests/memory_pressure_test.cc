@@ -0,0 +1,152 @@
+#include "memory_pressure.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "recording_event_sink.h"
+
+namespace pro_video_player {
+namespace {
+
+using ::pro_video_player::testing::WaitUntil;
+
+// A fake cgroup directory with the files the kernel would provide.
+class MemoryPressureTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char path[] = "/tmp/pvp-cgroup-test-XXXXXX";
+    ASSERT_NE(mkdtemp(path), nullptr);
+    directory_ = path;
+    SetMemory(100 << 20, "1073741824");
+    SetPressure(0, 0);
+  }
+
+  void TearDown() override { std::filesystem::remove_all(directory_); }
+
+  void Write(const std::string& name, const std::string& content) {
+    // Replaced atomically, as the monitor may be reading
+    const std::string path = directory_ + "/" + name;
+    std::ofstream(path + ".tmp") << content;
+    std::filesystem::rename(path + ".tmp", path);
+  }
+  void SetMemory(int64_t current, const std::string& max) {
+    Write("memory.current", std::to_string(current) + "\n");
+    Write("memory.max", max + "\n");
+  }
+  void SetPressure(double some, double full) {
+    Write("memory.pressure", "some avg10=" + std::to_string(some) + " avg60=0.00 avg300=0.00 total=12\n" +
+                                 "full avg10=" + std::to_string(full) + " avg60=0.00 avg300=0.00 total=3\n");
+  }
+
+  std::string directory_;
+};
+
+TEST_F(MemoryPressureTest, ReadsControllerFiles) {
+  SetMemory(512 << 20, "1073741824");
+  SetPressure(12.5, 1.25);
+  MemoryStats stats;
+  ASSERT_TRUE(MemoryPressureMonitor::ReadStats(directory_, &stats));
+  EXPECT_EQ(stats.current_bytes, 512 << 20);
+  EXPECT_EQ(stats.max_bytes, 1073741824);
+  EXPECT_DOUBLE_EQ(stats.some_avg10, 12.5);
+  EXPECT_DOUBLE_EQ(stats.full_avg10, 1.25);
+
+  SetMemory(512 << 20, "max");
+  ASSERT_TRUE(MemoryPressureMonitor::ReadStats(directory_, &stats));
+  EXPECT_EQ(stats.max_bytes, -1);
+  EXPECT_FALSE(MemoryPressureMonitor::ReadStats(directory_ + "/missing", &stats));
+}
+
+TEST_F(MemoryPressureTest, ClassifiesByUsageAndStalls) {
+  const MemoryPressureMonitor::Options options;
+  MemoryStats stats;
+  stats.current_bytes = 800;
+  stats.max_bytes = 1000;
+  EXPECT_EQ(MemoryPressureMonitor::Classify(stats, options), MemoryPressureLevel::kNone);
+  stats.current_bytes = 920;
+  EXPECT_EQ(MemoryPressureMonitor::Classify(stats, options), MemoryPressureLevel::kModerate);
+  stats.current_bytes = 990;
+  EXPECT_EQ(MemoryPressureMonitor::Classify(stats, options), MemoryPressureLevel::kCritical);
+
+  stats.current_bytes = 500;
+  stats.some_avg10 = 15;
+  EXPECT_EQ(MemoryPressureMonitor::Classify(stats, options), MemoryPressureLevel::kModerate);
+  stats.full_avg10 = 12;
+  EXPECT_EQ(MemoryPressureMonitor::Classify(stats, options), MemoryPressureLevel::kCritical);
+  // No limit: only stalls count
+  stats = MemoryStats();
+  stats.current_bytes = 1LL << 40;
+  EXPECT_EQ(MemoryPressureMonitor::Classify(stats, options), MemoryPressureLevel::kNone);
+}
+
+TEST_F(MemoryPressureTest, EscalatesWhilePressureLastsAndReportsTheEnd) {
+  std::mutex mutex;
+  std::vector<std::pair<MemoryPressureLevel, MemoryShedStep>> reports;
+  MemoryPressureMonitor::Options options;
+  options.cgroup_dir = directory_;
+  options.interval = std::chrono::milliseconds(5);
+  MemoryPressureMonitor monitor(options, [&](MemoryPressureLevel level, MemoryShedStep step, const MemoryStats&) {
+    std::lock_guard<std::mutex> lock(mutex);
+    reports.emplace_back(level, step);
+  });
+  ASSERT_TRUE(monitor.running());
+  const auto count = [&]() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return reports.size();
+  };
+
+  SetPressure(20, 0);
+  ASSERT_TRUE(WaitUntil([&]() { return count() >= 4; }));
+  SetPressure(0, 0);
+  ASSERT_TRUE(WaitUntil([&]() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return reports.back().first == MemoryPressureLevel::kNone;
+  }));
+  // Quiet again until the next episode
+  const size_t settled = count();
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  EXPECT_EQ(count(), settled);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  EXPECT_EQ(reports[0], std::make_pair(MemoryPressureLevel::kModerate, MemoryShedStep::kCaches));
+  EXPECT_EQ(reports[1], std::make_pair(MemoryPressureLevel::kModerate, MemoryShedStep::kSubtitleWindows));
+  EXPECT_EQ(reports[2], std::make_pair(MemoryPressureLevel::kModerate, MemoryShedStep::kForwardBuffers));
+  EXPECT_EQ(reports[3], std::make_pair(MemoryPressureLevel::kModerate, MemoryShedStep::kForwardBuffers));
+}
+
+TEST_F(MemoryPressureTest, CriticalShedsEverythingAtOnce) {
+  SetMemory(1000, "1000");
+  std::mutex mutex;
+  std::vector<std::pair<MemoryPressureLevel, MemoryShedStep>> reports;
+  MemoryPressureMonitor::Options options;
+  options.cgroup_dir = directory_;
+  options.interval = std::chrono::milliseconds(5);
+  MemoryPressureMonitor monitor(options, [&](MemoryPressureLevel level, MemoryShedStep step, const MemoryStats&) {
+    std::lock_guard<std::mutex> lock(mutex);
+    reports.emplace_back(level, step);
+  });
+  ASSERT_TRUE(WaitUntil([&]() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return !reports.empty();
+  }));
+  std::lock_guard<std::mutex> lock(mutex);
+  EXPECT_EQ(reports[0], std::make_pair(MemoryPressureLevel::kCritical, MemoryShedStep::kForwardBuffers));
+}
+
+TEST_F(MemoryPressureTest, DoesNothingWithoutACgroup) {
+  MemoryPressureMonitor::Options options;
+  options.cgroup_dir = directory_ + "/missing";
+  MemoryPressureMonitor monitor(options, [](MemoryPressureLevel, MemoryShedStep, const MemoryStats&) {});
+  EXPECT_FALSE(monitor.running());
+}
+
+}  // namespace
+}  // namespace pro_video_player
@@ -0,0 +1,162 @@
+#include "mp4_fast_start.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include "local_http_server.h"
+#include "recording_event_sink.h"
+
+namespace pro_video_player {
+namespace {
+
+using ::pro_video_player::testing::LocalHttpServer;
+using ::pro_video_player::testing::WaitUntil;
+
+std::string Box(const std::string& type, size_t payload_size, char fill) {
+  std::string box;
+  const size_t size = 8 + payload_size;
+  for (int i = 3; i >= 0; --i) box.push_back(static_cast<char>((size >> (8 * i)) & 0xff));
+  box += type;
+  box.append(payload_size, fill);
+  return box;
+}
+
+// Serves |file| at /video.mp4 with byte ranges (unless |ranges| is
+// false), each response after |delay|, and records the peak number of
+// requests in progress.
+class Mp4Server {
+ public:
+  Mp4Server(std::string file, bool ranges, std::chrono::milliseconds delay)
+      : file_(std::move(file)), server_([this, ranges, delay](const LocalHttpServer::Request& request) {
+          {
+            std::lock_guard<std::mutex> lock(mutex_);
+            peak_ = std::max(peak_, ++active_);
+          }
+          std::this_thread::sleep_for(delay);
+          LocalHttpServer::Response response;
+          const auto range = request.headers.find("range");
+          if (ranges && range != request.headers.end()) {
+            // "bytes=first-last"
+            const size_t first = std::strtoull(range->second.c_str() + 6, nullptr, 10);
+            const size_t dash = range->second.find('-');
+            size_t last = std::strtoull(range->second.c_str() + dash + 1, nullptr, 10);
+            last = std::min(last, file_.size() - 1);
+            response.status = 206;
+            response.body = file_.substr(first, last - first + 1);
+            response.headers["Content-Range"] = "bytes " + std::to_string(first) + "-" + std::to_string(last) +
+                                                "/" + std::to_string(file_.size());
+          } else {
+            response.body = file_;
+          }
+          std::lock_guard<std::mutex> lock(mutex_);
+          --active_;
+          return response;
+        }) {}
+
+  std::string url() const { return server_.url("/video.mp4"); }
+  const LocalHttpServer& server() const { return server_; }
+  int peak() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return peak_;
+  }
+
+ private:
+  const std::string file_;
+  std::mutex mutex_;
+  int active_ = 0;
+  int peak_ = 0;
+  LocalHttpServer server_;
+};
+
+std::optional<Mp4Prefetch> Prefetch(HttpFetcher* fetcher, const std::string& url, Mp4FastStart::Options options) {
+  std::mutex mutex;
+  std::optional<Mp4Prefetch> result;
+  MediaSource source;
+  source.type = SourceType::kNetwork;
+  source.uri = url;
+  Mp4FastStart prefetcher(fetcher, source, options, [&](const Mp4Prefetch& prefetch) {
+    std::lock_guard<std::mutex> lock(mutex);
+    result = prefetch;
+  });
+  WaitUntil([&]() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return result.has_value();
+  });
+  std::lock_guard<std::mutex> lock(mutex);
+  return result;
+}
+
+Mp4FastStart::Options SmallOptions() {
+  Mp4FastStart::Options options;
+  options.head_bytes = 1024;
+  options.media_bytes = 4096;
+  return options;
+}
+
+TEST(Mp4FastStartTest, FetchesTailAndMediaInParallelWhenMoovIsLast) {
+  const std::string moov = Box("moov", 700, 'm');
+  const std::string file = Box("ftyp", 16, 'f') + Box("mdat", 200000, 'd') + moov;
+  Mp4Server server(file, true, std::chrono::milliseconds(50));
+  HttpFetcher fetcher;
+  const auto result = Prefetch(&fetcher, server.url(), SmallOptions());
+  ASSERT_TRUE(result.has_value());
+
+  EXPECT_TRUE(result->error.empty()) << result->error;
+  EXPECT_EQ(result->layout.moov, Mp4MoovLocation::kEnd);
+  EXPECT_EQ(result->file_size, static_cast<int64_t>(file.size()));
+  EXPECT_EQ(result->head.size(), 1024u);
+  EXPECT_EQ(std::string(result->tail.begin(), result->tail.end()), moov);
+  EXPECT_EQ(std::string(result->media.begin(), result->media.end()), file.substr(1024, 4096));
+  // Head, then tail and media side by side
+  EXPECT_EQ(server.server().requests().size(), 3u);
+  EXPECT_EQ(server.peak(), 2);
+}
+
+TEST(Mp4FastStartTest, FaststartFileNeedsOnlyTheHead) {
+  const std::string file = Box("ftyp", 16, 'f') + Box("moov", 300, 'm') + Box("mdat", 50000, 'd');
+  Mp4Server server(file, true, std::chrono::milliseconds(0));
+  HttpFetcher fetcher;
+  const auto result = Prefetch(&fetcher, server.url(), SmallOptions());
+  ASSERT_TRUE(result.has_value());
+
+  EXPECT_EQ(result->layout.moov, Mp4MoovLocation::kFront);
+  EXPECT_TRUE(result->tail.empty());
+  EXPECT_EQ(server.server().requests().size(), 1u);
+}
+
+TEST(Mp4FastStartTest, ServerIgnoringRangesSendsEverythingAtOnce) {
+  const std::string moov = Box("moov", 100, 'm');
+  const std::string file = Box("ftyp", 16, 'f') + Box("mdat", 5000, 'd') + moov;
+  Mp4Server server(file, false, std::chrono::milliseconds(0));
+  HttpFetcher fetcher;
+  const auto result = Prefetch(&fetcher, server.url(), SmallOptions());
+  ASSERT_TRUE(result.has_value());
+
+  EXPECT_EQ(result->layout.moov, Mp4MoovLocation::kEnd);
+  EXPECT_EQ(result->head.size(), file.size());
+  EXPECT_EQ(std::string(result->tail.begin(), result->tail.end()), moov);
+  EXPECT_EQ(server.server().requests().size(), 1u);
+}
+
+TEST(Mp4FastStartTest, ReportsHeadFailures) {
+  LocalHttpServer server([](const LocalHttpServer::Request&) {
+    LocalHttpServer::Response response;
+    response.status = 404;
+    return response;
+  });
+  HttpFetcher fetcher;
+  const auto result = Prefetch(&fetcher, server.url("/missing.mp4"), SmallOptions());
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(result->error, "HTTP 404");
+  EXPECT_TRUE(result->head.empty());
+}
+
+}  // namespace
+}  // namespace pro_video_player
@@ -0,0 +1,84 @@
+#include "mp4_layout.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace pro_video_player {
+namespace {
+
+void PutBigEndian(std::string* out, uint64_t value, int bytes) {
+  for (int i = bytes - 1; i >= 0; --i) out->push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+}
+
+std::string Box(const std::string& type, size_t payload_size) {
+  std::string box;
+  PutBigEndian(&box, 8 + payload_size, 4);
+  box += type;
+  box.append(payload_size, '\0');
+  return box;
+}
+
+Mp4Layout Parse(const std::string& bytes, int64_t file_size) {
+  return ParseMp4Layout(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size(), file_size);
+}
+
+TEST(Mp4LayoutTest, FaststartHasMoovFirst) {
+  const std::string file = Box("ftyp", 16) + Box("moov", 500) + Box("mdat", 10000);
+  const Mp4Layout layout = Parse(file.substr(0, 100), static_cast<int64_t>(file.size()));
+  EXPECT_EQ(layout.moov, Mp4MoovLocation::kFront);
+  EXPECT_EQ(layout.moov_offset, 24);
+  EXPECT_EQ(layout.moov_size, 508);
+}
+
+TEST(Mp4LayoutTest, MoovAfterMdatPointsAtTheTail) {
+  const std::string file = Box("ftyp", 16) + Box("free", 8) + Box("mdat", 100000) + Box("moov", 500);
+  const Mp4Layout layout = Parse(file.substr(0, 4096), static_cast<int64_t>(file.size()));
+  EXPECT_EQ(layout.moov, Mp4MoovLocation::kEnd);
+  EXPECT_EQ(layout.mdat_offset, 40);
+  EXPECT_EQ(layout.mdat_size, 100008);
+  EXPECT_EQ(layout.tail_offset, 100048);
+  EXPECT_EQ(layout.moov_offset, -1);
+
+  // Both boxes in the bytes read
+  const Mp4Layout whole = Parse(file, static_cast<int64_t>(file.size()));
+  EXPECT_EQ(whole.moov, Mp4MoovLocation::kEnd);
+  EXPECT_EQ(whole.moov_offset, 100048);
+  EXPECT_EQ(whole.tail_offset, 100048);
+}
+
+TEST(Mp4LayoutTest, LargeSizeMdat) {
+  std::string head = Box("ftyp", 16);
+  PutBigEndian(&head, 1, 4);
+  head += "mdat";
+  PutBigEndian(&head, 5000000000ULL, 8);
+  head.append(1000, '\0');
+  const Mp4Layout layout = Parse(head, -1);
+  EXPECT_EQ(layout.moov, Mp4MoovLocation::kEnd);
+  EXPECT_EQ(layout.mdat_size, 5000000000LL);
+  EXPECT_EQ(layout.tail_offset, 24 + 5000000000LL);
+}
+
+TEST(Mp4LayoutTest, UndecidableHeads) {
+  EXPECT_EQ(Parse(Box("RIFF", 100), -1).moov, Mp4MoovLocation::kNotMp4);
+  // Cut inside the ftyp box
+  EXPECT_EQ(Parse(Box("ftyp", 16).substr(0, 6), -1).moov, Mp4MoovLocation::kUnknown);
+  // mdat runs to the end of the file (size 0): no moov can follow
+  std::string to_end = Box("ftyp", 16);
+  PutBigEndian(&to_end, 0, 4);
+  to_end += "mdat";
+  EXPECT_EQ(Parse(to_end, 1000).moov, Mp4MoovLocation::kUnknown);
+  // mdat is the last box of the file
+  const std::string truncated = Box("ftyp", 16) + Box("mdat", 5000);
+  EXPECT_EQ(Parse(truncated.substr(0, 100), static_cast<int64_t>(truncated.size())).moov,
+            Mp4MoovLocation::kUnknown);
+  // Corrupt box size
+  std::string corrupt = Box("ftyp", 16);
+  PutBigEndian(&corrupt, 4, 4);
+  corrupt += "free";
+  EXPECT_EQ(Parse(corrupt, -1).moov, Mp4MoovLocation::kUnknown);
+}
+
+}  // namespace
+}  // namespace pro_video_player
@@ -0,0 +1,155 @@
+#include "backends/mpv_decode_backend.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "recording_event_sink.h"
+
+namespace pro_video_player {
+namespace {
+
+using ::pro_video_player::testing::WaitUntil;
+
+// Ten seconds of 320x240 test pattern, generated by libavfilter inside
+// mpv: no files and no network, and no audio device needed.
+constexpr char kTestSource[] = "av://lavfi:testsrc=size=320x240:rate=30:duration=10";
+
+constexpr std::chrono::milliseconds kTimeout(10000);
+
+class RecordingListener : public DecodeBackendListener {
+ public:
+  void OnPrepared(const MediaInfo& info) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    info_ = info;
+    prepared_ = true;
+  }
+  void OnBufferingChanged(bool) override {}
+  void OnBufferedPosition(int64_t) override {}
+  void OnVideoSizeChanged(int, int) override {}
+  void OnTracksChanged(const std::vector<AudioTrack>&, const std::vector<SubtitleTrack>&) override {}
+  void OnEndOfStream() override {}
+  void OnError(const std::string& code, const std::string& message) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    errors_.push_back(code + ": " + message);
+  }
+  void OnFrame(const VideoFrame&) override { frames_.fetch_add(1); }
+  void OnAudioSamples(const AudioSamples&) override {}
+  void OnAudioLevels(const AudioLevels&) override {}
+  void OnSubtitleCue(const std::string&, const SubtitleCue&) override {}
+  void OnLivePlaylist(const std::string&) override {}
+
+  bool prepared() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return prepared_;
+  }
+  MediaInfo info() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return info_;
+  }
+  std::vector<std::string> errors() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return errors_;
+  }
+  int frames() const { return frames_.load(); }
+
+ private:
+  mutable std::mutex mutex_;
+  bool prepared_ = false;
+  MediaInfo info_;
+  std::vector<std::string> errors_;
+  std::atomic<int> frames_{0};
+};
+
+class MpvDecodeBackendTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    RegisterMpvDecodeBackend(&registry_);
+    backend_ = registry_.Create(kMpvBackendName);
+    ASSERT_NE(backend_, nullptr);
+    backend_->SetRenderPolicy(0, true);
+    MediaSource source;
+    source.type = SourceType::kFile;
+    source.uri = kTestSource;
+    backend_->Open(source, &listener_);
+    ASSERT_TRUE(WaitUntil([this]() { return listener_.prepared() || !listener_.errors().empty(); }, kTimeout));
+    ASSERT_TRUE(listener_.errors().empty()) << listener_.errors().front();
+  }
+
+  void TearDown() override {
+    if (backend_ != nullptr) backend_->Close();
+  }
+
+  // How far playback moves in |wall| of real time.
+  int64_t Advance(std::chrono::milliseconds wall) {
+    const int64_t start = backend_->QueryPositionMs();
+    std::this_thread::sleep_for(wall);
+    return backend_->QueryPositionMs() - start;
+  }
+
+  DecodeBackendRegistry registry_;
+  RecordingListener listener_;
+  std::unique_ptr<DecodeBackend> backend_;
+};
+
+TEST_F(MpvDecodeBackendTest, PreparesTheSource) {
+  const MediaInfo info = listener_.info();
+  EXPECT_NEAR(info.duration_ms, 10000, 100);
+  EXPECT_EQ(info.width, 320);
+  EXPECT_EQ(info.height, 240);
+  EXPECT_FALSE(info.is_live);
+  EXPECT_TRUE(registry_.IsInitialized(kMpvBackendName));
+}
+
+TEST_F(MpvDecodeBackendTest, PlaysFramesAndAdvances) {
+  backend_->Play();
+  ASSERT_TRUE(WaitUntil([this]() { return listener_.frames() >= 10; }, kTimeout));
+  ASSERT_TRUE(WaitUntil([this]() { return backend_->QueryPositionMs() >= 500; }, kTimeout));
+
+  backend_->Pause();
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  EXPECT_LE(Advance(std::chrono::milliseconds(300)), 50);
+  EXPECT_TRUE(listener_.errors().empty());
+}
+
+TEST_F(MpvDecodeBackendTest, SeeksAndKeepsPlaying) {
+  backend_->Seek(6000);
+  ASSERT_TRUE(WaitUntil([this]() { return backend_->QueryPositionMs() >= 5900; }, kTimeout));
+
+  const int frames = listener_.frames();
+  backend_->Play();
+  ASSERT_TRUE(WaitUntil([this]() { return backend_->QueryPositionMs() >= 6500; }, kTimeout));
+  EXPECT_GT(listener_.frames(), frames);
+
+  // Backwards too
+  backend_->Seek(1000);
+  ASSERT_TRUE(WaitUntil([this]() { return backend_->QueryPositionMs() < 3000; }, kTimeout));
+  EXPECT_GE(backend_->QueryPositionMs(), 900);
+  EXPECT_TRUE(listener_.errors().empty());
+}
+
+TEST_F(MpvDecodeBackendTest, RateChangesHowFastPlaybackAdvances) {
+  backend_->Play();
+  ASSERT_TRUE(WaitUntil([this]() { return backend_->QueryPositionMs() >= 200; }, kTimeout));
+
+  // Generous bounds: the clock only has to follow the rate, not match it
+  backend_->SetRate(2.0);
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  EXPECT_GE(Advance(std::chrono::milliseconds(1000)), 1500);
+
+  backend_->SetRate(0.5);
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  const int64_t slow = Advance(std::chrono::milliseconds(1000));
+  EXPECT_GE(slow, 250);
+  EXPECT_LE(slow, 800);
+  EXPECT_TRUE(listener_.errors().empty());
+}
+
+}  // namespace
+}  // namespace pro_video_player
@@ -0,0 +1,263 @@
+#include "player_manager.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "fake_decode_backend.h"
+#include "recording_event_sink.h"
+
+namespace pro_video_player {
+namespace {
+
+using ::pro_video_player::testing::FakeBackendState;
+using ::pro_video_player::testing::FakeDecodeBackend;
+using ::pro_video_player::testing::RecordingEventSink;
+using ::pro_video_player::testing::WaitUntil;
+
+class PlayerManagerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    registry_.Register("fake", [this]() {
+      auto state = std::make_shared<FakeBackendState>();
+      states_.push_back(state);
+      return std::make_unique<FakeDecodeBackend>(state);
+    });
+  }
+
+  MediaSource Source() const {
+    MediaSource source;
+    source.uri = "https://example.com/video.m3u8";
+    return source;
+  }
+
+  DecodeBackendRegistry registry_;
+  std::vector<std::shared_ptr<FakeBackendState>> states_;
+  RecordingEventSink sink_;
+};
+
+TEST_F(PlayerManagerTest, FirstRegisteredBackendIsDefault) {
+  registry_.Register("other", []() { return std::unique_ptr<DecodeBackend>(); });
+  EXPECT_EQ(registry_.default_name(), "fake");
+  EXPECT_EQ(registry_.names(), (std::vector<std::string>{"fake", "other"}));
+  EXPECT_EQ(registry_.Create("missing"), nullptr);
+
+  registry_.Unregister("fake");
+  EXPECT_EQ(registry_.Create(), nullptr);
+}
+
+TEST_F(PlayerManagerTest, DisplayNamesFallBackToRegistryKey) {
+  registry_.Register("mpv", []() { return std::unique_ptr<DecodeBackend>(); }, "libmpv");
+  EXPECT_EQ(registry_.DisplayName("mpv"), "libmpv");
+  EXPECT_EQ(registry_.DisplayName(), "fake");
+  EXPECT_EQ(registry_.DisplayName("missing"), "");
+}
+
+TEST_F(PlayerManagerTest, NativePlayerTypeReportsActiveBackends) {
+  registry_.Register("other", []() { return std::unique_ptr<DecodeBackend>(); }, "Other");
+  registry_.SetDefault("other");
+  PlayerManager manager(&sink_, &sink_, &registry_);
+  EXPECT_EQ(manager.NativePlayerType(), "Other");
+
+  const int64_t first = manager.Create(Source(), PlayerOptions(), "fake");
+  manager.Create(Source(), PlayerOptions(), "fake");
+  EXPECT_EQ(manager.NativePlayerType(), "Fake");
+
+  manager.Dispose(first);
+  EXPECT_EQ(manager.NativePlayerType(), "Fake");
+  manager.DisposeAll();
+  EXPECT_EQ(manager.NativePlayerType(), "Other");
+}
+
+TEST_F(PlayerManagerTest, CreateAssignsSequentialIdsAndOpensSource) {
+  PlayerManager manager(&sink_, &sink_, &registry_);
+  EXPECT_EQ(manager.Create(Source(), PlayerOptions()), 0);
+  EXPECT_EQ(manager.Create(Source(), PlayerOptions(), "fake"), 1);
+  EXPECT_EQ(manager.size(), 2u);
+
+  ASSERT_EQ(states_.size(), 2u);
+  for (const auto& state : states_) {
+    EXPECT_TRUE(WaitUntil([&]() { return state->HasCall("Open https://example.com/video.m3u8"); }));
+  }
+  ASSERT_NE(manager.Get(1), nullptr);
+  EXPECT_EQ(manager.Get(1)->backend_name(), "Fake");
+}
+
+TEST_F(PlayerManagerTest, UnknownBackendIsRejected) {
+  PlayerManager manager(&sink_, &sink_, &registry_);
+  EXPECT_EQ(manager.Create(Source(), PlayerOptions(), "mpv"), -1);
+  EXPECT_EQ(manager.size(), 0u);
+  // Failed creations don't consume ids.
+  EXPECT_EQ(manager.Create(Source(), PlayerOptions()), 0);
+}
+
+TEST_F(PlayerManagerTest, DisposeRemovesAndClosesPlayer) {
+  PlayerManager manager(&sink_, &sink_, &registry_);
+  const int64_t id = manager.Create(Source(), PlayerOptions());
+  std::shared_ptr<Player> player = manager.Get(id);
+
+  EXPECT_TRUE(manager.Dispose(id));
+  EXPECT_FALSE(manager.Dispose(id));
+  EXPECT_EQ(manager.Get(id), nullptr);
+  EXPECT_EQ(player->state(), PlaybackState::kDisposed);
+  EXPECT_TRUE(states_[0]->HasCall("Close"));
+}
+
+TEST_F(PlayerManagerTest, DisposeAllClosesEveryPlayer) {
+  {
+    PlayerManager manager(&sink_, &sink_, &registry_);
+    manager.Create(Source(), PlayerOptions());
+    manager.Create(Source(), PlayerOptions());
+    manager.DisposeAll();
+    EXPECT_EQ(manager.size(), 0u);
+    manager.Create(Source(), PlayerOptions());
+  }
+  // The destructor disposes whatever is left.
+  ASSERT_EQ(states_.size(), 3u);
+  for (const auto& state : states_) EXPECT_TRUE(state->HasCall("Close"));
+}
+
+TEST_F(PlayerManagerTest, EnginesInitializeOnFirstUse) {
+  std::atomic<int> initializations{0};
+  registry_.Register(
+      "lazy", []() { return std::make_unique<FakeDecodeBackend>(std::make_shared<FakeBackendState>()); }, "Lazy",
+      DecoderProbe(), [&]() {
+        ++initializations;
+        return true;
+      });
+  PlayerManager manager(&sink_, &sink_, &registry_);
+  // Registration and platform info don't start the engine
+  EXPECT_EQ(manager.NativePlayerType(), "fake");
+  EXPECT_FALSE(registry_.IsInitialized("lazy"));
+  EXPECT_EQ(initializations, 0);
+
+  EXPECT_GE(manager.Create(Source(), PlayerOptions(), "lazy"), 0);
+  EXPECT_GE(manager.Create(Source(), PlayerOptions(), "lazy"), 0);
+  EXPECT_TRUE(registry_.IsInitialized("lazy"));
+  EXPECT_EQ(initializations, 1);
+}
+
+TEST_F(PlayerManagerTest, FailedEngineRejectsPlayers) {
+  int initializations = 0;
+  registry_.Register(
+      "broken", []() { return std::make_unique<FakeDecodeBackend>(std::make_shared<FakeBackendState>()); },
+      "Broken", DecoderProbe(), [&]() {
+        ++initializations;
+        return false;
+      });
+  PlayerManager manager(&sink_, &sink_, &registry_);
+  EXPECT_EQ(manager.Create(Source(), PlayerOptions(), "broken"), -1);
+  EXPECT_FALSE(registry_.Initialize("broken"));
+  EXPECT_EQ(initializations, 1);
+  EXPECT_EQ(manager.size(), 0u);
+}
+
+TEST_F(PlayerManagerTest, WarmUpInitializesInTheBackground) {
+  std::atomic<int> initializations{0};
+  std::atomic<int> probes{0};
+  DecoderProbe probe;
+  probe.enumerate = [&](std::vector<DecoderInfo>*) {
+    ++probes;
+    return true;
+  };
+  auto warm_up_state = std::make_shared<FakeBackendState>();
+  registry_.Register(
+      "warm", [&]() { return std::make_unique<FakeDecodeBackend>(warm_up_state); }, "Warm", probe, [&]() {
+        ++initializations;
+        return true;
+      });
+  registry_.SetDefault("warm");
+  CodecCapabilityCache codecs("");
+  PlayerManager manager(&sink_, &sink_, &registry_, &codecs);
+  std::mutex mutex;
+  std::optional<PlayerManager::WarmUpReport> report;
+  manager.WarmUp(std::string(), [&](const PlayerManager::WarmUpReport& result) {
+    std::lock_guard<std::mutex> lock(mutex);
+    report = result;
+  });
+  ASSERT_TRUE(WaitUntil([&]() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return report.has_value();
+  }));
+  EXPECT_EQ(report->backend, "warm");
+  EXPECT_TRUE(report->initialized);
+  EXPECT_TRUE(report->pipeline);
+  EXPECT_GE(report->total_ms, report->initialize_ms + report->probe_ms + report->pipeline_ms);
+  // A throwaway instance ran the pipeline
+  EXPECT_EQ(warm_up_state->Calls(), (std::vector<std::string>{"WarmUp", "Close"}));
+  EXPECT_TRUE(registry_.IsInitialized("warm"));
+
+  // Neither the player nor the codec check starts over
+  EXPECT_GE(manager.Create(Source(), PlayerOptions()), 0);
+  EXPECT_EQ(manager.CanPlay(VideoMetadata()).support, CodecSupport::kSupported);
+  EXPECT_EQ(initializations, 1);
+  EXPECT_EQ(probes, 1);
+
+  // Nor does warming up again: the first report comes back at once
+  bool again = false;
+  manager.WarmUp("warm", [&](const PlayerManager::WarmUpReport& result) {
+    again = result.pipeline && result.total_ms == report->total_ms;
+  });
+  EXPECT_TRUE(again);
+  const std::vector<std::string> calls = warm_up_state->Calls();
+  EXPECT_EQ(std::count(calls.begin(), calls.end(), "WarmUp"), 1);
+}
+
+TEST_F(PlayerManagerTest, WarmUpReportsFailedEngines) {
+  registry_.Register(
+      "broken", []() { return std::unique_ptr<DecodeBackend>(); }, "Broken", DecoderProbe(), []() { return false; });
+  std::atomic<bool> reported{false};
+  bool initialized = true;
+  {
+    PlayerManager manager(&sink_, &sink_, &registry_);
+    manager.WarmUp("broken", [&](const PlayerManager::WarmUpReport& report) {
+      initialized = report.initialized;
+      reported = true;
+    });
+  }
+  // The destructor waits for it
+  EXPECT_TRUE(reported);
+  EXPECT_FALSE(initialized);
+}
+
+TEST_F(PlayerManagerTest, CanPlayChecksTheBackendsDecoders) {
+  DecoderProbe probe;
+  int probes = 0;
+  bool initialized = false;
+  probe.enumerate = [&](std::vector<DecoderInfo>* decoders) {
+    // The engine is set up before its decoders are listed
+    EXPECT_TRUE(initialized);
+    ++probes;
+    DecoderInfo h264;
+    h264.codec = "h264";
+    h264.name = "h264";
+    decoders->push_back(h264);
+    return true;
+  };
+  registry_.Register("probed", []() { return std::unique_ptr<DecodeBackend>(); }, "Probed", probe, [&]() {
+    initialized = true;
+    return true;
+  });
+  CodecCapabilityCache codecs("");
+  PlayerManager manager(&sink_, &sink_, &registry_, &codecs);
+
+  VideoMetadata metadata;
+  metadata.video_codec = "avc1.64001f";
+  EXPECT_EQ(manager.CanPlay(metadata, "probed").support, CodecSupport::kSupported);
+  metadata.video_codec = "av01.0.08M.08";
+  EXPECT_EQ(manager.CanPlay(metadata, "probed").reason, "No decoder for av1");
+  EXPECT_EQ(probes, 1);
+
+  // The default backend can't list its decoders
+  const CodecCheck check = manager.CanPlay(metadata);
+  EXPECT_EQ(check.support, CodecSupport::kUnknown);
+  EXPECT_EQ(check.reason, "Can't list the decoders of fake");
+}
+
+}  // namespace
+}  // namespace pro_video_player
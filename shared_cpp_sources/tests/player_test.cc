@@ -0,0 +1,1034 @@
+#include "player.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "download_store.h"
+#include "fake_decode_backend.h"
+#include "recording_event_sink.h"
+
+namespace pro_video_player {
+namespace {
+
+using ::pro_video_player::testing::FakeBackendState;
+using ::pro_video_player::testing::FakeDecodeBackend;
+using ::pro_video_player::testing::RecordingEventSink;
+using ::pro_video_player::testing::WaitUntil;
+
+MediaInfo MakeInfo() {
+  MediaInfo info;
+  info.duration_ms = 10000;
+  info.width = 1920;
+  info.height = 1080;
+  info.audio_tracks = {{"a0", "English", "en", 2, true}, {"a1", "Deutsch", "de-DE", 6, false}};
+  info.subtitle_tracks = {{"s0", "English", "en", false}, {"s1", "Français", "fr", false}};
+  return info;
+}
+
+class PlayerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    backend_ = std::make_shared<FakeBackendState>();
+    player_ = std::make_unique<Player>(7, std::make_unique<FakeDecodeBackend>(backend_), &sink_,
+                                       &sink_);
+  }
+
+  void TearDown() override { player_->Dispose(); }
+
+  DecodeBackendListener* Open(const PlayerOptions& options = PlayerOptions()) {
+    MediaSource source;
+    source.type = SourceType::kFile;
+    source.uri = "/media/clip.mp4";
+    EXPECT_TRUE(player_->Initialize(source, options));
+    EXPECT_TRUE(WaitUntil([&]() { return backend_->Listener() != nullptr; }));
+    return backend_->Listener();
+  }
+
+  DecodeBackendListener* Prepare(const PlayerOptions& options = PlayerOptions()) {
+    DecodeBackendListener* listener = Open(options);
+    listener->OnPrepared(MakeInfo());
+    EXPECT_TRUE(sink_.WaitFor("playbackStateChanged:ready"));
+    return listener;
+  }
+
+  bool WaitForCall(const std::string& call) {
+    return WaitUntil([&]() { return backend_->HasCall(call); });
+  }
+
+  std::shared_ptr<FakeBackendState> backend_;
+  RecordingEventSink sink_;
+  std::unique_ptr<Player> player_;
+};
+
+TEST_F(PlayerTest, InitializeOpensSourceOnce) {
+  Open();
+  EXPECT_TRUE(sink_.WaitFor("playbackStateChanged:initializing"));
+  EXPECT_TRUE(backend_->HasCall("Open /media/clip.mp4"));
+  EXPECT_FALSE(player_->Initialize(MediaSource(), PlayerOptions()));
+  EXPECT_EQ(player_->backend_name(), "Fake");
+}
+
+TEST_F(PlayerTest, OfflineSourcesOpenFinishedDownloads) {
+  char directory[] = "/tmp/pvp-player-offline-XXXXXX";
+  ASSERT_NE(mkdtemp(directory), nullptr);
+  const std::string previous = DownloadStore::Instance().directory();
+  DownloadStore::Instance().SetDirectory(directory);
+  DownloadPlan plan;
+  plan.source.type = SourceType::kNetwork;
+  plan.source.uri = "https://cdn.example/clip.mp4";
+  plan.entry = "media.mp4";
+  ASSERT_TRUE(DownloadStore::Instance().WritePlan("clip", plan));
+  ASSERT_TRUE(DownloadStore::Instance().WritePlan("partial", plan));
+  ASSERT_TRUE(DownloadStore::Instance().MarkComplete("clip"));
+
+  MediaSource source;
+  source.type = SourceType::kOffline;
+  source.uri = "clip";
+  ASSERT_TRUE(player_->Initialize(source, PlayerOptions()));
+  EXPECT_TRUE(WaitForCall("Open " + std::string(directory) + "/clip/media.mp4"));
+
+  // Unfinished downloads fail before reaching the backend
+  auto other_backend = std::make_shared<FakeBackendState>();
+  Player other(8, std::make_unique<FakeDecodeBackend>(other_backend), &sink_, &sink_);
+  source.uri = "partial";
+  ASSERT_TRUE(other.Initialize(source, PlayerOptions()));
+  EXPECT_TRUE(sink_.WaitFor("error:OFFLINE_ERROR"));
+  EXPECT_FALSE(other_backend->HasCall("Open " + std::string(directory) + "/partial/media.mp4"));
+  other.Dispose();
+
+  DownloadStore::Instance().SetDirectory(previous);
+  std::filesystem::remove_all(directory);
+}
+
+TEST_F(PlayerTest, PreparedReportsDurationSizeAndTracks) {
+  Prepare();
+  EXPECT_EQ(player_->state(), PlaybackState::kReady);
+  EXPECT_EQ(player_->DurationMs(), 10000);
+  ASSERT_TRUE(sink_.WaitFor("audioTracks:2"));
+  ASSERT_TRUE(sink_.WaitFor("subtitleTracks:2"));
+
+  const auto durations = sink_.EventsOfType("durationChanged");
+  ASSERT_EQ(durations.size(), 1u);
+  EXPECT_EQ(std::get<int64_t>(durations[0].Get("duration")), 10000);
+  const auto sizes = sink_.EventsOfType("videoSizeChanged");
+  ASSERT_EQ(sizes.size(), 1u);
+  EXPECT_EQ(std::get<int64_t>(sizes[0].Get("width")), 1920);
+  EXPECT_EQ(std::get<int64_t>(sizes[0].Get("height")), 1080);
+}
+
+TEST_F(PlayerTest, AutoPlayStartsOncePrepared) {
+  PlayerOptions options;
+  options.auto_play = true;
+  Prepare(options);
+  EXPECT_TRUE(sink_.WaitFor("playbackStateChanged:playing"));
+  EXPECT_TRUE(backend_->HasCall("Play"));
+}
+
+TEST_F(PlayerTest, PlayBeforePreparedIsDeferred) {
+  DecodeBackendListener* listener = Open();
+  player_->Play();
+  ASSERT_TRUE(sink_.WaitFor("playbackStateChanged:initializing"));
+  EXPECT_FALSE(backend_->HasCall("Play"));
+
+  listener->OnPrepared(MakeInfo());
+  EXPECT_TRUE(sink_.WaitFor("playbackStateChanged:playing"));
+  EXPECT_TRUE(backend_->HasCall("Play"));
+}
+
+TEST_F(PlayerTest, PauseStopsPlayback) {
+  Prepare();
+  player_->Play();
+  ASSERT_TRUE(sink_.WaitFor("playbackStateChanged:playing"));
+  player_->Pause();
+  EXPECT_TRUE(sink_.WaitFor("playbackStateChanged:paused"));
+  EXPECT_TRUE(backend_->HasCall("Pause"));
+}
+
+TEST_F(PlayerTest, SeekBeforePreparedBecomesStartPosition) {
+  DecodeBackendListener* listener = Open();
+  player_->SeekTo(4000);
+  listener->OnPrepared(MakeInfo());
+  EXPECT_TRUE(WaitForCall("Seek 4000"));
+  ASSERT_TRUE(sink_.WaitFor("positionChanged"));
+  EXPECT_EQ(player_->PositionMs(), 4000);
+}
+
+TEST_F(PlayerTest, SeekEmitsPositionAndClampsToDuration) {
+  Prepare();
+  player_->SeekTo(60000);
+  ASSERT_TRUE(WaitForCall("Seek 10000"));
+  ASSERT_TRUE(sink_.WaitFor("positionChanged"));
+  const auto positions = sink_.EventsOfType("positionChanged");
+  EXPECT_EQ(std::get<int64_t>(positions.back().Get("position")), 10000);
+}
+
+TEST_F(PlayerTest, EndOfStreamCompletesAndPlayRestartsFromZero) {
+  DecodeBackendListener* listener = Prepare();
+  player_->Play();
+  ASSERT_TRUE(sink_.WaitFor("playbackStateChanged:playing"));
+  listener->OnEndOfStream();
+  ASSERT_TRUE(sink_.WaitFor("completed"));
+  EXPECT_EQ(player_->state(), PlaybackState::kCompleted);
+  EXPECT_EQ(player_->PositionMs(), 10000);
+
+  player_->Play();
+  EXPECT_TRUE(sink_.WaitFor("playbackStateChanged:playing", 2));
+  EXPECT_TRUE(backend_->HasCall("Seek 0"));
+}
+
+TEST_F(PlayerTest, LoopingRestartsInsteadOfCompleting) {
+  PlayerOptions options;
+  options.looping = true;
+  DecodeBackendListener* listener = Prepare(options);
+  player_->Play();
+  ASSERT_TRUE(sink_.WaitFor("playbackStateChanged:playing"));
+  listener->OnEndOfStream();
+  ASSERT_TRUE(WaitForCall("Seek 0"));
+  EXPECT_EQ(sink_.Count("completed"), 0);
+  EXPECT_EQ(player_->state(), PlaybackState::kPlaying);
+}
+
+TEST_F(PlayerTest, RejectsInvalidArguments) {
+  EXPECT_FALSE(player_->SeekTo(-1));
+  EXPECT_FALSE(player_->SetPlaybackSpeed(0));
+  EXPECT_FALSE(player_->SetPlaybackSpeed(-1.5));
+  EXPECT_FALSE(player_->SetPlaybackSpeed(0.2));
+  EXPECT_FALSE(player_->SetPlaybackSpeed(4.5));
+  EXPECT_FALSE(player_->SetVolume(1.5));
+  EXPECT_FALSE(player_->SetVolume(-0.1));
+  EXPECT_FALSE(player_->SetMaxRenderFrameRate(-5.0));
+  EXPECT_FALSE(player_->SetDisplaySize(-1, 10));
+}
+
+TEST_F(PlayerTest, SpeedAndVolumeReachBackendAndEmitEvents) {
+  Prepare();
+  player_->SetPlaybackSpeed(1.5);
+  player_->SetVolume(0.25);
+  ASSERT_TRUE(sink_.WaitFor("volumeChanged"));
+  EXPECT_TRUE(backend_->HasCall("SetRate 1.500000"));
+  EXPECT_TRUE(backend_->HasCall("SetVolume 0.250000"));
+  EXPECT_DOUBLE_EQ(player_->playback_speed(), 1.5);
+  EXPECT_DOUBLE_EQ(player_->volume(), 0.25);
+  EXPECT_EQ(sink_.Count("playbackSpeedChanged"), 1);
+}
+
+TEST_F(PlayerTest, RejectedCommandsReportErrorToCallback) {
+  std::vector<std::string> codes;
+  auto record = [&](const CommandResult& result) { codes.push_back(result.code); };
+  EXPECT_FALSE(player_->SetVolume(2.0, record));
+  EXPECT_FALSE(player_->SeekTo(-1, record));
+  player_->Dispose();
+  EXPECT_FALSE(player_->Play(record));
+  EXPECT_EQ(codes, (std::vector<std::string>{"VOLUME_ERROR", "INVALID_ARGS", "INVALID_PLAYER"}));
+}
+
+TEST_F(PlayerTest, CommandCallbacksReportResultsFromWorker) {
+  Prepare();
+  std::mutex mutex;
+  std::vector<std::string> codes;
+  auto record = [&](const CommandResult& result) {
+    std::lock_guard<std::mutex> lock(mutex);
+    codes.push_back(result.ok() ? "ok" : result.code);
+  };
+  player_->Play(record);
+  player_->SetAudioTrack("missing", record);
+  ASSERT_TRUE(WaitUntil([&]() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return codes.size() == 2;
+  }));
+  EXPECT_EQ(codes, (std::vector<std::string>{"ok", "AUDIO_ERROR"}));
+}
+
+TEST_F(PlayerTest, SetterBurstBehindBusyWorkerIsCoalesced) {
+  Prepare();
+  std::atomic<int> completed{0};
+  auto count = [&](const CommandResult& result) {
+    if (result.ok()) ++completed;
+  };
+  {
+    // Stall the worker in Play() while a slider drag floods volume and seeks
+    std::unique_lock<std::mutex> hold(backend_->hold);
+    player_->Play();
+    for (int i = 1; i <= 50; ++i) {
+      player_->SetVolume(i / 50.0, count);
+      player_->SeekTo(i * 100, count);
+    }
+  }
+  ASSERT_TRUE(WaitUntil([&]() { return completed.load() == 100; }));
+  EXPECT_DOUBLE_EQ(player_->volume(), 1.0);
+  EXPECT_TRUE(backend_->HasCall("Seek 5000"));
+  int volume_calls = 0;
+  int seek_calls = 0;
+  for (const auto& call : backend_->Calls()) {
+    if (call.rfind("SetVolume", 0) == 0) ++volume_calls;
+    if (call.rfind("Seek", 0) == 0) ++seek_calls;
+  }
+  EXPECT_EQ(volume_calls, 1);
+  EXPECT_EQ(seek_calls, 1);
+  EXPECT_EQ(sink_.EventsOfType("volumeChanged").back().Get("volume"), EventValue(1.0));
+}
+
+TEST_F(PlayerTest, BufferingWhilePlayingPausesClock) {
+  DecodeBackendListener* listener = Prepare();
+  player_->Play();
+  ASSERT_TRUE(sink_.WaitFor("playbackStateChanged:playing"));
+
+  listener->OnBufferingChanged(true);
+  ASSERT_TRUE(sink_.WaitFor("playbackStateChanged:buffering"));
+  EXPECT_EQ(sink_.Count("bufferingStarted"), 1);
+
+  listener->OnBufferingChanged(false);
+  ASSERT_TRUE(sink_.WaitFor("playbackStateChanged:playing", 2));
+  EXPECT_EQ(sink_.Count("bufferingEnded"), 1);
+}
+
+TEST_F(PlayerTest, StallWithBufferedDataIsNotBuffering) {
+  DecodeBackendListener* listener = Prepare();
+  player_->Play();
+  ASSERT_TRUE(sink_.WaitFor("playbackStateChanged:playing"));
+
+  // 8 s ahead of the playhead: the backend is restarting a decoder
+  listener->OnBufferedPosition(8000);
+  listener->OnBufferingChanged(true);
+  listener->OnBufferingChanged(false);
+  // Then it really runs dry
+  listener->OnBufferedPosition(8000);
+  backend_->position_ms = 8000;
+  player_->SeekTo(7900);
+  listener->OnBufferingChanged(true);
+  ASSERT_TRUE(sink_.WaitFor("bufferingStarted"));
+  listener->OnBufferingChanged(false);
+  ASSERT_TRUE(sink_.WaitFor("bufferingEnded"));
+  player_->Dispose();
+  EXPECT_EQ(sink_.Count("bufferingStarted"), 1);
+  EXPECT_EQ(sink_.Count("bufferingEnded"), 1);
+}
+
+TEST_F(PlayerTest, BufferingTierSetsLimitsAndIdleDropsBackBuffer) {
+  PlayerOptions options;
+  options.buffering_tier = BufferingTier::kLow;
+  DecodeBackendListener* listener = Open(options);
+  // Applied before the backend starts reading
+  const auto calls = backend_->Calls();
+  const auto open = std::find(calls.begin(), calls.end(), "Open /media/clip.mp4");
+  const auto limits = std::find(calls.begin(), calls.end(), "SetBufferLimits 5000ms 16777216/2097152");
+  ASSERT_NE(limits, calls.end());
+  EXPECT_LT(limits, open);
+
+  listener->OnPrepared(MakeInfo());
+  EXPECT_TRUE(WaitForCall("SetBufferLimits 5000ms 16777216/0"));
+  player_->Play();
+  ASSERT_TRUE(sink_.WaitFor("playbackStateChanged:playing"));
+  player_->Pause();
+  ASSERT_TRUE(sink_.WaitFor("playbackStateChanged:paused"));
+  player_->Dispose();
+  int full = 0;
+  for (const auto& call : backend_->Calls()) full += call == "SetBufferLimits 5000ms 16777216/2097152";
+  EXPECT_EQ(full, 2);
+}
+
+TEST_F(PlayerTest, DynamicBufferingGrowsAfterRebufferAndTrimsOnPressure) {
+  PlayerOptions options;
+  options.dynamic_buffering = true;
+  DecodeBackendListener* listener = Prepare(options);
+  player_->Play();
+  ASSERT_TRUE(sink_.WaitFor("playbackStateChanged:playing"));
+  listener->OnBufferingChanged(true);
+  ASSERT_TRUE(sink_.WaitFor("playbackStateChanged:buffering"));
+  EXPECT_TRUE(WaitForCall("SetBufferLimits 22500ms 50331648/8388608"));
+
+  player_->ShedMemory(MemoryPressureLevel::kModerate, MemoryShedStep::kForwardBuffers);
+  EXPECT_TRUE(WaitForCall("SetBufferLimits 11250ms 25165824/6291456"));
+}
+
+TEST_F(PlayerTest, LiveLatencyNudgesRateTowardsTarget) {
+  PlayerOptions options;
+  options.target_live_latency_ms = 3000;
+  DecodeBackendListener* listener = Open(options);
+  MediaInfo info = MakeInfo();
+  info.duration_ms = 0;
+  info.is_live = true;
+  listener->OnPrepared(info);
+  // Read-ahead reaches past the target so the edge stays in sight
+  EXPECT_TRUE(WaitForCall("SetBufferLimits 6000ms 8388608/0"));
+  backend_->live_latency_ms = 6000;
+  listener->OnBufferedPosition(5000);
+  player_->Play();
+  ASSERT_TRUE(WaitForCall("SetRate 1.050000"));
+  ASSERT_TRUE(sink_.WaitFor("liveLatency"));
+  const PlayerEvent event = sink_.EventsOfType("liveLatency").front();
+  EXPECT_EQ(std::get<int64_t>(event.Get("latency")), 6000);
+  EXPECT_EQ(std::get<int64_t>(event.Get("targetLatency")), 3000);
+  EXPECT_DOUBLE_EQ(std::get<double>(event.Get("playbackRate")), 1.05);
+  // Catching up is not a user speed change
+  EXPECT_EQ(sink_.Count("playbackSpeedChanged"), 0);
+
+  // An explicit speed wins over catching up
+  player_->SetPlaybackSpeed(1.5);
+  ASSERT_TRUE(WaitForCall("SetRate 1.500000"));
+  backend_->live_latency_ms = 8000;
+  ASSERT_TRUE(WaitUntil([&]() {
+    const auto events = sink_.EventsOfType("liveLatency");
+    return std::get<int64_t>(events.back().Get("latency")) == 8000;
+  }));
+  EXPECT_DOUBLE_EQ(std::get<double>(sink_.EventsOfType("liveLatency").back().Get("playbackRate")), 1.5);
+  EXPECT_EQ(backend_->Calls().back(), "SetRate 1.500000");
+  // Even one of 1.0
+  player_->SetPlaybackSpeed(1.0);
+  ASSERT_TRUE(WaitForCall("SetRate 1.000000"));
+  std::this_thread::sleep_for(Player::kPositionInterval * 2);
+  EXPECT_EQ(backend_->Calls().back(), "SetRate 1.000000");
+}
+
+TEST_F(PlayerTest, LiveLatencyCatchesUpAgainAfterSeekingToTheEdge) {
+  PlayerOptions options;
+  options.target_live_latency_ms = 3000;
+  options.playback_speed = 1.5;
+  DecodeBackendListener* listener = Open(options);
+  MediaInfo info = MakeInfo();
+  info.is_live = true;
+  listener->OnPrepared(info);
+  backend_->live_latency_ms = 6000;
+  listener->OnBufferedPosition(5000);
+  player_->Play();
+  ASSERT_TRUE(sink_.WaitFor("liveLatency"));
+  EXPECT_TRUE(backend_->HasCall("SetRate 1.500000"));
+  EXPECT_FALSE(backend_->HasCall("SetRate 1.050000"));
+
+  // Seeking back into the window keeps the user's speed
+  player_->SeekTo(1000);
+  ASSERT_TRUE(WaitForCall("Seek 1000"));
+  EXPECT_DOUBLE_EQ(player_->playback_speed(), 1.5);
+  player_->SeekTo(info.duration_ms);
+  ASSERT_TRUE(sink_.WaitFor("playbackSpeedChanged"));
+  EXPECT_DOUBLE_EQ(player_->playback_speed(), 1.0);
+  listener->OnBufferedPosition(info.duration_ms + 5000);
+  EXPECT_TRUE(WaitForCall("SetRate 1.050000"));
+}
+
+TEST_F(PlayerTest, LiveLatencyFarBehindJumpsToTarget) {
+  PlayerOptions options;
+  options.target_live_latency_ms = 3000;
+  DecodeBackendListener* listener = Open(options);
+  MediaInfo info = MakeInfo();
+  info.duration_ms = 0;
+  info.is_live = true;
+  listener->OnPrepared(info);
+  backend_->position_ms = 1000;
+  backend_->live_latency_ms = 20000;
+  player_->Play();
+  EXPECT_TRUE(WaitForCall("Seek 18000"));
+}
+
+TEST_F(PlayerTest, TargetLatencyIgnoredForOnDemand) {
+  PlayerOptions options;
+  options.target_live_latency_ms = 3000;
+  Prepare(options);
+  backend_->live_latency_ms = 20000;
+  player_->Play();
+  ASSERT_TRUE(sink_.WaitFor("playbackStateChanged:playing"));
+  std::this_thread::sleep_for(Player::kPositionInterval * 2);
+  EXPECT_EQ(sink_.Count("liveLatency"), 0);
+  for (const auto& call : backend_->Calls()) EXPECT_EQ(call.rfind("Seek", 0), std::string::npos);
+}
+
+TEST_F(PlayerTest, LivePlaylistSetsSeekableRangeAndBoundsSeeks) {
+  DecodeBackendListener* listener = Open();
+  MediaInfo info = MakeInfo();
+  info.duration_ms = 0;
+  info.is_live = true;
+  listener->OnPrepared(info);
+  ASSERT_TRUE(sink_.WaitFor("playbackStateChanged:ready"));
+
+  listener->OnLivePlaylist(
+      "#EXTM3U\n#EXT-X-TARGETDURATION:4\n#EXT-X-MEDIA-SEQUENCE:7\n"
+      "#EXTINF:4.0,\na.ts\n#EXTINF:4.0,\nb.ts\n#EXTINF:4.0,\nc.ts\n");
+  ASSERT_TRUE(sink_.WaitFor("seekableRangeChanged"));
+  EXPECT_EQ(player_->DurationMs(), 12000);
+  listener->OnLivePlaylist(
+      "#EXTM3U\n#EXT-X-TARGETDURATION:4\n#EXT-X-MEDIA-SEQUENCE:8\n"
+      "#EXTINF:4.0,\nb.ts\n#EXTINF:4.0,\nc.ts\n#EXTINF:4.0,\nd.ts\n");
+  ASSERT_TRUE(sink_.WaitFor("seekableRangeChanged", 2));
+  const PlayerEvent range = sink_.EventsOfType("seekableRangeChanged").back();
+  EXPECT_EQ(std::get<int64_t>(range.Get("start")), 4000);
+  EXPECT_EQ(std::get<int64_t>(range.Get("end")), 16000);
+  EXPECT_EQ(player_->DurationMs(), 16000);
+  // Unchanged refreshes are quiet
+  listener->OnLivePlaylist(
+      "#EXTM3U\n#EXT-X-TARGETDURATION:4\n#EXT-X-MEDIA-SEQUENCE:8\n"
+      "#EXTINF:4.0,\nb.ts\n#EXTINF:4.0,\nc.ts\n#EXTINF:4.0,\nd.ts\n");
+
+  player_->SeekTo(1000);
+  EXPECT_TRUE(WaitForCall("Seek 4000"));
+  player_->SeekTo(9000);
+  EXPECT_TRUE(WaitForCall("Seek 9000"));
+  player_->Dispose();
+  EXPECT_EQ(sink_.Count("seekableRangeChanged"), 2);
+}
+
+TEST_F(PlayerTest, MemoryPressureShedsInStepsAndReportsIt) {
+  DecodeBackendListener* listener = Prepare();
+  ASSERT_TRUE(WaitForCall("SetBufferLimits 15000ms 33554432/0"));
+  listener->OnSubtitleCue("s0", {1000, 2000, "near"});
+  listener->OnSubtitleCue("s0", {600000, 601000, "far"});
+
+  player_->ShedMemory(MemoryPressureLevel::kModerate, MemoryShedStep::kCaches);
+  player_->ShedMemory(MemoryPressureLevel::kModerate, MemoryShedStep::kSubtitleWindows);
+  ASSERT_TRUE(sink_.WaitFor("memoryPressure"));
+  auto events = sink_.EventsOfType("memoryPressure");
+  EXPECT_EQ(events[0].Get("level"), EventValue("moderate"));
+  EXPECT_EQ(events[0].Get("shed"), EventValue(EventList{"subtitleCues"}));
+
+  player_->ShedMemory(MemoryPressureLevel::kCritical, MemoryShedStep::kForwardBuffers);
+  ASSERT_TRUE(sink_.WaitFor("memoryPressure", 2));
+  EXPECT_TRUE(WaitForCall("SetBufferLimits 7500ms 16777216/0"));
+  EXPECT_EQ(sink_.EventsOfType("memoryPressure")[1].Get("shed"), EventValue(EventList{"buffers"}));
+
+  player_->ShedMemory(MemoryPressureLevel::kNone, MemoryShedStep::kCaches);
+  ASSERT_TRUE(sink_.WaitFor("memoryPressure", 3));
+  EXPECT_EQ(sink_.EventsOfType("memoryPressure")[2].Get("level"), EventValue("none"));
+  int restored = 0;
+  for (const auto& call : backend_->Calls()) restored += call == "SetBufferLimits 15000ms 33554432/0";
+  EXPECT_EQ(restored, 2);
+}
+
+TEST_F(PlayerTest, BufferedPositionOnlyEmittedWhenItGrows) {
+  DecodeBackendListener* listener = Prepare();
+  listener->OnBufferedPosition(2000);
+  listener->OnBufferedPosition(1500);
+  listener->OnBufferedPosition(3000);
+  ASSERT_TRUE(sink_.WaitFor("bufferedPositionChanged", 2));
+  player_->Dispose();
+  EXPECT_EQ(sink_.Count("bufferedPositionChanged"), 2);
+}
+
+TEST_F(PlayerTest, PreferredLanguagesSelectTracks) {
+  PlayerOptions options;
+  options.preferred_audio_language = "de";
+  options.preferred_subtitle_language = "FR";
+  Prepare(options);
+  EXPECT_TRUE(backend_->HasCall("SetPreferredLanguages de,FR"));
+  EXPECT_TRUE(WaitForCall("SelectAudioTrack a1"));
+  EXPECT_TRUE(WaitForCall("SelectSubtitleTrack s1"));
+  EXPECT_EQ(player_->selected_audio_track_id(), "a1");
+  EXPECT_EQ(player_->selected_subtitle_track_id(), "s1");
+}
+
+TEST_F(PlayerTest, PreferredRenditionPicksAmongSameLanguage) {
+  PlayerOptions options;
+  options.preferred_audio_language = "en";
+  options.preferred_audio_rendition = "commentary";
+  DecodeBackendListener* listener = Open(options);
+  MediaInfo info = MakeInfo();
+  info.audio_tracks.push_back({"a2", "Commentary", "en", 2, false});
+  info.audio_tracks.push_back({"a3", "Commentary", "de", 2, false});
+  listener->OnPrepared(info);
+  EXPECT_TRUE(WaitForCall("SelectAudioTrack a2"));
+  EXPECT_TRUE(WaitUntil([&]() { return player_->selected_audio_track_id() == "a2"; }));
+}
+
+TEST_F(PlayerTest, TrackBackendOpenedOnIsNotSelectedAgain) {
+  PlayerOptions options;
+  options.preferred_audio_language = "de";
+  DecodeBackendListener* listener = Open(options);
+  MediaInfo info = MakeInfo();
+  info.selected_audio_track_id = "a1";
+  listener->OnPrepared(info);
+  ASSERT_TRUE(WaitUntil([&]() { return player_->selected_audio_track_id() == "a1"; }));
+  EXPECT_FALSE(backend_->HasCall("SelectAudioTrack a1"));
+
+  // Switching to the current track is a no-op: no decoder restart, no event
+  std::atomic<bool> done{false};
+  player_->SetAudioTrack("a1", [&](const CommandResult& result) { done = result.ok(); });
+  EXPECT_TRUE(WaitUntil([&]() { return done.load(); }));
+  EXPECT_FALSE(backend_->HasCall("SelectAudioTrack a1"));
+  EXPECT_EQ(sink_.Count("selectedAudioChanged"), 0);
+}
+
+TEST_F(PlayerTest, DefaultAudioTrackWithoutPreference) {
+  Prepare();
+  EXPECT_TRUE(WaitForCall("SelectAudioTrack a0"));
+  EXPECT_EQ(player_->selected_subtitle_track_id(), "");
+}
+
+TEST_F(PlayerTest, SelectingTracksEmitsSelectionEvents) {
+  Prepare();
+  player_->SetAudioTrack("a1");
+  ASSERT_TRUE(sink_.WaitFor("selectedAudioChanged"));
+  const auto selected = sink_.EventsOfType("selectedAudioChanged");
+  const auto& track = std::get<EventMap>(selected[0].Get("track"));
+  EXPECT_EQ(track[0].first, "id");
+  EXPECT_EQ(std::get<std::string>(track[0].second), "a1");
+
+  player_->SetSubtitleTrack("");
+  ASSERT_TRUE(sink_.WaitFor("selectedSubtitleChanged"));
+  EXPECT_TRUE(sink_.EventsOfType("selectedSubtitleChanged")[0].Get("track").is_null());
+
+  player_->SetAudioTrack("missing");
+  EXPECT_TRUE(sink_.WaitFor("error:AUDIO_ERROR"));
+}
+
+TEST_F(PlayerTest, TrackChangesOnlyEmittedWhenDifferent) {
+  DecodeBackendListener* listener = Prepare();
+  ASSERT_TRUE(sink_.WaitFor("audioTracks:2"));
+  const MediaInfo info = MakeInfo();
+  listener->OnTracksChanged(info.audio_tracks, info.subtitle_tracks);
+  listener->OnTracksChanged({info.audio_tracks[0]}, info.subtitle_tracks);
+  ASSERT_TRUE(sink_.WaitFor("audioTracks:1"));
+  EXPECT_EQ(sink_.Count("audioTracks:2"), 1);
+  EXPECT_EQ(sink_.Count("subtitleTracks:2"), 1);
+}
+
+TEST_F(PlayerTest, TracksReportedBeforePrepareAreNotRepeated) {
+  DecodeBackendListener* listener = Open();
+  const MediaInfo info = MakeInfo();
+  listener->OnTracksChanged(info.audio_tracks, info.subtitle_tracks);
+  listener->OnPrepared(info);
+  ASSERT_TRUE(sink_.WaitFor("playbackStateChanged:ready"));
+  EXPECT_EQ(sink_.Count("audioTracks:2"), 1);
+  EXPECT_EQ(sink_.Count("subtitleTracks:2"), 1);
+}
+
+TEST_F(PlayerTest, ExternalSubtitlesJoinTrackListAndEmitCues) {
+  Prepare();
+  ASSERT_TRUE(sink_.WaitFor("subtitleTracks:2"));
+  player_->SetSubtitleRenderMode(SubtitleRenderMode::kFlutter);
+  EXPECT_TRUE(WaitForCall("SetSubtitleCuesEnabled true"));
+
+  ExternalSubtitle subtitle;
+  subtitle.format = SubtitleFormat::kSrt;
+  subtitle.content = "1\n00:00:01,000 --> 00:00:02,000\nFrom a file\n";
+  subtitle.language = "en";
+  std::mutex mutex;
+  SubtitleTrack added;
+  player_->AddExternalSubtitle(subtitle, [&](const CommandResult& result, const SubtitleTrack& track) {
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_TRUE(result.ok());
+    added = track;
+  });
+  ASSERT_TRUE(sink_.WaitFor("subtitleTracks:3"));
+  std::string track_id;
+  ASSERT_TRUE(WaitUntil([&]() {
+    std::lock_guard<std::mutex> lock(mutex);
+    track_id = added.id;
+    return !track_id.empty();
+  }));
+
+  // The backend's own subtitle stream stays off for external tracks
+  player_->SetSubtitleTrack(track_id);
+  EXPECT_TRUE(WaitForCall("SelectSubtitleTrack "));
+  player_->SeekTo(1500);
+  ASSERT_TRUE(sink_.WaitFor("embeddedSubtitleCue"));
+  auto cues = sink_.EventsOfType("embeddedSubtitleCue");
+  EXPECT_EQ(std::get<std::string>(cues[0].Get("text")), "From a file");
+  EXPECT_EQ(std::get<int64_t>(cues[0].Get("startMs")), 1000);
+  EXPECT_EQ(std::get<int64_t>(cues[0].Get("endMs")), 2000);
+  EXPECT_EQ(std::get<std::string>(cues[0].Get("trackId")), track_id);
+
+  player_->SeekTo(3000);
+  ASSERT_TRUE(sink_.WaitFor("embeddedSubtitleCue", 2));
+  EXPECT_TRUE(sink_.EventsOfType("embeddedSubtitleCue")[1].Get("text").is_null());
+
+  player_->RemoveExternalSubtitle(track_id);
+  ASSERT_TRUE(sink_.WaitFor("subtitleTracks:2", 2));
+  EXPECT_EQ(player_->selected_subtitle_track_id(), "");
+}
+
+TEST_F(PlayerTest, UnparseableExternalSubtitleFails) {
+  Prepare();
+  ExternalSubtitle subtitle;
+  subtitle.format = SubtitleFormat::kVtt;
+  subtitle.content = "not subtitles";
+  std::atomic<bool> failed{false};
+  player_->AddExternalSubtitle(subtitle, [&](const CommandResult& result, const SubtitleTrack&) {
+    failed = result.code == "SUBTITLE_ERROR";
+  });
+  EXPECT_TRUE(WaitUntil([&]() { return failed.load(); }));
+  EXPECT_EQ(player_->subtitle_tracks().size(), 2u);
+}
+
+TEST_F(PlayerTest, EmbeddedCuesFromBackendAreEmittedOnce) {
+  DecodeBackendListener* listener = Prepare();
+  player_->SetSubtitleRenderMode(SubtitleRenderMode::kFlutter);
+  player_->SetSubtitleTrack("s0");
+  player_->SeekTo(1200);
+  ASSERT_TRUE(sink_.WaitFor("positionChanged"));
+
+  SubtitleCue cue;
+  cue.start_ms = 1000;
+  cue.end_ms = 2000;
+  cue.text = "Embedded";
+  listener->OnSubtitleCue("s0", cue);
+  ASSERT_TRUE(sink_.WaitFor("embeddedSubtitleCue"));
+  // Re-delivered after a seek, and a cue for an unselected track
+  listener->OnSubtitleCue("s0", cue);
+  listener->OnSubtitleCue("s1", cue);
+  std::atomic<bool> synced{false};
+  player_->SetLooping(false, [&](const CommandResult&) { synced = true; });
+  ASSERT_TRUE(WaitUntil([&]() { return synced.load(); }));
+  EXPECT_EQ(sink_.Count("embeddedSubtitleCue"), 1);
+  EXPECT_EQ(std::get<std::string>(sink_.EventsOfType("embeddedSubtitleCue")[0].Get("trackId")), "s0");
+}
+
+TEST_F(PlayerTest, PreferredSubtitleLanguageAppliesToLateTracks) {
+  PlayerOptions options;
+  options.preferred_subtitle_language = "it";
+  DecodeBackendListener* listener = Prepare(options);
+  EXPECT_EQ(player_->selected_subtitle_track_id(), "");
+
+  MediaInfo info = MakeInfo();
+  info.subtitle_tracks.push_back({"s2", "Italiano", "it-IT", false});
+  listener->OnTracksChanged(info.audio_tracks, info.subtitle_tracks);
+  ASSERT_TRUE(sink_.WaitFor("subtitleTracks:3"));
+  EXPECT_TRUE(WaitForCall("SelectSubtitleTrack s2"));
+  EXPECT_TRUE(sink_.WaitFor("selectedSubtitleChanged"));
+  EXPECT_EQ(player_->selected_subtitle_track_id(), "s2");
+}
+
+TEST_F(PlayerTest, FrameRateCapReachesBackend) {
+  DecodeBackendListener* listener = Prepare();
+  player_->SetMaxRenderFrameRate(10.0);
+  ASSERT_TRUE(WaitForCall("SetRenderPolicy 100000 visible"));
+  // Frames are dropped in the backend, before conversion; whatever
+  // arrives is presented
+  for (int i = 0; i < 3; ++i) {
+    VideoFrame frame;
+    frame.pts_ms = i;
+    listener->OnFrame(frame);
+  }
+  EXPECT_EQ(player_->frames_rendered(), 3u);
+  EXPECT_EQ(sink_.frames(), 3);
+
+  player_->SetMaxRenderFrameRate(std::nullopt);
+  EXPECT_TRUE(WaitForCall("SetRenderPolicy 0 visible"));
+  EXPECT_FALSE(backend_->HasCall("SetVideoEnabled false"));
+}
+
+TEST_F(PlayerTest, HiddenPlayerStopsVideoDecoding) {
+  Prepare();
+  player_->SetVisibilityHint(false);
+  ASSERT_TRUE(WaitForCall("SetVideoEnabled false"));
+  EXPECT_TRUE(backend_->HasCall("SetRenderPolicy 0 hidden"));
+
+  player_->SetVisibilityHint(true);
+  ASSERT_TRUE(WaitForCall("SetVideoEnabled true"));
+  EXPECT_TRUE(backend_->HasCall("SetRenderPolicy 0 visible"));
+}
+
+TEST_F(PlayerTest, CaptureFrameEncodesTheLatestFrame) {
+  DecodeBackendListener* listener = Prepare();
+  std::mutex mutex;
+  std::vector<std::pair<CommandResult, CapturedFrame>> replies;
+  const auto record = [&](const CommandResult& result, const CapturedFrame& frame) {
+    std::lock_guard<std::mutex> lock(mutex);
+    replies.emplace_back(result, frame);
+  };
+  EXPECT_FALSE(player_->CaptureFrame(0, CaptureFormat::kRaw, record));
+  ASSERT_EQ(replies.size(), 1u);
+  EXPECT_EQ(replies[0].first.code, "CAPTURE_ERROR");
+
+  // A 4x2 BGRA frame whose buffer the backend owns, then a newer one
+  auto pixels = std::make_shared<std::vector<uint8_t>>(4 * 2 * 4, 0);
+  for (size_t i = 0; i < pixels->size(); i += 4) (*pixels)[i] = 200;
+  VideoFrame frame;
+  frame.width = 4;
+  frame.height = 2;
+  frame.stride = 16;
+  frame.format = PixelFormat::kBgra;
+  frame.pts_ms = 40;
+  frame.data = pixels->data();
+  frame.owner = pixels;
+  listener->OnFrame(frame);
+  frame.pts_ms = 80;
+  listener->OnFrame(frame);
+  std::weak_ptr<std::vector<uint8_t>> buffer = pixels;
+  pixels.reset();
+  frame = VideoFrame();
+  // Held for capturing
+  EXPECT_FALSE(buffer.expired());
+
+  EXPECT_TRUE(player_->CaptureFrame(2, CaptureFormat::kRaw, record));
+  EXPECT_TRUE(player_->CaptureFrame(0, CaptureFormat::kPng, record));
+  ASSERT_TRUE(WaitUntil([&]() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return replies.size() == 3;
+  }));
+  EXPECT_TRUE(replies[1].first.ok());
+  EXPECT_EQ(replies[1].second.width, 2);
+  EXPECT_EQ(replies[1].second.height, 1);
+  EXPECT_EQ(replies[1].second.pts_ms, 80);
+  EXPECT_EQ(replies[1].second.bytes, (std::vector<uint8_t>{0, 0, 200, 0, 0, 0, 200, 0}));
+  EXPECT_EQ(replies[2].second.format, CaptureFormat::kPng);
+  EXPECT_EQ(replies[2].second.width, 4);
+
+  // Disposing lets go of the frame
+  player_->Dispose();
+  EXPECT_TRUE(buffer.expired());
+  EXPECT_FALSE(player_->CaptureFrame(0, CaptureFormat::kRaw, record));
+  EXPECT_EQ(replies.back().first.code, "INVALID_PLAYER");
+}
+
+TEST_F(PlayerTest, CaptureFrameBoundsPendingCapturesAndLetsGoOfFrames) {
+  DecodeBackendListener* listener = Prepare();
+  // A callback may capture again, even from an error reply
+  std::atomic<int> errors{0};
+  Player::CaptureCallback retry;
+  retry = [&](const CommandResult& result, const CapturedFrame&) {
+    if (!result.ok() && errors.fetch_add(1) == 0) player_->CaptureFrame(0, CaptureFormat::kRaw, retry);
+  };
+  EXPECT_FALSE(player_->CaptureFrame(0, CaptureFormat::kRaw, retry));
+  EXPECT_EQ(errors.load(), 2);
+
+  auto pixels = std::make_shared<std::vector<uint8_t>>(2 * 2 * 4, 100);
+  VideoFrame frame;
+  frame.width = 2;
+  frame.height = 2;
+  frame.stride = 8;
+  frame.format = PixelFormat::kRgba;
+  frame.data = pixels->data();
+  frame.owner = pixels;
+  listener->OnFrame(frame);
+  std::weak_ptr<std::vector<uint8_t>> buffer = pixels;
+  pixels.reset();
+  frame = VideoFrame();
+
+  // The first reply blocks the capture thread; the queue behind it fills up
+  std::mutex mutex;
+  std::condition_variable released;
+  bool release = false;
+  std::atomic<int> replies{0};
+  std::atomic<int> refused{0};
+  const auto record = [&](const CommandResult& result, const CapturedFrame&) {
+    if (!result.ok()) {
+      ++refused;
+      return;
+    }
+    if (replies.fetch_add(1) == 0) {
+      std::unique_lock<std::mutex> lock(mutex);
+      released.wait(lock, [&]() { return release; });
+    }
+  };
+  EXPECT_TRUE(player_->CaptureFrame(0, CaptureFormat::kRaw, record));
+  ASSERT_TRUE(WaitUntil([&]() { return replies.load() == 1; }));
+  // Nothing keeps the frame but the player's own reference
+  listener->OnFrame(VideoFrame());
+  EXPECT_TRUE(buffer.expired());
+
+  pixels = std::make_shared<std::vector<uint8_t>>(2 * 2 * 4, 100);
+  frame.width = 2;
+  frame.height = 2;
+  frame.stride = 8;
+  frame.format = PixelFormat::kRgba;
+  frame.data = pixels->data();
+  frame.owner = pixels;
+  listener->OnFrame(frame);
+  for (int i = 0; i < Player::kMaxPendingCaptures; ++i) {
+    EXPECT_TRUE(player_->CaptureFrame(0, CaptureFormat::kRaw, record));
+  }
+  EXPECT_FALSE(player_->CaptureFrame(0, CaptureFormat::kRaw, record));
+  EXPECT_EQ(refused.load(), 1);
+  // Disposing waits for the queued captures, which still finish
+  std::thread dispose([&]() { player_->Dispose(); });
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    release = true;
+  }
+  released.notify_all();
+  dispose.join();
+  EXPECT_EQ(replies.load(), 1 + Player::kMaxPendingCaptures);
+}
+
+TEST_F(PlayerTest, ZeroFpsCapBeforePrepareAppliesOnPrepare) {
+  DecodeBackendListener* listener = Open();
+  player_->SetMaxRenderFrameRate(0.0);
+  listener->OnPrepared(MakeInfo());
+  EXPECT_TRUE(WaitForCall("SetVideoEnabled false"));
+}
+
+TEST_F(PlayerTest, DisplaySizeReachesBackend) {
+  Prepare();
+  player_->SetDisplaySize(640, 360);
+  EXPECT_TRUE(WaitForCall("SetOutputSizeHint 640x360"));
+}
+
+TEST_F(PlayerTest, ErrorMovesToErrorState) {
+  DecodeBackendListener* listener = Open();
+  listener->OnError("source_not_found", "404");
+  ASSERT_TRUE(sink_.WaitFor("error:source_not_found"));
+  EXPECT_EQ(player_->state(), PlaybackState::kError);
+}
+
+TEST_F(PlayerTest, PositionTicksWhilePlaying) {
+  Prepare();
+  player_->Play();
+  ASSERT_TRUE(sink_.WaitFor("playbackStateChanged:playing"));
+  backend_->position_ms = 1500;
+  ASSERT_TRUE(WaitUntil(
+      [&]() {
+        for (const auto& event : sink_.EventsOfType("positionChanged")) {
+          if (std::get<int64_t>(event.Get("position")) >= 1500) return true;
+        }
+        return false;
+      },
+      std::chrono::milliseconds(3000)));
+}
+
+TEST_F(PlayerTest, AudioLevelsAreOptIn) {
+  std::vector<float> audio(2 * 4800, 0.5f);
+  AudioSamples samples;
+  samples.data = audio.data();
+  samples.frames = 4800;
+  samples.channels = 2;
+  samples.sample_rate = 48000;
+
+  DecodeBackendListener* listener = Prepare();
+  EXPECT_FALSE(backend_->HasCall("SetAudioTapEnabled true"));
+  listener->OnAudioSamples(samples);
+  listener->OnAudioLevels(AudioLevels{{0.5f}, {0.5f}});
+  player_->Play();
+  ASSERT_TRUE(sink_.WaitFor("playbackStateChanged:playing"));
+  EXPECT_EQ(sink_.Count("audioLevelsChanged"), 0);
+}
+
+TEST_F(PlayerTest, AudioLevelsEmittedPerWindowWhenEnabled) {
+  PlayerOptions options;
+  options.enable_audio_levels = true;
+  DecodeBackendListener* listener = Prepare(options);
+  EXPECT_TRUE(backend_->HasCall("SetAudioTapEnabled true"));
+
+  // 100 ms in 10 ms chunks -> two 50 ms windows
+  std::vector<float> audio(2 * 480);
+  for (size_t i = 0; i < audio.size(); i += 2) {
+    audio[i] = 0.5f;
+    audio[i + 1] = -0.25f;
+  }
+  AudioSamples samples;
+  samples.data = audio.data();
+  samples.frames = 480;
+  samples.channels = 2;
+  samples.sample_rate = 48000;
+  for (int i = 0; i < 10; ++i) listener->OnAudioSamples(samples);
+
+  ASSERT_TRUE(sink_.WaitFor("audioLevelsChanged", 2));
+  const PlayerEvent event = sink_.EventsOfType("audioLevelsChanged").front();
+  const auto& peak = std::get<EventList>(event.Get("peak"));
+  const auto& rms = std::get<EventList>(event.Get("rms"));
+  ASSERT_EQ(peak.size(), 2u);
+  EXPECT_DOUBLE_EQ(std::get<double>(peak[0]), 0.5);
+  EXPECT_DOUBLE_EQ(std::get<double>(peak[1]), 0.25);
+  EXPECT_NEAR(std::get<double>(rms[0]), 0.5, 1e-6);
+  EXPECT_NEAR(std::get<double>(rms[1]), 0.25, 1e-6);
+}
+
+TEST_F(PlayerTest, EngineMeteredAudioLevelsAreForwarded) {
+  AudioLevels levels;
+  levels.peak = {0.5f, 0.25f};
+  levels.rms = {0.125f, 0.0625f};
+
+  PlayerOptions options;
+  options.enable_audio_levels = true;
+  DecodeBackendListener* listener = Prepare(options);
+  listener->OnAudioLevels(levels);
+  ASSERT_TRUE(sink_.WaitFor("audioLevelsChanged"));
+  const PlayerEvent event = sink_.EventsOfType("audioLevelsChanged").front();
+  const auto& peak = std::get<EventList>(event.Get("peak"));
+  const auto& rms = std::get<EventList>(event.Get("rms"));
+  ASSERT_EQ(peak.size(), 2u);
+  EXPECT_DOUBLE_EQ(std::get<double>(peak[1]), 0.25);
+  EXPECT_DOUBLE_EQ(std::get<double>(rms[0]), 0.125);
+}
+
+TEST_F(PlayerTest, WaveformIsScannedOnceAndCachedOnDisk) {
+  char directory[] = "/tmp/pvp-player-waveform-XXXXXX";
+  ASSERT_NE(mkdtemp(directory), nullptr);
+  const std::string previous = WaveformCache::Instance().directory();
+  WaveformCache::Instance().SetDirectory(directory);
+
+  // 1 s of mono at 1 kHz, loud in the second half
+  backend_->scan_audio.assign(1000, 0.1f);
+  std::fill(backend_->scan_audio.begin() + 500, backend_->scan_audio.end(), 1.0f);
+  Prepare();
+
+  std::mutex mutex;
+  std::vector<std::vector<uint8_t>> replies;
+  auto record = [&](const CommandResult& result, const std::vector<uint8_t>& peaks) {
+    EXPECT_TRUE(result.ok()) << result.code;
+    std::lock_guard<std::mutex> lock(mutex);
+    replies.push_back(peaks);
+  };
+  EXPECT_TRUE(player_->GetWaveform(2, record));
+  EXPECT_TRUE(player_->GetWaveform(4, record));
+  ASSERT_TRUE(WaitUntil([&]() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return replies.size() == 2;
+  }));
+  EXPECT_EQ(replies[0], (std::vector<uint8_t>{26, 255}));
+  EXPECT_EQ(replies[1], (std::vector<uint8_t>{26, 26, 255, 255}));
+  EXPECT_EQ(backend_->scans.load(), 1);
+
+  // A second player for the same file reads it from disk
+  auto other_backend = std::make_shared<FakeBackendState>();
+  Player other(8, std::make_unique<FakeDecodeBackend>(other_backend), &sink_, &sink_);
+  MediaSource source;
+  source.type = SourceType::kFile;
+  source.uri = "/media/clip.mp4";
+  ASSERT_TRUE(other.Initialize(source, PlayerOptions()));
+  ASSERT_TRUE(other.GetWaveform(2, record));
+  ASSERT_TRUE(WaitUntil([&]() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return replies.size() == 3;
+  }));
+  EXPECT_EQ(replies[2], (std::vector<uint8_t>{26, 255}));
+  EXPECT_EQ(other_backend->scans.load(), 0);
+  other.Dispose();
+
+  WaveformCache::Instance().SetDirectory(previous);
+  std::filesystem::remove_all(directory);
+}
+
+TEST_F(PlayerTest, WaveformIsEmptyWhenBackendCannotScan) {
+  Prepare();
+  std::atomic<bool> replied{false};
+  std::vector<uint8_t> peaks = {1};
+  EXPECT_TRUE(player_->GetWaveform(10, [&](const CommandResult& result, const std::vector<uint8_t>& p) {
+    EXPECT_TRUE(result.ok());
+    peaks = p;
+    replied = true;
+  }));
+  ASSERT_TRUE(WaitUntil([&]() { return replied.load(); }));
+  EXPECT_TRUE(peaks.empty());
+
+  std::string code;
+  EXPECT_FALSE(player_->GetWaveform(0, [&](const CommandResult& result, const std::vector<uint8_t>&) {
+    code = result.code;
+  }));
+  EXPECT_EQ(code, "INVALID_ARGS");
+}
+
+TEST_F(PlayerTest, DisposeClosesBackendAndSilencesEvents) {
+  DecodeBackendListener* listener = Prepare();
+  const size_t before = sink_.Entries().size();
+  player_->Dispose();
+  EXPECT_TRUE(backend_->HasCall("Close"));
+  EXPECT_EQ(player_->state(), PlaybackState::kDisposed);
+
+  listener->OnEndOfStream();
+  listener->OnFrame(VideoFrame());
+  EXPECT_FALSE(player_->Play());
+  EXPECT_EQ(sink_.Entries().size(), before);
+  EXPECT_EQ(sink_.frames(), 0);
+
+  player_->Dispose();
+}
+
+}  // namespace
+}  // namespace pro_video_player
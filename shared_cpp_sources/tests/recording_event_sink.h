@@ -0,0 +1,112 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_TESTS_RECORDING_EVENT_SINK_H_
+#define PRO_VIDEO_PLAYER_SHARED_TESTS_RECORDING_EVENT_SINK_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "player_event_sink.h"
+
+namespace pro_video_player {
+namespace testing {
+
+// Polls |predicate| until it holds, for state that isn't signalled by an
+// event (e.g. calls reaching the backend).
+inline bool WaitUntil(const std::function<bool()>& predicate,
+                      std::chrono::milliseconds timeout = std::chrono::milliseconds(2000)) {
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (!predicate()) {
+    if (std::chrono::steady_clock::now() >= deadline) return false;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+// Flattens everything a player reports into "type[:detail]" strings so tests
+// can wait for and assert on event sequences.
+class RecordingEventSink : public PlayerEventSink, public FrameSink {
+ public:
+  void OnEvent(int64_t, const PlayerEvent& event) override {
+    std::string entry = event.type;
+    if (event.type == "playbackStateChanged") {
+      entry += ":" + std::get<std::string>(event.Get("state"));
+    }
+    Add(entry, event);
+  }
+  void OnError(int64_t, const std::string& code, const std::string&) override {
+    Add("error:" + code, PlayerEvent("error"));
+  }
+  void OnPlaybackCompleted(int64_t) override { Add("completed", PlayerEvent("completed")); }
+  void OnAudioTracksChanged(int64_t, const std::vector<AudioTrack>& tracks) override {
+    Add("audioTracks:" + std::to_string(tracks.size()), PlayerEvent("audioTracks"));
+  }
+  void OnSubtitleTracksChanged(int64_t, const std::vector<SubtitleTrack>& tracks) override {
+    Add("subtitleTracks:" + std::to_string(tracks.size()), PlayerEvent("subtitleTracks"));
+  }
+  void OnFrame(int64_t, const VideoFrame&) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++frames_;
+  }
+
+  std::vector<std::string> Entries() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_;
+  }
+
+  std::vector<PlayerEvent> EventsOfType(const std::string& type) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<PlayerEvent> result;
+    for (const auto& event : events_) {
+      if (event.type == type) result.push_back(event);
+    }
+    return result;
+  }
+
+  int frames() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return frames_;
+  }
+
+  // Waits until |entry| has been recorded |count| times.
+  bool WaitFor(const std::string& entry, int count = 1,
+               std::chrono::milliseconds timeout = std::chrono::milliseconds(2000)) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return changed_.wait_for(lock, timeout, [&]() {
+      int seen = 0;
+      for (const auto& e : entries_) seen += e == entry ? 1 : 0;
+      return seen >= count;
+    });
+  }
+
+  int Count(const std::string& entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int seen = 0;
+    for (const auto& e : entries_) seen += e == entry ? 1 : 0;
+    return seen;
+  }
+
+ private:
+  void Add(const std::string& entry, const PlayerEvent& event) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      entries_.push_back(entry);
+      events_.push_back(event);
+    }
+    changed_.notify_all();
+  }
+
+  std::mutex mutex_;
+  std::condition_variable changed_;
+  std::vector<std::string> entries_;
+  std::vector<PlayerEvent> events_;
+  int frames_ = 0;
+};
+
+}  // namespace testing
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_TESTS_RECORDING_EVENT_SINK_H_
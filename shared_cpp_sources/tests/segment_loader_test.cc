@@ -0,0 +1,221 @@
+#include "segment_loader.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "local_http_server.h"
+#include "recording_event_sink.h"
+
+namespace pro_video_player {
+namespace {
+
+using ::pro_video_player::testing::LocalHttpServer;
+using ::pro_video_player::testing::WaitUntil;
+
+// Segment paths are "/seg<N>.ts"; returns N.
+int SegmentNumber(const std::string& path) { return std::stoi(path.substr(4)); }
+
+std::vector<SegmentRequest> Playlist(const LocalHttpServer& server, int count) {
+  std::vector<SegmentRequest> segments;
+  for (int i = 0; i < count; ++i) segments.push_back({server.url("/seg" + std::to_string(i) + ".ts")});
+  return segments;
+}
+
+// Records what the sink receives.
+class Delivered {
+ public:
+  SegmentLoader::Sink Sink() {
+    return [this](size_t index, const HttpResponse& response) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      indexes_.push_back(index);
+      bodies_.emplace_back(response.body.begin(), response.body.end());
+      ok_.push_back(response.ok());
+    };
+  }
+
+  bool WaitFor(size_t count) {
+    return WaitUntil([&]() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return indexes_.size() >= count;
+    });
+  }
+
+  std::vector<size_t> indexes() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return indexes_;
+  }
+  std::vector<std::string> bodies() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bodies_;
+  }
+  std::vector<bool> ok() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ok_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<size_t> indexes_;
+  std::vector<std::string> bodies_;
+  std::vector<bool> ok_;
+};
+
+TEST(SegmentParallelismTest, CoversTheRoundTrip) {
+  using std::chrono::milliseconds;
+  // 100 ms RTT at 1 MB/s with 1 MB segments: a tenth of a segment per
+  // round trip, so one more request hides it
+  EXPECT_EQ(SegmentParallelism(milliseconds(100), 1e6, 1e6, 1, 6), 2);
+  // Same RTT at 10 MB/s with 250 kB segments: 4 segments per round trip
+  EXPECT_EQ(SegmentParallelism(milliseconds(100), 1e7, 2.5e5, 1, 6), 5);
+  EXPECT_EQ(SegmentParallelism(milliseconds(500), 1e8, 1e5, 1, 6), 6);
+  EXPECT_EQ(SegmentParallelism(milliseconds(0), 1e8, 1e5, 1, 6), 1);
+  EXPECT_EQ(SegmentParallelism(milliseconds(0), 1e8, 1e5, 3, 6), 3);
+  EXPECT_EQ(SegmentParallelism(milliseconds(100), 0, 0, 1, 6), 1);
+}
+
+TEST(SegmentLoaderTest, DeliversInOrderWhenLaterSegmentsFinishFirst) {
+  LocalHttpServer server([](const LocalHttpServer::Request& request) {
+    // Earlier segments are slower, so they complete out of order
+    const int number = SegmentNumber(request.path);
+    std::this_thread::sleep_for(std::chrono::milliseconds(number % 2 == 0 ? 60 : 5));
+    LocalHttpServer::Response response;
+    response.body = "segment " + std::to_string(number);
+    return response;
+  });
+  HttpFetcher fetcher;
+  Delivered delivered;
+  SegmentLoader::Options options;
+  options.min_parallel = 4;
+  options.initial_parallel = 4;
+  SegmentLoader loader(&fetcher, MediaSource(), options, delivered.Sink());
+  loader.Append(Playlist(server, 8));
+  ASSERT_TRUE(delivered.WaitFor(8));
+
+  const auto indexes = delivered.indexes();
+  const auto bodies = delivered.bodies();
+  for (size_t i = 0; i < 8; ++i) {
+    EXPECT_EQ(indexes[i], i);
+    EXPECT_EQ(bodies[i], "segment " + std::to_string(i));
+  }
+  EXPECT_GT(server.connections(), 1);
+  EXPECT_EQ(loader.next_index(), 8u);
+}
+
+TEST(SegmentLoaderTest, WidensTheWindowOnSlowRoundTrips) {
+  std::mutex mutex;
+  int active = 0;
+  int peak = 0;
+  LocalHttpServer server([&](const LocalHttpServer::Request&) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      peak = std::max(peak, ++active);
+    }
+    // High latency, tiny body: almost all of a fetch is waiting
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      --active;
+    }
+    LocalHttpServer::Response response;
+    response.body = std::string(1000, 'x');
+    return response;
+  });
+  HttpFetcher fetcher;
+  Delivered delivered;
+  SegmentLoader loader(&fetcher, MediaSource(), SegmentLoader::Options(), delivered.Sink());
+  loader.Append(Playlist(server, 24));
+  ASSERT_TRUE(delivered.WaitFor(24));
+
+  EXPECT_EQ(loader.estimate().parallelism, 6);
+  EXPECT_GE(loader.estimate().rtt, std::chrono::milliseconds(30));
+  std::lock_guard<std::mutex> lock(mutex);
+  EXPECT_GT(peak, 2);
+}
+
+TEST(SegmentLoaderTest, RetriesServerErrorsAndDeliversFinalFailures) {
+  std::atomic<int> seg1_attempts{0};
+  LocalHttpServer server([&](const LocalHttpServer::Request& request) {
+    LocalHttpServer::Response response;
+    const int number = SegmentNumber(request.path);
+    if (number == 1 && ++seg1_attempts < 2) response.status = 503;
+    if (number == 2) response.status = 404;
+    response.body = "segment " + std::to_string(number);
+    return response;
+  });
+  HttpFetcher fetcher;
+  Delivered delivered;
+  SegmentLoader loader(&fetcher, MediaSource(), SegmentLoader::Options(), delivered.Sink());
+  loader.Append(Playlist(server, 4));
+  ASSERT_TRUE(delivered.WaitFor(4));
+
+  EXPECT_EQ(delivered.indexes(), (std::vector<size_t>{0, 1, 2, 3}));
+  EXPECT_EQ(delivered.ok(), (std::vector<bool>{true, true, false, true}));
+  EXPECT_EQ(seg1_attempts.load(), 2);
+  int seg2_requests = 0;
+  for (const auto& request : server.requests()) seg2_requests += request.path == "/seg2.ts";
+  EXPECT_EQ(seg2_requests, 1);
+}
+
+TEST(SegmentLoaderTest, SeekRestartsFromTheNewIndex) {
+  LocalHttpServer server([](const LocalHttpServer::Request& request) {
+    if (SegmentNumber(request.path) < 10) std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    LocalHttpServer::Response response;
+    response.body = request.path;
+    return response;
+  });
+  HttpFetcher fetcher;
+  Delivered delivered;
+  SegmentLoader loader(&fetcher, MediaSource(), SegmentLoader::Options(), delivered.Sink());
+  loader.Append(Playlist(server, 14));
+  loader.Seek(10);
+  ASSERT_TRUE(delivered.WaitFor(4));
+
+  EXPECT_EQ(delivered.indexes(), (std::vector<size_t>{10, 11, 12, 13}));
+}
+
+TEST(SegmentLoaderTest, DecryptsAes128SegmentsWithOneKeyFetch) {
+  // "hls segment payload, 36 bytes long!!" under key 000102..0f, IV 00..07
+  const uint8_t ciphertext[] = {0xa8, 0xd2, 0xf3, 0xb8, 0xe2, 0x21, 0x11, 0x43, 0xd8, 0x90, 0xda, 0x56,
+                                0x86, 0x7e, 0x35, 0x8a, 0x0c, 0xbf, 0x9a, 0x47, 0xef, 0x3a, 0x6f, 0xd1,
+                                0xf7, 0x8f, 0xc9, 0xf1, 0x59, 0xff, 0x10, 0xcc, 0xbf, 0x03, 0x62, 0xac,
+                                0xaa, 0xf7, 0xd6, 0x29, 0xae, 0x3c, 0x38, 0xdb, 0x7d, 0xc6, 0xf5, 0x6b};
+  LocalHttpServer server([&](const LocalHttpServer::Request& request) {
+    LocalHttpServer::Response response;
+    if (request.path == "/key") {
+      for (int i = 0; i < 16; ++i) response.body.push_back(static_cast<char>(i));
+    } else if (request.path == "/bad-key") {
+      response.status = 404;
+    } else {
+      response.body.assign(reinterpret_cast<const char*>(ciphertext), sizeof(ciphertext));
+    }
+    return response;
+  });
+  HttpFetcher fetcher;
+  Delivered delivered;
+  SegmentLoader loader(&fetcher, MediaSource(), SegmentLoader::Options(), delivered.Sink());
+  auto segments = Playlist(server, 5);
+  for (size_t i = 0; i < segments.size(); ++i) {
+    segments[i].key.method = HlsKeyMethod::kAes128;
+    segments[i].key.uri = server.url(i == 3 ? "/bad-key" : "/key");
+    segments[i].key.iv = HlsSequenceIv(7);
+  }
+  loader.Append(segments);
+  ASSERT_TRUE(delivered.WaitFor(5));
+
+  EXPECT_EQ(delivered.ok(), (std::vector<bool>{true, true, true, false, true}));
+  for (const size_t i : {0, 1, 2, 4}) EXPECT_EQ(delivered.bodies()[i], "hls segment payload, 36 bytes long!!");
+  int key_requests = 0;
+  for (const auto& request : server.requests()) key_requests += request.path == "/key";
+  EXPECT_EQ(key_requests, 1);
+  EXPECT_NE(loader.CachedKey(server.url("/key")), nullptr);
+  EXPECT_EQ(loader.CachedKey(server.url("/bad-key")), nullptr);
+}
+
+}  // namespace
+}  // namespace pro_video_player
@@ -0,0 +1,110 @@
+#include "segment_timeline.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+
+namespace pro_video_player {
+namespace {
+
+// Live media playlist of |count| 6 s segments from |sequence| on.
+std::string Playlist(uint64_t sequence, int count, bool ended = false) {
+  std::string playlist = "#EXTM3U\r\n#EXT-X-VERSION:3\r\n#EXT-X-TARGETDURATION:6\r\n";
+  playlist += "#EXT-X-MEDIA-SEQUENCE:" + std::to_string(sequence) + "\r\n";
+  for (int i = 0; i < count; ++i) {
+    playlist += "#EXT-X-PROGRAM-DATE-TIME:2026-01-01T00:00:00Z\r\n";
+    playlist += "#EXTINF:6.000,\r\nseg" + std::to_string(sequence + i) + ".ts\r\n";
+  }
+  if (ended) playlist += "#EXT-X-ENDLIST\r\n";
+  return playlist;
+}
+
+std::string SegmentUri(int i) {
+  char uri[32];
+  std::snprintf(uri, sizeof(uri), "segment_%06d.ts", i);
+  return uri;
+}
+
+TEST(SegmentTimelineTest, RefreshesSlideTheWindow) {
+  SegmentTimeline timeline;
+  EXPECT_EQ(timeline.MergeMediaPlaylist(Playlist(10, 3)), 3u);
+  EXPECT_EQ(timeline.target_duration_ms(), 6000);
+  EXPECT_EQ(timeline.start_ms(), 0);
+  EXPECT_EQ(timeline.end_ms(), 18000);
+
+  // One segment dropped, two added; the overlap is not appended twice
+  EXPECT_EQ(timeline.MergeMediaPlaylist(Playlist(11, 4)), 2u);
+  EXPECT_EQ(timeline.size(), 4u);
+  EXPECT_EQ(timeline.start_ms(), 6000);
+  EXPECT_EQ(timeline.end_ms(), 30000);
+  EXPECT_FALSE(timeline.ended());
+
+  const auto segment = timeline.Find(13500);
+  ASSERT_TRUE(segment.has_value());
+  EXPECT_EQ(segment->sequence, 12u);
+  EXPECT_EQ(segment->start_ms, 12000);
+  EXPECT_EQ(segment->duration_ms, 6000);
+  EXPECT_EQ(segment->uri, "seg12.ts");
+  EXPECT_EQ(timeline.Find(30000)->sequence, 14u);
+  EXPECT_FALSE(timeline.Find(5999).has_value());
+  EXPECT_FALSE(timeline.Find(30001).has_value());
+
+  timeline.MergeMediaPlaylist(Playlist(11, 4, true));
+  EXPECT_TRUE(timeline.ended());
+}
+
+TEST(SegmentTimelineTest, GapStartsOverAtTheOldEnd) {
+  SegmentTimeline timeline;
+  timeline.MergeMediaPlaylist(Playlist(0, 3));
+  // Refreshed long after the window moved past everything we knew
+  EXPECT_EQ(timeline.MergeMediaPlaylist(Playlist(50, 2)), 2u);
+  EXPECT_EQ(timeline.size(), 2u);
+  EXPECT_EQ(timeline.start_ms(), 18000);
+  EXPECT_EQ(timeline.At(0).sequence, 50u);
+  EXPECT_EQ(timeline.At(0).uri, "seg50.ts");
+  EXPECT_FALSE(timeline.Append(49, 6000, "seg49.ts"));
+}
+
+TEST(SegmentTimelineTest, RingEvictsOldestAndKeepsUris) {
+  SegmentTimeline timeline(4);
+  // Long URIs so that evictions compact the arena
+  const std::string long_prefix(3000, 'x');
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_TRUE(timeline.Append(100 + i, 2000, long_prefix + SegmentUri(i)));
+    if (i == 5) timeline.TrimBefore(104);
+  }
+  EXPECT_EQ(timeline.size(), 4u);
+  for (size_t i = 0; i < 4; ++i) {
+    const TimelineSegment segment = timeline.At(i);
+    EXPECT_EQ(segment.sequence, 106 + i);
+    EXPECT_EQ(segment.start_ms, static_cast<int64_t>(12000 + 2000 * i));
+    EXPECT_EQ(segment.uri, long_prefix + SegmentUri(static_cast<int>(6 + i)));
+  }
+  // Less than all ten URIs
+  EXPECT_LT(timeline.memory_bytes(), 10 * long_prefix.size());
+}
+
+TEST(SegmentTimelineTest, SixHourWindowStaysCompact) {
+  SegmentTimeline timeline;
+  constexpr int kSegments = 6 * 3600 / 2;
+  // Slides through two windows' worth
+  for (int i = 0; i < 2 * kSegments; ++i) {
+    timeline.Append(static_cast<uint64_t>(i), 2000, SegmentUri(i));
+    if (i >= kSegments) timeline.TrimBefore(static_cast<uint64_t>(i - kSegments + 1));
+  }
+  EXPECT_EQ(timeline.size(), static_cast<size_t>(kSegments));
+  EXPECT_EQ(timeline.end_ms() - timeline.start_ms(), 6 * 3600 * 1000);
+  EXPECT_LT(timeline.memory_bytes(), 1024u * 1024u);
+
+  for (int i = 0; i < 1000; ++i) {
+    const int64_t position = timeline.start_ms() + static_cast<int64_t>(i) * 21599 + 1;
+    const auto segment = timeline.Find(position);
+    ASSERT_TRUE(segment.has_value());
+    EXPECT_EQ(segment->sequence, static_cast<uint64_t>(position / 2000));
+    EXPECT_EQ(segment->uri, SegmentUri(static_cast<int>(position / 2000)));
+  }
+}
+
+}  // namespace
+}  // namespace pro_video_player
@@ -0,0 +1,111 @@
+#include "subtitle_cues.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace pro_video_player {
+namespace {
+
+SubtitleCue Cue(int64_t start_ms, int64_t end_ms, std::string text) {
+  SubtitleCue cue;
+  cue.start_ms = start_ms;
+  cue.end_ms = end_ms;
+  cue.text = std::move(text);
+  return cue;
+}
+
+TEST(SubtitleCueStoreTest, FindsActiveCueAndNextChange) {
+  SubtitleCueStore store;
+  // Out of order, as a demuxer delivers after a seek back
+  EXPECT_TRUE(store.Add("3", Cue(5000, 6000, "second")));
+  EXPECT_TRUE(store.Add("3", Cue(1000, 2000, "first")));
+
+  EXPECT_FALSE(store.ActiveAt("3", 999).has_value());
+  ASSERT_TRUE(store.ActiveAt("3", 1000).has_value());
+  EXPECT_EQ(store.ActiveAt("3", 1999)->text, "first");
+  EXPECT_FALSE(store.ActiveAt("3", 2000).has_value());
+  EXPECT_EQ(store.ActiveAt("3", 5500)->text, "second");
+  EXPECT_FALSE(store.ActiveAt("other", 1500).has_value());
+
+  EXPECT_EQ(store.NextChangeAfter("3", 0), 1000);
+  EXPECT_EQ(store.NextChangeAfter("3", 1500), 2000);
+  EXPECT_EQ(store.NextChangeAfter("3", 2000), 5000);
+  EXPECT_EQ(store.NextChangeAfter("3", 6000), -1);
+}
+
+TEST(SubtitleCueStoreTest, DropsDuplicatesAndEmptyCues) {
+  SubtitleCueStore store;
+  EXPECT_TRUE(store.Add("1", Cue(0, 1000, "hello")));
+  EXPECT_FALSE(store.Add("1", Cue(0, 1000, "hello")));
+  EXPECT_FALSE(store.Add("1", Cue(2000, 2000, "zero length")));
+  EXPECT_FALSE(store.Add("1", Cue(3000, 4000, "")));
+  EXPECT_EQ(store.CueCount("1"), 1u);
+
+  store.RemoveTrack("1");
+  EXPECT_EQ(store.CueCount("1"), 0u);
+}
+
+TEST(SubtitleCueStoreTest, MergesOverlappingCues) {
+  SubtitleCueStore store;
+  store.Add("1", {Cue(0, 10000, "sign"), Cue(2000, 3000, "speech"), Cue(9000, 9500, "later")});
+
+  const auto both = store.ActiveAt("1", 2500);
+  ASSERT_TRUE(both.has_value());
+  EXPECT_EQ(both->text, "sign\nspeech");
+  EXPECT_EQ(both->start_ms, 2000);
+  EXPECT_EQ(both->end_ms, 3000);
+  // The long cue is still found once the short ones are far behind
+  EXPECT_EQ(store.ActiveAt("1", 8000)->text, "sign");
+  EXPECT_EQ(store.NextChangeAfter("1", 3000), 9000);
+  EXPECT_EQ(store.NextChangeAfter("1", 9500), 10000);
+}
+
+TEST(SubtitleCueStoreTest, TrimsToAWindow) {
+  SubtitleCueStore store;
+  store.Add("1", {Cue(0, 1000, "a"), Cue(5000, 6000, "b"), Cue(9000, 12000, "c"), Cue(20000, 21000, "d")});
+  EXPECT_EQ(store.TrimOutside("1", 5500, 10000), 2u);
+  EXPECT_EQ(store.CueCount("1"), 2u);
+  EXPECT_EQ(store.ActiveAt("1", 5500)->text, "b");
+  EXPECT_EQ(store.ActiveAt("1", 11000)->text, "c");
+  EXPECT_EQ(store.TrimOutside("other", 0, 1), 0u);
+}
+
+TEST(SubtitleParseTest, ParsesSubRip) {
+  const std::string srt =
+      "\xEF\xBB\xBF"
+      "1\r\n00:00:01,000 --> 00:00:02,500\r\n<i>Hello</i> there\r\n{\\an8}General\r\n\r\n"
+      "2\r\n00:01:02,050 --> 00:01:03,000\r\nSecond &amp; last\r\n";
+  std::vector<SubtitleCue> cues;
+  ASSERT_TRUE(ParseSubtitles(SubtitleFormat::kSrt, srt, &cues));
+  ASSERT_EQ(cues.size(), 2u);
+  EXPECT_EQ(cues[0], Cue(1000, 2500, "Hello there\nGeneral"));
+  EXPECT_EQ(cues[1], Cue(62050, 63000, "Second & last"));
+}
+
+TEST(SubtitleParseTest, ParsesWebVtt) {
+  const std::string vtt =
+      "WEBVTT - sample\n\n"
+      "NOTE this is ignored\n\n"
+      "STYLE\n::cue { color: yellow }\n\n"
+      "intro\n00:01.000 --> 00:02.000 align:start line:0\n<v Roger>Short timestamps\n\n"
+      "01:00:00.250 --> 01:00:01.000\nHour mark\n";
+  std::vector<SubtitleCue> cues;
+  ASSERT_TRUE(ParseSubtitles(SubtitleFormat::kVtt, vtt, &cues));
+  ASSERT_EQ(cues.size(), 2u);
+  EXPECT_EQ(cues[0], Cue(1000, 2000, "Short timestamps"));
+  EXPECT_EQ(cues[1], Cue(3600250, 3601000, "Hour mark"));
+}
+
+TEST(SubtitleParseTest, RejectsUnsupportedOrEmpty) {
+  std::vector<SubtitleCue> cues;
+  EXPECT_FALSE(ParseSubtitles(SubtitleFormat::kAss, "[Script Info]\n", &cues));
+  EXPECT_FALSE(ParseSubtitles(SubtitleFormat::kSrt, "", &cues));
+  EXPECT_FALSE(ParseSubtitles(SubtitleFormat::kSrt, "1\n00:00:05,000 --> 00:00:04,000\nBackwards\n", &cues));
+  EXPECT_FALSE(ParseSubtitles(SubtitleFormat::kVtt, "WEBVTT\n\n00:61.000 --> 00:62.000\nBad\n", &cues));
+  EXPECT_TRUE(cues.empty());
+}
+
+}  // namespace
+}  // namespace pro_video_player
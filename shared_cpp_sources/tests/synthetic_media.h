@@ -0,0 +1,252 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_TESTS_SYNTHETIC_MEDIA_H_
+#define PRO_VIDEO_PLAYER_SHARED_TESTS_SYNTHETIC_MEDIA_H_
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "fmp4_writer.h"
+
+namespace pro_video_player {
+namespace testing {
+
+// Small MP4 and Matroska files with recognizable sample bytes, for the
+// demuxers and the remuxer: 3 s of 10 fps video in three 1 s GOPs, with
+// B-frames (decode order I0 P2 B1 P4 B3 ... P9), and 20 audio frames a
+// second.
+constexpr int kSyntheticGops = 3;
+constexpr int kSyntheticFramesPerGop = 10;
+constexpr int kSyntheticAudioPerGop = 20;
+constexpr int64_t kSyntheticFrameMs = 100;
+constexpr int64_t kSyntheticAudioFrameMs = 50;
+
+// In decode order per track.
+struct SyntheticFrame {
+  bool video = true;
+  int64_t pts_ms = 0;
+  bool keyframe = false;
+  std::string data;
+};
+
+struct SyntheticMedia {
+  std::string bytes;
+  std::vector<SyntheticFrame> video;
+  std::vector<SyntheticFrame> audio;
+};
+
+inline const std::vector<uint8_t>& SyntheticAvcConfig() {
+  static const std::vector<uint8_t> config = {0x01, 0x64, 0x00, 0x1f, 0xff, 0xe1, 0x00, 0x04,
+                                              0x67, 0x64, 0x00, 0x1f, 0x01, 0x00, 0x02, 0x68, 0xee};
+  return config;
+}
+
+inline const std::vector<uint8_t>& SyntheticAacConfig() {
+  static const std::vector<uint8_t> config = {0x12, 0x10};
+  return config;
+}
+
+inline SyntheticMedia SyntheticFrames() {
+  SyntheticMedia media;
+  static const int kGopOrder[kSyntheticFramesPerGop] = {0, 2, 1, 4, 3, 6, 5, 8, 7, 9};
+  for (int gop = 0; gop < kSyntheticGops; ++gop) {
+    for (int i = 0; i < kSyntheticFramesPerGop; ++i) {
+      SyntheticFrame frame;
+      frame.pts_ms = (gop * kSyntheticFramesPerGop + kGopOrder[i]) * kSyntheticFrameMs;
+      frame.keyframe = i == 0;
+      const size_t index = media.video.size();
+      frame.data.resize(200 + index * 3);
+      for (size_t b = 0; b < frame.data.size(); ++b) frame.data[b] = static_cast<char>(index * 7 + b);
+      media.video.push_back(frame);
+    }
+  }
+  for (int i = 0; i < kSyntheticGops * kSyntheticAudioPerGop; ++i) {
+    SyntheticFrame frame;
+    frame.video = false;
+    frame.pts_ms = i * kSyntheticAudioFrameMs;
+    frame.keyframe = true;
+    frame.data.assign(16 + i % 5, static_cast<char>(0x80 + i));
+    media.audio.push_back(frame);
+  }
+  return media;
+}
+
+inline void PutBe(std::string* out, uint64_t value, int bytes) {
+  for (int i = bytes - 1; i >= 0; --i) out->push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+}
+
+inline std::string Be(uint64_t value, int bytes) {
+  std::string out;
+  PutBe(&out, value, bytes);
+  return out;
+}
+
+inline std::string AsString(const std::vector<uint8_t>& bytes) { return std::string(bytes.begin(), bytes.end()); }
+
+// ==================== MP4 ====================
+
+inline std::string Mp4Box(const std::string& type, const std::string& payload) {
+  return Be(8 + payload.size(), 4) + type + payload;
+}
+
+inline std::string Mp4FullBox(const std::string& type, uint32_t version_and_flags, const std::string& payload) {
+  return Mp4Box(type, Be(version_and_flags, 4) + payload);
+}
+
+// One trak; a chunk per GOP at |chunk_offsets|.
+inline std::string SyntheticTrak(const std::vector<SyntheticFrame>& frames, const std::vector<uint32_t>& chunk_offsets,
+                                 int per_chunk) {
+  const bool video = frames.front().video;
+  const int64_t delta = video ? kSyntheticFrameMs : kSyntheticAudioFrameMs;
+  // Packed ISO 639-2: "und", "fre"
+  const uint16_t language = video ? 0x55c4 : 0x1a45;
+  const std::string mdhd = Mp4FullBox("mdhd", 0, Be(0, 8) + Be(1000, 4) + Be(3000, 4) + Be(language, 2) + Be(0, 2));
+  const std::string hdlr =
+      Mp4FullBox("hdlr", 0, Be(0, 4) + (video ? "vide" : "soun") + std::string(12, '\0') + std::string(1, '\0'));
+  const std::string entry =
+      AsString(video ? Mp4VisualSampleEntry("avc1", 640, 360, "avcC", SyntheticAvcConfig())
+                     : Mp4AudioSampleEntry("mp4a", 2, 44100, Mp4EsdsBox(SyntheticAacConfig())));
+  std::string stbl = Mp4FullBox("stsd", 0, Be(1, 4) + entry);
+  stbl += Mp4FullBox("stts", 0, Be(1, 4) + Be(frames.size(), 4) + Be(delta, 4));
+  std::string sizes;
+  for (const auto& frame : frames) sizes += Be(frame.data.size(), 4);
+  if (video) {
+    // Presentation = decode + 100 ms; the edit list takes the 100 ms back
+    std::string ctts;
+    std::string stss;
+    int syncs = 0;
+    for (size_t i = 0; i < frames.size(); ++i) {
+      ctts += Be(1, 4) + Be(frames[i].pts_ms - static_cast<int64_t>(i) * delta + 100, 4);
+      if (frames[i].keyframe) {
+        stss += Be(i + 1, 4);
+        ++syncs;
+      }
+    }
+    stbl += Mp4FullBox("ctts", 0, Be(frames.size(), 4) + ctts);
+    stbl += Mp4FullBox("stss", 0, Be(syncs, 4) + stss);
+  }
+  stbl += Mp4FullBox("stsz", 0, Be(0, 4) + Be(frames.size(), 4) + sizes);
+  stbl += Mp4FullBox("stsc", 0, Be(1, 4) + Be(1, 4) + Be(per_chunk, 4) + Be(1, 4));
+  std::string offsets;
+  for (const uint32_t offset : chunk_offsets) offsets += Be(offset, 4);
+  stbl += Mp4FullBox("stco", 0, Be(chunk_offsets.size(), 4) + offsets);
+  const std::string mdia = Mp4Box("mdia", mdhd + hdlr + Mp4Box("minf", Mp4Box("stbl", stbl)));
+  std::string edts;
+  if (video) edts = Mp4Box("edts", Mp4FullBox("elst", 0, Be(1, 4) + Be(3000, 4) + Be(100, 4) + Be(0x10000, 4)));
+  return Mp4Box("trak", edts + mdia);
+}
+
+// Non-faststart: ftyp, mdat (a video then an audio chunk per GOP), moov.
+inline SyntheticMedia BuildSyntheticMp4() {
+  SyntheticMedia media = SyntheticFrames();
+  const std::string ftyp = Mp4Box("ftyp", std::string("isom") + Be(512, 4) + "isomavc1");
+  std::string mdat;
+  std::vector<uint32_t> video_chunks;
+  std::vector<uint32_t> audio_chunks;
+  const size_t mdat_start = ftyp.size() + 8;
+  for (int gop = 0; gop < kSyntheticGops; ++gop) {
+    video_chunks.push_back(static_cast<uint32_t>(mdat_start + mdat.size()));
+    for (int i = 0; i < kSyntheticFramesPerGop; ++i) mdat += media.video[gop * kSyntheticFramesPerGop + i].data;
+    audio_chunks.push_back(static_cast<uint32_t>(mdat_start + mdat.size()));
+    for (int i = 0; i < kSyntheticAudioPerGop; ++i) mdat += media.audio[gop * kSyntheticAudioPerGop + i].data;
+  }
+  const std::string mvhd = Mp4FullBox("mvhd", 0, Be(0, 8) + Be(1000, 4) + Be(3000, 4) + std::string(80, '\0'));
+  const std::string moov = Mp4Box("moov", mvhd + SyntheticTrak(media.video, video_chunks, kSyntheticFramesPerGop) +
+                                               SyntheticTrak(media.audio, audio_chunks, kSyntheticAudioPerGop));
+  media.bytes = ftyp + Mp4Box("mdat", mdat) + moov;
+  return media;
+}
+
+// ==================== Matroska ====================
+
+inline std::string Ebml(uint32_t id, const std::string& payload) {
+  const int id_bytes = id > 0xffffff ? 4 : id > 0xffff ? 3 : id > 0xff ? 2 : 1;
+  // Sizes always take 8 bytes
+  return Be(id, id_bytes) + Be((uint64_t{1} << 56) | payload.size(), 8) + payload;
+}
+
+inline std::string EbmlUint(uint32_t id, uint64_t value) {
+  int bytes = 1;
+  while (bytes < 8 && (value >> (8 * bytes)) != 0) ++bytes;
+  return Ebml(id, Be(value, bytes));
+}
+
+inline std::string EbmlFloat(uint32_t id, double value) {
+  uint64_t bits;
+  std::memcpy(&bits, &value, 8);
+  return Ebml(id, Be(bits, 8));
+}
+
+struct SyntheticMkvOptions {
+  bool cues = true;
+  // Audio frames in pairs, EBML-laced.
+  bool laced_audio = false;
+  uint64_t timestamp_scale = 1000000;
+  // When set, the last cluster and its cue point claim this timestamp.
+  uint64_t last_cluster_time = 0;
+};
+
+// Segment: Info, Tracks (video, audio, and a subtitle track to ignore), a
+// cluster per GOP, then Cues.
+inline SyntheticMedia BuildSyntheticMkv(SyntheticMkvOptions options = {}) {
+  SyntheticMedia media = SyntheticFrames();
+  const std::string info = Ebml(0x1549A966, EbmlUint(0x2AD7B1, options.timestamp_scale) + EbmlFloat(0x4489, 3000.0));
+  const std::string video_track =
+      Ebml(0xAE, EbmlUint(0xD7, 1) + EbmlUint(0x83, 1) + Ebml(0x86, "V_MPEG4/ISO/AVC") +
+                     Ebml(0x63A2, AsString(SyntheticAvcConfig())) + EbmlUint(0x23E383, 100000000) +
+                     Ebml(0xE0, EbmlUint(0xB0, 640) + EbmlUint(0xBA, 360)));
+  const std::string subtitle_track =
+      Ebml(0xAE, EbmlUint(0xD7, 3) + EbmlUint(0x83, 0x11) + Ebml(0x86, "S_TEXT/UTF8"));
+  const std::string audio_track =
+      Ebml(0xAE, EbmlUint(0xD7, 2) + EbmlUint(0x83, 2) + Ebml(0x86, "A_AAC") +
+                     Ebml(0x63A2, AsString(SyntheticAacConfig())) + EbmlUint(0x23E383, 50000000) +
+                     Ebml(0x22B59C, "fre") + Ebml(0xE1, EbmlFloat(0xB5, 44100.0) + EbmlUint(0x9F, 2)));
+  const std::string tracks = Ebml(0x1654AE6B, video_track + subtitle_track + audio_track);
+
+  std::string clusters;
+  std::vector<size_t> cluster_positions;
+  const auto cluster_time = [&](int gop) {
+    return options.last_cluster_time != 0 && gop == kSyntheticGops - 1
+               ? options.last_cluster_time
+               : static_cast<uint64_t>(gop * kSyntheticFramesPerGop * kSyntheticFrameMs);
+  };
+  for (int gop = 0; gop < kSyntheticGops; ++gop) {
+    const int64_t cluster_ms = gop * kSyntheticFramesPerGop * kSyntheticFrameMs;
+    std::string blocks;
+    for (int i = 0; i < kSyntheticFramesPerGop; ++i) {
+      const auto& frame = media.video[gop * kSyntheticFramesPerGop + i];
+      blocks += Ebml(0xA3, Be(0x81, 1) + Be(frame.pts_ms - cluster_ms, 2) + Be(frame.keyframe ? 0x80 : 0, 1) +
+                               frame.data);
+    }
+    for (int i = 0; i < kSyntheticAudioPerGop; i += options.laced_audio ? 2 : 1) {
+      const auto& frame = media.audio[gop * kSyntheticAudioPerGop + i];
+      if (options.laced_audio) {
+        const auto& next = media.audio[gop * kSyntheticAudioPerGop + i + 1];
+        blocks += Ebml(0xA3, Be(0x82, 1) + Be(frame.pts_ms - cluster_ms, 2) + Be(0x86, 1) + Be(1, 1) +
+                                 Be(0x80 | frame.data.size(), 1) + frame.data + next.data);
+      } else {
+        blocks += Ebml(0xA3, Be(0x82, 1) + Be(frame.pts_ms - cluster_ms, 2) + Be(0x80, 1) + frame.data);
+      }
+    }
+    cluster_positions.push_back(info.size() + tracks.size() + clusters.size());
+    clusters += Ebml(0x1F43B675, EbmlUint(0xE7, cluster_time(gop)) + blocks);
+  }
+
+  std::string cues;
+  if (options.cues) {
+    std::string points;
+    for (int gop = 0; gop < kSyntheticGops; ++gop) {
+      points += Ebml(0xBB, EbmlUint(0xB3, cluster_time(gop)) +
+                               Ebml(0xB7, EbmlUint(0xF7, 1) + EbmlUint(0xF1, cluster_positions[gop])));
+    }
+    cues = Ebml(0x1C53BB6B, points);
+  }
+  const std::string header = Ebml(0x1A45DFA3, Ebml(0x4282, "matroska"));
+  media.bytes = header + Ebml(0x18538067, info + tracks + clusters + cues);
+  return media;
+}
+
+}  // namespace testing
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_TESTS_SYNTHETIC_MEDIA_H_
@@ -0,0 +1,189 @@
+#include "time_stretch.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace pro_video_player {
+namespace {
+
+constexpr int kSampleRate = 48000;
+constexpr double kPi = 3.14159265358979323846;
+
+// Interleaved tone; |frequencies| holds one frequency per channel.
+std::vector<float> Tone(const std::vector<double>& frequencies, size_t frames, float amplitude = 0.5f) {
+  const size_t channels = frequencies.size();
+  std::vector<float> samples(frames * channels);
+  for (size_t frame = 0; frame < frames; ++frame) {
+    for (size_t channel = 0; channel < channels; ++channel) {
+      samples[frame * channels + channel] = amplitude * static_cast<float>(std::sin(
+          2.0 * kPi * frequencies[channel] * static_cast<double>(frame) / kSampleRate));
+    }
+  }
+  return samples;
+}
+
+// Feeds |input| in 10 ms chunks, the way an audio thread would, and
+// collects everything the stretcher produces.
+std::vector<float> Stretch(TimeStretcher& stretcher, const std::vector<float>& input) {
+  const size_t channels = stretcher.channels();
+  const size_t chunk = kSampleRate / 100;
+  std::vector<float> output;
+  std::vector<float> buffer(4 * chunk * channels);
+  for (size_t frame = 0; frame < input.size() / channels; frame += chunk) {
+    const size_t frames = std::min(chunk, input.size() / channels - frame);
+    stretcher.Push(input.data() + frame * channels, frames);
+    while (size_t pulled = stretcher.Pull(buffer.data(), buffer.size() / channels)) {
+      output.insert(output.end(), buffer.begin(), buffer.begin() + pulled * channels);
+    }
+  }
+  return output;
+}
+
+std::vector<float> Channel(const std::vector<float>& interleaved, size_t channel, size_t channels) {
+  std::vector<float> samples;
+  for (size_t i = channel; i < interleaved.size(); i += channels) samples.push_back(interleaved[i]);
+  return samples;
+}
+
+// Frequency from the spacing of rising zero crossings (interpolated).
+double EstimateFrequency(const std::vector<float>& samples) {
+  double first = -1.0;
+  double last = -1.0;
+  int crossings = 0;
+  for (size_t i = 1; i < samples.size(); ++i) {
+    if (samples[i - 1] < 0.0f && samples[i] >= 0.0f) {
+      const double t = (i - 1) + samples[i - 1] / (samples[i - 1] - samples[i]);
+      if (first < 0.0) first = t;
+      last = t;
+      ++crossings;
+    }
+  }
+  return crossings > 1 ? (crossings - 1) * kSampleRate / (last - first) : 0.0;
+}
+
+// Power at |frequency| (Goertzel), normalised by length.
+double PowerAt(const std::vector<float>& samples, double frequency) {
+  const double coefficient = 2.0 * std::cos(2.0 * kPi * frequency / kSampleRate);
+  double previous = 0.0;
+  double before = 0.0;
+  for (float sample : samples) {
+    const double current = sample + coefficient * previous - before;
+    before = previous;
+    previous = current;
+  }
+  const double power = previous * previous + before * before - coefficient * previous * before;
+  return power / (static_cast<double>(samples.size()) * samples.size());
+}
+
+double Rms(const std::vector<float>& samples) {
+  double sum = 0.0;
+  for (float sample : samples) sum += static_cast<double>(sample) * sample;
+  return samples.empty() ? 0.0 : std::sqrt(sum / samples.size());
+}
+
+TEST(TimeStretchTest, RateIsClampedToSupportedRange) {
+  TimeStretcher stretcher(2, kSampleRate);
+  EXPECT_EQ(stretcher.rate(), 1.0);
+  stretcher.SetRate(8.0);
+  EXPECT_EQ(stretcher.rate(), kMaxTimeStretchRate);
+  stretcher.SetRate(0.1);
+  EXPECT_EQ(stretcher.rate(), kMinTimeStretchRate);
+  stretcher.SetRate(std::nan(""));
+  EXPECT_EQ(stretcher.rate(), kMinTimeStretchRate);
+  EXPECT_TRUE(TimeStretcher::SupportsRate(2.5));
+  EXPECT_FALSE(TimeStretcher::SupportsRate(4.5));
+}
+
+TEST(TimeStretchTest, UnitRateReproducesInput) {
+  TimeStretcher stretcher(2, kSampleRate);
+  const auto input = Tone({440.0, 660.0}, kSampleRate);
+  const auto output = Stretch(stretcher, input);
+  ASSERT_GE(output.size() / 2, input.size() / 2 - stretcher.latency_frames());
+  for (size_t i = 0; i < output.size(); ++i) {
+    ASSERT_NEAR(output[i], input[i], 1e-6) << "sample " << i;
+  }
+}
+
+TEST(TimeStretchTest, KeepsPitchAndScalesDurationAcrossRates) {
+  const double frequency = 440.0;
+  const auto input = Tone({frequency}, 2 * kSampleRate);
+  for (double rate : {0.25, 0.5, 0.75, 1.25, 1.75, 2.0, 2.5, 4.0}) {
+    TimeStretcher stretcher(1, kSampleRate);
+    stretcher.SetRate(rate);
+    const auto output = Stretch(stretcher, input);
+
+    const double expected_frames = (input.size() - stretcher.latency_frames()) / rate;
+    EXPECT_NEAR(output.size(), expected_frames, 0.02 * expected_frames + 2 * stretcher.latency_frames())
+        << "rate " << rate;
+    EXPECT_NEAR(EstimateFrequency(output), frequency, frequency * 0.005) << "rate " << rate;
+    EXPECT_NEAR(Rms(output), Rms(input), Rms(input) * 0.05) << "rate " << rate;
+  }
+}
+
+TEST(TimeStretchTest, SplicesWithoutClicks) {
+  // A click shows up as a sample-to-sample jump larger than the sine's
+  // steepest slope
+  const double frequency = 300.0;
+  const float amplitude = 0.5f;
+  const double max_step = 2.0 * kPi * frequency / kSampleRate * amplitude;
+  const auto input = Tone({frequency}, 2 * kSampleRate, amplitude);
+  for (double rate : {0.5, 1.75, 2.5}) {
+    TimeStretcher stretcher(1, kSampleRate);
+    stretcher.SetRate(rate);
+    const auto output = Stretch(stretcher, input);
+    float worst = 0.0f;
+    for (size_t i = 1; i < output.size(); ++i) worst = std::max(worst, std::fabs(output[i] - output[i - 1]));
+    EXPECT_LT(worst, 1.2 * max_step) << "rate " << rate;
+  }
+}
+
+TEST(TimeStretchTest, HarmonicsStayPutUnlikeResampling) {
+  // Speech-like harmonic stack at 150 Hz. Resampling to 2x would move the
+  // energy to 300/600/900 Hz; time-stretching must leave it where it is.
+  std::vector<float> input(3 * kSampleRate);
+  for (size_t i = 0; i < input.size(); ++i) {
+    const double t = static_cast<double>(i) / kSampleRate;
+    input[i] = static_cast<float>(0.4 * std::sin(2 * kPi * 150 * t) + 0.2 * std::sin(2 * kPi * 450 * t) +
+                                  0.1 * std::sin(2 * kPi * 750 * t));
+  }
+  TimeStretcher stretcher(1, kSampleRate);
+  stretcher.SetRate(2.0);
+  const auto output = Stretch(stretcher, input);
+
+  for (double harmonic : {150.0, 450.0, 750.0}) {
+    EXPECT_NEAR(PowerAt(output, harmonic) / PowerAt(input, harmonic), 1.0, 0.1) << harmonic << " Hz";
+  }
+  EXPECT_LT(PowerAt(output, 300.0), 1e-3 * PowerAt(output, 150.0));
+  EXPECT_LT(PowerAt(output, 900.0), 1e-3 * PowerAt(output, 450.0));
+}
+
+TEST(TimeStretchTest, StereoChannelsStayIndependent) {
+  TimeStretcher stretcher(2, kSampleRate);
+  stretcher.SetRate(1.75);
+  const auto output = Stretch(stretcher, Tone({440.0, 660.0}, 2 * kSampleRate));
+  EXPECT_NEAR(EstimateFrequency(Channel(output, 0, 2)), 440.0, 440.0 * 0.005);
+  EXPECT_NEAR(EstimateFrequency(Channel(output, 1, 2)), 660.0, 660.0 * 0.005);
+}
+
+TEST(TimeStretchTest, RateChangesMidStreamAndReset) {
+  TimeStretcher stretcher(1, kSampleRate);
+  const auto input = Tone({440.0}, kSampleRate);
+  stretcher.SetRate(0.5);
+  auto output = Stretch(stretcher, input);
+  stretcher.SetRate(2.0);
+  const auto faster = Stretch(stretcher, input);
+  output.insert(output.end(), faster.begin(), faster.end());
+  EXPECT_NEAR(EstimateFrequency(output), 440.0, 440.0 * 0.005);
+
+  stretcher.Reset();
+  EXPECT_EQ(stretcher.available(), 0u);
+  std::vector<float> silence(stretcher.latency_frames() / 2, 0.0f);
+  stretcher.Push(silence.data(), silence.size());
+  EXPECT_EQ(stretcher.available(), 0u);
+}
+
+}  // namespace
+}  // namespace pro_video_player
@@ -0,0 +1,75 @@
+#include "trace_recorder.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+
+namespace pro_video_player {
+namespace {
+
+size_t CountOccurrences(const std::string& haystack, const std::string& needle) {
+  size_t count = 0;
+  for (size_t pos = haystack.find(needle); pos != std::string::npos;
+       pos = haystack.find(needle, pos + needle.size())) {
+    ++count;
+  }
+  return count;
+}
+
+TEST(TraceRecorderTest, ExportsChromeTraceEvents) {
+  TraceRecorder recorder;
+  recorder.AddComplete("player", "seek", 1000, 250, 3);
+  recorder.AddInstant("player", "eos");
+  recorder.AddCounter("queue_depth", 4, 3);
+
+  const std::string json = recorder.DumpJson();
+  EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0u);
+  EXPECT_NE(json.find("\"ph\":\"X\",\"cat\":\"player\",\"name\":\"seek\""), std::string::npos);
+  EXPECT_NE(json.find("\"ts\":1000,\"dur\":250,\"args\":{\"player\":3}"), std::string::npos);
+  EXPECT_NE(json.find("\"name\":\"eos\""), std::string::npos);
+  EXPECT_NE(json.find("\"s\":\"t\""), std::string::npos);
+  EXPECT_NE(json.find("\"id\":3,\"args\":{\"value\":4}"), std::string::npos);
+  EXPECT_NE(json.find("\"recorded_events\":3,\"dropped_events\":0"), std::string::npos);
+}
+
+TEST(TraceRecorderTest, RingKeepsNewestEvents) {
+  TraceRecorder recorder(4);
+  for (int i = 0; i < 10; ++i) recorder.AddComplete("test", "step", i, 1);
+
+  const std::string json = recorder.DumpJson();
+  EXPECT_EQ(CountOccurrences(json, "\"name\":\"step\""), 4u);
+  EXPECT_EQ(json.find("\"ts\":5,"), std::string::npos);
+  EXPECT_NE(json.find("\"ts\":6,"), std::string::npos);
+  EXPECT_NE(json.find("\"ts\":9,"), std::string::npos);
+  EXPECT_NE(json.find("\"recorded_events\":10,\"dropped_events\":6"), std::string::npos);
+  EXPECT_EQ(recorder.recorded(), 10u);
+
+  recorder.Clear();
+  EXPECT_EQ(recorder.recorded(), 0u);
+  EXPECT_EQ(CountOccurrences(recorder.DumpJson(), "\"name\":\"step\""), 0u);
+}
+
+TEST(TraceRecorderTest, DisabledRecorderDropsEvents) {
+  TraceRecorder recorder;
+  recorder.SetEnabled(false);
+  recorder.AddInstant("test", "ignored");
+  recorder.AddCounter("ignored", 1);
+  EXPECT_EQ(recorder.recorded(), 0u);
+}
+
+TEST(TraceRecorderTest, NamesThreadsAndEscapesNames) {
+  TraceRecorder recorder;
+  std::thread worker([&]() {
+    recorder.SetCurrentThreadName("pvp-\"worker\"");
+    recorder.AddInstant("test", "on_worker");
+  });
+  worker.join();
+
+  const std::string json = recorder.DumpJson();
+  EXPECT_NE(json.find("\"name\":\"thread_name\""), std::string::npos);
+  EXPECT_NE(json.find("pvp-\\\"worker\\\""), std::string::npos);
+}
+
+}  // namespace
+}  // namespace pro_video_player
@@ -0,0 +1,124 @@
+#include "waveform.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace pro_video_player {
+namespace {
+
+class WaveformCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char path[] = "/tmp/pvp-waveform-test-XXXXXX";
+    ASSERT_NE(mkdtemp(path), nullptr);
+    directory_ = path;
+  }
+
+  void TearDown() override { std::filesystem::remove_all(directory_); }
+
+  std::string directory_;
+};
+
+TEST(WaveformTest, BuilderPlacesSamplesByTimestamp) {
+  // 1 kHz mono: 50 frames per 50 ms bucket
+  std::vector<float> loud(50, -0.5f);
+  std::vector<float> quiet(100, 0.1f);
+  WaveformBuilder builder;
+  AudioSamples samples;
+  samples.channels = 1;
+  samples.sample_rate = 1000;
+
+  samples.data = quiet.data();
+  samples.frames = quiet.size();
+  samples.pts_ms = 0;
+  builder.Add(samples);
+  // Out of order, as after a seek
+  samples.data = loud.data();
+  samples.frames = loud.size();
+  samples.pts_ms = 150;
+  builder.Add(samples);
+
+  const Waveform waveform = builder.Finish();
+  EXPECT_EQ(waveform.bucket_ms, kWaveformBucketMs);
+  ASSERT_EQ(waveform.peaks.size(), 4u);
+  EXPECT_EQ(waveform.peaks[0], 26);
+  EXPECT_EQ(waveform.peaks[1], 26);
+  EXPECT_EQ(waveform.peaks[2], 0);
+  EXPECT_EQ(waveform.peaks[3], 128);
+}
+
+TEST(WaveformTest, BuilderSplitsChunksAcrossBuckets) {
+  std::vector<float> stereo(2 * 75, 0.0f);
+  stereo[2 * 60 + 1] = 1.0f;
+  WaveformBuilder builder;
+  AudioSamples samples;
+  samples.data = stereo.data();
+  samples.frames = 75;
+  samples.channels = 2;
+  samples.sample_rate = 1000;
+  builder.Add(samples);
+  const Waveform waveform = builder.Finish();
+  ASSERT_EQ(waveform.peaks.size(), 2u);
+  EXPECT_EQ(waveform.peaks[0], 0);
+  EXPECT_EQ(waveform.peaks[1], 255);
+}
+
+TEST(WaveformTest, DownsampleMaxPools) {
+  const std::vector<uint8_t> peaks = {1, 9, 2, 3, 8, 4, 5, 6, 7, 0};
+  EXPECT_EQ(DownsampleWaveform(peaks, 5), (std::vector<uint8_t>{9, 3, 8, 6, 7}));
+  EXPECT_EQ(DownsampleWaveform(peaks, 3), (std::vector<uint8_t>{9, 8, 7}));
+  EXPECT_EQ(DownsampleWaveform(peaks, 1), (std::vector<uint8_t>{9}));
+  EXPECT_EQ(DownsampleWaveform(peaks, 20), peaks);
+}
+
+TEST_F(WaveformCacheTest, RoundTripsThroughDisk) {
+  WaveformCache cache(directory_ + "/nested");
+  Waveform waveform;
+  waveform.peaks = {0, 127, 255, 3};
+  MediaSource source;
+  source.uri = "https://example.com/a.mp3";
+  const std::string key = WaveformCache::KeyFor(source);
+  ASSERT_EQ(key.size(), 16u);
+
+  Waveform loaded;
+  EXPECT_FALSE(cache.Load(key, &loaded));
+  ASSERT_TRUE(cache.Store(key, waveform));
+  ASSERT_TRUE(cache.Load(key, &loaded));
+  EXPECT_EQ(loaded.bucket_ms, waveform.bucket_ms);
+  EXPECT_EQ(loaded.peaks, waveform.peaks);
+}
+
+TEST_F(WaveformCacheTest, RejectsCorruptFilesAndDisabledCache) {
+  WaveformCache cache(directory_);
+  {
+    std::ofstream file(directory_ + "/bad.pvpw", std::ios::binary);
+    file << "not a waveform";
+  }
+  Waveform loaded;
+  EXPECT_FALSE(cache.Load("bad", &loaded));
+
+  cache.SetDirectory(std::string());
+  EXPECT_FALSE(cache.Store("key", Waveform()));
+}
+
+TEST_F(WaveformCacheTest, FileKeysChangeWhenTheFileChanges) {
+  MediaSource source;
+  source.type = SourceType::kFile;
+  source.uri = directory_ + "/clip.wav";
+  { std::ofstream(source.uri) << "abc"; }
+  const std::string before = WaveformCache::KeyFor(source);
+  { std::ofstream(source.uri, std::ios::app) << "def"; }
+  EXPECT_NE(WaveformCache::KeyFor(source), before);
+
+  MediaSource network;
+  network.uri = source.uri;
+  EXPECT_NE(WaveformCache::KeyFor(network), WaveformCache::KeyFor(source));
+}
+
+}  // namespace
+}  // namespace pro_video_player
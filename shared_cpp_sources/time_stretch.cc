@@ -0,0 +1,195 @@
+#include "time_stretch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "simd_float4.h"
+
+namespace pro_video_player {
+
+namespace {
+
+// 20 ms windows overlapped by half and a +-10 ms search cover pitch
+// periods down to 100 Hz, which keeps voices clean at 2-2.5x.
+constexpr double kHopSeconds = 0.010;
+constexpr double kSearchSeconds = 0.010;
+constexpr double kPi = 3.14159265358979323846;
+
+// Pulled output is compacted once this many frames have been read.
+constexpr size_t kCompactFrames = 4096;
+
+float Dot(const float* a, const float* b, size_t count) {
+  size_t i = 0;
+  float sum = 0.0f;
+#if defined(PVP_SIMD_FLOAT4)
+  simd::Vec even = simd::Zero();
+  simd::Vec odd = simd::Zero();
+  for (; i + 2 * simd::kLanes <= count; i += 2 * simd::kLanes) {
+    even = simd::MulAdd(even, simd::Load(a + i), simd::Load(b + i));
+    odd = simd::MulAdd(odd, simd::Load(a + i + simd::kLanes), simd::Load(b + i + simd::kLanes));
+  }
+  sum = simd::Sum(simd::Add(even, odd));
+#endif
+  for (; i < count; ++i) sum += a[i] * b[i];
+  return sum;
+}
+
+size_t FramesFor(int sample_rate, double seconds) {
+  return std::max<size_t>(1, static_cast<size_t>(std::lround(sample_rate * seconds)));
+}
+
+}  // namespace
+
+TimeStretcher::TimeStretcher(int channels, int sample_rate)
+    : channels_(std::max(channels, 1)),
+      sample_rate_(std::max(sample_rate, 1)),
+      window_(2 * FramesFor(sample_rate_, kHopSeconds)),
+      hop_(window_ / 2),
+      search_(FramesFor(sample_rate_, kSearchSeconds)),
+      hann_(window_),
+      tail_(hop_ * channels_) {
+  // Periodic Hann: windows overlapped by half sum to exactly one.
+  for (size_t i = 0; i < window_; ++i) {
+    hann_[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * kPi * i / window_));
+  }
+}
+
+void TimeStretcher::SetRate(double rate) {
+  if (!std::isfinite(rate)) return;
+  rate_ = std::clamp(rate, kMinTimeStretchRate, kMaxTimeStretchRate);
+}
+
+void TimeStretcher::Push(const float* interleaved, size_t frames) {
+  if (interleaved == nullptr || frames == 0) return;
+  input_.insert(input_.end(), interleaved, interleaved + frames * channels_);
+  const size_t first = mono_.size();
+  mono_.resize(first + frames);
+  const float scale = 1.0f / channels_;
+  for (size_t frame = 0; frame < frames; ++frame) {
+    const float* sample = interleaved + frame * channels_;
+    float mix = 0.0f;
+    for (int channel = 0; channel < channels_; ++channel) mix += sample[channel];
+    mono_[first + frame] = mix * scale;
+  }
+  while (ProcessWindow()) {
+  }
+  DiscardConsumedInput();
+}
+
+size_t TimeStretcher::Pull(float* out, size_t max_frames) {
+  const size_t frames = std::min(max_frames, available());
+  if (frames == 0) return 0;
+  const float* begin = output_.data() + output_read_ * channels_;
+  std::copy(begin, begin + frames * channels_, out);
+  output_read_ += frames;
+  if (output_read_ * channels_ == output_.size()) {
+    output_.clear();
+    output_read_ = 0;
+  } else if (output_read_ >= kCompactFrames) {
+    output_.erase(output_.begin(), output_.begin() + output_read_ * channels_);
+    output_read_ = 0;
+  }
+  return frames;
+}
+
+size_t TimeStretcher::available() const { return output_.size() / channels_ - output_read_; }
+
+void TimeStretcher::Reset() {
+  input_.clear();
+  mono_.clear();
+  output_.clear();
+  output_read_ = 0;
+  next_position_ = 0.0;
+  template_position_ = 0;
+  has_previous_ = false;
+}
+
+bool TimeStretcher::ProcessWindow() {
+  const size_t buffered = mono_.size();
+  const size_t ideal = static_cast<size_t>(std::llround(next_position_));
+  size_t position;
+  if (!has_previous_) {
+    // Nothing to line up with yet
+    if (ideal + window_ > buffered) return false;
+    position = ideal;
+  } else if (rate_ == 1.0 && template_position_ + search_ >= ideal &&
+             template_position_ <= ideal + search_) {
+    // The natural continuation is always the best match at rate 1, and
+    // taking it reproduces the input exactly
+    if (template_position_ + window_ > buffered) return false;
+    position = template_position_;
+  } else {
+    const size_t lo = ideal > search_ ? ideal - search_ : 0;
+    const size_t hi = ideal + search_;
+    if (hi + window_ > buffered) return false;
+    position = FindBestOffset(lo, hi);
+  }
+
+  const size_t channels = static_cast<size_t>(channels_);
+  const float* segment = input_.data() + position * channels;
+  if (!has_previous_) {
+    // Seed the overlap as if a matching window preceded this one, so the
+    // stream starts at full level instead of fading in
+    for (size_t i = 0; i < hop_ * channels; ++i) {
+      tail_[i] = segment[i] * (1.0f - hann_[i / channels]);
+    }
+  }
+  const size_t base = output_.size();
+  output_.resize(base + hop_ * channels);
+  float* out = output_.data() + base;
+  for (size_t frame = 0; frame < hop_; ++frame) {
+    const float rise = hann_[frame];
+    const float fall = hann_[hop_ + frame];
+    for (size_t channel = 0; channel < channels; ++channel) {
+      const size_t i = frame * channels + channel;
+      out[i] = tail_[i] + segment[i] * rise;
+      tail_[i] = segment[hop_ * channels + i] * fall;
+    }
+  }
+
+  template_position_ = position + hop_;
+  has_previous_ = true;
+  next_position_ += hop_ * rate_;
+  return true;
+}
+
+size_t TimeStretcher::FindBestOffset(size_t lo, size_t hi) const {
+  // Maximises dot(template, candidate) / |candidate| (the template's own
+  // energy is the same for every candidate). Compared as dot * |dot| / E
+  // to skip the square root while keeping anti-phase matches last.
+  const float* reference = mono_.data() + template_position_;
+  const size_t length = hop_;
+  const float* candidates = mono_.data();
+  double energy = Dot(candidates + lo, candidates + lo, length);
+  size_t best = lo;
+  double best_score = -std::numeric_limits<double>::infinity();
+  for (size_t position = lo; position <= hi; ++position) {
+    if (position > lo) {
+      const double leaving = candidates[position - 1];
+      const double entering = candidates[position + length - 1];
+      energy += entering * entering - leaving * leaving;
+    }
+    const double dot = Dot(reference, candidates + position, length);
+    const double score = dot * std::fabs(dot) / std::max(energy, 1e-9);
+    if (score > best_score) {
+      best_score = score;
+      best = position;
+    }
+  }
+  return best;
+}
+
+void TimeStretcher::DiscardConsumedInput() {
+  const size_t ideal = static_cast<size_t>(std::max(next_position_, 0.0));
+  size_t keep_from = ideal > search_ ? ideal - search_ : 0;
+  if (has_previous_) keep_from = std::min(keep_from, template_position_);
+  // Erasing shifts the whole buffer; only do it once per window or so
+  if (keep_from < window_) return;
+  input_.erase(input_.begin(), input_.begin() + keep_from * channels_);
+  mono_.erase(mono_.begin(), mono_.begin() + keep_from);
+  next_position_ -= static_cast<double>(keep_from);
+  template_position_ -= keep_from;
+}
+
+}  // namespace pro_video_player
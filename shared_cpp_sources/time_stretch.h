@@ -0,0 +1,88 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_TIME_STRETCH_H_
+#define PRO_VIDEO_PLAYER_SHARED_TIME_STRETCH_H_
+
+#include <cstddef>
+#include <vector>
+
+namespace pro_video_player {
+
+// Playback speeds at which TimeStretcher keeps pitch. Backends mute audio
+// outside this range rather than play it chipmunked.
+inline constexpr double kMinTimeStretchRate = 0.25;
+inline constexpr double kMaxTimeStretchRate = 4.0;
+
+// Changes the tempo of interleaved float PCM without changing its pitch,
+// for backends that render audio themselves.
+//
+// WSOLA: the output is built from 20 ms Hann windows overlapped by half.
+// Each window is read from the input at (output position * rate), shifted
+// by up to +-10 ms to the offset whose waveform best continues the
+// previous window (normalised cross-correlation on a mono mix, SSE2 /
+// NEON). Waveforms are copied, never resampled, so pitch is unchanged.
+// At rate 1 the output equals the input.
+//
+// Not thread-safe; one instance per audio stream, fed from its audio
+// thread.
+class TimeStretcher {
+ public:
+  TimeStretcher(int channels, int sample_rate);
+
+  static bool SupportsRate(double rate) {
+    return rate >= kMinTimeStretchRate && rate <= kMaxTimeStretchRate;
+  }
+
+  // Clamped to the supported range. Applies from the next window, so
+  // changes mid-stream are seamless.
+  void SetRate(double rate);
+  double rate() const { return rate_; }
+
+  int channels() const { return channels_; }
+  int sample_rate() const { return sample_rate_; }
+
+  void Push(const float* interleaved, size_t frames);
+
+  // Copies up to |max_frames| stretched frames to |out| and returns how
+  // many were written.
+  size_t Pull(float* out, size_t max_frames);
+
+  // Stretched frames ready for Pull().
+  size_t available() const;
+
+  // Drops all buffered audio; call on seek or track switch.
+  void Reset();
+
+  // Output lags input by about one window plus the search range.
+  size_t latency_frames() const { return window_ + search_; }
+
+ private:
+  // Emits one hop of output. False until enough input is buffered.
+  bool ProcessWindow();
+  size_t FindBestOffset(size_t lo, size_t hi) const;
+  void DiscardConsumedInput();
+
+  const int channels_;
+  const int sample_rate_;
+  const size_t window_;  // frames
+  const size_t hop_;     // output frames per window (window_ / 2)
+  const size_t search_;  // max shift either side of the ideal position
+  double rate_ = 1.0;
+
+  std::vector<float> hann_;
+  std::vector<float> input_;  // interleaved, starting at input frame 0
+  std::vector<float> mono_;   // channel mix of input_ for the search
+  // Ideal input position of the next window, in frames from input_[0].
+  double next_position_ = 0.0;
+  // Where the previous window's natural continuation starts (the
+  // correlation template); meaningless until has_previous_.
+  size_t template_position_ = 0;
+  bool has_previous_ = false;
+  // Second (falling) half of the previous window, already weighted.
+  std::vector<float> tail_;
+
+  std::vector<float> output_;
+  size_t output_read_ = 0;  // frames of output_ already pulled
+};
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_TIME_STRETCH_H_
@@ -0,0 +1,187 @@
+#include "trace_recorder.h"
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace pro_video_player {
+
+namespace {
+
+uint32_t CurrentThreadId() {
+  static std::atomic<uint32_t> next_id{1};
+  thread_local const uint32_t id = next_id.fetch_add(1, std::memory_order_relaxed);
+  return id;
+}
+
+int64_t ProcessId() {
+#ifdef _WIN32
+  return static_cast<int64_t>(GetCurrentProcessId());
+#else
+  return static_cast<int64_t>(getpid());
+#endif
+}
+
+void AppendEscaped(std::string* out, const char* text) {
+  for (const char* c = text; *c != '\0'; ++c) {
+    switch (*c) {
+      case '"':
+        out->append("\\\"");
+        break;
+      case '\\':
+        out->append("\\\\");
+        break;
+      case '\n':
+        out->append("\\n");
+        break;
+      default:
+        if (static_cast<unsigned char>(*c) < 0x20) {
+          char buffer[8];
+          std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned>(*c));
+          out->append(buffer);
+        } else {
+          out->push_back(*c);
+        }
+    }
+  }
+}
+
+}  // namespace
+
+TraceRecorder& TraceRecorder::Instance() {
+  // Leaked so trace points in static destructors stay valid
+  static TraceRecorder* instance = new TraceRecorder();
+  return *instance;
+}
+
+TraceRecorder::TraceRecorder(size_t capacity) : events_(capacity == 0 ? 1 : capacity) {}
+
+int64_t TraceRecorder::NowMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void TraceRecorder::AddComplete(const char* category, const char* name, int64_t start_us,
+                                int64_t duration_us, int64_t player_id) {
+  if (!enabled()) return;
+  Append({category, name, start_us, duration_us, 0, player_id, CurrentThreadId(), 'X'});
+}
+
+void TraceRecorder::AddInstant(const char* category, const char* name, int64_t player_id) {
+  if (!enabled()) return;
+  Append({category, name, NowMicros(), 0, 0, player_id, CurrentThreadId(), 'i'});
+}
+
+void TraceRecorder::AddCounter(const char* name, int64_t value, int64_t player_id) {
+  if (!enabled()) return;
+  Append({"counter", name, NowMicros(), 0, value, player_id, CurrentThreadId(), 'C'});
+}
+
+void TraceRecorder::SetCurrentThreadName(const std::string& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  thread_names_[CurrentThreadId()] = name;
+}
+
+void TraceRecorder::Append(const Event& event) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  events_[next_ % events_.size()] = event;
+  ++next_;
+}
+
+void TraceRecorder::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  next_ = 0;
+}
+
+uint64_t TraceRecorder::recorded() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return next_;
+}
+
+std::string TraceRecorder::DumpJson() const {
+  // Copy out under the lock; formatting can take milliseconds
+  std::vector<Event> events;
+  std::map<uint32_t, std::string> thread_names;
+  uint64_t recorded;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint64_t capacity = events_.size();
+    const uint64_t count = next_ < capacity ? next_ : capacity;
+    events.reserve(count);
+    for (uint64_t i = next_ - count; i < next_; ++i) events.push_back(events_[i % capacity]);
+    thread_names = thread_names_;
+    recorded = next_;
+  }
+
+  const int64_t pid = ProcessId();
+  std::string out;
+  out.reserve(64 + events.size() * 112);
+  char buffer[256];
+
+  out.append("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+  std::snprintf(buffer, sizeof(buffer),
+                "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":%" PRId64
+                ",\"tid\":0,\"args\":{\"name\":\"pro_video_player\"}}",
+                pid);
+  out.append(buffer);
+  for (const auto& entry : thread_names) {
+    std::snprintf(buffer, sizeof(buffer),
+                  ",{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%" PRId64
+                  ",\"tid\":%u,\"args\":{\"name\":\"",
+                  pid, entry.first);
+    out.append(buffer);
+    AppendEscaped(&out, entry.second.c_str());
+    out.append("\"}}");
+  }
+
+  for (const auto& event : events) {
+    out.append(",{\"ph\":\"");
+    out.push_back(event.phase);
+    out.append("\",\"cat\":\"");
+    AppendEscaped(&out, event.category);
+    out.append("\",\"name\":\"");
+    AppendEscaped(&out, event.name);
+    std::snprintf(buffer, sizeof(buffer), "\",\"pid\":%" PRId64 ",\"tid\":%u,\"ts\":%" PRId64, pid,
+                  event.thread_id, event.timestamp_us);
+    out.append(buffer);
+    switch (event.phase) {
+      case 'X':
+        std::snprintf(buffer, sizeof(buffer), ",\"dur\":%" PRId64, event.duration_us);
+        out.append(buffer);
+        break;
+      case 'i':
+        out.append(",\"s\":\"t\"");
+        break;
+      case 'C':
+        // Counters are keyed by name + id, so each player gets its own track
+        if (event.player_id >= 0) {
+          std::snprintf(buffer, sizeof(buffer), ",\"id\":%" PRId64, event.player_id);
+          out.append(buffer);
+        }
+        std::snprintf(buffer, sizeof(buffer), ",\"args\":{\"value\":%" PRId64 "}}",
+                      event.value);
+        out.append(buffer);
+        continue;
+    }
+    if (event.player_id >= 0) {
+      std::snprintf(buffer, sizeof(buffer), ",\"args\":{\"player\":%" PRId64 "}", event.player_id);
+      out.append(buffer);
+    }
+    out.push_back('}');
+  }
+
+  std::snprintf(buffer, sizeof(buffer),
+                "],\"otherData\":{\"recorded_events\":%" PRIu64 ",\"dropped_events\":%" PRIu64 "}}",
+                recorded, recorded - static_cast<uint64_t>(events.size()));
+  out.append(buffer);
+  return out;
+}
+
+}  // namespace pro_video_player
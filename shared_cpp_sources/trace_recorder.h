@@ -0,0 +1,130 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_TRACE_RECORDER_H_
+#define PRO_VIDEO_PLAYER_SHARED_TRACE_RECORDER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace pro_video_player {
+
+// Always-on flight recorder for the native playback path.
+//
+// Keeps the most recent events in a fixed-size ring and exports them as
+// Chrome trace event JSON (chrome://tracing, ui.perfetto.dev). Timestamps are
+// microseconds on the monotonic clock, which is the clock the Dart timeline
+// uses, so a native trace can be loaded next to a DevTools export.
+//
+// Category and name arguments must be string literals: only the pointers
+// are stored.
+class TraceRecorder {
+ public:
+  static constexpr size_t kDefaultCapacity = 16384;
+
+  // Process-wide recorder used by the PVP_TRACE_* macros.
+  static TraceRecorder& Instance();
+
+  explicit TraceRecorder(size_t capacity = kDefaultCapacity);
+
+  TraceRecorder(const TraceRecorder&) = delete;
+  TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+  void SetEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  // Monotonic time in microseconds.
+  static int64_t NowMicros();
+
+  // Records a complete ("X") event. |player_id| < 0 means no player.
+  void AddComplete(const char* category, const char* name, int64_t start_us,
+                   int64_t duration_us, int64_t player_id = -1);
+
+  // Records a thread-scoped instant ("i") event at the current time.
+  void AddInstant(const char* category, const char* name, int64_t player_id = -1);
+
+  // Records a counter ("C") sample, e.g. queue depth or buffered bytes.
+  void AddCounter(const char* name, int64_t value, int64_t player_id = -1);
+
+  // Names the calling thread in exported traces.
+  void SetCurrentThreadName(const std::string& name);
+
+  // Serialises the ring, oldest event first.
+  std::string DumpJson() const;
+
+  void Clear();
+
+  // Total events recorded since construction or Clear(), including ones
+  // that have since been overwritten.
+  uint64_t recorded() const;
+
+ private:
+  struct Event {
+    const char* category;
+    const char* name;
+    int64_t timestamp_us;
+    int64_t duration_us;
+    int64_t value;
+    int64_t player_id;
+    uint32_t thread_id;
+    char phase;
+  };
+
+  void Append(const Event& event);
+
+  std::atomic<bool> enabled_{true};
+  mutable std::mutex mutex_;
+  std::vector<Event> events_;
+  uint64_t next_ = 0;
+  std::map<uint32_t, std::string> thread_names_;
+};
+
+// Records a complete event covering its own lifetime.
+class ScopedTrace {
+ public:
+  ScopedTrace(const char* category, const char* name, int64_t player_id = -1)
+      : category_(category),
+        name_(name),
+        player_id_(player_id),
+        start_us_(TraceRecorder::Instance().enabled() ? TraceRecorder::NowMicros() : -1) {}
+
+  ~ScopedTrace() {
+    if (start_us_ < 0) return;
+    TraceRecorder::Instance().AddComplete(category_, name_, start_us_,
+                                          TraceRecorder::NowMicros() - start_us_, player_id_);
+  }
+
+  ScopedTrace(const ScopedTrace&) = delete;
+  ScopedTrace& operator=(const ScopedTrace&) = delete;
+
+ private:
+  const char* category_;
+  const char* name_;
+  int64_t player_id_;
+  int64_t start_us_;
+};
+
+}  // namespace pro_video_player
+
+// Define PVP_DISABLE_TRACING to compile all trace points out.
+#ifndef PVP_DISABLE_TRACING
+#define PVP_TRACE_CONCAT_INNER(a, b) a##b
+#define PVP_TRACE_CONCAT(a, b) PVP_TRACE_CONCAT_INNER(a, b)
+#define PVP_TRACE_SCOPE(category, name) \
+  ::pro_video_player::ScopedTrace PVP_TRACE_CONCAT(pvp_trace_, __COUNTER__)(category, name)
+#define PVP_TRACE_SCOPE_PLAYER(category, name, player_id) \
+  ::pro_video_player::ScopedTrace PVP_TRACE_CONCAT(pvp_trace_, __COUNTER__)(category, name, player_id)
+#define PVP_TRACE_INSTANT(category, name, player_id) \
+  ::pro_video_player::TraceRecorder::Instance().AddInstant(category, name, player_id)
+#define PVP_TRACE_COUNTER(name, value, player_id) \
+  ::pro_video_player::TraceRecorder::Instance().AddCounter(name, value, player_id)
+#else
+#define PVP_TRACE_SCOPE(category, name) ((void)0)
+#define PVP_TRACE_SCOPE_PLAYER(category, name, player_id) ((void)0)
+#define PVP_TRACE_INSTANT(category, name, player_id) ((void)0)
+#define PVP_TRACE_COUNTER(name, value, player_id) ((void)0)
+#endif
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_TRACE_RECORDER_H_
@@ -0,0 +1,183 @@
+#include "waveform.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "audio_levels.h"
+
+namespace pro_video_player {
+
+namespace {
+
+// Guards against bogus timestamps growing the summary without bound
+// (24 hours at the default resolution).
+constexpr size_t kMaxBuckets = 24 * 3600 * 1000 / kWaveformBucketMs;
+
+constexpr char kMagic[4] = {'P', 'V', 'P', 'W'};
+constexpr uint32_t kFormatVersion = 1;
+
+uint64_t Fnv1a(const std::string& data, uint64_t hash = 0xcbf29ce484222325ULL) {
+  for (unsigned char c : data) {
+    hash ^= c;
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+std::string DefaultDirectory() {
+  const char* xdg = std::getenv("XDG_CACHE_HOME");
+  std::string base;
+  if (xdg != nullptr && *xdg != '\0') {
+    base = xdg;
+  } else if (const char* home = std::getenv("HOME"); home != nullptr && *home != '\0') {
+    base = std::string(home) + "/.cache";
+  } else {
+    return std::string();
+  }
+  return base + "/pro_video_player/waveforms";
+}
+
+}  // namespace
+
+// ==================== WaveformBuilder ====================
+
+void WaveformBuilder::Add(const AudioSamples& samples) {
+  if (samples.data == nullptr || samples.channels <= 0 || samples.sample_rate <= 0) return;
+  const double frames_per_bucket = samples.sample_rate * static_cast<double>(bucket_ms_) / 1000.0;
+  const int64_t first_frame =
+      std::llround(std::max<int64_t>(samples.pts_ms, 0) * samples.sample_rate / 1000.0);
+
+  size_t offset = 0;
+  while (offset < samples.frames) {
+    const int64_t frame = first_frame + static_cast<int64_t>(offset);
+    const size_t bucket = static_cast<size_t>(frame / frames_per_bucket);
+    if (bucket >= kMaxBuckets) return;
+    const int64_t bucket_end = static_cast<int64_t>(std::ceil((bucket + 1) * frames_per_bucket));
+    const size_t count = std::min<size_t>(samples.frames - offset,
+                                          static_cast<size_t>(std::max<int64_t>(bucket_end - frame, 1)));
+    const float peak = PeakAbs(samples.data + offset * samples.channels, count * samples.channels);
+    if (bucket >= peaks_.size()) peaks_.resize(bucket + 1, 0.0f);
+    peaks_[bucket] = std::max(peaks_[bucket], peak);
+    offset += count;
+  }
+}
+
+Waveform WaveformBuilder::Finish() const {
+  Waveform waveform;
+  waveform.bucket_ms = bucket_ms_;
+  waveform.peaks.reserve(peaks_.size());
+  for (float peak : peaks_) {
+    waveform.peaks.push_back(static_cast<uint8_t>(std::lround(std::clamp(peak, 0.0f, 1.0f) * 255.0f)));
+  }
+  return waveform;
+}
+
+std::vector<uint8_t> DownsampleWaveform(const std::vector<uint8_t>& peaks, int bucket_count) {
+  if (bucket_count <= 0 || peaks.size() <= static_cast<size_t>(bucket_count)) return peaks;
+  std::vector<uint8_t> result(bucket_count);
+  const size_t total = peaks.size();
+  for (size_t i = 0; i < result.size(); ++i) {
+    const size_t begin = i * total / result.size();
+    const size_t end = (i + 1) * total / result.size();
+    result[i] = *std::max_element(peaks.begin() + begin, peaks.begin() + end);
+  }
+  return result;
+}
+
+// ==================== WaveformCache ====================
+
+WaveformCache& WaveformCache::Instance() {
+  static WaveformCache* instance = new WaveformCache(DefaultDirectory());
+  return *instance;
+}
+
+void WaveformCache::SetDirectory(std::string directory) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  directory_ = std::move(directory);
+}
+
+std::string WaveformCache::directory() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return directory_;
+}
+
+std::string WaveformCache::KeyFor(const MediaSource& source) {
+  std::string identity = std::to_string(static_cast<int>(source.type)) + '\n' + source.uri;
+  if (source.type != SourceType::kNetwork) {
+    std::error_code error;
+    const auto size = std::filesystem::file_size(source.uri, error);
+    if (!error) identity += '\n' + std::to_string(size);
+    const auto modified = std::filesystem::last_write_time(source.uri, error);
+    if (!error) identity += '\n' + std::to_string(modified.time_since_epoch().count());
+  }
+  char key[17];
+  std::snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(Fnv1a(identity)));
+  return key;
+}
+
+std::string WaveformCache::PathFor(const std::string& key) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (directory_.empty() || key.empty()) return std::string();
+  return directory_ + "/" + key + ".pvpw";
+}
+
+bool WaveformCache::Load(const std::string& key, Waveform* waveform) const {
+  const std::string path = PathFor(key);
+  if (path.empty()) return false;
+  std::ifstream file(path, std::ios::binary);
+  if (!file) return false;
+
+  char magic[4];
+  uint32_t version = 0;
+  int64_t bucket_ms = 0;
+  uint32_t count = 0;
+  file.read(magic, sizeof(magic));
+  file.read(reinterpret_cast<char*>(&version), sizeof(version));
+  file.read(reinterpret_cast<char*>(&bucket_ms), sizeof(bucket_ms));
+  file.read(reinterpret_cast<char*>(&count), sizeof(count));
+  if (!file || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 || version != kFormatVersion ||
+      bucket_ms <= 0 || count > kMaxBuckets) {
+    return false;
+  }
+  std::vector<uint8_t> peaks(count);
+  file.read(reinterpret_cast<char*>(peaks.data()), count);
+  if (!file) return false;
+  waveform->bucket_ms = bucket_ms;
+  waveform->peaks = std::move(peaks);
+  return true;
+}
+
+bool WaveformCache::Store(const std::string& key, const Waveform& waveform) const {
+  const std::string path = PathFor(key);
+  if (path.empty()) return false;
+  std::error_code error;
+  std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+  if (error) return false;
+
+  // Host byte order; the cache never leaves the machine
+  const std::string temp = path + ".tmp";
+  {
+    std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+    const uint32_t version = kFormatVersion;
+    const uint32_t count = static_cast<uint32_t>(waveform.peaks.size());
+    file.write(kMagic, sizeof(kMagic));
+    file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    file.write(reinterpret_cast<const char*>(&waveform.bucket_ms), sizeof(waveform.bucket_ms));
+    file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    file.write(reinterpret_cast<const char*>(waveform.peaks.data()), count);
+    if (!file) {
+      file.close();
+      std::filesystem::remove(temp, error);
+      return false;
+    }
+  }
+  std::filesystem::rename(temp, path, error);
+  return !error;
+}
+
+}  // namespace pro_video_player
@@ -0,0 +1,74 @@
+#ifndef PRO_VIDEO_PLAYER_SHARED_WAVEFORM_H_
+#define PRO_VIDEO_PLAYER_SHARED_WAVEFORM_H_
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "player_types.h"
+
+namespace pro_video_player {
+
+// Resolution at which waveforms are built and cached; GetWaveform
+// max-pools down to whatever bucket count the caller asks for.
+inline constexpr int64_t kWaveformBucketMs = 50;
+
+// Peak-amplitude summary of a whole file: one byte per |bucket_ms| of
+// media time, linear, 255 = full scale. Empty if the audio couldn't be
+// analysed.
+struct Waveform {
+  int64_t bucket_ms = kWaveformBucketMs;
+  std::vector<uint8_t> peaks;
+};
+
+// Folds decoded audio into a Waveform. Samples may arrive in any order
+// (e.g. across a seek); each lands in the bucket of its timestamp.
+class WaveformBuilder {
+ public:
+  explicit WaveformBuilder(int64_t bucket_ms = kWaveformBucketMs) : bucket_ms_(bucket_ms) {}
+
+  void Add(const AudioSamples& samples);
+  Waveform Finish() const;
+
+ private:
+  int64_t bucket_ms_;
+  std::vector<float> peaks_;
+};
+
+// Max-pools |peaks| into |bucket_count| buckets. Returns |peaks| unchanged
+// if it already has no more than that.
+std::vector<uint8_t> DownsampleWaveform(const std::vector<uint8_t>& peaks, int bucket_count);
+
+// On-disk cache of finished waveforms so a file is only scanned once.
+// Thread-safe.
+class WaveformCache {
+ public:
+  // Uses $XDG_CACHE_HOME/pro_video_player/waveforms (or ~/.cache/...).
+  static WaveformCache& Instance();
+
+  explicit WaveformCache(std::string directory) : directory_(std::move(directory)) {}
+
+  // Empty disables the cache.
+  void SetDirectory(std::string directory);
+  std::string directory() const;
+
+  // Stable key for |source|. Local files include size and modification
+  // time so edited files are re-scanned.
+  static std::string KeyFor(const MediaSource& source);
+
+  bool Load(const std::string& key, Waveform* waveform) const;
+  // Writes atomically (temp file + rename); false on I/O errors.
+  bool Store(const std::string& key, const Waveform& waveform) const;
+
+ private:
+  std::string PathFor(const std::string& key) const;
+
+  mutable std::mutex mutex_;
+  std::string directory_;
+};
+
+}  // namespace pro_video_player
+
+#endif  // PRO_VIDEO_PLAYER_SHARED_WAVEFORM_H_
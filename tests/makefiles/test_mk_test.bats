@@ -143,6 +143,32 @@ load ../test_helper
   assert_success
 }
 
+@test "test.mk: benchmark-linux target exists" {
+  run bash -c "cd '$PROJECT_ROOT' && make -n benchmark-linux 2>&1"
+  assert_success
+}
+
+@test "test.mk: benchmark-linux forwards player count and media" {
+  run bash -c "cd '$PROJECT_ROOT' && make -n benchmark-linux BENCH_PLAYERS=8 BENCH_MEDIA=/tmp/clips 2>&1"
+  assert_success
+  assert_output --regexp "players 8"
+  assert_output --regexp "media \"/tmp/clips\""
+}
+
+@test "test.mk: benchmark-time-stretch builds a release benchmark with a CPU budget" {
+  run bash -c "cd '$PROJECT_ROOT' && make -n benchmark-time-stretch 2>&1"
+  assert_success
+  assert_output --regexp "CMAKE_BUILD_TYPE=Release"
+  assert_output --regexp "time_stretch_benchmark --budget 2"
+}
+
+@test "test.mk: test-cpp-native builds shared_cpp_sources and runs ctest" {
+  run bash -c "cd '$PROJECT_ROOT' && make -n test-cpp-native 2>&1"
+  assert_success
+  assert_output --regexp "cmake -S shared_cpp_sources"
+  assert_output --regexp "ctest --test-dir shared_cpp_sources/build"
+}
+
 # Helper functions
 assert_success() {
   if [ "$status" -ne 0 ]; then